@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <fstream>
 #include <memory>
 #include <vector>
@@ -5,6 +6,14 @@
 #include "../image_exception.h"
 #include "../parameter_validation.h"
 
+#if defined(__linux__) || defined(__APPLE__) || defined(__unix__)
+#define PENGUINV_MAPPED_FILE_SET
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace Bitmap_Operation
 {
     const static uint8_t BITMAP_ALIGNMENT = 4; // this is standard alignment of bitmap images
@@ -320,45 +329,32 @@ namespace Bitmap_Operation
         }
     }
 
-    PenguinV_Image::Image Load( const std::string & path )
+    // Size of file header and the biggest supported dib header
+    size_t headerSize()
     {
-        if( path.empty() )
-            throw imageException( "Incorrect parameters for bitmap loading" );
-
-        std::fstream file;
-        file.open( path, std::fstream::in | std::fstream::binary );
-
-        if( !file )
-            return PenguinV_Image::Image();
-
-        file.seekg( 0, file.end );
-        std::streamoff length = file.tellg();
-
-        if( length == std::char_traits<char>::pos_type( -1 ) ||
-            static_cast<size_t>(length) < sizeof( BitmapFileHeader ) + sizeof( BitmapInfoHeader ) )
-            return PenguinV_Image::Image();
-
-        file.seekg( 0, file.beg );
-
-        // read bitmap header
-        BitmapFileHeader header;
+        return BitmapFileHeader().overallSize + BitmapInfoHeader().overallSize;
+    }
 
-        std::vector < uint8_t > data( sizeof( BitmapFileHeader ) );
+    // Size of file header and the smallest supported dib header
+    size_t minimumFileSize()
+    {
+        return BitmapFileHeader().overallSize + BitmapCoreHeader().overallSize;
+    }
 
-        file.read( reinterpret_cast<char *>(data.data()), header.overallSize );
+    // Reads and validates headers located at the beginning of a file. Returns nullptr if the file is not a supported bitmap
+    BitmapDibHeader * readHeader( const std::vector < uint8_t > & data, size_t length, BitmapFileHeader & header, uint32_t & rowSize )
+    {
+        if( data.size() < header.overallSize + sizeof( uint32_t ) )
+            return nullptr;
 
         header.set( data );
 
         // we suppose to compare header.bfSize and length but some editors don't put correct information
         if( header.bfType != BitmapFileHeader().bfType || header.bfOffBits >= length )
-            return PenguinV_Image::Image();
+            return nullptr;
 
         // read the size of dib header
-        data.resize( 4u );
-
-        file.read( reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(data.size()) );
-
-        size_t dibHeaderOffset = 0;
+        size_t dibHeaderOffset = header.overallSize;
         uint32_t dibHeaderSize = 0;
 
         get_value( data, dibHeaderOffset, dibHeaderSize );
@@ -366,46 +362,184 @@ namespace Bitmap_Operation
         // create proper dib header
         std::unique_ptr <BitmapDibHeader> info( getInfoHeader( dibHeaderSize ) );
 
-        if( info.get() == nullptr )
-            return PenguinV_Image::Image();
-
-        data.resize( dibHeaderSize );
-
-        // read bitmap info
-        file.read( reinterpret_cast<char *>(data.data() + sizeof( dibHeaderSize )), static_cast<std::streamsize>(data.size() - sizeof( dibHeaderSize )) );
+        if( info.get() == nullptr || data.size() < header.overallSize + dibHeaderSize )
+            return nullptr;
 
-        info->set( data );
+        info->set( std::vector < uint8_t >( data.begin() + header.overallSize, data.begin() + header.overallSize + dibHeaderSize ) );
 
         if( info->validate( header ) )
-            return PenguinV_Image::Image();
+            return nullptr;
 
-        uint32_t rowSize = info->width() * info->colorCount();
+        rowSize = info->width() * info->colorCount();
         if( rowSize % BITMAP_ALIGNMENT != 0 )
             rowSize = (rowSize / BITMAP_ALIGNMENT + 1) * BITMAP_ALIGNMENT;
 
-        if( length != header.bfOffBits + rowSize * info->height() )
-            return PenguinV_Image::Image();
+        if( length != header.bfOffBits + static_cast<size_t>(rowSize) * info->height() )
+            return nullptr;
 
-        const uint32_t palleteSize = header.bfOffBits - info->size() - header.overallSize;
+        return info.release();
+    }
 
-        if( palleteSize > 0 ) {
-            std::vector < uint8_t > pallete( palleteSize );
+    // Returns file header, dib header and pallete (for gray-scale images) of a bitmap file
+    std::vector < uint8_t > writeHeader( uint32_t width, uint32_t height, uint8_t colorCount, uint32_t & lineLength )
+    {
+        uint32_t palleteSize = 0;
+        std::vector < uint8_t > pallete;
 
-            size_t dataToRead = palleteSize;
-            size_t dataReaded = 0;
+        // Create a pallete only for gray-scale image
+        if( colorCount == 1u ) {
+            palleteSize = 1024u;
+            pallete.resize( palleteSize, 0 );
 
-            const size_t blockSize = 4 * 1024 * 1024; // read by 4 MB blocks
+            uint8_t * palleteData = pallete.data();
+            uint8_t * palleteEnd = palleteData + pallete.size();
 
-            while( dataToRead > 0 ) {
-                size_t readSize = dataToRead > blockSize ? blockSize : dataToRead;
+            for( uint8_t i = 0; palleteData != palleteEnd; ++i, ++palleteData ) {
+                *palleteData++ = i;
+                *palleteData++ = i;
+                *palleteData++ = i;
+            }
+        }
 
-                file.read( reinterpret_cast<char *>(pallete.data() + dataReaded), static_cast<std::streamsize>(readSize) );
+        lineLength = width * colorCount;
+        if( lineLength % BITMAP_ALIGNMENT != 0 )
+            lineLength = (lineLength / BITMAP_ALIGNMENT + 1) * BITMAP_ALIGNMENT;
+
+        BitmapFileHeader header;
+        BitmapInfoHeader info;
+
+        header.bfSize    = header.overallSize + info.size() + palleteSize + lineLength * height;
+        header.bfOffBits = header.overallSize + info.size() + palleteSize;
+
+        info.setWidth     ( width );
+        info.setHeight    ( height );
+        info.setColorCount( colorCount );
+        info.setImageSize ( lineLength * height );
+
+        std::vector < uint8_t > data( header.bfOffBits );
+        std::vector < uint8_t > temp( sizeof( BitmapInfoHeader ) );
+
+        header.get( temp );
+        memcpy( data.data(), temp.data(), header.overallSize );
+
+        info.get( temp );
+        memcpy( data.data() + header.overallSize, temp.data(), info.size() );
+
+        if( !pallete.empty() )
+            memcpy( data.data() + header.overallSize + info.size(), pallete.data(), pallete.size() );
 
-                dataReaded += readSize;
-                dataToRead -= readSize;
+        return data;
+    }
+
+#ifdef PENGUINV_MAPPED_FILE_SET
+    // Memory mapping of a whole file. The mapping is released in destructor
+    class MappedFile
+    {
+    public:
+        // maps an existing file for reading
+        explicit MappedFile( const std::string & path )
+            : _data( nullptr )
+            , _size( 0 )
+        {
+            const int file = open( path.c_str(), O_RDONLY );
+            if( file < 0 )
+                return;
+
+            struct stat status;
+            if( fstat( file, &status ) == 0 && status.st_size > 0 )
+                _map( file, static_cast<size_t>(status.st_size), PROT_READ );
+
+            close( file );
+
+            // the file is read from the beginning to the end only once
+            if( _data != nullptr )
+                madvise( _data, _size, MADV_SEQUENTIAL );
+        }
+
+        // creates (or truncates) a file of given size and maps it for writing
+        MappedFile( const std::string & path, size_t size )
+            : _data( nullptr )
+            , _size( 0 )
+        {
+            const int file = open( path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644 );
+            if( file < 0 )
+                return;
+
+            if( ftruncate( file, static_cast<off_t>(size) ) == 0 )
+                _map( file, size, PROT_READ | PROT_WRITE );
+
+            close( file );
+        }
+
+        ~MappedFile()
+        {
+            if( _data != nullptr )
+                munmap( _data, _size );
+        }
+
+        uint8_t * data()
+        {
+            return _data;
+        }
+
+        size_t size() const
+        {
+            return _size;
+        }
+    private:
+        uint8_t * _data;
+        size_t _size;
+
+        void _map( int file, size_t size, int protection )
+        {
+            void * data = mmap( nullptr, size, protection, MAP_SHARED, file, 0 );
+            if( data != MAP_FAILED ) {
+                _data = static_cast<uint8_t *>( data );
+                _size = size;
             }
         }
 
+        MappedFile( const MappedFile & ) = delete;
+        MappedFile & operator=( const MappedFile & ) = delete;
+    };
+#endif
+
+    PenguinV_Image::Image Load( const std::string & path )
+    {
+        if( path.empty() )
+            throw imageException( "Incorrect parameters for bitmap loading" );
+
+        std::fstream file;
+        file.open( path, std::fstream::in | std::fstream::binary );
+
+        if( !file )
+            return PenguinV_Image::Image();
+
+        file.seekg( 0, file.end );
+        std::streamoff length = file.tellg();
+
+        if( length == std::char_traits<char>::pos_type( -1 ) ||
+            static_cast<size_t>(length) < minimumFileSize() )
+            return PenguinV_Image::Image();
+
+        file.seekg( 0, file.beg );
+
+        // read bitmap headers
+        std::vector < uint8_t > data( std::min( headerSize(), static_cast<size_t>(length) ) );
+
+        file.read( reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(data.size()) );
+
+        BitmapFileHeader header;
+        uint32_t rowSize = 0;
+
+        std::unique_ptr <BitmapDibHeader> info( readHeader( data, static_cast<size_t>(length), header, rowSize ) );
+
+        if( info.get() == nullptr )
+            return PenguinV_Image::Image();
+
+        // skip pallete
+        file.seekg( header.bfOffBits, file.beg );
+
         PenguinV_Image::Image image( info->width(), info->height(), info->colorCount(), BITMAP_ALIGNMENT );
 
         size_t dataToRead = rowSize * info->height();
@@ -433,6 +567,43 @@ namespace Bitmap_Operation
         raw = Load( path );
     }
 
+    PenguinV_Image::Image LoadMapped( const std::string & path )
+    {
+#ifdef PENGUINV_MAPPED_FILE_SET
+        if( path.empty() )
+            throw imageException( "Incorrect parameters for bitmap loading" );
+
+        MappedFile file( path );
+
+        if( file.data() == nullptr || file.size() < minimumFileSize() )
+            return PenguinV_Image::Image();
+
+        const std::vector < uint8_t > data( file.data(), file.data() + std::min( headerSize(), file.size() ) );
+
+        BitmapFileHeader header;
+        uint32_t rowSize = 0;
+
+        std::unique_ptr <BitmapDibHeader> info( readHeader( data, file.size(), header, rowSize ) );
+
+        if( info.get() == nullptr )
+            return PenguinV_Image::Image();
+
+        PenguinV_Image::Image image( info->width(), info->height(), info->colorCount(), BITMAP_ALIGNMENT );
+
+        // rows are stored bottom-up so they are flipped while reading the file sequentially once
+        const uint8_t * fileY    = file.data() + header.bfOffBits;
+        const uint8_t * fileYEnd = fileY + static_cast<size_t>(rowSize) * image.height();
+        uint8_t       * imageY   = image.data() + static_cast<size_t>(image.rowSize()) * (image.height() - 1);
+
+        for( ; fileY != fileYEnd; fileY += rowSize, imageY -= image.rowSize() )
+            memcpy( imageY, fileY, sizeof( uint8_t ) * rowSize );
+
+        return image;
+#else
+        return Load( path );
+#endif
+    }
+
     void Save( const std::string & path, const PenguinV_Image::Image & image )
     {
         Save( path, image, 0, 0, image.width(), image.height() );
@@ -443,40 +614,10 @@ namespace Bitmap_Operation
     {
         Image_Function::ParameterValidation( image, startX, startY, width, height );
 
-        uint32_t palleteSize = 0;
-        std::vector < uint8_t > pallete;
-
-        // Create a pallete only for gray-scale image
-        if( image.colorCount() == 1u ) {
-            palleteSize = 1024u;
-            pallete.resize( palleteSize, 0 );
-
-            uint8_t * palleteData = pallete.data();
-            uint8_t * palleteEnd = palleteData + pallete.size();
-
-            for( uint8_t i = 0; palleteData != palleteEnd; ++i, ++palleteData ) {
-                *palleteData++ = i;
-                *palleteData++ = i;
-                *palleteData++ = i;
-            }
-        }
-
         const uint8_t colorCount = image.colorCount();
 
-        uint32_t lineLength = width * colorCount;
-        if( lineLength % BITMAP_ALIGNMENT != 0 )
-            lineLength = (lineLength / BITMAP_ALIGNMENT + 1) * BITMAP_ALIGNMENT;
-
-        BitmapFileHeader header;
-        BitmapInfoHeader info;
-
-        header.bfSize    = header.overallSize + info.size() + palleteSize + lineLength * height;
-        header.bfOffBits = header.overallSize + info.size() + palleteSize;
-
-        info.setWidth     ( width );
-        info.setHeight    ( height );
-        info.setColorCount( colorCount );
-        info.setImageSize ( lineLength * height );
+        uint32_t lineLength = 0;
+        const std::vector < uint8_t > data = writeHeader( width, height, colorCount, lineLength );
 
         std::fstream file;
         file.open( path, std::fstream::out | std::fstream::trunc | std::fstream::binary );
@@ -484,18 +625,7 @@ namespace Bitmap_Operation
         if( !file )
             throw imageException( "Cannot create file for saving" );
 
-        std::vector < uint8_t > data( sizeof( BitmapFileHeader ) );
-
-        header.get( data );
-        file.write( reinterpret_cast<const char *>(data.data()), header.overallSize );
-
-        data.resize( sizeof( BitmapInfoHeader ) );
-
-        info.get( data );
-        file.write( reinterpret_cast<const char *>(data.data()), info.size() );
-
-        if( !pallete.empty() )
-            file.write( reinterpret_cast<const char *>(pallete.data()), static_cast<std::streamsize>(pallete.size()) );
+        file.write( reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()) );
 
         file.flush();
 
@@ -515,4 +645,191 @@ namespace Bitmap_Operation
         if( !file )
             throw imageException( "failed to write data into file" );
     }
+
+    void SaveMapped( const std::string & path, const PenguinV_Image::Image & image )
+    {
+        SaveMapped( path, image, 0, 0, image.width(), image.height() );
+    }
+
+    void SaveMapped( const std::string & path, const PenguinV_Image::Image & image, uint32_t startX, uint32_t startY,
+                     uint32_t width, uint32_t height )
+    {
+#ifdef PENGUINV_MAPPED_FILE_SET
+        Image_Function::ParameterValidation( image, startX, startY, width, height );
+
+        const uint8_t colorCount = image.colorCount();
+
+        uint32_t lineLength = 0;
+        const std::vector < uint8_t > data = writeHeader( width, height, colorCount, lineLength );
+
+        MappedFile file( path, data.size() + static_cast<size_t>(lineLength) * height );
+
+        if( file.data() == nullptr )
+            throw imageException( "Cannot create file for saving" );
+
+        memcpy( file.data(), data.data(), data.size() );
+
+        // a new file is filled by zeros so only pixel data is copied without padding at the end of every line
+        const uint32_t rowSize = image.rowSize();
+
+        const uint8_t * imageY = image.data() + (startY + height - 1) * rowSize + startX * colorCount;
+        uint8_t       * fileY  = file.data() + data.size();
+
+        for( uint32_t rowId = 0; rowId < height; ++rowId, imageY -= rowSize, fileY += lineLength )
+            memcpy( fileY, imageY, sizeof( uint8_t ) * width * colorCount );
+#else
+        Save( path, image, startX, startY, width, height );
+#endif
+    }
+
+    BitmapReader::BitmapReader( const std::string & path )
+        : _width     ( 0 )
+        , _height    ( 0 )
+        , _colorCount( 0 )
+        , _lineLength( 0 )
+        , _dataOffset( 0 )
+    {
+        if( path.empty() )
+            throw imageException( "Incorrect parameters for bitmap loading" );
+
+        _file.open( path, std::fstream::in | std::fstream::binary );
+
+        if( !_file )
+            throw imageException( "Cannot open file for reading" );
+
+        _file.seekg( 0, _file.end );
+        std::streamoff length = _file.tellg();
+
+        if( length == std::char_traits<char>::pos_type( -1 ) || static_cast<size_t>(length) < minimumFileSize() )
+            throw imageException( "File is not a supported bitmap" );
+
+        _file.seekg( 0, _file.beg );
+
+        std::vector < uint8_t > data( std::min( headerSize(), static_cast<size_t>(length) ) );
+
+        _file.read( reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(data.size()) );
+
+        BitmapFileHeader header;
+
+        std::unique_ptr <BitmapDibHeader> info( readHeader( data, static_cast<size_t>(length), header, _lineLength ) );
+
+        if( info.get() == nullptr )
+            throw imageException( "File is not a supported bitmap" );
+
+        _width      = info->width();
+        _height     = info->height();
+        _colorCount = info->colorCount();
+        _dataOffset = header.bfOffBits;
+    }
+
+    uint32_t BitmapReader::width() const
+    {
+        return _width;
+    }
+
+    uint32_t BitmapReader::height() const
+    {
+        return _height;
+    }
+
+    uint8_t BitmapReader::colorCount() const
+    {
+        return _colorCount;
+    }
+
+    void BitmapReader::read( uint32_t startY, PenguinV_Image::Image & image )
+    {
+        if( image.empty() || image.width() != _width || image.colorCount() != _colorCount ||
+            startY + image.height() < image.height() || startY + image.height() > _height )
+            throw imageException( "Bad input parameters in image stream function" );
+
+        // rows are stored bottom-up so the file is read sequentially from the last row of the image area
+        _file.seekg( _dataOffset + static_cast<std::streamoff>(_height - startY - image.height()) * _lineLength, _file.beg );
+
+        const uint32_t width = _width * _colorCount;
+        const std::streamoff padding = _lineLength - width;
+
+        uint8_t * imageY = image.data() + (image.height() - 1) * image.rowSize();
+
+        for( uint32_t rowId = 0; rowId < image.height(); ++rowId, imageY -= image.rowSize() ) {
+            _file.read( reinterpret_cast<char *>(imageY), width );
+
+            if( padding > 0 )
+                _file.seekg( padding, _file.cur );
+        }
+
+        if( !_file )
+            throw imageException( "Cannot read image rows from file" );
+    }
+
+    BitmapWriter::BitmapWriter( const std::string & path, uint32_t width_, uint32_t height_, uint8_t colorCount_ )
+        : _width     ( width_ )
+        , _height    ( height_ )
+        , _colorCount( colorCount_ )
+        , _lineLength( 0 )
+        , _dataOffset( 0 )
+    {
+        if( path.empty() || _width == 0 || _height == 0 || (_colorCount != 1u && _colorCount != 3u) )
+            throw imageException( "Incorrect parameters for bitmap saving" );
+
+        const std::vector < uint8_t > data = writeHeader( _width, _height, _colorCount, _lineLength );
+
+        _dataOffset = static_cast<uint32_t>(data.size());
+
+        _file.open( path, std::fstream::in | std::fstream::out | std::fstream::trunc | std::fstream::binary );
+
+        if( !_file )
+            throw imageException( "Cannot create file for saving" );
+
+        _file.write( reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()) );
+
+        // rows can be written in any order so the file gets its final size at once
+        const char zero = 0;
+        _file.seekp( _dataOffset + static_cast<std::streamoff>(_lineLength) * _height - 1, _file.beg );
+        _file.write( &zero, 1 );
+
+        if( !_file )
+            throw imageException( "Cannot create file for saving" );
+    }
+
+    uint32_t BitmapWriter::width() const
+    {
+        return _width;
+    }
+
+    uint32_t BitmapWriter::height() const
+    {
+        return _height;
+    }
+
+    uint8_t BitmapWriter::colorCount() const
+    {
+        return _colorCount;
+    }
+
+    void BitmapWriter::write( uint32_t startY, const PenguinV_Image::Image & image, uint32_t startYIn, uint32_t height_ )
+    {
+        if( image.empty() || image.width() != _width || image.colorCount() != _colorCount || height_ == 0 ||
+            startY + height_ < height_ || startY + height_ > _height )
+            throw imageException( "Bad input parameters in image stream function" );
+
+        Image_Function::ParameterValidation( image, 0, startYIn, image.width(), height_ );
+
+        _file.seekp( _dataOffset + static_cast<std::streamoff>(_height - startY - height_) * _lineLength, _file.beg );
+
+        const uint32_t width = _width * _colorCount;
+        std::vector < uint8_t > padding( _lineLength - width, 0 );
+
+        const uint8_t * imageY = image.data() + (startYIn + height_ - 1) * image.rowSize();
+
+        for( uint32_t rowId = 0; rowId < height_; ++rowId, imageY -= image.rowSize() ) {
+            _file.write( reinterpret_cast<const char *>(imageY), width );
+
+            if( !padding.empty() )
+                _file.write( reinterpret_cast<const char *>(padding.data()), static_cast<std::streamsize>(padding.size()) );
+        }
+
+        if( !_file )
+            throw imageException( "Cannot write image rows into file" );
+    }
 }
@@ -1,4 +1,8 @@
+#pragma once
+
+#include <fstream>
 #include "../image_buffer.h"
+#include "../image_stream.h"
 
 namespace Bitmap_Operation
 {
@@ -9,4 +13,53 @@ namespace Bitmap_Operation
     void Save( const std::string & path, const PenguinV_Image::Image & image );
     void Save( const std::string & path, const PenguinV_Image::Image & image, uint32_t startX, uint32_t startY,
                uint32_t width, uint32_t height );
+
+    // Functions below map a whole file into memory so pixel data is copied between the file and an image in one pass
+    // without intermediate buffers. It is faster for big images. If memory mapping is not supported on a platform
+    // the functions above are called
+    PenguinV_Image::Image LoadMapped( const std::string & path );
+
+    void SaveMapped( const std::string & path, const PenguinV_Image::Image & image );
+    void SaveMapped( const std::string & path, const PenguinV_Image::Image & image, uint32_t startX, uint32_t startY,
+                     uint32_t width, uint32_t height );
+
+    // Classes below read and write a bitmap file by bands of rows for Image_Stream::StreamExecutor
+    // so images which do not fit into memory can be processed
+    class BitmapReader : public Image_Stream::ImageReader
+    {
+    public:
+        explicit BitmapReader( const std::string & path );
+
+        virtual uint32_t width() const;
+        virtual uint32_t height() const;
+        virtual uint8_t colorCount() const;
+
+        virtual void read( uint32_t startY, PenguinV_Image::Image & image );
+    private:
+        std::fstream _file;
+        uint32_t _width;
+        uint32_t _height;
+        uint8_t _colorCount;
+        uint32_t _lineLength; // size of a row in the file including padding
+        uint32_t _dataOffset; // position of pixel data in the file
+    };
+
+    class BitmapWriter : public Image_Stream::ImageWriter
+    {
+    public:
+        BitmapWriter( const std::string & path, uint32_t width, uint32_t height, uint8_t colorCount = 1u );
+
+        virtual uint32_t width() const;
+        virtual uint32_t height() const;
+        virtual uint8_t colorCount() const;
+
+        virtual void write( uint32_t startY, const PenguinV_Image::Image & image, uint32_t startYIn, uint32_t height );
+    private:
+        std::fstream _file;
+        uint32_t _width;
+        uint32_t _height;
+        uint8_t _colorCount;
+        uint32_t _lineLength;
+        uint32_t _dataOffset;
+    };
 }
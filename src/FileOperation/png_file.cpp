@@ -1,4 +1,6 @@
-#include <stdlib.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <string.h>
 
 #ifdef _WIN32
 
@@ -10,24 +12,144 @@
 #include "../image_exception.h"
 #include "../parameter_validation.h"
 
-namespace Png_Operation
+namespace
 {
-    PenguinV_Image::Image Load( const std::string & path )
+    // File which is closed in destructor
+    class FileHandle
     {
-        if( path.empty() )
-            throw imageException( "Incorrect file path for image file loading" );
+    public:
+        FileHandle( const std::string & path, const char * mode )
+            : _file( fopen( path.data(), mode ) )
+        {
+        }
 
-        FILE * file = fopen( path.data(), "rb" );
-        if( !file )
-            throw imageException( "Cannot create file for reading" );
+        ~FileHandle()
+        {
+            if( _file != nullptr )
+                fclose( _file );
+        }
+
+        FILE * get() const
+        {
+            return _file;
+        }
+    private:
+        FILE * _file;
+
+        FileHandle( const FileHandle & ) = delete;
+        FileHandle & operator=( const FileHandle & ) = delete;
+    };
+
+    // libpng reports an error by a long jump to png_jmpbuf() of a structure. The handler keeps a message of the error
+    // to throw it as an exception after the jump
+    void PNGCBAPI ErrorHandler( png_structp png, png_const_charp message );
+
+    // Warnings do not stop decoding or encoding so they are not reported
+    void PNGCBAPI WarningHandler( png_structp, png_const_charp )
+    {
+    }
+
+    // libpng read or write structure with info structure which are destroyed in destructor
+    class PngStruct
+    {
+    public:
+        explicit PngStruct( bool read )
+            : png  ( read ? png_create_read_struct ( PNG_LIBPNG_VER_STRING, this, ErrorHandler, WarningHandler )
+                          : png_create_write_struct( PNG_LIBPNG_VER_STRING, this, ErrorHandler, WarningHandler ) )
+            , info ( NULL )
+            , _read( read )
+        {
+            error[0] = '\0';
+
+            if( png != NULL )
+                info = png_create_info_struct( png );
+
+            if( info == NULL ) {
+                _destroy();
+                throw imageException( read ? "Cannot create PNG decoder" : "Cannot create PNG encoder" );
+            }
+        }
+
+        ~PngStruct()
+        {
+            _destroy();
+        }
+
+        png_structp png;
+        png_infop info;
+        char error[128];
+    private:
+        bool _read;
+
+        void _destroy()
+        {
+            if( png == NULL )
+                return;
+
+            if( _read )
+                png_destroy_read_struct( &png, &info, NULL );
+            else
+                png_destroy_write_struct( &png, &info );
+        }
+
+        PngStruct( const PngStruct & ) = delete;
+        PngStruct & operator=( const PngStruct & ) = delete;
+    };
+
+    void PNGCBAPI ErrorHandler( png_structp png, png_const_charp message )
+    {
+        PngStruct * pngStruct = static_cast<PngStruct *>( png_get_error_ptr( png ) );
+
+        strncpy( pngStruct->error, message, sizeof( pngStruct->error ) - 1u );
+        pngStruct->error[sizeof( pngStruct->error ) - 1u] = '\0';
 
-        png_structp png = png_create_read_struct( PNG_LIBPNG_VER_STRING, NULL, NULL, NULL );
-        if( !png )
-            return PenguinV_Image::Image();
+        png_longjmp( png, 1 );
+    }
+
+    // Converts decoded RGBA pixels into BGR pixels of an image row
+    void ConvertRow( const uint8_t * in, uint8_t * out, uint32_t width )
+    {
+        const uint8_t * inEnd = in + width * 4u;
+
+        for( ; in != inEnd; in += 4 ) {
+            *(out++) = in[2];
+            *(out++) = in[1];
+            *(out++) = in[0];
+        }
+    }
+
+    // Converts gray-scale or BGR pixels of an image row into RGBA pixels
+    void ConvertRow( const uint8_t * in, uint8_t * out, uint32_t width, uint8_t colorCount )
+    {
+        uint8_t * outEnd = out + width * 4u;
 
-        png_infop info = png_create_info_struct( png );
-        if( !info )
-            return PenguinV_Image::Image();
+        if( colorCount == PenguinV_Image::GRAY_SCALE ) {
+            for( ; out != outEnd; out += 4 ) {
+                out[0] = out[1] = out[2] = *(in++);
+                out[3] = 255;
+            }
+        }
+        else {
+            for( ; out != outEnd; out += 4 ) {
+                out[2] = *(in++);
+                out[1] = *(in++);
+                out[0] = *(in++);
+                out[3] = 255;
+            }
+        }
+    }
+
+    // Decodes a file into an image row by row. The image is reallocated only if its size or color count is different
+    // No objects with destructors may be created after setjmp() call as a long jump skips them
+    void Decode( FILE * file, PenguinV_Image::Image & image, std::vector < uint8_t > & buffer )
+    {
+        PngStruct pngStruct( true );
+
+        png_structp png = pngStruct.png;
+        png_infop info = pngStruct.info;
+
+        if( setjmp( png_jmpbuf( png ) ) )
+            throw imageException( pngStruct.error );
 
         png_init_io( png, file );
         png_read_info( png, info );
@@ -57,44 +179,98 @@ namespace Png_Operation
         if( colorType == PNG_COLOR_TYPE_GRAY || colorType == PNG_COLOR_TYPE_GRAY_ALPHA )
             png_set_gray_to_rgb( png );
 
-        png_read_update_info( png, info );
+        const int passCount = png_set_interlace_handling( png );
 
-        uint8_t ** row_pointers = reinterpret_cast<uint8_t**>( malloc( sizeof( uint8_t* ) * height ) );
+        png_read_update_info( png, info );
 
         const size_t rowByteCount = png_get_rowbytes( png, info );
 
-        for( uint32_t y = 0; y < height; ++y )
-            row_pointers[y] = reinterpret_cast<uint8_t*>( malloc( rowByteCount ) );
+        image.setColorCount( PenguinV_Image::RGB );
+        image.resize( width, height );
 
-        png_read_image( png, row_pointers );
+        if( passCount > 1 ) {
+            // every pass of an interlaced image updates all rows so the whole decoded image must be kept
+            buffer.resize( rowByteCount * height );
 
-        PenguinV_Image::Image image( width, height, PenguinV_Image::RGB );
+            for( int pass = 0; pass < passCount; ++pass ) {
+                for( uint32_t y = 0; y < height; ++y )
+                    png_read_row( png, buffer.data() + y * rowByteCount, NULL );
+            }
+
+            uint8_t * outY = image.data();
+            for( uint32_t y = 0; y < height; ++y, outY += image.rowSize() )
+                ConvertRow( buffer.data() + y * rowByteCount, outY, width );
+        }
+        else {
+            buffer.resize( rowByteCount );
 
-        uint8_t * outY = image.data();
-        for( uint32_t y = 0; y < height; ++y, outY += image.rowSize() ) {
-            const uint8_t * column = row_pointers[y];
-            uint8_t * outX = outY;
-            for( uint32_t x = 0; x < width; ++x, column += 4 ) {
-                *(outX++) = column[2];
-                *(outX++) = column[1];
-                *(outX++) = column[0];
+            uint8_t * outY = image.data();
+            for( uint32_t y = 0; y < height; ++y, outY += image.rowSize() ) {
+                png_read_row( png, buffer.data(), NULL );
+                ConvertRow( buffer.data(), outY, width );
             }
         }
 
-        fclose( file );
+        png_read_end( png, NULL );
+    }
+
+    // Encodes an image area into a file row by row
+    // No objects with destructors may be created after setjmp() call as a long jump skips them
+    void Encode( FILE * file, const PenguinV_Image::Image & image, uint32_t startX, uint32_t startY, uint32_t width, uint32_t height,
+                 std::vector < uint8_t > & buffer )
+    {
+        PngStruct pngStruct( false );
+
+        png_structp png = pngStruct.png;
+        png_infop info = pngStruct.info;
+
+        if( setjmp( png_jmpbuf( png ) ) )
+            throw imageException( pngStruct.error );
+
+        png_init_io( png, file );
+
+        // Output is 8bit depth, RGBA format
+        png_set_IHDR( png, info, width, height, 8, PNG_COLOR_TYPE_RGBA, PNG_INTERLACE_NONE,
+                      PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT );
+
+        png_write_info( png, info );
+
+        buffer.resize( png_get_rowbytes( png, info ) );
+
+        const uint8_t colorCount = image.colorCount();
+
+        const uint8_t * inY = image.data() + startY * image.rowSize() + startX * colorCount;
+        for( uint32_t y = 0; y < height; ++y, inY += image.rowSize() ) {
+            ConvertRow( inY, buffer.data(), width, colorCount );
+            png_write_row( png, buffer.data() );
+        }
+
+        png_write_end( png, NULL );
+    }
+}
 
-        for( uint32_t y = 0; y < height; ++y )
-            free( row_pointers[y] );
-        free( row_pointers );
+namespace Png_Operation
+{
+    PenguinV_Image::Image Load( const std::string & path )
+    {
+        PenguinV_Image::Image image;
 
-        png_destroy_read_struct( &png, &info, NULL );
+        Load( path, image );
 
         return image;
     }
 
     void Load( const std::string & path, PenguinV_Image::Image & raw )
     {
-        raw = Load( path );
+        if( path.empty() )
+            throw imageException( "Incorrect file path for image file loading" );
+
+        FileHandle file( path, "rb" );
+        if( file.get() == nullptr )
+            throw imageException( "Cannot create file for reading" );
+
+        std::vector < uint8_t > buffer;
+        Decode( file.get(), raw, buffer );
     }
 
     void Save( const std::string & path, const PenguinV_Image::Image & image )
@@ -107,67 +283,99 @@ namespace Png_Operation
     {
         Image_Function::ParameterValidation( image, startX, startY, width, height );
 
-        FILE * file = fopen( path.data(), "wb" );
-        if( !file )
-            throw imageException( "Cannot create file for saving" );
-
-        png_structp png = png_create_write_struct( PNG_LIBPNG_VER_STRING, NULL, NULL, NULL );
-        if( !png )
+        FileHandle file( path, "wb" );
+        if( file.get() == nullptr )
             throw imageException( "Cannot create file for saving" );
 
-        png_infop info = png_create_info_struct( png );
-        if( !info )
-            throw imageException( "Cannot create file for saving" );
+        std::vector < uint8_t > buffer;
+        Encode( file.get(), image, startX, startY, width, height, buffer );
+    }
 
-        png_init_io( png, file );
+    AsyncPng::AsyncPng()
+        : _image     ( nullptr )
+        , _constImage( nullptr )
+        , _startX    ( 0 )
+        , _startY    ( 0 )
+        , _width     ( 0 )
+        , _height    ( 0 )
+    {
+    }
 
-        // Output is 8bit depth, RGBA format
-        png_set_IHDR( png, info, width, height, 8, PNG_COLOR_TYPE_RGBA, PNG_INTERLACE_NONE,
-                      PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT );
+    AsyncPng::~AsyncPng()
+    {
+        // a worker must not use members of this object after destruction
+        wait();
+    }
 
-        png_write_info( png, info );
+    std::future < void > AsyncPng::load( const std::string & path, PenguinV_Image::Image & image )
+    {
+        return _start( path, &image, nullptr, 0, 0, 0, 0 );
+    }
 
-        uint8_t ** row_pointers = reinterpret_cast<uint8_t**>( malloc( sizeof( uint8_t* ) * height ) );
+    std::future < void > AsyncPng::save( const std::string & path, const PenguinV_Image::Image & image )
+    {
+        return save( path, image, 0, 0, image.width(), image.height() );
+    }
 
-        const size_t rowByteCount = png_get_rowbytes( png, info );
+    std::future < void > AsyncPng::save( const std::string & path, const PenguinV_Image::Image & image, uint32_t startX, uint32_t startY,
+                                         uint32_t width, uint32_t height )
+    {
+        Image_Function::ParameterValidation( image, startX, startY, width, height );
 
-        for( uint32_t y = 0; y < height; ++y )
-            row_pointers[y] = reinterpret_cast<uint8_t*>( malloc( rowByteCount ) );
+        return _start( path, nullptr, &image, startX, startY, width, height );
+    }
 
-        const bool grayScaleImage = image.colorCount() == PenguinV_Image::GRAY_SCALE;
+    void AsyncPng::wait()
+    {
+        _wait();
+    }
 
-        const uint8_t * outY = image.data() + startY * image.rowSize() + startX * image.colorCount();
-        for( uint32_t y = 0; y < height; ++y, outY += image.rowSize() ) {
-            uint8_t * column = row_pointers[y];
-            const uint8_t * outX = outY;
+    void AsyncPng::_task( size_t )
+    {
+        try {
+            if( _image != nullptr ) {
+                FileHandle file( _path, "rb" );
+                if( file.get() == nullptr )
+                    throw imageException( "Cannot create file for reading" );
 
-            if( grayScaleImage )
-            {
-                for( uint32_t x = 0; x < width; ++x, column += 4 ) {
-                    column[0] = column[1] = column[2] = *(outX++);
-                    column[3] = 255;
-                }
+                Decode( file.get(), *_image, _buffer );
             }
-            else
-            {
-                for( uint32_t x = 0; x < width; ++x, column += 4 ) {
-                    column[2] = *(outX++);
-                    column[1] = *(outX++);
-                    column[0] = *(outX++);
-                    column[3] = 255;
-                }
+            else {
+                FileHandle file( _path, "wb" );
+                if( file.get() == nullptr )
+                    throw imageException( "Cannot create file for saving" );
+
+                Encode( file.get(), *_constImage, _startX, _startY, _width, _height, _buffer );
             }
+
+            _promise.set_value();
+        }
+        catch( ... ) {
+            _promise.set_exception( std::current_exception() );
         }
+    }
 
-        png_write_image( png, row_pointers );
-        png_write_end( png, NULL );
+    std::future < void > AsyncPng::_start( const std::string & path, PenguinV_Image::Image * image, const PenguinV_Image::Image * constImage,
+                                           uint32_t startX, uint32_t startY, uint32_t width, uint32_t height )
+    {
+        if( path.empty() )
+            throw imageException( "Incorrect file path for image file loading" );
+
+        wait();
+
+        _path       = path;
+        _image      = image;
+        _constImage = constImage;
+        _startX     = startX;
+        _startY     = startY;
+        _width      = width;
+        _height     = height;
 
-        fclose( file );
+        _promise = std::promise < void >();
+        std::future < void > result = _promise.get_future();
 
-        for( uint32_t y = 0; y < height; ++y )
-            free( row_pointers[y] );
-        free( row_pointers );
+        _run( 1 );
 
-        png_destroy_write_struct( &png, &info );
+        return result;
     }
 }
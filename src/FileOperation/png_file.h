@@ -1,4 +1,10 @@
+#pragma once
+
+#include <future>
+#include <string>
+#include <vector>
 #include "../image_buffer.h"
+#include "../thread_pool.h"
 
 namespace Png_Operation
 {
@@ -9,4 +15,43 @@ namespace Png_Operation
     void Save( const std::string & path, const PenguinV_Image::Image & image );
     void Save( const std::string & path, const PenguinV_Image::Image & image, uint32_t startX, uint32_t startY,
                uint32_t width, uint32_t height );
+
+    // This class loads and saves files on a worker of global thread pool (Thread_Pool::ThreadPoolMonoid) so a caller
+    // can process a frame while next frame is being decoded. Use two objects for double buffering:
+    //     std::future < void > next = loader[1].load( path[i + 1], frame[1] );
+    //     process( frame[0] );
+    //     next.get();
+    // A file is decoded row by row directly into a given image which is reallocated only when its size is different,
+    // so images and internal buffers are reused between frames
+    // An image must exist and must not be used by a caller until returned future is ready
+    // Only one operation per object can be in progress: a new operation waits for completion of previous one
+    class AsyncPng : public Thread_Pool::TaskProviderSingleton
+    {
+    public:
+        AsyncPng();
+        virtual ~AsyncPng();
+
+        std::future < void > load( const std::string & path, PenguinV_Image::Image & image );
+        std::future < void > save( const std::string & path, const PenguinV_Image::Image & image );
+        std::future < void > save( const std::string & path, const PenguinV_Image::Image & image, uint32_t startX, uint32_t startY,
+                                   uint32_t width, uint32_t height );
+
+        void wait(); // waits for completion of current operation
+    protected:
+        virtual void _task( size_t );
+    private:
+        std::string _path;
+        PenguinV_Image::Image * _image;
+        const PenguinV_Image::Image * _constImage;
+        uint32_t _startX;
+        uint32_t _startY;
+        uint32_t _width;
+        uint32_t _height;
+
+        std::promise < void > _promise;
+        std::vector < uint8_t > _buffer; // decoded or encoded rows
+
+        std::future < void > _start( const std::string & path, PenguinV_Image::Image * image, const PenguinV_Image::Image * constImage,
+                                     uint32_t startX, uint32_t startY, uint32_t width, uint32_t height );
+    };
 }
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace PenguinV_Image
+{
+    // Binary image which stores 1 bit per pixel. Every row is an array of 64-bit words where pixel x is bit (x % 64)
+    // of word (x / 64). Bits after the last pixel of a row are always 0 so functions process whole words without masking
+    // Functions to work with binary images are located in Binary_Image_Function namespace
+    class BinaryImage
+    {
+    public:
+        BinaryImage()
+            : _width  ( 0 )
+            , _height ( 0 )
+            , _rowSize( 0 )
+        {
+        }
+
+        BinaryImage( uint32_t width_, uint32_t height_ )
+            : _width  ( 0 )
+            , _height ( 0 )
+            , _rowSize( 0 )
+        {
+            resize( width_, height_ );
+        }
+
+        // All pixels of resized image are 0
+        void resize( uint32_t width_, uint32_t height_ )
+        {
+            _width   = width_;
+            _height  = height_;
+            _rowSize = (width_ + 63u) / 64u;
+
+            _data.assign( static_cast<size_t>(_rowSize) * _height, 0u );
+        }
+
+        void clear()
+        {
+            _width   = 0;
+            _height  = 0;
+            _rowSize = 0;
+
+            _data.clear();
+        }
+
+        uint64_t * data()
+        {
+            return _data.data();
+        }
+
+        const uint64_t * data() const
+        {
+            return _data.data();
+        }
+
+        uint8_t colorCount() const // binary image always has one channel
+        {
+            return 1u;
+        }
+
+        bool empty() const
+        {
+            return _data.empty();
+        }
+
+        uint32_t width() const
+        {
+            return _width;
+        }
+
+        uint32_t height() const
+        {
+            return _height;
+        }
+
+        uint32_t rowSize() const // number of 64-bit words in a row
+        {
+            return _rowSize;
+        }
+
+        uint64_t lastWordMask() const // valid bits of the last word in a row
+        {
+            return (_width % 64u == 0u) ? ~static_cast<uint64_t>(0u) : (static_cast<uint64_t>(1u) << (_width % 64u)) - 1u;
+        }
+    private:
+        uint32_t _width;
+        uint32_t _height;
+        uint32_t _rowSize;
+        std::vector < uint64_t > _data;
+    };
+
+    // Number of set bits in a word
+    inline uint32_t BitCount( uint64_t value )
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<uint32_t>( __builtin_popcountll( value ) );
+#else
+        value = value - ((value >> 1) & 0x5555555555555555u);
+        value = (value & 0x3333333333333333u) + ((value >> 2) & 0x3333333333333333u);
+        value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0Fu;
+
+        return static_cast<uint32_t>( (value * 0x0101010101010101u) >> 56 );
+#endif
+    }
+
+    // Position of the lowest set bit in a word, value must not be 0
+    inline uint32_t LowestBitPosition( uint64_t value )
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<uint32_t>( __builtin_ctzll( value ) );
+#else
+        return BitCount( (value & (~value + 1u)) - 1u );
+#endif
+    }
+}
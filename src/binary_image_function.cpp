@@ -0,0 +1,559 @@
+#include <algorithm>
+#include "binary_image_function.h"
+#include "parameter_validation.h"
+#include "penguinv/cpu_identification.h"
+
+#ifdef PENGUINV_AVX_SET
+#include <immintrin.h>
+#endif
+
+#ifdef PENGUINV_SSE_SET
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    struct AndOperation
+    {
+        static uint64_t calculate( uint64_t value1, uint64_t value2 )
+        {
+            return value1 & value2;
+        }
+
+#ifdef PENGUINV_AVX_SET
+        static __m256i calculate( __m256i value1, __m256i value2 )
+        {
+            return _mm256_and_si256( value1, value2 );
+        }
+#endif
+
+#ifdef PENGUINV_SSE_SET
+        static __m128i calculate( __m128i value1, __m128i value2 )
+        {
+            return _mm_and_si128( value1, value2 );
+        }
+#endif
+    };
+
+    struct OrOperation
+    {
+        static uint64_t calculate( uint64_t value1, uint64_t value2 )
+        {
+            return value1 | value2;
+        }
+
+#ifdef PENGUINV_AVX_SET
+        static __m256i calculate( __m256i value1, __m256i value2 )
+        {
+            return _mm256_or_si256( value1, value2 );
+        }
+#endif
+
+#ifdef PENGUINV_SSE_SET
+        static __m128i calculate( __m128i value1, __m128i value2 )
+        {
+            return _mm_or_si128( value1, value2 );
+        }
+#endif
+    };
+
+    struct XorOperation
+    {
+        static uint64_t calculate( uint64_t value1, uint64_t value2 )
+        {
+            return value1 ^ value2;
+        }
+
+#ifdef PENGUINV_AVX_SET
+        static __m256i calculate( __m256i value1, __m256i value2 )
+        {
+            return _mm256_xor_si256( value1, value2 );
+        }
+#endif
+
+#ifdef PENGUINV_SSE_SET
+        static __m128i calculate( __m128i value1, __m128i value2 )
+        {
+            return _mm_xor_si128( value1, value2 );
+        }
+#endif
+    };
+
+    template <typename TOperation>
+    void WordOperation( const uint64_t * in1, const uint64_t * in2, uint64_t * out, size_t size )
+    {
+        size_t i = 0;
+
+#ifdef PENGUINV_AVX_SET
+        if( isAvxAvailable ) {
+            for( ; i + 4u <= size; i += 4u ) {
+                const __m256i data1 = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(in1 + i) );
+                const __m256i data2 = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(in2 + i) );
+
+                _mm256_storeu_si256( reinterpret_cast<__m256i*>(out + i), TOperation::calculate( data1, data2 ) );
+            }
+        }
+#endif
+
+#ifdef PENGUINV_SSE_SET
+        if( isSseAvailable ) {
+            for( ; i + 2u <= size; i += 2u ) {
+                const __m128i data1 = _mm_loadu_si128( reinterpret_cast<const __m128i*>(in1 + i) );
+                const __m128i data2 = _mm_loadu_si128( reinterpret_cast<const __m128i*>(in2 + i) );
+
+                _mm_storeu_si128( reinterpret_cast<__m128i*>(out + i), TOperation::calculate( data1, data2 ) );
+            }
+        }
+#endif
+
+        for( ; i < size; ++i )
+            out[i] = TOperation::calculate( in1[i], in2[i] );
+    }
+
+    // Bits after the last pixel of rows are 0 in both input images and they stay 0 in output image
+    // so all rows are processed as one array of words
+    template <typename TOperation>
+    void BitwiseImage( const PenguinV_Image::BinaryImage & in1, const PenguinV_Image::BinaryImage & in2, PenguinV_Image::BinaryImage & out )
+    {
+        Image_Function::ParameterValidation( in1, in2, out );
+
+        WordOperation<TOperation>( in1.data(), in2.data(), out.data(), static_cast<size_t>(out.rowSize()) * out.height() );
+    }
+
+    void InvertImage( const PenguinV_Image::BinaryImage & in, PenguinV_Image::BinaryImage & out )
+    {
+        const uint32_t rowSize = out.rowSize();
+        const uint64_t lastWordMask = out.lastWordMask();
+
+        const uint64_t * inY = in.data();
+        uint64_t * outY = out.data();
+        const uint64_t * outYEnd = outY + static_cast<size_t>(rowSize) * out.height();
+
+        for( ; outY != outYEnd; outY += rowSize, inY += rowSize ) {
+            for( uint32_t i = 0; i < rowSize; ++i )
+                outY[i] = ~inY[i];
+
+            outY[rowSize - 1] &= lastWordMask;
+        }
+    }
+
+    // Every pixel of a row takes OR of itself and a pixel which is [shift] positions to the right (toRight is true) or to the left
+    // Pixels outside of a row are 0. A row is processed in place as words are read before they are overwritten
+    void OrShiftedRow( uint64_t * row, uint32_t rowSize, uint32_t shift, bool toRight )
+    {
+        const uint32_t wordShift = shift / 64u;
+        const uint32_t bitShift  = shift % 64u;
+
+        if( wordShift >= rowSize )
+            return;
+
+        if( toRight ) {
+            for( uint32_t i = 0; i + wordShift < rowSize; ++i ) {
+                uint64_t value = row[i + wordShift] >> bitShift;
+                if( bitShift > 0u && i + wordShift + 1u < rowSize )
+                    value |= row[i + wordShift + 1u] << (64u - bitShift);
+
+                row[i] |= value;
+            }
+        }
+        else {
+            for( uint32_t i = rowSize; i-- > wordShift; ) {
+                uint64_t value = row[i - wordShift] << bitShift;
+                if( bitShift > 0u && i > wordShift )
+                    value |= row[i - wordShift - 1u] >> (64u - bitShift);
+
+                row[i] |= value;
+            }
+        }
+    }
+
+    // Window of a pixel starts from the pixel itself and it is extended to [radius] pixels on one side by steps.
+    // Every step ORs the image with a copy shifted by the current window size so the window grows twice per step
+    void DilateImage( PenguinV_Image::BinaryImage & image, uint32_t radiusX, uint32_t radiusY )
+    {
+        const uint32_t rowSize = image.rowSize();
+        const uint32_t height  = image.height();
+        const uint64_t lastWordMask = image.lastWordMask();
+
+        uint64_t * data = image.data();
+
+        radiusX = std::min( radiusX, image.width() );
+        radiusY = std::min( radiusY, height );
+
+        if( radiusX > 0u ) {
+            for( uint32_t y = 0; y < height; ++y ) {
+                uint64_t * row = data + static_cast<size_t>(y) * rowSize;
+
+                for( uint32_t direction = 0; direction < 2u; ++direction ) {
+                    for( uint32_t covered = 0; covered < radiusX; ) {
+                        const uint32_t step = std::min( covered + 1u, radiusX - covered );
+
+                        OrShiftedRow( row, rowSize, step, direction == 0u );
+                        covered += step;
+                    }
+                }
+
+                row[rowSize - 1] &= lastWordMask;
+            }
+        }
+
+        for( uint32_t direction = 0; direction < 2u; ++direction ) {
+            for( uint32_t covered = 0; covered < radiusY; ) {
+                const uint32_t step = std::min( covered + 1u, radiusY - covered );
+
+                // rows are read before they are overwritten: from top for rows below and from bottom for rows above
+                if( direction == 0u ) {
+                    for( uint32_t y = 0; y + step < height; ++y ) {
+                        uint64_t * row = data + static_cast<size_t>(y) * rowSize;
+                        WordOperation<OrOperation>( row, row + static_cast<size_t>(step) * rowSize, row, rowSize );
+                    }
+                }
+                else {
+                    for( uint32_t y = height; y-- > step; ) {
+                        uint64_t * row = data + static_cast<size_t>(y) * rowSize;
+                        WordOperation<OrOperation>( row, row - static_cast<size_t>(step) * rowSize, row, rowSize );
+                    }
+                }
+
+                covered += step;
+            }
+        }
+    }
+
+    // Sets bits of pixels within [minThreshold, maxThreshold] range. 64 pixels are converted into a word at once
+    // by comparison of bytes and gathering of their highest bits
+    void ThresholdRow( const uint8_t * in, uint64_t * out, uint32_t width, uint8_t minThreshold, uint8_t maxThreshold )
+    {
+        uint32_t x = 0;
+
+#ifdef PENGUINV_AVX_SET
+        if( isAvxAvailable ) {
+            const __m256i minimum = _mm256_set1_epi8( static_cast<char>(minThreshold) );
+            const __m256i maximum = _mm256_set1_epi8( static_cast<char>(maxThreshold) );
+
+            for( ; x + 64u <= width; x += 64u ) {
+                const __m256i data1 = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(in + x) );
+                const __m256i data2 = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(in + x + 32u) );
+
+                // a value is in range if neither maximum with lower bound nor minimum with upper bound changes it
+                const __m256i inRange1 = _mm256_and_si256( _mm256_cmpeq_epi8( _mm256_max_epu8( data1, minimum ), data1 ),
+                                                           _mm256_cmpeq_epi8( _mm256_min_epu8( data1, maximum ), data1 ) );
+                const __m256i inRange2 = _mm256_and_si256( _mm256_cmpeq_epi8( _mm256_max_epu8( data2, minimum ), data2 ),
+                                                           _mm256_cmpeq_epi8( _mm256_min_epu8( data2, maximum ), data2 ) );
+
+                out[x / 64u] = static_cast<uint64_t>( static_cast<uint32_t>( _mm256_movemask_epi8( inRange1 ) ) ) |
+                               (static_cast<uint64_t>( static_cast<uint32_t>( _mm256_movemask_epi8( inRange2 ) ) ) << 32);
+            }
+        }
+#endif
+
+#ifdef PENGUINV_SSE_SET
+        if( isSseAvailable ) {
+            const __m128i minimum = _mm_set1_epi8( static_cast<char>(minThreshold) );
+            const __m128i maximum = _mm_set1_epi8( static_cast<char>(maxThreshold) );
+
+            for( ; x + 64u <= width; x += 64u ) {
+                uint64_t word = 0u;
+
+                for( uint32_t i = 0; i < 4u; ++i ) {
+                    const __m128i data = _mm_loadu_si128( reinterpret_cast<const __m128i*>(in + x + i * 16u) );
+                    const __m128i inRange = _mm_and_si128( _mm_cmpeq_epi8( _mm_max_epu8( data, minimum ), data ),
+                                                           _mm_cmpeq_epi8( _mm_min_epu8( data, maximum ), data ) );
+
+                    word |= static_cast<uint64_t>( static_cast<uint32_t>( _mm_movemask_epi8( inRange ) ) ) << (i * 16u);
+                }
+
+                out[x / 64u] = word;
+            }
+        }
+#endif
+
+        for( ; x < width; x += 64u ) {
+            const uint32_t end = std::min( width, x + 64u );
+            uint64_t word = 0u;
+
+            for( uint32_t i = x; i < end; ++i ) {
+                if( in[i] >= minThreshold && in[i] <= maxThreshold )
+                    word |= static_cast<uint64_t>(1u) << (i - x);
+            }
+
+            out[x / 64u] = word;
+        }
+    }
+
+    void ThresholdImage( const PenguinV_Image::Image & in, uint32_t startXIn, uint32_t startYIn, PenguinV_Image::BinaryImage & out,
+                         uint8_t minThreshold, uint8_t maxThreshold )
+    {
+        Image_Function::VerifyGrayScaleImage( in );
+
+        if( minThreshold > maxThreshold )
+            throw imageException( "Minimum threshold value is bigger than maximum threshold value" );
+
+        const uint32_t rowSizeIn  = in.rowSize();
+        const uint32_t rowSizeOut = out.rowSize();
+
+        const uint8_t * inY = in.data() + startYIn * rowSizeIn + startXIn;
+        uint64_t * outY = out.data();
+        const uint64_t * outYEnd = outY + static_cast<size_t>(rowSizeOut) * out.height();
+
+        for( ; outY != outYEnd; outY += rowSizeOut, inY += rowSizeIn )
+            ThresholdRow( inY, outY, out.width(), minThreshold, maxThreshold );
+    }
+
+    void ParameterValidation( const PenguinV_Image::BinaryImage & binary, const PenguinV_Image::Image & image )
+    {
+        if( binary.empty() || image.empty() || binary.width() != image.width() || binary.height() != image.height() )
+            throw imageException( "Bad input parameters in image function" );
+    }
+}
+
+namespace Binary_Image_Function
+{
+    BinaryImage BitwiseAnd( const BinaryImage & in1, const BinaryImage & in2 )
+    {
+        BinaryImage out( in1.width(), in1.height() );
+
+        BitwiseAnd( in1, in2, out );
+
+        return out;
+    }
+
+    void BitwiseAnd( const BinaryImage & in1, const BinaryImage & in2, BinaryImage & out )
+    {
+        BitwiseImage<AndOperation>( in1, in2, out );
+    }
+
+    BinaryImage BitwiseOr( const BinaryImage & in1, const BinaryImage & in2 )
+    {
+        BinaryImage out( in1.width(), in1.height() );
+
+        BitwiseOr( in1, in2, out );
+
+        return out;
+    }
+
+    void BitwiseOr( const BinaryImage & in1, const BinaryImage & in2, BinaryImage & out )
+    {
+        BitwiseImage<OrOperation>( in1, in2, out );
+    }
+
+    BinaryImage BitwiseXor( const BinaryImage & in1, const BinaryImage & in2 )
+    {
+        BinaryImage out( in1.width(), in1.height() );
+
+        BitwiseXor( in1, in2, out );
+
+        return out;
+    }
+
+    void BitwiseXor( const BinaryImage & in1, const BinaryImage & in2, BinaryImage & out )
+    {
+        BitwiseImage<XorOperation>( in1, in2, out );
+    }
+
+    Image ConvertFromBinary( const BinaryImage & in )
+    {
+        Image out( in.width(), in.height() );
+
+        ConvertFromBinary( in, out );
+
+        return out;
+    }
+
+    void ConvertFromBinary( const BinaryImage & in, Image & out )
+    {
+        ParameterValidation( in, out );
+        Image_Function::VerifyGrayScaleImage( out );
+
+        const uint32_t rowSizeIn  = in.rowSize();
+        const uint32_t rowSizeOut = out.rowSize();
+        const uint32_t width = out.width();
+
+        const uint64_t * inY = in.data();
+        uint8_t * outY = out.data();
+        const uint8_t * outYEnd = outY + rowSizeOut * out.height();
+
+        for( ; outY != outYEnd; outY += rowSizeOut, inY += rowSizeIn ) {
+            for( uint32_t x = 0; x < width; ++x )
+                outY[x] = ((inY[x / 64u] >> (x % 64u)) & 1u) ? 255u : 0u;
+        }
+    }
+
+    BinaryImage ConvertToBinary( const Image & in )
+    {
+        return ConvertToBinary( in, 0, 0, in.width(), in.height() );
+    }
+
+    void ConvertToBinary( const Image & in, BinaryImage & out )
+    {
+        ParameterValidation( out, in );
+
+        ThresholdImage( in, 0, 0, out, 1u, 255u );
+    }
+
+    BinaryImage ConvertToBinary( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height )
+    {
+        Image_Function::ParameterValidation( in, startXIn, startYIn, width, height );
+
+        BinaryImage out( width, height );
+
+        ThresholdImage( in, startXIn, startYIn, out, 1u, 255u );
+
+        return out;
+    }
+
+    BinaryImage Dilate( const BinaryImage & in, uint32_t radiusX, uint32_t radiusY )
+    {
+        BinaryImage out( in.width(), in.height() );
+
+        Dilate( in, out, radiusX, radiusY );
+
+        return out;
+    }
+
+    void Dilate( const BinaryImage & in, BinaryImage & out, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function::ParameterValidation( in, out );
+
+        if( &in != &out )
+            std::copy( in.data(), in.data() + static_cast<size_t>(in.rowSize()) * in.height(), out.data() );
+
+        DilateImage( out, radiusX, radiusY );
+    }
+
+    BinaryImage Erode( const BinaryImage & in, uint32_t radiusX, uint32_t radiusY )
+    {
+        BinaryImage out( in.width(), in.height() );
+
+        Erode( in, out, radiusX, radiusY );
+
+        return out;
+    }
+
+    // Erosion is dilation of inverted image: pixels outside of image are 0 for dilation so they are ignored by erosion
+    void Erode( const BinaryImage & in, BinaryImage & out, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function::ParameterValidation( in, out );
+
+        InvertImage( in, out );
+        DilateImage( out, radiusX, radiusY );
+        InvertImage( out, out );
+    }
+
+    BinaryImage Invert( const BinaryImage & in )
+    {
+        BinaryImage out( in.width(), in.height() );
+
+        Invert( in, out );
+
+        return out;
+    }
+
+    void Invert( const BinaryImage & in, BinaryImage & out )
+    {
+        Image_Function::ParameterValidation( in, out );
+
+        InvertImage( in, out );
+    }
+
+    bool IsEqual( const BinaryImage & in1, const BinaryImage & in2 )
+    {
+        Image_Function::ParameterValidation( in1, in2 );
+
+        return std::equal( in1.data(), in1.data() + static_cast<size_t>(in1.rowSize()) * in1.height(), in2.data() );
+    }
+
+    std::vector < uint32_t > ProjectionProfile( const BinaryImage & image, bool horizontal )
+    {
+        std::vector < uint32_t > projection;
+
+        ProjectionProfile( image, horizontal, projection );
+
+        return projection;
+    }
+
+    void ProjectionProfile( const BinaryImage & image, bool horizontal, std::vector < uint32_t > & projection )
+    {
+        Image_Function::ParameterValidation( image );
+
+        const uint32_t rowSize = image.rowSize();
+        const uint32_t height  = image.height();
+
+        projection.resize( horizontal ? image.width() : height );
+        std::fill( projection.begin(), projection.end(), 0u );
+
+        const uint64_t * imageY = image.data();
+
+        for( uint32_t y = 0; y < height; ++y, imageY += rowSize ) {
+            if( horizontal ) {
+                // only set pixels are visited
+                for( uint32_t i = 0; i < rowSize; ++i ) {
+                    for( uint64_t value = imageY[i]; value != 0u; value &= value - 1u )
+                        ++projection[i * 64u + LowestBitPosition( value )];
+                }
+            }
+            else {
+                uint32_t sum = 0;
+
+                for( uint32_t i = 0; i < rowSize; ++i )
+                    sum += BitCount( imageY[i] );
+
+                projection[y] = sum;
+            }
+        }
+    }
+
+    uint32_t Sum( const BinaryImage & image )
+    {
+        Image_Function::ParameterValidation( image );
+
+        const uint64_t * data = image.data();
+        const uint64_t * dataEnd = data + static_cast<size_t>(image.rowSize()) * image.height();
+
+        uint32_t sum = 0;
+
+        for( ; data != dataEnd; ++data )
+            sum += BitCount( *data );
+
+        return sum;
+    }
+
+    BinaryImage Threshold( const Image & in, uint8_t threshold )
+    {
+        return Threshold( in, 0, 0, in.width(), in.height(), threshold, 255u );
+    }
+
+    void Threshold( const Image & in, BinaryImage & out, uint8_t threshold )
+    {
+        Threshold( in, out, threshold, 255u );
+    }
+
+    BinaryImage Threshold( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint8_t threshold )
+    {
+        return Threshold( in, startXIn, startYIn, width, height, threshold, 255u );
+    }
+
+    BinaryImage Threshold( const Image & in, uint8_t minThreshold, uint8_t maxThreshold )
+    {
+        return Threshold( in, 0, 0, in.width(), in.height(), minThreshold, maxThreshold );
+    }
+
+    void Threshold( const Image & in, BinaryImage & out, uint8_t minThreshold, uint8_t maxThreshold )
+    {
+        ParameterValidation( out, in );
+
+        ThresholdImage( in, 0, 0, out, minThreshold, maxThreshold );
+    }
+
+    BinaryImage Threshold( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint8_t minThreshold,
+                           uint8_t maxThreshold )
+    {
+        Image_Function::ParameterValidation( in, startXIn, startYIn, width, height );
+
+        BinaryImage out( width, height );
+
+        ThresholdImage( in, startXIn, startYIn, out, minThreshold, maxThreshold );
+
+        return out;
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+#include "binary_image.h"
+#include "image_buffer.h"
+
+namespace Binary_Image_Function
+{
+    using namespace PenguinV_Image;
+
+    // Bitwise operations process 64 pixels by one operation. Output image can be the same as any input image
+    BinaryImage BitwiseAnd( const BinaryImage & in1, const BinaryImage & in2 );
+    void        BitwiseAnd( const BinaryImage & in1, const BinaryImage & in2, BinaryImage & out );
+
+    BinaryImage BitwiseOr( const BinaryImage & in1, const BinaryImage & in2 );
+    void        BitwiseOr( const BinaryImage & in1, const BinaryImage & in2, BinaryImage & out );
+
+    BinaryImage BitwiseXor( const BinaryImage & in1, const BinaryImage & in2 );
+    void        BitwiseXor( const BinaryImage & in1, const BinaryImage & in2, BinaryImage & out );
+
+    // Converts binary image into 8-bit gray-scale image: set pixels are 255 and others are 0
+    Image ConvertFromBinary( const BinaryImage & in );
+    void  ConvertFromBinary( const BinaryImage & in, Image & out );
+
+    // Converts gray-scale image (for example, a result of Threshold function or any image for which IsBinary returns true)
+    // into binary image: non-zero pixels are set
+    BinaryImage ConvertToBinary( const Image & in );
+    void        ConvertToBinary( const Image & in, BinaryImage & out );
+    BinaryImage ConvertToBinary( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height );
+
+    // Dilation and erosion with a rectangle window of (2 * radiusX + 1) x (2 * radiusY + 1) pixels, pixels outside of image are ignored
+    // A window is built from shifted copies of rows and whole rows so it takes O(log(radius)) operations per 64 pixels
+    // Output image can be the same as input image
+    BinaryImage Dilate( const BinaryImage & in, uint32_t radiusX, uint32_t radiusY );
+    void        Dilate( const BinaryImage & in, BinaryImage & out, uint32_t radiusX, uint32_t radiusY );
+
+    BinaryImage Erode( const BinaryImage & in, uint32_t radiusX, uint32_t radiusY );
+    void        Erode( const BinaryImage & in, BinaryImage & out, uint32_t radiusX, uint32_t radiusY );
+
+    BinaryImage Invert( const BinaryImage & in );
+    void        Invert( const BinaryImage & in, BinaryImage & out );
+
+    bool IsEqual( const BinaryImage & in1, const BinaryImage & in2 );
+
+    // Number of set pixels in every column (horizontal is true) or in every row
+    std::vector < uint32_t > ProjectionProfile( const BinaryImage & image, bool horizontal );
+    void                     ProjectionProfile( const BinaryImage & image, bool horizontal, std::vector < uint32_t > & projection );
+
+    // Number of set pixels in image
+    uint32_t Sum( const BinaryImage & image );
+
+    // Thresholding of gray-scale image directly into binary image: pixels which are white in a result of Threshold function are set
+    BinaryImage Threshold( const Image & in, uint8_t threshold );
+    void        Threshold( const Image & in, BinaryImage & out, uint8_t threshold );
+    BinaryImage Threshold( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint8_t threshold );
+
+    BinaryImage Threshold( const Image & in, uint8_t minThreshold, uint8_t maxThreshold );
+    void        Threshold( const Image & in, BinaryImage & out, uint8_t minThreshold, uint8_t maxThreshold );
+    BinaryImage Threshold( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint8_t minThreshold,
+                           uint8_t maxThreshold );
+}
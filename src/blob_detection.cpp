@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <cmath>
+#include <iterator>
 #include <list>
 #include <numeric>
 #include <queue>
@@ -17,40 +19,292 @@ namespace
     };
 
     const double pi = 3.1415926536;
+
+    typedef std::pair < uint32_t, uint32_t > HullPoint;
+
+    // doubled signed area of triangle (o, a, b): positive if the triangle is counter-clockwise in Cartesian coordinates
+    int64_t crossProduct( const HullPoint & o, const HullPoint & a, const HullPoint & b )
+    {
+        return (static_cast<int64_t>(a.first) - o.first) * (static_cast<int64_t>(b.second) - o.second) -
+               (static_cast<int64_t>(a.second) - o.second) * (static_cast<int64_t>(b.first) - o.first);
+    }
+
+    uint64_t squareDistance( const HullPoint & a, const HullPoint & b )
+    {
+        const int64_t x = static_cast<int64_t>(a.first) - b.first;
+        const int64_t y = static_cast<int64_t>(a.second) - b.second;
+
+        return static_cast<uint64_t>(x * x + y * y);
+    }
+
+    // sum of k^2 for k in [0, n): the difference of 2 values gives the sum for any range even for negative values
+    double sumOfSquares( double n )
+    {
+        return (n - 1) * n * (2 * n - 1) / 6;
+    }
+
+    // runs [start, end) must be sorted by rows and by positions within a row
+    template <typename RunArray>
+    Blob_Detection::Moments calculateMoments( const RunArray & run, size_t start, size_t end )
+    {
+        // sums are calculated relative to the first run to keep precision of central moments
+        const double originX = run[start].startX;
+        const double originY = run[start].y;
+
+        double sum00 = 0;
+        double sum10 = 0;
+        double sum01 = 0;
+        double sum20 = 0;
+        double sum11 = 0;
+        double sum02 = 0;
+
+        // number of vertical pairs of blob pixels: each pair hides 2 pixel sides from perimeter
+        uint64_t verticalPairs = 0;
+
+        size_t previousRow    = end;
+        size_t previousRowEnd = end;
+
+        for( size_t row = start; row != end; ) {
+            size_t rowEnd = row;
+            for( ; (rowEnd != end) && (run[rowEnd].y == run[row].y); ++rowEnd );
+
+            if( (previousRow != end) && (run[previousRow].y + 1 == run[row].y) ) {
+                size_t top    = previousRow;
+                size_t bottom = row;
+
+                while( (top != previousRowEnd) && (bottom != rowEnd) ) {
+                    const uint32_t overlapStart = std::max( run[top].startX, run[bottom].startX );
+                    const uint32_t overlapEnd   = std::min( run[top].endX, run[bottom].endX );
+
+                    if( overlapStart < overlapEnd )
+                        verticalPairs += overlapEnd - overlapStart;
+
+                    if( run[top].endX < run[bottom].endX )
+                        ++top;
+                    else
+                        ++bottom;
+                }
+            }
+
+            previousRow    = row;
+            previousRowEnd = rowEnd;
+
+            for( ; row != rowEnd; ++row ) {
+                const double startX = run[row].startX - originX;
+                const double endX   = run[row].endX - originX;
+                const double y      = run[row].y - originY;
+                const double length = endX - startX;
+                const double sumX   = (startX + endX - 1) * length / 2;
+
+                sum00 += length;
+                sum10 += sumX;
+                sum01 += y * length;
+                sum20 += sumOfSquares( endX ) - sumOfSquares( startX );
+                sum11 += y * sumX;
+                sum02 += y * y * length;
+            }
+        }
+
+        Blob_Detection::Moments moments;
+
+        moments.m00 = sum00;
+        moments.m10 = sum10 + originX * sum00;
+        moments.m01 = sum01 + originY * sum00;
+        moments.m20 = sum20 + 2 * originX * sum10 + originX * originX * sum00;
+        moments.m11 = sum11 + originX * sum01 + originY * sum10 + originX * originY * sum00;
+        moments.m02 = sum02 + 2 * originY * sum01 + originY * originY * sum00;
+
+        moments.mu20 = sum20 - sum10 * sum10 / sum00;
+        moments.mu11 = sum11 - sum10 * sum01 / sum00;
+        moments.mu02 = sum02 - sum01 * sum01 / sum00;
+
+        // every run has 2 vertical sides and every pixel has 2 horizontal sides which are not covered by neighbours
+        moments.perimeter = static_cast<double>(2 * (end - start) + 2 * static_cast<uint64_t>(sum00) - 2 * verticalPairs);
+
+        return moments;
+    }
+
+    // A rectangle with the same second order moments as blob. Rectangles are measured between pixel centers
+    // so a rectangle of pixels has its real size reduced by 1 as well as the minimum area rectangle of such blob
+    Blob_Detection::OrientedArea equivalentRectangle( const Blob_Detection::Moments & moments )
+    {
+        const double varianceSum        = (moments.mu20 + moments.mu02) / 2;
+        const double varianceDifference = sqrt( (moments.mu20 - moments.mu02) * (moments.mu20 - moments.mu02) / 4 + moments.mu11 * moments.mu11 );
+
+        // variance of a row of n pixels is (n^2 - 1) / 12
+        const double width  = sqrt( std::max( 12 * (varianceSum + varianceDifference) / moments.m00 + 1, 1.0 ) ) - 1;
+        const double height = sqrt( std::max( 12 * (varianceSum - varianceDifference) / moments.m00 + 1, 1.0 ) ) - 1;
+
+        Blob_Detection::OrientedArea area;
+
+        area.center = Point2d( moments.m10 / moments.m00, moments.m01 / moments.m00 );
+        area.width  = width;
+        area.height = height;
+        area.angle  = atan2( 2 * moments.mu11, moments.mu20 - moments.mu02 ) / 2;
+
+        return area;
+    }
+
+    uint32_t findRoot( std::vector < uint32_t > & parent, uint32_t id )
+    {
+        while( parent[id] != id ) {
+            parent[id] = parent[parent[id]]; // path halving
+            id = parent[id];
+        }
+
+        return id;
+    }
+
+    void mergeLabels( std::vector < uint32_t > & parent, uint32_t id1, uint32_t id2 )
+    {
+        id1 = findRoot( parent, id1 );
+        id2 = findRoot( parent, id2 );
+
+        // the smallest label is always a root so blobs are ordered by position of their first pixel as in flood fill search
+        if( id1 < id2 )
+            parent[id2] = id1;
+        else if( id2 < id1 )
+            parent[id1] = id2;
+    }
 }
 
 namespace Blob_Detection
 {
+    RunStorage::RunStorage( const std::vector < PointRun > & run )
+        : _offsetX( 0 )
+        , _offsetY( 0 )
+    {
+        if( run.empty() )
+            return;
+
+        uint32_t maximumX = 0;
+        uint32_t maximumY = 0;
+
+        _offsetX = run.front().startX;
+        _offsetY = run.front().y;
+
+        for( std::vector < PointRun >::const_iterator point = run.begin(); point != run.end(); ++point ) {
+            _offsetX = std::min( _offsetX, point->startX );
+            _offsetY = std::min( _offsetY, point->y );
+            maximumX = std::max( maximumX, point->endX );
+            maximumY = std::max( maximumY, point->y );
+        }
+
+        if( (maximumX - _offsetX <= 0xFFFFu) && (maximumY - _offsetY <= 0xFFFFu) ) {
+            _compactY.resize( run.size() );
+            _compactStartX.resize( run.size() );
+            _compactEndX.resize( run.size() );
+
+            for( size_t id = 0; id < run.size(); ++id ) {
+                _compactY[id]      = static_cast<uint16_t>(run[id].y - _offsetY);
+                _compactStartX[id] = static_cast<uint16_t>(run[id].startX - _offsetX);
+                _compactEndX[id]   = static_cast<uint16_t>(run[id].endX - _offsetX);
+            }
+        }
+        else {
+            _y.resize( run.size() );
+            _startX.resize( run.size() );
+            _endX.resize( run.size() );
+
+            for( size_t id = 0; id < run.size(); ++id ) {
+                _y[id]      = run[id].y;
+                _startX[id] = run[id].startX;
+                _endX[id]   = run[id].endX;
+            }
+        }
+    }
+
+    PointRun RunStorage::operator[]( size_t id ) const
+    {
+        PointRun run;
+
+        if( isCompact() ) {
+            run.y      = _compactY[id] + _offsetY;
+            run.startX = _compactStartX[id] + _offsetX;
+            run.endX   = _compactEndX[id] + _offsetX;
+        }
+        else {
+            run.y      = _y[id];
+            run.startX = _startX[id];
+            run.endX   = _endX[id];
+        }
+
+        return run;
+    }
+
+    size_t RunStorage::size() const
+    {
+        return isCompact() ? _compactY.size() : _y.size();
+    }
+
+    bool RunStorage::isCompact() const
+    {
+        return !_compactY.empty();
+    }
+
+    BlobInfo::BlobInfo()
+        : _runStart( 0 )
+        , _runEnd  ( 0 )
+        , _size    ( 0 )
+    {
+    }
+
     const std::vector < uint32_t > & BlobInfo::pointX() const
     {
+        _extractPoints();
+
         return _pointX;
     }
 
     const std::vector < uint32_t > & BlobInfo::pointY() const
     {
+        _extractPoints();
+
         return _pointY;
     }
 
     const std::vector < uint32_t > & BlobInfo::contourX() const
     {
+        _extractPoints();
+
         return _contourX;
     }
 
     const std::vector < uint32_t > & BlobInfo::contourY() const
     {
+        _extractPoints();
+
         return _contourY;
     }
 
     const std::vector < uint32_t > & BlobInfo::edgeX() const
     {
+        _extractPoints();
+
         return _edgeX;
     }
 
     const std::vector < uint32_t > & BlobInfo::edgeY() const
     {
+        _extractPoints();
+
         return _edgeY;
     }
 
+    const std::vector < uint32_t > & BlobInfo::convexHullX() const
+    {
+        _getConvexHull();
+
+        return _convexHullX;
+    }
+
+    const std::vector < uint32_t > & BlobInfo::convexHullY() const
+    {
+        _getConvexHull();
+
+        return _convexHullY;
+    }
+
     Area BlobInfo::area()
     {
         _getArea();
@@ -123,9 +377,33 @@ namespace Blob_Detection
         return _length.value;
     }
 
+    OrientedArea BlobInfo::minimumArea()
+    {
+        _getMinimumArea();
+
+        return _minimumArea.value;
+    }
+
+    OrientedArea BlobInfo::minimumArea() const
+    {
+        return _minimumArea.value;
+    }
+
+    Moments BlobInfo::moments()
+    {
+        _getMoments();
+
+        return _moments.value;
+    }
+
+    Moments BlobInfo::moments() const
+    {
+        return _moments.value;
+    }
+
     size_t BlobInfo::size() const
     {
-        return _pointX.size();
+        return _size;
     }
 
     uint32_t BlobInfo::width()
@@ -142,9 +420,27 @@ namespace Blob_Detection
 
     bool BlobInfo::isSolid() const
     {
+        if( !_hasPoints() )
+            throw imageException( "Blob found in SEARCH_MOMENTS mode has no edge points to check whether it is solid" );
+
+        _extractPoints();
+
         return _contourX.size() == _edgeX.size();
     }
 
+    size_t BlobInfo::runCount() const
+    {
+        return _runEnd - _runStart;
+    }
+
+    PointRun BlobInfo::run( size_t id ) const
+    {
+        if( id >= runCount() )
+            throw imageException( "Run index is out of range" );
+
+        return (*_runStorage)[_runStart + id];
+    }
+
     void BlobInfo::_getArea()
     {
         if( !_contourX.empty() && !_contourY.empty() && !_area.found ) {
@@ -160,9 +456,9 @@ namespace Blob_Detection
     void BlobInfo::_getCenter()
     {
         if( !_pointX.empty() && !_pointY.empty() && !_center.found ) {
-            _center.value.x = static_cast <double>(std::accumulate( _pointX.begin(), _pointX.end(), 0 )) /
+            _center.value.x = static_cast <double>(std::accumulate( _pointX.begin(), _pointX.end(), static_cast<uint64_t>(0) )) /
                 static_cast <double>(size());
-            _center.value.y = static_cast <double>(std::accumulate( _pointY.begin(), _pointY.end(), 0 )) /
+            _center.value.y = static_cast <double>(std::accumulate( _pointY.begin(), _pointY.end(), static_cast<uint64_t>(0) )) /
                 static_cast <double>(size());
 
             _center.found = true;
@@ -171,6 +467,20 @@ namespace Blob_Detection
 
     void BlobInfo::_getCircularity()
     {
+        if( !_hasPoints() ) {
+            if( _moments.found && !_circularity.found ) {
+                // perimeter along pixel sides is longer than the real one by 4 / pi on average
+                const double perimeter = _moments.value.perimeter * pi / 4;
+
+                _circularity.value = std::min( 4 * pi * _moments.value.m00 / (perimeter * perimeter), 1.0 );
+                _circularity.found = true;
+            }
+
+            return;
+        }
+
+        _extractPoints();
+
         if( !_contourX.empty() && !_circularity.found ) {
             const double radius = sqrt( static_cast<double>(size()) / pi );
             _getCenter();
@@ -194,108 +504,201 @@ namespace Blob_Detection
 
     void BlobInfo::_getElongation()
     {
-        if( !_contourX.empty() && !_contourY.empty() && !_elongation.found ) {
-            if( _contourX.size() > 1 ) {
-                std::vector < uint32_t >::const_iterator x   = _contourX.cbegin();
-                std::vector < uint32_t >::const_iterator y   = _contourY.cbegin();
-                std::vector < uint32_t >::const_iterator end = _contourX.cend();
+        _getMinimumArea();
 
-                uint32_t maximumDistance = 0;
+        if( _minimumArea.found && !_elongation.found ) {
+            const double length = std::max( _minimumArea.value.width, _minimumArea.value.height );
+            double height       = std::min( _minimumArea.value.width, _minimumArea.value.height );
 
-                Point2d startPoint, endPoint;
+            if( height < 1 )
+                height = 1;
 
-                for( ; x != (end - 1); ++x, ++y ) {
-                    std::vector < uint32_t >::const_iterator xx = x + 1;
-                    std::vector < uint32_t >::const_iterator yy = y + 1;
+            // a single pixel has no length
+            _elongation.value = (length > 0) ? length / height : 1;
 
-                    for( ; xx != end; ++xx, ++yy ) {
-                        uint32_t distance = (*x - *xx) * (*x - *xx) + (*y - *yy) * (*y - *yy);
+            _elongation.found = true;
+        }
+    }
 
-                        if( maximumDistance < distance ) {
-                            maximumDistance = distance;
+    void BlobInfo::_getHeight()
+    {
+        if( !_contourY.empty() && !_height.found ) {
+            _height.value = *(std::max_element( _contourY.begin(), _contourY.end() )) -
+                *(std::min_element( _contourY.begin(), _contourY.end() )) + 1;
 
-                            startPoint.x = *x;
-                            startPoint.y = *y;
+            _height.found = true;
+        }
+    }
 
-                            endPoint.x = *xx;
-                            endPoint.y = *xx;
-                        }
-                    }
-                }
+    void BlobInfo::_getLength()
+    {
+        if( !_hasPoints() ) {
+            _getMinimumArea();
+
+            if( _minimumArea.found && !_length.found ) {
+                _length.value = sqrt( _minimumArea.value.width * _minimumArea.value.width +
+                                      _minimumArea.value.height * _minimumArea.value.height );
+                _length.found = true;
+            }
 
-                const double length = sqrt( static_cast<double>(maximumDistance) );
-                const double angle  = -atan2( static_cast<double>(endPoint.y - startPoint.y),
-                                              static_cast<double>(endPoint.x - startPoint.x) );
+            return;
+        }
 
-                const double _cos = cos( angle );
-                const double _sin = sin( angle );
+        _getConvexHull();
 
-                std::vector < double > contourYTemp( _contourY.begin(), _contourY.end() );
+        if( !_convexHullX.empty() && !_length.found ) {
+            const size_t hullSize = _convexHullX.size();
 
-                std::vector < uint32_t >::const_iterator xRotated   = _contourX.begin();
-                std::vector < double >::iterator yRotated           = contourYTemp.begin();
-                std::vector < uint32_t >::const_iterator endRotated = _contourX.end();
+            // the most distant pair of points is among antipodal pairs of hull vertices so for every edge of hull
+            // we move the opposite vertex forward while it goes away from the edge
+            uint64_t maximumDistance = 0;
+            size_t opposite = 1 % hullSize;
 
-                for( ; xRotated != endRotated; ++xRotated, ++yRotated )
-                    (*yRotated) = (*xRotated - startPoint.x) * _sin + (*yRotated - startPoint.y) * _cos;
+            for( size_t i = 0; i < hullSize; ++i ) {
+                const size_t next = (i + 1) % hullSize;
 
-                double height = *(std::max_element( contourYTemp.begin(), contourYTemp.end() )) -
-                    *(std::min_element( contourYTemp.begin(), contourYTemp.end() ));
+                const HullPoint start( _convexHullX[i], _convexHullY[i] );
+                const HullPoint end  ( _convexHullX[next], _convexHullY[next] );
 
-                if( height < 1 )
-                    height = 1;
+                for( ; ; ) {
+                    const size_t candidate = (opposite + 1) % hullSize;
 
-                _elongation.value = length / height;
-            }
-            else {
-                _elongation.value = 1;
+                    if( crossProduct( start, end, HullPoint( _convexHullX[candidate], _convexHullY[candidate] ) ) <=
+                        crossProduct( start, end, HullPoint( _convexHullX[opposite], _convexHullY[opposite] ) ) )
+                        break;
+
+                    opposite = candidate;
+                }
+
+                const HullPoint point( _convexHullX[opposite], _convexHullY[opposite] );
+
+                maximumDistance = std::max( maximumDistance, std::max( squareDistance( start, point ), squareDistance( end, point ) ) );
             }
 
-            _elongation.found = true;
+            _length.value = sqrt( static_cast<double>(maximumDistance) );
+
+            _length.found = true;
         }
     }
 
-    void BlobInfo::_getHeight()
+    void BlobInfo::_getMinimumArea()
     {
-        if( !_contourY.empty() && !_height.found ) {
-            _height.value = *(std::max_element( _contourY.begin(), _contourY.end() )) -
-                *(std::min_element( _contourY.begin(), _contourY.end() )) + 1;
+        if( !_hasPoints() ) {
+            if( _moments.found && !_minimumArea.found ) {
+                _minimumArea.value = equivalentRectangle( _moments.value );
+                _minimumArea.found = true;
+            }
 
-            _height.found = true;
+            return;
+        }
+
+        _getConvexHull();
+
+        if( !_convexHullX.empty() && !_minimumArea.found ) {
+            const size_t hullSize = _convexHullX.size();
+
+            _minimumArea.value = OrientedArea();
+            _minimumArea.value.center = Point2d( _convexHullX.front(), _convexHullY.front() );
+
+            // one side of minimum area rectangle lies on an edge of hull. For every edge we keep 3 calipers
+            // touching the hull: the farthest vertices along the edge in both directions and the farthest vertex from the edge.
+            // All of them only move forward while the edge rotates so the whole search is linear
+            double minimumArea = -1;
+            size_t right = 0;
+            size_t top   = 0;
+            size_t left  = 0;
+
+            for( size_t i = 0; (i < hullSize) && (hullSize > 1); ++i ) {
+                const size_t next = (i + 1) % hullSize;
+
+                const double startX = _convexHullX[i];
+                const double startY = _convexHullY[i];
+                const double length = sqrt( static_cast<double>(squareDistance( HullPoint( _convexHullX[i], _convexHullY[i] ),
+                                                                                HullPoint( _convexHullX[next], _convexHullY[next] ) )) );
+                const double directionX = (_convexHullX[next] - startX) / length;
+                const double directionY = (_convexHullY[next] - startY) / length;
+
+                const auto alongEdge = [&]( size_t id ) {
+                    return (_convexHullX[id] - startX) * directionX + (_convexHullY[id] - startY) * directionY; };
+                const auto acrossEdge = [&]( size_t id ) {
+                    return (_convexHullY[id] - startY) * directionX - (_convexHullX[id] - startX) * directionY; };
+
+                if( i == 0 ) {
+                    for( size_t id = 1; id < hullSize; ++id ) {
+                        if( alongEdge( id ) > alongEdge( right ) )
+                            right = id;
+                        if( acrossEdge( id ) > acrossEdge( top ) )
+                            top = id;
+                        if( alongEdge( id ) < alongEdge( left ) )
+                            left = id;
+                    }
+                }
+                else {
+                    while( alongEdge( (right + 1) % hullSize ) > alongEdge( right ) )
+                        right = (right + 1) % hullSize;
+                    while( acrossEdge( (top + 1) % hullSize ) > acrossEdge( top ) )
+                        top = (top + 1) % hullSize;
+                    while( alongEdge( (left + 1) % hullSize ) < alongEdge( left ) )
+                        left = (left + 1) % hullSize;
+                }
+
+                const double width  = alongEdge( right ) - alongEdge( left );
+                const double height = acrossEdge( top );
+
+                if( minimumArea < 0 || width * height < minimumArea ) {
+                    minimumArea = width * height;
+
+                    const double middle = (alongEdge( right ) + alongEdge( left )) / 2;
+
+                    _minimumArea.value.center = Point2d( startX + middle * directionX - height / 2 * directionY,
+                                                         startY + middle * directionY + height / 2 * directionX );
+                    _minimumArea.value.width  = width;
+                    _minimumArea.value.height = height;
+                    _minimumArea.value.angle  = atan2( directionY, directionX );
+                }
+            }
+
+            _minimumArea.found = true;
         }
     }
 
-    void BlobInfo::_getLength()
+    void BlobInfo::_getMoments()
     {
-        if( !_contourX.empty() && !_contourY.empty() && !_length.found ) {
-            if( _contourX.size() > 1 ) {
-                std::vector < uint32_t >::const_iterator x   = _contourX.cbegin();
-                std::vector < uint32_t >::const_iterator y   = _contourY.cbegin();
-                std::vector < uint32_t >::const_iterator end = _contourX.cend();
+        if( _moments.found || !_hasPoints() )
+            return;
 
-                int32_t maximumDistance = 0;
+        if( !_runStorage ) {
+            // blob found by flood fill: points are sorted by rows and joined into runs
+            std::vector < HullPoint > point( _pointX.size() );
 
-                for( ; x != (end - 1); ++x, ++y ) {
-                    std::vector < uint32_t >::const_iterator xx = x + 1;
-                    std::vector < uint32_t >::const_iterator yy = y + 1;
+            for( size_t i = 0; i < point.size(); ++i )
+                point[i] = HullPoint( _pointY[i], _pointX[i] );
 
-                    for( ; xx != end; ++xx, ++yy ) {
-                        int32_t distance = static_cast<int32_t>(*x - *xx) * static_cast<int32_t>(*x - *xx) +
-                            static_cast<int32_t>(*y - *yy) * static_cast<int32_t>(*y - *yy);
+            std::sort( point.begin(), point.end() );
 
-                        if( maximumDistance < distance )
-                            maximumDistance = distance;
-                    }
-                }
+            std::vector < PointRun > run;
 
-                _length.value = sqrt( static_cast<double>(maximumDistance) );
-            }
-            else {
-                _length.value = 0;
+            for( std::vector < HullPoint >::const_iterator current = point.begin(); current != point.end(); ++current ) {
+                if( run.empty() || (run.back().y != current->first) || (run.back().endX != current->second) ) {
+                    PointRun newRun;
+                    newRun.y      = current->first;
+                    newRun.startX = current->second;
+                    newRun.endX   = current->second + 1;
+
+                    run.push_back( newRun );
+                }
+                else {
+                    ++run.back().endX;
+                }
             }
 
-            _length.found = true;
+            _moments.value = calculateMoments( run, 0, run.size() );
+        }
+        else {
+            _moments.value = calculateMoments( *_runStorage, _runStart, _runEnd );
         }
+
+        _moments.found = true;
     }
 
     void BlobInfo::_getWidth()
@@ -308,14 +711,167 @@ namespace Blob_Detection
         }
     }
 
+    bool BlobInfo::_hasPoints() const
+    {
+        return _runStorage || !_pointX.empty();
+    }
+
+    void BlobInfo::_extractPoints() const
+    {
+        if( _pointLock.ready.load( std::memory_order_acquire ) )
+            return;
+
+        std::lock_guard < std::mutex > guard( _pointLock.mutex );
+
+        if( !_pointLock.ready.load( std::memory_order_relaxed ) ) {
+            _findPoints();
+            _pointLock.ready.store( true, std::memory_order_release );
+        }
+    }
+
+    void BlobInfo::_findPoints() const
+    {
+        if( !_runStorage || !_pointX.empty() )
+            return;
+
+        // area is always calculated during run-length search
+        const uint32_t left     = _area.value.left;
+        const uint32_t top      = _area.value.top;
+        const uint32_t mapWidth = _area.value.right - left + 2;
+
+        // we make the map by 2 pixels bigger in each direction so we don't need to check borders of map
+        std::vector < uint8_t > imageMap( mapWidth * (_area.value.bottom - top + 2), EMPTY );
+
+        _pointX.reserve( _size );
+        _pointY.reserve( _size );
+
+        for( size_t id = _runStart; id != _runEnd; ++id ) {
+            const PointRun run = (*_runStorage)[id];
+
+            std::fill( imageMap.begin() + (run.y - top + 1) * mapWidth + (run.startX - left + 1),
+                       imageMap.begin() + (run.y - top + 1) * mapWidth + (run.endX   - left + 1), FOUND );
+
+            for( uint32_t x = run.startX; x != run.endX; ++x ) {
+                _pointX.push_back( x );
+                _pointY.push_back( run.y );
+            }
+        }
+
+        const std::ptrdiff_t width = static_cast<std::ptrdiff_t>(mapWidth);
+        const std::ptrdiff_t neighbour[8] = { -width - 1, -width, -width + 1, -1, 1, width - 1, width, width + 1 };
+        // offsets of neighbours in X and Y directions shifted by 1 to keep values unsigned
+        const uint32_t neighbourX[8] = { 0, 1, 2, 0, 2, 0, 1, 2 };
+        const uint32_t neighbourY[8] = { 0, 0, 0, 1, 1, 2, 2, 2 };
+
+        // a pixel is an edge pixel if any of its 8 neighbours does not belong to the blob
+        std::vector < uint32_t >::const_iterator x   = _pointX.begin();
+        std::vector < uint32_t >::const_iterator y   = _pointY.begin();
+        std::vector < uint32_t >::const_iterator end = _pointX.end();
+
+        for( ; x != end; ++x, ++y ) {
+            uint8_t * position = imageMap.data() + (*y - top + 1) * mapWidth + (*x - left + 1);
+
+            for( uint8_t i = 0; i < 8; ++i ) {
+                if( *(position + neighbour[i]) == EMPTY ) {
+                    _edgeX.push_back( *x );
+                    _edgeY.push_back( *y );
+                    *position = EDGE;
+                    break;
+                }
+            }
+        }
+
+        // contour points are edge points connected to the first pixel of blob which is always an outer edge pixel
+        _contourX.push_back( _pointX.front() );
+        _contourY.push_back( _pointY.front() );
+
+        imageMap[mapWidth + (_pointX.front() - left + 1)] = CONTOUR;
+
+        size_t pointId = 0;
+
+        do {
+            const uint32_t xMap = _contourX[pointId];
+            const uint32_t yMap = _contourY[pointId++];
+
+            uint8_t * position = imageMap.data() + (yMap - top + 1) * mapWidth + (xMap - left + 1);
+
+            for( uint8_t i = 0; i < 8; ++i ) {
+                if( *(position + neighbour[i]) == EDGE ) {
+                    _contourX.push_back( xMap + neighbourX[i] - 1 );
+                    _contourY.push_back( yMap + neighbourY[i] - 1 );
+                    *(position + neighbour[i]) = CONTOUR;
+                }
+            }
+        } while( pointId != _contourX.size() );
+    }
+
+    void BlobInfo::_getConvexHull() const
+    {
+        if( _hullLock.ready.load( std::memory_order_acquire ) )
+            return;
+
+        std::lock_guard < std::mutex > guard( _hullLock.mutex );
+
+        if( !_hullLock.ready.load( std::memory_order_relaxed ) ) {
+            _extractPoints();
+            _findConvexHull();
+            _hullLock.ready.store( true, std::memory_order_release );
+        }
+    }
+
+    void BlobInfo::_findConvexHull() const
+    {
+        if( _contourX.empty() || !_convexHullX.empty() )
+            return;
+
+        std::vector < HullPoint > point( _contourX.size() );
+
+        for( size_t i = 0; i < point.size(); ++i )
+            point[i] = HullPoint( _contourX[i], _contourY[i] );
+
+        std::sort( point.begin(), point.end() );
+
+        // lower and upper chains keep only left turns, the first point is repeated at the end of the upper chain
+        std::vector < HullPoint > hull( 2 * point.size() );
+        size_t hullSize = 0;
+
+        for( size_t i = 0; i < point.size(); ++i ) {
+            while( hullSize >= 2 && crossProduct( hull[hullSize - 2], hull[hullSize - 1], point[i] ) <= 0 )
+                --hullSize;
+
+            hull[hullSize++] = point[i];
+        }
+
+        const size_t lowerSize = hullSize + 1;
+
+        for( size_t i = point.size() - 1; i > 0; --i ) {
+            while( hullSize >= lowerSize && crossProduct( hull[hullSize - 2], hull[hullSize - 1], point[i - 1] ) <= 0 )
+                --hullSize;
+
+            hull[hullSize++] = point[i - 1];
+        }
+
+        if( hullSize > 1 )
+            --hullSize;
+
+        _convexHullX.resize( hullSize );
+        _convexHullY.resize( hullSize );
+
+        for( size_t i = 0; i < hullSize; ++i ) {
+            _convexHullX[i] = hull[i].first;
+            _convexHullY[i] = hull[i].second;
+        }
+    }
+
 
-    const std::vector < BlobInfo > & BlobDetection::find( const PenguinV_Image::Image & image, BlobParameters parameter, uint8_t threshold )
+    const std::vector < BlobInfo > & BlobDetection::find( const PenguinV_Image::Image & image, BlobParameters parameter, uint8_t threshold,
+                                                          SearchMode mode )
     {
-        return find( image, 0, 0, image.width(), image.height(), parameter, threshold );
+        return find( image, 0, 0, image.width(), image.height(), parameter, threshold, mode );
     }
 
     const std::vector < BlobInfo > & BlobDetection::find( const PenguinV_Image::Image & image, uint32_t x, uint32_t y, uint32_t width,
-                                                          uint32_t height, BlobParameters parameter, uint8_t threshold )
+                                                          uint32_t height, BlobParameters parameter, uint8_t threshold, SearchMode mode )
     {
         Image_Function::ParameterValidation( image, x, y, width, height );
         Image_Function::VerifyGrayScaleImage( image );
@@ -324,6 +880,15 @@ namespace Blob_Detection
 
         _blob.clear();
 
+        if( mode == SEARCH_MOMENTS ) {
+            std::vector < PointRun > run;
+            std::vector < uint32_t > label;
+
+            _findRuns( image, x, y, width, height, threshold, run, label );
+
+            return _createBlobs( run, label, parameter, false );
+        }
+
         // we make the area by 2 pixels bigger in each direction so we don't need to check borders of map
         std::vector < uint8_t > imageMap( (width + 2) * (height + 2), EMPTY );
 
@@ -472,6 +1037,8 @@ namespace Blob_Detection
                     }
                 } while( pointId != pointX.size() );
 
+                newBlob._size = pointX.size();
+
                 // Now we can extract outer edge points or so called contour points
                 std::vector < uint32_t > & contourX = newBlob._contourX;
                 std::vector < uint32_t > & contourY = newBlob._contourY;
@@ -550,60 +1117,312 @@ namespace Blob_Detection
             }
         }
 
+        std::vector < BlobInfo > blob( std::make_move_iterator( foundBlob.begin() ), std::make_move_iterator( foundBlob.end() ) );
+
+        return _filter( blob, parameter );
+    }
+
+    const std::vector < BlobInfo > & BlobDetection::findRunLength( const PenguinV_Image::Image & image, BlobParameters parameter,
+                                                                   uint8_t threshold )
+    {
+        return findRunLength( image, 0, 0, image.width(), image.height(), parameter, threshold );
+    }
+
+    const std::vector < BlobInfo > & BlobDetection::findRunLength( const PenguinV_Image::Image & image, uint32_t x, uint32_t y, uint32_t width,
+                                                                   uint32_t height, BlobParameters parameter, uint8_t threshold )
+    {
+        Image_Function::ParameterValidation( image, x, y, width, height );
+        Image_Function::VerifyGrayScaleImage( image );
+
+        parameter._verify();
+
+        _blob.clear();
+
+        std::vector < PointRun > run;
+        std::vector < uint32_t > label;
+
+        _findRuns( image, x, y, width, height, threshold, run, label );
+
+        return _createBlobs( run, label, parameter );
+    }
+
+    const std::vector < BlobInfo > & BlobDetection::findRunLength( const PenguinV_Image::BinaryImage & image, BlobParameters parameter )
+    {
+        Image_Function::ParameterValidation( image );
+
+        parameter._verify();
+
+        _blob.clear();
+
+        std::vector < PointRun > run;
+        std::vector < uint32_t > label;
+
+        _findRuns( image, run, label );
+
+        return _createBlobs( run, label, parameter );
+    }
+
+    const std::vector < BlobInfo > & BlobDetection::_filter( std::vector < BlobInfo > & foundBlob, const BlobParameters & parameter )
+    {
         // All blobs found. Now we need to sort them
         if( parameter.circularity.checkMaximum || parameter.circularity.checkMinimum ) {
             std::for_each( foundBlob.begin(), foundBlob.end(), []( BlobInfo & info ) { info._getCircularity(); } );
 
-            foundBlob.remove_if( [&parameter]( const BlobInfo & info ) {
+            foundBlob.erase( std::remove_if( foundBlob.begin(), foundBlob.end(), [&parameter]( const BlobInfo & info ) {
                 return (parameter.circularity.checkMaximum && info.circularity() > parameter.circularity.maximum) ||
-                       (parameter.circularity.checkMinimum && info.circularity() < parameter.circularity.minimum); } );
+                       (parameter.circularity.checkMinimum && info.circularity() < parameter.circularity.minimum); } ), foundBlob.end() );
         }
 
         if( parameter.elongation.checkMaximum || parameter.elongation.checkMinimum ) {
             std::for_each( foundBlob.begin(), foundBlob.end(), []( BlobInfo & info ) { info._getElongation(); } );
 
-            foundBlob.remove_if( [&parameter]( const BlobInfo & info ) {
+            foundBlob.erase( std::remove_if( foundBlob.begin(), foundBlob.end(), [&parameter]( const BlobInfo & info ) {
                 return (parameter.elongation.checkMaximum && info.elongation() > parameter.elongation.maximum) ||
-                       (parameter.elongation.checkMinimum && info.elongation() < parameter.elongation.minimum); } );
+                       (parameter.elongation.checkMinimum && info.elongation() < parameter.elongation.minimum); } ), foundBlob.end() );
         }
 
         if( parameter.height.checkMaximum || parameter.height.checkMinimum ) {
             std::for_each( foundBlob.begin(), foundBlob.end(), []( BlobInfo & info ) { info._getHeight(); } );
 
-            foundBlob.remove_if( [&parameter]( const BlobInfo & info ) {
+            foundBlob.erase( std::remove_if( foundBlob.begin(), foundBlob.end(), [&parameter]( const BlobInfo & info ) {
                 return (parameter.height.checkMaximum && info.height() > parameter.height.maximum) ||
-                       (parameter.height.checkMinimum && info.height() < parameter.height.minimum); } );
+                       (parameter.height.checkMinimum && info.height() < parameter.height.minimum); } ), foundBlob.end() );
         }
 
         if( parameter.length.checkMaximum || parameter.length.checkMinimum ) {
             std::for_each( foundBlob.begin(), foundBlob.end(), []( BlobInfo & info ) { info._getLength(); } );
 
-            foundBlob.remove_if( [&parameter]( const BlobInfo & info ) {
+            foundBlob.erase( std::remove_if( foundBlob.begin(), foundBlob.end(), [&parameter]( const BlobInfo & info ) {
                 return (parameter.length.checkMaximum && info.length() > parameter.length.maximum) ||
-                       (parameter.length.checkMinimum && info.length() < parameter.length.minimum); } );
+                       (parameter.length.checkMinimum && info.length() < parameter.length.minimum); } ), foundBlob.end() );
         }
 
         if( parameter.size.checkMaximum || parameter.size.checkMinimum ) {
-            foundBlob.remove_if( [&parameter]( const BlobInfo & info ) {
+            foundBlob.erase( std::remove_if( foundBlob.begin(), foundBlob.end(), [&parameter]( const BlobInfo & info ) {
                 return (parameter.size.checkMaximum && info.size() > parameter.size.maximum) ||
-                       (parameter.size.checkMinimum && info.size() < parameter.size.minimum); } );
+                       (parameter.size.checkMinimum && info.size() < parameter.size.minimum); } ), foundBlob.end() );
         }
 
         if( parameter.width.checkMaximum || parameter.width.checkMinimum ) {
             std::for_each( foundBlob.begin(), foundBlob.end(), []( BlobInfo & info ) { info._getWidth(); } );
 
-            foundBlob.remove_if( [&parameter]( const BlobInfo & info ) {
+            foundBlob.erase( std::remove_if( foundBlob.begin(), foundBlob.end(), [&parameter]( const BlobInfo & info ) {
                 return (parameter.width.checkMaximum && info.width() > parameter.width.maximum) ||
-                       (parameter.width.checkMinimum && info.width() < parameter.width.minimum); } );
+                       (parameter.width.checkMinimum && info.width() < parameter.width.minimum); } ), foundBlob.end() );
         }
 
         // prepare data for output
-        std::vector <BlobInfo> blobTemp ( foundBlob.begin(), foundBlob.end() );
-        std::swap( _blob, blobTemp );
+        std::swap( _blob, foundBlob );
 
         return get();
     }
 
+    void BlobDetection::_findRuns( const PenguinV_Image::Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                                   uint8_t threshold, std::vector < PointRun > & run, std::vector < uint32_t > & label )
+    {
+        const uint32_t rowSize = image.rowSize();
+
+        const uint8_t * imageY    = image.data() + y * rowSize + x;
+        const uint8_t * imageYEnd = imageY + height * rowSize;
+
+        size_t previousRowStart = run.size();
+        size_t previousRowEnd   = run.size();
+
+        for( uint32_t rowId = y; imageY != imageYEnd; imageY += rowSize, ++rowId ) {
+            const uint8_t * imageX    = imageY;
+            const uint8_t * imageXEnd = imageX + width;
+
+            const size_t currentRowStart = run.size();
+
+            while( imageX != imageXEnd ) {
+                for( ; (imageX != imageXEnd) && ((*imageX) < threshold); ++imageX );
+
+                if( imageX == imageXEnd )
+                    break;
+
+                PointRun newRun;
+                newRun.y      = rowId;
+                newRun.startX = static_cast<uint32_t>(imageX - imageY) + x;
+
+                for( ; (imageX != imageXEnd) && ((*imageX) >= threshold); ++imageX );
+
+                newRun.endX = static_cast<uint32_t>(imageX - imageY) + x;
+
+                label.push_back( static_cast<uint32_t>(run.size()) );
+                run.push_back( newRun );
+            }
+
+            _mergeRows( run, label, previousRowStart, previousRowEnd, currentRowStart, run.size() );
+
+            previousRowStart = currentRowStart;
+            previousRowEnd   = run.size();
+        }
+    }
+
+    void BlobDetection::_findRuns( const PenguinV_Image::BinaryImage & image, std::vector < PointRun > & run, std::vector < uint32_t > & label )
+    {
+        const uint32_t rowSize = image.rowSize();
+
+        const uint64_t * imageY    = image.data();
+        const uint64_t * imageYEnd = imageY + static_cast<size_t>(image.height()) * rowSize;
+
+        size_t previousRowStart = run.size();
+        size_t previousRowEnd   = run.size();
+
+        for( uint32_t rowId = 0; imageY != imageYEnd; imageY += rowSize, ++rowId ) {
+            const size_t currentRowStart = run.size();
+
+            PointRun newRun;
+            newRun.y = rowId;
+
+            bool isRunOpen = false;
+            uint64_t carry = 0u; // the last pixel of previous word
+
+            for( uint32_t wordId = 0; wordId < rowSize; ++wordId ) {
+                const uint64_t value = imageY[wordId];
+
+                // a bit is set where pixel differs from its left neighbour so edges are starts and ends of runs by turns
+                uint64_t edge = value ^ ((value << 1) | carry);
+                carry = value >> 63;
+
+                for( ; edge != 0u; edge &= edge - 1u ) {
+                    const uint32_t position = wordId * 64u + PenguinV_Image::LowestBitPosition( edge );
+
+                    if( isRunOpen ) {
+                        newRun.endX = position;
+
+                        label.push_back( static_cast<uint32_t>(run.size()) );
+                        run.push_back( newRun );
+                    }
+                    else {
+                        newRun.startX = position;
+                    }
+
+                    isRunOpen = !isRunOpen;
+                }
+            }
+
+            // bits after the last pixel are 0 so only a run ending at the end of the last full word is still open
+            if( isRunOpen ) {
+                newRun.endX = image.width();
+
+                label.push_back( static_cast<uint32_t>(run.size()) );
+                run.push_back( newRun );
+            }
+
+            _mergeRows( run, label, previousRowStart, previousRowEnd, currentRowStart, run.size() );
+
+            previousRowStart = currentRowStart;
+            previousRowEnd   = run.size();
+        }
+    }
+
+    void BlobDetection::_mergeRows( const std::vector < PointRun > & run, std::vector < uint32_t > & label, size_t previousStart,
+                                    size_t previousEnd, size_t currentStart, size_t currentEnd )
+    {
+        // runs are 8-connected if they overlap or touch each other diagonally
+        size_t previousId = previousStart;
+
+        for( size_t currentId = currentStart; currentId < currentEnd; ++currentId ) {
+            for( ; (previousId < previousEnd) && (run[previousId].endX < run[currentId].startX); ++previousId );
+
+            for( size_t id = previousId; (id < previousEnd) && (run[id].startX <= run[currentId].endX); ++id )
+                mergeLabels( label, static_cast<uint32_t>(id), static_cast<uint32_t>(currentId) );
+        }
+    }
+
+    const std::vector < BlobInfo > & BlobDetection::_createBlobs( const std::vector < PointRun > & run, std::vector < uint32_t > & label,
+                                                                  const BlobParameters & parameter, bool keepRuns )
+    {
+        // assign final labels and calculate moments of blobs
+        std::vector < uint32_t > blobId( run.size() );
+        std::vector < uint32_t > blobRunCount;
+
+        for( uint32_t id = 0; id < run.size(); ++id ) {
+            const uint32_t root = findRoot( label, id );
+
+            if( root == id ) { // root is always the first run of a blob
+                blobId[id] = static_cast<uint32_t>(blobRunCount.size());
+                blobRunCount.push_back( 0 );
+            }
+            else {
+                blobId[id] = blobId[root];
+            }
+
+            ++blobRunCount[blobId[id]];
+        }
+
+        // runs are grouped by blobs in one array keeping their order so runs of every blob are sorted by rows
+        std::vector < size_t > blobRunStart( blobRunCount.size() + 1, 0 );
+
+        for( size_t id = 0; id < blobRunCount.size(); ++id )
+            blobRunStart[id + 1] = blobRunStart[id] + blobRunCount[id];
+
+        std::vector < PointRun > groupedRun( run.size() );
+
+        {
+            std::vector < size_t > position( blobRunStart.begin(), blobRunStart.end() - 1 );
+
+            for( size_t id = 0; id < run.size(); ++id )
+                groupedRun[position[blobId[id]]++] = run[id];
+        }
+
+        // all blobs refer to one storage instead of keeping own copies of runs
+        std::shared_ptr < const RunStorage > storage;
+        if( keepRuns )
+            storage = std::make_shared < const RunStorage >( groupedRun );
+
+        std::vector < BlobInfo > blob( blobRunCount.size() );
+
+        for( size_t id = 0; id < blob.size(); ++id ) {
+            BlobInfo & info = blob[id];
+
+            const size_t start = blobRunStart[id];
+            const size_t end   = blobRunStart[id + 1];
+
+            if( keepRuns ) {
+                info._runStorage = storage;
+                info._runStart   = start;
+                info._runEnd     = end;
+            }
+
+            Area area( groupedRun[start].startX );
+            area.top    = groupedRun[start].y;
+            area.bottom = groupedRun[end - 1].y + 1;
+
+            size_t size = 0;
+
+            for( size_t point = start; point != end; ++point ) {
+                size += groupedRun[point].endX - groupedRun[point].startX;
+
+                if( area.left > groupedRun[point].startX )
+                    area.left = groupedRun[point].startX;
+                if( area.right < groupedRun[point].endX )
+                    area.right = groupedRun[point].endX;
+            }
+
+            info._size = size;
+
+            info._area.value = area;
+            info._area.found = true;
+
+            info._moments.value = calculateMoments( groupedRun, start, end );
+            info._moments.found = true;
+
+            info._center.value.x = info._moments.value.m10 / info._moments.value.m00;
+            info._center.value.y = info._moments.value.m01 / info._moments.value.m00;
+            info._center.found = true;
+
+            info._width.value = area.right - area.left;
+            info._width.found = true;
+
+            info._height.value = area.bottom - area.top;
+            info._height.found = true;
+        }
+
+        return _filter( blob, parameter );
+    }
+
     const std::vector < BlobInfo > & BlobDetection::get() const
     {
         return _blob;
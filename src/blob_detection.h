@@ -1,5 +1,9 @@
 #pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <vector>
+#include "binary_image.h"
 #include "image_buffer.h"
 #include "math_base.h"
 
@@ -55,6 +59,11 @@ namespace Blob_Detection
     {
         Parameter < double   > circularity; // this parameter will be 1 if blob is ideal circle and will be less than 1 if it's not
                                             // closer this value to 1 --> blob shape is closer to circle
+                                            // Definitions depend on search mode so values of the modes are not comparable:
+                                            // - SEARCH_POINTS: 1 - mean deviation of contour points from radius of a circle
+                                            //   with the same area, divided by the radius
+                                            // - SEARCH_MOMENTS: 4 * pi * area / perimeter^2 where the perimeter along pixel sides
+                                            //   is scaled by pi / 4, the value is limited by 1
         Parameter < double   > elongation;  // some people call it inertia: ratio of the minor and major axes of a blob
         Parameter < uint32_t > height;      // height, in pixels
         Parameter < double   > length;      // maximum distance between any of 2 pixels, in pixels
@@ -118,21 +127,134 @@ namespace Blob_Detection
         bool found;
     };
 
+    // Rectangle of minimum area which contains centers of all blob pixels. Width is measured along a direction
+    // given by angle (in radians) and height is measured perpendicular to it
+    struct OrientedArea
+    {
+        OrientedArea()
+            : width ( 0 )
+            , height( 0 )
+            , angle ( 0 )
+        { }
+
+        // this constructor is made to avoid 'Value' template restriction
+        explicit OrientedArea( double value )
+            : center( value, value )
+            , width ( value )
+            , height( value )
+            , angle ( value )
+        { }
+
+        Point2d center;
+        double width;
+        double height;
+        double angle;
+    };
+
+    // Moments of blob pixels: raw moments m<p><q> are sums of x^p * y^q over all pixels
+    // and central moments mu<p><q> are the same sums for positions relative to the center of blob
+    struct Moments
+    {
+        Moments()
+            : m00      ( 0 )
+            , m10      ( 0 )
+            , m01      ( 0 )
+            , m20      ( 0 )
+            , m11      ( 0 )
+            , m02      ( 0 )
+            , mu20     ( 0 )
+            , mu11     ( 0 )
+            , mu02     ( 0 )
+            , perimeter( 0 )
+        { }
+
+        // this constructor is made to avoid 'Value' template restriction
+        explicit Moments( double value )
+            : m00      ( value )
+            , m10      ( value )
+            , m01      ( value )
+            , m20      ( value )
+            , m11      ( value )
+            , m02      ( value )
+            , mu20     ( value )
+            , mu11     ( value )
+            , mu02     ( value )
+            , perimeter( value )
+        { }
+
+        double m00;
+        double m10;
+        double m01;
+        double m20;
+        double m11;
+        double m02;
+        double mu20;
+        double mu11;
+        double mu02;
+        double perimeter; // number of pixel sides between blob and background
+    };
+
+    // Horizontal sequence of blob pixels [startX, endX) in row y
+    struct PointRun
+    {
+        uint32_t y;
+        uint32_t startX;
+        uint32_t endX;
+    };
+
+    // Run-length encoded rows of all blobs found by one search. Runs of every blob take a continuous range of positions
+    // Coordinates of runs are kept in separate arrays as 16-bit values relative to the minimum run coordinates when they fit
+    class RunStorage
+    {
+    public:
+        explicit RunStorage( const std::vector < PointRun > & run );
+
+        PointRun operator[]( size_t id ) const;
+
+        size_t size() const;
+        bool isCompact() const; // true if 16-bit coordinates are used
+    private:
+        uint32_t _offsetX;
+        uint32_t _offsetY;
+
+        std::vector < uint16_t > _compactY;
+        std::vector < uint16_t > _compactStartX;
+        std::vector < uint16_t > _compactEndX;
+
+        std::vector < uint32_t > _y;
+        std::vector < uint32_t > _startX;
+        std::vector < uint32_t > _endX;
+    };
+
     // This class follows an idea of lazy computations:
     // calculate result when it is needed. If you forgot to specify some parameter
     // in BlobParameter structure for evaluation you can still retrieve the value after.
     // But sorting of blobs in BlobDetection class will depend on input BlobParameter parameters so set proper parameters ;)
+    // Blobs found by BlobDetection::findRunLength function keep only a range of pixel runs in a storage shared by all blobs
+    // of the search: point, contour and edge arrays are extracted from runs at the first request of any of them
+    // Length, elongation and minimum area rectangle are measured by rotating calipers over convex hull of contour
+    // which is found once and shared by all of them
+    // Blobs found in BlobDetection::SEARCH_MOMENTS mode keep no pixel positions: all point arrays are empty
+    // and shape features are estimated by a rectangle with the same moments as blob. Circularity of such blobs is calculated
+    // by another formula (see BlobParameters) and isSolid() throws an exception as holes cannot be found from moments
+    // Constant functions of the same blob can be called from several threads at the same time: lazy extraction of point
+    // arrays and convex hull is guarded by a mutex which is not taken any more once they are found. Non-constant functions
+    // store calculated values so they must not be called while any other function of the same blob is running in another thread
     class BlobInfo
     {
     public:
         friend class BlobDetection;
 
+        BlobInfo();
+
         const std::vector < uint32_t > & pointX() const;   // returns an array what contains all blob's pixel X positions (unsorted)
         const std::vector < uint32_t > & pointY() const;   // returns an array what contains all blob's pixel Y positions (unsorted)
         const std::vector < uint32_t > & contourX() const; // returns an array what contains all blob's contour pixel X positions (unsorted)
         const std::vector < uint32_t > & contourY() const; // returns an array what contains all blob's contour pixel Y positions (unsorted)
         const std::vector < uint32_t > & edgeX() const;    // returns an array what contains all blob's edge pixel X positions (unsorted)
         const std::vector < uint32_t > & edgeY() const;    // returns an array what contains all blob's edge pixel Y positions (unsorted)
+        const std::vector < uint32_t > & convexHullX() const; // returns an array what contains X positions of convex hull vertices in order of traversal
+        const std::vector < uint32_t > & convexHullY() const; // returns an array what contains Y positions of convex hull vertices in order of traversal
 
         // Each function has 2 overloaded forms:
         // - non-constant function check whether value was calculated, calculates it if neccessary and return value
@@ -149,18 +271,48 @@ namespace Blob_Detection
         uint32_t height() const;      // height of blob
         double   length();            // length of blob
         double   length() const;      // length of blob
+        OrientedArea minimumArea();       // rotated rectangle of minimum area what can contain blob
+        OrientedArea minimumArea() const; // rotated rectangle of minimum area what can contain blob
+        Moments  moments();           // moments of blob
+        Moments  moments() const;     // moments of blob
         size_t   size() const;        // total number of pixels in blob
         uint32_t width();             // width of blob
         uint32_t width() const;       // width of blob
 
-        bool isSolid() const;         // true if blob does not have inner edge points
+        bool isSolid() const;         // true if blob does not have inner edge points, throws for blobs found in SEARCH_MOMENTS mode
+
+        size_t   runCount() const;        // number of pixel runs, 0 if blob is not found by run-length search
+        PointRun run( size_t id ) const;  // pixel run of blob, runs are sorted by rows
     private:
-        std::vector < uint32_t > _pointX;
-        std::vector < uint32_t > _pointY;
-        std::vector < uint32_t > _contourX;
-        std::vector < uint32_t > _contourY;
-        std::vector < uint32_t > _edgeX;
-        std::vector < uint32_t > _edgeY;
+        // mutex which does not prevent copying of blobs: a copy gets its own mutex and the state of guarded data
+        // Guarded data never changes after it is found so the mutex is taken only until ready flag is set
+        struct Lock
+        {
+            Lock() : ready( false ) { }
+            Lock( const Lock & lock ) : ready( lock.ready.load() ) { }
+            Lock & operator=( const Lock & lock ) { ready.store( lock.ready.load() ); return (*this); }
+
+            std::mutex mutex;
+            std::atomic < bool > ready;
+        };
+
+        mutable std::vector < uint32_t > _pointX;
+        mutable std::vector < uint32_t > _pointY;
+        mutable std::vector < uint32_t > _contourX;
+        mutable std::vector < uint32_t > _contourY;
+        mutable std::vector < uint32_t > _edgeX;
+        mutable std::vector < uint32_t > _edgeY;
+        mutable std::vector < uint32_t > _convexHullX;
+        mutable std::vector < uint32_t > _convexHullY;
+
+        mutable Lock _pointLock; // guards extraction of point, contour and edge arrays
+        mutable Lock _hullLock;  // guards search of convex hull, always taken before _pointLock
+
+        // filled only by run-length search
+        std::shared_ptr < const RunStorage > _runStorage;
+        size_t _runStart;
+        size_t _runEnd;
+        size_t _size;
 
         Value < Area   > _area;
         Value < Point2d> _center;
@@ -168,6 +320,8 @@ namespace Blob_Detection
         Value < double > _elongation;
         Value <uint32_t> _height;
         Value < double > _length;
+        Value <OrientedArea> _minimumArea;
+        Value < Moments> _moments;
         Value <uint32_t> _width;
 
         void _getArea();
@@ -176,19 +330,46 @@ namespace Blob_Detection
         void _getElongation();
         void _getHeight();
         void _getLength();
+        void _getMinimumArea();
+        void _getMoments();
         void _getWidth();
+
+        bool _hasPoints() const; // false for blobs found in SEARCH_MOMENTS mode
+
+        void _extractPoints() const; // fills point, contour and edge arrays from pixel runs once
+        void _getConvexHull() const; // finds convex hull of contour once
+
+        void _findPoints() const;     // must be called under _pointLock
+        void _findConvexHull() const; // monotone chain algorithm, must be called under _hullLock
     };
 
     class BlobDetection
     {
     public:
+        enum SearchMode
+        {
+            SEARCH_POINTS, // positions of all blob pixels are stored
+            SEARCH_MOMENTS // only moments of blobs are accumulated during labeling of run-length encoded rows, no positions are stored
+        };
+
         // Sorting blobs will be in alphabet order of sorting criteria
         // Example: length and width criteria enabled. So first all blobs would be removed if they are not fitting length criterion
         // and then all remain blobs would be removed if they are not fitting for width criterion
         const std::vector < BlobInfo > & find( const PenguinV_Image::Image & image, BlobParameters parameter = BlobParameters(),
-                                               uint8_t threshold = 1 );
+                                               uint8_t threshold = 1, SearchMode mode = SEARCH_POINTS );
         const std::vector < BlobInfo > & find( const PenguinV_Image::Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
-                                               BlobParameters parameter = BlobParameters(), uint8_t threshold = 1 );
+                                               BlobParameters parameter = BlobParameters(), uint8_t threshold = 1,
+                                               SearchMode mode = SEARCH_POINTS );
+
+        // Alternative two-pass search over run-length encoded rows with union-find merging of labels
+        // Size, area and center of blobs are calculated during labeling and pixel positions are extracted only on request
+        // so this function is much faster for images with big or many blobs. Results are the same as for find() function
+        const std::vector < BlobInfo > & findRunLength( const PenguinV_Image::Image & image, BlobParameters parameter = BlobParameters(),
+                                                        uint8_t threshold = 1 );
+        const std::vector < BlobInfo > & findRunLength( const PenguinV_Image::Image & image, uint32_t x, uint32_t y, uint32_t width,
+                                                        uint32_t height, BlobParameters parameter = BlobParameters(), uint8_t threshold = 1 );
+        // Run-length search over bit-packed binary image: runs are taken from edge bits of 64 pixels at once
+        const std::vector < BlobInfo > & findRunLength( const PenguinV_Image::BinaryImage & image, BlobParameters parameter = BlobParameters() );
 
         // Retrieve an array of all found blobs
         const std::vector < BlobInfo > & get() const;
@@ -212,5 +393,22 @@ namespace Blob_Detection
         void sort( BlobCriterion criterion );
     protected:
         std::vector < BlobInfo > _blob;
+
+        // removes blobs which do not fit parameters and stores the rest
+        const std::vector < BlobInfo > & _filter( std::vector < BlobInfo > & foundBlob, const BlobParameters & parameter );
+
+        // First pass of run-length search: encodes rows of the area as runs of pixels and merges labels of connected runs
+        // Runs are appended to the arrays and their labels are equal to positions in the arrays
+        static void _findRuns( const PenguinV_Image::Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                               uint8_t threshold, std::vector < PointRun > & run, std::vector < uint32_t > & label );
+        static void _findRuns( const PenguinV_Image::BinaryImage & image, std::vector < PointRun > & run, std::vector < uint32_t > & label );
+        // merges labels of connected runs of neighbour rows: previous row runs are [previousStart, previousEnd),
+        // current row runs are [currentStart, currentEnd)
+        static void _mergeRows( const std::vector < PointRun > & run, std::vector < uint32_t > & label, size_t previousStart,
+                                size_t previousEnd, size_t currentStart, size_t currentEnd );
+        // Second pass of run-length search: creates blobs from labeled runs and removes blobs which do not fit parameters
+        // Runs of all blobs are kept in one storage if keepRuns is true
+        const std::vector < BlobInfo > & _createBlobs( const std::vector < PointRun > & run, std::vector < uint32_t > & label,
+                                                       const BlobParameters & parameter, bool keepRuns = true );
     };
 }
@@ -1,6 +1,344 @@
+#include <cmath>
+#include <functional>
 #include "fft.h"
 #include "image_function.h"
 #include "image_exception.h"
+#include "thread_pool.h"
+#include "penguinv/cpu_identification.h"
+
+#ifdef PENGUINV_AVX_SET
+#include <immintrin.h>
+#endif
+
+#ifdef PENGUINV_SSE_SET
+#include <emmintrin.h>
+#endif
+
+#ifdef PENGUINV_NEON_SET
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+    // Number of independent signals (rows or columns) transformed together. Values of all signals for the same point
+    // are stored sequentially so butterflies are done over continuous memory for any stage of FFT
+    const uint32_t blockSize = 16u;
+
+    void ComplexMultiplication( const FFT::ComplexData & in1, const FFT::ComplexData & in2, FFT::ComplexData & out )
+    {
+        if( in1.width() != in2.width() || in1.height() != in2.height() || in1.width() != out.width() || in1.height() != out.height() ||
+            in1.width() == 0 || in1.height() == 0 )
+            throw imageException( "Invalid parameters for FFTExecutor" );
+
+        // in1 = A + iB
+        // in2 = C + iD
+        // out = in1 * (-in2) = (A + iB) * (-C - iD) = - A * C - i(B * C) - i(A * D) + B * D
+
+        const uint32_t size = in1.width() * in1.height();
+
+        const kiss_fft_cpx * in1X = in1.data();
+        const kiss_fft_cpx * in2X = in2.data();
+        kiss_fft_cpx * outX = out.data();
+        const kiss_fft_cpx * outXEnd = outX + size;
+
+        for( ; outX != outXEnd; ++in1X, ++in2X, ++outX ) {
+            outX->r = in1X->r * in2X->r - in1X->i * in2X->i;
+            outX->i = in1X->r * in2X->i + in1X->i * in2X->r;
+        }
+    }
+
+    // Complex data is aligned to a cache line. A pointer to allocated memory is stored right before aligned memory
+    const size_t dataAlignment = 64u;
+
+    kiss_fft_cpx * AllocateData( size_t size )
+    {
+        uint8_t * memory = reinterpret_cast<uint8_t *>( malloc( size * sizeof( kiss_fft_cpx ) + dataAlignment ) );
+        if( memory == NULL )
+            throw imageException( "Cannot allocate memory for complex data" );
+
+        // malloc returns memory aligned at least to a size of pointer so there is always space for the pointer
+        uint8_t * aligned = memory + dataAlignment - reinterpret_cast<size_t>( memory ) % dataAlignment;
+        memcpy( aligned - sizeof( uint8_t * ), &memory, sizeof( uint8_t * ) );
+
+        return reinterpret_cast<kiss_fft_cpx *>( aligned );
+    }
+
+    void FreeData( kiss_fft_cpx * data )
+    {
+        uint8_t * memory = NULL;
+        memcpy( &memory, reinterpret_cast<uint8_t *>( data ) - sizeof( uint8_t * ), sizeof( uint8_t * ) );
+
+        free( memory );
+    }
+
+    bool IsPowerOfTwo( uint32_t value )
+    {
+        return value > 0 && (value & (value - 1)) == 0;
+    }
+
+    // Twiddle factors of Stockham FFT: for every radix-4 stage with length n and for every p < n / 4
+    // it contains W^p, W^2p and W^3p where W = exp(-2 * pi * i / n). Values are calculated in double precision
+    std::vector < float > GenerateTwiddle( uint32_t size )
+    {
+        std::vector < float > twiddle;
+
+        for( uint32_t n = size; n >= 4; n /= 4 ) {
+            const double angle = -2 * 3.14159265358979323846 / n;
+
+            for( uint32_t p = 0; p < n / 4; ++p ) {
+                for( uint32_t j = 1; j < 4; ++j ) {
+                    twiddle.push_back( static_cast<float>( cos( angle * p * j ) ) );
+                    twiddle.push_back( static_cast<float>( sin( angle * p * j ) ) );
+                }
+            }
+        }
+
+        return twiddle;
+    }
+
+    struct ScalarOperation
+    {
+        typedef float Vector;
+        static const uint32_t width = 1u;
+
+        static Vector load( const float * in ) { return *in; }
+        static void store( float * out, Vector value ) { *out = value; }
+        static Vector set( float value ) { return value; }
+        static Vector add( Vector left, Vector right ) { return left + right; }
+        static Vector sub( Vector left, Vector right ) { return left - right; }
+        static Vector mul( Vector left, Vector right ) { return left * right; }
+    };
+
+#ifdef PENGUINV_AVX_SET
+    struct AvxOperation
+    {
+        typedef __m256 Vector;
+        static const uint32_t width = 8u;
+
+        static Vector load( const float * in ) { return _mm256_loadu_ps( in ); }
+        static void store( float * out, Vector value ) { _mm256_storeu_ps( out, value ); }
+        static Vector set( float value ) { return _mm256_set1_ps( value ); }
+        static Vector add( Vector left, Vector right ) { return _mm256_add_ps( left, right ); }
+        static Vector sub( Vector left, Vector right ) { return _mm256_sub_ps( left, right ); }
+        static Vector mul( Vector left, Vector right ) { return _mm256_mul_ps( left, right ); }
+    };
+#endif
+
+#ifdef PENGUINV_SSE_SET
+    struct SseOperation
+    {
+        typedef __m128 Vector;
+        static const uint32_t width = 4u;
+
+        static Vector load( const float * in ) { return _mm_loadu_ps( in ); }
+        static void store( float * out, Vector value ) { _mm_storeu_ps( out, value ); }
+        static Vector set( float value ) { return _mm_set1_ps( value ); }
+        static Vector add( Vector left, Vector right ) { return _mm_add_ps( left, right ); }
+        static Vector sub( Vector left, Vector right ) { return _mm_sub_ps( left, right ); }
+        static Vector mul( Vector left, Vector right ) { return _mm_mul_ps( left, right ); }
+    };
+#endif
+
+#ifdef PENGUINV_NEON_SET
+    struct NeonOperation
+    {
+        typedef float32x4_t Vector;
+        static const uint32_t width = 4u;
+
+        static Vector load( const float * in ) { return vld1q_f32( in ); }
+        static void store( float * out, Vector value ) { vst1q_f32( out, value ); }
+        static Vector set( float value ) { return vdupq_n_f32( value ); }
+        static Vector add( Vector left, Vector right ) { return vaddq_f32( left, right ); }
+        static Vector sub( Vector left, Vector right ) { return vsubq_f32( left, right ); }
+        static Vector mul( Vector left, Vector right ) { return vmulq_f32( left, right ); }
+    };
+#endif
+
+    // Stockham FFT of size (power of 2) points for blockSize independent signals: point p of signal l is located at [p * blockSize + l]
+    // Every radix-4 stage reads from one pair of arrays and writes into another so no bit reversal is needed. The last stage is radix-2
+    // for odd powers of 2. The result is stored in input arrays, buffer arrays must have the same size as input arrays
+    // Inverse transform is done by swapping of real and imaginary arrays
+    template <typename TOperation>
+    void Transform( float * real, float * imaginary, float * bufferReal, float * bufferImaginary, uint32_t size, const float * twiddle )
+    {
+        typedef typename TOperation::Vector Vector;
+
+        float * inRe  = real;
+        float * inIm  = imaginary;
+        float * outRe = bufferReal;
+        float * outIm = bufferImaginary;
+
+        uint32_t n = size;
+        uint32_t stride = blockSize; // number of continuous values processed by one butterfly
+
+        for( ; n >= 4; n /= 4, stride *= 4 ) {
+            const uint32_t quarter = (n / 4) * stride;
+
+            for( uint32_t p = 0; p < n / 4; ++p, twiddle += 6 ) {
+                const Vector w1Re = TOperation::set( twiddle[0] );
+                const Vector w1Im = TOperation::set( twiddle[1] );
+                const Vector w2Re = TOperation::set( twiddle[2] );
+                const Vector w2Im = TOperation::set( twiddle[3] );
+                const Vector w3Re = TOperation::set( twiddle[4] );
+                const Vector w3Im = TOperation::set( twiddle[5] );
+
+                const float * aRe = inRe + p * stride;
+                const float * aIm = inIm + p * stride;
+                float * yRe = outRe + 4 * p * stride;
+                float * yIm = outIm + 4 * p * stride;
+
+                for( uint32_t i = 0; i < stride; i += TOperation::width ) {
+                    const Vector aR = TOperation::load( aRe + i );
+                    const Vector aI = TOperation::load( aIm + i );
+                    const Vector bR = TOperation::load( aRe + i + quarter );
+                    const Vector bI = TOperation::load( aIm + i + quarter );
+                    const Vector cR = TOperation::load( aRe + i + 2 * quarter );
+                    const Vector cI = TOperation::load( aIm + i + 2 * quarter );
+                    const Vector dR = TOperation::load( aRe + i + 3 * quarter );
+                    const Vector dI = TOperation::load( aIm + i + 3 * quarter );
+
+                    const Vector apcR = TOperation::add( aR, cR );
+                    const Vector apcI = TOperation::add( aI, cI );
+                    const Vector amcR = TOperation::sub( aR, cR );
+                    const Vector amcI = TOperation::sub( aI, cI );
+                    const Vector bpdR = TOperation::add( bR, dR );
+                    const Vector bpdI = TOperation::add( bI, dI );
+                    const Vector bmdR = TOperation::sub( bR, dR );
+                    const Vector bmdI = TOperation::sub( bI, dI );
+
+                    // y0 = (a + c) + (b + d), y1 = W * ((a - c) - i(b - d)), y2 = W^2 * ((a + c) - (b + d)), y3 = W^3 * ((a - c) + i(b - d))
+                    const Vector t1R = TOperation::add( amcR, bmdI );
+                    const Vector t1I = TOperation::sub( amcI, bmdR );
+                    const Vector t2R = TOperation::sub( apcR, bpdR );
+                    const Vector t2I = TOperation::sub( apcI, bpdI );
+                    const Vector t3R = TOperation::sub( amcR, bmdI );
+                    const Vector t3I = TOperation::add( amcI, bmdR );
+
+                    TOperation::store( yRe + i, TOperation::add( apcR, bpdR ) );
+                    TOperation::store( yIm + i, TOperation::add( apcI, bpdI ) );
+                    TOperation::store( yRe + i + stride, TOperation::sub( TOperation::mul( t1R, w1Re ), TOperation::mul( t1I, w1Im ) ) );
+                    TOperation::store( yIm + i + stride, TOperation::add( TOperation::mul( t1R, w1Im ), TOperation::mul( t1I, w1Re ) ) );
+                    TOperation::store( yRe + i + 2 * stride, TOperation::sub( TOperation::mul( t2R, w2Re ), TOperation::mul( t2I, w2Im ) ) );
+                    TOperation::store( yIm + i + 2 * stride, TOperation::add( TOperation::mul( t2R, w2Im ), TOperation::mul( t2I, w2Re ) ) );
+                    TOperation::store( yRe + i + 3 * stride, TOperation::sub( TOperation::mul( t3R, w3Re ), TOperation::mul( t3I, w3Im ) ) );
+                    TOperation::store( yIm + i + 3 * stride, TOperation::add( TOperation::mul( t3R, w3Im ), TOperation::mul( t3I, w3Re ) ) );
+                }
+            }
+
+            std::swap( inRe, outRe );
+            std::swap( inIm, outIm );
+        }
+
+        if( n == 2 ) { // the last radix-2 stage writes directly into resulting arrays
+            for( uint32_t i = 0; i < stride; i += TOperation::width ) {
+                const Vector aR = TOperation::load( inRe + i );
+                const Vector aI = TOperation::load( inIm + i );
+                const Vector bR = TOperation::load( inRe + i + stride );
+                const Vector bI = TOperation::load( inIm + i + stride );
+
+                TOperation::store( real + i, TOperation::add( aR, bR ) );
+                TOperation::store( imaginary + i, TOperation::add( aI, bI ) );
+                TOperation::store( real + i + stride, TOperation::sub( aR, bR ) );
+                TOperation::store( imaginary + i + stride, TOperation::sub( aI, bI ) );
+            }
+        }
+        else if( inRe != real ) {
+            memcpy( real, inRe, sizeof( float ) * size * blockSize );
+            memcpy( imaginary, inIm, sizeof( float ) * size * blockSize );
+        }
+    }
+
+    typedef void (*TransformFunction)( float *, float *, float *, float *, uint32_t, const float * );
+
+    TransformFunction GetTransformFunction()
+    {
+#ifdef PENGUINV_AVX_SET
+        if( isAvxAvailable )
+            return &Transform<AvxOperation>;
+#endif
+#ifdef PENGUINV_SSE_SET
+        if( isSseAvailable )
+            return &Transform<SseOperation>;
+#endif
+#ifdef PENGUINV_NEON_SET
+        if( isNeonAvailable )
+            return &Transform<NeonOperation>;
+#endif
+        return &Transform<ScalarOperation>;
+    }
+
+    void DirectTransform( float * real, float * imaginary, float * buffer, uint32_t size, const std::vector < float > & twiddle )
+    {
+        GetTransformFunction()( real, imaginary, buffer, buffer + size * blockSize, size, twiddle.data() );
+    }
+
+    // Inverse transform (without normalization) is a direct transform of data with swapped real and imaginary parts
+    void InverseTransform( float * real, float * imaginary, float * buffer, uint32_t size, const std::vector < float > & twiddle )
+    {
+        GetTransformFunction()( imaginary, real, buffer + size * blockSize, buffer, size, twiddle.data() );
+    }
+
+    // Distributes blocks of rows or columns between tasks of global thread pool. Every task processes a continuous range of blocks
+    // with its own workspace. All blocks are processed in the calling thread if thread pool has no threads
+    class BlockTask : public Thread_Pool::TaskProviderSingleton
+    {
+    public:
+        typedef std::function< void( uint32_t, std::vector < float > & ) > BlockFunction;
+
+        BlockTask( std::vector < std::vector < float > > & workspace, size_t workspaceSize )
+            : _workspace    ( workspace )
+            , _workspaceSize( workspaceSize )
+            , _blockCount   ( 0 )
+            , _taskCount    ( 0 )
+        {
+        }
+
+        void run( uint32_t blockCount, const BlockFunction & function )
+        {
+            const uint32_t threadCount = static_cast<uint32_t>( Thread_Pool::ThreadPoolMonoid::instance().threadCount() );
+
+            _blockCount = blockCount;
+            _taskCount  = std::max( 1u, std::min( threadCount, blockCount ) );
+            _function   = function;
+
+            if( _workspace.size() < _taskCount )
+                _workspace.resize( _taskCount );
+
+            for( uint32_t i = 0; i < _taskCount; ++i ) {
+                if( _workspace[i].size() < _workspaceSize )
+                    _workspace[i].resize( _workspaceSize );
+            }
+
+            if( threadCount == 0 || _taskCount == 1 ) {
+                _task( 0 );
+            }
+            else {
+                _run( _taskCount );
+
+                if( !_wait() )
+                    throw imageException( "An exception raised during task execution in FFT" );
+            }
+        }
+
+    protected:
+        virtual void _task( size_t taskId )
+        {
+            const uint32_t id = static_cast<uint32_t>( taskId );
+            const uint32_t startBlock = _blockCount * id / _taskCount;
+            const uint32_t endBlock   = _blockCount * (id + 1) / _taskCount;
+
+            for( uint32_t blockId = startBlock; blockId < endBlock; ++blockId )
+                _function( blockId, _workspace[taskId] );
+        }
+
+    private:
+        std::vector < std::vector < float > > & _workspace;
+        size_t _workspaceSize;
+        uint32_t _blockCount;
+        uint32_t _taskCount;
+        BlockFunction _function;
+    };
+}
 
 namespace FFT
 {
@@ -59,14 +397,7 @@ namespace FFT
         if( image.empty() || image.colorCount() != 1u )
             throw imageException( "Failed to allocate complex data for empty or coloured image" );
 
-        _clean();
-
-        const uint32_t size = image.width() * image.height();
-
-        _data = reinterpret_cast<kiss_fft_cpx *>( malloc( size * sizeof(kiss_fft_cpx) ) );
-
-        _width  = image.width();
-        _height = image.height();
+        resize( image.width(), image.height() );
 
         // Copy data from input image to FFT array
         const uint32_t rowSize = image.rowSize();
@@ -131,9 +462,7 @@ namespace FFT
         if( ( width_ != _width || height_ != _height ) && width_ != 0 && height_ != 0 ) {
             _clean();
 
-            const uint32_t size = width_ * height_;
-
-            _data = reinterpret_cast<kiss_fft_cpx *>( malloc( size * sizeof(kiss_fft_cpx) ) );
+            _data = AllocateData( width_ * height_ );
 
             _width  = width_;
             _height = height_;
@@ -168,7 +497,7 @@ namespace FFT
     void ComplexData::_clean()
     {
         if( _data != NULL ) {
-            kiss_fft_free( _data );
+            FreeData( _data );
             _data = NULL;
         }
 
@@ -178,9 +507,10 @@ namespace FFT
 
     void ComplexData::_copy( const ComplexData & data )
     {
-        _clean();
-
-        resize( data._width, data._height );
+        if( data.empty() )
+            _clean();
+        else
+            resize( data._width, data._height );
 
         if( !empty() )
             memcpy( _data, data._data, _width * _height * sizeof(kiss_fft_cpx) );
@@ -193,6 +523,132 @@ namespace FFT
         std::swap( _height, data._height );
     }
 
+    PlanCache::PlanCache()
+        : _hitCount ( 0 )
+        , _missCount( 0 )
+    {
+    }
+
+    PlanCache::~PlanCache()
+    {
+        clear();
+    }
+
+    PlanCache & PlanCache::instance()
+    {
+        static PlanCache cache;
+        return cache;
+    }
+
+    kiss_fftnd_cfg PlanCache::acquire( uint32_t width, uint32_t height, bool inverse )
+    {
+        const PlanKey key = { width, height, inverse };
+
+        {
+            std::lock_guard < std::mutex > lock( _mutex );
+
+            std::map < PlanKey, std::vector < kiss_fftnd_cfg > >::iterator plan = _plan.find( key );
+            if( plan != _plan.end() && !plan->second.empty() ) {
+                kiss_fftnd_cfg cfg = plan->second.back();
+                plan->second.pop_back();
+
+                ++_hitCount;
+                return cfg;
+            }
+        }
+
+        ++_missCount;
+
+        // kissfft expects dimensions starting from the slowest changing one
+        const int dims[2] = { static_cast<int>(height), static_cast<int>(width) };
+        kiss_fftnd_cfg cfg = kiss_fftnd_alloc( dims, 2, inverse, 0, 0 );
+        if( cfg == 0 )
+            throw imageException( "Cannot allocate FFT plan" );
+
+        return cfg;
+    }
+
+    void PlanCache::release( kiss_fftnd_cfg plan, uint32_t width, uint32_t height, bool inverse )
+    {
+        if( plan == 0 )
+            return;
+
+        const PlanKey key = { width, height, inverse };
+
+        std::lock_guard < std::mutex > lock( _mutex );
+        _plan[key].push_back( plan );
+    }
+
+    std::shared_ptr < const RealFFTTwiddle > PlanCache::twiddle( uint32_t width, uint32_t height )
+    {
+        const PlanKey key = { width, height, false };
+
+        {
+            std::lock_guard < std::mutex > lock( _mutex );
+
+            std::map < PlanKey, std::shared_ptr < const RealFFTTwiddle > >::const_iterator twiddle = _twiddle.find( key );
+            if( twiddle != _twiddle.end() ) {
+                ++_hitCount;
+                return twiddle->second;
+            }
+        }
+
+        ++_missCount;
+
+        // Every row of real values is transformed as a complex signal of width / 2 points. A half of spectrum of the row
+        // (width / 2 + 1 values) is restored from this transform by twiddle factors exp(-2 * pi * i * k / width)
+        const uint32_t half = width / 2;
+
+        std::shared_ptr < RealFFTTwiddle > twiddle = std::make_shared < RealFFTTwiddle >();
+
+        twiddle->row    = GenerateTwiddle( half );
+        twiddle->column = GenerateTwiddle( height );
+
+        twiddle->split.resize( 2 * (half + 1) );
+        for( uint32_t k = 0; k <= half; ++k ) {
+            const double angle = -2 * 3.14159265358979323846 * k / width;
+            twiddle->split[2 * k    ] = static_cast<float>( cos( angle ) );
+            twiddle->split[2 * k + 1] = static_cast<float>( sin( angle ) );
+        }
+
+        std::lock_guard < std::mutex > lock( _mutex );
+
+        // another thread could create the same factors in the meantime: the first stored ones are kept
+        return _twiddle.insert( std::make_pair( key, twiddle ) ).first->second;
+    }
+
+    size_t PlanCache::hitCount() const
+    {
+        return _hitCount;
+    }
+
+    size_t PlanCache::missCount() const
+    {
+        return _missCount;
+    }
+
+    void PlanCache::clear()
+    {
+        std::lock_guard < std::mutex > lock( _mutex );
+
+        for( std::map < PlanKey, std::vector < kiss_fftnd_cfg > >::iterator plan = _plan.begin(); plan != _plan.end(); ++plan ) {
+            for( std::vector < kiss_fftnd_cfg >::iterator cfg = plan->second.begin(); cfg != plan->second.end(); ++cfg )
+                kiss_fft_free( *cfg );
+        }
+
+        _plan.clear();
+        _twiddle.clear();
+    }
+
+    bool PlanCache::PlanKey::operator<( const PlanKey & key ) const
+    {
+        if( width != key.width )
+            return width < key.width;
+        if( height != key.height )
+            return height < key.height;
+        return inverse < key.inverse;
+    }
+
     FFTExecutor::FFTExecutor()
         : _planDirect  ( 0 )
         , _planInverse ( 0 )
@@ -220,11 +676,13 @@ namespace FFT
         if( width_ == 0 || height_ == 0 )
             throw imageException( "Invalid parameters for FFTExecutor" );
 
+        if( width_ == _width && height_ == _height )
+            return;
+
         _clean();
 
-        const int dims[2] = { static_cast<int>(width_), static_cast<int>(height_) };
-        _planDirect  = kiss_fftnd_alloc(dims, 2, false, 0, 0);
-        _planInverse = kiss_fftnd_alloc(dims, 2, true , 0, 0);
+        _planDirect  = PlanCache::instance().acquire( width_, height_, false );
+        _planInverse = PlanCache::instance().acquire( width_, height_, true );
 
         _width  = width_;
         _height = height_;
@@ -268,37 +726,19 @@ namespace FFT
 
     void FFTExecutor::complexMultiplication( const ComplexData & in1, const ComplexData & in2, ComplexData & out ) const
     {
-        if( in1.width() != in2.width() || in1.height() != in2.height() || in1.width() != out.width() || in1.height() != out.height() ||
-            in1.width() == 0 || in1.height() == 0 )
-            throw imageException( "Invalid parameters for FFTExecutor" );
-
-        // in1 = A + iB
-        // in2 = C + iD
-        // out = in1 * (-in2) = (A + iB) * (-C - iD) = - A * C - i(B * C) - i(A * D) + B * D
-
-        const uint32_t size = in1.width() * in1.height();
-
-        const kiss_fft_cpx * in1X = in1.data();
-        const kiss_fft_cpx * in2X = in2.data();
-        kiss_fft_cpx * outX = out.data();
-        const kiss_fft_cpx * outXEnd = outX + size;
-
-        for( ; outX != outXEnd; ++in1X, ++in2X, ++outX ) {
-            outX->r = in1X->r * in2X->r - in1X->i * in2X->i;
-            outX->i = in1X->r * in2X->i + in1X->i * in2X->r;
-        }
+        ComplexMultiplication( in1, in2, out );
     }
 
     void FFTExecutor::_clean()
     {
         if( _planDirect != 0 ) {
-            kiss_fft_free( _planDirect );
+            PlanCache::instance().release( _planDirect, _width, _height, false );
 
             _planDirect = 0;
         }
 
         if( _planInverse != 0 ) {
-            kiss_fft_free( _planInverse );
+            PlanCache::instance().release( _planInverse, _width, _height, true );
 
             _planInverse = 0;
         }
@@ -306,4 +746,287 @@ namespace FFT
         _width  = 0;
         _height = 0;
     }
+
+    RealFFTExecutor::RealFFTExecutor()
+        : _width        ( 0 )
+        , _height       ( 0 )
+        , _spectrumWidth( 0 )
+    {
+    }
+
+    RealFFTExecutor::RealFFTExecutor( uint32_t width_, uint32_t height_ )
+        : _width        ( 0 )
+        , _height       ( 0 )
+        , _spectrumWidth( 0 )
+    {
+        initialize( width_, height_ );
+    }
+
+    void RealFFTExecutor::initialize( uint32_t width_, uint32_t height_ )
+    {
+        if( width_ < 2 || !IsPowerOfTwo( width_ ) || !IsPowerOfTwo( height_ ) )
+            throw imageException( "Invalid parameters for RealFFTExecutor" );
+
+        if( width_ == _width && height_ == _height )
+            return;
+
+        _twiddle = PlanCache::instance().twiddle( width_, height_ );
+
+        const uint32_t half = width_ / 2;
+
+        _spectrumWidth = ((half + 1 + blockSize - 1) / blockSize) * blockSize;
+        _spectrumReal.resize( _spectrumWidth * height_ );
+        _spectrumImaginary.resize( _spectrumWidth * height_ );
+
+        _width  = width_;
+        _height = height_;
+    }
+
+    uint32_t RealFFTExecutor::width() const
+    {
+        return _width;
+    }
+
+    uint32_t RealFFTExecutor::height() const
+    {
+        return _height;
+    }
+
+    void RealFFTExecutor::directTransform( ComplexData & data )
+    {
+        directTransform( data, data );
+    }
+
+    void RealFFTExecutor::directTransform( const ComplexData & in, ComplexData & out )
+    {
+        _verify( in, out );
+
+        const size_t workspaceSize = 4 * std::max( _width / 2, _height ) * blockSize;
+        BlockTask task( _workspace, workspaceSize );
+
+        const uint32_t rowBlockCount = (_height + blockSize - 1) / blockSize;
+
+        const kiss_fft_cpx * inData = in.data();
+        kiss_fft_cpx * outData = out.data();
+
+        // Output can be written only after all rows are read because input and output could be the same
+        task.run( rowBlockCount, [this, inData]( uint32_t blockId, std::vector < float > & workspace ) { _rowDirect( blockId, inData, workspace ); } );
+        task.run( _spectrumWidth / blockSize, [this]( uint32_t blockId, std::vector < float > & workspace ) { _columnDirect( blockId, workspace ); } );
+        task.run( rowBlockCount, [this, outData]( uint32_t blockId, std::vector < float > & ) { _restoreSpectrum( blockId, outData ); } );
+    }
+
+    void RealFFTExecutor::inverseTransform( ComplexData & data )
+    {
+        inverseTransform( data, data );
+    }
+
+    void RealFFTExecutor::inverseTransform( const ComplexData & in, ComplexData & out )
+    {
+        _verify( in, out );
+
+        const size_t workspaceSize = 4 * std::max( _width / 2, _height ) * blockSize;
+        BlockTask task( _workspace, workspaceSize );
+
+        const kiss_fft_cpx * inData = in.data();
+        kiss_fft_cpx * outData = out.data();
+
+        task.run( _spectrumWidth / blockSize, [this, inData]( uint32_t blockId, std::vector < float > & workspace ) { _columnInverse( blockId, inData, workspace ); } );
+        task.run( (_height + blockSize - 1) / blockSize, [this, outData]( uint32_t blockId, std::vector < float > & workspace ) { _rowInverse( blockId, outData, workspace ); } );
+    }
+
+    void RealFFTExecutor::complexMultiplication( const ComplexData & in1, const ComplexData & in2, ComplexData & out ) const
+    {
+        ComplexMultiplication( in1, in2, out );
+    }
+
+    void RealFFTExecutor::_rowDirect( uint32_t blockId, const kiss_fft_cpx * in, std::vector < float > & workspace )
+    {
+        const uint32_t half = _width / 2;
+        const uint32_t startY = blockId * blockSize;
+        const uint32_t rowCount = std::min( blockSize, _height - startY );
+
+        float * real = workspace.data();
+        float * imaginary = real + half * blockSize;
+        float * buffer = imaginary + half * blockSize;
+
+        // even values of a row form real part of complex signal and odd values form imaginary part
+        for( uint32_t i = 0; i < blockSize; ++i ) {
+            if( i < rowCount ) {
+                const kiss_fft_cpx * inX = in + (startY + i) * _width;
+
+                for( uint32_t x = 0; x < half; ++x, inX += 2 ) {
+                    real     [x * blockSize + i] = inX[0].r;
+                    imaginary[x * blockSize + i] = inX[1].r;
+                }
+            }
+            else {
+                for( uint32_t x = 0; x < half; ++x ) {
+                    real     [x * blockSize + i] = 0;
+                    imaginary[x * blockSize + i] = 0;
+                }
+            }
+        }
+
+        DirectTransform( real, imaginary, buffer, half, _twiddle->row );
+
+        // X[k] = E[k] + W^k * O[k], where E[k] = (Z[k] + conj(Z[half - k])) / 2 and O[k] = (Z[k] - conj(Z[half - k])) / 2i
+        for( uint32_t i = 0; i < rowCount; ++i ) {
+            float * outRe = _spectrumReal.data() + (startY + i) * _spectrumWidth;
+            float * outIm = _spectrumImaginary.data() + (startY + i) * _spectrumWidth;
+
+            for( uint32_t k = 0; k <= half; ++k ) {
+                const uint32_t id = (k == half ? 0 : k) * blockSize + i;
+                const uint32_t idMirror = (k == 0 ? 0 : half - k) * blockSize + i;
+
+                const float evenRe = (real[id] + real[idMirror]) * 0.5f;
+                const float evenIm = (imaginary[id] - imaginary[idMirror]) * 0.5f;
+                const float oddRe  = (imaginary[id] + imaginary[idMirror]) * 0.5f;
+                const float oddIm  = (real[idMirror] - real[id]) * 0.5f;
+
+                const float wRe = _twiddle->split[2 * k];
+                const float wIm = _twiddle->split[2 * k + 1];
+
+                outRe[k] = evenRe + wRe * oddRe - wIm * oddIm;
+                outIm[k] = evenIm + wRe * oddIm + wIm * oddRe;
+            }
+        }
+    }
+
+    void RealFFTExecutor::_rowInverse( uint32_t blockId, kiss_fft_cpx * out, std::vector < float > & workspace )
+    {
+        const uint32_t half = _width / 2;
+        const uint32_t startY = blockId * blockSize;
+        const uint32_t rowCount = std::min( blockSize, _height - startY );
+
+        float * real = workspace.data();
+        float * imaginary = real + half * blockSize;
+        float * buffer = imaginary + half * blockSize;
+
+        // Z[k] = (X[k] + conj(X[half - k])) + i * W^-k * (X[k] - conj(X[half - k])) is a spectrum of signal with even values
+        // as real part and odd values as imaginary part
+        for( uint32_t i = 0; i < blockSize; ++i ) {
+            if( i < rowCount ) {
+                const float * inRe = _spectrumReal.data() + (startY + i) * _spectrumWidth;
+                const float * inIm = _spectrumImaginary.data() + (startY + i) * _spectrumWidth;
+
+                for( uint32_t k = 0; k < half; ++k ) {
+                    const float sumRe = inRe[k] + inRe[half - k];
+                    const float sumIm = inIm[k] - inIm[half - k];
+                    const float diffRe = inRe[k] - inRe[half - k];
+                    const float diffIm = inIm[k] + inIm[half - k];
+
+                    const float wRe = _twiddle->split[2 * k];
+                    const float wIm = _twiddle->split[2 * k + 1];
+
+                    const float productRe = wRe * diffRe + wIm * diffIm;
+                    const float productIm = wRe * diffIm - wIm * diffRe;
+
+                    real     [k * blockSize + i] = sumRe - productIm;
+                    imaginary[k * blockSize + i] = sumIm + productRe;
+                }
+            }
+            else {
+                for( uint32_t k = 0; k < half; ++k ) {
+                    real     [k * blockSize + i] = 0;
+                    imaginary[k * blockSize + i] = 0;
+                }
+            }
+        }
+
+        InverseTransform( real, imaginary, buffer, half, _twiddle->row );
+
+        for( uint32_t i = 0; i < rowCount; ++i ) {
+            kiss_fft_cpx * outX = out + (startY + i) * _width;
+
+            for( uint32_t x = 0; x < half; ++x, outX += 2 ) {
+                outX[0].r = real     [x * blockSize + i];
+                outX[0].i = 0;
+                outX[1].r = imaginary[x * blockSize + i];
+                outX[1].i = 0;
+            }
+        }
+    }
+
+    void RealFFTExecutor::_columnDirect( uint32_t blockId, std::vector < float > & workspace )
+    {
+        const uint32_t startX = blockId * blockSize;
+
+        float * real = workspace.data();
+        float * imaginary = real + _height * blockSize;
+        float * buffer = imaginary + _height * blockSize;
+
+        for( uint32_t y = 0; y < _height; ++y ) {
+            memcpy( real + y * blockSize, _spectrumReal.data() + y * _spectrumWidth + startX, sizeof( float ) * blockSize );
+            memcpy( imaginary + y * blockSize, _spectrumImaginary.data() + y * _spectrumWidth + startX, sizeof( float ) * blockSize );
+        }
+
+        DirectTransform( real, imaginary, buffer, _height, _twiddle->column );
+
+        for( uint32_t y = 0; y < _height; ++y ) {
+            memcpy( _spectrumReal.data() + y * _spectrumWidth + startX, real + y * blockSize, sizeof( float ) * blockSize );
+            memcpy( _spectrumImaginary.data() + y * _spectrumWidth + startX, imaginary + y * blockSize, sizeof( float ) * blockSize );
+        }
+    }
+
+    void RealFFTExecutor::_columnInverse( uint32_t blockId, const kiss_fft_cpx * in, std::vector < float > & workspace )
+    {
+        const uint32_t half = _width / 2;
+        const uint32_t startX = blockId * blockSize;
+        const uint32_t columnCount = std::min( blockSize, half + 1 - std::min( startX, half + 1 ) );
+
+        float * real = workspace.data();
+        float * imaginary = real + _height * blockSize;
+        float * buffer = imaginary + _height * blockSize;
+
+        for( uint32_t y = 0; y < _height; ++y ) {
+            const kiss_fft_cpx * inX = in + y * _width + startX;
+
+            for( uint32_t i = 0; i < blockSize; ++i ) {
+                real     [y * blockSize + i] = (i < columnCount) ? inX[i].r : 0;
+                imaginary[y * blockSize + i] = (i < columnCount) ? inX[i].i : 0;
+            }
+        }
+
+        InverseTransform( real, imaginary, buffer, _height, _twiddle->column );
+
+        for( uint32_t y = 0; y < _height; ++y ) {
+            memcpy( _spectrumReal.data() + y * _spectrumWidth + startX, real + y * blockSize, sizeof( float ) * blockSize );
+            memcpy( _spectrumImaginary.data() + y * _spectrumWidth + startX, imaginary + y * blockSize, sizeof( float ) * blockSize );
+        }
+    }
+
+    void RealFFTExecutor::_restoreSpectrum( uint32_t blockId, kiss_fft_cpx * out ) const
+    {
+        const uint32_t half = _width / 2;
+        const uint32_t startY = blockId * blockSize;
+        const uint32_t endY = std::min( startY + blockSize, _height );
+
+        // the second half of spectrum is restored by symmetry X[y][x] = conj(X[height - y][width - x])
+        for( uint32_t y = startY; y < endY; ++y ) {
+            const float * inRe = _spectrumReal.data() + y * _spectrumWidth;
+            const float * inIm = _spectrumImaginary.data() + y * _spectrumWidth;
+
+            const uint32_t mirrorY = (_height - y) % _height;
+            const float * mirrorRe = _spectrumReal.data() + mirrorY * _spectrumWidth;
+            const float * mirrorIm = _spectrumImaginary.data() + mirrorY * _spectrumWidth;
+
+            kiss_fft_cpx * outX = out + y * _width;
+
+            for( uint32_t x = 0; x <= half; ++x ) {
+                outX[x].r = inRe[x];
+                outX[x].i = inIm[x];
+            }
+
+            for( uint32_t x = half + 1; x < _width; ++x ) {
+                outX[x].r =  mirrorRe[_width - x];
+                outX[x].i = -mirrorIm[_width - x];
+            }
+        }
+    }
+
+    void RealFFTExecutor::_verify( const ComplexData & in, const ComplexData & out ) const
+    {
+        if( _width == 0 || _width != in.width() || _height != in.height() || _width != out.width() || _height != out.height() )
+            throw imageException( "Invalid parameters for RealFFTExecutor" );
+    }
 }
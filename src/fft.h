@@ -1,4 +1,8 @@
 #pragma once
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include "image_buffer.h"
 #include "thirdparty/kissfft/kiss_fft.h"
@@ -6,8 +10,8 @@
 
 namespace FFT
 {
-    // This class store complex ([real, imaginary]) data in CPU memory
-    // It is used for Fast Fourier Transform
+    // This class store complex ([real, imaginary]) data in CPU memory aligned to a cache line (64 bytes)
+    // It is used for Fast Fourier Transform. Memory is reused when new data has the same size
     class ComplexData
     {
     public:
@@ -47,6 +51,56 @@ namespace FFT
         void _swap( ComplexData & data );
     };
 
+    // Twiddle factors of RealFFTExecutor for row and column transforms and for splitting of row transform results
+    // into spectrum of real data. The same factors are used for direct and inverse transforms
+    struct RealFFTTwiddle
+    {
+        std::vector < float > row;
+        std::vector < float > column;
+        std::vector < float > split;
+    };
+
+    // Process-wide cache of kissfft plans keyed by (width, height, direction). A plan contains a temporary buffer
+    // so it cannot be used by several executors at the same time: executors take plans from the cache and return them back
+    // when they are destroyed or reinitialized. Repeated creation of executors for the same size does no allocation
+    // Twiddle factors of RealFFTExecutor are read-only so they are shared by all executors of the same size
+    class PlanCache
+    {
+    public:
+        static PlanCache & instance(); // function returns a reference to global (static) cache
+
+        kiss_fftnd_cfg acquire( uint32_t width, uint32_t height, bool inverse );
+        void release( kiss_fftnd_cfg plan, uint32_t width, uint32_t height, bool inverse );
+
+        std::shared_ptr < const RealFFTTwiddle > twiddle( uint32_t width, uint32_t height );
+
+        size_t hitCount() const;  // number of acquired plans and twiddle factors which were taken from the cache
+        size_t missCount() const; // number of acquired plans and twiddle factors which were created
+
+        void clear(); // frees all plans which are not in use at the moment and releases twiddle factors
+
+        PlanCache & operator=( const PlanCache & ) = delete;
+        PlanCache( const PlanCache & ) = delete;
+        ~PlanCache();
+    private:
+        PlanCache();
+
+        struct PlanKey
+        {
+            uint32_t width;
+            uint32_t height;
+            bool inverse;
+
+            bool operator<( const PlanKey & key ) const;
+        };
+
+        std::map < PlanKey, std::vector < kiss_fftnd_cfg > > _plan; // free plans
+        std::map < PlanKey, std::shared_ptr < const RealFFTTwiddle > > _twiddle; // keys have direct direction only
+        std::mutex _mutex;
+        std::atomic < size_t > _hitCount;
+        std::atomic < size_t > _missCount;
+    };
+
     // The class for FFT command execution:
     // - conversion from original domain of data to frequency domain and vice versa
     // - complex multiplication in frequency domain (convolution)
@@ -80,4 +134,51 @@ namespace FFT
 
         void _clean();
     };
+
+    // The class for FFT of real data (for example, images) with width and height as powers of 2
+    // Spectrum of real data is symmetric so only a half of it is calculated and the second half is restored on output:
+    // results are the same as for FFTExecutor class. Rows and columns are processed by blocks using SIMD and global thread pool
+    // (Thread_Pool::ThreadPoolMonoid) if it has any threads
+    class RealFFTExecutor
+    {
+    public:
+        RealFFTExecutor();
+        RealFFTExecutor( uint32_t width_, uint32_t height_ );
+
+        void initialize( uint32_t width_, uint32_t height_ );
+
+        uint32_t width() const;
+        uint32_t height() const;
+
+        // conversion from original domain of data to frequence domain. Imaginary part of input data is ignored
+        void directTransform( ComplexData & data );
+        void directTransform( const ComplexData & in, ComplexData & out );
+
+        // conversion from frequence domain of data to original domain. Input data must be a spectrum of real data
+        void inverseTransform( ComplexData & data );
+        void inverseTransform( const ComplexData & in, ComplexData & out );
+
+        void complexMultiplication( const ComplexData & in1, const ComplexData & in2, ComplexData & out ) const;
+
+    private:
+        uint32_t _width;
+        uint32_t _height;
+
+        std::shared_ptr < const RealFFTTwiddle > _twiddle; // taken from PlanCache
+
+        // a half of spectrum: (width / 2 + 1) columns aligned to a size of block
+        uint32_t _spectrumWidth;
+        std::vector < float > _spectrumReal;
+        std::vector < float > _spectrumImaginary;
+
+        // buffers for every task of thread pool
+        std::vector < std::vector < float > > _workspace;
+
+        void _rowDirect( uint32_t blockId, const kiss_fft_cpx * in, std::vector < float > & workspace );
+        void _rowInverse( uint32_t blockId, kiss_fft_cpx * out, std::vector < float > & workspace );
+        void _columnDirect( uint32_t blockId, std::vector < float > & workspace );
+        void _columnInverse( uint32_t blockId, const kiss_fft_cpx * in, std::vector < float > & workspace );
+        void _restoreSpectrum( uint32_t blockId, kiss_fft_cpx * out ) const;
+        void _verify( const ComplexData & in, const ComplexData & out ) const;
+    };
 }
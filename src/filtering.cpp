@@ -1,10 +1,1531 @@
 #include <math.h>
+#include <algorithm>
+#include <cstring>
 #include "filtering.h"
 #include "image_function.h"
+#include "image_function_simd.h"
 #include "parameter_validation.h"
+#include "penguinv/cpu_identification.h"
+
+#ifdef PENGUINV_AVX_SET
+#include <immintrin.h>
+#endif
+
+#ifdef PENGUINV_SSE_SET
+#include <emmintrin.h>
+#endif
+
+#ifdef PENGUINV_NEON_SET
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+    // Median filter with Huang algorithm: a histogram of kernel is moved along a row by removing left column
+    // and adding right column of kernel. It takes O(kernelSize) operations per pixel so it is the best for small kernels
+    void MedianHuang( const uint8_t * inY, uint32_t rowSizeIn, uint8_t * outY, uint32_t rowSizeOut, uint32_t width, uint32_t height,
+                      uint32_t kernelSize )
+    {
+        const uint32_t medianPosition = kernelSize * kernelSize / 2;
+
+        std::vector < uint32_t > histogram( 256u );
+
+        const uint8_t * outYEnd = outY + height * rowSizeOut;
+
+        for( ; outY != outYEnd; outY += rowSizeOut, inY += rowSizeIn ) {
+            std::fill( histogram.begin(), histogram.end(), 0u );
+
+            const uint8_t * inYRead    = inY;
+            const uint8_t * inYReadEnd = inYRead + kernelSize * rowSizeIn;
+
+            for( ; inYRead != inYReadEnd; inYRead += rowSizeIn ) {
+                const uint8_t * inXRead    = inYRead;
+                const uint8_t * inXReadEnd = inXRead + kernelSize;
+
+                for( ; inXRead != inXReadEnd; ++inXRead )
+                    ++histogram[*inXRead];
+            }
+
+            // median is the smallest value for which a number of smaller values (lessCount) plus a number of such values
+            // is bigger than median position. Both variables are tracked while kernel moves so median value changes slightly
+            uint32_t median    = 0;
+            uint32_t lessCount = 0;
+
+            while( lessCount + histogram[median] <= medianPosition )
+                lessCount += histogram[median++];
+
+            const uint8_t * inX  = inY;
+            uint8_t       * outX = outY;
+
+            (*outX) = static_cast<uint8_t>(median);
+
+            const uint8_t * outXEnd = outX + width;
+
+            for( ++outX; outX != outXEnd; ++outX, ++inX ) {
+                inYRead    = inX;
+                inYReadEnd = inYRead + kernelSize * rowSizeIn;
+
+                for( ; inYRead != inYReadEnd; inYRead += rowSizeIn ) {
+                    const uint8_t removed = *inYRead;
+                    const uint8_t added   = *(inYRead + kernelSize);
+
+                    --histogram[removed];
+                    ++histogram[added];
+
+                    if( removed < median )
+                        --lessCount;
+                    if( added < median )
+                        ++lessCount;
+                }
+
+                if( lessCount > medianPosition ) {
+                    do {
+                        lessCount -= histogram[--median];
+                    } while( lessCount > medianPosition );
+                }
+                else {
+                    while( lessCount + histogram[median] <= medianPosition )
+                        lessCount += histogram[median++];
+                }
+
+                (*outX) = static_cast<uint8_t>(median);
+            }
+        }
+    }
+
+    // Median filter with Perreault-Hebert algorithm: every column of image has its own histogram which is moved down by one row
+    // at each row and histogram of kernel is computed by adding right column histogram and subtracting left column histogram
+    // Histograms consist of 16 coarse bins and 256 fine bins. Coarse bins are used to find a range of median value
+    // and fine bins of this range are updated only when they are needed so it takes constant number of operations per pixel
+    void MedianPerreaultHebert( const uint8_t * inY, uint32_t rowSizeIn, uint8_t * outY, uint32_t rowSizeOut, uint32_t width, uint32_t height,
+                                uint32_t kernelSize )
+    {
+        const uint32_t medianPosition = kernelSize * kernelSize / 2;
+        const uint32_t columnCount = width + kernelSize - 1;
+
+        std::vector < uint16_t > columnFine  ( columnCount * 256u, 0u );
+        std::vector < uint16_t > columnCoarse( columnCount * 16u , 0u );
+
+        std::vector < uint32_t > kernelFine  ( 256u );
+        std::vector < uint32_t > kernelCoarse( 16u );
+        std::vector < uint32_t > fineUpdateX ( 16u ); // position of kernel for which fine bins of coarse bin range were computed
+
+        // column histograms contain all rows of kernel except the last one which is added while processing of a row
+        for( uint32_t y = 0; y < kernelSize - 1; ++y ) {
+            const uint8_t * inX = inY + y * rowSizeIn;
+
+            for( uint32_t x = 0; x < columnCount; ++x, ++inX ) {
+                ++columnFine  [x * 256u + (*inX)];
+                ++columnCoarse[x * 16u + ((*inX) >> 4)];
+            }
+        }
+
+        const uint32_t invalidX = 0xFFFFFFFFu;
+
+        const uint8_t * outYEnd = outY + height * rowSizeOut;
+
+        for( bool firstRow = true; outY != outYEnd; outY += rowSizeOut, inY += rowSizeIn, firstRow = false ) {
+            const uint8_t * inAdded   = inY + (kernelSize - 1) * rowSizeIn;
+            const uint8_t * inRemoved = inY - rowSizeIn;
+
+            std::fill( kernelCoarse.begin(), kernelCoarse.end(), 0u );
+            std::fill( fineUpdateX.begin(), fineUpdateX.end(), invalidX );
+
+            for( uint32_t x = 0; x < columnCount; ++x ) {
+                // column histogram is moved down right before the column is used by kernel
+                ++columnFine  [x * 256u + inAdded[x]];
+                ++columnCoarse[x * 16u + (inAdded[x] >> 4)];
+
+                if( !firstRow ) {
+                    --columnFine  [x * 256u + inRemoved[x]];
+                    --columnCoarse[x * 16u + (inRemoved[x] >> 4)];
+                }
+
+                const uint16_t * addedCoarse = columnCoarse.data() + x * 16u;
+
+                if( x < kernelSize ) {
+                    for( uint32_t i = 0; i < 16u; ++i )
+                        kernelCoarse[i] += addedCoarse[i];
+
+                    if( x + 1 < kernelSize )
+                        continue;
+                }
+                else {
+                    const uint16_t * removedCoarse = addedCoarse - kernelSize * 16u;
+
+                    for( uint32_t i = 0; i < 16u; ++i )
+                        kernelCoarse[i] = kernelCoarse[i] + addedCoarse[i] - removedCoarse[i];
+                }
+
+                const uint32_t kernelX = x + 1 - kernelSize; // the first column of kernel
+
+                uint32_t lessCount = 0;
+                uint32_t coarseId  = 0;
+
+                while( lessCount + kernelCoarse[coarseId] <= medianPosition )
+                    lessCount += kernelCoarse[coarseId++];
+
+                uint32_t * fine = kernelFine.data() + coarseId * 16u;
+
+                if( fineUpdateX[coarseId] == invalidX || fineUpdateX[coarseId] + kernelSize <= kernelX ) {
+                    std::fill( fine, fine + 16u, 0u );
+
+                    for( uint32_t columnX = kernelX; columnX <= x; ++columnX ) {
+                        const uint16_t * added = columnFine.data() + columnX * 256u + coarseId * 16u;
+
+                        for( uint32_t i = 0; i < 16u; ++i )
+                            fine[i] += added[i];
+                    }
+                }
+                else {
+                    for( uint32_t columnX = fineUpdateX[coarseId] + 1; columnX <= kernelX; ++columnX ) {
+                        const uint16_t * added   = columnFine.data() + (columnX + kernelSize - 1) * 256u + coarseId * 16u;
+                        const uint16_t * removed = columnFine.data() + (columnX - 1) * 256u + coarseId * 16u;
+
+                        for( uint32_t i = 0; i < 16u; ++i )
+                            fine[i] = fine[i] + added[i] - removed[i];
+                    }
+                }
+
+                fineUpdateX[coarseId] = kernelX;
+
+                uint32_t fineId = 0;
+
+                while( lessCount + fine[fineId] <= medianPosition )
+                    lessCount += fine[fineId++];
+
+                outY[kernelX] = static_cast<uint8_t>(coarseId * 16u + fineId);
+            }
+        }
+    }
+
+    // Returns position within [0, size) range for a pixel located outside of it or -1 if pixel value is 0
+    int32_t BorderPosition( int32_t position, int32_t size, Image_Function::BorderMode border )
+    {
+        if( position >= 0 && position < size )
+            return position;
+
+        switch( border ) {
+            case Image_Function::BORDER_CONSTANT:
+                return -1;
+            case Image_Function::BORDER_REPLICATE:
+                return (position < 0) ? 0 : size - 1;
+            case Image_Function::BORDER_REFLECT:
+                return (position < 0) ? -position : 2 * (size - 1) - position;
+            default:
+                throw imageException( "Unknown border mode" );
+        }
+    }
+
+    // Copies pixels [startX - radius, startX + width + radius) of a row into buffer. Pixels outside of the row are set based on border mode
+    template <typename TColorDepth, typename TData>
+    void FillRow( const TColorDepth * in, uint32_t rowWidth, uint32_t startX, uint32_t width, uint32_t radius,
+                  Image_Function::BorderMode border, TData * out )
+    {
+        const int32_t start = static_cast<int32_t>(startX) - static_cast<int32_t>(radius);
+        const int32_t end   = static_cast<int32_t>(startX + width + radius);
+
+        const int32_t middleEnd = std::min( end, static_cast<int32_t>(rowWidth) );
+
+        int32_t x = start;
+
+        for( ; x < 0; ++x, ++out ) {
+            const int32_t position = BorderPosition( x, static_cast<int32_t>(rowWidth), border );
+            *out = (position < 0) ? 0 : static_cast<TData>(in[position]);
+        }
+
+        for( ; x < middleEnd; ++x, ++out )
+            *out = static_cast<TData>(in[x]);
+
+        for( ; x < end; ++x, ++out ) {
+            const int32_t position = BorderPosition( x, static_cast<int32_t>(rowWidth), border );
+            *out = (position < 0) ? 0 : static_cast<TData>(in[position]);
+        }
+    }
+
+    // Row convolution: out[x] = sum of kernel[i] * in[x + i]. Input row must contain (width + kernelSize - 1) values
+    void ConvolveRow( const float * in, float * out, uint32_t width, const float * kernel, uint32_t kernelSize )
+    {
+        const float * outEnd = out + width;
+
+        for( ; out != outEnd; ++in, ++out ) {
+            float sum = 0;
+
+            for( uint32_t i = 0; i < kernelSize; ++i )
+                sum += in[i] * kernel[i];
+
+            *out = sum;
+        }
+    }
+
+    void ConvolveRow( const int16_t * in, int16_t * out, uint32_t width, const int16_t * kernel, uint32_t kernelSize )
+    {
+        const int16_t * outEnd = out + width;
+
+        for( ; out != outEnd; ++in, ++out ) {
+            int32_t sum = 0;
+
+            for( uint32_t i = 0; i < kernelSize; ++i )
+                sum += in[i] * kernel[i];
+
+            *out = static_cast<int16_t>(sum);
+        }
+    }
+
+    // Column convolution: out[x] = sum of kernel[i] * row[i][x]
+    void ConvolveColumn( const float * const * row, uint8_t * out, uint32_t offset, uint32_t width, const float * kernel, uint32_t kernelSize,
+                         uint8_t )
+    {
+        for( uint32_t x = offset; x < width; ++x ) {
+            float sum = 0;
+
+            for( uint32_t i = 0; i < kernelSize; ++i )
+                sum += row[i][x] * kernel[i];
+
+            // rounding to nearest even is the same as in SIMD conversion so results do not depend on position of a pixel in a row
+            const long value = lrintf( sum );
+
+            out[x] = (value < 0) ? 0 : ((value > 255) ? 255u : static_cast<uint8_t>(value));
+        }
+    }
+
+    void ConvolveColumn( const int16_t * const * row, uint8_t * out, uint32_t offset, uint32_t width, const int16_t * kernel,
+                         uint32_t kernelSize, uint8_t shift )
+    {
+        const int32_t rounding = (shift > 0) ? (1 << (shift - 1)) : 0;
+
+        for( uint32_t x = offset; x < width; ++x ) {
+            int32_t sum = rounding;
+
+            for( uint32_t i = 0; i < kernelSize; ++i )
+                sum += row[i][x] * kernel[i];
+
+            sum >>= shift;
+
+            out[x] = (sum < 0) ? 0 : ((sum > 255) ? 255u : static_cast<uint8_t>(sum));
+        }
+    }
+
+    void ConvolveColumn( const float * const * row, uint16_t * out, uint32_t offset, uint32_t width, const float * kernel, uint32_t kernelSize,
+                         uint8_t )
+    {
+        for( uint32_t x = offset; x < width; ++x ) {
+            float sum = 0;
+
+            for( uint32_t i = 0; i < kernelSize; ++i )
+                sum += row[i][x] * kernel[i];
+
+            const long value = lrintf( sum );
+
+            out[x] = (value < 0) ? 0 : ((value > 65535) ? 65535u : static_cast<uint16_t>(value));
+        }
+    }
+
+    void ConvolveColumn( const float * const * row, float * out, uint32_t offset, uint32_t width, const float * kernel, uint32_t kernelSize,
+                         uint8_t )
+    {
+        for( uint32_t x = offset; x < width; ++x ) {
+            float sum = 0;
+
+            for( uint32_t i = 0; i < kernelSize; ++i )
+                sum += row[i][x] * kernel[i];
+
+            out[x] = sum;
+        }
+    }
+
+#ifdef PENGUINV_AVX_SET
+    namespace avx
+    {
+        void ConvolveRow( const float * in, float * out, uint32_t width, const float * kernel, uint32_t kernelSize )
+        {
+            const uint32_t simdWidth = width - width % 8u;
+
+            for( uint32_t x = 0; x < simdWidth; x += 8u ) {
+                __m256 sum = _mm256_setzero_ps();
+
+                for( uint32_t i = 0; i < kernelSize; ++i )
+                    sum = _mm256_add_ps( sum, _mm256_mul_ps( _mm256_loadu_ps( in + x + i ), _mm256_set1_ps( kernel[i] ) ) );
+
+                _mm256_storeu_ps( out + x, sum );
+            }
+
+            ::ConvolveRow( in + simdWidth, out + simdWidth, width - simdWidth, kernel, kernelSize );
+        }
+
+        void ConvolveRow( const int16_t * in, int16_t * out, uint32_t width, const int16_t * kernel, uint32_t kernelSize )
+        {
+            const uint32_t simdWidth = width - width % 16u;
+
+            for( uint32_t x = 0; x < simdWidth; x += 16u ) {
+                __m256i sum = _mm256_setzero_si256();
+
+                for( uint32_t i = 0; i < kernelSize; ++i ) {
+                    const __m256i data = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(in + x + i) );
+                    sum = _mm256_add_epi16( sum, _mm256_mullo_epi16( data, _mm256_set1_epi16( kernel[i] ) ) );
+                }
+
+                _mm256_storeu_si256( reinterpret_cast<__m256i*>(out + x), sum );
+            }
+
+            ::ConvolveRow( in + simdWidth, out + simdWidth, width - simdWidth, kernel, kernelSize );
+        }
+
+        void ConvolveColumn( const float * const * row, uint8_t * out, uint32_t width, const float * kernel, uint32_t kernelSize, uint8_t shift )
+        {
+            const uint32_t simdWidth = width - width % 8u;
+
+            for( uint32_t x = 0; x < simdWidth; x += 8u ) {
+                __m256 sum = _mm256_setzero_ps();
+
+                for( uint32_t i = 0; i < kernelSize; ++i )
+                    sum = _mm256_add_ps( sum, _mm256_mul_ps( _mm256_loadu_ps( row[i] + x ), _mm256_set1_ps( kernel[i] ) ) );
+
+                const __m256i value = _mm256_cvtps_epi32( sum );
+                const __m128i data  = _mm_packs_epi32( _mm256_castsi256_si128( value ), _mm256_extracti128_si256( value, 1 ) );
+
+                _mm_storel_epi64( reinterpret_cast<__m128i*>(out + x), _mm_packus_epi16( data, data ) );
+            }
+
+            ::ConvolveColumn( row, out, simdWidth, width, kernel, kernelSize, shift );
+        }
+
+        void ConvolveColumn( const int16_t * const * row, uint8_t * out, uint32_t width, const int16_t * kernel, uint32_t kernelSize,
+                             uint8_t shift )
+        {
+            const uint32_t simdWidth = width - width % 16u;
+
+            const __m256i rounding = _mm256_set1_epi32( (shift > 0) ? (1 << (shift - 1)) : 0 );
+            const __m128i shiftCount = _mm_cvtsi32_si128( shift );
+            const __m256i zero = _mm256_setzero_si256();
+
+            for( uint32_t x = 0; x < simdWidth; x += 16u ) {
+                __m256i sumLo = rounding;
+                __m256i sumHi = rounding;
+
+                // rows are processed by pairs: interleaved values of 2 rows are multiplied by a pair of coefficients
+                for( uint32_t i = 0; i < kernelSize; i += 2 ) {
+                    const bool pair = (i + 1 < kernelSize);
+
+                    const __m256i data1 = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(row[i] + x) );
+                    const __m256i data2 = pair ? _mm256_loadu_si256( reinterpret_cast<const __m256i*>(row[i + 1] + x) ) : zero;
+
+                    const __m256i coefficient = _mm256_set1_epi32( static_cast<int32_t>(static_cast<uint16_t>(kernel[i])) |
+                                                                   static_cast<int32_t>(static_cast<uint32_t>(static_cast<uint16_t>(pair ? kernel[i + 1] : 0)) << 16) );
+
+                    sumLo = _mm256_add_epi32( sumLo, _mm256_madd_epi16( _mm256_unpacklo_epi16( data1, data2 ), coefficient ) );
+                    sumHi = _mm256_add_epi32( sumHi, _mm256_madd_epi16( _mm256_unpackhi_epi16( data1, data2 ), coefficient ) );
+                }
+
+                const __m256i data = _mm256_packs_epi32( _mm256_sra_epi32( sumLo, shiftCount ), _mm256_sra_epi32( sumHi, shiftCount ) );
+                const __m256i result = _mm256_permute4x64_epi64( _mm256_packus_epi16( data, data ), 0x08 );
+
+                _mm_storeu_si128( reinterpret_cast<__m128i*>(out + x), _mm256_castsi256_si128( result ) );
+            }
+
+            ::ConvolveColumn( row, out, simdWidth, width, kernel, kernelSize, shift );
+        }
+
+        void ConvolveColumn( const float * const * row, uint16_t * out, uint32_t width, const float * kernel, uint32_t kernelSize, uint8_t shift )
+        {
+            const uint32_t simdWidth = width - width % 8u;
+
+            for( uint32_t x = 0; x < simdWidth; x += 8u ) {
+                __m256 sum = _mm256_setzero_ps();
+
+                for( uint32_t i = 0; i < kernelSize; ++i )
+                    sum = _mm256_add_ps( sum, _mm256_mul_ps( _mm256_loadu_ps( row[i] + x ), _mm256_set1_ps( kernel[i] ) ) );
+
+                const __m256i value  = _mm256_cvtps_epi32( sum );
+                const __m256i result = _mm256_permute4x64_epi64( _mm256_packus_epi32( value, value ), 0x08 );
+
+                _mm_storeu_si128( reinterpret_cast<__m128i*>(out + x), _mm256_castsi256_si128( result ) );
+            }
+
+            ::ConvolveColumn( row, out, simdWidth, width, kernel, kernelSize, shift );
+        }
+
+        void ConvolveColumn( const float * const * row, float * out, uint32_t width, const float * kernel, uint32_t kernelSize, uint8_t shift )
+        {
+            const uint32_t simdWidth = width - width % 8u;
+
+            for( uint32_t x = 0; x < simdWidth; x += 8u ) {
+                __m256 sum = _mm256_setzero_ps();
+
+                for( uint32_t i = 0; i < kernelSize; ++i )
+                    sum = _mm256_add_ps( sum, _mm256_mul_ps( _mm256_loadu_ps( row[i] + x ), _mm256_set1_ps( kernel[i] ) ) );
+
+                _mm256_storeu_ps( out + x, sum );
+            }
+
+            ::ConvolveColumn( row, out, simdWidth, width, kernel, kernelSize, shift );
+        }
+    }
+#endif
+
+#ifdef PENGUINV_SSE_SET
+    namespace sse
+    {
+        void ConvolveRow( const float * in, float * out, uint32_t width, const float * kernel, uint32_t kernelSize )
+        {
+            const uint32_t simdWidth = width - width % 4u;
+
+            for( uint32_t x = 0; x < simdWidth; x += 4u ) {
+                __m128 sum = _mm_setzero_ps();
+
+                for( uint32_t i = 0; i < kernelSize; ++i )
+                    sum = _mm_add_ps( sum, _mm_mul_ps( _mm_loadu_ps( in + x + i ), _mm_set1_ps( kernel[i] ) ) );
+
+                _mm_storeu_ps( out + x, sum );
+            }
+
+            ::ConvolveRow( in + simdWidth, out + simdWidth, width - simdWidth, kernel, kernelSize );
+        }
+
+        void ConvolveRow( const int16_t * in, int16_t * out, uint32_t width, const int16_t * kernel, uint32_t kernelSize )
+        {
+            const uint32_t simdWidth = width - width % 8u;
+
+            for( uint32_t x = 0; x < simdWidth; x += 8u ) {
+                __m128i sum = _mm_setzero_si128();
+
+                for( uint32_t i = 0; i < kernelSize; ++i ) {
+                    const __m128i data = _mm_loadu_si128( reinterpret_cast<const __m128i*>(in + x + i) );
+                    sum = _mm_add_epi16( sum, _mm_mullo_epi16( data, _mm_set1_epi16( kernel[i] ) ) );
+                }
+
+                _mm_storeu_si128( reinterpret_cast<__m128i*>(out + x), sum );
+            }
+
+            ::ConvolveRow( in + simdWidth, out + simdWidth, width - simdWidth, kernel, kernelSize );
+        }
+
+        void ConvolveColumn( const float * const * row, uint8_t * out, uint32_t width, const float * kernel, uint32_t kernelSize, uint8_t shift )
+        {
+            const uint32_t simdWidth = width - width % 8u;
+
+            for( uint32_t x = 0; x < simdWidth; x += 8u ) {
+                __m128 sumLo = _mm_setzero_ps();
+                __m128 sumHi = _mm_setzero_ps();
+
+                for( uint32_t i = 0; i < kernelSize; ++i ) {
+                    const __m128 coefficient = _mm_set1_ps( kernel[i] );
+
+                    sumLo = _mm_add_ps( sumLo, _mm_mul_ps( _mm_loadu_ps( row[i] + x     ), coefficient ) );
+                    sumHi = _mm_add_ps( sumHi, _mm_mul_ps( _mm_loadu_ps( row[i] + x + 4 ), coefficient ) );
+                }
+
+                const __m128i data = _mm_packs_epi32( _mm_cvtps_epi32( sumLo ), _mm_cvtps_epi32( sumHi ) );
+
+                _mm_storel_epi64( reinterpret_cast<__m128i*>(out + x), _mm_packus_epi16( data, data ) );
+            }
+
+            ::ConvolveColumn( row, out, simdWidth, width, kernel, kernelSize, shift );
+        }
+
+        void ConvolveColumn( const int16_t * const * row, uint8_t * out, uint32_t width, const int16_t * kernel, uint32_t kernelSize,
+                             uint8_t shift )
+        {
+            const uint32_t simdWidth = width - width % 8u;
+
+            const __m128i rounding = _mm_set1_epi32( (shift > 0) ? (1 << (shift - 1)) : 0 );
+            const __m128i shiftCount = _mm_cvtsi32_si128( shift );
+            const __m128i zero = _mm_setzero_si128();
+
+            for( uint32_t x = 0; x < simdWidth; x += 8u ) {
+                __m128i sumLo = rounding;
+                __m128i sumHi = rounding;
+
+                // rows are processed by pairs: interleaved values of 2 rows are multiplied by a pair of coefficients
+                for( uint32_t i = 0; i < kernelSize; i += 2 ) {
+                    const bool pair = (i + 1 < kernelSize);
+
+                    const __m128i data1 = _mm_loadu_si128( reinterpret_cast<const __m128i*>(row[i] + x) );
+                    const __m128i data2 = pair ? _mm_loadu_si128( reinterpret_cast<const __m128i*>(row[i + 1] + x) ) : zero;
+
+                    const __m128i coefficient = _mm_set1_epi32( static_cast<int32_t>(static_cast<uint16_t>(kernel[i])) |
+                                                                static_cast<int32_t>(static_cast<uint32_t>(static_cast<uint16_t>(pair ? kernel[i + 1] : 0)) << 16) );
+
+                    sumLo = _mm_add_epi32( sumLo, _mm_madd_epi16( _mm_unpacklo_epi16( data1, data2 ), coefficient ) );
+                    sumHi = _mm_add_epi32( sumHi, _mm_madd_epi16( _mm_unpackhi_epi16( data1, data2 ), coefficient ) );
+                }
+
+                const __m128i data = _mm_packs_epi32( _mm_sra_epi32( sumLo, shiftCount ), _mm_sra_epi32( sumHi, shiftCount ) );
+
+                _mm_storel_epi64( reinterpret_cast<__m128i*>(out + x), _mm_packus_epi16( data, data ) );
+            }
+
+            ::ConvolveColumn( row, out, simdWidth, width, kernel, kernelSize, shift );
+        }
+
+        // SSE2 has no instruction to pack 32-bit values into unsigned 16-bit values so values are shifted into signed 16-bit range
+        void ConvolveColumn( const float * const * row, uint16_t * out, uint32_t width, const float * kernel, uint32_t kernelSize, uint8_t shift )
+        {
+            const uint32_t simdWidth = width - width % 8u;
+
+            const __m128 minimum = _mm_setzero_ps();
+            const __m128 maximum = _mm_set1_ps( 65535.0f );
+            const __m128i offset32 = _mm_set1_epi32( 32768 );
+            const __m128i offset16 = _mm_set1_epi16( static_cast<int16_t>(0x8000) );
+
+            for( uint32_t x = 0; x < simdWidth; x += 8u ) {
+                __m128 sumLo = _mm_setzero_ps();
+                __m128 sumHi = _mm_setzero_ps();
+
+                for( uint32_t i = 0; i < kernelSize; ++i ) {
+                    const __m128 coefficient = _mm_set1_ps( kernel[i] );
+
+                    sumLo = _mm_add_ps( sumLo, _mm_mul_ps( _mm_loadu_ps( row[i] + x     ), coefficient ) );
+                    sumHi = _mm_add_ps( sumHi, _mm_mul_ps( _mm_loadu_ps( row[i] + x + 4 ), coefficient ) );
+                }
+
+                const __m128i valueLo = _mm_sub_epi32( _mm_cvtps_epi32( _mm_min_ps( _mm_max_ps( sumLo, minimum ), maximum ) ), offset32 );
+                const __m128i valueHi = _mm_sub_epi32( _mm_cvtps_epi32( _mm_min_ps( _mm_max_ps( sumHi, minimum ), maximum ) ), offset32 );
+
+                _mm_storeu_si128( reinterpret_cast<__m128i*>(out + x), _mm_xor_si128( _mm_packs_epi32( valueLo, valueHi ), offset16 ) );
+            }
+
+            ::ConvolveColumn( row, out, simdWidth, width, kernel, kernelSize, shift );
+        }
+
+        void ConvolveColumn( const float * const * row, float * out, uint32_t width, const float * kernel, uint32_t kernelSize, uint8_t shift )
+        {
+            const uint32_t simdWidth = width - width % 4u;
+
+            for( uint32_t x = 0; x < simdWidth; x += 4u ) {
+                __m128 sum = _mm_setzero_ps();
+
+                for( uint32_t i = 0; i < kernelSize; ++i )
+                    sum = _mm_add_ps( sum, _mm_mul_ps( _mm_loadu_ps( row[i] + x ), _mm_set1_ps( kernel[i] ) ) );
+
+                _mm_storeu_ps( out + x, sum );
+            }
+
+            ::ConvolveColumn( row, out, simdWidth, width, kernel, kernelSize, shift );
+        }
+    }
+#endif
+
+#ifdef PENGUINV_NEON_SET
+    namespace neon
+    {
+        void ConvolveRow( const float * in, float * out, uint32_t width, const float * kernel, uint32_t kernelSize )
+        {
+            const uint32_t simdWidth = width - width % 4u;
+
+            for( uint32_t x = 0; x < simdWidth; x += 4u ) {
+                float32x4_t sum = vdupq_n_f32( 0 );
+
+                for( uint32_t i = 0; i < kernelSize; ++i )
+                    sum = vmlaq_n_f32( sum, vld1q_f32( in + x + i ), kernel[i] );
+
+                vst1q_f32( out + x, sum );
+            }
+
+            ::ConvolveRow( in + simdWidth, out + simdWidth, width - simdWidth, kernel, kernelSize );
+        }
+
+        void ConvolveRow( const int16_t * in, int16_t * out, uint32_t width, const int16_t * kernel, uint32_t kernelSize )
+        {
+            const uint32_t simdWidth = width - width % 8u;
+
+            for( uint32_t x = 0; x < simdWidth; x += 8u ) {
+                int16x8_t sum = vdupq_n_s16( 0 );
+
+                for( uint32_t i = 0; i < kernelSize; ++i )
+                    sum = vmlaq_n_s16( sum, vld1q_s16( in + x + i ), kernel[i] );
+
+                vst1q_s16( out + x, sum );
+            }
+
+            ::ConvolveRow( in + simdWidth, out + simdWidth, width - simdWidth, kernel, kernelSize );
+        }
+
+        void ConvolveColumn( const float * const * row, uint8_t * out, uint32_t width, const float * kernel, uint32_t kernelSize, uint8_t shift )
+        {
+            const uint32_t simdWidth = width - width % 8u;
+
+            const float32x4_t half = vdupq_n_f32( 0.5f );
+
+            for( uint32_t x = 0; x < simdWidth; x += 8u ) {
+                float32x4_t sumLo = half;
+                float32x4_t sumHi = half;
+
+                for( uint32_t i = 0; i < kernelSize; ++i ) {
+                    sumLo = vmlaq_n_f32( sumLo, vld1q_f32( row[i] + x     ), kernel[i] );
+                    sumHi = vmlaq_n_f32( sumHi, vld1q_f32( row[i] + x + 4 ), kernel[i] );
+                }
+
+                // conversion truncates values so 0.5 is added in advance for rounding
+                const int16x8_t data = vcombine_s16( vqmovn_s32( vcvtq_s32_f32( sumLo ) ), vqmovn_s32( vcvtq_s32_f32( sumHi ) ) );
+
+                vst1_u8( out + x, vqmovun_s16( data ) );
+            }
+
+            ::ConvolveColumn( row, out, simdWidth, width, kernel, kernelSize, shift );
+        }
+
+        void ConvolveColumn( const int16_t * const * row, uint8_t * out, uint32_t width, const int16_t * kernel, uint32_t kernelSize,
+                             uint8_t shift )
+        {
+            const uint32_t simdWidth = width - width % 8u;
+
+            const int32x4_t rounding = vdupq_n_s32( (shift > 0) ? (1 << (shift - 1)) : 0 );
+            const int32x4_t shiftCount = vdupq_n_s32( -static_cast<int32_t>(shift) );
+
+            for( uint32_t x = 0; x < simdWidth; x += 8u ) {
+                int32x4_t sumLo = rounding;
+                int32x4_t sumHi = rounding;
+
+                for( uint32_t i = 0; i < kernelSize; ++i ) {
+                    const int16x8_t data = vld1q_s16( row[i] + x );
+
+                    sumLo = vmlal_n_s16( sumLo, vget_low_s16 ( data ), kernel[i] );
+                    sumHi = vmlal_n_s16( sumHi, vget_high_s16( data ), kernel[i] );
+                }
+
+                const int16x8_t data = vcombine_s16( vqmovn_s32( vshlq_s32( sumLo, shiftCount ) ), vqmovn_s32( vshlq_s32( sumHi, shiftCount ) ) );
+
+                vst1_u8( out + x, vqmovun_s16( data ) );
+            }
+
+            ::ConvolveColumn( row, out, simdWidth, width, kernel, kernelSize, shift );
+        }
+
+        void ConvolveColumn( const float * const * row, uint16_t * out, uint32_t width, const float * kernel, uint32_t kernelSize, uint8_t shift )
+        {
+            const uint32_t simdWidth = width - width % 4u;
+
+            const float32x4_t half = vdupq_n_f32( 0.5f );
+
+            for( uint32_t x = 0; x < simdWidth; x += 4u ) {
+                float32x4_t sum = half;
+
+                for( uint32_t i = 0; i < kernelSize; ++i )
+                    sum = vmlaq_n_f32( sum, vld1q_f32( row[i] + x ), kernel[i] );
+
+                // conversion truncates values so 0.5 is added in advance for rounding, negative values become 0
+                vst1_u16( out + x, vqmovn_u32( vcvtq_u32_f32( sum ) ) );
+            }
+
+            ::ConvolveColumn( row, out, simdWidth, width, kernel, kernelSize, shift );
+        }
+
+        void ConvolveColumn( const float * const * row, float * out, uint32_t width, const float * kernel, uint32_t kernelSize, uint8_t shift )
+        {
+            const uint32_t simdWidth = width - width % 4u;
+
+            for( uint32_t x = 0; x < simdWidth; x += 4u ) {
+                float32x4_t sum = vdupq_n_f32( 0 );
+
+                for( uint32_t i = 0; i < kernelSize; ++i )
+                    sum = vmlaq_n_f32( sum, vld1q_f32( row[i] + x ), kernel[i] );
+
+                vst1q_f32( out + x, sum );
+            }
+
+            ::ConvolveColumn( row, out, simdWidth, width, kernel, kernelSize, shift );
+        }
+    }
+#endif
+
+    // SIMD technique is chosen in the same way as for gradient kernels
+    template <typename TData>
+    void ConvolveRowSimd( const TData * in, TData * out, uint32_t width, const TData * kernel, uint32_t kernelSize, simd::SIMDType simdType )
+    {
+#ifdef PENGUINV_AVX_SET
+        if( (simdType == simd::avx512_function && isAvxAvailable) || simdType == simd::avx_function ) {
+            avx::ConvolveRow( in, out, width, kernel, kernelSize );
+            return;
+        }
+#endif
+#ifdef PENGUINV_SSE_SET
+        if( simdType != simd::cpu_function && simdType != simd::neon_function ) {
+            sse::ConvolveRow( in, out, width, kernel, kernelSize );
+            return;
+        }
+#endif
+#ifdef PENGUINV_NEON_SET
+        if( simdType == simd::neon_function ) {
+            neon::ConvolveRow( in, out, width, kernel, kernelSize );
+            return;
+        }
+#endif
+        ConvolveRow( in, out, width, kernel, kernelSize );
+    }
+
+    template <typename TData, typename TColorDepth>
+    void ConvolveColumnSimd( const TData * const * row, TColorDepth * out, uint32_t width, const TData * kernel, uint32_t kernelSize, uint8_t shift,
+                             simd::SIMDType simdType )
+    {
+#ifdef PENGUINV_AVX_SET
+        if( (simdType == simd::avx512_function && isAvxAvailable) || simdType == simd::avx_function ) {
+            avx::ConvolveColumn( row, out, width, kernel, kernelSize, shift );
+            return;
+        }
+#endif
+#ifdef PENGUINV_SSE_SET
+        if( simdType != simd::cpu_function && simdType != simd::neon_function ) {
+            sse::ConvolveColumn( row, out, width, kernel, kernelSize, shift );
+            return;
+        }
+#endif
+#ifdef PENGUINV_NEON_SET
+        if( simdType == simd::neon_function ) {
+            neon::ConvolveColumn( row, out, width, kernel, kernelSize, shift );
+            return;
+        }
+#endif
+        ConvolveColumn( row, out, 0, width, kernel, kernelSize, shift );
+    }
+
+    // Separable convolution of an area. Rows of the image are convolved once and kept in a ring buffer of kernelY size
+    // until all output rows which need them are calculated
+    template <typename TColorDepth, typename TData>
+    void ConvolveSeparable( const PenguinV_Image::ImageTemplate < TColorDepth > & in, uint32_t startXIn, uint32_t startYIn,
+                            PenguinV_Image::ImageTemplate < TColorDepth > & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height, const std::vector < TData > & kernelX,
+                            const std::vector < TData > & kernelY, uint8_t shift, Image_Function::BorderMode border )
+    {
+        const uint32_t radiusX  = static_cast<uint32_t>(kernelX.size() / 2);
+        const uint32_t radiusY  = static_cast<uint32_t>(kernelY.size() / 2);
+        const uint32_t ringSize = static_cast<uint32_t>(kernelY.size());
+
+        const int32_t imageHeight = static_cast<int32_t>(in.height());
+
+        const uint32_t rowSizeIn  = in.rowSize();
+        const uint32_t rowSizeOut = out.rowSize();
+
+        std::vector < TData > inputRow( width + 2 * radiusX );
+        // the last row of buffer is filled by zeros and it is used for pixels outside of the image in constant border mode
+        std::vector < TData > convolvedRow( (ringSize + 1) * width, 0 );
+        std::vector < const TData * > columnRow( ringSize );
+
+        const TData * zeroRow = convolvedRow.data() + ringSize * width;
+
+        int32_t nextRowY = std::max( static_cast<int32_t>(startYIn) - static_cast<int32_t>(radiusY), 0 );
+
+        TColorDepth * outY = out.data() + startYOut * rowSizeOut + startXOut;
+
+        const simd::SIMDType simdType = simd::actualSimdType();
+
+        for( int32_t y = static_cast<int32_t>(startYIn); y < static_cast<int32_t>(startYIn + height); ++y, outY += rowSizeOut ) {
+            const int32_t lastRowY = std::min( y + static_cast<int32_t>(radiusY), imageHeight - 1 );
+
+            for( ; nextRowY <= lastRowY; ++nextRowY ) {
+                FillRow( in.data() + static_cast<uint32_t>(nextRowY) * rowSizeIn, in.width(), startXIn, width, radiusX, border, inputRow.data() );
+                ConvolveRowSimd( inputRow.data(), convolvedRow.data() + (static_cast<uint32_t>(nextRowY) % ringSize) * width, width,
+                                 kernelX.data(), static_cast<uint32_t>(kernelX.size()), simdType );
+            }
+
+            for( uint32_t i = 0; i < ringSize; ++i ) {
+                const int32_t rowY = BorderPosition( y + static_cast<int32_t>(i) - static_cast<int32_t>(radiusY), imageHeight, border );
+                columnRow[i] = (rowY < 0) ? zeroRow : convolvedRow.data() + (static_cast<uint32_t>(rowY) % ringSize) * width;
+            }
+
+            ConvolveColumnSimd( columnRow.data(), outY, width, kernelY.data(), ringSize, shift, simdType );
+        }
+    }
+
+    template <typename TImage>
+    void VerifyConvolutionKernels( const TImage & in, size_t kernelXSize, size_t kernelYSize, Image_Function::BorderMode border )
+    {
+        if( kernelXSize % 2 == 0 || kernelYSize % 2 == 0 )
+            throw imageException( "Convolution kernel size must be odd" );
+
+        if( border == Image_Function::BORDER_REFLECT && (kernelXSize / 2 >= in.width() || kernelYSize / 2 >= in.height()) )
+            throw imageException( "Convolution kernel is too big for image with reflection border mode" );
+    }
+
+    template <typename TData>
+    int64_t SumAbsolute( const std::vector < TData > & kernel )
+    {
+        int64_t sum = 0;
+        for( typename std::vector < TData >::const_iterator value = kernel.begin(); value != kernel.end(); ++value )
+            sum += (*value < 0) ? -static_cast<int64_t>(*value) : static_cast<int64_t>(*value);
+        return sum;
+    }
+
+    // Gradient direction is quantized into 8 sectors of 45 degrees. Borders of sectors are tan(22.5) and tan(67.5) which are
+    // approximated as 1697 / 4096 and 9889 / 4096. Gradients are calculated as differences of right and left, bottom and top pixels
+    const int16_t tangent22  = 1697;
+    const int16_t tangent67  = 9889;
+    const int16_t tangentOne = 4096;
+
+    uint8_t GradientDirection( int32_t gX, int32_t gY )
+    {
+        const int32_t absX = (gX < 0) ? -gX : gX;
+        const int32_t absY = (gY < 0) ? -gY : gY;
+
+        if( absX * tangent22 - absY * tangentOne >= 0 )
+            return (gX < 0) ? 4u : 0u;
+
+        if( absX * tangent67 - absY * tangentOne < 0 )
+            return (gY < 0) ? 6u : 2u;
+
+        if( gX < 0 )
+            return (gY < 0) ? 5u : 3u;
+        else
+            return (gY < 0) ? 7u : 1u;
+    }
+
+    // Calculates gradient magnitude and direction (if needed) for pixels of a row. Input pointer points to the first pixel of the row,
+    // weight is a weight of central row and column of kernel: 1 for Prewitt and 2 for Sobel filters
+    void GradientRow( const uint8_t * in, uint32_t rowSize, uint8_t * magnitude, uint8_t * direction, uint32_t width, int32_t weight,
+                      float multiplier )
+    {
+        const uint8_t * inEnd = in + width;
+
+        for( ; in != inEnd; ++in, ++magnitude ) {
+            const uint8_t * top    = in - rowSize;
+            const uint8_t * bottom = in + rowSize;
+
+            const int32_t gX = top[1] + weight * in[1] + bottom[1] - top[-1] - weight * in[-1] - bottom[-1];
+            const int32_t gY = bottom[-1] + weight * bottom[0] + bottom[1] - top[-1] - weight * top[0] - top[1];
+
+            *magnitude = static_cast<uint8_t>(sqrtf( static_cast<float>(gX * gX + gY * gY) ) * multiplier + 0.5f);
+
+            if( direction != nullptr )
+                *(direction++) = GradientDirection( gX, gY );
+        }
+    }
+
+#ifdef PENGUINV_AVX_SET
+    namespace avx
+    {
+        void GradientRow( const uint8_t * in, uint32_t rowSize, uint8_t * magnitude, uint8_t * direction, uint32_t width, int32_t weight,
+                          float multiplier )
+        {
+            const uint32_t simdWidth = width - width % 16u;
+
+            const __m256i zero    = _mm256_setzero_si256();
+            const __m256i weightX = _mm256_set1_epi16( static_cast<int16_t>(weight) );
+            const __m256  scale   = _mm256_set1_ps( multiplier );
+            const __m256  half    = _mm256_set1_ps( 0.5f );
+
+            const __m256i sector22 = _mm256_unpacklo_epi16( _mm256_set1_epi16( tangent22 ), _mm256_set1_epi16( -tangentOne ) );
+            const __m256i sector67 = _mm256_unpacklo_epi16( _mm256_set1_epi16( tangent67 ), _mm256_set1_epi16( -tangentOne ) );
+
+            const __m256i one      = _mm256_set1_epi16( 1 );
+            const __m256i two      = _mm256_set1_epi16( 2 );
+            const __m256i four     = _mm256_set1_epi16( 4 );
+            const __m256i minusOne = _mm256_set1_epi32( -1 );
+
+            const uint8_t * top    = in - rowSize;
+            const uint8_t * bottom = in + rowSize;
+
+            for( uint32_t x = 0; x < simdWidth; x += 16u ) {
+                const __m256i topLeft     = _mm256_cvtepu8_epi16( _mm_loadu_si128( reinterpret_cast<const __m128i*>(top    + x - 1) ) );
+                const __m256i topCenter   = _mm256_cvtepu8_epi16( _mm_loadu_si128( reinterpret_cast<const __m128i*>(top    + x    ) ) );
+                const __m256i topRight    = _mm256_cvtepu8_epi16( _mm_loadu_si128( reinterpret_cast<const __m128i*>(top    + x + 1) ) );
+                const __m256i left        = _mm256_cvtepu8_epi16( _mm_loadu_si128( reinterpret_cast<const __m128i*>(in     + x - 1) ) );
+                const __m256i right       = _mm256_cvtepu8_epi16( _mm_loadu_si128( reinterpret_cast<const __m128i*>(in     + x + 1) ) );
+                const __m256i bottomLeft  = _mm256_cvtepu8_epi16( _mm_loadu_si128( reinterpret_cast<const __m128i*>(bottom + x - 1) ) );
+                const __m256i bottomCenter= _mm256_cvtepu8_epi16( _mm_loadu_si128( reinterpret_cast<const __m128i*>(bottom + x    ) ) );
+                const __m256i bottomRight = _mm256_cvtepu8_epi16( _mm_loadu_si128( reinterpret_cast<const __m128i*>(bottom + x + 1) ) );
+
+                const __m256i gX = _mm256_sub_epi16( _mm256_add_epi16( _mm256_add_epi16( topRight, bottomRight ), _mm256_mullo_epi16( right, weightX ) ),
+                                                     _mm256_add_epi16( _mm256_add_epi16( topLeft, bottomLeft ), _mm256_mullo_epi16( left, weightX ) ) );
+                const __m256i gY = _mm256_sub_epi16( _mm256_add_epi16( _mm256_add_epi16( bottomLeft, bottomRight ), _mm256_mullo_epi16( bottomCenter, weightX ) ),
+                                                     _mm256_add_epi16( _mm256_add_epi16( topLeft, topRight ), _mm256_mullo_epi16( topCenter, weightX ) ) );
+
+                // unpacking and packing back within 128-bit lanes keep the order of pixels
+                const __m256i gLo = _mm256_unpacklo_epi16( gX, gY );
+                const __m256i gHi = _mm256_unpackhi_epi16( gX, gY );
+
+                const __m256i valueLo = _mm256_cvttps_epi32( _mm256_add_ps( _mm256_mul_ps( _mm256_sqrt_ps( _mm256_cvtepi32_ps(
+                                            _mm256_madd_epi16( gLo, gLo ) ) ), scale ), half ) );
+                const __m256i valueHi = _mm256_cvttps_epi32( _mm256_add_ps( _mm256_mul_ps( _mm256_sqrt_ps( _mm256_cvtepi32_ps(
+                                            _mm256_madd_epi16( gHi, gHi ) ) ), scale ), half ) );
+
+                const __m256i value = _mm256_packs_epi32( valueLo, valueHi );
+                _mm_storeu_si128( reinterpret_cast<__m128i*>(magnitude + x),
+                                  _mm256_castsi256_si128( _mm256_permute4x64_epi64( _mm256_packus_epi16( value, value ), 0x08 ) ) );
+
+                if( direction != nullptr ) {
+                    const __m256i absLo = _mm256_unpacklo_epi16( _mm256_abs_epi16( gX ), _mm256_abs_epi16( gY ) );
+                    const __m256i absHi = _mm256_unpackhi_epi16( _mm256_abs_epi16( gX ), _mm256_abs_epi16( gY ) );
+
+                    const __m256i horizontal = _mm256_packs_epi32( _mm256_cmpgt_epi32( _mm256_madd_epi16( absLo, sector22 ), minusOne ),
+                                                                   _mm256_cmpgt_epi32( _mm256_madd_epi16( absHi, sector22 ), minusOne ) );
+                    const __m256i vertical   = _mm256_packs_epi32( _mm256_cmpgt_epi32( zero, _mm256_madd_epi16( absLo, sector67 ) ),
+                                                                   _mm256_cmpgt_epi32( zero, _mm256_madd_epi16( absHi, sector67 ) ) );
+
+                    const __m256i negativeX = _mm256_cmpgt_epi16( zero, gX );
+                    const __m256i negativeY = _mm256_cmpgt_epi16( zero, gY );
+
+                    const __m256i directionX = _mm256_and_si256( negativeX, four );
+                    const __m256i directionY = _mm256_add_epi16( two, _mm256_and_si256( negativeY, four ) );
+                    const __m256i diagonal   = _mm256_add_epi16( _mm256_add_epi16( one, _mm256_and_si256( _mm256_xor_si256( negativeX, negativeY ), two ) ),
+                                                                 _mm256_and_si256( negativeY, four ) );
+
+                    const __m256i sector = _mm256_or_si256( _mm256_or_si256( _mm256_and_si256( horizontal, directionX ),
+                                                                             _mm256_and_si256( vertical, directionY ) ),
+                                                            _mm256_andnot_si256( _mm256_or_si256( horizontal, vertical ), diagonal ) );
+
+                    _mm_storeu_si128( reinterpret_cast<__m128i*>(direction + x),
+                                      _mm256_castsi256_si128( _mm256_permute4x64_epi64( _mm256_packus_epi16( sector, sector ), 0x08 ) ) );
+                }
+            }
+
+            ::GradientRow( in + simdWidth, rowSize, magnitude + simdWidth, (direction != nullptr) ? direction + simdWidth : nullptr,
+                           width - simdWidth, weight, multiplier );
+        }
+    }
+#endif
+
+#ifdef PENGUINV_SSE_SET
+    namespace sse
+    {
+        __m128i Load( const uint8_t * in )
+        {
+            return _mm_unpacklo_epi8( _mm_loadl_epi64( reinterpret_cast<const __m128i*>(in) ), _mm_setzero_si128() );
+        }
+
+        __m128i Absolute( __m128i value )
+        {
+            return _mm_max_epi16( value, _mm_sub_epi16( _mm_setzero_si128(), value ) );
+        }
+
+        void GradientRow( const uint8_t * in, uint32_t rowSize, uint8_t * magnitude, uint8_t * direction, uint32_t width, int32_t weight,
+                          float multiplier )
+        {
+            const uint32_t simdWidth = width - width % 8u;
+
+            const __m128i zero    = _mm_setzero_si128();
+            const __m128i weightX = _mm_set1_epi16( static_cast<int16_t>(weight) );
+            const __m128  scale   = _mm_set1_ps( multiplier );
+            const __m128  half    = _mm_set1_ps( 0.5f );
+
+            const __m128i sector22 = _mm_unpacklo_epi16( _mm_set1_epi16( tangent22 ), _mm_set1_epi16( -tangentOne ) );
+            const __m128i sector67 = _mm_unpacklo_epi16( _mm_set1_epi16( tangent67 ), _mm_set1_epi16( -tangentOne ) );
+
+            const __m128i one      = _mm_set1_epi16( 1 );
+            const __m128i two      = _mm_set1_epi16( 2 );
+            const __m128i four     = _mm_set1_epi16( 4 );
+            const __m128i minusOne = _mm_set1_epi32( -1 );
+
+            const uint8_t * top    = in - rowSize;
+            const uint8_t * bottom = in + rowSize;
+
+            for( uint32_t x = 0; x < simdWidth; x += 8u ) {
+                const __m128i topLeft      = Load( top    + x - 1 );
+                const __m128i topCenter    = Load( top    + x     );
+                const __m128i topRight     = Load( top    + x + 1 );
+                const __m128i left         = Load( in     + x - 1 );
+                const __m128i right        = Load( in     + x + 1 );
+                const __m128i bottomLeft   = Load( bottom + x - 1 );
+                const __m128i bottomCenter = Load( bottom + x     );
+                const __m128i bottomRight  = Load( bottom + x + 1 );
+
+                const __m128i gX = _mm_sub_epi16( _mm_add_epi16( _mm_add_epi16( topRight, bottomRight ), _mm_mullo_epi16( right, weightX ) ),
+                                                  _mm_add_epi16( _mm_add_epi16( topLeft, bottomLeft ), _mm_mullo_epi16( left, weightX ) ) );
+                const __m128i gY = _mm_sub_epi16( _mm_add_epi16( _mm_add_epi16( bottomLeft, bottomRight ), _mm_mullo_epi16( bottomCenter, weightX ) ),
+                                                  _mm_add_epi16( _mm_add_epi16( topLeft, topRight ), _mm_mullo_epi16( topCenter, weightX ) ) );
+
+                const __m128i gLo = _mm_unpacklo_epi16( gX, gY );
+                const __m128i gHi = _mm_unpackhi_epi16( gX, gY );
+
+                const __m128i valueLo = _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( _mm_sqrt_ps( _mm_cvtepi32_ps( _mm_madd_epi16( gLo, gLo ) ) ),
+                                                                                  scale ), half ) );
+                const __m128i valueHi = _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( _mm_sqrt_ps( _mm_cvtepi32_ps( _mm_madd_epi16( gHi, gHi ) ) ),
+                                                                                  scale ), half ) );
+
+                const __m128i value = _mm_packs_epi32( valueLo, valueHi );
+                _mm_storel_epi64( reinterpret_cast<__m128i*>(magnitude + x), _mm_packus_epi16( value, value ) );
+
+                if( direction != nullptr ) {
+                    const __m128i absLo = _mm_unpacklo_epi16( Absolute( gX ), Absolute( gY ) );
+                    const __m128i absHi = _mm_unpackhi_epi16( Absolute( gX ), Absolute( gY ) );
+
+                    const __m128i horizontal = _mm_packs_epi32( _mm_cmpgt_epi32( _mm_madd_epi16( absLo, sector22 ), minusOne ),
+                                                                _mm_cmpgt_epi32( _mm_madd_epi16( absHi, sector22 ), minusOne ) );
+                    const __m128i vertical   = _mm_packs_epi32( _mm_cmplt_epi32( _mm_madd_epi16( absLo, sector67 ), zero ),
+                                                                _mm_cmplt_epi32( _mm_madd_epi16( absHi, sector67 ), zero ) );
+
+                    const __m128i negativeX = _mm_cmplt_epi16( gX, zero );
+                    const __m128i negativeY = _mm_cmplt_epi16( gY, zero );
+
+                    const __m128i directionX = _mm_and_si128( negativeX, four );
+                    const __m128i directionY = _mm_add_epi16( two, _mm_and_si128( negativeY, four ) );
+                    const __m128i diagonal   = _mm_add_epi16( _mm_add_epi16( one, _mm_and_si128( _mm_xor_si128( negativeX, negativeY ), two ) ),
+                                                              _mm_and_si128( negativeY, four ) );
+
+                    const __m128i sector = _mm_or_si128( _mm_or_si128( _mm_and_si128( horizontal, directionX ), _mm_and_si128( vertical, directionY ) ),
+                                                         _mm_andnot_si128( _mm_or_si128( horizontal, vertical ), diagonal ) );
+
+                    _mm_storel_epi64( reinterpret_cast<__m128i*>(direction + x), _mm_packus_epi16( sector, sector ) );
+                }
+            }
+
+            ::GradientRow( in + simdWidth, rowSize, magnitude + simdWidth, (direction != nullptr) ? direction + simdWidth : nullptr,
+                           width - simdWidth, weight, multiplier );
+        }
+    }
+#endif
+
+#ifdef PENGUINV_NEON_SET
+    namespace neon
+    {
+        // ARMv7 does not have floating point square root instruction so only gradients and directions are vectorized
+        void GradientRow( const uint8_t * in, uint32_t rowSize, uint8_t * magnitude, uint8_t * direction, uint32_t width, int32_t weight,
+                          float multiplier )
+        {
+            const uint32_t simdWidth = width - width % 8u;
+
+            const int16x8_t weightX = vdupq_n_s16( static_cast<int16_t>(weight) );
+            const int16x8_t zero    = vdupq_n_s16( 0 );
+            const uint16x8_t one    = vdupq_n_u16( 1 );
+            const uint16x8_t two    = vdupq_n_u16( 2 );
+            const uint16x8_t four   = vdupq_n_u16( 4 );
+
+            const uint8_t * top    = in - rowSize;
+            const uint8_t * bottom = in + rowSize;
+
+            int32_t squared[8];
+
+            for( uint32_t x = 0; x < simdWidth; x += 8u ) {
+                const int16x8_t topLeft      = vreinterpretq_s16_u16( vmovl_u8( vld1_u8( top    + x - 1 ) ) );
+                const int16x8_t topCenter    = vreinterpretq_s16_u16( vmovl_u8( vld1_u8( top    + x     ) ) );
+                const int16x8_t topRight     = vreinterpretq_s16_u16( vmovl_u8( vld1_u8( top    + x + 1 ) ) );
+                const int16x8_t left         = vreinterpretq_s16_u16( vmovl_u8( vld1_u8( in     + x - 1 ) ) );
+                const int16x8_t right        = vreinterpretq_s16_u16( vmovl_u8( vld1_u8( in     + x + 1 ) ) );
+                const int16x8_t bottomLeft   = vreinterpretq_s16_u16( vmovl_u8( vld1_u8( bottom + x - 1 ) ) );
+                const int16x8_t bottomCenter = vreinterpretq_s16_u16( vmovl_u8( vld1_u8( bottom + x     ) ) );
+                const int16x8_t bottomRight  = vreinterpretq_s16_u16( vmovl_u8( vld1_u8( bottom + x + 1 ) ) );
+
+                const int16x8_t gX = vsubq_s16( vmlaq_s16( vaddq_s16( topRight, bottomRight ), right, weightX ),
+                                                vmlaq_s16( vaddq_s16( topLeft, bottomLeft ), left, weightX ) );
+                const int16x8_t gY = vsubq_s16( vmlaq_s16( vaddq_s16( bottomLeft, bottomRight ), bottomCenter, weightX ),
+                                                vmlaq_s16( vaddq_s16( topLeft, topRight ), topCenter, weightX ) );
+
+                vst1q_s32( squared,     vmlal_s16( vmull_s16( vget_low_s16 ( gX ), vget_low_s16 ( gX ) ), vget_low_s16 ( gY ), vget_low_s16 ( gY ) ) );
+                vst1q_s32( squared + 4, vmlal_s16( vmull_s16( vget_high_s16( gX ), vget_high_s16( gX ) ), vget_high_s16( gY ), vget_high_s16( gY ) ) );
+
+                for( uint32_t i = 0; i < 8u; ++i )
+                    magnitude[x + i] = static_cast<uint8_t>(sqrtf( static_cast<float>(squared[i]) ) * multiplier + 0.5f);
+
+                if( direction != nullptr ) {
+                    const int16x4_t absXLo = vget_low_s16 ( vabsq_s16( gX ) );
+                    const int16x4_t absXHi = vget_high_s16( vabsq_s16( gX ) );
+                    const int16x4_t absYLo = vget_low_s16 ( vabsq_s16( gY ) );
+                    const int16x4_t absYHi = vget_high_s16( vabsq_s16( gY ) );
+
+                    const uint16x8_t horizontal = vcombine_u16(
+                        vmovn_u32( vcgeq_s32( vmlsl_n_s16( vmull_n_s16( absXLo, tangent22 ), absYLo, tangentOne ), vdupq_n_s32( 0 ) ) ),
+                        vmovn_u32( vcgeq_s32( vmlsl_n_s16( vmull_n_s16( absXHi, tangent22 ), absYHi, tangentOne ), vdupq_n_s32( 0 ) ) ) );
+                    const uint16x8_t vertical = vcombine_u16(
+                        vmovn_u32( vcltq_s32( vmlsl_n_s16( vmull_n_s16( absXLo, tangent67 ), absYLo, tangentOne ), vdupq_n_s32( 0 ) ) ),
+                        vmovn_u32( vcltq_s32( vmlsl_n_s16( vmull_n_s16( absXHi, tangent67 ), absYHi, tangentOne ), vdupq_n_s32( 0 ) ) ) );
+
+                    const uint16x8_t negativeX = vcltq_s16( gX, zero );
+                    const uint16x8_t negativeY = vcltq_s16( gY, zero );
+
+                    const uint16x8_t directionX = vandq_u16( negativeX, four );
+                    const uint16x8_t directionY = vaddq_u16( two, vandq_u16( negativeY, four ) );
+                    const uint16x8_t diagonal   = vaddq_u16( vaddq_u16( one, vandq_u16( veorq_u16( negativeX, negativeY ), two ) ),
+                                                             vandq_u16( negativeY, four ) );
+
+                    const uint16x8_t sector = vbslq_u16( horizontal, directionX, vbslq_u16( vertical, directionY, diagonal ) );
+
+                    vst1_u8( direction + x, vmovn_u16( sector ) );
+                }
+            }
+
+            ::GradientRow( in + simdWidth, rowSize, magnitude + simdWidth, (direction != nullptr) ? direction + simdWidth : nullptr,
+                           width - simdWidth, weight, multiplier );
+        }
+    }
+#endif
+
+    // SIMD technique is chosen by simd::actualSimdType() so these kernels are switched off by Simd_Activation functions
+    // as any other SIMD code. AVX-512 kernel is not implemented and AVX one is used instead
+    void GradientRowSimd( const uint8_t * in, uint32_t rowSize, uint8_t * magnitude, uint8_t * direction, uint32_t width, int32_t weight,
+                          float multiplier, simd::SIMDType simdType )
+    {
+#ifdef PENGUINV_AVX_SET
+        if( (simdType == simd::avx512_function && isAvxAvailable) || simdType == simd::avx_function ) {
+            avx::GradientRow( in, rowSize, magnitude, direction, width, weight, multiplier );
+            return;
+        }
+#endif
+#ifdef PENGUINV_SSE_SET
+        if( simdType != simd::cpu_function && simdType != simd::neon_function ) {
+            sse::GradientRow( in, rowSize, magnitude, direction, width, weight, multiplier );
+            return;
+        }
+#endif
+#ifdef PENGUINV_NEON_SET
+        if( simdType == simd::neon_function ) {
+            neon::GradientRow( in, rowSize, magnitude, direction, width, weight, multiplier );
+            return;
+        }
+#endif
+        GradientRow( in, rowSize, magnitude, direction, width, weight, multiplier );
+    }
+
+    // Calculates gradient magnitude and direction (if direction image is not null) of pixels which are not on borders of the area
+    void Gradient( const Image_Function::Image & in, uint32_t startXIn, uint32_t startYIn, Image_Function::Image & magnitude,
+                   uint32_t startXMagnitude, uint32_t startYMagnitude, Image_Function::Image * direction, uint32_t startXDirection,
+                   uint32_t startYDirection, uint32_t width, uint32_t height, int32_t weight )
+    {
+        if( width < 3 || height < 3 )
+            throw imageException( "Input image is very small for gradient filter to be applied" );
+
+        // maximum value of gradient is 255 * (weight + 2) in both directions
+        const float maximumGradient = 255.0f * static_cast<float>(weight + 2);
+        const float multiplier = 255.0f / sqrtf( 2.0f * maximumGradient * maximumGradient );
+
+        const uint32_t rowSizeIn        = in.rowSize();
+        const uint32_t rowSizeMagnitude = magnitude.rowSize();
+        const uint32_t rowSizeDirection = (direction != nullptr) ? direction->rowSize() : 0u;
+
+        const uint8_t * inY        = in.data() + (startYIn + 1) * rowSizeIn + startXIn + 1;
+        uint8_t       * magnitudeY = magnitude.data() + (startYMagnitude + 1) * rowSizeMagnitude + startXMagnitude + 1;
+        uint8_t       * directionY = (direction != nullptr) ? direction->data() + (startYDirection + 1) * rowSizeDirection + startXDirection + 1
+                                                            : nullptr;
+
+        const uint8_t * inYEnd = inY + (height - 2) * rowSizeIn;
+
+        const simd::SIMDType simdType = simd::actualSimdType();
+
+        for( ; inY != inYEnd; inY += rowSizeIn, magnitudeY += rowSizeMagnitude ) {
+            GradientRowSimd( inY, rowSizeIn, magnitudeY, directionY, width - 2, weight, multiplier, simdType );
+
+            if( directionY != nullptr )
+                directionY += rowSizeDirection;
+        }
+    }
+
+    // Fills 1 pixel wide frame of the area by zeros
+    void ZeroBorders( Image_Function::Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height )
+    {
+        const uint32_t rowSize = image.rowSize();
+
+        uint8_t * outY = image.data() + y * rowSize + x;
+
+        memset( outY, 0, width );
+        memset( outY + (height - 1) * rowSize, 0, width );
+
+        for( uint32_t i = 1; i + 1 < height; ++i ) {
+            outY[i * rowSize]             = 0;
+            outY[i * rowSize + width - 1] = 0;
+        }
+    }
+
+    void GradientFilter( const Image_Function::Image & in, uint32_t startXIn, uint32_t startYIn, Image_Function::Image & magnitude,
+                         uint32_t startXMagnitude, uint32_t startYMagnitude, Image_Function::Image * direction, uint32_t startXDirection,
+                         uint32_t startYDirection, uint32_t width, uint32_t height, int32_t weight )
+    {
+        Gradient( in, startXIn, startYIn, magnitude, startXMagnitude, startYMagnitude, direction, startXDirection, startYDirection,
+                  width, height, weight );
+
+        ZeroBorders( magnitude, startXMagnitude, startYMagnitude, width, height );
+        if( direction != nullptr )
+            ZeroBorders( *direction, startXDirection, startYDirection, width, height );
+    }
+
+    const int32_t prewittWeight = 1;
+    const int32_t sobelWeight   = 2;
+
+    // Huang algorithm is faster for kernels smaller than this value
+    const uint32_t perreaultHebertKernelSize = 15u;
+    // Column histograms of Perreault-Hebert algorithm store 16-bit values
+    const uint32_t maximumPerreaultHebertKernelSize = 65535u;
+}
 
 namespace Image_Function
 {
+    Image Convolve( const Image & in, const std::vector < float > & kernelX, const std::vector < float > & kernelY, BorderMode border )
+    {
+        ParameterValidation( in );
+
+        Image out( in.width(), in.height() );
+
+        Convolve( in, 0, 0, out, 0, 0, out.width(), out.height(), kernelX, kernelY, border );
+
+        return out;
+    }
+
+    void Convolve( const Image & in, Image & out, const std::vector < float > & kernelX, const std::vector < float > & kernelY,
+                   BorderMode border )
+    {
+        ParameterValidation( in, out );
+
+        Convolve( in, 0, 0, out, 0, 0, out.width(), out.height(), kernelX, kernelY, border );
+    }
+
+    Image Convolve( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height,
+                    const std::vector < float > & kernelX, const std::vector < float > & kernelY, BorderMode border )
+    {
+        ParameterValidation( in, startXIn, startYIn, width, height );
+
+        Image out( width, height );
+
+        Convolve( in, startXIn, startYIn, out, 0, 0, width, height, kernelX, kernelY, border );
+
+        return out;
+    }
+
+    void Convolve( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                   uint32_t width, uint32_t height, const std::vector < float > & kernelX, const std::vector < float > & kernelY,
+                   BorderMode border )
+    {
+        ParameterValidation( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+        VerifyGrayScaleImage( in, out );
+        VerifyConvolutionKernels( in, kernelX.size(), kernelY.size(), border );
+
+        ConvolveSeparable( in, startXIn, startYIn, out, startXOut, startYOut, width, height, kernelX, kernelY, 0, border );
+    }
+
+    Image Convolve( const Image & in, const std::vector < int16_t > & kernelX, const std::vector < int16_t > & kernelY, uint8_t shift,
+                    BorderMode border )
+    {
+        ParameterValidation( in );
+
+        Image out( in.width(), in.height() );
+
+        Convolve( in, 0, 0, out, 0, 0, out.width(), out.height(), kernelX, kernelY, shift, border );
+
+        return out;
+    }
+
+    void Convolve( const Image & in, Image & out, const std::vector < int16_t > & kernelX, const std::vector < int16_t > & kernelY,
+                   uint8_t shift, BorderMode border )
+    {
+        ParameterValidation( in, out );
+
+        Convolve( in, 0, 0, out, 0, 0, out.width(), out.height(), kernelX, kernelY, shift, border );
+    }
+
+    Image Convolve( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height,
+                    const std::vector < int16_t > & kernelX, const std::vector < int16_t > & kernelY, uint8_t shift, BorderMode border )
+    {
+        ParameterValidation( in, startXIn, startYIn, width, height );
+
+        Image out( width, height );
+
+        Convolve( in, startXIn, startYIn, out, 0, 0, width, height, kernelX, kernelY, shift, border );
+
+        return out;
+    }
+
+    void Convolve( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                   uint32_t width, uint32_t height, const std::vector < int16_t > & kernelX, const std::vector < int16_t > & kernelY,
+                   uint8_t shift, BorderMode border )
+    {
+        ParameterValidation( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+        VerifyGrayScaleImage( in, out );
+        VerifyConvolutionKernels( in, kernelX.size(), kernelY.size(), border );
+
+        // rows are convolved in 16-bit integers and columns in 32-bit integers so there must be no overflow
+        const int64_t maximumRowValue = 255 * SumAbsolute( kernelX );
+        if( shift > 30 || maximumRowValue > 32767 || maximumRowValue * SumAbsolute( kernelY ) + (int64_t(1) << shift) > 2147483647 )
+            throw imageException( "Fixed-point convolution kernels are too big" );
+
+        ConvolveSeparable( in, startXIn, startYIn, out, startXOut, startYOut, width, height, kernelX, kernelY, shift, border );
+    }
+
+    Image GaussianBlur( const Image & in, uint32_t kernelSize, float sigma, BorderMode border )
+    {
+        ParameterValidation( in );
+
+        Image out( in.width(), in.height() );
+
+        GaussianBlur( in, 0, 0, out, 0, 0, out.width(), out.height(), kernelSize, sigma, border );
+
+        return out;
+    }
+
+    void GaussianBlur( const Image & in, Image & out, uint32_t kernelSize, float sigma, BorderMode border )
+    {
+        ParameterValidation( in, out );
+
+        GaussianBlur( in, 0, 0, out, 0, 0, out.width(), out.height(), kernelSize, sigma, border );
+    }
+
+    Image GaussianBlur( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t kernelSize,
+                        float sigma, BorderMode border )
+    {
+        ParameterValidation( in, startXIn, startYIn, width, height );
+
+        Image out( width, height );
+
+        GaussianBlur( in, startXIn, startYIn, out, 0, 0, width, height, kernelSize, sigma, border );
+
+        return out;
+    }
+
+    void GaussianBlur( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                       uint32_t width, uint32_t height, uint32_t kernelSize, float sigma, BorderMode border )
+    {
+        std::vector < float > kernel;
+        GetGaussianKernel( kernel, kernelSize, sigma );
+
+        Convolve( in, startXIn, startYIn, out, startXOut, startYOut, width, height, kernel, kernel, border );
+    }
+
+    Image16Bit Convolve( const Image16Bit & in, const std::vector < float > & kernelX, const std::vector < float > & kernelY, BorderMode border )
+    {
+        ParameterValidation( in );
+
+        Image16Bit out( in.width(), in.height() );
+
+        Convolve( in, 0, 0, out, 0, 0, out.width(), out.height(), kernelX, kernelY, border );
+
+        return out;
+    }
+
+    void Convolve( const Image16Bit & in, Image16Bit & out, const std::vector < float > & kernelX, const std::vector < float > & kernelY,
+                   BorderMode border )
+    {
+        ParameterValidation( in, out );
+
+        Convolve( in, 0, 0, out, 0, 0, out.width(), out.height(), kernelX, kernelY, border );
+    }
+
+    Image16Bit Convolve( const Image16Bit & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height,
+                         const std::vector < float > & kernelX, const std::vector < float > & kernelY, BorderMode border )
+    {
+        ParameterValidation( in, startXIn, startYIn, width, height );
+
+        Image16Bit out( width, height );
+
+        Convolve( in, startXIn, startYIn, out, 0, 0, width, height, kernelX, kernelY, border );
+
+        return out;
+    }
+
+    void Convolve( const Image16Bit & in, uint32_t startXIn, uint32_t startYIn, Image16Bit & out, uint32_t startXOut, uint32_t startYOut,
+                   uint32_t width, uint32_t height, const std::vector < float > & kernelX, const std::vector < float > & kernelY,
+                   BorderMode border )
+    {
+        ParameterValidation( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+        VerifyGrayScaleImage( in, out );
+        VerifyConvolutionKernels( in, kernelX.size(), kernelY.size(), border );
+
+        ConvolveSeparable( in, startXIn, startYIn, out, startXOut, startYOut, width, height, kernelX, kernelY, 0, border );
+    }
+
+    Image16Bit GaussianBlur( const Image16Bit & in, uint32_t kernelSize, float sigma, BorderMode border )
+    {
+        ParameterValidation( in );
+
+        Image16Bit out( in.width(), in.height() );
+
+        GaussianBlur( in, 0, 0, out, 0, 0, out.width(), out.height(), kernelSize, sigma, border );
+
+        return out;
+    }
+
+    void GaussianBlur( const Image16Bit & in, Image16Bit & out, uint32_t kernelSize, float sigma, BorderMode border )
+    {
+        ParameterValidation( in, out );
+
+        GaussianBlur( in, 0, 0, out, 0, 0, out.width(), out.height(), kernelSize, sigma, border );
+    }
+
+    Image16Bit GaussianBlur( const Image16Bit & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t kernelSize,
+                             float sigma, BorderMode border )
+    {
+        ParameterValidation( in, startXIn, startYIn, width, height );
+
+        Image16Bit out( width, height );
+
+        GaussianBlur( in, startXIn, startYIn, out, 0, 0, width, height, kernelSize, sigma, border );
+
+        return out;
+    }
+
+    void GaussianBlur( const Image16Bit & in, uint32_t startXIn, uint32_t startYIn, Image16Bit & out, uint32_t startXOut, uint32_t startYOut,
+                       uint32_t width, uint32_t height, uint32_t kernelSize, float sigma, BorderMode border )
+    {
+        std::vector < float > kernel;
+        GetGaussianKernel( kernel, kernelSize, sigma );
+
+        Convolve( in, startXIn, startYIn, out, startXOut, startYOut, width, height, kernel, kernel, border );
+    }
+
+    ImageFloat Convolve( const ImageFloat & in, const std::vector < float > & kernelX, const std::vector < float > & kernelY, BorderMode border )
+    {
+        ParameterValidation( in );
+
+        ImageFloat out( in.width(), in.height() );
+
+        Convolve( in, 0, 0, out, 0, 0, out.width(), out.height(), kernelX, kernelY, border );
+
+        return out;
+    }
+
+    void Convolve( const ImageFloat & in, ImageFloat & out, const std::vector < float > & kernelX, const std::vector < float > & kernelY,
+                   BorderMode border )
+    {
+        ParameterValidation( in, out );
+
+        Convolve( in, 0, 0, out, 0, 0, out.width(), out.height(), kernelX, kernelY, border );
+    }
+
+    ImageFloat Convolve( const ImageFloat & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height,
+                         const std::vector < float > & kernelX, const std::vector < float > & kernelY, BorderMode border )
+    {
+        ParameterValidation( in, startXIn, startYIn, width, height );
+
+        ImageFloat out( width, height );
+
+        Convolve( in, startXIn, startYIn, out, 0, 0, width, height, kernelX, kernelY, border );
+
+        return out;
+    }
+
+    void Convolve( const ImageFloat & in, uint32_t startXIn, uint32_t startYIn, ImageFloat & out, uint32_t startXOut, uint32_t startYOut,
+                   uint32_t width, uint32_t height, const std::vector < float > & kernelX, const std::vector < float > & kernelY,
+                   BorderMode border )
+    {
+        ParameterValidation( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+        VerifyGrayScaleImage( in, out );
+        VerifyConvolutionKernels( in, kernelX.size(), kernelY.size(), border );
+
+        ConvolveSeparable( in, startXIn, startYIn, out, startXOut, startYOut, width, height, kernelX, kernelY, 0, border );
+    }
+
+    ImageFloat GaussianBlur( const ImageFloat & in, uint32_t kernelSize, float sigma, BorderMode border )
+    {
+        ParameterValidation( in );
+
+        ImageFloat out( in.width(), in.height() );
+
+        GaussianBlur( in, 0, 0, out, 0, 0, out.width(), out.height(), kernelSize, sigma, border );
+
+        return out;
+    }
+
+    void GaussianBlur( const ImageFloat & in, ImageFloat & out, uint32_t kernelSize, float sigma, BorderMode border )
+    {
+        ParameterValidation( in, out );
+
+        GaussianBlur( in, 0, 0, out, 0, 0, out.width(), out.height(), kernelSize, sigma, border );
+    }
+
+    ImageFloat GaussianBlur( const ImageFloat & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t kernelSize,
+                             float sigma, BorderMode border )
+    {
+        ParameterValidation( in, startXIn, startYIn, width, height );
+
+        ImageFloat out( width, height );
+
+        GaussianBlur( in, startXIn, startYIn, out, 0, 0, width, height, kernelSize, sigma, border );
+
+        return out;
+    }
+
+    void GaussianBlur( const ImageFloat & in, uint32_t startXIn, uint32_t startYIn, ImageFloat & out, uint32_t startXOut, uint32_t startYOut,
+                       uint32_t width, uint32_t height, uint32_t kernelSize, float sigma, BorderMode border )
+    {
+        std::vector < float > kernel;
+        GetGaussianKernel( kernel, kernelSize, sigma );
+
+        Convolve( in, startXIn, startYIn, out, startXOut, startYOut, width, height, kernel, kernel, border );
+    }
+
     Image Median( const Image & in, uint32_t kernelSize )
     {
         ParameterValidation( in );
@@ -54,8 +1575,17 @@ namespace Image_Function
         Copy( in, startXIn + width - kernelSize / 2, startYIn + kernelSize / 2, out, startXOut + width - kernelSize / 2,
               startYOut + kernelSize / 2, kernelSize / 2, height - (kernelSize - 1) );
 
-        std::vector < uint8_t > data( kernelSize * kernelSize );
-        const size_t dataMedianPosition = data.size() / 2;
+        MedianWithoutBorders( in, startXIn, startYIn, out, startXOut, startYOut, width, height, kernelSize );
+    }
+
+    void MedianWithoutBorders( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                               uint32_t width, uint32_t height, uint32_t kernelSize )
+    {
+        ParameterValidation( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+        VerifyGrayScaleImage( in, out );
+
+        if( kernelSize < 3 || kernelSize % 2 == 0 || kernelSize > width || kernelSize > height )
+            throw imageException( "Kernel size for filter is not correct" );
 
         const uint32_t rowSizeIn  = in.rowSize();
         const uint32_t rowSizeOut = out.rowSize();
@@ -66,33 +1596,10 @@ namespace Image_Function
         width  = width  - (kernelSize - 1);
         height = height - (kernelSize - 1);
 
-        const uint8_t * outYEnd = outY + height * rowSizeOut;
-
-        for( ; outY != outYEnd; outY += rowSizeOut, inY += rowSizeIn ) {
-            const uint8_t * inX = inY;
-            uint8_t       * outX = outY;
-
-            const uint8_t * outXEnd = outX + width;
-
-            for( ; outX != outXEnd; ++outX, ++inX ) {
-                uint8_t * value = data.data();
-
-                const uint8_t * inYRead    = inX;
-                const uint8_t * inYReadEnd = inYRead + kernelSize * rowSizeIn;
-
-                for( ; inYRead != inYReadEnd; inYRead += rowSizeIn ) {
-                    const uint8_t * inXRead    = inYRead;
-                    const uint8_t * inXReadEnd = inXRead + kernelSize;
-
-                    for( ; inXRead != inXReadEnd; ++inXRead, ++value )
-                        *value = *inXRead;
-                }
-
-                std::nth_element( data.begin(), data.begin() + dataMedianPosition, data.end() );
-
-                (*outX) = data[dataMedianPosition];
-            }
-        }
+        if( kernelSize < perreaultHebertKernelSize || kernelSize > maximumPerreaultHebertKernelSize )
+            MedianHuang( inY, rowSizeIn, outY, rowSizeOut, width, height, kernelSize );
+        else
+            MedianPerreaultHebert( inY, rowSizeIn, outY, rowSizeOut, width, height, kernelSize );
     }
 
     Image Prewitt( const Image & in )
@@ -119,7 +1626,7 @@ namespace Image_Function
 
         Image out( width, height );
 
-        Sobel( in, startXIn, startYIn, out, 0, 0, width, height );
+        Prewitt( in, startXIn, startYIn, out, 0, 0, width, height );
 
         return out;
     }
@@ -130,59 +1637,41 @@ namespace Image_Function
         ParameterValidation( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
         VerifyGrayScaleImage( in, out );
 
-        if( width < 3 || height < 3 )
-            throw imageException( "Input image is very small for Sobel filter to be applied" );
-
-        // Create the map of gradient values
-        const uint32_t gradientWidth  = width  - 2;
-        const uint32_t gradientHeight = height - 2;
-
-        const float multiplier = 255.0f / sqrtf( 1170450.0f ); // 1170450 is 2 * (255 * 3) * (255 * 3);
-
-        const uint32_t rowSizeIn  = in.rowSize();
-        const uint32_t rowSizeOut = out.rowSize();
-
-        const uint8_t * inY  = in.data()  + (startYIn + 1) * rowSizeIn + startXIn + 1;
-        uint8_t       * outY = out.data() + startYOut * rowSizeOut + startXOut;
-
-        const uint8_t * inYEnd = inY + gradientHeight * rowSizeIn;
-
-        // fill top row with zeros
-        memset( outY, 0, width );
-        outY += rowSizeOut;
-
-        for( ; inY != inYEnd; inY += rowSizeIn, outY += rowSizeOut ) {
-            // set first pixel in row to 0
-            *outY = 0;
-
-            uint8_t       * outX    = outY + 1;
-            const uint8_t * inX = inY;
-            const uint8_t * inXEnd = inX + gradientWidth;
+        GradientFilter( in, startXIn, startYIn, out, startXOut, startYOut, nullptr, 0, 0, width, height, prewittWeight );
+    }
 
-            for( ; inX != inXEnd; ++inX, ++outX ) {
-                //      | +1  0 -1|
-                // Gx = | +1  0 -1|
-                //      | +1  0 -1|
+    void Prewitt( const Image & in, Image & magnitude, Image & direction )
+    {
+        ParameterValidation( in, magnitude, direction );
 
-                //      | +1 +1 +1|
-                // Gy = |  0  0  0|
-                //      | -1 -1 -1|
+        Prewitt( in, 0, 0, magnitude, 0, 0, direction, 0, 0, in.width(), in.height() );
+    }
 
-                const int32_t gX = *(inX - rowSizeIn - 1) + *(inX - 1) + *(inX + rowSizeIn - 1) -
-                                   *(inX - rowSizeIn + 1) - *(inX + 1) - *(inX + rowSizeIn + 1);
+    void Prewitt( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & magnitude, uint32_t startXMagnitude, uint32_t startYMagnitude,
+                  Image & direction, uint32_t startXDirection, uint32_t startYDirection, uint32_t width, uint32_t height )
+    {
+        ParameterValidation( in, startXIn, startYIn, magnitude, startXMagnitude, startYMagnitude, direction, startXDirection, startYDirection,
+                             width, height );
+        VerifyGrayScaleImage( in, magnitude, direction );
 
-                const int32_t gY = *(inX - rowSizeIn - 1) + *(inX - rowSizeIn) + *(inX - rowSizeIn + 1) -
-                                   *(inX + rowSizeIn - 1) - *(inX + rowSizeIn) - *(inX + rowSizeIn + 1);
+        GradientFilter( in, startXIn, startYIn, magnitude, startXMagnitude, startYMagnitude, &direction, startXDirection, startYDirection,
+                        width, height, prewittWeight );
+    }
 
-                *outX = static_cast<uint8_t>(sqrtf( static_cast<float>(gX * gX + gY + gY) ) * multiplier + 0.5f);
-            }
+    void PrewittWithoutBorders( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & magnitude, uint32_t startXMagnitude,
+                                uint32_t startYMagnitude, Image * direction, uint32_t startXDirection, uint32_t startYDirection,
+                                uint32_t width, uint32_t height )
+    {
+        ParameterValidation( in, startXIn, startYIn, magnitude, startXMagnitude, startYMagnitude, width, height );
+        VerifyGrayScaleImage( in, magnitude );
 
-            // set last pixel in row to 0
-            *outX = 0;
+        if( direction != nullptr ) {
+            ParameterValidation( in, startXIn, startYIn, *direction, startXDirection, startYDirection, width, height );
+            VerifyGrayScaleImage( *direction );
         }
 
-        // fill bottom row with zeros
-        memset( outY, 0, width );
+        Gradient( in, startXIn, startYIn, magnitude, startXMagnitude, startYMagnitude, direction, startXDirection, startYDirection,
+                  width, height, prewittWeight );
     }
 
     Image Sobel( const Image & in )
@@ -220,59 +1709,41 @@ namespace Image_Function
         ParameterValidation( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
         VerifyGrayScaleImage( in, out );
 
-        if( width < 3 || height < 3 )
-            throw imageException( "Input image is very small for Sobel filter to be applied" );
-
-        // Create the map of gradient values
-        const uint32_t gradientWidth  = width  - 2;
-        const uint32_t gradientHeight = height - 2;
-
-        const float multiplier = 255.0f / sqrtf( 2080800.0f ); // 2080800 is 2 * (255 * 4) * (255 * 4);
-
-        const uint32_t rowSizeIn  = in.rowSize();
-        const uint32_t rowSizeOut = out.rowSize();
-
-        const uint8_t * inY  = in.data()  + (startYIn + 1) * rowSizeIn + startXIn + 1;
-        uint8_t       * outY = out.data() + startYOut * rowSizeOut + startXOut;
-
-        const uint8_t * inYEnd = inY + gradientHeight * rowSizeIn;
-
-        // fill top row with zeros
-        memset( outY, 0, width );
-        outY += rowSizeOut;
-
-        for( ; inY != inYEnd; inY += rowSizeIn, outY += rowSizeOut ) {
-            // set first pixel in row to 0
-            *outY = 0;
-
-            uint8_t       * outX    = outY + 1;
-            const uint8_t * inX = inY;
-            const uint8_t * inXEnd = inX + gradientWidth;
+        GradientFilter( in, startXIn, startYIn, out, startXOut, startYOut, nullptr, 0, 0, width, height, sobelWeight );
+    }
 
-            for( ; inX != inXEnd; ++inX, ++outX ) {
-                //      | +1  0 -1|
-                // Gx = | +2  0 -2|
-                //      | +1  0 -1|
+    void Sobel( const Image & in, Image & magnitude, Image & direction )
+    {
+        ParameterValidation( in, magnitude, direction );
 
-                //      | +1 +2 +1|
-                // Gy = |  0  0  0|
-                //      | -1 -2 -1|
+        Sobel( in, 0, 0, magnitude, 0, 0, direction, 0, 0, in.width(), in.height() );
+    }
 
-                const int32_t gX = *(inX - rowSizeIn - 1) + 2 * (*(inX - 1)) + *(inX + rowSizeIn - 1) -
-                                   *(inX - rowSizeIn + 1) - 2 * (*(inX + 1)) - *(inX + rowSizeIn + 1);
+    void Sobel( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & magnitude, uint32_t startXMagnitude, uint32_t startYMagnitude,
+                Image & direction, uint32_t startXDirection, uint32_t startYDirection, uint32_t width, uint32_t height )
+    {
+        ParameterValidation( in, startXIn, startYIn, magnitude, startXMagnitude, startYMagnitude, direction, startXDirection, startYDirection,
+                             width, height );
+        VerifyGrayScaleImage( in, magnitude, direction );
 
-                const int32_t gY = *(inX - rowSizeIn - 1) + 2 * (*(inX - rowSizeIn)) + *(inX - rowSizeIn + 1) -
-                                   *(inX + rowSizeIn - 1) - 2 * (*(inX + rowSizeIn)) - *(inX + rowSizeIn + 1);
+        GradientFilter( in, startXIn, startYIn, magnitude, startXMagnitude, startYMagnitude, &direction, startXDirection, startYDirection,
+                        width, height, sobelWeight );
+    }
 
-                *outX = static_cast<uint8_t>(sqrtf( static_cast<float>(gX * gX + gY + gY) ) * multiplier + 0.5f);
-            }
+    void SobelWithoutBorders( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & magnitude, uint32_t startXMagnitude,
+                              uint32_t startYMagnitude, Image * direction, uint32_t startXDirection, uint32_t startYDirection,
+                              uint32_t width, uint32_t height )
+    {
+        ParameterValidation( in, startXIn, startYIn, magnitude, startXMagnitude, startYMagnitude, width, height );
+        VerifyGrayScaleImage( in, magnitude );
 
-            // set last pixel in row to 0
-            *outX = 0;
+        if( direction != nullptr ) {
+            ParameterValidation( in, startXIn, startYIn, *direction, startXDirection, startYDirection, width, height );
+            VerifyGrayScaleImage( *direction );
         }
 
-        // fill bottom row with zeros
-        memset( outY, 0, width );
+        Gradient( in, startXIn, startYIn, magnitude, startXMagnitude, startYMagnitude, direction, startXDirection, startYDirection,
+                  width, height, sobelWeight );
     }
 
     void GetGaussianKernel( std::vector<float> & filter, uint32_t width, uint32_t height, uint32_t kernelSize, float sigma )
@@ -318,4 +1789,27 @@ namespace Image_Function
             }
         }
     }
+
+    void GetGaussianKernel( std::vector<float> & filter, uint32_t kernelSize, float sigma )
+    {
+        if( kernelSize == 0 || sigma <= 0 )
+            throw imageException( "Incorrect input parameters for Gaussian filter kernel" );
+
+        filter.resize( 2 * kernelSize + 1 );
+
+        const float doubleSigma = sigma * 2;
+
+        float sum = 0;
+
+        for( uint32_t i = 0; i < filter.size(); ++i ) {
+            const float position = static_cast<float>(static_cast<int32_t>(i) - static_cast<int32_t>(kernelSize));
+            filter[i] = expf( -(position * position) / doubleSigma );
+            sum += filter[i];
+        }
+
+        const float normalization = 1.0f / sum;
+
+        for( std::vector<float>::iterator value = filter.begin(); value != filter.end(); ++value )
+            *value *= normalization;
+    }
 }
@@ -7,12 +7,95 @@ namespace Image_Function
 {
     using namespace PenguinV_Image;
 
+    // Methods to get pixel values outside of an image for convolution
+    enum BorderMode
+    {
+        BORDER_CONSTANT,  // pixels outside of an image are equal to 0: 000|abcd|000
+        BORDER_REPLICATE, // the closest pixel of an image is used: aaa|abcd|ddd
+        BORDER_REFLECT    // pixels are mirrored around border pixel: dcb|abcd|cba
+    };
+
+    // Separable convolution: each row is convolved with kernelX and then each column is convolved with kernelY
+    // Both kernels must have odd size. Pixels outside of the area but within the image are taken from the image
+    // while pixels outside of the image are calculated based on border mode
+    Image Convolve( const Image & in, const std::vector < float > & kernelX, const std::vector < float > & kernelY,
+                    BorderMode border = BORDER_REPLICATE );
+    void  Convolve( const Image & in, Image & out, const std::vector < float > & kernelX, const std::vector < float > & kernelY,
+                    BorderMode border = BORDER_REPLICATE );
+    Image Convolve( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height,
+                    const std::vector < float > & kernelX, const std::vector < float > & kernelY, BorderMode border = BORDER_REPLICATE );
+    void  Convolve( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                    uint32_t width, uint32_t height, const std::vector < float > & kernelX, const std::vector < float > & kernelY,
+                    BorderMode border = BORDER_REPLICATE );
+
+    // Fixed-point separable convolution: output pixel is equal to (sum of kernelY * (sum of kernelX * pixel)) >> shift with rounding
+    // 255 * (sum of absolute values of kernelX) must not exceed 32767 as rows are convolved in 16-bit integers
+    Image Convolve( const Image & in, const std::vector < int16_t > & kernelX, const std::vector < int16_t > & kernelY, uint8_t shift,
+                    BorderMode border = BORDER_REPLICATE );
+    void  Convolve( const Image & in, Image & out, const std::vector < int16_t > & kernelX, const std::vector < int16_t > & kernelY,
+                    uint8_t shift, BorderMode border = BORDER_REPLICATE );
+    Image Convolve( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height,
+                    const std::vector < int16_t > & kernelX, const std::vector < int16_t > & kernelY, uint8_t shift,
+                    BorderMode border = BORDER_REPLICATE );
+    void  Convolve( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                    uint32_t width, uint32_t height, const std::vector < int16_t > & kernelX, const std::vector < int16_t > & kernelY,
+                    uint8_t shift, BorderMode border = BORDER_REPLICATE );
+
+    // Gaussian blur with (2 * kernelSize + 1) x (2 * kernelSize + 1) kernel done as separable convolution
+    Image GaussianBlur( const Image & in, uint32_t kernelSize, float sigma, BorderMode border = BORDER_REPLICATE );
+    void  GaussianBlur( const Image & in, Image & out, uint32_t kernelSize, float sigma, BorderMode border = BORDER_REPLICATE );
+    Image GaussianBlur( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t kernelSize,
+                        float sigma, BorderMode border = BORDER_REPLICATE );
+    void  GaussianBlur( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                        uint32_t width, uint32_t height, uint32_t kernelSize, float sigma, BorderMode border = BORDER_REPLICATE );
+
+    // Convolution and Gaussian blur of images with 16-bit and floating point pixels work in the same way as for 8-bit images.
+    // Output values of 16-bit images are rounded and limited by [0, 65535] range, output values of floating point images are not changed
+    Image16Bit Convolve( const Image16Bit & in, const std::vector < float > & kernelX, const std::vector < float > & kernelY,
+                         BorderMode border = BORDER_REPLICATE );
+    void       Convolve( const Image16Bit & in, Image16Bit & out, const std::vector < float > & kernelX, const std::vector < float > & kernelY,
+                         BorderMode border = BORDER_REPLICATE );
+    Image16Bit Convolve( const Image16Bit & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height,
+                         const std::vector < float > & kernelX, const std::vector < float > & kernelY, BorderMode border = BORDER_REPLICATE );
+    void       Convolve( const Image16Bit & in, uint32_t startXIn, uint32_t startYIn, Image16Bit & out, uint32_t startXOut, uint32_t startYOut,
+                         uint32_t width, uint32_t height, const std::vector < float > & kernelX, const std::vector < float > & kernelY,
+                         BorderMode border = BORDER_REPLICATE );
+
+    Image16Bit GaussianBlur( const Image16Bit & in, uint32_t kernelSize, float sigma, BorderMode border = BORDER_REPLICATE );
+    void       GaussianBlur( const Image16Bit & in, Image16Bit & out, uint32_t kernelSize, float sigma, BorderMode border = BORDER_REPLICATE );
+    Image16Bit GaussianBlur( const Image16Bit & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t kernelSize,
+                             float sigma, BorderMode border = BORDER_REPLICATE );
+    void       GaussianBlur( const Image16Bit & in, uint32_t startXIn, uint32_t startYIn, Image16Bit & out, uint32_t startXOut, uint32_t startYOut,
+                             uint32_t width, uint32_t height, uint32_t kernelSize, float sigma, BorderMode border = BORDER_REPLICATE );
+
+    ImageFloat Convolve( const ImageFloat & in, const std::vector < float > & kernelX, const std::vector < float > & kernelY,
+                         BorderMode border = BORDER_REPLICATE );
+    void       Convolve( const ImageFloat & in, ImageFloat & out, const std::vector < float > & kernelX, const std::vector < float > & kernelY,
+                         BorderMode border = BORDER_REPLICATE );
+    ImageFloat Convolve( const ImageFloat & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height,
+                         const std::vector < float > & kernelX, const std::vector < float > & kernelY, BorderMode border = BORDER_REPLICATE );
+    void       Convolve( const ImageFloat & in, uint32_t startXIn, uint32_t startYIn, ImageFloat & out, uint32_t startXOut, uint32_t startYOut,
+                         uint32_t width, uint32_t height, const std::vector < float > & kernelX, const std::vector < float > & kernelY,
+                         BorderMode border = BORDER_REPLICATE );
+
+    ImageFloat GaussianBlur( const ImageFloat & in, uint32_t kernelSize, float sigma, BorderMode border = BORDER_REPLICATE );
+    void       GaussianBlur( const ImageFloat & in, ImageFloat & out, uint32_t kernelSize, float sigma, BorderMode border = BORDER_REPLICATE );
+    ImageFloat GaussianBlur( const ImageFloat & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t kernelSize,
+                             float sigma, BorderMode border = BORDER_REPLICATE );
+    void       GaussianBlur( const ImageFloat & in, uint32_t startXIn, uint32_t startYIn, ImageFloat & out, uint32_t startXOut, uint32_t startYOut,
+                             uint32_t width, uint32_t height, uint32_t kernelSize, float sigma, BorderMode border = BORDER_REPLICATE );
+
     Image Median( const Image & in, uint32_t kernelSize );
     void  Median( const Image & in, Image & out, uint32_t kernelSize );
     Image Median( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t kernelSize );
     void  Median( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                   uint32_t width, uint32_t height, uint32_t kernelSize );
 
+    // Same as Median function but output pixels located closer than kernelSize / 2 to borders of the area are not modified
+    // It allows to process an image by overlapping parts, for example, in multiple threads
+    void MedianWithoutBorders( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                               uint32_t width, uint32_t height, uint32_t kernelSize );
+
     // This filter returns image based on gradient magnitude in both X and Y directions
     Image Prewitt( const Image & in );
     void  Prewitt( const Image & in, Image & out );
@@ -20,6 +103,18 @@ namespace Image_Function
     void  Prewitt( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                    uint32_t width, uint32_t height );
 
+    // Gradient magnitude and quantized gradient direction are calculated in one pass. Direction is a number of 45 degree sector:
+    // 0 - along X axis, 2 - along Y axis (downwards), 4 - opposite to X axis, 6 - opposite to Y axis, odd values - diagonals
+    void  Prewitt( const Image & in, Image & magnitude, Image & direction );
+    void  Prewitt( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & magnitude, uint32_t startXMagnitude, uint32_t startYMagnitude,
+                   Image & direction, uint32_t startXDirection, uint32_t startYDirection, uint32_t width, uint32_t height );
+
+    // Same as Prewitt function but output pixels on borders of the area are not modified. Direction image is optional (can be nullptr)
+    // It allows to process an image by overlapping parts, for example, in multiple threads
+    void PrewittWithoutBorders( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & magnitude, uint32_t startXMagnitude,
+                                uint32_t startYMagnitude, Image * direction, uint32_t startXDirection, uint32_t startYDirection,
+                                uint32_t width, uint32_t height );
+
     // This filter returns image based on gradient magnitude in both X and Y directions
     Image Sobel( const Image & in );
     void  Sobel( const Image & in, Image & out );
@@ -27,5 +122,16 @@ namespace Image_Function
     void  Sobel( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                  uint32_t width, uint32_t height );
 
+    // Gradient magnitude and quantized gradient direction in one pass. Direction values are the same as for Prewitt function
+    void  Sobel( const Image & in, Image & magnitude, Image & direction );
+    void  Sobel( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & magnitude, uint32_t startXMagnitude, uint32_t startYMagnitude,
+                 Image & direction, uint32_t startXDirection, uint32_t startYDirection, uint32_t width, uint32_t height );
+
+    void SobelWithoutBorders( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & magnitude, uint32_t startXMagnitude,
+                              uint32_t startYMagnitude, Image * direction, uint32_t startXDirection, uint32_t startYDirection,
+                              uint32_t width, uint32_t height );
+
     void GetGaussianKernel( std::vector<float> & filter, uint32_t width, uint32_t height, uint32_t kernelSize, float sigma );
+    // One dimensional Gaussian kernel of (2 * kernelSize + 1) size. Outer product of 2 such kernels is equal to the kernel above
+    void GetGaussianKernel( std::vector<float> & filter, uint32_t kernelSize, float sigma );
 }
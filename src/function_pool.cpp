@@ -1,5 +1,7 @@
 #include "image_function_helper.h"
+#include "filtering.h"
 #include "function_pool.h"
+#include "image_function.h"
 #include "parameter_validation.h"
 #include "thread_pool.h"
 #include "penguinv/penguinv.h"
@@ -148,6 +150,14 @@ namespace Function_Pool
             , coefficientA        ( 1 )
             , coefficientGamma    ( 1 )
             , extractChannelId    ( 255 )
+            , kernelSize          ( 3 )
+            , shift               ( 0 )
+            , border              ( Image_Function::BORDER_REPLICATE )
+            , direction           ( nullptr )
+            , startXDirection     ( 0 )
+            , startYDirection     ( 0 )
+            , radiusX             ( 0 )
+            , radiusY             ( 0 )
         { }
 
         uint8_t minThreshold;      // for Threshold() function same as threshold
@@ -156,7 +166,19 @@ namespace Function_Pool
         double coefficientA;       // for GammaCorrection() function
         double coefficientGamma;   // for GammaCorrection() function
         uint8_t extractChannelId;  // for ExtractChannel() function
+        uint32_t kernelSize;       // for Median() function
         std::vector<uint8_t> lookupTable; // for LookupTable() function
+        std::vector<float> kernelX;       // for Convolve() function with float kernel
+        std::vector<float> kernelY;       // for Convolve() function with float kernel
+        std::vector<int16_t> kernelXFixed; // for Convolve() function with fixed-point kernel
+        std::vector<int16_t> kernelYFixed; // for Convolve() function with fixed-point kernel
+        uint8_t shift;                    // for Convolve() function with fixed-point kernel
+        Image_Function::BorderMode border; // for Convolve() function
+        Image * direction;                // for Prewitt() and Sobel() functions
+        uint32_t startXDirection;         // for Prewitt() and Sobel() functions
+        uint32_t startYDirection;         // for Prewitt() and Sobel() functions
+        uint32_t radiusX;                 // for morphology functions
+        uint32_t radiusY;                 // for morphology functions
     };
     // This structure holds output data for some specific functions
     struct OutputInfo
@@ -302,6 +324,12 @@ namespace Function_Pool
             _process( _BitwiseXor );
         }
 
+        void Closing( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                      uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+        {
+            _morphology( in, startXIn, startYIn, out, startXOut, startYOut, width, height, radiusX, radiusY, _Closing );
+        }
+
         void ConvertToGrayScale( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                                  uint32_t width, uint32_t height )
         {
@@ -316,6 +344,51 @@ namespace Function_Pool
             _process( _ConvertToRgb );
         }
 
+        void Convolve( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                       uint32_t width, uint32_t height, const std::vector < float > & kernelX, const std::vector < float > & kernelY,
+                       Image_Function::BorderMode border )
+        {
+            if( &in == &out )
+                throw imageException( "In-place convolution is not supported" );
+
+            _setup( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+
+            _dataIn.kernelX = kernelX;
+            _dataIn.kernelY = kernelY;
+            _dataIn.border  = border;
+
+            _process( _Convolve );
+        }
+
+        void Convolve( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                       uint32_t width, uint32_t height, const std::vector < int16_t > & kernelX, const std::vector < int16_t > & kernelY,
+                       uint8_t shift, Image_Function::BorderMode border )
+        {
+            if( &in == &out )
+                throw imageException( "In-place convolution is not supported" );
+
+            _setup( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+
+            _dataIn.kernelXFixed = kernelX;
+            _dataIn.kernelYFixed = kernelY;
+            _dataIn.shift        = shift;
+            _dataIn.border       = border;
+
+            _process( _ConvolveFixed );
+        }
+
+        void Dilate( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                     uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+        {
+            _morphology( in, startXIn, startYIn, out, startXOut, startYOut, width, height, radiusX, radiusY, _Dilate );
+        }
+
+        void Erode( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                    uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+        {
+            _morphology( in, startXIn, startYIn, out, startXOut, startYOut, width, height, radiusX, radiusY, _Erode );
+        }
+
         void  ExtractChannel( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut,
                               uint32_t startYOut, uint32_t width, uint32_t height, uint8_t channelId )
         {
@@ -382,6 +455,30 @@ namespace Function_Pool
             _process( _Maximum );
         }
 
+        void Median( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                     uint32_t width, uint32_t height, uint32_t kernelSize )
+        {
+            Image_Function::ParameterValidation( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+            Image_Function::VerifyGrayScaleImage( in, out );
+
+            if( kernelSize < 3 || kernelSize % 2 == 0 || kernelSize >= width || kernelSize >= height )
+                throw imageException( "Kernel size for filter is not correct" );
+
+            const uint32_t border = kernelSize / 2;
+
+            // Borders are copied without filtering like it is done in Image_Function::Median
+            penguinV::Copy( in, startXIn, startYIn, out, startXOut, startYOut, width, border );
+            penguinV::Copy( in, startXIn, startYIn + height - border, out, startXOut, startYOut + height - border, width, border );
+            penguinV::Copy( in, startXIn, startYIn + border, out, startXOut, startYOut + border, border, height - 2 * border );
+            penguinV::Copy( in, startXIn + width - border, startYIn + border, out, startXOut + width - border, startYOut + border,
+                            border, height - 2 * border );
+
+            // Inner area is split into bands and every task reads kernelSize / 2 pixels around its band
+            _setup( in, startXIn + border, startYIn + border, out, startXOut + border, startYOut + border, width - 2 * border, height - 2 * border );
+            _dataIn.kernelSize = kernelSize;
+            _process( _Median );
+        }
+
         void Minimum( const Image & in1, uint32_t startX1, uint32_t startY1, const Image & in2, uint32_t startX2, uint32_t startY2,
                       Image & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height )
         {
@@ -389,6 +486,20 @@ namespace Function_Pool
             _process( _Minimum );
         }
 
+        void Opening( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                      uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+        {
+            _morphology( in, startXIn, startYIn, out, startXOut, startYOut, width, height, radiusX, radiusY, _Opening );
+        }
+
+        void Prewitt( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & magnitude, uint32_t startXMagnitude,
+                      uint32_t startYMagnitude, Image * direction, uint32_t startXDirection, uint32_t startYDirection, uint32_t width,
+                      uint32_t height )
+        {
+            _gradient( in, startXIn, startYIn, magnitude, startXMagnitude, startYMagnitude, direction, startXDirection, startYDirection,
+                       width, height, _Prewitt );
+        }
+
         void ProjectionProfile( const Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height, bool horizontal,
                                 std::vector < uint32_t > & projection )
         {
@@ -415,6 +526,14 @@ namespace Function_Pool
             _process( _RgbToBgr );
         }
 
+        void Sobel( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & magnitude, uint32_t startXMagnitude,
+                    uint32_t startYMagnitude, Image * direction, uint32_t startXDirection, uint32_t startYDirection, uint32_t width,
+                    uint32_t height )
+        {
+            _gradient( in, startXIn, startYIn, magnitude, startXMagnitude, startYMagnitude, direction, startXDirection, startYDirection,
+                       width, height, _Sobel );
+        }
+
         void Subtract( const Image & in1, uint32_t startX1, uint32_t startY1, const Image & in2, uint32_t startX2, uint32_t startY2,
                        Image & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height )
         {
@@ -450,6 +569,12 @@ namespace Function_Pool
             _dataIn.maxThreshold = maxThreshold;
             _process( _ThresholdDouble );
         }
+
+        void TopHat( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                     uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+        {
+            _morphology( in, startXIn, startYIn, out, startXOut, startYOut, width, height, radiusX, radiusY, _TopHat );
+        }
     protected:
         enum TaskName // enumeration to define for thread which function need to execute
         {
@@ -458,8 +583,13 @@ namespace Function_Pool
             _BitwiseAnd,
             _BitwiseOr,
             _BitwiseXor,
+            _Closing,
             _ConvertToGrayScale,
             _ConvertToRgb,
+            _Convolve,
+            _ConvolveFixed,
+            _Dilate,
+            _Erode,
             _ExtractChannel,
             _GammaCorrection,
             _Histogram,
@@ -467,138 +597,215 @@ namespace Function_Pool
             _IsEqual,
             _LookupTable,
             _Maximum,
+            _Median,
             _Minimum,
+            _Opening,
+            _Prewitt,
             _ProjectionProfile,
             _Resize,
             _RgbToBgr,
+            _Sobel,
             _Subtract,
             _Sum,
             _Threshold,
-            _ThresholdDouble
+            _ThresholdDouble,
+            _TopHat
         };
 
         void _task( size_t taskId )
         {
+            // Functions are called from a single-threaded table as tasks are already executed in the thread pool
+            const penguinV::FunctionTable & table = penguinV::functionTable();
+
             switch( functionId ) {
                 case _none:
                     throw imageException( "Image function task is not setup" );
                 case _AbsoluteDifference:
-                    penguinV::AbsoluteDifference(
+                    table.AbsoluteDifference(
                         _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
                         _infoIn2->image, _infoIn2->startX[taskId], _infoIn2->startY[taskId],
                         _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
                         _infoIn1->width[taskId], _infoIn1->height[taskId] );
                     break;
                 case _BitwiseAnd:
-                    penguinV::BitwiseAnd( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
-                                          _infoIn2->image, _infoIn2->startX[taskId], _infoIn2->startY[taskId],
-                                          _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
-                                          _infoIn1->width[taskId], _infoIn1->height[taskId] );
+                    table.BitwiseAnd( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
+                                      _infoIn2->image, _infoIn2->startX[taskId], _infoIn2->startY[taskId],
+                                      _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
+                                      _infoIn1->width[taskId], _infoIn1->height[taskId] );
                     break;
                 case _BitwiseOr:
-                    penguinV::BitwiseOr( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
-                                         _infoIn2->image, _infoIn2->startX[taskId], _infoIn2->startY[taskId],
-                                         _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
-                                         _infoIn1->width[taskId], _infoIn1->height[taskId] );
+                    table.BitwiseOr( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
+                                     _infoIn2->image, _infoIn2->startX[taskId], _infoIn2->startY[taskId],
+                                     _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
+                                     _infoIn1->width[taskId], _infoIn1->height[taskId] );
                     break;
                 case _BitwiseXor:
-                    penguinV::BitwiseXor( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
-                                          _infoIn2->image, _infoIn2->startX[taskId], _infoIn2->startY[taskId],
-                                          _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
-                                          _infoIn1->width[taskId], _infoIn1->height[taskId] );
+                    table.BitwiseXor( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
+                                      _infoIn2->image, _infoIn2->startX[taskId], _infoIn2->startY[taskId],
+                                      _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
+                                      _infoIn1->width[taskId], _infoIn1->height[taskId] );
+                    break;
+                case _Closing:
+                    Image_Function::Closing( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
+                                             _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
+                                             _infoIn1->width[taskId], _infoIn1->height[taskId], _dataIn.radiusX, _dataIn.radiusY );
                     break;
                 case _ConvertToGrayScale:
-                    penguinV::ConvertToGrayScale( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
-                                                  _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
-                                                  _infoIn1->width[taskId], _infoIn1->height[taskId] );
+                    table.ConvertToGrayScale( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
+                                              _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
+                                              _infoIn1->width[taskId], _infoIn1->height[taskId] );
                     break;
                 case _ConvertToRgb:
-                    penguinV::ConvertToRgb( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
+                    table.ConvertToRgb( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
+                                        _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
+                                        _infoIn1->width[taskId], _infoIn1->height[taskId] );
+                    break;
+                case _Convolve:
+                    Image_Function::Convolve( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
+                                              _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
+                                              _infoIn1->width[taskId], _infoIn1->height[taskId], _dataIn.kernelX, _dataIn.kernelY,
+                                              _dataIn.border );
+                    break;
+                case _ConvolveFixed:
+                    Image_Function::Convolve( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
+                                              _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
+                                              _infoIn1->width[taskId], _infoIn1->height[taskId], _dataIn.kernelXFixed, _dataIn.kernelYFixed,
+                                              _dataIn.shift, _dataIn.border );
+                    break;
+                case _Dilate:
+                    Image_Function::Dilate( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
                                             _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
-                                            _infoIn1->width[taskId], _infoIn1->height[taskId] );
+                                            _infoIn1->width[taskId], _infoIn1->height[taskId], _dataIn.radiusX, _dataIn.radiusY );
+                    break;
+                case _Erode:
+                    Image_Function::Erode( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
+                                           _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
+                                           _infoIn1->width[taskId], _infoIn1->height[taskId], _dataIn.radiusX, _dataIn.radiusY );
                     break;
                 case _ExtractChannel:
-                    penguinV::ExtractChannel(
+                    table.ExtractChannel(
                         _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
                         _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
                         _infoIn1->width[taskId], _infoIn1->height[taskId], _dataIn.extractChannelId );
+                    break;
                 case _GammaCorrection:
-                    penguinV::GammaCorrection(
+                    table.GammaCorrection(
                         _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
                         _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
                         _infoIn1->width[taskId], _infoIn1->height[taskId], _dataIn.coefficientA,
                         _dataIn.coefficientGamma );
                     break;
                 case _Histogram:
-                    penguinV::Histogram( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
-                                         _infoIn1->width[taskId], _infoIn1->height[taskId], _dataOut.histogram[taskId] );
+                    table.Histogram( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
+                                     _infoIn1->width[taskId], _infoIn1->height[taskId], _dataOut.histogram[taskId] );
                     break;
                 case _Invert:
-                    penguinV::Invert( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
-                                      _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
-                                      _infoIn1->width[taskId], _infoIn1->height[taskId] );
+                    table.Invert( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
+                                  _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
+                                  _infoIn1->width[taskId], _infoIn1->height[taskId] );
                     break;
                 case _IsEqual:
-                    _dataOut.equality[taskId] = penguinV::IsEqual(
+                    _dataOut.equality[taskId] = table.IsEqual(
                         _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
                         _infoIn2->image, _infoIn2->startX[taskId], _infoIn2->startY[taskId],
                         _infoIn1->width[taskId], _infoIn1->height[taskId] );
                     break;
                 case _LookupTable:
-                    penguinV::LookupTable( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
-                                           _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
-                                           _infoIn1->width[taskId], _infoIn1->height[taskId], _dataIn.lookupTable );
+                    table.LookupTable( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
+                                       _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
+                                       _infoIn1->width[taskId], _infoIn1->height[taskId], _dataIn.lookupTable );
                     break;
                 case _Maximum:
-                    penguinV::Maximum( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
-                                       _infoIn2->image, _infoIn2->startX[taskId], _infoIn2->startY[taskId],
-                                       _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
-                                       _infoIn1->width[taskId], _infoIn1->height[taskId] );
+                    table.Maximum( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
+                                   _infoIn2->image, _infoIn2->startX[taskId], _infoIn2->startY[taskId],
+                                   _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
+                                   _infoIn1->width[taskId], _infoIn1->height[taskId] );
+                    break;
+                case _Median:
+                    {
+                        const uint32_t border = _dataIn.kernelSize / 2;
+
+                        Image_Function::MedianWithoutBorders(
+                            _infoIn1->image, _infoIn1->startX[taskId] - border, _infoIn1->startY[taskId] - border,
+                            _infoOut->image, _infoOut->startX[taskId] - border, _infoOut->startY[taskId] - border,
+                            _infoIn1->width[taskId] + 2 * border, _infoIn1->height[taskId] + 2 * border, _dataIn.kernelSize );
+                    }
                     break;
                 case _Minimum:
-                    penguinV::Minimum( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
-                                       _infoIn2->image, _infoIn2->startX[taskId], _infoIn2->startY[taskId],
-                                       _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
-                                       _infoIn1->width[taskId], _infoIn1->height[taskId] );
+                    table.Minimum( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
+                                   _infoIn2->image, _infoIn2->startX[taskId], _infoIn2->startY[taskId],
+                                   _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
+                                   _infoIn1->width[taskId], _infoIn1->height[taskId] );
+                    break;
+                case _Opening:
+                    Image_Function::Opening( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
+                                             _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
+                                             _infoIn1->width[taskId], _infoIn1->height[taskId], _dataIn.radiusX, _dataIn.radiusY );
+                    break;
+                case _Prewitt:
+                case _Sobel:
+                    {
+                        const uint32_t startXDirection = _dataIn.startXDirection + _infoOut->startX[taskId] - _infoOut->startX[0];
+                        const uint32_t startYDirection = _dataIn.startYDirection + _infoOut->startY[taskId] - _infoOut->startY[0];
+
+                        // every task reads 1 pixel around its band so the band is extended by 1 pixel in all directions
+                        if( functionId == _Prewitt )
+                            Image_Function::PrewittWithoutBorders(
+                                _infoIn1->image, _infoIn1->startX[taskId] - 1, _infoIn1->startY[taskId] - 1,
+                                _infoOut->image, _infoOut->startX[taskId] - 1, _infoOut->startY[taskId] - 1,
+                                _dataIn.direction, startXDirection - 1, startYDirection - 1,
+                                _infoIn1->width[taskId] + 2, _infoIn1->height[taskId] + 2 );
+                        else
+                            Image_Function::SobelWithoutBorders(
+                                _infoIn1->image, _infoIn1->startX[taskId] - 1, _infoIn1->startY[taskId] - 1,
+                                _infoOut->image, _infoOut->startX[taskId] - 1, _infoOut->startY[taskId] - 1,
+                                _dataIn.direction, startXDirection - 1, startYDirection - 1,
+                                _infoIn1->width[taskId] + 2, _infoIn1->height[taskId] + 2 );
+                    }
                     break;
                 case _ProjectionProfile:
-                    penguinV::ProjectionProfile(
+                    table.ProjectionProfile(
                         _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
                         _infoIn1->width[taskId], _infoIn1->height[taskId],
                         _dataIn.horizontalProjection, _dataOut.projection[taskId] );
                     break;
                 case _Resize:
-                    penguinV::Resize( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
-                                      _infoIn1->width[taskId], _infoIn1->height[taskId],
-                                      _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
-                                      _infoOut->width[taskId], _infoOut->height[taskId] );
+                    table.Resize( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
+                                  _infoIn1->width[taskId], _infoIn1->height[taskId],
+                                  _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
+                                  _infoOut->width[taskId], _infoOut->height[taskId] );
                     break;
                 case _RgbToBgr:
-                    penguinV::RgbToBgr( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
-                                        _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
-                                        _infoIn1->width[taskId], _infoIn1->height[taskId] );
+                    table.RgbToBgr( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
+                                    _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
+                                    _infoIn1->width[taskId], _infoIn1->height[taskId] );
                     break;
                 case _Subtract:
-                    penguinV::Subtract( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
-                                        _infoIn2->image, _infoIn2->startX[taskId], _infoIn2->startY[taskId],
-                                        _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
-                                        _infoIn1->width[taskId], _infoIn1->height[taskId] );
+                    table.Subtract( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
+                                    _infoIn2->image, _infoIn2->startX[taskId], _infoIn2->startY[taskId],
+                                    _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
+                                    _infoIn1->width[taskId], _infoIn1->height[taskId] );
                     break;
                 case _Sum:
-                    _dataOut.sum[taskId] = penguinV::Sum(
+                    _dataOut.sum[taskId] = table.Sum(
                         _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
                         _infoIn1->width[taskId], _infoIn1->height[taskId] );
                     break;
                 case _Threshold:
-                    penguinV::Threshold( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
-                                         _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
-                                         _infoIn1->width[taskId], _infoIn1->height[taskId], _dataIn.minThreshold );
+                    table.Threshold( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
+                                     _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
+                                     _infoIn1->width[taskId], _infoIn1->height[taskId], _dataIn.minThreshold );
                     break;
                 case _ThresholdDouble:
-                    penguinV::Threshold( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
-                                         _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
-                                         _infoIn1->width[taskId], _infoIn1->height[taskId], _dataIn.minThreshold,
-                                         _dataIn.maxThreshold );
+                    table.Threshold2( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
+                                      _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
+                                      _infoIn1->width[taskId], _infoIn1->height[taskId], _dataIn.minThreshold,
+                                      _dataIn.maxThreshold );
+                    break;
+                case _TopHat:
+                    Image_Function::TopHat( _infoIn1->image, _infoIn1->startX[taskId], _infoIn1->startY[taskId],
+                                            _infoOut->image, _infoOut->startX[taskId], _infoOut->startY[taskId],
+                                            _infoIn1->width[taskId], _infoIn1->height[taskId], _dataIn.radiusX, _dataIn.radiusY );
                     break;
                 default:
                     throw imageException( "Unknown image function task" );
@@ -677,6 +884,62 @@ namespace Function_Pool
             _infoOut = std::unique_ptr < OutputImageInfo >( new OutputImageInfo( out, startXOut, startYOut, width, height, threadCount() ) );
         }
 
+        // Inner part of the area is split into bands and every task reads 1 pixel around its band. Borders of the area are set to 0
+        void _gradient( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & magnitude, uint32_t startXMagnitude,
+                        uint32_t startYMagnitude, Image * direction, uint32_t startXDirection, uint32_t startYDirection, uint32_t width,
+                        uint32_t height, TaskName id )
+        {
+            Image_Function::ParameterValidation( in, startXIn, startYIn, magnitude, startXMagnitude, startYMagnitude, width, height );
+            Image_Function::VerifyGrayScaleImage( in, magnitude );
+
+            if( direction != nullptr ) {
+                Image_Function::ParameterValidation( in, startXIn, startYIn, *direction, startXDirection, startYDirection, width, height );
+                Image_Function::VerifyGrayScaleImage( *direction );
+            }
+
+            if( width < 3 || height < 3 )
+                throw imageException( "Input image is very small for gradient filter to be applied" );
+
+            if( &in == &magnitude || &in == direction )
+                throw imageException( "In-place gradient filtering is not supported" );
+
+            _setup( in, startXIn + 1, startYIn + 1, magnitude, startXMagnitude + 1, startYMagnitude + 1, width - 2, height - 2 );
+
+            _dataIn.direction       = direction;
+            _dataIn.startXDirection = startXDirection + 1;
+            _dataIn.startYDirection = startYDirection + 1;
+
+            _process( id );
+
+            _zeroBorders( magnitude, startXMagnitude, startYMagnitude, width, height );
+            if( direction != nullptr )
+                _zeroBorders( *direction, startXDirection, startYDirection, width, height );
+        }
+
+        // Every task reads pixels around its band within the image so the result does not depend on splitting
+        void _morphology( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                          uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY, TaskName id )
+        {
+            if( &in == &out )
+                throw imageException( "In-place morphology is not supported" );
+
+            _setup( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+            Image_Function::VerifyGrayScaleImage( in, out );
+
+            _dataIn.radiusX = radiusX;
+            _dataIn.radiusY = radiusY;
+
+            _process( id );
+        }
+
+        void _zeroBorders( Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height )
+        {
+            penguinV::Fill( image, x, y, width, 1, 0 );
+            penguinV::Fill( image, x, y + height - 1, width, 1, 0 );
+            penguinV::Fill( image, x, y + 1, 1, height - 2, 0 );
+            penguinV::Fill( image, x + width - 1, y + 1, 1, height - 2, 0 );
+        }
+
         void _process( TaskName id ) // function which calls global thread pool and waits results from it
         {
             functionId = id;
@@ -778,6 +1041,35 @@ namespace Function_Pool
         FunctionTask().BitwiseXor( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
     }
 
+    Image Closing( const Image & in, uint32_t radiusX, uint32_t radiusY )
+    {
+        return Closing( in, 0, 0, in.width(), in.height(), radiusX, radiusY );
+    }
+
+    void Closing( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function::ParameterValidation( in, out );
+
+        Closing( in, 0, 0, out, 0, 0, out.width(), out.height(), radiusX, radiusY );
+    }
+
+    Image Closing( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function::ParameterValidation( in, startXIn, startYIn, width, height );
+
+        Image out = in.generate( width, height );
+
+        Closing( in, startXIn, startYIn, out, 0, 0, width, height, radiusX, radiusY );
+
+        return out;
+    }
+
+    void Closing( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                  uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        FunctionTask().Closing( in, startXIn, startYIn, out, startXOut, startYOut, width, height, radiusX, radiusY );
+    }
+
     Image ConvertToGrayScale( const Image & in )
     {
         return Image_Function_Helper::ConvertToGrayScale( ConvertToGrayScale, in );
@@ -820,6 +1112,131 @@ namespace Function_Pool
         FunctionTask().ConvertToRgb( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
     }
 
+    Image Convolve( const Image & in, const std::vector < float > & kernelX, const std::vector < float > & kernelY,
+                    Image_Function::BorderMode border )
+    {
+        return Function_Pool::Convolve( in, 0, 0, in.width(), in.height(), kernelX, kernelY, border );
+    }
+
+    void Convolve( const Image & in, Image & out, const std::vector < float > & kernelX, const std::vector < float > & kernelY,
+                   Image_Function::BorderMode border )
+    {
+        Image_Function::ParameterValidation( in, out );
+
+        Function_Pool::Convolve( in, 0, 0, out, 0, 0, out.width(), out.height(), kernelX, kernelY, border );
+    }
+
+    Image Convolve( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height,
+                    const std::vector < float > & kernelX, const std::vector < float > & kernelY, Image_Function::BorderMode border )
+    {
+        Image_Function::ParameterValidation( in, startXIn, startYIn, width, height );
+
+        Image out = in.generate( width, height );
+
+        Function_Pool::Convolve( in, startXIn, startYIn, out, 0, 0, width, height, kernelX, kernelY, border );
+
+        return out;
+    }
+
+    void Convolve( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                   uint32_t width, uint32_t height, const std::vector < float > & kernelX, const std::vector < float > & kernelY,
+                   Image_Function::BorderMode border )
+    {
+        FunctionTask().Convolve( in, startXIn, startYIn, out, startXOut, startYOut, width, height, kernelX, kernelY, border );
+    }
+
+    Image Convolve( const Image & in, const std::vector < int16_t > & kernelX, const std::vector < int16_t > & kernelY, uint8_t shift,
+                    Image_Function::BorderMode border )
+    {
+        return Function_Pool::Convolve( in, 0, 0, in.width(), in.height(), kernelX, kernelY, shift, border );
+    }
+
+    void Convolve( const Image & in, Image & out, const std::vector < int16_t > & kernelX, const std::vector < int16_t > & kernelY,
+                   uint8_t shift, Image_Function::BorderMode border )
+    {
+        Image_Function::ParameterValidation( in, out );
+
+        Function_Pool::Convolve( in, 0, 0, out, 0, 0, out.width(), out.height(), kernelX, kernelY, shift, border );
+    }
+
+    Image Convolve( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height,
+                    const std::vector < int16_t > & kernelX, const std::vector < int16_t > & kernelY, uint8_t shift,
+                    Image_Function::BorderMode border )
+    {
+        Image_Function::ParameterValidation( in, startXIn, startYIn, width, height );
+
+        Image out = in.generate( width, height );
+
+        Function_Pool::Convolve( in, startXIn, startYIn, out, 0, 0, width, height, kernelX, kernelY, shift, border );
+
+        return out;
+    }
+
+    void Convolve( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                   uint32_t width, uint32_t height, const std::vector < int16_t > & kernelX, const std::vector < int16_t > & kernelY,
+                   uint8_t shift, Image_Function::BorderMode border )
+    {
+        FunctionTask().Convolve( in, startXIn, startYIn, out, startXOut, startYOut, width, height, kernelX, kernelY, shift, border );
+    }
+
+    Image Dilate( const Image & in, uint32_t radiusX, uint32_t radiusY )
+    {
+        return Dilate( in, 0, 0, in.width(), in.height(), radiusX, radiusY );
+    }
+
+    void Dilate( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function::ParameterValidation( in, out );
+
+        Dilate( in, 0, 0, out, 0, 0, out.width(), out.height(), radiusX, radiusY );
+    }
+
+    Image Dilate( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function::ParameterValidation( in, startXIn, startYIn, width, height );
+
+        Image out = in.generate( width, height );
+
+        Dilate( in, startXIn, startYIn, out, 0, 0, width, height, radiusX, radiusY );
+
+        return out;
+    }
+
+    void Dilate( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                 uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        FunctionTask().Dilate( in, startXIn, startYIn, out, startXOut, startYOut, width, height, radiusX, radiusY );
+    }
+
+    Image Erode( const Image & in, uint32_t radiusX, uint32_t radiusY )
+    {
+        return Erode( in, 0, 0, in.width(), in.height(), radiusX, radiusY );
+    }
+
+    void Erode( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function::ParameterValidation( in, out );
+
+        Erode( in, 0, 0, out, 0, 0, out.width(), out.height(), radiusX, radiusY );
+    }
+
+    Image Erode( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function::ParameterValidation( in, startXIn, startYIn, width, height );
+
+        Image out = in.generate( width, height );
+
+        Erode( in, startXIn, startYIn, out, 0, 0, width, height, radiusX, radiusY );
+
+        return out;
+    }
+
+    void Erode( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        FunctionTask().Erode( in, startXIn, startYIn, out, startXOut, startYOut, width, height, radiusX, radiusY );
+    }
+
     Image ExtractChannel( const Image & in, uint8_t channelId )
     {
         return Image_Function_Helper::ExtractChannel( ExtractChannel, in, channelId );
@@ -865,6 +1282,39 @@ namespace Function_Pool
         FunctionTask().GammaCorrection( in, startXIn, startYIn, out, startXOut, startYOut, width, height, a, gamma );
     }
 
+    Image GaussianBlur( const Image & in, uint32_t kernelSize, float sigma, Image_Function::BorderMode border )
+    {
+        return Function_Pool::GaussianBlur( in, 0, 0, in.width(), in.height(), kernelSize, sigma, border );
+    }
+
+    void GaussianBlur( const Image & in, Image & out, uint32_t kernelSize, float sigma, Image_Function::BorderMode border )
+    {
+        Image_Function::ParameterValidation( in, out );
+
+        Function_Pool::GaussianBlur( in, 0, 0, out, 0, 0, out.width(), out.height(), kernelSize, sigma, border );
+    }
+
+    Image GaussianBlur( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t kernelSize,
+                        float sigma, Image_Function::BorderMode border )
+    {
+        Image_Function::ParameterValidation( in, startXIn, startYIn, width, height );
+
+        Image out = in.generate( width, height );
+
+        Function_Pool::GaussianBlur( in, startXIn, startYIn, out, 0, 0, width, height, kernelSize, sigma, border );
+
+        return out;
+    }
+
+    void GaussianBlur( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                       uint32_t width, uint32_t height, uint32_t kernelSize, float sigma, Image_Function::BorderMode border )
+    {
+        std::vector < float > kernel;
+        Image_Function::GetGaussianKernel( kernel, kernelSize, sigma );
+
+        Function_Pool::Convolve( in, startXIn, startYIn, out, startXOut, startYOut, width, height, kernel, kernel, border );
+    }
+
     std::vector < uint32_t > Histogram( const Image & image )
     {
         return Image_Function_Helper::Histogram( Histogram, image );
@@ -963,6 +1413,35 @@ namespace Function_Pool
         FunctionTask().Maximum( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
     }
 
+    Image Median( const Image & in, uint32_t kernelSize )
+    {
+        return Median( in, 0, 0, in.width(), in.height(), kernelSize );
+    }
+
+    void Median( const Image & in, Image & out, uint32_t kernelSize )
+    {
+        Image_Function::ParameterValidation( in, out );
+
+        Median( in, 0, 0, out, 0, 0, out.width(), out.height(), kernelSize );
+    }
+
+    Image Median( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t kernelSize )
+    {
+        Image_Function::ParameterValidation( in, startXIn, startYIn, width, height );
+
+        Image out = in.generate( width, height );
+
+        Median( in, startXIn, startYIn, out, 0, 0, width, height, kernelSize );
+
+        return out;
+    }
+
+    void Median( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                 uint32_t width, uint32_t height, uint32_t kernelSize )
+    {
+        FunctionTask().Median( in, startXIn, startYIn, out, startXOut, startYOut, width, height, kernelSize );
+    }
+
     Image Minimum( const Image & in1, const Image & in2 )
     {
         return Image_Function_Helper::Minimum( Minimum, in1, in2 );
@@ -1020,18 +1499,85 @@ namespace Function_Pool
             penguinV::Copy( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
         }
         else {
-            const double correction = 255.0 / (maximum - minimum);
-
-            // We precalculate all values and store them in lookup table
-            std::vector < uint8_t > value( 256 );
-
-            for( uint16_t i = 0; i < 256; ++i )
-                value[i] = static_cast <uint8_t>((i - minimum) * correction + 0.5);
+            const std::vector < uint8_t > value = Image_Function_Helper::GetNormalizeLookupTable( static_cast<uint8_t>(minimum),
+                                                                                                  static_cast<uint8_t>(maximum) );
 
             FunctionTask().LookupTable( in, startXIn, startYIn, out, startXOut, startYOut, width, height, value );
         }
     }
 
+    Image Opening( const Image & in, uint32_t radiusX, uint32_t radiusY )
+    {
+        return Opening( in, 0, 0, in.width(), in.height(), radiusX, radiusY );
+    }
+
+    void Opening( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function::ParameterValidation( in, out );
+
+        Opening( in, 0, 0, out, 0, 0, out.width(), out.height(), radiusX, radiusY );
+    }
+
+    Image Opening( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function::ParameterValidation( in, startXIn, startYIn, width, height );
+
+        Image out = in.generate( width, height );
+
+        Opening( in, startXIn, startYIn, out, 0, 0, width, height, radiusX, radiusY );
+
+        return out;
+    }
+
+    void Opening( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                  uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        FunctionTask().Opening( in, startXIn, startYIn, out, startXOut, startYOut, width, height, radiusX, radiusY );
+    }
+
+    Image Prewitt( const Image & in )
+    {
+        return Function_Pool::Prewitt( in, 0, 0, in.width(), in.height() );
+    }
+
+    void Prewitt( const Image & in, Image & out )
+    {
+        Image_Function::ParameterValidation( in, out );
+
+        Function_Pool::Prewitt( in, 0, 0, out, 0, 0, out.width(), out.height() );
+    }
+
+    Image Prewitt( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height )
+    {
+        Image_Function::ParameterValidation( in, startXIn, startYIn, width, height );
+
+        Image out = in.generate( width, height );
+
+        Function_Pool::Prewitt( in, startXIn, startYIn, out, 0, 0, width, height );
+
+        return out;
+    }
+
+    void Prewitt( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                  uint32_t width, uint32_t height )
+    {
+        FunctionTask().Prewitt( in, startXIn, startYIn, out, startXOut, startYOut, nullptr, 0, 0, width, height );
+    }
+
+    void Prewitt( const Image & in, Image & magnitude, Image & direction )
+    {
+        Image_Function::ParameterValidation( in, magnitude, direction );
+
+        Function_Pool::Prewitt( in, 0, 0, magnitude, 0, 0, direction, 0, 0, in.width(), in.height() );
+    }
+
+    void Prewitt( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & magnitude, uint32_t startXMagnitude, uint32_t startYMagnitude,
+                  Image & direction, uint32_t startXDirection, uint32_t startYDirection, uint32_t width, uint32_t height )
+    {
+        FunctionTask().Prewitt( in, startXIn, startYIn, magnitude, startXMagnitude, startYMagnitude, &direction, startXDirection, startYDirection,
+                                width, height );
+    }
+
     std::vector < uint32_t > ProjectionProfile( const Image & image, bool horizontal )
     {
         return Image_Function_Helper::ProjectionProfile( ProjectionProfile, image, horizontal );
@@ -1099,6 +1645,49 @@ namespace Function_Pool
         FunctionTask().RgbToBgr( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
     }
 
+    Image Sobel( const Image & in )
+    {
+        return Function_Pool::Sobel( in, 0, 0, in.width(), in.height() );
+    }
+
+    void Sobel( const Image & in, Image & out )
+    {
+        Image_Function::ParameterValidation( in, out );
+
+        Function_Pool::Sobel( in, 0, 0, out, 0, 0, out.width(), out.height() );
+    }
+
+    Image Sobel( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height )
+    {
+        Image_Function::ParameterValidation( in, startXIn, startYIn, width, height );
+
+        Image out = in.generate( width, height );
+
+        Function_Pool::Sobel( in, startXIn, startYIn, out, 0, 0, width, height );
+
+        return out;
+    }
+
+    void Sobel( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                uint32_t width, uint32_t height )
+    {
+        FunctionTask().Sobel( in, startXIn, startYIn, out, startXOut, startYOut, nullptr, 0, 0, width, height );
+    }
+
+    void Sobel( const Image & in, Image & magnitude, Image & direction )
+    {
+        Image_Function::ParameterValidation( in, magnitude, direction );
+
+        Function_Pool::Sobel( in, 0, 0, magnitude, 0, 0, direction, 0, 0, in.width(), in.height() );
+    }
+
+    void Sobel( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & magnitude, uint32_t startXMagnitude, uint32_t startYMagnitude,
+                Image & direction, uint32_t startXDirection, uint32_t startYDirection, uint32_t width, uint32_t height )
+    {
+        FunctionTask().Sobel( in, startXIn, startYIn, magnitude, startXMagnitude, startYMagnitude, &direction, startXDirection, startYDirection,
+                              width, height );
+    }
+
     Image Subtract( const Image & in1, const Image & in2 )
     {
         return Image_Function_Helper::Subtract( Subtract, in1, in2 );
@@ -1173,4 +1762,141 @@ namespace Function_Pool
     {
         FunctionTask().Threshold( in, startXIn, startYIn, out, startXOut, startYOut, width, height, minThreshold, maxThreshold );
     }
+
+    Image TopHat( const Image & in, uint32_t radiusX, uint32_t radiusY )
+    {
+        return TopHat( in, 0, 0, in.width(), in.height(), radiusX, radiusY );
+    }
+
+    void TopHat( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function::ParameterValidation( in, out );
+
+        TopHat( in, 0, 0, out, 0, 0, out.width(), out.height(), radiusX, radiusY );
+    }
+
+    Image TopHat( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function::ParameterValidation( in, startXIn, startYIn, width, height );
+
+        Image out = in.generate( width, height );
+
+        TopHat( in, startXIn, startYIn, out, 0, 0, width, height, radiusX, radiusY );
+
+        return out;
+    }
+
+    void TopHat( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                 uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        FunctionTask().TopHat( in, startXIn, startYIn, out, startXOut, startYOut, width, height, radiusX, radiusY );
+    }
+
+    class BlobDetection::StripTask : public Thread_Pool::TaskProviderSingleton
+    {
+    public:
+        StripTask( const Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint8_t threshold )
+            : _image    ( image )
+            , _x        ( x )
+            , _width    ( width )
+            , _threshold( threshold )
+        {
+            const uint32_t count = std::min( threadCount(), height );
+
+            uint32_t remainValue = height % count;
+            uint32_t previousValue = y;
+
+            _startY.resize( count );
+            _height.resize( count );
+
+            for( size_t i = 0; i < count; ++i ) {
+                _height[i] = height / count;
+                if( remainValue > 0 ) {
+                    --remainValue;
+                    ++_height[i];
+                }
+                _startY[i] = previousValue;
+                previousValue = _startY[i] + _height[i];
+            }
+
+            _stripRun.resize( count );
+            _stripLabel.resize( count );
+        }
+
+        void find( std::vector < Blob_Detection::PointRun > & run, std::vector < uint32_t > & label )
+        {
+            _run( _startY.size() );
+
+            if( !_wait() ) {
+                throw imageException( "An exception raised during task execution in function pool" );
+            }
+
+            size_t runCount = 0;
+            for( size_t i = 0; i < _stripRun.size(); ++i )
+                runCount += _stripRun[i].size();
+
+            run.reserve( runCount );
+            label.reserve( runCount );
+
+            for( size_t i = 0; i < _stripRun.size(); ++i ) {
+                const size_t offset = run.size();
+
+                // runs of the last row of previous strip
+                size_t previousRowStart = offset;
+                for( ; (previousRowStart > 0) && (run[previousRowStart - 1].y + 1 == _startY[i]); --previousRowStart );
+
+                run.insert( run.end(), _stripRun[i].begin(), _stripRun[i].end() );
+
+                for( std::vector < uint32_t >::const_iterator id = _stripLabel[i].begin(); id != _stripLabel[i].end(); ++id )
+                    label.push_back( *id + static_cast<uint32_t>(offset) );
+
+                // runs of the first row of current strip
+                size_t currentRowEnd = offset;
+                for( ; (currentRowEnd < run.size()) && (run[currentRowEnd].y == _startY[i]); ++currentRowEnd );
+
+                _mergeRows( run, label, previousRowStart, offset, offset, currentRowEnd );
+            }
+        }
+    protected:
+        virtual void _task( size_t taskId )
+        {
+            _findRuns( _image, _x, _startY[taskId], _width, _height[taskId], _threshold, _stripRun[taskId], _stripLabel[taskId] );
+        }
+    private:
+        const Image & _image;
+        uint32_t _x;
+        uint32_t _width;
+        uint8_t _threshold;
+
+        std::vector < uint32_t > _startY;
+        std::vector < uint32_t > _height;
+
+        std::vector < std::vector < Blob_Detection::PointRun > > _stripRun;   // runs of each strip
+        std::vector < std::vector < uint32_t > >                 _stripLabel; // labels of runs within each strip
+    };
+
+    const std::vector < Blob_Detection::BlobInfo > & BlobDetection::find( const Image & image, Blob_Detection::BlobParameters parameter,
+                                                                          uint8_t threshold )
+    {
+        return find( image, 0, 0, image.width(), image.height(), parameter, threshold );
+    }
+
+    const std::vector < Blob_Detection::BlobInfo > & BlobDetection::find( const Image & image, uint32_t x, uint32_t y, uint32_t width,
+                                                                          uint32_t height, Blob_Detection::BlobParameters parameter,
+                                                                          uint8_t threshold )
+    {
+        Image_Function::ParameterValidation( image, x, y, width, height );
+        Image_Function::VerifyGrayScaleImage( image );
+
+        parameter._verify();
+
+        _blob.clear();
+
+        std::vector < Blob_Detection::PointRun > run;
+        std::vector < uint32_t > label;
+
+        StripTask( image, x, y, width, height, threshold ).find( run, label );
+
+        return _createBlobs( run, label, parameter );
+    }
 }
@@ -1,5 +1,7 @@
 #pragma once
 #include <vector>
+#include "blob_detection.h"
+#include "filtering.h"
 #include "image_buffer.h"
 
 namespace Function_Pool
@@ -38,6 +40,13 @@ namespace Function_Pool
     void  BitwiseXor( const Image & in1, uint32_t startX1, uint32_t startY1, const Image & in2, uint32_t startX2, uint32_t startY2,
                       Image & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height );
 
+    // Morphology filters give the same results as Image_Function ones. Every task reads pixels around its band
+    Image Closing( const Image & in, uint32_t radiusX, uint32_t radiusY );
+    void  Closing( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY );
+    Image Closing( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+    void  Closing( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                   uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
     Image ConvertToGrayScale( const Image & in );
     void  ConvertToGrayScale( const Image & in, Image & out );
     Image ConvertToGrayScale( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height );
@@ -50,6 +59,42 @@ namespace Function_Pool
     void  ConvertToRgb( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                         uint32_t width, uint32_t height );
 
+    // Separable convolution with a float kernel or a fixed-point kernel: output = (convolution result + rounding) >> shift
+    // In-place processing is not supported as every task reads pixels of neighbour tasks
+    Image Convolve( const Image & in, const std::vector < float > & kernelX, const std::vector < float > & kernelY,
+                    Image_Function::BorderMode border = Image_Function::BORDER_REPLICATE );
+    void  Convolve( const Image & in, Image & out, const std::vector < float > & kernelX, const std::vector < float > & kernelY,
+                    Image_Function::BorderMode border = Image_Function::BORDER_REPLICATE );
+    Image Convolve( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height,
+                    const std::vector < float > & kernelX, const std::vector < float > & kernelY,
+                    Image_Function::BorderMode border = Image_Function::BORDER_REPLICATE );
+    void  Convolve( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                    uint32_t width, uint32_t height, const std::vector < float > & kernelX, const std::vector < float > & kernelY,
+                    Image_Function::BorderMode border = Image_Function::BORDER_REPLICATE );
+
+    Image Convolve( const Image & in, const std::vector < int16_t > & kernelX, const std::vector < int16_t > & kernelY, uint8_t shift,
+                    Image_Function::BorderMode border = Image_Function::BORDER_REPLICATE );
+    void  Convolve( const Image & in, Image & out, const std::vector < int16_t > & kernelX, const std::vector < int16_t > & kernelY,
+                    uint8_t shift, Image_Function::BorderMode border = Image_Function::BORDER_REPLICATE );
+    Image Convolve( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height,
+                    const std::vector < int16_t > & kernelX, const std::vector < int16_t > & kernelY, uint8_t shift,
+                    Image_Function::BorderMode border = Image_Function::BORDER_REPLICATE );
+    void  Convolve( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                    uint32_t width, uint32_t height, const std::vector < int16_t > & kernelX, const std::vector < int16_t > & kernelY,
+                    uint8_t shift, Image_Function::BorderMode border = Image_Function::BORDER_REPLICATE );
+
+    Image Dilate( const Image & in, uint32_t radiusX, uint32_t radiusY );
+    void  Dilate( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY );
+    Image Dilate( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+    void  Dilate( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                  uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
+    Image Erode( const Image & in, uint32_t radiusX, uint32_t radiusY );
+    void  Erode( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY );
+    Image Erode( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+    void  Erode( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                 uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
     Image ExtractChannel( const Image & in, uint8_t channelId );
     void  ExtractChannel( const Image & in, Image & out, uint8_t channelId );
     Image ExtractChannel( const Image & in, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint8_t channelId );
@@ -65,6 +110,16 @@ namespace Function_Pool
     void  GammaCorrection( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                            uint32_t width, uint32_t height, double a, double gamma );
 
+    Image GaussianBlur( const Image & in, uint32_t kernelSize, float sigma,
+                        Image_Function::BorderMode border = Image_Function::BORDER_REPLICATE );
+    void  GaussianBlur( const Image & in, Image & out, uint32_t kernelSize, float sigma,
+                        Image_Function::BorderMode border = Image_Function::BORDER_REPLICATE );
+    Image GaussianBlur( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t kernelSize,
+                        float sigma, Image_Function::BorderMode border = Image_Function::BORDER_REPLICATE );
+    void  GaussianBlur( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                        uint32_t width, uint32_t height, uint32_t kernelSize, float sigma,
+                        Image_Function::BorderMode border = Image_Function::BORDER_REPLICATE );
+
     std::vector < uint32_t > Histogram( const Image & image );
     void                     Histogram( const Image & image, std::vector < uint32_t > & histogram );
     std::vector < uint32_t > Histogram( const Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height );
@@ -96,6 +151,12 @@ namespace Function_Pool
     void  Maximum( const Image & in1, uint32_t startX1, uint32_t startY1, const Image & in2, uint32_t startX2, uint32_t startY2,
                    Image & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height );
 
+    Image Median( const Image & in, uint32_t kernelSize );
+    void  Median( const Image & in, Image & out, uint32_t kernelSize );
+    Image Median( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t kernelSize );
+    void  Median( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                  uint32_t width, uint32_t height, uint32_t kernelSize );
+
     Image Minimum( const Image & in1, const Image & in2 );
     void  Minimum( const Image & in1, const Image & in2, Image & out );
     Image Minimum( const Image & in1, uint32_t startX1, uint32_t startY1, const Image & in2, uint32_t startX2, uint32_t startY2,
@@ -109,6 +170,24 @@ namespace Function_Pool
     void  Normalize( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                      uint32_t width, uint32_t height );
 
+    Image Opening( const Image & in, uint32_t radiusX, uint32_t radiusY );
+    void  Opening( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY );
+    Image Opening( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+    void  Opening( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                   uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
+    // This filter returns image based on gradient magnitude in both X and Y directions
+    Image Prewitt( const Image & in );
+    void  Prewitt( const Image & in, Image & out );
+    Image Prewitt( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height );
+    void  Prewitt( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                   uint32_t width, uint32_t height );
+
+    // Gradient magnitude and quantized gradient direction in one pass. Direction values are the same as for Image_Function::Prewitt
+    void  Prewitt( const Image & in, Image & magnitude, Image & direction );
+    void  Prewitt( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & magnitude, uint32_t startXMagnitude, uint32_t startYMagnitude,
+                   Image & direction, uint32_t startXDirection, uint32_t startYDirection, uint32_t width, uint32_t height );
+
     std::vector < uint32_t > ProjectionProfile( const Image & image, bool horizontal );
     void                     ProjectionProfile( const Image & image, bool horizontal, std::vector < uint32_t > & projection );
     std::vector < uint32_t > ProjectionProfile( const Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height, bool horizontal );
@@ -129,6 +208,18 @@ namespace Function_Pool
     void  RgbToBgr( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                     uint32_t width, uint32_t height );
 
+    // This filter returns image based on gradient magnitude in both X and Y directions
+    Image Sobel( const Image & in );
+    void  Sobel( const Image & in, Image & out );
+    Image Sobel( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height );
+    void  Sobel( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                 uint32_t width, uint32_t height );
+
+    // Gradient magnitude and quantized gradient direction in one pass. Direction values are the same as for Image_Function::Sobel
+    void  Sobel( const Image & in, Image & magnitude, Image & direction );
+    void  Sobel( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & magnitude, uint32_t startXMagnitude, uint32_t startYMagnitude,
+                 Image & direction, uint32_t startXDirection, uint32_t startYDirection, uint32_t width, uint32_t height );
+
     Image Subtract( const Image & in1, const Image & in2 );
     void  Subtract( const Image & in1, const Image & in2, Image & out );
     Image Subtract( const Image & in1, uint32_t startX1, uint32_t startY1, const Image & in2, uint32_t startX2, uint32_t startY2,
@@ -160,4 +251,25 @@ namespace Function_Pool
                      uint8_t maxThreshold );
     void  Threshold( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                      uint32_t width, uint32_t height, uint8_t minThreshold, uint8_t maxThreshold );
+
+    Image TopHat( const Image & in, uint32_t radiusX, uint32_t radiusY );
+    void  TopHat( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY );
+    Image TopHat( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+    void  TopHat( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                  uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
+    // Multithreaded run-length blob detection: horizontal strips of an image are labeled in parallel
+    // and labels are merged across borders of strips. Found blobs are the same as for Blob_Detection::BlobDetection class
+    class BlobDetection : public Blob_Detection::BlobDetection
+    {
+    public:
+        const std::vector < Blob_Detection::BlobInfo > & find( const Image & image,
+                                                               Blob_Detection::BlobParameters parameter = Blob_Detection::BlobParameters(),
+                                                               uint8_t threshold = 1 );
+        const std::vector < Blob_Detection::BlobInfo > & find( const Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                                                               Blob_Detection::BlobParameters parameter = Blob_Detection::BlobParameters(),
+                                                               uint8_t threshold = 1 );
+    private:
+        class StripTask;
+    };
 }
@@ -8,6 +8,12 @@
 
 namespace PenguinV_Image
 {
+    // Row alignments which allow to use aligned SIMD instructions for all rows of an image
+    // Images have alignment 1 by default (as well as output images of functions) so aligned code is used only for images
+    // created with one of these values
+    const static uint8_t SIMD_ALIGNMENT = 32u;       // AVX register size
+    const static uint8_t CACHE_LINE_ALIGNMENT = 64u; // every row starts at new cache line
+
     template <typename TColorDepth>
     class ImageTemplate
     {
@@ -21,6 +27,8 @@ namespace PenguinV_Image
             , _rowSize   ( 0 )       // size of single row on image, usually it is equal to width
             , _data      ( nullptr ) // an array what store image information (pixel data)
             , _type      ( 0 )       // special attribute to specify different types of images based on technology it is used for
+            , _isView    ( false )   // the image does not own data but refers to an area of another image (see image_view.h)
+            , _isAssigned( false )   // data was given by assign() function and it was not allocated by the image
         {
             _setType();
 
@@ -32,6 +40,8 @@ namespace PenguinV_Image
         ImageTemplate( const ImageTemplate & image )
             : _data      ( nullptr )
             , _type      ( image._type )
+            , _isView    ( false )
+            , _isAssigned( false )
         {
             copy( image );
         }
@@ -44,6 +54,8 @@ namespace PenguinV_Image
             , _rowSize   ( 0 )
             , _data      ( nullptr )
             , _type      ( 0 )
+            , _isView    ( false )
+            , _isAssigned( false )
         {
             swap( image );
         }
@@ -86,10 +98,15 @@ namespace PenguinV_Image
         void clear()
         {
             if( _data != nullptr ) {
-                _deallocate( _data );
+                if( _isAssigned )
+                    _deallocateAssigned( _data );
+                else if( !_isView )
+                    _deallocate( _data );
                 _data = nullptr;
             }
 
+            _isView     = false;
+            _isAssigned = false;
             _width   = 0;
             _height  = 0;
             _rowSize = 0;
@@ -105,6 +122,8 @@ namespace PenguinV_Image
             return _data;
         }
 
+        // the image takes ownership of data. For default image types the data must be allocated by new[] (of TColorDepth type),
+        // other types (for example, GPU images) expect the data to be allocated in the same way as the type allocates memory
         void assign( TColorDepth * data_, uint32_t width_, uint32_t height_, uint8_t colorCount_, uint8_t alignment_ )
         {
             if( data_ == nullptr || width_ == 0 || height_ == 0 || colorCount_ == 0 || alignment_ == 0 )
@@ -119,6 +138,7 @@ namespace PenguinV_Image
             _alignment = alignment_;
 
             _data = data_;
+            _isAssigned = true;
 
             _rowSize = width() * colorCount();
             if( _rowSize % alignment() != 0 )
@@ -176,7 +196,13 @@ namespace PenguinV_Image
             if( empty() )
                 return;
 
-            _set( data(), value, sizeof( TColorDepth ) * height() * rowSize() );
+            if( _isView ) { // rows of a view are not continuous and memory between them belongs to other areas of an image
+                for( uint32_t y = 0; y < height(); ++y )
+                    _set( data() + y * rowSize(), value, sizeof( TColorDepth ) * width() * colorCount() );
+            }
+            else {
+                _set( data(), value, sizeof( TColorDepth ) * height() * rowSize() );
+            }
         }
 
         void swap( ImageTemplate & image )
@@ -190,6 +216,9 @@ namespace PenguinV_Image
 
             std::swap( _data, image._data );
             std::swap( _type, image._type );
+
+            std::swap( _isView, image._isView );
+            std::swap( _isAssigned, image._isAssigned );
         }
 
         void copy( const ImageTemplate & image )
@@ -207,15 +236,27 @@ namespace PenguinV_Image
             _alignment  = image._alignment;
 
             if( image._data != nullptr ) {
-                _data = _allocate( _height * _rowSize );
+                if( image._isView ) { // a copy of a view is an ordinary image with own data
+                    _rowSize = _width * _colorCount;
+                    if( _rowSize % alignment() != 0 )
+                        _rowSize = (_rowSize / alignment() + 1) * alignment();
+
+                    _data = _allocate( _height * _rowSize );
 
-                _copy( _data, image._data, sizeof( TColorDepth ) * _height * _rowSize );
+                    for( uint32_t y = 0; y < _height; ++y )
+                        _copy( _data + y * _rowSize, image._data + y * image._rowSize, sizeof( TColorDepth ) * _width * _colorCount );
+                }
+                else {
+                    _data = _allocate( _height * _rowSize );
+
+                    _copy( _data, image._data, sizeof( TColorDepth ) * _height * _rowSize );
+                }
             }
         }
 
         bool mutate( uint32_t width_, uint32_t height_, uint8_t colorCount_, uint8_t alignment_ )
         {
-            if( colorCount_ > 0 && alignment_ > 0 )
+            if( colorCount_ > 0 && alignment_ > 0 && !_isView )
             {
                 uint32_t rowSize_ = width_ * colorCount_;
                 if( rowSize_ % alignment_ != 0 )
@@ -241,6 +282,11 @@ namespace PenguinV_Image
             return _type;
         }
 
+        bool isView() const
+        {
+            return _isView;
+        }
+
         ImageTemplate generate( uint32_t width_ = 0u, uint32_t height_ = 0u, uint8_t colorCount_ = 1u, uint8_t alignment_ = 1u ) const
         {
             ImageTemplate image;
@@ -265,6 +311,21 @@ namespace PenguinV_Image
             FunctionFacade::instance().initialize( _type, allocateFunction, deallocateFunction, copyFunction, setFunction );
         }
 
+        // makes the image a reference to memory of another image without taking ownership
+        void _setView( TColorDepth * data_, uint32_t width_, uint32_t height_, uint8_t colorCount_, uint32_t rowSize_, uint8_t type_ )
+        {
+            clear();
+
+            _width      = width_;
+            _height     = height_;
+            _colorCount = colorCount_;
+            _alignment  = 1u;
+            _rowSize    = rowSize_;
+            _data       = data_;
+            _type       = type_;
+            _isView     = true;
+        }
+
     private:
         TColorDepth * _allocate( size_t size ) const
         {
@@ -276,6 +337,17 @@ namespace PenguinV_Image
             FunctionFacade::instance().deallocate( _type )( data );
         }
 
+        // memory given by assign() function has no alignment offset in front of it so it is freed by delete[] for default types
+        void _deallocateAssigned( TColorDepth * data ) const
+        {
+            const DeallocateFunction deallocateFunction = FunctionFacade::instance().deallocate( _type );
+
+            if( deallocateFunction == _deallocateMemory )
+                delete[] data;
+            else
+                deallocateFunction( data );
+        }
+
         void _copy( TColorDepth * out, TColorDepth * in, size_t size ) const
         {
             FunctionFacade::instance().copy( _type )( out, in, size );
@@ -286,14 +358,23 @@ namespace PenguinV_Image
             FunctionFacade::instance().set( _type )( data, value, size );
         }
 
+        // Memory is aligned to a cache line (which is also enough for any SIMD instruction set) so if row size is a multiple
+        // of SIMD size too (alignment is SIMD_ALIGNMENT or CACHE_LINE_ALIGNMENT) every row can be processed by aligned instructions.
+        // An offset from really allocated memory is stored in a byte right before aligned data
         static TColorDepth * _allocateMemory( size_t size )
         {
-            return new TColorDepth[size];
+            uint8_t * memory = new uint8_t[size * sizeof( TColorDepth ) + CACHE_LINE_ALIGNMENT];
+
+            const uint8_t offset = static_cast<uint8_t>( CACHE_LINE_ALIGNMENT - reinterpret_cast<size_t>( memory ) % CACHE_LINE_ALIGNMENT );
+            memory[offset - 1u] = offset;
+
+            return reinterpret_cast<TColorDepth *>( memory + offset );
         }
 
         static void _deallocateMemory( TColorDepth * data )
         {
-            delete[] data;
+            uint8_t * memory = reinterpret_cast<uint8_t *>( data );
+            delete[] (memory - *(memory - 1));
         }
 
         static void _copyMemory( TColorDepth * out, TColorDepth * in, size_t size )
@@ -301,9 +382,13 @@ namespace PenguinV_Image
             memcpy( out, in, size );
         }
 
+        // size is in bytes. memset() can fill only types of 1 byte size by a value
         static void _setMemory( TColorDepth * data, TColorDepth value, size_t size )
         {
-            memset( data, static_cast<int>(value), size );
+            if( sizeof( TColorDepth ) == 1u )
+                memset( data, static_cast<int>(value), size );
+            else
+                std::fill_n( data, size / sizeof( TColorDepth ), value );
         }
 
         uint32_t _width;
@@ -317,6 +402,9 @@ namespace PenguinV_Image
 
         uint8_t  _type;
 
+        bool _isView;
+        bool _isAssigned;
+
         class FunctionFacade
         {
         public:
@@ -387,6 +475,8 @@ namespace PenguinV_Image
     };
 
     typedef ImageTemplate <uint8_t> Image;
+    typedef ImageTemplate <uint16_t> Image16Bit;
+    typedef ImageTemplate <float> ImageFloat;
 
     const static uint8_t GRAY_SCALE = 1u;
     const static uint8_t RGB = 3u;
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "image_buffer.h"
+#include "memory/cpu_memory.h"
+
+namespace PenguinV_Image
+{
+    // Image which memory is taken from global CPU memory allocator (Cpu_Memory::MemoryManager::memory())
+    // Reserve memory in the allocator at the startup of an application so images of frame size do not use the heap
+    // Images generated from this image (for example, outputs of Image_Function functions) have the same type
+    template <typename TColorDepth>
+    class ImageTemplatePool : public ImageTemplate<TColorDepth>
+    {
+    public:
+        ImageTemplatePool( uint32_t width_ = 0u, uint32_t height_ = 0u, uint8_t colorCount_ = 1u, uint8_t alignment_ = 1u )
+        {
+            ImageTemplate<TColorDepth>::_setType( 4, _allocateMemory, _deallocateMemory );
+            ImageTemplate<TColorDepth>::setColorCount( colorCount_ );
+            ImageTemplate<TColorDepth>::setAlignment( alignment_ );
+            ImageTemplate<TColorDepth>::resize( width_, height_ );
+        }
+
+        ImageTemplatePool( const ImageTemplatePool & image )
+            : ImageTemplate<TColorDepth>()
+        {
+            ImageTemplate<TColorDepth>::_setType( 4, _allocateMemory, _deallocateMemory );
+            ImageTemplate<TColorDepth>::operator=( image );
+        }
+
+        ImageTemplatePool( ImageTemplatePool && image )
+            : ImageTemplate<TColorDepth>()
+        {
+            ImageTemplate<TColorDepth>::_setType( 4, _allocateMemory, _deallocateMemory );
+            ImageTemplate<TColorDepth>::swap( image );
+        }
+
+        ImageTemplatePool & operator=( const ImageTemplatePool & image )
+        {
+            ImageTemplate<TColorDepth>::operator=( image );
+
+            return (*this);
+        }
+
+        ImageTemplatePool & operator=( ImageTemplatePool && image )
+        {
+            ImageTemplate<TColorDepth>::swap( image );
+
+            return (*this);
+        }
+    private:
+        static TColorDepth * _allocateMemory( size_t size )
+        {
+            return Cpu_Memory::MemoryManager::memory().allocate<TColorDepth>( size );
+        }
+
+        static void _deallocateMemory( TColorDepth * data )
+        {
+            Cpu_Memory::MemoryManager::memory().free( data );
+        }
+    };
+
+    typedef PenguinV_Image::ImageTemplatePool <uint8_t> ImagePool;
+}
@@ -1,119 +1,165 @@
 #include <cmath>
+#include <cstring>
+#include <limits>
 #include "image_function.h"
 #include "parameter_validation.h"
 #include "image_function_helper.h"
 
 namespace
 {
-    void Dilate( PenguinV_Image::Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t dilationX, uint32_t dilationY, uint8_t value )
+    // Morphology filters calculate maximum or minimum of whole rows by these functions
+    void MaximumRow( const uint8_t * in1, const uint8_t * in2, uint8_t * out, uint32_t width )
     {
-        Image_Function::ParameterValidation( image, x, y, width, height );
-        Image_Function::VerifyGrayScaleImage( image );
+        for( uint32_t x = 0; x < width; ++x )
+            out[x] = (in1[x] < in2[x]) ? in2[x] : in1[x];
+    }
 
-        if( dilationX == 0u && dilationY == 0u )
-            return;
+    void MinimumRow( const uint8_t * in1, const uint8_t * in2, uint8_t * out, uint32_t width )
+    {
+        for( uint32_t x = 0; x < width; ++x )
+            out[x] = (in1[x] < in2[x]) ? in1[x] : in2[x];
+    }
 
-        if( dilationX > width / 2 )
-            dilationX = width / 2;
-        if( dilationY > height / 2 )
-            dilationY = height / 2;
+    // Operations on pixel values of images with 16-bit and floating point pixels
+    struct AbsoluteDifferenceOperation
+    {
+        template <typename TColorDepth>
+        TColorDepth operator()( TColorDepth value1, TColorDepth value2 ) const
+        {
+            return (value2 > value1) ? static_cast<TColorDepth>(value2 - value1) : static_cast<TColorDepth>(value1 - value2);
+        }
+    };
 
-        if( dilationX > 0u ) {
-            const int32_t dilateX = static_cast<int32_t>(dilationX);
+    struct MaximumOperation
+    {
+        template <typename TColorDepth>
+        TColorDepth operator()( TColorDepth value1, TColorDepth value2 ) const
+        {
+            return (value1 > value2) ? value1 : value2;
+        }
+    };
 
-            uint8_t ** startPos = new uint8_t *[width];
-            uint8_t ** endPos   = new uint8_t *[width];
+    struct MinimumOperation
+    {
+        template <typename TColorDepth>
+        TColorDepth operator()( TColorDepth value1, TColorDepth value2 ) const
+        {
+            return (value1 < value2) ? value1 : value2;
+        }
+    };
 
-            const uint32_t rowSize = image.rowSize();
-            uint8_t * imageY    = image.data() + y * rowSize + x;
-            uint8_t * imageYEnd = imageY + height * rowSize;
+    struct SubtractOperation
+    {
+        uint16_t operator()( uint16_t value1, uint16_t value2 ) const
+        {
+            return (value1 > value2) ? static_cast<uint16_t>(value1 - value2) : 0u;
+        }
 
-            for( ; imageY != imageYEnd; imageY += rowSize ) {
-                uint32_t pairCount = 0u;
+        float operator()( float value1, float value2 ) const
+        {
+            return value1 - value2;
+        }
+    };
 
-                uint8_t previousValue = *imageY;
+    template <typename TColorDepth, typename TOperation>
+    void BinaryOperation( const PenguinV_Image::ImageTemplate < TColorDepth > & in1, uint32_t startX1, uint32_t startY1,
+                          const PenguinV_Image::ImageTemplate < TColorDepth > & in2, uint32_t startX2, uint32_t startY2,
+                          PenguinV_Image::ImageTemplate < TColorDepth > & out, uint32_t startXOut, uint32_t startYOut,
+                          uint32_t width, uint32_t height, TOperation operation )
+    {
+        Image_Function::ParameterValidation( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
 
-                uint8_t * imageXStart = imageY;
-                uint8_t * imageX      = imageXStart + 1;
-                uint8_t * imageXEnd   = imageXStart + width;
+        const uint8_t colorCount  = Image_Function::CommonColorCount( in1, in2, out );
+        const uint32_t rowSize1   = in1.rowSize();
+        const uint32_t rowSize2   = in2.rowSize();
+        const uint32_t rowSizeOut = out.rowSize();
 
-                for( ; imageX != imageXEnd; ++imageX ) {
-                    if( (*imageX) != previousValue ) {
-                        if( imageX - imageXStart < dilateX )
-                            startPos[pairCount] = imageXStart;
-                        else
-                            startPos[pairCount] = imageX - dilateX;
+        const TColorDepth * in1Y = in1.data() + startY1   * rowSize1   + startX1   * colorCount;
+        const TColorDepth * in2Y = in2.data() + startY2   * rowSize2   + startX2   * colorCount;
+        TColorDepth       * outY = out.data() + startYOut * rowSizeOut + startXOut * colorCount;
 
-                        if( imageXEnd - imageX < dilateX )
-                            endPos[pairCount] = imageXEnd;
-                        else
-                            endPos[pairCount] = imageX + dilateX;
+        const TColorDepth * outYEnd = outY + height * rowSizeOut;
 
-                        previousValue = 0xFFu ^ previousValue;
-                        ++pairCount;
-                    }
-                }
+        width = width * colorCount;
 
-                for( uint32_t i = 0u; i < pairCount; ++i ) {
-                    imageX    = startPos[i];
-                    imageXEnd = endPos[i];
+        for( ; outY != outYEnd; outY += rowSizeOut, in1Y += rowSize1, in2Y += rowSize2 ) {
+            const TColorDepth * in1X = in1Y;
+            const TColorDepth * in2X = in2Y;
+            TColorDepth       * outX = outY;
 
-                    for( ; imageX != imageXEnd; ++imageX )
-                        (*imageX) = value;
-                }
-            }
+            const TColorDepth * outXEnd = outX + width;
 
-            delete[] startPos;
-            delete[] endPos;
+            for( ; outX != outXEnd; ++outX, ++in1X, ++in2X )
+                (*outX) = operation( *in1X, *in2X );
         }
+    }
 
-        if( dilationY > 0u ) {
-            uint8_t ** startPos = new uint8_t *[height];
-            uint8_t ** endPos   = new uint8_t *[height];
+    template <typename TColorDepth>
+    void ResizeImage( const PenguinV_Image::ImageTemplate < TColorDepth > & in, uint32_t startXIn, uint32_t startYIn, uint32_t widthIn,
+                      uint32_t heightIn, PenguinV_Image::ImageTemplate < TColorDepth > & out, uint32_t startXOut, uint32_t startYOut,
+                      uint32_t widthOut, uint32_t heightOut )
+    {
+        Image_Function::ParameterValidation( in, startXIn, startYIn, widthIn, heightIn );
+        Image_Function::ParameterValidation( out, startXOut, startYOut, widthOut, heightOut );
+        Image_Function::VerifyGrayScaleImage( in, out );
 
-            const uint32_t rowSize = image.rowSize();
-            uint8_t * imageX    = image.data() + y * rowSize + x;
-            uint8_t * imageXEnd = imageX + width;
+        const uint32_t rowSizeIn  = in.rowSize();
+        const uint32_t rowSizeOut = out.rowSize();
 
-            for( ; imageX != imageXEnd; ++imageX ) {
-                uint32_t pairCount = 0u;
+        const TColorDepth * inY  = in.data()  + startYIn  * rowSizeIn  + startXIn;
+        TColorDepth       * outY = out.data() + startYOut * rowSizeOut + startXOut;
 
-                uint8_t previousValue = *imageX;
+        const TColorDepth * outYEnd = outY + heightOut * rowSizeOut;
 
-                uint8_t * imageYStart = imageX;
-                uint8_t * imageY      = imageYStart + rowSize;
-                uint8_t * imageYEnd   = imageYStart + height * rowSize;
+        uint32_t idY = 0;
 
-                for( ; imageY != imageYEnd; imageY += rowSize ) {
-                    if( (*imageY) != previousValue ) {
-                        const uint32_t rowId = static_cast<uint32_t>(imageY - imageYStart) / rowSize;
+        // Precalculation of X position
+        std::vector < uint32_t > positionX( widthOut );
+        for( uint32_t x = 0; x < widthOut; ++x )
+            positionX[x] = x * widthIn / widthOut;
 
-                        if( rowId < dilationY )
-                            startPos[pairCount] = imageYStart;
-                        else
-                            startPos[pairCount] = imageY - dilationY * rowSize;
+        for( ; outY != outYEnd; outY += rowSizeOut, ++idY ) {
+            const TColorDepth * inX  = inY + (idY * heightIn / heightOut) * rowSizeIn;
+            TColorDepth       * outX = outY;
 
-                        if( height - rowId < dilationY )
-                            endPos[pairCount] = imageYEnd;
-                        else
-                            endPos[pairCount] = imageY + dilationY * rowSize;
+            const TColorDepth * outXEnd = outX + widthOut;
 
-                        previousValue = 0xFFu ^ previousValue;
-                        ++pairCount;
-                    }
-                }
+            const uint32_t * idX = positionX.data();
 
-                for( uint32_t i = 0u; i < pairCount; ++i ) {
-                    imageY    = startPos[i];
-                    imageYEnd = endPos[i];
+            for( ; outX != outXEnd; ++outX, ++idX )
+                (*outX) = *(inX + (*idX));
+        }
+    }
 
-                    for( ; imageY != imageYEnd; imageY += rowSize )
-                        (*imageY) = value;
-                }
-            }
+    template <typename TColorDepth>
+    void ThresholdImage( const PenguinV_Image::ImageTemplate < TColorDepth > & in, uint32_t startXIn, uint32_t startYIn,
+                         PenguinV_Image::Image & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height,
+                         TColorDepth minThreshold, TColorDepth maxThreshold )
+    {
+        Image_Function::ParameterValidation( in, startXIn, startYIn, width, height );
+        Image_Function::ParameterValidation( out, startXOut, startYOut, width, height );
+        Image_Function::VerifyGrayScaleImage( in );
+        Image_Function::VerifyGrayScaleImage( out );
+
+        if( minThreshold > maxThreshold )
+            throw imageException( "Minimum threshold value is bigger than maximum threshold value" );
+
+        const uint32_t rowSizeIn  = in.rowSize();
+        const uint32_t rowSizeOut = out.rowSize();
+
+        const TColorDepth * inY  = in.data()  + startYIn  * rowSizeIn  + startXIn;
+        uint8_t           * outY = out.data() + startYOut * rowSizeOut + startXOut;
+
+        const uint8_t * outYEnd = outY + height * rowSizeOut;
+
+        for( ; outY != outYEnd; outY += rowSizeOut, inY += rowSizeIn ) {
+            const TColorDepth * inX  = inY;
+            uint8_t           * outX = outY;
 
-            delete[] startPos;
-            delete[] endPos;
+            const uint8_t * outXEnd = outX + width;
+
+            for( ; outX != outXEnd; ++outX, ++inX )
+                (*outX) = (*inX) < minThreshold || (*inX) > maxThreshold ? 0 : 255;
         }
     }
 }
@@ -198,6 +244,22 @@ namespace Image_Function
         }
     }
 
+    void BinaryClosing( Image & image, uint32_t radiusX, uint32_t radiusY )
+    {
+        ParameterValidation( image );
+
+        BinaryClosing( image, 0, 0, image.width(), image.height(), radiusX, radiusY );
+    }
+
+    void BinaryClosing( Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        ParameterValidation( image, x, y, width, height );
+        VerifyGrayScaleImage( image );
+
+        Image_Function_Helper::ClosingFilter( MaximumRow, MinimumRow, image, x, y, width, height, x, y, image, x, y, width, height,
+                                              radiusX, radiusY );
+    }
+
     void BinaryDilate( Image & image, uint32_t dilationX, uint32_t dilationY )
     {
         ParameterValidation( image );
@@ -207,7 +269,10 @@ namespace Image_Function
 
     void BinaryDilate( Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t dilationX, uint32_t dilationY )
     {
-        Dilate( image, x, y, width, height, dilationX, dilationY, 255u );
+        ParameterValidation( image, x, y, width, height );
+        VerifyGrayScaleImage( image );
+
+        Image_Function_Helper::DilateFilter( MaximumRow, image, x, y, width, height, x, y, image, x, y, width, height, dilationX, dilationY );
     }
 
     void BinaryErode( Image & image, uint32_t erosionX, uint32_t erosionY )
@@ -219,7 +284,42 @@ namespace Image_Function
 
     void BinaryErode( Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t erosionX, uint32_t erosionY )
     {
-        Dilate( image, x, y, width, height, erosionX, erosionY, 0u );
+        ParameterValidation( image, x, y, width, height );
+        VerifyGrayScaleImage( image );
+
+        Image_Function_Helper::ErodeFilter( MinimumRow, image, x, y, width, height, x, y, image, x, y, width, height, erosionX, erosionY );
+    }
+
+    void BinaryOpening( Image & image, uint32_t radiusX, uint32_t radiusY )
+    {
+        ParameterValidation( image );
+
+        BinaryOpening( image, 0, 0, image.width(), image.height(), radiusX, radiusY );
+    }
+
+    void BinaryOpening( Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        ParameterValidation( image, x, y, width, height );
+        VerifyGrayScaleImage( image );
+
+        Image_Function_Helper::OpeningFilter( MaximumRow, MinimumRow, image, x, y, width, height, x, y, image, x, y, width, height,
+                                              radiusX, radiusY );
+    }
+
+    void BinaryTopHat( Image & image, uint32_t radiusX, uint32_t radiusY )
+    {
+        ParameterValidation( image );
+
+        BinaryTopHat( image, 0, 0, image.width(), image.height(), radiusX, radiusY );
+    }
+
+    void BinaryTopHat( Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        ParameterValidation( image, x, y, width, height );
+        VerifyGrayScaleImage( image );
+
+        Image_Function_Helper::TopHatFilter( MaximumRow, MinimumRow, Subtract, image, x, y, width, height, x, y, image, x, y, width, height,
+                                             radiusX, radiusY );
     }
 
     Image BitwiseAnd( const Image & in1, const Image & in2 )
@@ -360,6 +460,45 @@ namespace Image_Function
         }
     }
 
+    Image Closing( const Image & in, uint32_t radiusX, uint32_t radiusY )
+    {
+        ParameterValidation( in );
+
+        Image out( in.width(), in.height() );
+
+        Closing( in, 0, 0, out, 0, 0, out.width(), out.height(), radiusX, radiusY );
+
+        return out;
+    }
+
+    void Closing( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY )
+    {
+        ParameterValidation( in, out );
+
+        Closing( in, 0, 0, out, 0, 0, out.width(), out.height(), radiusX, radiusY );
+    }
+
+    Image Closing( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        ParameterValidation( in, startXIn, startYIn, width, height );
+
+        Image out( width, height );
+
+        Closing( in, startXIn, startYIn, out, 0, 0, width, height, radiusX, radiusY );
+
+        return out;
+    }
+
+    void Closing( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                  uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        ParameterValidation( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+        VerifyGrayScaleImage( in, out );
+
+        Image_Function_Helper::ClosingFilter( MaximumRow, MinimumRow, in, 0, 0, in.width(), in.height(), startXIn, startYIn, out, startXOut,
+                                              startYOut, width, height, radiusX, radiusY );
+    }
+
     Image ConvertToGrayScale( const Image & in )
     {
         return Image_Function_Helper::ConvertToGrayScale( ConvertToGrayScale, in );
@@ -488,6 +627,84 @@ namespace Image_Function
             memcpy( outY, inY, sizeof( uint8_t ) * width );
     }
 
+    Image Dilate( const Image & in, uint32_t radiusX, uint32_t radiusY )
+    {
+        ParameterValidation( in );
+
+        Image out( in.width(), in.height() );
+
+        Dilate( in, 0, 0, out, 0, 0, out.width(), out.height(), radiusX, radiusY );
+
+        return out;
+    }
+
+    void Dilate( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY )
+    {
+        ParameterValidation( in, out );
+
+        Dilate( in, 0, 0, out, 0, 0, out.width(), out.height(), radiusX, radiusY );
+    }
+
+    Image Dilate( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        ParameterValidation( in, startXIn, startYIn, width, height );
+
+        Image out( width, height );
+
+        Dilate( in, startXIn, startYIn, out, 0, 0, width, height, radiusX, radiusY );
+
+        return out;
+    }
+
+    void Dilate( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                 uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        ParameterValidation( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+        VerifyGrayScaleImage( in, out );
+
+        Image_Function_Helper::DilateFilter( MaximumRow, in, 0, 0, in.width(), in.height(), startXIn, startYIn, out, startXOut,
+                                             startYOut, width, height, radiusX, radiusY );
+    }
+
+    Image Erode( const Image & in, uint32_t radiusX, uint32_t radiusY )
+    {
+        ParameterValidation( in );
+
+        Image out( in.width(), in.height() );
+
+        Erode( in, 0, 0, out, 0, 0, out.width(), out.height(), radiusX, radiusY );
+
+        return out;
+    }
+
+    void Erode( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY )
+    {
+        ParameterValidation( in, out );
+
+        Erode( in, 0, 0, out, 0, 0, out.width(), out.height(), radiusX, radiusY );
+    }
+
+    Image Erode( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        ParameterValidation( in, startXIn, startYIn, width, height );
+
+        Image out( width, height );
+
+        Erode( in, startXIn, startYIn, out, 0, 0, width, height, radiusX, radiusY );
+
+        return out;
+    }
+
+    void Erode( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        ParameterValidation( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+        VerifyGrayScaleImage( in, out );
+
+        Image_Function_Helper::ErodeFilter( MinimumRow, in, 0, 0, in.width(), in.height(), startXIn, startYIn, out, startXOut,
+                                            startYOut, width, height, radiusX, radiusY );
+    }
+
     Image ExtractChannel( const Image & in, uint8_t channelId )
     {
         return Image_Function_Helper::ExtractChannel( ExtractChannel, in, channelId );
@@ -639,18 +856,7 @@ namespace Image_Function
     {
         ParameterValidation( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
 
-        if( a < 0 || gamma < 0 )
-            throw imageException( "Gamma correction parameters are invalid" );
-
-        // We precalculate all values and store them in lookup table
-        std::vector < uint8_t > value( 256, 255u );
-
-        for( uint16_t i = 0; i < 256; ++i ) {
-            double data = a * pow( i / 255.0, gamma ) * 255 + 0.5;
-
-            if( data < 256 )
-                value[i] = static_cast<uint8_t>(data);
-        }
+        const std::vector < uint8_t > value = Image_Function_Helper::GetGammaCorrectionLookupTable( a, gamma );
 
         LookupTable( in, startXIn, startYIn, out, startXOut, startYOut, width, height, value );
     }
@@ -1055,18 +1261,51 @@ namespace Image_Function
             Copy( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
         }
         else {
-            const double correction = 255.0 / (maximum - minimum);
-
-            // We precalculate all values and store them in lookup table
-            std::vector < uint8_t > value( 256 );
-
-            for( uint16_t i = 0; i < 256; ++i )
-                value[i] = static_cast <uint8_t>((i - minimum) * correction + 0.5);
+            const std::vector < uint8_t > value = Image_Function_Helper::GetNormalizeLookupTable( minimum, maximum );
 
             LookupTable( in, startXIn, startYIn, out, startXOut, startYOut, width, height, value );
         }
     }
 
+    Image Opening( const Image & in, uint32_t radiusX, uint32_t radiusY )
+    {
+        ParameterValidation( in );
+
+        Image out( in.width(), in.height() );
+
+        Opening( in, 0, 0, out, 0, 0, out.width(), out.height(), radiusX, radiusY );
+
+        return out;
+    }
+
+    void Opening( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY )
+    {
+        ParameterValidation( in, out );
+
+        Opening( in, 0, 0, out, 0, 0, out.width(), out.height(), radiusX, radiusY );
+    }
+
+    Image Opening( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        ParameterValidation( in, startXIn, startYIn, width, height );
+
+        Image out( width, height );
+
+        Opening( in, startXIn, startYIn, out, 0, 0, width, height, radiusX, radiusY );
+
+        return out;
+    }
+
+    void Opening( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                  uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        ParameterValidation( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+        VerifyGrayScaleImage( in, out );
+
+        Image_Function_Helper::OpeningFilter( MaximumRow, MinimumRow, in, 0, 0, in.width(), in.height(), startXIn, startYIn, out, startXOut,
+                                              startYOut, width, height, radiusX, radiusY );
+    }
+
     std::vector < uint32_t > ProjectionProfile( const Image & image, bool horizontal )
     {
         return Image_Function_Helper::ProjectionProfile( ProjectionProfile, image, horizontal );
@@ -1520,6 +1759,45 @@ namespace Image_Function
         }
     }
 
+    Image TopHat( const Image & in, uint32_t radiusX, uint32_t radiusY )
+    {
+        ParameterValidation( in );
+
+        Image out( in.width(), in.height() );
+
+        TopHat( in, 0, 0, out, 0, 0, out.width(), out.height(), radiusX, radiusY );
+
+        return out;
+    }
+
+    void TopHat( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY )
+    {
+        ParameterValidation( in, out );
+
+        TopHat( in, 0, 0, out, 0, 0, out.width(), out.height(), radiusX, radiusY );
+    }
+
+    Image TopHat( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        ParameterValidation( in, startXIn, startYIn, width, height );
+
+        Image out( width, height );
+
+        TopHat( in, startXIn, startYIn, out, 0, 0, width, height, radiusX, radiusY );
+
+        return out;
+    }
+
+    void TopHat( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                 uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        ParameterValidation( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+        VerifyGrayScaleImage( in, out );
+
+        Image_Function_Helper::TopHatFilter( MaximumRow, MinimumRow, Subtract, in, 0, 0, in.width(), in.height(), startXIn, startYIn, out,
+                                             startXOut, startYOut, width, height, radiusX, radiusY );
+    }
+
     Image Transpose( const Image & in )
     {
         return Image_Function_Helper::Transpose( Transpose, in );
@@ -1560,4 +1838,347 @@ namespace Image_Function
                 (*outX) = *(inY);
         }
     }
+
+    Image16Bit AbsoluteDifference( const Image16Bit & in1, const Image16Bit & in2 )
+    {
+        return Image_Function_Helper::BinaryOperation( AbsoluteDifference, in1, in2 );
+    }
+
+    void AbsoluteDifference( const Image16Bit & in1, const Image16Bit & in2, Image16Bit & out )
+    {
+        Image_Function_Helper::BinaryOperation( AbsoluteDifference, in1, in2, out );
+    }
+
+    Image16Bit AbsoluteDifference( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                                   uint32_t width, uint32_t height )
+    {
+        return Image_Function_Helper::BinaryOperation( AbsoluteDifference, in1, startX1, startY1, in2, startX2, startY2, width, height );
+    }
+
+    void AbsoluteDifference( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                             Image16Bit & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height )
+    {
+        BinaryOperation( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height, AbsoluteDifferenceOperation() );
+    }
+
+    ImageFloat AbsoluteDifference( const ImageFloat & in1, const ImageFloat & in2 )
+    {
+        return Image_Function_Helper::BinaryOperation( AbsoluteDifference, in1, in2 );
+    }
+
+    void AbsoluteDifference( const ImageFloat & in1, const ImageFloat & in2, ImageFloat & out )
+    {
+        Image_Function_Helper::BinaryOperation( AbsoluteDifference, in1, in2, out );
+    }
+
+    ImageFloat AbsoluteDifference( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                                   uint32_t width, uint32_t height )
+    {
+        return Image_Function_Helper::BinaryOperation( AbsoluteDifference, in1, startX1, startY1, in2, startX2, startY2, width, height );
+    }
+
+    void AbsoluteDifference( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                             ImageFloat & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height )
+    {
+        BinaryOperation( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height, AbsoluteDifferenceOperation() );
+    }
+
+    std::vector < uint32_t > Histogram( const Image16Bit & image )
+    {
+        return Image_Function_Helper::Histogram( Histogram, image );
+    }
+
+    void Histogram( const Image16Bit & image, std::vector < uint32_t > & histogram )
+    {
+        Image_Function_Helper::Histogram( Histogram, image, histogram );
+    }
+
+    std::vector < uint32_t > Histogram( const Image16Bit & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height )
+    {
+        return Image_Function_Helper::Histogram( Histogram, image, x, y, width, height );
+    }
+
+    void Histogram( const Image16Bit & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height, std::vector < uint32_t > & histogram )
+    {
+        ParameterValidation( image, x, y, width, height );
+        VerifyGrayScaleImage( image );
+
+        histogram.resize( 65536u );
+        std::fill( histogram.begin(), histogram.end(), 0u );
+
+        const uint32_t rowSize = image.rowSize();
+
+        const uint16_t * imageY = image.data() + y * rowSize + x;
+        const uint16_t * imageYEnd = imageY + height * rowSize;
+
+        for( ; imageY != imageYEnd; imageY += rowSize ) {
+            const uint16_t * imageX    = imageY;
+            const uint16_t * imageXEnd = imageX + width;
+
+            for( ; imageX != imageXEnd; ++imageX )
+                ++histogram[*imageX];
+        }
+    }
+
+    Image16Bit Maximum( const Image16Bit & in1, const Image16Bit & in2 )
+    {
+        return Image_Function_Helper::BinaryOperation( Maximum, in1, in2 );
+    }
+
+    void Maximum( const Image16Bit & in1, const Image16Bit & in2, Image16Bit & out )
+    {
+        Image_Function_Helper::BinaryOperation( Maximum, in1, in2, out );
+    }
+
+    Image16Bit Maximum( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                        uint32_t width, uint32_t height )
+    {
+        return Image_Function_Helper::BinaryOperation( Maximum, in1, startX1, startY1, in2, startX2, startY2, width, height );
+    }
+
+    void Maximum( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                  Image16Bit & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height )
+    {
+        BinaryOperation( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height, MaximumOperation() );
+    }
+
+    ImageFloat Maximum( const ImageFloat & in1, const ImageFloat & in2 )
+    {
+        return Image_Function_Helper::BinaryOperation( Maximum, in1, in2 );
+    }
+
+    void Maximum( const ImageFloat & in1, const ImageFloat & in2, ImageFloat & out )
+    {
+        Image_Function_Helper::BinaryOperation( Maximum, in1, in2, out );
+    }
+
+    ImageFloat Maximum( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                        uint32_t width, uint32_t height )
+    {
+        return Image_Function_Helper::BinaryOperation( Maximum, in1, startX1, startY1, in2, startX2, startY2, width, height );
+    }
+
+    void Maximum( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                  ImageFloat & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height )
+    {
+        BinaryOperation( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height, MaximumOperation() );
+    }
+
+    Image16Bit Minimum( const Image16Bit & in1, const Image16Bit & in2 )
+    {
+        return Image_Function_Helper::BinaryOperation( Minimum, in1, in2 );
+    }
+
+    void Minimum( const Image16Bit & in1, const Image16Bit & in2, Image16Bit & out )
+    {
+        Image_Function_Helper::BinaryOperation( Minimum, in1, in2, out );
+    }
+
+    Image16Bit Minimum( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                        uint32_t width, uint32_t height )
+    {
+        return Image_Function_Helper::BinaryOperation( Minimum, in1, startX1, startY1, in2, startX2, startY2, width, height );
+    }
+
+    void Minimum( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                  Image16Bit & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height )
+    {
+        BinaryOperation( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height, MinimumOperation() );
+    }
+
+    ImageFloat Minimum( const ImageFloat & in1, const ImageFloat & in2 )
+    {
+        return Image_Function_Helper::BinaryOperation( Minimum, in1, in2 );
+    }
+
+    void Minimum( const ImageFloat & in1, const ImageFloat & in2, ImageFloat & out )
+    {
+        Image_Function_Helper::BinaryOperation( Minimum, in1, in2, out );
+    }
+
+    ImageFloat Minimum( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                        uint32_t width, uint32_t height )
+    {
+        return Image_Function_Helper::BinaryOperation( Minimum, in1, startX1, startY1, in2, startX2, startY2, width, height );
+    }
+
+    void Minimum( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                  ImageFloat & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height )
+    {
+        BinaryOperation( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height, MinimumOperation() );
+    }
+
+    Image16Bit Resize( const Image16Bit & in, uint32_t widthOut, uint32_t heightOut )
+    {
+        return Image_Function_Helper::Resize( Resize, in, widthOut, heightOut );
+    }
+
+    void Resize( const Image16Bit & in, Image16Bit & out )
+    {
+        Image_Function_Helper::Resize( Resize, in, out );
+    }
+
+    Image16Bit Resize( const Image16Bit & in, uint32_t startXIn, uint32_t startYIn, uint32_t widthIn, uint32_t heightIn,
+                       uint32_t widthOut, uint32_t heightOut )
+    {
+        return Image_Function_Helper::Resize( Resize, in, startXIn, startYIn, widthIn, heightIn, widthOut, heightOut );
+    }
+
+    void Resize( const Image16Bit & in, uint32_t startXIn, uint32_t startYIn, uint32_t widthIn, uint32_t heightIn,
+                 Image16Bit & out, uint32_t startXOut, uint32_t startYOut, uint32_t widthOut, uint32_t heightOut )
+    {
+        ResizeImage( in, startXIn, startYIn, widthIn, heightIn, out, startXOut, startYOut, widthOut, heightOut );
+    }
+
+    ImageFloat Resize( const ImageFloat & in, uint32_t widthOut, uint32_t heightOut )
+    {
+        return Image_Function_Helper::Resize( Resize, in, widthOut, heightOut );
+    }
+
+    void Resize( const ImageFloat & in, ImageFloat & out )
+    {
+        Image_Function_Helper::Resize( Resize, in, out );
+    }
+
+    ImageFloat Resize( const ImageFloat & in, uint32_t startXIn, uint32_t startYIn, uint32_t widthIn, uint32_t heightIn,
+                       uint32_t widthOut, uint32_t heightOut )
+    {
+        return Image_Function_Helper::Resize( Resize, in, startXIn, startYIn, widthIn, heightIn, widthOut, heightOut );
+    }
+
+    void Resize( const ImageFloat & in, uint32_t startXIn, uint32_t startYIn, uint32_t widthIn, uint32_t heightIn,
+                 ImageFloat & out, uint32_t startXOut, uint32_t startYOut, uint32_t widthOut, uint32_t heightOut )
+    {
+        ResizeImage( in, startXIn, startYIn, widthIn, heightIn, out, startXOut, startYOut, widthOut, heightOut );
+    }
+
+    Image16Bit Subtract( const Image16Bit & in1, const Image16Bit & in2 )
+    {
+        return Image_Function_Helper::BinaryOperation( Subtract, in1, in2 );
+    }
+
+    void Subtract( const Image16Bit & in1, const Image16Bit & in2, Image16Bit & out )
+    {
+        Image_Function_Helper::BinaryOperation( Subtract, in1, in2, out );
+    }
+
+    Image16Bit Subtract( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                         uint32_t width, uint32_t height )
+    {
+        return Image_Function_Helper::BinaryOperation( Subtract, in1, startX1, startY1, in2, startX2, startY2, width, height );
+    }
+
+    void Subtract( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                   Image16Bit & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height )
+    {
+        BinaryOperation( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height, SubtractOperation() );
+    }
+
+    ImageFloat Subtract( const ImageFloat & in1, const ImageFloat & in2 )
+    {
+        return Image_Function_Helper::BinaryOperation( Subtract, in1, in2 );
+    }
+
+    void Subtract( const ImageFloat & in1, const ImageFloat & in2, ImageFloat & out )
+    {
+        Image_Function_Helper::BinaryOperation( Subtract, in1, in2, out );
+    }
+
+    ImageFloat Subtract( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                         uint32_t width, uint32_t height )
+    {
+        return Image_Function_Helper::BinaryOperation( Subtract, in1, startX1, startY1, in2, startX2, startY2, width, height );
+    }
+
+    void Subtract( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                   ImageFloat & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height )
+    {
+        BinaryOperation( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height, SubtractOperation() );
+    }
+
+    Image Threshold( const Image16Bit & in, uint16_t threshold )
+    {
+        return Image_Function_Helper::Threshold( Threshold, in, threshold );
+    }
+
+    void Threshold( const Image16Bit & in, Image & out, uint16_t threshold )
+    {
+        Image_Function_Helper::Threshold( Threshold, in, out, threshold );
+    }
+
+    Image Threshold( const Image16Bit & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint16_t threshold )
+    {
+        return Image_Function_Helper::Threshold( Threshold, in, startXIn, startYIn, width, height, threshold );
+    }
+
+    void Threshold( const Image16Bit & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                    uint32_t width, uint32_t height, uint16_t threshold )
+    {
+        ThresholdImage( in, startXIn, startYIn, out, startXOut, startYOut, width, height, threshold, static_cast<uint16_t>(65535u) );
+    }
+
+    Image Threshold( const ImageFloat & in, float threshold )
+    {
+        return Image_Function_Helper::Threshold( Threshold, in, threshold );
+    }
+
+    void Threshold( const ImageFloat & in, Image & out, float threshold )
+    {
+        Image_Function_Helper::Threshold( Threshold, in, out, threshold );
+    }
+
+    Image Threshold( const ImageFloat & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, float threshold )
+    {
+        return Image_Function_Helper::Threshold( Threshold, in, startXIn, startYIn, width, height, threshold );
+    }
+
+    void Threshold( const ImageFloat & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                    uint32_t width, uint32_t height, float threshold )
+    {
+        ThresholdImage( in, startXIn, startYIn, out, startXOut, startYOut, width, height, threshold, std::numeric_limits<float>::infinity() );
+    }
+
+    Image Threshold( const Image16Bit & in, uint16_t minThreshold, uint16_t maxThreshold )
+    {
+        return Image_Function_Helper::Threshold( Threshold, in, minThreshold, maxThreshold );
+    }
+
+    void Threshold( const Image16Bit & in, Image & out, uint16_t minThreshold, uint16_t maxThreshold )
+    {
+        Image_Function_Helper::Threshold( Threshold, in, out, minThreshold, maxThreshold );
+    }
+
+    Image Threshold( const Image16Bit & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint16_t minThreshold,
+                     uint16_t maxThreshold )
+    {
+        return Image_Function_Helper::Threshold( Threshold, in, startXIn, startYIn, width, height, minThreshold, maxThreshold );
+    }
+
+    void Threshold( const Image16Bit & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                    uint32_t width, uint32_t height, uint16_t minThreshold, uint16_t maxThreshold )
+    {
+        ThresholdImage( in, startXIn, startYIn, out, startXOut, startYOut, width, height, minThreshold, maxThreshold );
+    }
+
+    Image Threshold( const ImageFloat & in, float minThreshold, float maxThreshold )
+    {
+        return Image_Function_Helper::Threshold( Threshold, in, minThreshold, maxThreshold );
+    }
+
+    void Threshold( const ImageFloat & in, Image & out, float minThreshold, float maxThreshold )
+    {
+        Image_Function_Helper::Threshold( Threshold, in, out, minThreshold, maxThreshold );
+    }
+
+    Image Threshold( const ImageFloat & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, float minThreshold,
+                     float maxThreshold )
+    {
+        return Image_Function_Helper::Threshold( Threshold, in, startXIn, startYIn, width, height, minThreshold, maxThreshold );
+    }
+
+    void Threshold( const ImageFloat & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                    uint32_t width, uint32_t height, float minThreshold, float maxThreshold )
+    {
+        ThresholdImage( in, startXIn, startYIn, out, startXOut, startYOut, width, height, minThreshold, maxThreshold );
+    }
 }
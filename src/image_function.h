@@ -17,12 +17,23 @@ namespace Image_Function
     void Accumulate( const Image & image, std::vector < uint32_t > & result );
     void Accumulate( const Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height, std::vector < uint32_t > & result );
 
+    // Binary morphology is done in place and uses only pixels of the area: window of filters is (2 * radius + 1) pixels
+    // along each axis. Top hat keeps pixels which are removed by opening
+    void BinaryClosing( Image & image, uint32_t radiusX, uint32_t radiusY );
+    void BinaryClosing( Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
     void BinaryDilate( Image & image, uint32_t dilationX, uint32_t dilationY );
     void BinaryDilate( Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t dilationX, uint32_t dilationY );
 
     void BinaryErode( Image & image, uint32_t erosionX, uint32_t erosionY );
     void BinaryErode( Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t erosionX, uint32_t erosionY );
 
+    void BinaryOpening( Image & image, uint32_t radiusX, uint32_t radiusY );
+    void BinaryOpening( Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
+    void BinaryTopHat( Image & image, uint32_t radiusX, uint32_t radiusY );
+    void BinaryTopHat( Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
     Image BitwiseAnd( const Image & in1, const Image & in2 );
     void  BitwiseAnd( const Image & in1, const Image & in2, Image & out );
     Image BitwiseAnd( const Image & in1, uint32_t startX1, uint32_t startY1, const Image & in2, uint32_t startX2, uint32_t startY2,
@@ -44,6 +55,15 @@ namespace Image_Function
     void  BitwiseXor( const Image & in1, uint32_t startX1, uint32_t startY1, const Image & in2, uint32_t startX2, uint32_t startY2,
                       Image & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height );
 
+    // Grayscale morphology with a rectangular window of (2 * radiusX + 1) x (2 * radiusY + 1) pixels: dilation is a maximum
+    // and erosion is a minimum within the window. Pixels around the area are used if they are inside of the image
+    // Top hat is a difference between the image and its opening
+    Image Closing( const Image & in, uint32_t radiusX, uint32_t radiusY );
+    void  Closing( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY );
+    Image Closing( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+    void  Closing( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                   uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
     Image ConvertToGrayScale( const Image & in );
     void  ConvertToGrayScale( const Image & in, Image & out );
     Image ConvertToGrayScale( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height );
@@ -61,6 +81,18 @@ namespace Image_Function
     void  Copy( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                 uint32_t width, uint32_t height );
 
+    Image Dilate( const Image & in, uint32_t radiusX, uint32_t radiusY );
+    void  Dilate( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY );
+    Image Dilate( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+    void  Dilate( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                  uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
+    Image Erode( const Image & in, uint32_t radiusX, uint32_t radiusY );
+    void  Erode( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY );
+    Image Erode( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+    void  Erode( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                 uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
     Image ExtractChannel( const Image & in, uint8_t channelId );
     void  ExtractChannel( const Image & in, Image & out, uint8_t channelId );
     Image ExtractChannel( const Image & in, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint8_t channelId );
@@ -148,6 +180,12 @@ namespace Image_Function
     void  Normalize( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                      uint32_t width, uint32_t height );
 
+    Image Opening( const Image & in, uint32_t radiusX, uint32_t radiusY );
+    void  Opening( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY );
+    Image Opening( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+    void  Opening( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                   uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
     std::vector < uint32_t > ProjectionProfile( const Image & image, bool horizontal );
     void                     ProjectionProfile( const Image & image, bool horizontal, std::vector < uint32_t > & projection );
     std::vector < uint32_t > ProjectionProfile( const Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height, bool horizontal );
@@ -210,6 +248,12 @@ namespace Image_Function
     void  Threshold( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                      uint32_t width, uint32_t height, uint8_t minThreshold, uint8_t maxThreshold );
 
+    Image TopHat( const Image & in, uint32_t radiusX, uint32_t radiusY );
+    void  TopHat( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY );
+    Image TopHat( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+    void  TopHat( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                  uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
     // Swap columns and rows in input image. It is equivalent to 90 degree rotation
     // Output image (area) must be [height, width] compare to original [width, height]
     Image Transpose( const Image & in );
@@ -217,4 +261,111 @@ namespace Image_Function
     Image Transpose( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height );
     void  Transpose( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                      uint32_t width, uint32_t height );
+
+    // Functions below process images with 16-bit and floating point pixels. They work in the same way as functions for 8-bit images
+    // but pixel values are not limited by 255. Subtraction of 16-bit images is saturated at 0 while subtraction of floating point
+    // images is not limited at all
+    Image16Bit AbsoluteDifference( const Image16Bit & in1, const Image16Bit & in2 );
+    void       AbsoluteDifference( const Image16Bit & in1, const Image16Bit & in2, Image16Bit & out );
+    Image16Bit AbsoluteDifference( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                                   uint32_t width, uint32_t height );
+    void       AbsoluteDifference( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                                   Image16Bit & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height );
+
+    ImageFloat AbsoluteDifference( const ImageFloat & in1, const ImageFloat & in2 );
+    void       AbsoluteDifference( const ImageFloat & in1, const ImageFloat & in2, ImageFloat & out );
+    ImageFloat AbsoluteDifference( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                                   uint32_t width, uint32_t height );
+    void       AbsoluteDifference( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                                   ImageFloat & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height );
+
+    // Histogram of 16-bit image contains 65536 values
+    std::vector < uint32_t > Histogram( const Image16Bit & image );
+    void                     Histogram( const Image16Bit & image, std::vector < uint32_t > & histogram );
+    std::vector < uint32_t > Histogram( const Image16Bit & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height );
+    void                     Histogram( const Image16Bit & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                                        std::vector < uint32_t > & histogram );
+
+    Image16Bit Maximum( const Image16Bit & in1, const Image16Bit & in2 );
+    void       Maximum( const Image16Bit & in1, const Image16Bit & in2, Image16Bit & out );
+    Image16Bit Maximum( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                        uint32_t width, uint32_t height );
+    void       Maximum( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                        Image16Bit & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height );
+
+    ImageFloat Maximum( const ImageFloat & in1, const ImageFloat & in2 );
+    void       Maximum( const ImageFloat & in1, const ImageFloat & in2, ImageFloat & out );
+    ImageFloat Maximum( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                        uint32_t width, uint32_t height );
+    void       Maximum( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                        ImageFloat & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height );
+
+    Image16Bit Minimum( const Image16Bit & in1, const Image16Bit & in2 );
+    void       Minimum( const Image16Bit & in1, const Image16Bit & in2, Image16Bit & out );
+    Image16Bit Minimum( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                        uint32_t width, uint32_t height );
+    void       Minimum( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                        Image16Bit & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height );
+
+    ImageFloat Minimum( const ImageFloat & in1, const ImageFloat & in2 );
+    void       Minimum( const ImageFloat & in1, const ImageFloat & in2, ImageFloat & out );
+    ImageFloat Minimum( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                        uint32_t width, uint32_t height );
+    void       Minimum( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                        ImageFloat & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height );
+
+    Image16Bit Resize( const Image16Bit & in, uint32_t widthOut, uint32_t heightOut );
+    void       Resize( const Image16Bit & in, Image16Bit & out );
+    Image16Bit Resize( const Image16Bit & in, uint32_t startXIn, uint32_t startYIn, uint32_t widthIn, uint32_t heightIn,
+                       uint32_t widthOut, uint32_t heightOut );
+    void       Resize( const Image16Bit & in, uint32_t startXIn, uint32_t startYIn, uint32_t widthIn, uint32_t heightIn,
+                       Image16Bit & out, uint32_t startXOut, uint32_t startYOut, uint32_t widthOut, uint32_t heightOut );
+
+    ImageFloat Resize( const ImageFloat & in, uint32_t widthOut, uint32_t heightOut );
+    void       Resize( const ImageFloat & in, ImageFloat & out );
+    ImageFloat Resize( const ImageFloat & in, uint32_t startXIn, uint32_t startYIn, uint32_t widthIn, uint32_t heightIn,
+                       uint32_t widthOut, uint32_t heightOut );
+    void       Resize( const ImageFloat & in, uint32_t startXIn, uint32_t startYIn, uint32_t widthIn, uint32_t heightIn,
+                       ImageFloat & out, uint32_t startXOut, uint32_t startYOut, uint32_t widthOut, uint32_t heightOut );
+
+    Image16Bit Subtract( const Image16Bit & in1, const Image16Bit & in2 );
+    void       Subtract( const Image16Bit & in1, const Image16Bit & in2, Image16Bit & out );
+    Image16Bit Subtract( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                         uint32_t width, uint32_t height );
+    void       Subtract( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                         Image16Bit & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height );
+
+    ImageFloat Subtract( const ImageFloat & in1, const ImageFloat & in2 );
+    void       Subtract( const ImageFloat & in1, const ImageFloat & in2, ImageFloat & out );
+    ImageFloat Subtract( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                         uint32_t width, uint32_t height );
+    void       Subtract( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                         ImageFloat & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height );
+
+    // Thresholding of 16-bit and floating point images works in the same way as for 8-bit images. Output image is always 8-bit
+    Image Threshold( const Image16Bit & in, uint16_t threshold );
+    void  Threshold( const Image16Bit & in, Image & out, uint16_t threshold );
+    Image Threshold( const Image16Bit & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint16_t threshold );
+    void  Threshold( const Image16Bit & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                     uint32_t width, uint32_t height, uint16_t threshold );
+
+    Image Threshold( const ImageFloat & in, float threshold );
+    void  Threshold( const ImageFloat & in, Image & out, float threshold );
+    Image Threshold( const ImageFloat & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, float threshold );
+    void  Threshold( const ImageFloat & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                     uint32_t width, uint32_t height, float threshold );
+
+    Image Threshold( const Image16Bit & in, uint16_t minThreshold, uint16_t maxThreshold );
+    void  Threshold( const Image16Bit & in, Image & out, uint16_t minThreshold, uint16_t maxThreshold );
+    Image Threshold( const Image16Bit & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint16_t minThreshold,
+                     uint16_t maxThreshold );
+    void  Threshold( const Image16Bit & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                     uint32_t width, uint32_t height, uint16_t minThreshold, uint16_t maxThreshold );
+
+    Image Threshold( const ImageFloat & in, float minThreshold, float maxThreshold );
+    void  Threshold( const ImageFloat & in, Image & out, float minThreshold, float maxThreshold );
+    Image Threshold( const ImageFloat & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, float minThreshold,
+                     float maxThreshold );
+    void  Threshold( const ImageFloat & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                     uint32_t width, uint32_t height, float minThreshold, float maxThreshold );
 }
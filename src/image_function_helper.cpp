@@ -1,6 +1,196 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include "image_function_helper.h"
 #include "parameter_validation.h"
 
+namespace
+{
+    // Operations of morphology filters. Neutral value does not change a result of operation so it is used for pixels outside of an area
+    struct DilateOperation
+    {
+        static uint8_t neutral()
+        {
+            return 0u;
+        }
+
+        static uint8_t calculate( uint8_t value1, uint8_t value2 )
+        {
+            return (value1 < value2) ? value2 : value1;
+        }
+    };
+
+    struct ErodeOperation
+    {
+        static uint8_t neutral()
+        {
+            return 255u;
+        }
+
+        static uint8_t calculate( uint8_t value1, uint8_t value2 )
+        {
+            return (value1 < value2) ? value1 : value2;
+        }
+    };
+
+    // Scratch buffers of morphology filters are kept between calls so filtering of images of the same size does not allocate memory.
+    // Every thread has own buffers as the filters are called from many threads by Function_Pool
+    struct MorphologyBuffer
+    {
+        std::vector < uint8_t > vertical;
+        std::vector < uint8_t > prefix;
+        std::vector < uint8_t > suffix;
+        std::vector < uint8_t > neutralRow;
+        std::vector < const uint8_t * > row;
+    };
+
+    thread_local MorphologyBuffer morphologyBuffer;
+
+    // Positions are split into blocks of window size, any window is covered by a suffix of one block and a prefix of the next block
+    // so every pixel takes 3 operations regardless of window size
+    template <typename TOperation>
+    void MorphologyFilter( Image_Function_Helper::FunctionTable::MorphologyRow morphologyRow,
+                           const PenguinV_Image::Image & in, uint32_t areaX, uint32_t areaY, uint32_t areaWidth, uint32_t areaHeight,
+                           uint32_t startXIn, uint32_t startYIn, PenguinV_Image::Image & out, uint32_t startXOut, uint32_t startYOut,
+                           uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        // a window which is bigger than the area covers the same pixels
+        radiusX = std::min( radiusX, areaWidth );
+        radiusY = std::min( radiusY, areaHeight );
+
+        const uint32_t columnStart = (startXIn - areaX > radiusX) ? startXIn - radiusX : areaX;
+        const uint32_t columnEnd   = std::min( areaX + areaWidth, startXIn + width + radiusX );
+        const uint32_t columnCount = columnEnd - columnStart;
+
+        const uint32_t rowSizeIn  = in.rowSize();
+        const uint32_t rowSizeOut = out.rowSize();
+
+        std::vector < uint8_t > & vertical = morphologyBuffer.vertical;
+        std::vector < uint8_t > & prefix   = morphologyBuffer.prefix;
+        std::vector < uint8_t > & suffix   = morphologyBuffer.suffix;
+
+        // all input pixels are read before writing output so filtering can be done in place
+        vertical.resize( height * columnCount );
+
+        if( radiusY == 0u ) {
+            for( uint32_t y = 0; y < height; ++y )
+                memcpy( vertical.data() + y * columnCount, in.data() + (startYIn + y) * rowSizeIn + columnStart, columnCount );
+        }
+        else {
+            const uint32_t windowSize = 2 * radiusY + 1;
+
+            suffix.resize( windowSize * columnCount );
+            prefix.resize( windowSize * columnCount );
+            morphologyBuffer.neutralRow.assign( columnCount, TOperation::neutral() );
+
+            // rows are numbered from (startYIn - radiusY) and rows outside of the area are neutral
+            std::vector < const uint8_t * > & row = morphologyBuffer.row;
+            row.resize( height + windowSize - 1 );
+
+            for( uint32_t i = 0; i < row.size(); ++i ) {
+                const int64_t rowY = static_cast<int64_t>(startYIn) - radiusY + i;
+
+                if( rowY < areaY || rowY >= static_cast<int64_t>(areaY) + areaHeight )
+                    row[i] = morphologyBuffer.neutralRow.data();
+                else
+                    row[i] = in.data() + static_cast<uint32_t>(rowY) * rowSizeIn + columnStart;
+            }
+
+            for( uint32_t blockStart = 0; blockStart < height; blockStart += windowSize ) {
+                uint8_t * suffixRow = suffix.data() + (windowSize - 1) * columnCount;
+                memcpy( suffixRow, row[blockStart + windowSize - 1], columnCount );
+
+                for( uint32_t i = windowSize - 1; i > 0; --i, suffixRow -= columnCount )
+                    morphologyRow( row[blockStart + i - 1], suffixRow, suffixRow - columnCount, columnCount );
+
+                memcpy( vertical.data() + blockStart * columnCount, suffix.data(), columnCount );
+
+                // the first output row of a block is covered by the block itself, other rows need a prefix of the next block
+                const uint32_t prefixCount = std::min( blockStart + windowSize, height ) - blockStart - 1;
+
+                if( prefixCount > 0 ) {
+                    uint8_t * prefixRow = prefix.data();
+                    memcpy( prefixRow, row[blockStart + windowSize], columnCount );
+
+                    for( uint32_t i = 1; i < prefixCount; ++i, prefixRow += columnCount )
+                        morphologyRow( prefixRow, row[blockStart + windowSize + i], prefixRow + columnCount, columnCount );
+
+                    for( uint32_t i = 0; i < prefixCount; ++i )
+                        morphologyRow( suffix.data() + (i + 1) * columnCount, prefix.data() + i * columnCount,
+                                       vertical.data() + (blockStart + i + 1) * columnCount, columnCount );
+                }
+            }
+        }
+
+        uint8_t * outY = out.data() + startYOut * rowSizeOut + startXOut;
+        const uint8_t * verticalY = vertical.data() + (startXIn - columnStart);
+
+        if( radiusX == 0u ) {
+            for( uint32_t y = 0; y < height; ++y, outY += rowSizeOut, verticalY += columnCount )
+                memcpy( outY, verticalY, width );
+
+            return;
+        }
+
+        const uint32_t windowSize = 2 * radiusX + 1;
+        const uint32_t rowLength  = width + windowSize - 1;
+
+        // columns are numbered from (startXIn - radiusX) and columns outside of the area are neutral
+        const uint32_t columnOffset = columnStart + radiusX - startXIn;
+
+        std::vector < uint8_t > & paddedRow = morphologyBuffer.neutralRow;
+        paddedRow.assign( rowLength, TOperation::neutral() );
+        prefix.resize( rowLength );
+        suffix.resize( rowLength );
+
+        verticalY = vertical.data();
+
+        for( uint32_t y = 0; y < height; ++y, outY += rowSizeOut, verticalY += columnCount ) {
+            memcpy( paddedRow.data() + columnOffset, verticalY, columnCount );
+
+            for( uint32_t blockStart = 0; blockStart < rowLength; blockStart += windowSize ) {
+                const uint32_t blockEnd = std::min( blockStart + windowSize, rowLength );
+
+                prefix[blockStart] = paddedRow[blockStart];
+                for( uint32_t x = blockStart + 1; x < blockEnd; ++x )
+                    prefix[x] = TOperation::calculate( prefix[x - 1], paddedRow[x] );
+
+                suffix[blockEnd - 1] = paddedRow[blockEnd - 1];
+                for( uint32_t x = blockEnd - 1; x > blockStart; --x )
+                    suffix[x - 1] = TOperation::calculate( paddedRow[x - 1], suffix[x] );
+            }
+
+            for( uint32_t x = 0; x < width; ++x )
+                outY[x] = TOperation::calculate( suffix[x], prefix[x + windowSize - 1] );
+        }
+    }
+
+    // Opening and closing: the first filter is applied to the area extended by radius as the second filter uses these pixels
+    template <typename TOperation1, typename TOperation2>
+    void MorphologyFilter( Image_Function_Helper::FunctionTable::MorphologyRow morphologyRow1,
+                           Image_Function_Helper::FunctionTable::MorphologyRow morphologyRow2,
+                           const PenguinV_Image::Image & in, uint32_t areaX, uint32_t areaY, uint32_t areaWidth, uint32_t areaHeight,
+                           uint32_t startXIn, uint32_t startYIn, PenguinV_Image::Image & out, uint32_t startXOut, uint32_t startYOut,
+                           uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        radiusX = std::min( radiusX, areaWidth );
+        radiusY = std::min( radiusY, areaHeight );
+
+        const uint32_t extendedX = (startXIn - areaX > radiusX) ? startXIn - radiusX : areaX;
+        const uint32_t extendedY = (startYIn - areaY > radiusY) ? startYIn - radiusY : areaY;
+
+        const uint32_t extendedWidth  = std::min( areaX + areaWidth,  startXIn + width  + radiusX ) - extendedX;
+        const uint32_t extendedHeight = std::min( areaY + areaHeight, startYIn + height + radiusY ) - extendedY;
+
+        PenguinV_Image::Image filtered( extendedWidth, extendedHeight );
+
+        MorphologyFilter<TOperation1>( morphologyRow1, in, areaX, areaY, areaWidth, areaHeight, extendedX, extendedY, filtered, 0, 0,
+                                       extendedWidth, extendedHeight, radiusX, radiusY );
+        MorphologyFilter<TOperation2>( morphologyRow2, filtered, 0, 0, extendedWidth, extendedHeight, startXIn - extendedX,
+                                       startYIn - extendedY, out, startXOut, startYOut, width, height, radiusX, radiusY );
+    }
+}
+
 namespace Image_Function_Helper
 {
     Image AbsoluteDifference( FunctionTable::AbsoluteDifference absoluteDifference,
@@ -143,6 +333,38 @@ namespace Image_Function_Helper
         return out;
     }
 
+    Image Closing( FunctionTable::Closing closing,
+                 const Image & in, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function::ParameterValidation( in );
+
+        Image out = in.generate( in.width(), in.height() );
+
+        closing( in, 0, 0, out, 0, 0, out.width(), out.height(), radiusX, radiusY );
+
+        return out;
+    }
+
+    void Closing( FunctionTable::Closing closing,
+                const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function::ParameterValidation( in, out );
+
+        closing( in, 0, 0, out, 0, 0, out.width(), out.height(), radiusX, radiusY );
+    }
+
+    Image Closing( FunctionTable::Closing closing,
+                 const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function::ParameterValidation( in, startXIn, startYIn, width, height );
+
+        Image out = in.generate( width, height );
+
+        closing( in, startXIn, startYIn, out, 0, 0, width, height, radiusX, radiusY );
+
+        return out;
+    }
+
     Image ConvertToGrayScale( FunctionTable::ConvertToGrayScale convertToGrayScale,
                               const Image & in )
     {
@@ -219,6 +441,70 @@ namespace Image_Function_Helper
         return out;
     }
 
+    Image Dilate( FunctionTable::Dilate dilate,
+                const Image & in, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function::ParameterValidation( in );
+
+        Image out = in.generate( in.width(), in.height() );
+
+        dilate( in, 0, 0, out, 0, 0, out.width(), out.height(), radiusX, radiusY );
+
+        return out;
+    }
+
+    void Dilate( FunctionTable::Dilate dilate,
+               const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function::ParameterValidation( in, out );
+
+        dilate( in, 0, 0, out, 0, 0, out.width(), out.height(), radiusX, radiusY );
+    }
+
+    Image Dilate( FunctionTable::Dilate dilate,
+                const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function::ParameterValidation( in, startXIn, startYIn, width, height );
+
+        Image out = in.generate( width, height );
+
+        dilate( in, startXIn, startYIn, out, 0, 0, width, height, radiusX, radiusY );
+
+        return out;
+    }
+
+    Image Erode( FunctionTable::Erode erode,
+               const Image & in, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function::ParameterValidation( in );
+
+        Image out = in.generate( in.width(), in.height() );
+
+        erode( in, 0, 0, out, 0, 0, out.width(), out.height(), radiusX, radiusY );
+
+        return out;
+    }
+
+    void Erode( FunctionTable::Erode erode,
+              const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function::ParameterValidation( in, out );
+
+        erode( in, 0, 0, out, 0, 0, out.width(), out.height(), radiusX, radiusY );
+    }
+
+    Image Erode( FunctionTable::Erode erode,
+               const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function::ParameterValidation( in, startXIn, startYIn, width, height );
+
+        Image out = in.generate( width, height );
+
+        erode( in, startXIn, startYIn, out, 0, 0, width, height, radiusX, radiusY );
+
+        return out;
+    }
+
     Image ExtractChannel( FunctionTable::ExtractChannel extractChannel,
                           const Image & in, uint8_t channelId )
     {
@@ -316,6 +602,40 @@ namespace Image_Function_Helper
         return out;
     }
 
+    std::vector < uint8_t > GetGammaCorrectionLookupTable( double a, double gamma )
+    {
+        if( a < 0 || gamma < 0 )
+            throw imageException( "Gamma correction parameters are invalid" );
+
+        // We precalculate all values and store them in lookup table
+        std::vector < uint8_t > value( 256, 255u );
+
+        for( uint16_t i = 0; i < 256; ++i ) {
+            double data = a * pow( i / 255.0, gamma ) * 255 + 0.5;
+
+            if( data < 256 )
+                value[i] = static_cast<uint8_t>(data);
+        }
+
+        return value;
+    }
+
+    std::vector < uint8_t > GetNormalizeLookupTable( uint8_t minimum, uint8_t maximum )
+    {
+        if( minimum >= maximum )
+            throw imageException( "Normalization range is invalid" );
+
+        const double correction = 255.0 / (maximum - minimum);
+
+        // We precalculate all values and store them in lookup table
+        std::vector < uint8_t > value( 256 );
+
+        for( uint16_t i = 0; i < 256; ++i )
+            value[i] = static_cast <uint8_t>((i - minimum) * correction + 0.5);
+
+        return value;
+    }
+
     uint8_t GetThreshold( const std::vector < uint32_t > & histogram )
     {
         if( histogram.size() != 256 )
@@ -587,6 +907,38 @@ namespace Image_Function_Helper
         return out;
     }
 
+    Image Opening( FunctionTable::Opening opening,
+                 const Image & in, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function::ParameterValidation( in );
+
+        Image out = in.generate( in.width(), in.height() );
+
+        opening( in, 0, 0, out, 0, 0, out.width(), out.height(), radiusX, radiusY );
+
+        return out;
+    }
+
+    void Opening( FunctionTable::Opening opening,
+                const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function::ParameterValidation( in, out );
+
+        opening( in, 0, 0, out, 0, 0, out.width(), out.height(), radiusX, radiusY );
+    }
+
+    Image Opening( FunctionTable::Opening opening,
+                 const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function::ParameterValidation( in, startXIn, startYIn, width, height );
+
+        Image out = in.generate( width, height );
+
+        opening( in, startXIn, startYIn, out, 0, 0, width, height, radiusX, radiusY );
+
+        return out;
+    }
+
     std::vector < uint32_t > ProjectionProfile( FunctionTable::ProjectionProfile projectionProfile,
                                                 const Image & image, bool horizontal )
     {
@@ -777,6 +1129,38 @@ namespace Image_Function_Helper
         return out;
     }
 
+    Image TopHat( FunctionTable::TopHat topHat,
+                const Image & in, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function::ParameterValidation( in );
+
+        Image out = in.generate( in.width(), in.height() );
+
+        topHat( in, 0, 0, out, 0, 0, out.width(), out.height(), radiusX, radiusY );
+
+        return out;
+    }
+
+    void TopHat( FunctionTable::TopHat topHat,
+               const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function::ParameterValidation( in, out );
+
+        topHat( in, 0, 0, out, 0, 0, out.width(), out.height(), radiusX, radiusY );
+    }
+
+    Image TopHat( FunctionTable::TopHat topHat,
+                const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function::ParameterValidation( in, startXIn, startYIn, width, height );
+
+        Image out = in.generate( width, height );
+
+        topHat( in, startXIn, startYIn, out, 0, 0, width, height, radiusX, radiusY );
+
+        return out;
+    }
+
     Image Transpose( FunctionTable::Transpose transpose,
                      const Image & in )
     {
@@ -809,4 +1193,54 @@ namespace Image_Function_Helper
 
         return out;
     }
+
+    void DilateFilter( FunctionTable::MorphologyRow maximumRow,
+                       const Image & in, uint32_t areaX, uint32_t areaY, uint32_t areaWidth, uint32_t areaHeight,
+                       uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                       uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        MorphologyFilter<DilateOperation>( maximumRow, in, areaX, areaY, areaWidth, areaHeight, startXIn, startYIn, out, startXOut,
+                                           startYOut, width, height, radiusX, radiusY );
+    }
+
+    void ErodeFilter( FunctionTable::MorphologyRow minimumRow,
+                      const Image & in, uint32_t areaX, uint32_t areaY, uint32_t areaWidth, uint32_t areaHeight,
+                      uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                      uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        MorphologyFilter<ErodeOperation>( minimumRow, in, areaX, areaY, areaWidth, areaHeight, startXIn, startYIn, out, startXOut,
+                                          startYOut, width, height, radiusX, radiusY );
+    }
+
+    void ClosingFilter( FunctionTable::MorphologyRow maximumRow, FunctionTable::MorphologyRow minimumRow,
+                        const Image & in, uint32_t areaX, uint32_t areaY, uint32_t areaWidth, uint32_t areaHeight,
+                        uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                        uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        MorphologyFilter<DilateOperation, ErodeOperation>( maximumRow, minimumRow, in, areaX, areaY, areaWidth, areaHeight, startXIn, startYIn,
+                                                           out, startXOut, startYOut, width, height, radiusX, radiusY );
+    }
+
+    void OpeningFilter( FunctionTable::MorphologyRow maximumRow, FunctionTable::MorphologyRow minimumRow,
+                        const Image & in, uint32_t areaX, uint32_t areaY, uint32_t areaWidth, uint32_t areaHeight,
+                        uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                        uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        MorphologyFilter<ErodeOperation, DilateOperation>( minimumRow, maximumRow, in, areaX, areaY, areaWidth, areaHeight, startXIn, startYIn,
+                                                           out, startXOut, startYOut, width, height, radiusX, radiusY );
+    }
+
+    // Top hat is a difference between an image and its opening
+    void TopHatFilter( FunctionTable::MorphologyRow maximumRow, FunctionTable::MorphologyRow minimumRow, FunctionTable::Subtract subtract,
+                       const Image & in, uint32_t areaX, uint32_t areaY, uint32_t areaWidth, uint32_t areaHeight,
+                       uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                       uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image opening( width, height );
+
+        OpeningFilter( maximumRow, minimumRow, in, areaX, areaY, areaWidth, areaHeight, startXIn, startYIn, opening, 0, 0,
+                       width, height, radiusX, radiusY );
+
+        subtract( in, startXIn, startYIn, opening, 0, 0, out, startXOut, startYOut, width, height );
+    }
 }
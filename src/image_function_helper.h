@@ -1,5 +1,8 @@
+#pragma once
+
 #include <vector>
 #include "image_buffer.h"
+#include "parameter_validation.h"
 
 namespace Image_Function_Helper
 {
@@ -17,12 +20,18 @@ namespace Image_Function_Helper
                                             Image & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height);
         typedef void ( *BitwiseXor )       (const Image & in1, uint32_t startX1, uint32_t startY1, const Image & in2, uint32_t startX2, uint32_t startY2,
                                             Image & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height);
+        typedef void ( *Closing )          (const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                                            uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY);
         typedef void ( *ConvertToGrayScale )(const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                                             uint32_t width, uint32_t height);
         typedef void ( *ConvertToRgb )     (const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                                             uint32_t width, uint32_t height);
         typedef void ( *Copy )             (const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                                             uint32_t width, uint32_t height);
+        typedef void ( *Dilate )           (const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                                            uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY);
+        typedef void ( *Erode )            (const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                                            uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY);
         typedef void ( *ExtractChannel )   (const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut,
                                             uint32_t startYOut, uint32_t width, uint32_t height, uint8_t channelId);
         typedef void ( *Fill )             (Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint8_t value);
@@ -46,8 +55,11 @@ namespace Image_Function_Helper
                                             Image & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height);
         typedef void ( *Minimum )          (const Image & in1, uint32_t startX1, uint32_t startY1, const Image & in2, uint32_t startX2, uint32_t startY2,
                                             Image & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height);
+        typedef void ( *MorphologyRow )    (const uint8_t * in1, const uint8_t * in2, uint8_t * out, uint32_t width);
         typedef void ( *Normalize )        (const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                                             uint32_t width, uint32_t height);
+        typedef void ( *Opening )          (const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                                            uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY);
         typedef void ( *ProjectionProfile )(const Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height, bool horizontal,
                                             std::vector < uint32_t > & projection);
         typedef void ( *Resize )           (const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t widthIn, uint32_t heightIn,
@@ -66,6 +78,8 @@ namespace Image_Function_Helper
                                             uint32_t width, uint32_t height, uint8_t threshold);
         typedef void ( *Threshold2 )       (const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                                             uint32_t width, uint32_t height, uint8_t minThreshold, uint8_t maxThreshold);
+        typedef void ( *TopHat )           (const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                                            uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY);
         typedef void ( *Transpose )        (const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                                             uint32_t width, uint32_t height);
     }
@@ -113,6 +127,15 @@ namespace Image_Function_Helper
                       const Image & in1, uint32_t startX1, uint32_t startY1, const Image & in2, uint32_t startX2, uint32_t startY2,
                       uint32_t width, uint32_t height );
 
+    Image Closing( FunctionTable::Closing closing,
+                 const Image & in, uint32_t radiusX, uint32_t radiusY );
+
+    void Closing( FunctionTable::Closing closing,
+                const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY );
+
+    Image Closing( FunctionTable::Closing closing,
+                 const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
     Image ConvertToGrayScale( FunctionTable::ConvertToGrayScale convertToGrayScale,
                               const Image & in );
 
@@ -134,6 +157,24 @@ namespace Image_Function_Helper
     Image Copy( FunctionTable::Copy copy,
                 const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height );
 
+    Image Dilate( FunctionTable::Dilate dilate,
+                const Image & in, uint32_t radiusX, uint32_t radiusY );
+
+    void Dilate( FunctionTable::Dilate dilate,
+               const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY );
+
+    Image Dilate( FunctionTable::Dilate dilate,
+                const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
+    Image Erode( FunctionTable::Erode erode,
+               const Image & in, uint32_t radiusX, uint32_t radiusY );
+
+    void Erode( FunctionTable::Erode erode,
+              const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY );
+
+    Image Erode( FunctionTable::Erode erode,
+               const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
     Image ExtractChannel( FunctionTable::ExtractChannel extractChannel,
                           const Image & in, uint8_t channelId );
 
@@ -162,6 +203,12 @@ namespace Image_Function_Helper
     Image GammaCorrection( FunctionTable::GammaCorrection gammaCorrection,
                            const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, double a, double gamma );
 
+    // Lookup table used by GammaCorrection function
+    std::vector < uint8_t > GetGammaCorrectionLookupTable( double a, double gamma );
+
+    // Lookup table used by Normalize function to stretch [minimum, maximum] range of intensities to [0, 255] range
+    std::vector < uint8_t > GetNormalizeLookupTable( uint8_t minimum, uint8_t maximum );
+
     uint8_t GetThreshold( const std::vector < uint32_t > & histogram );
 
     std::vector < uint32_t > Histogram( FunctionTable::Histogram histogram,
@@ -231,6 +278,15 @@ namespace Image_Function_Helper
     Image Normalize( FunctionTable::Normalize normalize,
                      const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height );
 
+    Image Opening( FunctionTable::Opening opening,
+                 const Image & in, uint32_t radiusX, uint32_t radiusY );
+
+    void Opening( FunctionTable::Opening opening,
+                const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY );
+
+    Image Opening( FunctionTable::Opening opening,
+                 const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
     std::vector < uint32_t > ProjectionProfile( FunctionTable::ProjectionProfile projectionProfile,
                                                 const Image & image, bool horizontal );
 
@@ -288,6 +344,15 @@ namespace Image_Function_Helper
                      const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint8_t minThreshold,
                      uint8_t maxThreshold );
 
+    Image TopHat( FunctionTable::TopHat topHat,
+                const Image & in, uint32_t radiusX, uint32_t radiusY );
+
+    void TopHat( FunctionTable::TopHat topHat,
+               const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY );
+
+    Image TopHat( FunctionTable::TopHat topHat,
+                const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
     Image Transpose( FunctionTable::Transpose transpose,
                      const Image & in );
 
@@ -296,4 +361,243 @@ namespace Image_Function_Helper
 
     Image Transpose( FunctionTable::Transpose transpose,
                      const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height );
+
+    // Morphology filters of gray-scale images share van Herk/Gil-Werman algorithm. The vertical pass processes whole rows
+    // by given functions which calculate maximum or minimum of two rows so CPU and SIMD code differ only by these functions.
+    // Only pixels of [areaX, areaX + areaWidth) x [areaY, areaY + areaHeight) rectangle are used, filtering can be done in place
+    void DilateFilter( FunctionTable::MorphologyRow maximumRow,
+                       const Image & in, uint32_t areaX, uint32_t areaY, uint32_t areaWidth, uint32_t areaHeight,
+                       uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                       uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
+    void ErodeFilter( FunctionTable::MorphologyRow minimumRow,
+                      const Image & in, uint32_t areaX, uint32_t areaY, uint32_t areaWidth, uint32_t areaHeight,
+                      uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                      uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
+    void ClosingFilter( FunctionTable::MorphologyRow maximumRow, FunctionTable::MorphologyRow minimumRow,
+                        const Image & in, uint32_t areaX, uint32_t areaY, uint32_t areaWidth, uint32_t areaHeight,
+                        uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                        uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
+    void OpeningFilter( FunctionTable::MorphologyRow maximumRow, FunctionTable::MorphologyRow minimumRow,
+                        const Image & in, uint32_t areaX, uint32_t areaY, uint32_t areaWidth, uint32_t areaHeight,
+                        uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                        uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
+    void TopHatFilter( FunctionTable::MorphologyRow maximumRow, FunctionTable::MorphologyRow minimumRow, FunctionTable::Subtract subtract,
+                       const Image & in, uint32_t areaX, uint32_t areaY, uint32_t areaWidth, uint32_t areaHeight,
+                       uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                       uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
+    // Templates below are used by functions for images with 16-bit and floating point pixels
+    namespace FunctionTable
+    {
+        template <typename TColorDepth>
+        using BinaryOperation = void (*)(const ImageTemplate < TColorDepth > & in1, uint32_t startX1, uint32_t startY1,
+                                         const ImageTemplate < TColorDepth > & in2, uint32_t startX2, uint32_t startY2,
+                                         ImageTemplate < TColorDepth > & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height);
+        template <typename TColorDepth>
+        using HistogramTemplate = void (*)(const ImageTemplate < TColorDepth > & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                                           std::vector < uint32_t > & histogram);
+        template <typename TColorDepth>
+        using ResizeTemplate = void (*)(const ImageTemplate < TColorDepth > & in, uint32_t startXIn, uint32_t startYIn, uint32_t widthIn,
+                                        uint32_t heightIn, ImageTemplate < TColorDepth > & out, uint32_t startXOut, uint32_t startYOut,
+                                        uint32_t widthOut, uint32_t heightOut);
+        template <typename TColorDepth>
+        using ThresholdTemplate = void (*)(const ImageTemplate < TColorDepth > & in, uint32_t startXIn, uint32_t startYIn, Image & out,
+                                           uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height, TColorDepth threshold);
+        template <typename TColorDepth>
+        using Threshold2Template = void (*)(const ImageTemplate < TColorDepth > & in, uint32_t startXIn, uint32_t startYIn, Image & out,
+                                            uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height, TColorDepth minThreshold,
+                                            TColorDepth maxThreshold);
+    }
+
+    template <typename TColorDepth>
+    ImageTemplate < TColorDepth > BinaryOperation( FunctionTable::BinaryOperation < TColorDepth > operation,
+                                                   const ImageTemplate < TColorDepth > & in1, const ImageTemplate < TColorDepth > & in2 )
+    {
+        Image_Function::ParameterValidation( in1, in2 );
+
+        ImageTemplate < TColorDepth > out = in1.generate( in1.width(), in1.height(), Image_Function::CommonColorCount( in1, in2 ) );
+
+        operation( in1, 0, 0, in2, 0, 0, out, 0, 0, out.width(), out.height() );
+
+        return out;
+    }
+
+    template <typename TColorDepth>
+    void BinaryOperation( FunctionTable::BinaryOperation < TColorDepth > operation,
+                          const ImageTemplate < TColorDepth > & in1, const ImageTemplate < TColorDepth > & in2, ImageTemplate < TColorDepth > & out )
+    {
+        Image_Function::ParameterValidation( in1, in2, out );
+
+        operation( in1, 0, 0, in2, 0, 0, out, 0, 0, out.width(), out.height() );
+    }
+
+    template <typename TColorDepth>
+    ImageTemplate < TColorDepth > BinaryOperation( FunctionTable::BinaryOperation < TColorDepth > operation,
+                                                   const ImageTemplate < TColorDepth > & in1, uint32_t startX1, uint32_t startY1,
+                                                   const ImageTemplate < TColorDepth > & in2, uint32_t startX2, uint32_t startY2,
+                                                   uint32_t width, uint32_t height )
+    {
+        Image_Function::ParameterValidation( in1, startX1, startY1, in2, startX2, startY2, width, height );
+
+        ImageTemplate < TColorDepth > out = in1.generate( width, height, Image_Function::CommonColorCount( in1, in2 ) );
+
+        operation( in1, startX1, startY1, in2, startX2, startY2, out, 0, 0, out.width(), out.height() );
+
+        return out;
+    }
+
+    template <typename TColorDepth>
+    std::vector < uint32_t > Histogram( FunctionTable::HistogramTemplate < TColorDepth > histogram,
+                                        const ImageTemplate < TColorDepth > & image )
+    {
+        std::vector < uint32_t > histogramTable;
+
+        histogram( image, 0, 0, image.width(), image.height(), histogramTable );
+
+        return histogramTable;
+    }
+
+    template <typename TColorDepth>
+    void Histogram( FunctionTable::HistogramTemplate < TColorDepth > histogram,
+                    const ImageTemplate < TColorDepth > & image, std::vector < uint32_t > & histogramTable )
+    {
+        Image_Function::ParameterValidation( image );
+
+        histogram( image, 0, 0, image.width(), image.height(), histogramTable );
+    }
+
+    template <typename TColorDepth>
+    std::vector < uint32_t > Histogram( FunctionTable::HistogramTemplate < TColorDepth > histogram,
+                                        const ImageTemplate < TColorDepth > & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height )
+    {
+        Image_Function::ParameterValidation( image, x, y, width, height );
+
+        std::vector < uint32_t > histogramTable;
+
+        histogram( image, x, y, width, height, histogramTable );
+
+        return histogramTable;
+    }
+
+    template <typename TColorDepth>
+    ImageTemplate < TColorDepth > Resize( FunctionTable::ResizeTemplate < TColorDepth > resize,
+                                          const ImageTemplate < TColorDepth > & in, uint32_t widthOut, uint32_t heightOut )
+    {
+        Image_Function::ParameterValidation( in );
+
+        ImageTemplate < TColorDepth > out = in.generate( widthOut, heightOut );
+
+        resize( in, 0, 0, in.width(), in.height(), out, 0, 0, widthOut, heightOut );
+
+        return out;
+    }
+
+    template <typename TColorDepth>
+    void Resize( FunctionTable::ResizeTemplate < TColorDepth > resize,
+                 const ImageTemplate < TColorDepth > & in, ImageTemplate < TColorDepth > & out )
+    {
+        Image_Function::ParameterValidation( in );
+        Image_Function::ParameterValidation( out );
+
+        resize( in, 0, 0, in.width(), in.height(), out, 0, 0, out.width(), out.height() );
+    }
+
+    template <typename TColorDepth>
+    ImageTemplate < TColorDepth > Resize( FunctionTable::ResizeTemplate < TColorDepth > resize,
+                                          const ImageTemplate < TColorDepth > & in, uint32_t startXIn, uint32_t startYIn, uint32_t widthIn,
+                                          uint32_t heightIn, uint32_t widthOut, uint32_t heightOut )
+    {
+        Image_Function::ParameterValidation( in, startXIn, startYIn, widthIn, heightIn );
+
+        ImageTemplate < TColorDepth > out = in.generate( widthOut, heightOut );
+
+        resize( in, startXIn, startYIn, widthIn, heightIn, out, 0, 0, widthOut, heightOut );
+
+        return out;
+    }
+
+    // Thresholding of images with 16-bit and floating point pixels always produces 8-bit images
+    template <typename TColorDepth>
+    Image Threshold( FunctionTable::ThresholdTemplate < TColorDepth > threshold,
+                     const ImageTemplate < TColorDepth > & in, TColorDepth thresholdValue )
+    {
+        Image_Function::ParameterValidation( in );
+
+        Image out( in.width(), in.height() );
+
+        threshold( in, 0, 0, out, 0, 0, out.width(), out.height(), thresholdValue );
+
+        return out;
+    }
+
+    template <typename TColorDepth>
+    void Threshold( FunctionTable::ThresholdTemplate < TColorDepth > threshold,
+                    const ImageTemplate < TColorDepth > & in, Image & out, TColorDepth thresholdValue )
+    {
+        Image_Function::ParameterValidation( in );
+        Image_Function::ParameterValidation( out );
+
+        if( in.width() != out.width() || in.height() != out.height() )
+            throw imageException( "Bad input parameters in image function" );
+
+        threshold( in, 0, 0, out, 0, 0, out.width(), out.height(), thresholdValue );
+    }
+
+    template <typename TColorDepth>
+    Image Threshold( FunctionTable::ThresholdTemplate < TColorDepth > threshold,
+                     const ImageTemplate < TColorDepth > & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height,
+                     TColorDepth thresholdValue )
+    {
+        Image_Function::ParameterValidation( in, startXIn, startYIn, width, height );
+
+        Image out( width, height );
+
+        threshold( in, startXIn, startYIn, out, 0, 0, width, height, thresholdValue );
+
+        return out;
+    }
+
+    template <typename TColorDepth>
+    Image Threshold( FunctionTable::Threshold2Template < TColorDepth > threshold,
+                     const ImageTemplate < TColorDepth > & in, TColorDepth minThreshold, TColorDepth maxThreshold )
+    {
+        Image_Function::ParameterValidation( in );
+
+        Image out( in.width(), in.height() );
+
+        threshold( in, 0, 0, out, 0, 0, out.width(), out.height(), minThreshold, maxThreshold );
+
+        return out;
+    }
+
+    template <typename TColorDepth>
+    void Threshold( FunctionTable::Threshold2Template < TColorDepth > threshold,
+                    const ImageTemplate < TColorDepth > & in, Image & out, TColorDepth minThreshold, TColorDepth maxThreshold )
+    {
+        Image_Function::ParameterValidation( in );
+        Image_Function::ParameterValidation( out );
+
+        if( in.width() != out.width() || in.height() != out.height() )
+            throw imageException( "Bad input parameters in image function" );
+
+        threshold( in, 0, 0, out, 0, 0, out.width(), out.height(), minThreshold, maxThreshold );
+    }
+
+    template <typename TColorDepth>
+    Image Threshold( FunctionTable::Threshold2Template < TColorDepth > threshold,
+                     const ImageTemplate < TColorDepth > & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height,
+                     TColorDepth minThreshold, TColorDepth maxThreshold )
+    {
+        Image_Function::ParameterValidation( in, startXIn, startYIn, width, height );
+
+        Image out( width, height );
+
+        threshold( in, startXIn, startYIn, out, 0, 0, width, height, minThreshold, maxThreshold );
+
+        return out;
+    }
 }
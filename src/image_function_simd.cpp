@@ -1,5 +1,6 @@
 #include "image_function_simd.h"
 
+#include <limits>
 #include "image_function.h"
 #include "image_function_helper.h"
 #include "parameter_validation.h"
@@ -17,6 +18,51 @@
 #include <arm_neon.h>
 #endif
 
+namespace
+{
+    // Operations for images with 16-bit and floating point pixels
+    enum BinaryOperation
+    {
+        ABSOLUTE_DIFFERENCE,
+        MAXIMUM,
+        MINIMUM,
+        SUBTRACT
+    };
+
+    // These functions are used for pixels at the end of a row which do not fill whole SIMD register
+    template <BinaryOperation operation>
+    uint16_t calculate( uint16_t value1, uint16_t value2 )
+    {
+        switch( operation ) {
+            case ABSOLUTE_DIFFERENCE:
+                return (value2 > value1) ? static_cast<uint16_t>(value2 - value1) : static_cast<uint16_t>(value1 - value2);
+            case MAXIMUM:
+                return (value1 > value2) ? value1 : value2;
+            case MINIMUM:
+                return (value1 < value2) ? value1 : value2;
+            case SUBTRACT:
+            default:
+                return (value1 > value2) ? static_cast<uint16_t>(value1 - value2) : static_cast<uint16_t>(0u);
+        }
+    }
+
+    template <BinaryOperation operation>
+    float calculate( float value1, float value2 )
+    {
+        switch( operation ) {
+            case ABSOLUTE_DIFFERENCE:
+                return (value2 > value1) ? value2 - value1 : value1 - value2;
+            case MAXIMUM:
+                return (value1 > value2) ? value1 : value2;
+            case MINIMUM:
+                return (value1 < value2) ? value1 : value2;
+            case SUBTRACT:
+            default:
+                return value1 - value2;
+        }
+    }
+}
+
 namespace avx
 {
     const uint32_t simdSize = 32u;
@@ -24,8 +70,24 @@ namespace avx
 #ifdef PENGUINV_AVX_SET
     typedef __m256i simd;
 
-    // We are not sure that input data is aligned by 32 bytes so we use loadu() functions instead of load()
+    // Aligned load() and store() functions are used only when all rows of all images start at 32-byte boundary
+    // otherwise we are not sure that data is aligned so loadu() and storeu() functions are used
+    template <bool aligned>
+    simd load( const simd * address )
+    {
+        return aligned ? _mm256_load_si256( address ) : _mm256_loadu_si256( address );
+    }
+
+    template <bool aligned>
+    void store( simd * address, simd value )
+    {
+        if( aligned )
+            _mm256_store_si256( address, value );
+        else
+            _mm256_storeu_si256( address, value );
+    }
 
+    template <bool aligned>
     void AbsoluteDifference( uint32_t rowSizeIn1, uint32_t rowSizeIn2, uint32_t rowSizeOut, const uint8_t * in1Y, const uint8_t * in2Y,
                              uint8_t * outY, const uint8_t * outYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
     {
@@ -37,9 +99,9 @@ namespace avx
             const simd * src1End = src1 + simdWidth;
 
             for( ; src1 != src1End; ++src1, ++src2, ++dst ) {
-                simd data1 = _mm256_loadu_si256( src1 );
-                simd data2 = _mm256_loadu_si256( src2 );
-                _mm256_storeu_si256( dst, _mm256_sub_epi8( _mm256_max_epu8( data1, data2 ), _mm256_min_epu8( data1, data2 ) ) );
+                simd data1 = load<aligned>( src1 );
+                simd data2 = load<aligned>( src2 );
+                store<aligned>( dst, _mm256_sub_epi8( _mm256_max_epu8( data1, data2 ), _mm256_min_epu8( data1, data2 ) ) );
             }
 
             if( nonSimdWidth > 0 ) {
@@ -55,6 +117,7 @@ namespace avx
         }
     }
 
+    template <bool aligned>
     void BitwiseAnd( uint32_t rowSizeIn1, uint32_t rowSizeIn2, uint32_t rowSizeOut, const uint8_t * in1Y, const uint8_t * in2Y,
                      uint8_t * outY, const uint8_t * outYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
     {
@@ -66,7 +129,7 @@ namespace avx
             const simd * src1End = src1 + simdWidth;
 
             for( ; src1 != src1End; ++src1, ++src2, ++dst )
-                _mm256_storeu_si256( dst, _mm256_and_si256( _mm256_loadu_si256( src1 ), _mm256_loadu_si256( src2 ) ) );
+                store<aligned>( dst, _mm256_and_si256( load<aligned>( src1 ), load<aligned>( src2 ) ) );
 
             if( nonSimdWidth > 0 ) {
                 const uint8_t * in1X = in1Y + totalSimdWidth;
@@ -81,6 +144,7 @@ namespace avx
         }
     }
 
+    template <bool aligned>
     void BitwiseOr( uint32_t rowSizeIn1, uint32_t rowSizeIn2, uint32_t rowSizeOut, const uint8_t * in1Y, const uint8_t * in2Y,
                     uint8_t * outY, const uint8_t * outYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
     {
@@ -92,7 +156,7 @@ namespace avx
             const simd * src1End = src1 + simdWidth;
 
             for( ; src1 != src1End; ++src1, ++src2, ++dst )
-                _mm256_storeu_si256( dst, _mm256_or_si256( _mm256_loadu_si256( src1 ), _mm256_loadu_si256( src2 ) ) );
+                store<aligned>( dst, _mm256_or_si256( load<aligned>( src1 ), load<aligned>( src2 ) ) );
 
             if( nonSimdWidth > 0 ) {
                 const uint8_t * in1X = in1Y + totalSimdWidth;
@@ -107,6 +171,7 @@ namespace avx
         }
     }
 
+    template <bool aligned>
     void BitwiseXor( uint32_t rowSizeIn1, uint32_t rowSizeIn2, uint32_t rowSizeOut, const uint8_t * in1Y, const uint8_t * in2Y,
                      uint8_t * outY, const uint8_t * outYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
     {
@@ -118,7 +183,7 @@ namespace avx
             const simd * src1End = src1 + simdWidth;
 
             for( ; src1 != src1End; ++src1, ++src2, ++dst )
-                _mm256_storeu_si256( dst, _mm256_xor_si256( _mm256_loadu_si256( src1 ), _mm256_loadu_si256( src2 ) ) );
+                store<aligned>( dst, _mm256_xor_si256( load<aligned>( src1 ), load<aligned>( src2 ) ) );
 
             if( nonSimdWidth > 0 ) {
                 const uint8_t * in1X = in1Y + totalSimdWidth;
@@ -133,6 +198,7 @@ namespace avx
         }
     }
 
+    template <bool aligned>
     void Invert( uint32_t rowSizeIn, uint32_t rowSizeOut, const uint8_t * inY, uint8_t * outY, const uint8_t * outYEnd,
                  uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
     {
@@ -150,7 +216,7 @@ namespace avx
             const simd * src1End = src1 + simdWidth;
 
             for( ; src1 != src1End; ++src1, ++dst )
-                _mm256_storeu_si256( dst, _mm256_andnot_si256( _mm256_loadu_si256( src1 ), mask ) );
+                store<aligned>( dst, _mm256_andnot_si256( load<aligned>( src1 ), mask ) );
 
             if( nonSimdWidth > 0 ) {
                 const uint8_t * inX  = inY  + totalSimdWidth;
@@ -164,6 +230,54 @@ namespace avx
         }
     }
 
+    template <bool aligned>
+    void LookupTable( uint32_t rowSizeIn, uint32_t rowSizeOut, const uint8_t * inY, uint8_t * outY, const uint8_t * outYEnd, const uint8_t * table,
+                      uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
+    {
+        // Shuffle instruction picks a byte from 16-byte array so the table is split into 16 parts
+        // Every part is copied into both 128-bit lanes as shuffle instruction works within a lane
+        simd part[16];
+        for( uint32_t i = 0; i < 16u; ++i ) {
+            const __m128i value = _mm_loadu_si128( reinterpret_cast <const __m128i*> (table + i * 16u) );
+            part[i] = _mm256_inserti128_si256( _mm256_castsi128_si256( value ), value, 1 );
+        }
+
+        // Shuffle instruction sets a byte to 0 when the highest bit of index is set
+        // Saturated addition of 0x70 keeps the highest bit cleared only for indices from 0 to 15
+        // so at every step we move to next part of the table by subtracting 16 from indices
+        const simd step   = _mm256_set1_epi8( 16 );
+        const simd offset = _mm256_set1_epi8( 0x70 );
+
+        for( ; outY != outYEnd; outY += rowSizeOut, inY += rowSizeIn ) {
+            const simd * src    = reinterpret_cast <const simd*> (inY);
+            simd       * dst    = reinterpret_cast <simd*> (outY);
+            const simd * srcEnd = src + simdWidth;
+
+            for( ; src != srcEnd; ++src, ++dst ) {
+                simd index  = load<aligned>( src );
+                simd result = _mm256_shuffle_epi8( part[0], _mm256_adds_epu8( index, offset ) );
+
+                for( uint32_t i = 1; i < 16u; ++i ) {
+                    index  = _mm256_sub_epi8( index, step );
+                    result = _mm256_or_si256( result, _mm256_shuffle_epi8( part[i], _mm256_adds_epu8( index, offset ) ) );
+                }
+
+                store<aligned>( dst, result );
+            }
+
+            if( nonSimdWidth > 0 ) {
+                const uint8_t * inX  = inY  + totalSimdWidth;
+                uint8_t       * outX = outY + totalSimdWidth;
+
+                const uint8_t * outXEnd = outX + nonSimdWidth;
+
+                for( ; outX != outXEnd; ++outX, ++inX )
+                    (*outX) = table[*inX];
+            }
+        }
+    }
+
+    template <bool aligned>
     void Maximum( uint32_t rowSizeIn1, uint32_t rowSizeIn2, uint32_t rowSizeOut, const uint8_t * in1Y, const uint8_t * in2Y,
                   uint8_t * outY, const uint8_t * outYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
     {
@@ -175,7 +289,7 @@ namespace avx
             const simd * src1End = src1 + simdWidth;
 
             for( ; src1 != src1End; ++src1, ++src2, ++dst )
-                _mm256_storeu_si256( dst, _mm256_max_epu8( _mm256_loadu_si256( src1 ), _mm256_loadu_si256( src2 ) ) );
+                store<aligned>( dst, _mm256_max_epu8( load<aligned>( src1 ), load<aligned>( src2 ) ) );
 
             if( nonSimdWidth > 0 ) {
                 const uint8_t * in1X = in1Y + totalSimdWidth;
@@ -194,6 +308,7 @@ namespace avx
         }
     }
 
+    template <bool aligned>
     void Minimum( uint32_t rowSizeIn1, uint32_t rowSizeIn2, uint32_t rowSizeOut, const uint8_t * in1Y, const uint8_t * in2Y,
                   uint8_t * outY, const uint8_t * outYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
     {
@@ -205,7 +320,7 @@ namespace avx
             const simd * src1End = src1 + simdWidth;
 
             for( ; src1 != src1End; ++src1, ++src2, ++dst )
-                _mm256_storeu_si256( dst, _mm256_min_epu8( _mm256_loadu_si256( src1 ), _mm256_loadu_si256( src2 ) ) );
+                store<aligned>( dst, _mm256_min_epu8( load<aligned>( src1 ), load<aligned>( src2 ) ) );
 
             if( nonSimdWidth > 0 ) {
                 const uint8_t * in1X = in1Y + totalSimdWidth;
@@ -224,6 +339,54 @@ namespace avx
         }
     }
 
+    template <bool aligned>
+    void MinimumMaximum( uint32_t rowSize, const uint8_t * imageY, const uint8_t * imageYEnd, uint32_t simdWidth, uint32_t totalSimdWidth,
+                         uint32_t nonSimdWidth, uint8_t & minimum, uint8_t & maximum )
+    {
+        simd simdMinimum = _mm256_set1_epi8( static_cast<char>(minimum) );
+        simd simdMaximum = _mm256_set1_epi8( static_cast<char>(maximum) );
+
+        for( ; imageY != imageYEnd; imageY += rowSize ) {
+            const simd * src    = reinterpret_cast <const simd*> (imageY);
+            const simd * srcEnd = src + simdWidth;
+
+            for( ; src != srcEnd; ++src ) {
+                const simd data = load<aligned>( src );
+
+                simdMinimum = _mm256_min_epu8( simdMinimum, data );
+                simdMaximum = _mm256_max_epu8( simdMaximum, data );
+            }
+
+            if( nonSimdWidth > 0 ) {
+                const uint8_t * imageX    = imageY + totalSimdWidth;
+                const uint8_t * imageXEnd = imageX + nonSimdWidth;
+
+                for( ; imageX != imageXEnd; ++imageX ) {
+                    if( minimum > (*imageX) )
+                        minimum = (*imageX);
+
+                    if( maximum < (*imageX) )
+                        maximum = (*imageX);
+                }
+            }
+        }
+
+        uint8_t outputMinimum[32] = { 0 };
+        uint8_t outputMaximum[32] = { 0 };
+
+        _mm256_storeu_si256( reinterpret_cast <simd*>(outputMinimum), simdMinimum );
+        _mm256_storeu_si256( reinterpret_cast <simd*>(outputMaximum), simdMaximum );
+
+        for( uint32_t i = 0; i < 32u; ++i ) {
+            if( minimum > outputMinimum[i] )
+                minimum = outputMinimum[i];
+
+            if( maximum < outputMaximum[i] )
+                maximum = outputMaximum[i];
+        }
+    }
+
+    template <bool aligned>
     void Subtract( uint32_t rowSizeIn1, uint32_t rowSizeIn2, uint32_t rowSizeOut, const uint8_t * in1Y, const uint8_t * in2Y,
                    uint8_t * outY, const uint8_t * outYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
     {
@@ -235,8 +398,8 @@ namespace avx
             const simd * src1End = src1 + simdWidth;
 
             for( ; src1 != src1End; ++src1, ++src2, ++dst ) {
-                simd data = _mm256_loadu_si256( src1 );
-                _mm256_storeu_si256( dst, _mm256_sub_epi8( data, _mm256_min_epu8( data, _mm256_loadu_si256( src2 ) ) ) );
+                simd data = load<aligned>( src1 );
+                store<aligned>( dst, _mm256_sub_epi8( data, _mm256_min_epu8( data, load<aligned>( src2 ) ) ) );
             }
 
             if( nonSimdWidth > 0 ) {
@@ -256,6 +419,7 @@ namespace avx
         }
     }
 
+    template <bool aligned>
     uint32_t Sum( uint32_t rowSize, const uint8_t * imageY,const uint8_t * imageYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
     {
         uint32_t sum = 0;
@@ -267,7 +431,7 @@ namespace avx
             const simd * srcEnd = src + simdWidth;
 
             for( ; src != srcEnd; ++src ) {
-                simd data = _mm256_loadu_si256( src );
+                simd data = load<aligned>( src );
 
                 simd dataLo  = _mm256_unpacklo_epi8( data, zero );
                 simd dataHi  = _mm256_unpackhi_epi8( data, zero );
@@ -293,6 +457,7 @@ namespace avx
         return sum + output[0] + output[1] + output[2] + output[3] + output[4] + output[5] + output[6] + output[7];
     }
 
+    template <bool aligned>
     void Threshold( uint32_t rowSizeIn, uint32_t rowSizeOut, const uint8_t * inY, uint8_t * outY, const uint8_t * outYEnd, uint8_t threshold,
                     uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
     {
@@ -324,7 +489,7 @@ namespace avx
                 const simd * src1End = src1 + simdWidth;
 
                 for( ; src1 != src1End; ++src1, ++dst )
-                    _mm256_storeu_si256( dst, _mm256_cmpgt_epi8( _mm256_xor_si256( _mm256_loadu_si256( src1 ), mask ), compare ) );
+                    store<aligned>( dst, _mm256_cmpgt_epi8( _mm256_xor_si256( load<aligned>( src1 ), mask ), compare ) );
 
                 if( nonSimdWidth > 0 ) {
                     const uint8_t * inX  = inY  + totalSimdWidth;
@@ -343,6 +508,7 @@ namespace avx
         }
     }
 
+    template <bool aligned>
     void Threshold( uint32_t rowSizeIn, uint32_t rowSizeOut, const uint8_t * inY, uint8_t * outY, const uint8_t * outYEnd, uint8_t minThreshold, uint8_t maxThreshold,
                     uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
     {
@@ -391,9 +557,9 @@ namespace avx
                 const simd * src1End = src1 + simdWidth;
 
                 for( ; src1 != src1End; ++src1, ++dst ) {
-                    simd data = _mm256_xor_si256( _mm256_loadu_si256( src1 ), shiftMask );
+                    simd data = _mm256_xor_si256( load<aligned>( src1 ), shiftMask );
 
-                    _mm256_storeu_si256( dst, _mm256_and_si256(
+                    store<aligned>( dst, _mm256_and_si256(
                         _mm256_andnot_si256(
                             _mm256_cmpgt_epi8( data, maxCompare ), notMask ),
                         _mm256_cmpgt_epi8( data, minCompare ) ) );
@@ -418,9 +584,9 @@ namespace avx
                 const simd * src1End = src1 + simdWidth;
 
                 for( ; src1 != src1End; ++src1, ++dst ) {
-                    simd data = _mm256_xor_si256( _mm256_loadu_si256( src1 ), shiftMask );
+                    simd data = _mm256_xor_si256( load<aligned>( src1 ), shiftMask );
 
-                    _mm256_storeu_si256( dst, _mm256_andnot_si256( _mm256_cmpgt_epi8( data, maxCompare ), notMask ) );
+                    store<aligned>( dst, _mm256_andnot_si256( _mm256_cmpgt_epi8( data, maxCompare ), notMask ) );
                 }
 
                 if( nonSimdWidth > 0 ) {
@@ -435,21 +601,191 @@ namespace avx
             }
         }
     }
+
+    // Operations for images with 16-bit and floating point pixels. Floating point values are passed in integer registers
+    // so the same load() and store() functions are used for all types of pixels. The last parameter defines pixel type
+    template <BinaryOperation operation>
+    simd calculate( simd data1, simd data2, uint16_t )
+    {
+        switch( operation ) {
+            case ABSOLUTE_DIFFERENCE:
+                return _mm256_sub_epi16( _mm256_max_epu16( data1, data2 ), _mm256_min_epu16( data1, data2 ) );
+            case MAXIMUM:
+                return _mm256_max_epu16( data1, data2 );
+            case MINIMUM:
+                return _mm256_min_epu16( data1, data2 );
+            case SUBTRACT:
+            default:
+                return _mm256_subs_epu16( data1, data2 );
+        }
+    }
+
+    template <BinaryOperation operation>
+    simd calculate( simd data1, simd data2, float )
+    {
+        const __m256 value1 = _mm256_castsi256_ps( data1 );
+        const __m256 value2 = _mm256_castsi256_ps( data2 );
+
+        switch( operation ) {
+            case ABSOLUTE_DIFFERENCE:
+                return _mm256_castps_si256( _mm256_sub_ps( _mm256_max_ps( value1, value2 ), _mm256_min_ps( value1, value2 ) ) );
+            case MAXIMUM:
+                return _mm256_castps_si256( _mm256_max_ps( value1, value2 ) );
+            case MINIMUM:
+                return _mm256_castps_si256( _mm256_min_ps( value1, value2 ) );
+            case SUBTRACT:
+            default:
+                return _mm256_castps_si256( _mm256_sub_ps( value1, value2 ) );
+        }
+    }
+
+    template <bool aligned, BinaryOperation operation, typename TColorDepth>
+    void Calculate( uint32_t rowSizeIn1, uint32_t rowSizeIn2, uint32_t rowSizeOut, const TColorDepth * in1Y, const TColorDepth * in2Y,
+                    TColorDepth * outY, const TColorDepth * outYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
+    {
+        for( ; outY != outYEnd; outY += rowSizeOut, in1Y += rowSizeIn1, in2Y += rowSizeIn2 ) {
+            const simd * src1 = reinterpret_cast <const simd*> (in1Y);
+            const simd * src2 = reinterpret_cast <const simd*> (in2Y);
+            simd       * dst  = reinterpret_cast <simd*> (outY);
+
+            const simd * src1End = src1 + simdWidth;
+
+            for( ; src1 != src1End; ++src1, ++src2, ++dst )
+                store<aligned>( dst, calculate<operation>( load<aligned>( src1 ), load<aligned>( src2 ), TColorDepth() ) );
+
+            if( nonSimdWidth > 0 ) {
+                const TColorDepth * in1X = in1Y + totalSimdWidth;
+                const TColorDepth * in2X = in2Y + totalSimdWidth;
+                TColorDepth       * outX = outY + totalSimdWidth;
+
+                const TColorDepth * outXEnd = outX + nonSimdWidth;
+
+                for( ; outX != outXEnd; ++outX, ++in1X, ++in2X )
+                    (*outX) = ::calculate<operation>( *in1X, *in2X );
+            }
+        }
+    }
+
+    // Thresholding of images with 16-bit and floating point pixels. 16 pixels are processed per step and masks of them
+    // are packed into 8-bit output values. Threshold values of floating point images are passed in integer registers
+    const uint32_t thresholdStep = 16u;
+
+    simd thresholdValue( uint16_t value )
+    {
+        return _mm256_set1_epi16( static_cast<short>(value) );
+    }
+
+    simd thresholdValue( float value )
+    {
+        return _mm256_castps_si256( _mm256_set1_ps( value ) );
+    }
+
+    // Saturated differences are zero only for values within the range
+    __m128i threshold( const uint16_t * in, simd minThreshold, simd maxThreshold )
+    {
+        const simd data    = _mm256_loadu_si256( reinterpret_cast<const simd*>(in) );
+        const simd outside = _mm256_or_si256( _mm256_subs_epu16( minThreshold, data ), _mm256_subs_epu16( data, maxThreshold ) );
+        const simd mask    = _mm256_cmpeq_epi16( outside, _mm256_setzero_si256() );
+
+        return _mm_packs_epi16( _mm256_castsi256_si128( mask ), _mm256_extracti128_si256( mask, 1 ) );
+    }
+
+    // Ordered comparisons are false for NaN values so such pixels are set to 255 as CPU code does
+    __m128i threshold( const float * in, simd minThreshold, simd maxThreshold )
+    {
+        const __m256 minValue = _mm256_castsi256_ps( minThreshold );
+        const __m256 maxValue = _mm256_castsi256_ps( maxThreshold );
+
+        const __m256 data1 = _mm256_loadu_ps( in );
+        const __m256 data2 = _mm256_loadu_ps( in + 8 );
+
+        const simd outside1 = _mm256_castps_si256( _mm256_or_ps( _mm256_cmp_ps( data1, minValue, _CMP_LT_OQ ), _mm256_cmp_ps( data1, maxValue, _CMP_GT_OQ ) ) );
+        const simd outside2 = _mm256_castps_si256( _mm256_or_ps( _mm256_cmp_ps( data2, minValue, _CMP_LT_OQ ), _mm256_cmp_ps( data2, maxValue, _CMP_GT_OQ ) ) );
+
+        // packing works within 128-bit lanes so 64-bit blocks are reordered to restore the order of pixels
+        const simd outside = _mm256_permute4x64_epi64( _mm256_packs_epi32( outside1, outside2 ), 0xD8 );
+        const simd mask    = _mm256_cmpeq_epi16( outside, _mm256_setzero_si256() );
+
+        return _mm_packs_epi16( _mm256_castsi256_si128( mask ), _mm256_extracti128_si256( mask, 1 ) );
+    }
+
+    template <typename TColorDepth>
+    void Threshold( uint32_t rowSizeIn, uint32_t rowSizeOut, const TColorDepth * inY, uint8_t * outY, const uint8_t * outYEnd,
+                    TColorDepth minThreshold, TColorDepth maxThreshold, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
+    {
+        const simd minValue = thresholdValue( minThreshold );
+        const simd maxValue = thresholdValue( maxThreshold );
+
+        for( ; outY != outYEnd; outY += rowSizeOut, inY += rowSizeIn ) {
+            const TColorDepth * src = inY;
+            __m128i           * dst = reinterpret_cast <__m128i*> (outY);
+
+            const __m128i * dstEnd = dst + simdWidth;
+
+            for( ; dst != dstEnd; ++dst, src += thresholdStep )
+                _mm_storeu_si128( dst, threshold( src, minValue, maxValue ) );
+
+            if( nonSimdWidth > 0 ) {
+                const TColorDepth * inX  = inY + totalSimdWidth;
+                uint8_t           * outX = outY + totalSimdWidth;
+
+                const uint8_t * outXEnd = outX + nonSimdWidth;
+
+                for( ; outX != outXEnd; ++outX, ++inX )
+                    (*outX) = (*inX) < minThreshold || (*inX) > maxThreshold ? 0 : 255;
+            }
+        }
+    }
 #endif
 }
 
-namespace sse
+namespace avx512
 {
-    const uint32_t simdSize = 16u;
+    const uint32_t simdSize = 64u;
 
-#ifdef PENGUINV_SSE_SET
-    typedef __m128i simd;
+#ifdef PENGUINV_AVX512_SET
+    typedef __m512i simd;
+
+    // Aligned load() and store() functions are used only when all rows of all images start at 64-byte boundary
+    // otherwise we are not sure that data is aligned so loadu() and storeu() functions are used
+    template <bool aligned>
+    simd load( const simd * address )
+    {
+        return aligned ? _mm512_load_si512( address ) : _mm512_loadu_si512( address );
+    }
+
+    template <bool aligned>
+    void store( simd * address, simd value )
+    {
+        if( aligned )
+            _mm512_store_si512( address, value );
+        else
+            _mm512_storeu_si512( address, value );
+    }
+
+    // Pixels at the end of a row which do not fill whole SIMD register are processed by masked instructions
+    // Masked load and store do not access memory of disabled bytes so no code is needed for the rest of a row
+    __mmask64 tailMask( uint32_t nonSimdWidth )
+    {
+        return (nonSimdWidth > 0) ? (~static_cast<__mmask64>(0u) >> (64u - nonSimdWidth)) : static_cast<__mmask64>(0u);
+    }
+
+    simd loadTail( const void * address, __mmask64 mask )
+    {
+        return _mm512_maskz_loadu_epi8( mask, address );
+    }
 
-    // We are not sure that input data is aligned by 16 bytes so we use loadu() functions instead of load()
+    void storeTail( void * address, __mmask64 mask, simd value )
+    {
+        _mm512_mask_storeu_epi8( address, mask, value );
+    }
 
+    template <bool aligned>
     void AbsoluteDifference( uint32_t rowSizeIn1, uint32_t rowSizeIn2, uint32_t rowSizeOut, const uint8_t * in1Y, const uint8_t * in2Y,
                              uint8_t * outY, const uint8_t * outYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
     {
+        const __mmask64 mask = tailMask( nonSimdWidth );
+
         for( ; outY != outYEnd; outY += rowSizeOut, in1Y += rowSizeIn1, in2Y += rowSizeIn2 ) {
             const simd * src1 = reinterpret_cast <const simd*> (in1Y);
             const simd * src2 = reinterpret_cast <const simd*> (in2Y);
@@ -458,27 +794,25 @@ namespace sse
             const simd * src1End = src1 + simdWidth;
 
             for( ; src1 != src1End; ++src1, ++src2, ++dst ) {
-                simd data1 = _mm_loadu_si128( src1 );
-                simd data2 = _mm_loadu_si128( src2 );
-                _mm_storeu_si128( dst, _mm_sub_epi8( _mm_max_epu8( data1, data2 ), _mm_min_epu8( data1, data2 ) ) );
+                simd data1 = load<aligned>( src1 );
+                simd data2 = load<aligned>( src2 );
+                store<aligned>( dst, _mm512_sub_epi8( _mm512_max_epu8( data1, data2 ), _mm512_min_epu8( data1, data2 ) ) );
             }
 
             if( nonSimdWidth > 0 ) {
-                const uint8_t * in1X = in1Y + totalSimdWidth;
-                const uint8_t * in2X = in2Y + totalSimdWidth;
-                uint8_t       * outX = outY + totalSimdWidth;
-
-                const uint8_t * outXEnd = outX + nonSimdWidth;
-
-                for( ; outX != outXEnd; ++outX, ++in1X, ++in2X )
-                    (*outX) = (*in2X) > (*in1X) ? (*in2X) - (*in1X) : (*in1X) - (*in2X);
+                simd data1 = loadTail( in1Y + totalSimdWidth, mask );
+                simd data2 = loadTail( in2Y + totalSimdWidth, mask );
+                storeTail( outY + totalSimdWidth, mask, _mm512_sub_epi8( _mm512_max_epu8( data1, data2 ), _mm512_min_epu8( data1, data2 ) ) );
             }
         }
     }
 
+    template <bool aligned>
     void BitwiseAnd( uint32_t rowSizeIn1, uint32_t rowSizeIn2, uint32_t rowSizeOut, const uint8_t * in1Y, const uint8_t * in2Y,
                      uint8_t * outY, const uint8_t * outYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
     {
+        const __mmask64 mask = tailMask( nonSimdWidth );
+
         for( ; outY != outYEnd; outY += rowSizeOut, in1Y += rowSizeIn1, in2Y += rowSizeIn2 ) {
             const simd * src1 = reinterpret_cast <const simd*> (in1Y);
             const simd * src2 = reinterpret_cast <const simd*> (in2Y);
@@ -487,24 +821,19 @@ namespace sse
             const simd * src1End = src1 + simdWidth;
 
             for( ; src1 != src1End; ++src1, ++src2, ++dst )
-                _mm_storeu_si128( dst, _mm_and_si128( _mm_loadu_si128( src1 ), _mm_loadu_si128( src2 ) ) );
-
-            if( nonSimdWidth > 0 ) {
-                const uint8_t * in1X = in1Y + totalSimdWidth;
-                const uint8_t * in2X = in2Y + totalSimdWidth;
-                uint8_t       * outX = outY + totalSimdWidth;
-
-                const uint8_t * outXEnd = outX + nonSimdWidth;
+                store<aligned>( dst, _mm512_and_si512( load<aligned>( src1 ), load<aligned>( src2 ) ) );
 
-                for( ; outX != outXEnd; ++outX, ++in1X, ++in2X )
-                    (*outX) = (*in1X) & (*in2X);
-            }
+            if( nonSimdWidth > 0 )
+                storeTail( outY + totalSimdWidth, mask, _mm512_and_si512( loadTail( in1Y + totalSimdWidth, mask ), loadTail( in2Y + totalSimdWidth, mask ) ) );
         }
     }
 
+    template <bool aligned>
     void BitwiseOr( uint32_t rowSizeIn1, uint32_t rowSizeIn2, uint32_t rowSizeOut, const uint8_t * in1Y, const uint8_t * in2Y,
                     uint8_t * outY, const uint8_t * outYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
     {
+        const __mmask64 mask = tailMask( nonSimdWidth );
+
         for( ; outY != outYEnd; outY += rowSizeOut, in1Y += rowSizeIn1, in2Y += rowSizeIn2 ) {
             const simd * src1 = reinterpret_cast <const simd*> (in1Y);
             const simd * src2 = reinterpret_cast <const simd*> (in2Y);
@@ -513,24 +842,19 @@ namespace sse
             const simd * src1End = src1 + simdWidth;
 
             for( ; src1 != src1End; ++src1, ++src2, ++dst )
-                _mm_storeu_si128( dst, _mm_or_si128( _mm_loadu_si128( src1 ), _mm_loadu_si128( src2 ) ) );
-
-            if( nonSimdWidth > 0 ) {
-                const uint8_t * in1X = in1Y + totalSimdWidth;
-                const uint8_t * in2X = in2Y + totalSimdWidth;
-                uint8_t       * outX = outY + totalSimdWidth;
-
-                const uint8_t * outXEnd = outX + nonSimdWidth;
+                store<aligned>( dst, _mm512_or_si512( load<aligned>( src1 ), load<aligned>( src2 ) ) );
 
-                for( ; outX != outXEnd; ++outX, ++in1X, ++in2X )
-                    (*outX) = (*in1X) | (*in2X);
-            }
+            if( nonSimdWidth > 0 )
+                storeTail( outY + totalSimdWidth, mask, _mm512_or_si512( loadTail( in1Y + totalSimdWidth, mask ), loadTail( in2Y + totalSimdWidth, mask ) ) );
         }
     }
 
+    template <bool aligned>
     void BitwiseXor( uint32_t rowSizeIn1, uint32_t rowSizeIn2, uint32_t rowSizeOut, const uint8_t * in1Y, const uint8_t * in2Y,
                      uint8_t * outY, const uint8_t * outYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
     {
+        const __mmask64 mask = tailMask( nonSimdWidth );
+
         for( ; outY != outYEnd; outY += rowSizeOut, in1Y += rowSizeIn1, in2Y += rowSizeIn2 ) {
             const simd * src1 = reinterpret_cast <const simd*> (in1Y);
             const simd * src2 = reinterpret_cast <const simd*> (in2Y);
@@ -539,27 +863,19 @@ namespace sse
             const simd * src1End = src1 + simdWidth;
 
             for( ; src1 != src1End; ++src1, ++src2, ++dst )
-                _mm_storeu_si128( dst, _mm_xor_si128( _mm_loadu_si128( src1 ), _mm_loadu_si128( src2 ) ) );
-
-            if( nonSimdWidth > 0 ) {
-                const uint8_t * in1X = in1Y + totalSimdWidth;
-                const uint8_t * in2X = in2Y + totalSimdWidth;
-                uint8_t       * outX = outY + totalSimdWidth;
+                store<aligned>( dst, _mm512_xor_si512( load<aligned>( src1 ), load<aligned>( src2 ) ) );
 
-                const uint8_t * outXEnd = outX + nonSimdWidth;
-
-                for( ; outX != outXEnd; ++outX, ++in1X, ++in2X )
-                    (*outX) = (*in1X) ^ (*in2X);
-            }
+            if( nonSimdWidth > 0 )
+                storeTail( outY + totalSimdWidth, mask, _mm512_xor_si512( loadTail( in1Y + totalSimdWidth, mask ), loadTail( in2Y + totalSimdWidth, mask ) ) );
         }
     }
 
+    template <bool aligned>
     void Invert( uint32_t rowSizeIn, uint32_t rowSizeOut, const uint8_t * inY, uint8_t * outY, const uint8_t * outYEnd,
                  uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
     {
-        const char maskValue = static_cast<char>(0xffu);
-        const simd mask = _mm_set_epi8( maskValue, maskValue, maskValue, maskValue, maskValue, maskValue, maskValue, maskValue,
-                                        maskValue, maskValue, maskValue, maskValue, maskValue, maskValue, maskValue, maskValue );
+        const __mmask64 mask = tailMask( nonSimdWidth );
+        const simd notMask = _mm512_set1_epi8( static_cast<char>(0xffu) );
 
         for( ; outY != outYEnd; outY += rowSizeOut, inY += rowSizeIn ) {
             const simd * src1 = reinterpret_cast <const simd*> (inY);
@@ -568,23 +884,70 @@ namespace sse
             const simd * src1End = src1 + simdWidth;
 
             for( ; src1 != src1End; ++src1, ++dst )
-                _mm_storeu_si128( dst, _mm_andnot_si128( _mm_loadu_si128( src1 ), mask ) );
+                store<aligned>( dst, _mm512_xor_si512( load<aligned>( src1 ), notMask ) );
+
+            if( nonSimdWidth > 0 )
+                storeTail( outY + totalSimdWidth, mask, _mm512_xor_si512( loadTail( inY + totalSimdWidth, mask ), notMask ) );
+        }
+    }
+
+    template <bool aligned>
+    void LookupTable( uint32_t rowSizeIn, uint32_t rowSizeOut, const uint8_t * inY, uint8_t * outY, const uint8_t * outYEnd, const uint8_t * table,
+                      uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
+    {
+        // The same approach as for AVX: shuffle instruction works within 128-bit lanes so every 16-byte part of the table
+        // is copied into all 4 lanes and indices are moved to next part of the table at every step
+        simd part[16];
+        uint8_t lanes[64];
+        for( uint32_t i = 0; i < 16u; ++i ) {
+            for( uint32_t lane = 0; lane < 4u; ++lane )
+                memcpy( lanes + lane * 16u, table + i * 16u, sizeof( uint8_t ) * 16u );
+
+            part[i] = _mm512_loadu_si512( reinterpret_cast <const simd*> (lanes) );
+        }
+
+        const simd step   = _mm512_set1_epi8( 16 );
+        const simd offset = _mm512_set1_epi8( 0x70 );
+
+        const __mmask64 mask = tailMask( nonSimdWidth );
+
+        for( ; outY != outYEnd; outY += rowSizeOut, inY += rowSizeIn ) {
+            const simd * src    = reinterpret_cast <const simd*> (inY);
+            simd       * dst    = reinterpret_cast <simd*> (outY);
+            const simd * srcEnd = src + simdWidth;
+
+            for( ; src != srcEnd; ++src, ++dst ) {
+                simd index  = load<aligned>( src );
+                simd result = _mm512_shuffle_epi8( part[0], _mm512_adds_epu8( index, offset ) );
+
+                for( uint32_t i = 1; i < 16u; ++i ) {
+                    index  = _mm512_sub_epi8( index, step );
+                    result = _mm512_or_si512( result, _mm512_shuffle_epi8( part[i], _mm512_adds_epu8( index, offset ) ) );
+                }
+
+                store<aligned>( dst, result );
+            }
 
             if( nonSimdWidth > 0 ) {
-                const uint8_t * inX  = inY  + totalSimdWidth;
-                uint8_t       * outX = outY + totalSimdWidth;
+                simd index  = loadTail( inY + totalSimdWidth, mask );
+                simd result = _mm512_shuffle_epi8( part[0], _mm512_adds_epu8( index, offset ) );
 
-                const uint8_t * outXEnd = outX + nonSimdWidth;
+                for( uint32_t i = 1; i < 16u; ++i ) {
+                    index  = _mm512_sub_epi8( index, step );
+                    result = _mm512_or_si512( result, _mm512_shuffle_epi8( part[i], _mm512_adds_epu8( index, offset ) ) );
+                }
 
-                for( ; outX != outXEnd; ++outX, ++inX )
-                    (*outX) = ~(*inX);
+                storeTail( outY + totalSimdWidth, mask, result );
             }
         }
     }
 
+    template <bool aligned>
     void Maximum( uint32_t rowSizeIn1, uint32_t rowSizeIn2, uint32_t rowSizeOut, const uint8_t * in1Y, const uint8_t * in2Y,
                   uint8_t * outY, const uint8_t * outYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
     {
+        const __mmask64 mask = tailMask( nonSimdWidth );
+
         for( ; outY != outYEnd; outY += rowSizeOut, in1Y += rowSizeIn1, in2Y += rowSizeIn2 ) {
             const simd * src1 = reinterpret_cast <const simd*> (in1Y);
             const simd * src2 = reinterpret_cast <const simd*> (in2Y);
@@ -593,28 +956,19 @@ namespace sse
             const simd * src1End = src1 + simdWidth;
 
             for( ; src1 != src1End; ++src1, ++src2, ++dst )
-                _mm_storeu_si128( dst, _mm_max_epu8( _mm_loadu_si128( src1 ), _mm_loadu_si128( src2 ) ) );
-
-            if( nonSimdWidth > 0 ) {
-                const uint8_t * in1X = in1Y + totalSimdWidth;
-                const uint8_t * in2X = in2Y + totalSimdWidth;
-                uint8_t       * outX = outY + totalSimdWidth;
-
-                const uint8_t * outXEnd = outX + nonSimdWidth;
+                store<aligned>( dst, _mm512_max_epu8( load<aligned>( src1 ), load<aligned>( src2 ) ) );
 
-                for( ; outX != outXEnd; ++outX, ++in1X, ++in2X ) {
-                    if( (*in2X) < (*in1X) )
-                        (*outX) = (*in1X);
-                    else
-                        (*outX) = (*in2X);
-                }
-            }
+            if( nonSimdWidth > 0 )
+                storeTail( outY + totalSimdWidth, mask, _mm512_max_epu8( loadTail( in1Y + totalSimdWidth, mask ), loadTail( in2Y + totalSimdWidth, mask ) ) );
         }
     }
 
+    template <bool aligned>
     void Minimum( uint32_t rowSizeIn1, uint32_t rowSizeIn2, uint32_t rowSizeOut, const uint8_t * in1Y, const uint8_t * in2Y,
                   uint8_t * outY, const uint8_t * outYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
     {
+        const __mmask64 mask = tailMask( nonSimdWidth );
+
         for( ; outY != outYEnd; outY += rowSizeOut, in1Y += rowSizeIn1, in2Y += rowSizeIn2 ) {
             const simd * src1 = reinterpret_cast <const simd*> (in1Y);
             const simd * src2 = reinterpret_cast <const simd*> (in2Y);
@@ -623,42 +977,512 @@ namespace sse
             const simd * src1End = src1 + simdWidth;
 
             for( ; src1 != src1End; ++src1, ++src2, ++dst )
-                _mm_storeu_si128( dst, _mm_min_epu8( _mm_loadu_si128( src1 ), _mm_loadu_si128( src2 ) ) );
-
-            if( nonSimdWidth > 0 ) {
-                const uint8_t * in1X = in1Y + totalSimdWidth;
-                const uint8_t * in2X = in2Y + totalSimdWidth;
-                uint8_t       * outX = outY + totalSimdWidth;
+                store<aligned>( dst, _mm512_min_epu8( load<aligned>( src1 ), load<aligned>( src2 ) ) );
 
-                const uint8_t * outXEnd = outX + nonSimdWidth;
-
-                for( ; outX != outXEnd; ++outX, ++in1X, ++in2X ) {
-                    if( (*in2X) > (*in1X) )
-                        (*outX) = (*in1X);
-                    else
-                        (*outX) = (*in2X);
-                }
-            }
+            if( nonSimdWidth > 0 )
+                storeTail( outY + totalSimdWidth, mask, _mm512_min_epu8( loadTail( in1Y + totalSimdWidth, mask ), loadTail( in2Y + totalSimdWidth, mask ) ) );
         }
     }
 
-    void Subtract( uint32_t rowSizeIn1, uint32_t rowSizeIn2, uint32_t rowSizeOut, const uint8_t * in1Y, const uint8_t * in2Y,
-                   uint8_t * outY, const uint8_t * outYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
+    template <bool aligned>
+    void MinimumMaximum( uint32_t rowSize, const uint8_t * imageY, const uint8_t * imageYEnd, uint32_t simdWidth, uint32_t totalSimdWidth,
+                         uint32_t nonSimdWidth, uint8_t & minimum, uint8_t & maximum )
     {
-        for( ; outY != outYEnd; outY += rowSizeOut, in1Y += rowSizeIn1, in2Y += rowSizeIn2 ) {
-            const simd * src1 = reinterpret_cast <const simd*> (in1Y);
-            const simd * src2 = reinterpret_cast <const simd*> (in2Y);
-            simd       * dst  = reinterpret_cast <simd*> (outY);
+        simd simdMinimum = _mm512_set1_epi8( static_cast<char>(minimum) );
+        simd simdMaximum = _mm512_set1_epi8( static_cast<char>(maximum) );
 
-            const simd * src1End = src1 + simdWidth;
+        const __mmask64 mask = tailMask( nonSimdWidth );
 
-            for( ; src1 != src1End; ++src1, ++src2, ++dst ) {
-                simd data = _mm_loadu_si128( src1 );
-                _mm_storeu_si128( dst, _mm_sub_epi8( data, _mm_min_epu8( data, _mm_loadu_si128( src2 ) ) ) );
+        for( ; imageY != imageYEnd; imageY += rowSize ) {
+            const simd * src    = reinterpret_cast <const simd*> (imageY);
+            const simd * srcEnd = src + simdWidth;
+
+            for( ; src != srcEnd; ++src ) {
+                const simd data = load<aligned>( src );
+
+                simdMinimum = _mm512_min_epu8( simdMinimum, data );
+                simdMaximum = _mm512_max_epu8( simdMaximum, data );
             }
 
+            // Disabled bytes keep previous minimum and maximum values
             if( nonSimdWidth > 0 ) {
-                const uint8_t * in1X = in1Y + totalSimdWidth;
+                const simd data = loadTail( imageY + totalSimdWidth, mask );
+
+                simdMinimum = _mm512_mask_min_epu8( simdMinimum, mask, simdMinimum, data );
+                simdMaximum = _mm512_mask_max_epu8( simdMaximum, mask, simdMaximum, data );
+            }
+        }
+
+        uint8_t outputMinimum[64] = { 0 };
+        uint8_t outputMaximum[64] = { 0 };
+
+        _mm512_storeu_si512( reinterpret_cast <simd*>(outputMinimum), simdMinimum );
+        _mm512_storeu_si512( reinterpret_cast <simd*>(outputMaximum), simdMaximum );
+
+        for( uint32_t i = 0; i < 64u; ++i ) {
+            if( minimum > outputMinimum[i] )
+                minimum = outputMinimum[i];
+
+            if( maximum < outputMaximum[i] )
+                maximum = outputMaximum[i];
+        }
+    }
+
+    template <bool aligned>
+    void Subtract( uint32_t rowSizeIn1, uint32_t rowSizeIn2, uint32_t rowSizeOut, const uint8_t * in1Y, const uint8_t * in2Y,
+                   uint8_t * outY, const uint8_t * outYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
+    {
+        const __mmask64 mask = tailMask( nonSimdWidth );
+
+        for( ; outY != outYEnd; outY += rowSizeOut, in1Y += rowSizeIn1, in2Y += rowSizeIn2 ) {
+            const simd * src1 = reinterpret_cast <const simd*> (in1Y);
+            const simd * src2 = reinterpret_cast <const simd*> (in2Y);
+            simd       * dst  = reinterpret_cast <simd*> (outY);
+
+            const simd * src1End = src1 + simdWidth;
+
+            for( ; src1 != src1End; ++src1, ++src2, ++dst )
+                store<aligned>( dst, _mm512_subs_epu8( load<aligned>( src1 ), load<aligned>( src2 ) ) );
+
+            if( nonSimdWidth > 0 )
+                storeTail( outY + totalSimdWidth, mask, _mm512_subs_epu8( loadTail( in1Y + totalSimdWidth, mask ), loadTail( in2Y + totalSimdWidth, mask ) ) );
+        }
+    }
+
+    template <bool aligned>
+    uint32_t Sum( uint32_t rowSize, const uint8_t * imageY, const uint8_t * imageYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
+    {
+        // Sum of absolute differences with zero gives sums of every 8 bytes as 64-bit values
+        // Disabled bytes of masked load are set to zero so they do not change the sum
+        simd simdSum = _mm512_setzero_si512();
+        const simd zero = _mm512_setzero_si512();
+
+        const __mmask64 mask = tailMask( nonSimdWidth );
+
+        for( ; imageY != imageYEnd; imageY += rowSize ) {
+            const simd * src    = reinterpret_cast <const simd*> (imageY);
+            const simd * srcEnd = src + simdWidth;
+
+            for( ; src != srcEnd; ++src )
+                simdSum = _mm512_add_epi64( simdSum, _mm512_sad_epu8( load<aligned>( src ), zero ) );
+
+            if( nonSimdWidth > 0 )
+                simdSum = _mm512_add_epi64( simdSum, _mm512_sad_epu8( loadTail( imageY + totalSimdWidth, mask ), zero ) );
+        }
+
+        uint64_t output[8] = { 0 };
+
+        _mm512_storeu_si512( reinterpret_cast <simd*>(output), simdSum );
+
+        return static_cast<uint32_t>( output[0] + output[1] + output[2] + output[3] + output[4] + output[5] + output[6] + output[7] );
+    }
+
+    template <bool aligned>
+    void Threshold( uint32_t rowSizeIn, uint32_t rowSizeOut, const uint8_t * inY, uint8_t * outY, const uint8_t * outYEnd, uint8_t threshold,
+                    uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
+    {
+        // AVX-512 has unsigned comparison which returns a mask of bytes so no tricks with a sign bit are needed
+        const simd compare = _mm512_set1_epi8( static_cast<char>(threshold) );
+
+        const __mmask64 mask = tailMask( nonSimdWidth );
+
+        for( ; outY != outYEnd; outY += rowSizeOut, inY += rowSizeIn ) {
+            const simd * src1 = reinterpret_cast <const simd*> (inY);
+            simd       * dst  = reinterpret_cast <simd*> (outY);
+
+            const simd * src1End = src1 + simdWidth;
+
+            for( ; src1 != src1End; ++src1, ++dst )
+                store<aligned>( dst, _mm512_movm_epi8( _mm512_cmpge_epu8_mask( load<aligned>( src1 ), compare ) ) );
+
+            if( nonSimdWidth > 0 )
+                storeTail( outY + totalSimdWidth, mask, _mm512_movm_epi8( _mm512_cmpge_epu8_mask( loadTail( inY + totalSimdWidth, mask ), compare ) ) );
+        }
+    }
+
+    template <bool aligned>
+    void Threshold( uint32_t rowSizeIn, uint32_t rowSizeOut, const uint8_t * inY, uint8_t * outY, const uint8_t * outYEnd, uint8_t minThreshold, uint8_t maxThreshold,
+                    uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
+    {
+        const simd minCompare = _mm512_set1_epi8( static_cast<char>(minThreshold) );
+        const simd maxCompare = _mm512_set1_epi8( static_cast<char>(maxThreshold) );
+
+        const __mmask64 mask = tailMask( nonSimdWidth );
+
+        for( ; outY != outYEnd; outY += rowSizeOut, inY += rowSizeIn ) {
+            const simd * src1 = reinterpret_cast <const simd*> (inY);
+            simd       * dst  = reinterpret_cast <simd*> (outY);
+
+            const simd * src1End = src1 + simdWidth;
+
+            for( ; src1 != src1End; ++src1, ++dst ) {
+                const simd data = load<aligned>( src1 );
+                store<aligned>( dst, _mm512_movm_epi8( _mm512_cmpge_epu8_mask( data, minCompare ) & _mm512_cmple_epu8_mask( data, maxCompare ) ) );
+            }
+
+            if( nonSimdWidth > 0 ) {
+                const simd data = loadTail( inY + totalSimdWidth, mask );
+                storeTail( outY + totalSimdWidth, mask,
+                           _mm512_movm_epi8( _mm512_cmpge_epu8_mask( data, minCompare ) & _mm512_cmple_epu8_mask( data, maxCompare ) ) );
+            }
+        }
+    }
+
+    // Operations for images with 16-bit and floating point pixels. Floating point values are passed in integer registers
+    // so the same load() and store() functions are used for all types of pixels. The last parameter defines pixel type
+    template <BinaryOperation operation>
+    simd calculate( simd data1, simd data2, uint16_t )
+    {
+        switch( operation ) {
+            case ABSOLUTE_DIFFERENCE:
+                return _mm512_sub_epi16( _mm512_max_epu16( data1, data2 ), _mm512_min_epu16( data1, data2 ) );
+            case MAXIMUM:
+                return _mm512_max_epu16( data1, data2 );
+            case MINIMUM:
+                return _mm512_min_epu16( data1, data2 );
+            case SUBTRACT:
+            default:
+                return _mm512_subs_epu16( data1, data2 );
+        }
+    }
+
+    // Comparison masks select values exactly as CPU code does
+    template <BinaryOperation operation>
+    simd calculate( simd data1, simd data2, float )
+    {
+        const __m512 value1 = _mm512_castsi512_ps( data1 );
+        const __m512 value2 = _mm512_castsi512_ps( data2 );
+
+        switch( operation ) {
+            case ABSOLUTE_DIFFERENCE:
+                return _mm512_castps_si512( _mm512_mask_blend_ps( _mm512_cmp_ps_mask( value2, value1, _CMP_GT_OQ ), _mm512_sub_ps( value1, value2 ),
+                                                                  _mm512_sub_ps( value2, value1 ) ) );
+            case MAXIMUM:
+                return _mm512_castps_si512( _mm512_mask_blend_ps( _mm512_cmp_ps_mask( value1, value2, _CMP_GT_OQ ), value2, value1 ) );
+            case MINIMUM:
+                return _mm512_castps_si512( _mm512_mask_blend_ps( _mm512_cmp_ps_mask( value1, value2, _CMP_LT_OQ ), value2, value1 ) );
+            case SUBTRACT:
+            default:
+                return _mm512_castps_si512( _mm512_sub_ps( value1, value2 ) );
+        }
+    }
+
+    template <bool aligned, BinaryOperation operation, typename TColorDepth>
+    void Calculate( uint32_t rowSizeIn1, uint32_t rowSizeIn2, uint32_t rowSizeOut, const TColorDepth * in1Y, const TColorDepth * in2Y,
+                    TColorDepth * outY, const TColorDepth * outYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
+    {
+        // The mask is set per byte so it covers all bytes of remaining pixels
+        const __mmask64 mask = tailMask( nonSimdWidth * static_cast<uint32_t>(sizeof( TColorDepth )) );
+
+        for( ; outY != outYEnd; outY += rowSizeOut, in1Y += rowSizeIn1, in2Y += rowSizeIn2 ) {
+            const simd * src1 = reinterpret_cast <const simd*> (in1Y);
+            const simd * src2 = reinterpret_cast <const simd*> (in2Y);
+            simd       * dst  = reinterpret_cast <simd*> (outY);
+
+            const simd * src1End = src1 + simdWidth;
+
+            for( ; src1 != src1End; ++src1, ++src2, ++dst )
+                store<aligned>( dst, calculate<operation>( load<aligned>( src1 ), load<aligned>( src2 ), TColorDepth() ) );
+
+            if( nonSimdWidth > 0 )
+                storeTail( outY + totalSimdWidth, mask, calculate<operation>( loadTail( in1Y + totalSimdWidth, mask ), loadTail( in2Y + totalSimdWidth, mask ),
+                                                                              TColorDepth() ) );
+        }
+    }
+#endif
+}
+
+namespace sse
+{
+    const uint32_t simdSize = 16u;
+
+#ifdef PENGUINV_SSE_SET
+    typedef __m128i simd;
+
+    // Aligned load() and store() functions are used only when all rows of all images start at 16-byte boundary
+    // otherwise we are not sure that data is aligned so loadu() and storeu() functions are used
+    template <bool aligned>
+    simd load( const simd * address )
+    {
+        return aligned ? _mm_load_si128( address ) : _mm_loadu_si128( address );
+    }
+
+    template <bool aligned>
+    void store( simd * address, simd value )
+    {
+        if( aligned )
+            _mm_store_si128( address, value );
+        else
+            _mm_storeu_si128( address, value );
+    }
+
+    template <bool aligned>
+    void AbsoluteDifference( uint32_t rowSizeIn1, uint32_t rowSizeIn2, uint32_t rowSizeOut, const uint8_t * in1Y, const uint8_t * in2Y,
+                             uint8_t * outY, const uint8_t * outYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
+    {
+        for( ; outY != outYEnd; outY += rowSizeOut, in1Y += rowSizeIn1, in2Y += rowSizeIn2 ) {
+            const simd * src1 = reinterpret_cast <const simd*> (in1Y);
+            const simd * src2 = reinterpret_cast <const simd*> (in2Y);
+            simd       * dst  = reinterpret_cast <simd*> (outY);
+
+            const simd * src1End = src1 + simdWidth;
+
+            for( ; src1 != src1End; ++src1, ++src2, ++dst ) {
+                simd data1 = load<aligned>( src1 );
+                simd data2 = load<aligned>( src2 );
+                store<aligned>( dst, _mm_sub_epi8( _mm_max_epu8( data1, data2 ), _mm_min_epu8( data1, data2 ) ) );
+            }
+
+            if( nonSimdWidth > 0 ) {
+                const uint8_t * in1X = in1Y + totalSimdWidth;
+                const uint8_t * in2X = in2Y + totalSimdWidth;
+                uint8_t       * outX = outY + totalSimdWidth;
+
+                const uint8_t * outXEnd = outX + nonSimdWidth;
+
+                for( ; outX != outXEnd; ++outX, ++in1X, ++in2X )
+                    (*outX) = (*in2X) > (*in1X) ? (*in2X) - (*in1X) : (*in1X) - (*in2X);
+            }
+        }
+    }
+
+    template <bool aligned>
+    void BitwiseAnd( uint32_t rowSizeIn1, uint32_t rowSizeIn2, uint32_t rowSizeOut, const uint8_t * in1Y, const uint8_t * in2Y,
+                     uint8_t * outY, const uint8_t * outYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
+    {
+        for( ; outY != outYEnd; outY += rowSizeOut, in1Y += rowSizeIn1, in2Y += rowSizeIn2 ) {
+            const simd * src1 = reinterpret_cast <const simd*> (in1Y);
+            const simd * src2 = reinterpret_cast <const simd*> (in2Y);
+            simd       * dst  = reinterpret_cast <simd*> (outY);
+
+            const simd * src1End = src1 + simdWidth;
+
+            for( ; src1 != src1End; ++src1, ++src2, ++dst )
+                store<aligned>( dst, _mm_and_si128( load<aligned>( src1 ), load<aligned>( src2 ) ) );
+
+            if( nonSimdWidth > 0 ) {
+                const uint8_t * in1X = in1Y + totalSimdWidth;
+                const uint8_t * in2X = in2Y + totalSimdWidth;
+                uint8_t       * outX = outY + totalSimdWidth;
+
+                const uint8_t * outXEnd = outX + nonSimdWidth;
+
+                for( ; outX != outXEnd; ++outX, ++in1X, ++in2X )
+                    (*outX) = (*in1X) & (*in2X);
+            }
+        }
+    }
+
+    template <bool aligned>
+    void BitwiseOr( uint32_t rowSizeIn1, uint32_t rowSizeIn2, uint32_t rowSizeOut, const uint8_t * in1Y, const uint8_t * in2Y,
+                    uint8_t * outY, const uint8_t * outYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
+    {
+        for( ; outY != outYEnd; outY += rowSizeOut, in1Y += rowSizeIn1, in2Y += rowSizeIn2 ) {
+            const simd * src1 = reinterpret_cast <const simd*> (in1Y);
+            const simd * src2 = reinterpret_cast <const simd*> (in2Y);
+            simd       * dst  = reinterpret_cast <simd*> (outY);
+
+            const simd * src1End = src1 + simdWidth;
+
+            for( ; src1 != src1End; ++src1, ++src2, ++dst )
+                store<aligned>( dst, _mm_or_si128( load<aligned>( src1 ), load<aligned>( src2 ) ) );
+
+            if( nonSimdWidth > 0 ) {
+                const uint8_t * in1X = in1Y + totalSimdWidth;
+                const uint8_t * in2X = in2Y + totalSimdWidth;
+                uint8_t       * outX = outY + totalSimdWidth;
+
+                const uint8_t * outXEnd = outX + nonSimdWidth;
+
+                for( ; outX != outXEnd; ++outX, ++in1X, ++in2X )
+                    (*outX) = (*in1X) | (*in2X);
+            }
+        }
+    }
+
+    template <bool aligned>
+    void BitwiseXor( uint32_t rowSizeIn1, uint32_t rowSizeIn2, uint32_t rowSizeOut, const uint8_t * in1Y, const uint8_t * in2Y,
+                     uint8_t * outY, const uint8_t * outYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
+    {
+        for( ; outY != outYEnd; outY += rowSizeOut, in1Y += rowSizeIn1, in2Y += rowSizeIn2 ) {
+            const simd * src1 = reinterpret_cast <const simd*> (in1Y);
+            const simd * src2 = reinterpret_cast <const simd*> (in2Y);
+            simd       * dst  = reinterpret_cast <simd*> (outY);
+
+            const simd * src1End = src1 + simdWidth;
+
+            for( ; src1 != src1End; ++src1, ++src2, ++dst )
+                store<aligned>( dst, _mm_xor_si128( load<aligned>( src1 ), load<aligned>( src2 ) ) );
+
+            if( nonSimdWidth > 0 ) {
+                const uint8_t * in1X = in1Y + totalSimdWidth;
+                const uint8_t * in2X = in2Y + totalSimdWidth;
+                uint8_t       * outX = outY + totalSimdWidth;
+
+                const uint8_t * outXEnd = outX + nonSimdWidth;
+
+                for( ; outX != outXEnd; ++outX, ++in1X, ++in2X )
+                    (*outX) = (*in1X) ^ (*in2X);
+            }
+        }
+    }
+
+    template <bool aligned>
+    void Invert( uint32_t rowSizeIn, uint32_t rowSizeOut, const uint8_t * inY, uint8_t * outY, const uint8_t * outYEnd,
+                 uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
+    {
+        const char maskValue = static_cast<char>(0xffu);
+        const simd mask = _mm_set_epi8( maskValue, maskValue, maskValue, maskValue, maskValue, maskValue, maskValue, maskValue,
+                                        maskValue, maskValue, maskValue, maskValue, maskValue, maskValue, maskValue, maskValue );
+
+        for( ; outY != outYEnd; outY += rowSizeOut, inY += rowSizeIn ) {
+            const simd * src1 = reinterpret_cast <const simd*> (inY);
+            simd       * dst  = reinterpret_cast <simd*> (outY);
+
+            const simd * src1End = src1 + simdWidth;
+
+            for( ; src1 != src1End; ++src1, ++dst )
+                store<aligned>( dst, _mm_andnot_si128( load<aligned>( src1 ), mask ) );
+
+            if( nonSimdWidth > 0 ) {
+                const uint8_t * inX  = inY  + totalSimdWidth;
+                uint8_t       * outX = outY + totalSimdWidth;
+
+                const uint8_t * outXEnd = outX + nonSimdWidth;
+
+                for( ; outX != outXEnd; ++outX, ++inX )
+                    (*outX) = ~(*inX);
+            }
+        }
+    }
+
+    template <bool aligned>
+    void Maximum( uint32_t rowSizeIn1, uint32_t rowSizeIn2, uint32_t rowSizeOut, const uint8_t * in1Y, const uint8_t * in2Y,
+                  uint8_t * outY, const uint8_t * outYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
+    {
+        for( ; outY != outYEnd; outY += rowSizeOut, in1Y += rowSizeIn1, in2Y += rowSizeIn2 ) {
+            const simd * src1 = reinterpret_cast <const simd*> (in1Y);
+            const simd * src2 = reinterpret_cast <const simd*> (in2Y);
+            simd       * dst  = reinterpret_cast <simd*> (outY);
+
+            const simd * src1End = src1 + simdWidth;
+
+            for( ; src1 != src1End; ++src1, ++src2, ++dst )
+                store<aligned>( dst, _mm_max_epu8( load<aligned>( src1 ), load<aligned>( src2 ) ) );
+
+            if( nonSimdWidth > 0 ) {
+                const uint8_t * in1X = in1Y + totalSimdWidth;
+                const uint8_t * in2X = in2Y + totalSimdWidth;
+                uint8_t       * outX = outY + totalSimdWidth;
+
+                const uint8_t * outXEnd = outX + nonSimdWidth;
+
+                for( ; outX != outXEnd; ++outX, ++in1X, ++in2X ) {
+                    if( (*in2X) < (*in1X) )
+                        (*outX) = (*in1X);
+                    else
+                        (*outX) = (*in2X);
+                }
+            }
+        }
+    }
+
+    template <bool aligned>
+    void Minimum( uint32_t rowSizeIn1, uint32_t rowSizeIn2, uint32_t rowSizeOut, const uint8_t * in1Y, const uint8_t * in2Y,
+                  uint8_t * outY, const uint8_t * outYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
+    {
+        for( ; outY != outYEnd; outY += rowSizeOut, in1Y += rowSizeIn1, in2Y += rowSizeIn2 ) {
+            const simd * src1 = reinterpret_cast <const simd*> (in1Y);
+            const simd * src2 = reinterpret_cast <const simd*> (in2Y);
+            simd       * dst  = reinterpret_cast <simd*> (outY);
+
+            const simd * src1End = src1 + simdWidth;
+
+            for( ; src1 != src1End; ++src1, ++src2, ++dst )
+                store<aligned>( dst, _mm_min_epu8( load<aligned>( src1 ), load<aligned>( src2 ) ) );
+
+            if( nonSimdWidth > 0 ) {
+                const uint8_t * in1X = in1Y + totalSimdWidth;
+                const uint8_t * in2X = in2Y + totalSimdWidth;
+                uint8_t       * outX = outY + totalSimdWidth;
+
+                const uint8_t * outXEnd = outX + nonSimdWidth;
+
+                for( ; outX != outXEnd; ++outX, ++in1X, ++in2X ) {
+                    if( (*in2X) > (*in1X) )
+                        (*outX) = (*in1X);
+                    else
+                        (*outX) = (*in2X);
+                }
+            }
+        }
+    }
+
+    template <bool aligned>
+    void MinimumMaximum( uint32_t rowSize, const uint8_t * imageY, const uint8_t * imageYEnd, uint32_t simdWidth, uint32_t totalSimdWidth,
+                         uint32_t nonSimdWidth, uint8_t & minimum, uint8_t & maximum )
+    {
+        simd simdMinimum = _mm_set1_epi8( static_cast<char>(minimum) );
+        simd simdMaximum = _mm_set1_epi8( static_cast<char>(maximum) );
+
+        for( ; imageY != imageYEnd; imageY += rowSize ) {
+            const simd * src    = reinterpret_cast <const simd*> (imageY);
+            const simd * srcEnd = src + simdWidth;
+
+            for( ; src != srcEnd; ++src ) {
+                const simd data = load<aligned>( src );
+
+                simdMinimum = _mm_min_epu8( simdMinimum, data );
+                simdMaximum = _mm_max_epu8( simdMaximum, data );
+            }
+
+            if( nonSimdWidth > 0 ) {
+                const uint8_t * imageX    = imageY + totalSimdWidth;
+                const uint8_t * imageXEnd = imageX + nonSimdWidth;
+
+                for( ; imageX != imageXEnd; ++imageX ) {
+                    if( minimum > (*imageX) )
+                        minimum = (*imageX);
+
+                    if( maximum < (*imageX) )
+                        maximum = (*imageX);
+                }
+            }
+        }
+
+        uint8_t outputMinimum[16] = { 0 };
+        uint8_t outputMaximum[16] = { 0 };
+
+        _mm_storeu_si128( reinterpret_cast <simd*>(outputMinimum), simdMinimum );
+        _mm_storeu_si128( reinterpret_cast <simd*>(outputMaximum), simdMaximum );
+
+        for( uint32_t i = 0; i < 16u; ++i ) {
+            if( minimum > outputMinimum[i] )
+                minimum = outputMinimum[i];
+
+            if( maximum < outputMaximum[i] )
+                maximum = outputMaximum[i];
+        }
+    }
+
+    template <bool aligned>
+    void Subtract( uint32_t rowSizeIn1, uint32_t rowSizeIn2, uint32_t rowSizeOut, const uint8_t * in1Y, const uint8_t * in2Y,
+                   uint8_t * outY, const uint8_t * outYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
+    {
+        for( ; outY != outYEnd; outY += rowSizeOut, in1Y += rowSizeIn1, in2Y += rowSizeIn2 ) {
+            const simd * src1 = reinterpret_cast <const simd*> (in1Y);
+            const simd * src2 = reinterpret_cast <const simd*> (in2Y);
+            simd       * dst  = reinterpret_cast <simd*> (outY);
+
+            const simd * src1End = src1 + simdWidth;
+
+            for( ; src1 != src1End; ++src1, ++src2, ++dst ) {
+                simd data = load<aligned>( src1 );
+                store<aligned>( dst, _mm_sub_epi8( data, _mm_min_epu8( data, load<aligned>( src2 ) ) ) );
+            }
+
+            if( nonSimdWidth > 0 ) {
+                const uint8_t * in1X = in1Y + totalSimdWidth;
                 const uint8_t * in2X = in2Y + totalSimdWidth;
                 uint8_t       * outX = outY + totalSimdWidth;
 
@@ -674,6 +1498,7 @@ namespace sse
         }
     }
 
+    template <bool aligned>
     uint32_t Sum( uint32_t rowSize, const uint8_t * imageY,const uint8_t * imageYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
     {
         uint32_t sum = 0;
@@ -685,7 +1510,7 @@ namespace sse
             const simd * srcEnd = src + simdWidth;
 
             for( ; src != srcEnd; ++src ) {
-                simd data = _mm_loadu_si128( src );
+                simd data = load<aligned>( src );
 
                 simd dataLo  = _mm_unpacklo_epi8( data, zero );
                 simd dataHi  = _mm_unpackhi_epi8( data, zero );
@@ -711,6 +1536,7 @@ namespace sse
         return sum + output[0] + output[1] + output[2] + output[3];
     }
 
+    template <bool aligned>
     void Threshold( uint32_t rowSizeIn, uint32_t rowSizeOut, const uint8_t * inY, uint8_t * outY, const uint8_t * outYEnd, uint8_t threshold,
                     uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
     {
@@ -735,7 +1561,7 @@ namespace sse
                 const simd * src1End = src1 + simdWidth;
 
                 for( ; src1 != src1End; ++src1, ++dst )
-                    _mm_storeu_si128( dst, _mm_cmpgt_epi8( _mm_xor_si128( _mm_loadu_si128( src1 ), mask ), compare ) );
+                    store<aligned>( dst, _mm_cmpgt_epi8( _mm_xor_si128( load<aligned>( src1 ), mask ), compare ) );
 
                 if( nonSimdWidth > 0 ) {
                     const uint8_t * inX  = inY  + totalSimdWidth;
@@ -754,6 +1580,7 @@ namespace sse
         }
     }
 
+    template <bool aligned>
     void Threshold( uint32_t rowSizeIn, uint32_t rowSizeOut, const uint8_t * inY, uint8_t * outY, const uint8_t * outYEnd, uint8_t minThreshold, uint8_t maxThreshold,
                     uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
     {
@@ -790,9 +1617,9 @@ namespace sse
             const simd * src1End = src1 + simdWidth;
 
             for( ; src1 != src1End; ++src1, ++dst ) {
-                simd data = _mm_xor_si128( _mm_loadu_si128( src1 ), shiftMask );
+                simd data = _mm_xor_si128( load<aligned>( src1 ), shiftMask );
 
-                _mm_storeu_si128( dst, _mm_andnot_si128(
+                store<aligned>( dst, _mm_andnot_si128(
                     _mm_or_si128(
                         _mm_cmplt_epi8( data, minCompare ),
                         _mm_cmpgt_epi8( data, maxCompare ) ),
@@ -810,6 +1637,139 @@ namespace sse
             }
         }
     }
+
+    // Operations for images with 16-bit and floating point pixels. Floating point values are passed in integer registers
+    // so the same load() and store() functions are used for all types of pixels. The last parameter defines pixel type
+    // SSE2 has no maximum and minimum instructions for unsigned 16-bit values so they are calculated through saturated subtraction
+    template <BinaryOperation operation>
+    simd calculate( simd data1, simd data2, uint16_t )
+    {
+        switch( operation ) {
+            case ABSOLUTE_DIFFERENCE:
+                return _mm_or_si128( _mm_subs_epu16( data1, data2 ), _mm_subs_epu16( data2, data1 ) );
+            case MAXIMUM:
+                return _mm_add_epi16( _mm_subs_epu16( data1, data2 ), data2 );
+            case MINIMUM:
+                return _mm_sub_epi16( data1, _mm_subs_epu16( data1, data2 ) );
+            case SUBTRACT:
+            default:
+                return _mm_subs_epu16( data1, data2 );
+        }
+    }
+
+    template <BinaryOperation operation>
+    simd calculate( simd data1, simd data2, float )
+    {
+        const __m128 value1 = _mm_castsi128_ps( data1 );
+        const __m128 value2 = _mm_castsi128_ps( data2 );
+
+        switch( operation ) {
+            case ABSOLUTE_DIFFERENCE:
+                return _mm_castps_si128( _mm_sub_ps( _mm_max_ps( value1, value2 ), _mm_min_ps( value1, value2 ) ) );
+            case MAXIMUM:
+                return _mm_castps_si128( _mm_max_ps( value1, value2 ) );
+            case MINIMUM:
+                return _mm_castps_si128( _mm_min_ps( value1, value2 ) );
+            case SUBTRACT:
+            default:
+                return _mm_castps_si128( _mm_sub_ps( value1, value2 ) );
+        }
+    }
+
+    template <bool aligned, BinaryOperation operation, typename TColorDepth>
+    void Calculate( uint32_t rowSizeIn1, uint32_t rowSizeIn2, uint32_t rowSizeOut, const TColorDepth * in1Y, const TColorDepth * in2Y,
+                    TColorDepth * outY, const TColorDepth * outYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
+    {
+        for( ; outY != outYEnd; outY += rowSizeOut, in1Y += rowSizeIn1, in2Y += rowSizeIn2 ) {
+            const simd * src1 = reinterpret_cast <const simd*> (in1Y);
+            const simd * src2 = reinterpret_cast <const simd*> (in2Y);
+            simd       * dst  = reinterpret_cast <simd*> (outY);
+
+            const simd * src1End = src1 + simdWidth;
+
+            for( ; src1 != src1End; ++src1, ++src2, ++dst )
+                store<aligned>( dst, calculate<operation>( load<aligned>( src1 ), load<aligned>( src2 ), TColorDepth() ) );
+
+            if( nonSimdWidth > 0 ) {
+                const TColorDepth * in1X = in1Y + totalSimdWidth;
+                const TColorDepth * in2X = in2Y + totalSimdWidth;
+                TColorDepth       * outX = outY + totalSimdWidth;
+
+                const TColorDepth * outXEnd = outX + nonSimdWidth;
+
+                for( ; outX != outXEnd; ++outX, ++in1X, ++in2X )
+                    (*outX) = ::calculate<operation>( *in1X, *in2X );
+            }
+        }
+    }
+
+    // Thresholding of images with 16-bit and floating point pixels works in the same way as AVX code does
+    const uint32_t thresholdStep = 16u;
+
+    simd thresholdValue( uint16_t value )
+    {
+        return _mm_set1_epi16( static_cast<short>(value) );
+    }
+
+    simd thresholdValue( float value )
+    {
+        return _mm_castps_si128( _mm_set1_ps( value ) );
+    }
+
+    __m128i threshold( const uint16_t * in, simd minThreshold, simd maxThreshold )
+    {
+        const simd data1 = _mm_loadu_si128( reinterpret_cast<const simd*>(in) );
+        const simd data2 = _mm_loadu_si128( reinterpret_cast<const simd*>(in + 8) );
+
+        const simd outside1 = _mm_or_si128( _mm_subs_epu16( minThreshold, data1 ), _mm_subs_epu16( data1, maxThreshold ) );
+        const simd outside2 = _mm_or_si128( _mm_subs_epu16( minThreshold, data2 ), _mm_subs_epu16( data2, maxThreshold ) );
+
+        return _mm_packs_epi16( _mm_cmpeq_epi16( outside1, _mm_setzero_si128() ), _mm_cmpeq_epi16( outside2, _mm_setzero_si128() ) );
+    }
+
+    __m128i threshold( const float * in, simd minThreshold, simd maxThreshold )
+    {
+        const __m128 minValue = _mm_castsi128_ps( minThreshold );
+        const __m128 maxValue = _mm_castsi128_ps( maxThreshold );
+
+        simd outside[4];
+        for( uint32_t i = 0; i < 4u; ++i ) {
+            const __m128 data = _mm_loadu_ps( in + i * 4u );
+            outside[i] = _mm_castps_si128( _mm_or_ps( _mm_cmplt_ps( data, minValue ), _mm_cmpgt_ps( data, maxValue ) ) );
+        }
+
+        const simd packed = _mm_packs_epi16( _mm_packs_epi32( outside[0], outside[1] ), _mm_packs_epi32( outside[2], outside[3] ) );
+
+        return _mm_cmpeq_epi8( packed, _mm_setzero_si128() );
+    }
+
+    template <typename TColorDepth>
+    void Threshold( uint32_t rowSizeIn, uint32_t rowSizeOut, const TColorDepth * inY, uint8_t * outY, const uint8_t * outYEnd,
+                    TColorDepth minThreshold, TColorDepth maxThreshold, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
+    {
+        const simd minValue = thresholdValue( minThreshold );
+        const simd maxValue = thresholdValue( maxThreshold );
+
+        for( ; outY != outYEnd; outY += rowSizeOut, inY += rowSizeIn ) {
+            const TColorDepth * src = inY;
+            simd              * dst = reinterpret_cast <simd*> (outY);
+
+            const simd * dstEnd = dst + simdWidth;
+
+            for( ; dst != dstEnd; ++dst, src += thresholdStep )
+                _mm_storeu_si128( dst, threshold( src, minValue, maxValue ) );
+
+            if( nonSimdWidth > 0 ) {
+                const TColorDepth * inX  = inY + totalSimdWidth;
+                uint8_t           * outX = outY + totalSimdWidth;
+
+                const uint8_t * outXEnd = outX + nonSimdWidth;
+
+                for( ; outX != outXEnd; ++outX, ++inX )
+                    (*outX) = (*inX) < minThreshold || (*inX) > maxThreshold ? 0 : 255;
+            }
+        }
+    }
 #endif
 }
 
@@ -943,7 +1903,59 @@ namespace neon
                 const uint8_t * outXEnd = outX + nonSimdWidth;
 
                 for( ; outX != outXEnd; ++outX, ++inX )
-                    (*outX) = ~(*inX);
+                    (*outX) = ~(*inX);
+            }
+        }
+    }
+
+    void LookupTable( uint32_t rowSizeIn, uint32_t rowSizeOut, const uint8_t * inY, uint8_t * outY, const uint8_t * outYEnd, const uint8_t * table,
+                      uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
+    {
+        // Table lookup instruction can use only 32-byte table so the table is split into 8 parts
+        // Extended table lookup instruction keeps an original value for indices out of range [0; 32)
+        // so at every step we move to next part of the table by subtracting 32 from indices
+        uint8x8x4_t part[8];
+        for( uint32_t i = 0; i < 8u; ++i ) {
+            for( uint32_t j = 0; j < 4u; ++j )
+                part[i].val[j] = vld1_u8( table + i * 32u + j * 8u );
+        }
+
+        const uint8x8_t step = vdup_n_u8( 32u );
+
+        for( ; outY != outYEnd; outY += rowSizeOut, inY += rowSizeIn ) {
+            const uint8_t * src = inY;
+            uint8_t       * dst = outY;
+
+            const uint8_t * srcEnd = src + totalSimdWidth;
+
+            for( ; src != srcEnd; src += simdSize, dst += simdSize ) {
+                const simd data = vld1q_u8( src );
+
+                uint8x8_t indexLow  = vget_low_u8 ( data );
+                uint8x8_t indexHigh = vget_high_u8( data );
+
+                uint8x8_t resultLow  = vtbl4_u8( part[0], indexLow  );
+                uint8x8_t resultHigh = vtbl4_u8( part[0], indexHigh );
+
+                for( uint32_t i = 1; i < 8u; ++i ) {
+                    indexLow  = vsub_u8( indexLow , step );
+                    indexHigh = vsub_u8( indexHigh, step );
+
+                    resultLow  = vtbx4_u8( resultLow , part[i], indexLow  );
+                    resultHigh = vtbx4_u8( resultHigh, part[i], indexHigh );
+                }
+
+                vst1q_u8( dst, vcombine_u8( resultLow, resultHigh ) );
+            }
+
+            if( nonSimdWidth > 0 ) {
+                const uint8_t * inX  = inY  + totalSimdWidth;
+                uint8_t       * outX = outY + totalSimdWidth;
+
+                const uint8_t * outXEnd = outX + nonSimdWidth;
+
+                for( ; outX != outXEnd; ++outX, ++inX )
+                    (*outX) = table[*inX];
             }
         }
     }
@@ -1008,6 +2020,52 @@ namespace neon
         }
     }
 
+    void MinimumMaximum( uint32_t rowSize, const uint8_t * imageY, const uint8_t * imageYEnd, uint32_t simdWidth, uint32_t totalSimdWidth,
+                         uint32_t nonSimdWidth, uint8_t & minimum, uint8_t & maximum )
+    {
+        simd simdMinimum = vdupq_n_u8( minimum );
+        simd simdMaximum = vdupq_n_u8( maximum );
+
+        for( ; imageY != imageYEnd; imageY += rowSize ) {
+            const uint8_t * src    = imageY;
+            const uint8_t * srcEnd = src + totalSimdWidth;
+
+            for( ; src != srcEnd; src += simdSize ) {
+                const simd data = vld1q_u8( src );
+
+                simdMinimum = vminq_u8( simdMinimum, data );
+                simdMaximum = vmaxq_u8( simdMaximum, data );
+            }
+
+            if( nonSimdWidth > 0 ) {
+                const uint8_t * imageX    = imageY + totalSimdWidth;
+                const uint8_t * imageXEnd = imageX + nonSimdWidth;
+
+                for( ; imageX != imageXEnd; ++imageX ) {
+                    if( minimum > (*imageX) )
+                        minimum = (*imageX);
+
+                    if( maximum < (*imageX) )
+                        maximum = (*imageX);
+                }
+            }
+        }
+
+        uint8_t outputMinimum[16] = { 0 };
+        uint8_t outputMaximum[16] = { 0 };
+
+        vst1q_u8( outputMinimum, simdMinimum );
+        vst1q_u8( outputMaximum, simdMaximum );
+
+        for( uint32_t i = 0; i < 16u; ++i ) {
+            if( minimum > outputMinimum[i] )
+                minimum = outputMinimum[i];
+
+            if( maximum < outputMaximum[i] )
+                maximum = outputMaximum[i];
+        }
+    }
+
     void Subtract( uint32_t rowSizeIn1, uint32_t rowSizeIn2, uint32_t rowSizeOut, const uint8_t * in1Y, const uint8_t * in2Y,
                    uint8_t * outY, const uint8_t * outYEnd, uint32_t simdWidth, uint32_t totalSimdWidth, uint32_t nonSimdWidth )
     {
@@ -1140,20 +2198,18 @@ namespace neon
 
 namespace simd
 {
-    enum SIMDType
-    {
-        avx_function,
-        sse_function,
-        neon_function,
-        cpu_function
-    };
-
+    bool isAvx512Enabled = true;
     bool isAvxEnabled = true;
     bool isSseEnabled = true;
     bool isNeonEnabled = true;
 
     SIMDType actualSimdType()
     {
+        #ifdef PENGUINV_AVX512_SET
+        if ( isAvx512Available && isAvx512Enabled )
+            return avx512_function;
+        #endif
+
         #ifdef PENGUINV_AVX_SET
         if ( isAvxAvailable && isAvxEnabled )
             return avx_function;
@@ -1174,6 +2230,8 @@ namespace simd
 
     uint32_t getSimdSize( SIMDType simdType )
     {
+        if ( simdType == avx512_function )
+            return avx512::simdSize;
         if ( simdType == avx_function )
             return avx::simdSize;
         if ( simdType == sse_function )
@@ -1186,34 +2244,58 @@ namespace simd
         return 0u;
     }
 
+    // Returns true if all rows of an image area start at simdSize-byte boundary so aligned SIMD instructions can be used
+    bool isAligned( uint32_t simdSize, const uint8_t * data, uint32_t rowSize )
+    {
+        return (reinterpret_cast<size_t>( data ) % simdSize == 0) && (rowSize % simdSize == 0);
+    }
+
+    // Returns true if an image area is narrower than SIMD register so CPU code must be used
+    // AVX-512 functions process the end of a row by masked instructions so they support an area of any width
+    bool isNarrow( uint32_t width, SIMDType simdType )
+    {
+        return (simdType != avx512_function) && (width < getSimdSize( simdType ));
+    }
+
+// Code is passed as variadic arguments as it could contain commas, for example, in a list of template arguments
+#ifdef PENGUINV_AVX512_SET
+#define AVX512_CODE( ... )           \
+if ( simdType == avx512_function ) { \
+    __VA_ARGS__;                     \
+    return;                          \
+}
+#else
+#define AVX512_CODE( ... )
+#endif
+
 #ifdef PENGUINV_AVX_SET
-#define AVX_CODE( code )          \
+#define AVX_CODE( ... )           \
 if ( simdType == avx_function ) { \
-    code;                         \
+    __VA_ARGS__;                  \
     return;                       \
 }
 #else
-#define AVX_CODE( code )
+#define AVX_CODE( ... )
 #endif
 
 #ifdef PENGUINV_SSE_SET
-#define SSE_CODE( code )          \
+#define SSE_CODE( ... )           \
 if ( simdType == sse_function ) { \
-    code;                         \
+    __VA_ARGS__;                  \
     return;                       \
 }
 #else
-#define SSE_CODE( code )
+#define SSE_CODE( ... )
 #endif
 
 #ifdef PENGUINV_NEON_SET
-#define NEON_CODE( code )          \
+#define NEON_CODE( ... )           \
 if ( simdType == neon_function ) { \
-    code;                          \
+    __VA_ARGS__;                   \
     return;                        \
 }
 #else
-#define NEON_CODE( code )
+#define NEON_CODE( ... )
 #endif
 
     using namespace PenguinV_Image;
@@ -1224,7 +2306,7 @@ if ( simdType == neon_function ) { \
         const uint8_t colorCount = Image_Function::CommonColorCount( in1, in2, out );
         const uint32_t simdSize = getSimdSize( simdType );
 
-        if( (simdType == cpu_function) || (width * colorCount < simdSize) ) {
+        if( (simdType == cpu_function) || isNarrow( width * colorCount, simdType ) ) {
             AVX_CODE( AbsoluteDifference( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height, sse_function ); )
 
             Image_Function::AbsoluteDifference( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
@@ -1249,8 +2331,15 @@ if ( simdType == neon_function ) { \
         const uint32_t totalSimdWidth = simdWidth * simdSize;
         const uint32_t nonSimdWidth = width - totalSimdWidth;
 
-        AVX_CODE( avx::AbsoluteDifference( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
-        SSE_CODE( sse::AbsoluteDifference( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        if( isAligned( simdSize, in1Y, rowSizeIn1 ) && isAligned( simdSize, in2Y, rowSizeIn2 ) && isAligned( simdSize, outY, rowSizeOut ) ) {
+            AVX512_CODE( avx512::AbsoluteDifference<true>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+            AVX_CODE( avx::AbsoluteDifference<true>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+            SSE_CODE( sse::AbsoluteDifference<true>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        }
+
+        AVX512_CODE( avx512::AbsoluteDifference<false>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        AVX_CODE( avx::AbsoluteDifference<false>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        SSE_CODE( sse::AbsoluteDifference<false>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
         NEON_CODE( neon::AbsoluteDifference( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
     }
 
@@ -1260,7 +2349,7 @@ if ( simdType == neon_function ) { \
         const uint8_t colorCount = Image_Function::CommonColorCount( in1, in2, out );
         const uint32_t simdSize = getSimdSize( simdType );
 
-        if( (simdType == cpu_function) || (width * colorCount < simdSize) ) {
+        if( (simdType == cpu_function) || isNarrow( width * colorCount, simdType ) ) {
             AVX_CODE( BitwiseAnd( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height, sse_function ); )
 
             Image_Function::BitwiseAnd( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
@@ -1285,8 +2374,15 @@ if ( simdType == neon_function ) { \
         const uint32_t totalSimdWidth = simdWidth * simdSize;
         const uint32_t nonSimdWidth = width - totalSimdWidth;
 
-        AVX_CODE( avx::BitwiseAnd( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
-        SSE_CODE( sse::BitwiseAnd( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        if( isAligned( simdSize, in1Y, rowSizeIn1 ) && isAligned( simdSize, in2Y, rowSizeIn2 ) && isAligned( simdSize, outY, rowSizeOut ) ) {
+            AVX512_CODE( avx512::BitwiseAnd<true>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+            AVX_CODE( avx::BitwiseAnd<true>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+            SSE_CODE( sse::BitwiseAnd<true>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        }
+
+        AVX512_CODE( avx512::BitwiseAnd<false>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        AVX_CODE( avx::BitwiseAnd<false>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        SSE_CODE( sse::BitwiseAnd<false>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
         NEON_CODE( neon::BitwiseAnd( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
     }
 
@@ -1296,7 +2392,7 @@ if ( simdType == neon_function ) { \
         const uint8_t colorCount = Image_Function::CommonColorCount( in1, in2, out );
         const uint32_t simdSize = getSimdSize( simdType );
 
-        if( (simdType == cpu_function) || (width * colorCount < simdSize) ) {
+        if( (simdType == cpu_function) || isNarrow( width * colorCount, simdType ) ) {
             AVX_CODE( BitwiseOr( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height, sse_function ); )
 
             Image_Function::BitwiseOr( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
@@ -1321,8 +2417,15 @@ if ( simdType == neon_function ) { \
         const uint32_t totalSimdWidth = simdWidth * simdSize;
         const uint32_t nonSimdWidth = width - totalSimdWidth;
 
-        AVX_CODE( avx::BitwiseOr( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
-        SSE_CODE( sse::BitwiseOr( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        if( isAligned( simdSize, in1Y, rowSizeIn1 ) && isAligned( simdSize, in2Y, rowSizeIn2 ) && isAligned( simdSize, outY, rowSizeOut ) ) {
+            AVX512_CODE( avx512::BitwiseOr<true>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+            AVX_CODE( avx::BitwiseOr<true>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+            SSE_CODE( sse::BitwiseOr<true>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        }
+
+        AVX512_CODE( avx512::BitwiseOr<false>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        AVX_CODE( avx::BitwiseOr<false>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        SSE_CODE( sse::BitwiseOr<false>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
         NEON_CODE( neon::BitwiseOr( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
     }
 
@@ -1332,7 +2435,7 @@ if ( simdType == neon_function ) { \
         const uint8_t colorCount = Image_Function::CommonColorCount( in1, in2, out );
         const uint32_t simdSize = getSimdSize( simdType );
 
-        if( (simdType == cpu_function) || (width * colorCount < simdSize) ) {
+        if( (simdType == cpu_function) || isNarrow( width * colorCount, simdType ) ) {
             AVX_CODE( BitwiseXor( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height, sse_function ); )
 
             Image_Function::BitwiseXor( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
@@ -1357,18 +2460,140 @@ if ( simdType == neon_function ) { \
         const uint32_t totalSimdWidth = simdWidth * simdSize;
         const uint32_t nonSimdWidth = width - totalSimdWidth;
 
-        AVX_CODE( avx::BitwiseXor( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
-        SSE_CODE( sse::BitwiseXor( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        if( isAligned( simdSize, in1Y, rowSizeIn1 ) && isAligned( simdSize, in2Y, rowSizeIn2 ) && isAligned( simdSize, outY, rowSizeOut ) ) {
+            AVX512_CODE( avx512::BitwiseXor<true>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+            AVX_CODE( avx::BitwiseXor<true>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+            SSE_CODE( sse::BitwiseXor<true>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        }
+
+        AVX512_CODE( avx512::BitwiseXor<false>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        AVX_CODE( avx::BitwiseXor<false>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        SSE_CODE( sse::BitwiseXor<false>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
         NEON_CODE( neon::BitwiseXor( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
     }
 
+    // Morphology filters calculate maximum or minimum of whole rows by these functions. A row is processed as an image area
+    // of one row by SIMD code of Maximum and Minimum functions, the end of a row which does not fill SIMD register is processed by CPU code
+    template <SIMDType simdType>
+    void MaximumRow( const uint8_t * in1, const uint8_t * in2, uint8_t * out, uint32_t width )
+    {
+        const uint32_t simdSize = getSimdSize( simdType );
+
+        const uint32_t simdWidth = width / simdSize;
+        const uint32_t totalSimdWidth = simdWidth * simdSize;
+        const uint32_t nonSimdWidth = width - totalSimdWidth;
+
+        AVX512_CODE( avx512::Maximum<false>( width, width, width, in1, in2, out, out + width, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        AVX_CODE( avx::Maximum<false>( width, width, width, in1, in2, out, out + width, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        SSE_CODE( sse::Maximum<false>( width, width, width, in1, in2, out, out + width, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        NEON_CODE( neon::Maximum( width, width, width, in1, in2, out, out + width, simdWidth, totalSimdWidth, nonSimdWidth ); )
+    }
+
+    template <SIMDType simdType>
+    void MinimumRow( const uint8_t * in1, const uint8_t * in2, uint8_t * out, uint32_t width )
+    {
+        const uint32_t simdSize = getSimdSize( simdType );
+
+        const uint32_t simdWidth = width / simdSize;
+        const uint32_t totalSimdWidth = simdWidth * simdSize;
+        const uint32_t nonSimdWidth = width - totalSimdWidth;
+
+        AVX512_CODE( avx512::Minimum<false>( width, width, width, in1, in2, out, out + width, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        AVX_CODE( avx::Minimum<false>( width, width, width, in1, in2, out, out + width, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        SSE_CODE( sse::Minimum<false>( width, width, width, in1, in2, out, out + width, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        NEON_CODE( neon::Minimum( width, width, width, in1, in2, out, out + width, simdWidth, totalSimdWidth, nonSimdWidth ); )
+    }
+
+    // CPU code is not passed to these functions as morphology filters of Image_Function namespace are used for it
+    Image_Function_Helper::FunctionTable::MorphologyRow getMaximumRow( SIMDType simdType )
+    {
+        if ( simdType == avx512_function )
+            return MaximumRow<avx512_function>;
+        if ( simdType == avx_function )
+            return MaximumRow<avx_function>;
+        if ( simdType == sse_function )
+            return MaximumRow<sse_function>;
+
+        return MaximumRow<neon_function>;
+    }
+
+    Image_Function_Helper::FunctionTable::MorphologyRow getMinimumRow( SIMDType simdType )
+    {
+        if ( simdType == avx512_function )
+            return MinimumRow<avx512_function>;
+        if ( simdType == avx_function )
+            return MinimumRow<avx_function>;
+        if ( simdType == sse_function )
+            return MinimumRow<sse_function>;
+
+        return MinimumRow<neon_function>;
+    }
+
+    void Closing( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                  uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY, SIMDType simdType )
+    {
+        if( simdType == cpu_function ) {
+            Image_Function::Closing( in, startXIn, startYIn, out, startXOut, startYOut, width, height, radiusX, radiusY );
+            return;
+        }
+
+        Image_Function::ParameterValidation( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+        Image_Function::VerifyGrayScaleImage( in, out );
+
+        Image_Function_Helper::ClosingFilter( getMaximumRow( simdType ), getMinimumRow( simdType ), in, 0, 0, in.width(), in.height(), startXIn, startYIn,
+                                              out, startXOut, startYOut, width, height, radiusX, radiusY );
+    }
+
+    void Dilate( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                 uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY, SIMDType simdType )
+    {
+        if( simdType == cpu_function ) {
+            Image_Function::Dilate( in, startXIn, startYIn, out, startXOut, startYOut, width, height, radiusX, radiusY );
+            return;
+        }
+
+        Image_Function::ParameterValidation( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+        Image_Function::VerifyGrayScaleImage( in, out );
+
+        Image_Function_Helper::DilateFilter( getMaximumRow( simdType ), in, 0, 0, in.width(), in.height(), startXIn, startYIn,
+                                             out, startXOut, startYOut, width, height, radiusX, radiusY );
+    }
+
+    void Erode( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY, SIMDType simdType )
+    {
+        if( simdType == cpu_function ) {
+            Image_Function::Erode( in, startXIn, startYIn, out, startXOut, startYOut, width, height, radiusX, radiusY );
+            return;
+        }
+
+        Image_Function::ParameterValidation( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+        Image_Function::VerifyGrayScaleImage( in, out );
+
+        Image_Function_Helper::ErodeFilter( getMinimumRow( simdType ), in, 0, 0, in.width(), in.height(), startXIn, startYIn,
+                                            out, startXOut, startYOut, width, height, radiusX, radiusY );
+    }
+
+    void LookupTable( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                      uint32_t width, uint32_t height, const std::vector < uint8_t > & table, SIMDType simdType );
+
+    void GammaCorrection( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                          uint32_t width, uint32_t height, double a, double gamma, SIMDType simdType )
+    {
+        Image_Function::ParameterValidation( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+
+        const std::vector < uint8_t > value = Image_Function_Helper::GetGammaCorrectionLookupTable( a, gamma );
+
+        LookupTable( in, startXIn, startYIn, out, startXOut, startYOut, width, height, value, simdType );
+    }
+
     void Invert( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                  uint32_t width, uint32_t height, SIMDType simdType )
     {
         const uint8_t colorCount = Image_Function::CommonColorCount( in, out );
         const uint32_t simdSize = getSimdSize( simdType );
 
-        if( (simdType == cpu_function) || (width * colorCount < simdSize) ) {
+        if( (simdType == cpu_function) || isNarrow( width * colorCount, simdType ) ) {
             AVX_CODE( Invert( in, startXIn, startYIn, out, startXOut, startYOut, width, height, sse_function ); )
 
             Image_Function::Invert( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
@@ -1391,18 +2616,66 @@ if ( simdType == neon_function ) { \
         const uint32_t totalSimdWidth = simdWidth * simdSize;
         const uint32_t nonSimdWidth = width - totalSimdWidth;
 
-        AVX_CODE( avx::Invert( rowSizeIn, rowSizeOut, inY, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
-        SSE_CODE( sse::Invert( rowSizeIn, rowSizeOut, inY, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        if( isAligned( simdSize, inY, rowSizeIn ) && isAligned( simdSize, outY, rowSizeOut ) ) {
+            AVX512_CODE( avx512::Invert<true>( rowSizeIn, rowSizeOut, inY, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+            AVX_CODE( avx::Invert<true>( rowSizeIn, rowSizeOut, inY, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+            SSE_CODE( sse::Invert<true>( rowSizeIn, rowSizeOut, inY, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        }
+
+        AVX512_CODE( avx512::Invert<false>( rowSizeIn, rowSizeOut, inY, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        AVX_CODE( avx::Invert<false>( rowSizeIn, rowSizeOut, inY, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        SSE_CODE( sse::Invert<false>( rowSizeIn, rowSizeOut, inY, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
         NEON_CODE( neon::Invert( rowSizeIn, rowSizeOut, inY, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
     }
 
+    void LookupTable( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                      uint32_t width, uint32_t height, const std::vector < uint8_t > & table, SIMDType simdType )
+    {
+        const uint8_t colorCount = Image_Function::CommonColorCount( in, out );
+        const uint32_t simdSize = getSimdSize( simdType );
+
+        // SSE2 doesn't have byte shuffle instruction so lookup table is done by CPU for SSE
+        if( (simdType == cpu_function) || (simdType == sse_function) || isNarrow( width * colorCount, simdType ) ) {
+            Image_Function::LookupTable( in, startXIn, startYIn, out, startXOut, startYOut, width, height, table );
+            return;
+        }
+
+        Image_Function::ParameterValidation( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+
+        if( table.size() != 256u )
+            throw imageException( "Lookup table size is not equal to 256" );
+
+        width = width * colorCount;
+
+        const uint32_t rowSizeIn  = in.rowSize();
+        const uint32_t rowSizeOut = out.rowSize();
+
+        const uint8_t * inY  = in.data()  + startYIn  * rowSizeIn  + startXIn  * colorCount;
+        uint8_t       * outY = out.data() + startYOut * rowSizeOut + startXOut * colorCount;
+
+        const uint8_t * outYEnd = outY + height * rowSizeOut;
+
+        const uint32_t simdWidth = width / simdSize;
+        const uint32_t totalSimdWidth = simdWidth * simdSize;
+        const uint32_t nonSimdWidth = width - totalSimdWidth;
+
+        if( isAligned( simdSize, inY, rowSizeIn ) && isAligned( simdSize, outY, rowSizeOut ) ) {
+            AVX512_CODE( avx512::LookupTable<true>( rowSizeIn, rowSizeOut, inY, outY, outYEnd, table.data(), simdWidth, totalSimdWidth, nonSimdWidth ); )
+            AVX_CODE( avx::LookupTable<true>( rowSizeIn, rowSizeOut, inY, outY, outYEnd, table.data(), simdWidth, totalSimdWidth, nonSimdWidth ); )
+        }
+
+        AVX512_CODE( avx512::LookupTable<false>( rowSizeIn, rowSizeOut, inY, outY, outYEnd, table.data(), simdWidth, totalSimdWidth, nonSimdWidth ); )
+        AVX_CODE( avx::LookupTable<false>( rowSizeIn, rowSizeOut, inY, outY, outYEnd, table.data(), simdWidth, totalSimdWidth, nonSimdWidth ); )
+        NEON_CODE( neon::LookupTable( rowSizeIn, rowSizeOut, inY, outY, outYEnd, table.data(), simdWidth, totalSimdWidth, nonSimdWidth ); )
+    }
+
     void Maximum( const Image & in1, uint32_t startX1, uint32_t startY1, const Image & in2, uint32_t startX2, uint32_t startY2,
                   Image & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height, SIMDType simdType )
     {
         const uint8_t colorCount = Image_Function::CommonColorCount( in1, in2, out );
         const uint32_t simdSize = getSimdSize( simdType );
 
-        if( (simdType == cpu_function) || (width * colorCount < simdSize) ) {
+        if( (simdType == cpu_function) || isNarrow( width * colorCount, simdType ) ) {
             AVX_CODE( Maximum( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height, sse_function ); )
 
             Image_Function::Maximum( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
@@ -1427,8 +2700,15 @@ if ( simdType == neon_function ) { \
         const uint32_t totalSimdWidth = simdWidth * simdSize;
         const uint32_t nonSimdWidth = width - totalSimdWidth;
 
-        AVX_CODE( avx::Maximum( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
-        SSE_CODE( sse::Maximum( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        if( isAligned( simdSize, in1Y, rowSizeIn1 ) && isAligned( simdSize, in2Y, rowSizeIn2 ) && isAligned( simdSize, outY, rowSizeOut ) ) {
+            AVX512_CODE( avx512::Maximum<true>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+            AVX_CODE( avx::Maximum<true>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+            SSE_CODE( sse::Maximum<true>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        }
+
+        AVX512_CODE( avx512::Maximum<false>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        AVX_CODE( avx::Maximum<false>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        SSE_CODE( sse::Maximum<false>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
         NEON_CODE( neon::Maximum( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
     }
 
@@ -1438,7 +2718,7 @@ if ( simdType == neon_function ) { \
         const uint8_t colorCount = Image_Function::CommonColorCount( in1, in2, out );
         const uint32_t simdSize = getSimdSize( simdType );
 
-        if( (simdType == cpu_function) || (width * colorCount < simdSize) ) {
+        if( (simdType == cpu_function) || isNarrow( width * colorCount, simdType ) ) {
             AVX_CODE( Minimum( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height, sse_function ); )
 
             Image_Function::Minimum( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
@@ -1463,18 +2743,108 @@ if ( simdType == neon_function ) { \
         const uint32_t totalSimdWidth = simdWidth * simdSize;
         const uint32_t nonSimdWidth = width - totalSimdWidth;
 
-        AVX_CODE( avx::Minimum( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
-        SSE_CODE( sse::Minimum( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        if( isAligned( simdSize, in1Y, rowSizeIn1 ) && isAligned( simdSize, in2Y, rowSizeIn2 ) && isAligned( simdSize, outY, rowSizeOut ) ) {
+            AVX512_CODE( avx512::Minimum<true>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+            AVX_CODE( avx::Minimum<true>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+            SSE_CODE( sse::Minimum<true>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        }
+
+        AVX512_CODE( avx512::Minimum<false>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        AVX_CODE( avx::Minimum<false>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        SSE_CODE( sse::Minimum<false>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
         NEON_CODE( neon::Minimum( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
     }
 
+    void Normalize( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                    uint32_t width, uint32_t height, SIMDType simdType )
+    {
+        const uint8_t colorCount = Image_Function::CommonColorCount( in, out );
+        const uint32_t simdSize = getSimdSize( simdType );
+
+        if( (simdType == cpu_function) || isNarrow( width * colorCount, simdType ) ) {
+            AVX_CODE( Normalize( in, startXIn, startYIn, out, startXOut, startYOut, width, height, sse_function ); )
+
+            Image_Function::Normalize( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+            return;
+        }
+
+        Image_Function::ParameterValidation( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+
+        const uint32_t rowSizeIn = in.rowSize();
+
+        const uint8_t * inY    = in.data() + startYIn * rowSizeIn + startXIn * colorCount;
+        const uint8_t * inYEnd = inY + height * rowSizeIn;
+
+        const uint32_t realWidth = width * colorCount;
+
+        const uint32_t simdWidth = realWidth / simdSize;
+        const uint32_t totalSimdWidth = simdWidth * simdSize;
+        const uint32_t nonSimdWidth = realWidth - totalSimdWidth;
+
+        uint8_t minimum = 255;
+        uint8_t maximum = 0;
+
+        #ifdef PENGUINV_AVX512_SET
+        if( simdType == avx512_function ) {
+            if( isAligned( simdSize, inY, rowSizeIn ) )
+                avx512::MinimumMaximum<true>( rowSizeIn, inY, inYEnd, simdWidth, totalSimdWidth, nonSimdWidth, minimum, maximum );
+            else
+                avx512::MinimumMaximum<false>( rowSizeIn, inY, inYEnd, simdWidth, totalSimdWidth, nonSimdWidth, minimum, maximum );
+        }
+        #endif
+        #ifdef PENGUINV_AVX_SET
+        if( simdType == avx_function ) {
+            if( isAligned( simdSize, inY, rowSizeIn ) )
+                avx::MinimumMaximum<true>( rowSizeIn, inY, inYEnd, simdWidth, totalSimdWidth, nonSimdWidth, minimum, maximum );
+            else
+                avx::MinimumMaximum<false>( rowSizeIn, inY, inYEnd, simdWidth, totalSimdWidth, nonSimdWidth, minimum, maximum );
+        }
+        #endif
+        #ifdef PENGUINV_SSE_SET
+        if( simdType == sse_function ) {
+            if( isAligned( simdSize, inY, rowSizeIn ) )
+                sse::MinimumMaximum<true>( rowSizeIn, inY, inYEnd, simdWidth, totalSimdWidth, nonSimdWidth, minimum, maximum );
+            else
+                sse::MinimumMaximum<false>( rowSizeIn, inY, inYEnd, simdWidth, totalSimdWidth, nonSimdWidth, minimum, maximum );
+        }
+        #endif
+        #ifdef PENGUINV_NEON_SET
+        if( simdType == neon_function )
+            neon::MinimumMaximum( rowSizeIn, inY, inYEnd, simdWidth, totalSimdWidth, nonSimdWidth, minimum, maximum );
+        #endif
+
+        if( (minimum == 0 && maximum == 255) || (minimum == maximum) ) {
+            Image_Function::Copy( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+        }
+        else {
+            const std::vector < uint8_t > value = Image_Function_Helper::GetNormalizeLookupTable( minimum, maximum );
+
+            LookupTable( in, startXIn, startYIn, out, startXOut, startYOut, width, height, value, simdType );
+        }
+    }
+
+    void Opening( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                  uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY, SIMDType simdType )
+    {
+        if( simdType == cpu_function ) {
+            Image_Function::Opening( in, startXIn, startYIn, out, startXOut, startYOut, width, height, radiusX, radiusY );
+            return;
+        }
+
+        Image_Function::ParameterValidation( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+        Image_Function::VerifyGrayScaleImage( in, out );
+
+        Image_Function_Helper::OpeningFilter( getMaximumRow( simdType ), getMinimumRow( simdType ), in, 0, 0, in.width(), in.height(), startXIn, startYIn,
+                                              out, startXOut, startYOut, width, height, radiusX, radiusY );
+    }
+
     void Subtract( const Image & in1, uint32_t startX1, uint32_t startY1, const Image & in2, uint32_t startX2, uint32_t startY2,
                    Image & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height, SIMDType simdType )
     {
         const uint8_t colorCount = Image_Function::CommonColorCount( in1, in2, out );
         const uint32_t simdSize = getSimdSize( simdType );
 
-        if( (simdType == cpu_function) || (width * colorCount < simdSize) ) {
+        if( (simdType == cpu_function) || isNarrow( width * colorCount, simdType ) ) {
             AVX_CODE( Subtract( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height, sse_function ); )
 
             Image_Function::Subtract( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
@@ -1499,8 +2869,15 @@ if ( simdType == neon_function ) { \
         const uint32_t totalSimdWidth = simdWidth * simdSize;
         const uint32_t nonSimdWidth = width - totalSimdWidth;
 
-        AVX_CODE( avx::Subtract( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
-        SSE_CODE( sse::Subtract( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        if( isAligned( simdSize, in1Y, rowSizeIn1 ) && isAligned( simdSize, in2Y, rowSizeIn2 ) && isAligned( simdSize, outY, rowSizeOut ) ) {
+            AVX512_CODE( avx512::Subtract<true>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+            AVX_CODE( avx::Subtract<true>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+            SSE_CODE( sse::Subtract<true>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        }
+
+        AVX512_CODE( avx512::Subtract<false>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        AVX_CODE( avx::Subtract<false>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        SSE_CODE( sse::Subtract<false>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
         NEON_CODE( neon::Subtract( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
     }
 
@@ -1508,7 +2885,7 @@ if ( simdType == neon_function ) { \
     {
         const uint32_t simdSize = getSimdSize( simdType );
 
-        if( (simdType == cpu_function) || (width < simdSize) ) {
+        if( (simdType == cpu_function) || isNarrow( width, simdType ) ) {
             #ifdef PENGUINV_AVX_SET
             if ( simdType == avx_function )
                 return Sum( image, x, y, width, height, sse_function );
@@ -1529,13 +2906,29 @@ if ( simdType == neon_function ) { \
         const uint32_t totalSimdWidth = simdWidth * simdSize;
         const uint32_t nonSimdWidth = width - totalSimdWidth;
 
+        #ifdef PENGUINV_AVX512_SET
+        if ( simdType == avx512_function ) {
+            if( isAligned( simdSize, imageY, rowSize ) )
+                return avx512::Sum<true>( rowSize, imageY, imageYEnd, simdWidth, totalSimdWidth, nonSimdWidth );
+            else
+                return avx512::Sum<false>( rowSize, imageY, imageYEnd, simdWidth, totalSimdWidth, nonSimdWidth );
+        }
+        #endif
         #ifdef PENGUINV_AVX_SET
-        if ( simdType == avx_function )
-            return avx::Sum( rowSize, imageY, imageYEnd, simdWidth, totalSimdWidth, nonSimdWidth );
+        if ( simdType == avx_function ) {
+            if( isAligned( simdSize, imageY, rowSize ) )
+                return avx::Sum<true>( rowSize, imageY, imageYEnd, simdWidth, totalSimdWidth, nonSimdWidth );
+            else
+                return avx::Sum<false>( rowSize, imageY, imageYEnd, simdWidth, totalSimdWidth, nonSimdWidth );
+        }
         #endif
         #ifdef PENGUINV_SSE_SET
-        if ( simdType == sse_function )
-            return sse::Sum( rowSize, imageY, imageYEnd, simdWidth, totalSimdWidth, nonSimdWidth );
+        if ( simdType == sse_function ) {
+            if( isAligned( simdSize, imageY, rowSize ) )
+                return sse::Sum<true>( rowSize, imageY, imageYEnd, simdWidth, totalSimdWidth, nonSimdWidth );
+            else
+                return sse::Sum<false>( rowSize, imageY, imageYEnd, simdWidth, totalSimdWidth, nonSimdWidth );
+        }
         #endif
         #ifdef PENGUINV_NEON_SET
         if (simdType == neon_function)
@@ -1550,7 +2943,7 @@ if ( simdType == neon_function ) { \
     {
         const uint32_t simdSize = getSimdSize( simdType );
 
-        if( (simdType == cpu_function) || (width < simdSize) ) {
+        if( (simdType == cpu_function) || isNarrow( width, simdType ) ) {
             AVX_CODE( Threshold( in, startXIn, startYIn, out, startXOut, startYOut, width, height, threshold, sse_function ); )
 
             Image_Function::Threshold( in, startXIn, startYIn, out, startXOut, startYOut, width, height, threshold );
@@ -1572,8 +2965,15 @@ if ( simdType == neon_function ) { \
         const uint32_t totalSimdWidth = simdWidth * simdSize;
         const uint32_t nonSimdWidth = width - totalSimdWidth;
 
-        AVX_CODE( avx::Threshold( rowSizeIn, rowSizeOut, inY, outY, outYEnd, threshold, simdWidth, totalSimdWidth, nonSimdWidth ); )
-        SSE_CODE( sse::Threshold( rowSizeIn, rowSizeOut, inY, outY, outYEnd, threshold, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        if( isAligned( simdSize, inY, rowSizeIn ) && isAligned( simdSize, outY, rowSizeOut ) ) {
+            AVX512_CODE( avx512::Threshold<true>( rowSizeIn, rowSizeOut, inY, outY, outYEnd, threshold, simdWidth, totalSimdWidth, nonSimdWidth ); )
+            AVX_CODE( avx::Threshold<true>( rowSizeIn, rowSizeOut, inY, outY, outYEnd, threshold, simdWidth, totalSimdWidth, nonSimdWidth ); )
+            SSE_CODE( sse::Threshold<true>( rowSizeIn, rowSizeOut, inY, outY, outYEnd, threshold, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        }
+
+        AVX512_CODE( avx512::Threshold<false>( rowSizeIn, rowSizeOut, inY, outY, outYEnd, threshold, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        AVX_CODE( avx::Threshold<false>( rowSizeIn, rowSizeOut, inY, outY, outYEnd, threshold, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        SSE_CODE( sse::Threshold<false>( rowSizeIn, rowSizeOut, inY, outY, outYEnd, threshold, simdWidth, totalSimdWidth, nonSimdWidth ); )
         NEON_CODE( neon::Threshold( rowSizeIn, rowSizeOut, inY, outY, outYEnd, threshold, simdWidth, totalSimdWidth, nonSimdWidth ); )
     }
 
@@ -1582,7 +2982,7 @@ if ( simdType == neon_function ) { \
     {
         const uint32_t simdSize = getSimdSize( simdType );
 
-        if( (simdType == cpu_function) || (width < simdSize) ) {
+        if( (simdType == cpu_function) || isNarrow( width, simdType ) ) {
             AVX_CODE( Threshold( in, startXIn, startYIn, out, startXOut, startYOut, width, height, minThreshold, maxThreshold, sse_function ); )
 
             Image_Function::Threshold( in, startXIn, startYIn, out, startXOut, startYOut, width, height, minThreshold, maxThreshold );
@@ -1604,9 +3004,131 @@ if ( simdType == neon_function ) { \
         const uint32_t totalSimdWidth = simdWidth * simdSize;
         const uint32_t nonSimdWidth = width - totalSimdWidth;
 
+        if( isAligned( simdSize, inY, rowSizeIn ) && isAligned( simdSize, outY, rowSizeOut ) ) {
+            AVX512_CODE( avx512::Threshold<true>( rowSizeIn, rowSizeOut, inY, outY, outYEnd, minThreshold, maxThreshold, simdWidth, totalSimdWidth, nonSimdWidth ); )
+            AVX_CODE( avx::Threshold<true>( rowSizeIn, rowSizeOut, inY, outY, outYEnd, minThreshold, maxThreshold, simdWidth, totalSimdWidth, nonSimdWidth ); )
+            SSE_CODE( sse::Threshold<true>( rowSizeIn, rowSizeOut, inY, outY, outYEnd, minThreshold, maxThreshold, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        }
+
+        AVX512_CODE( avx512::Threshold<false>( rowSizeIn, rowSizeOut, inY, outY, outYEnd, minThreshold, maxThreshold, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        AVX_CODE( avx::Threshold<false>( rowSizeIn, rowSizeOut, inY, outY, outYEnd, minThreshold, maxThreshold, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        SSE_CODE( sse::Threshold<false>( rowSizeIn, rowSizeOut, inY, outY, outYEnd, minThreshold, maxThreshold, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        NEON_CODE( neon::Threshold( rowSizeIn, rowSizeOut, inY, outY, outYEnd, minThreshold, maxThreshold, simdWidth, totalSimdWidth, nonSimdWidth ); )
+    }
+
+    void TopHat( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                 uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY, SIMDType simdType )
+    {
+        if( simdType == cpu_function ) {
+            Image_Function::TopHat( in, startXIn, startYIn, out, startXOut, startYOut, width, height, radiusX, radiusY );
+            return;
+        }
+
+        Image_Function::ParameterValidation( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+        Image_Function::VerifyGrayScaleImage( in, out );
+
+        Image_Function_Helper::TopHatFilter( getMaximumRow( simdType ), getMinimumRow( simdType ), Image_Function_Simd::Subtract, in, 0, 0, in.width(), in.height(), startXIn, startYIn,
+                                             out, startXOut, startYOut, width, height, radiusX, radiusY );
+    }
+
+    // Images with 16-bit and floating point pixels. NEON kernels for such images are not implemented so CPU code is used instead
+    template <BinaryOperation operation, typename TColorDepth>
+    void Calculate( const ImageTemplate < TColorDepth > & in1, uint32_t startX1, uint32_t startY1,
+                    const ImageTemplate < TColorDepth > & in2, uint32_t startX2, uint32_t startY2,
+                    ImageTemplate < TColorDepth > & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height, SIMDType simdType )
+    {
+        const uint8_t colorCount = Image_Function::CommonColorCount( in1, in2, out );
+        const uint32_t simdSize = getSimdSize( simdType );
+        const uint32_t pixelSize = static_cast<uint32_t>(sizeof( TColorDepth ));
+
+        if( (simdType == cpu_function) || (simdType == neon_function) || isNarrow( width * colorCount * pixelSize, simdType ) ) {
+            AVX_CODE( Calculate<operation>( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height, sse_function ); )
+
+            switch( operation ) {
+                case ABSOLUTE_DIFFERENCE:
+                    Image_Function::AbsoluteDifference( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
+                    break;
+                case MAXIMUM:
+                    Image_Function::Maximum( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
+                    break;
+                case MINIMUM:
+                    Image_Function::Minimum( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
+                    break;
+                case SUBTRACT:
+                    Image_Function::Subtract( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
+                    break;
+            }
+            return;
+        }
+
+        Image_Function::ParameterValidation( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
+
+        width = width * colorCount;
+
+        const uint32_t rowSizeIn1 = in1.rowSize();
+        const uint32_t rowSizeIn2 = in2.rowSize();
+        const uint32_t rowSizeOut = out.rowSize();
+
+        const TColorDepth * in1Y = in1.data() + startY1   * rowSizeIn1 + startX1   * colorCount;
+        const TColorDepth * in2Y = in2.data() + startY2   * rowSizeIn2 + startX2   * colorCount;
+        TColorDepth       * outY = out.data() + startYOut * rowSizeOut + startXOut * colorCount;
+
+        const TColorDepth * outYEnd = outY + height * rowSizeOut;
+
+        const uint32_t simdWidth = width * pixelSize / simdSize;
+        const uint32_t totalSimdWidth = simdWidth * simdSize / pixelSize;
+        const uint32_t nonSimdWidth = width - totalSimdWidth;
+
+        if( isAligned( simdSize, reinterpret_cast<const uint8_t *>(in1Y), rowSizeIn1 * pixelSize ) &&
+            isAligned( simdSize, reinterpret_cast<const uint8_t *>(in2Y), rowSizeIn2 * pixelSize ) &&
+            isAligned( simdSize, reinterpret_cast<const uint8_t *>(outY), rowSizeOut * pixelSize ) ) {
+            AVX512_CODE( avx512::Calculate<true, operation>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+            AVX_CODE( avx::Calculate<true, operation>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+            SSE_CODE( sse::Calculate<true, operation>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        }
+
+        AVX512_CODE( avx512::Calculate<false, operation>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        AVX_CODE( avx::Calculate<false, operation>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+        SSE_CODE( sse::Calculate<false, operation>( rowSizeIn1, rowSizeIn2, rowSizeOut, in1Y, in2Y, outY, outYEnd, simdWidth, totalSimdWidth, nonSimdWidth ); )
+    }
+
+    // Images with 16-bit and floating point pixels. Output image is always 8-bit so AVX and SSE kernels process 16 pixels per step
+    // AVX-512 and NEON kernels are not implemented so AVX and CPU code is used instead
+    template <typename TColorDepth>
+    void Threshold( const ImageTemplate < TColorDepth > & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                    uint32_t width, uint32_t height, TColorDepth minThreshold, TColorDepth maxThreshold, SIMDType simdType )
+    {
+        AVX512_CODE( Threshold( in, startXIn, startYIn, out, startXOut, startYOut, width, height, minThreshold, maxThreshold, avx_function ); )
+
+        const uint32_t stepSize = 16u; // number of pixels processed by AVX and SSE kernels per step
+
+        if( (simdType == cpu_function) || (simdType == neon_function) || (width < stepSize) ) {
+            Image_Function::Threshold( in, startXIn, startYIn, out, startXOut, startYOut, width, height, minThreshold, maxThreshold );
+            return;
+        }
+
+        Image_Function::ParameterValidation( in, startXIn, startYIn, width, height );
+        Image_Function::ParameterValidation( out, startXOut, startYOut, width, height );
+        Image_Function::VerifyGrayScaleImage( in );
+        Image_Function::VerifyGrayScaleImage( out );
+
+        if( minThreshold > maxThreshold )
+            throw imageException( "Minimum threshold value is bigger than maximum threshold value" );
+
+        const uint32_t rowSizeIn  = in.rowSize();
+        const uint32_t rowSizeOut = out.rowSize();
+
+        const TColorDepth * inY  = in.data()  + startYIn  * rowSizeIn  + startXIn;
+        uint8_t           * outY = out.data() + startYOut * rowSizeOut + startXOut;
+
+        const uint8_t * outYEnd = outY + height * rowSizeOut;
+
+        const uint32_t simdWidth = width / stepSize;
+        const uint32_t totalSimdWidth = simdWidth * stepSize;
+        const uint32_t nonSimdWidth = width - totalSimdWidth;
+
         AVX_CODE( avx::Threshold( rowSizeIn, rowSizeOut, inY, outY, outYEnd, minThreshold, maxThreshold, simdWidth, totalSimdWidth, nonSimdWidth ); )
         SSE_CODE( sse::Threshold( rowSizeIn, rowSizeOut, inY, outY, outYEnd, minThreshold, maxThreshold, simdWidth, totalSimdWidth, nonSimdWidth ); )
-        NEON_CODE( neon::Threshold( rowSizeIn, rowSizeOut, inY, outY, outYEnd, minThreshold, maxThreshold, simdWidth, totalSimdWidth, nonSimdWidth ); )
     }
 }
 
@@ -1616,11 +3138,17 @@ namespace Image_Function_Simd
     {
         void EnableSimd( bool enable )
         {
+            EnableAvx512( enable );
             EnableAvx( enable );
             EnableSse( enable );
             EnableNeon( enable );
         }
 
+        void EnableAvx512( bool enable )
+        {
+            simd::isAvx512Enabled = enable;
+        }
+
         void EnableAvx( bool enable )
         {
             simd::isAvxEnabled = enable;
@@ -1725,6 +3253,90 @@ namespace Image_Function_Simd
         simd::BitwiseXor( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height, simd::actualSimdType() );
     }
 
+    Image Closing( const Image & in, uint32_t radiusX, uint32_t radiusY )
+    {
+        return Image_Function_Helper::Closing( Closing, in, radiusX, radiusY );
+    }
+
+    void Closing( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function_Helper::Closing( Closing, in, out, radiusX, radiusY );
+    }
+
+    Image Closing( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        return Image_Function_Helper::Closing( Closing, in, startXIn, startYIn, width, height, radiusX, radiusY );
+    }
+
+    void Closing( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                  uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        simd::Closing( in, startXIn, startYIn, out, startXOut, startYOut, width, height, radiusX, radiusY, simd::actualSimdType() );
+    }
+
+    Image Dilate( const Image & in, uint32_t radiusX, uint32_t radiusY )
+    {
+        return Image_Function_Helper::Dilate( Dilate, in, radiusX, radiusY );
+    }
+
+    void Dilate( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function_Helper::Dilate( Dilate, in, out, radiusX, radiusY );
+    }
+
+    Image Dilate( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        return Image_Function_Helper::Dilate( Dilate, in, startXIn, startYIn, width, height, radiusX, radiusY );
+    }
+
+    void Dilate( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                 uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        simd::Dilate( in, startXIn, startYIn, out, startXOut, startYOut, width, height, radiusX, radiusY, simd::actualSimdType() );
+    }
+
+    Image Erode( const Image & in, uint32_t radiusX, uint32_t radiusY )
+    {
+        return Image_Function_Helper::Erode( Erode, in, radiusX, radiusY );
+    }
+
+    void Erode( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function_Helper::Erode( Erode, in, out, radiusX, radiusY );
+    }
+
+    Image Erode( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        return Image_Function_Helper::Erode( Erode, in, startXIn, startYIn, width, height, radiusX, radiusY );
+    }
+
+    void Erode( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        simd::Erode( in, startXIn, startYIn, out, startXOut, startYOut, width, height, radiusX, radiusY, simd::actualSimdType() );
+    }
+
+    Image GammaCorrection( const Image & in, double a, double gamma )
+    {
+        return Image_Function_Helper::GammaCorrection( GammaCorrection, in, a, gamma );
+    }
+
+    void GammaCorrection( const Image & in, Image & out, double a, double gamma )
+    {
+        Image_Function_Helper::GammaCorrection( GammaCorrection, in, out, a, gamma );
+    }
+
+    Image GammaCorrection( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, double a, double gamma )
+    {
+        return Image_Function_Helper::GammaCorrection( GammaCorrection, in, startXIn, startYIn, width, height, a, gamma );
+    }
+
+    void GammaCorrection( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                          uint32_t width, uint32_t height, double a, double gamma )
+    {
+        simd::GammaCorrection( in, startXIn, startYIn, out, startXOut, startYOut, width, height, a, gamma, simd::actualSimdType() );
+    }
+
     Image Invert( const Image & in )
     {
         return Image_Function_Helper::Invert( Invert, in );
@@ -1746,6 +3358,28 @@ namespace Image_Function_Simd
         simd::Invert( in, startXIn, startYIn, out, startXOut, startYOut, width, height, simd::actualSimdType() );
     }
 
+    Image LookupTable( const Image & in, const std::vector < uint8_t > & table )
+    {
+        return Image_Function_Helper::LookupTable( LookupTable, in, table );
+    }
+
+    void LookupTable( const Image & in, Image & out, const std::vector < uint8_t > & table )
+    {
+        Image_Function_Helper::LookupTable( LookupTable, in, out, table );
+    }
+
+    Image LookupTable( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height,
+                       const std::vector < uint8_t > & table )
+    {
+        return Image_Function_Helper::LookupTable( LookupTable, in, startXIn, startYIn, width, height, table );
+    }
+
+    void LookupTable( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                      uint32_t width, uint32_t height, const std::vector < uint8_t > & table )
+    {
+        simd::LookupTable( in, startXIn, startYIn, out, startXOut, startYOut, width, height, table, simd::actualSimdType() );
+    }
+
     Image Maximum( const Image & in1, const Image & in2 )
     {
         return Image_Function_Helper::Maximum( Maximum, in1, in2 );
@@ -1790,6 +3424,48 @@ namespace Image_Function_Simd
         simd::Minimum( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height, simd::actualSimdType() );
     }
 
+    Image Normalize( const Image & in )
+    {
+        return Image_Function_Helper::Normalize( Normalize, in );
+    }
+
+    void Normalize( const Image & in, Image & out )
+    {
+        Image_Function_Helper::Normalize( Normalize, in, out );
+    }
+
+    Image Normalize( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height )
+    {
+        return Image_Function_Helper::Normalize( Normalize, in, startXIn, startYIn, width, height );
+    }
+
+    void Normalize( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                    uint32_t width, uint32_t height )
+    {
+        simd::Normalize( in, startXIn, startYIn, out, startXOut, startYOut, width, height, simd::actualSimdType() );
+    }
+
+    Image Opening( const Image & in, uint32_t radiusX, uint32_t radiusY )
+    {
+        return Image_Function_Helper::Opening( Opening, in, radiusX, radiusY );
+    }
+
+    void Opening( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function_Helper::Opening( Opening, in, out, radiusX, radiusY );
+    }
+
+    Image Opening( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        return Image_Function_Helper::Opening( Opening, in, startXIn, startYIn, width, height, radiusX, radiusY );
+    }
+
+    void Opening( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                  uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        simd::Opening( in, startXIn, startYIn, out, startXOut, startYOut, width, height, radiusX, radiusY, simd::actualSimdType() );
+    }
+
     Image Subtract( const Image & in1, const Image & in2 )
     {
         return Image_Function_Helper::Subtract( Subtract, in1, in2 );
@@ -1864,4 +3540,289 @@ namespace Image_Function_Simd
     {
         simd::Threshold( in, startXIn, startYIn, out, startXOut, startYOut, width, height, minThreshold, maxThreshold, simd::actualSimdType() );
     }
+
+    Image TopHat( const Image & in, uint32_t radiusX, uint32_t radiusY )
+    {
+        return Image_Function_Helper::TopHat( TopHat, in, radiusX, radiusY );
+    }
+
+    void TopHat( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY )
+    {
+        Image_Function_Helper::TopHat( TopHat, in, out, radiusX, radiusY );
+    }
+
+    Image TopHat( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        return Image_Function_Helper::TopHat( TopHat, in, startXIn, startYIn, width, height, radiusX, radiusY );
+    }
+
+    void TopHat( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                 uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY )
+    {
+        simd::TopHat( in, startXIn, startYIn, out, startXOut, startYOut, width, height, radiusX, radiusY, simd::actualSimdType() );
+    }
+
+    Image16Bit AbsoluteDifference( const Image16Bit & in1, const Image16Bit & in2 )
+    {
+        return Image_Function_Helper::BinaryOperation( AbsoluteDifference, in1, in2 );
+    }
+
+    void AbsoluteDifference( const Image16Bit & in1, const Image16Bit & in2, Image16Bit & out )
+    {
+        Image_Function_Helper::BinaryOperation( AbsoluteDifference, in1, in2, out );
+    }
+
+    Image16Bit AbsoluteDifference( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                                   uint32_t width, uint32_t height )
+    {
+        return Image_Function_Helper::BinaryOperation( AbsoluteDifference, in1, startX1, startY1, in2, startX2, startY2, width, height );
+    }
+
+    void AbsoluteDifference( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                             Image16Bit & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height )
+    {
+        simd::Calculate<ABSOLUTE_DIFFERENCE>( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height, simd::actualSimdType() );
+    }
+
+    ImageFloat AbsoluteDifference( const ImageFloat & in1, const ImageFloat & in2 )
+    {
+        return Image_Function_Helper::BinaryOperation( AbsoluteDifference, in1, in2 );
+    }
+
+    void AbsoluteDifference( const ImageFloat & in1, const ImageFloat & in2, ImageFloat & out )
+    {
+        Image_Function_Helper::BinaryOperation( AbsoluteDifference, in1, in2, out );
+    }
+
+    ImageFloat AbsoluteDifference( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                                   uint32_t width, uint32_t height )
+    {
+        return Image_Function_Helper::BinaryOperation( AbsoluteDifference, in1, startX1, startY1, in2, startX2, startY2, width, height );
+    }
+
+    void AbsoluteDifference( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                             ImageFloat & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height )
+    {
+        simd::Calculate<ABSOLUTE_DIFFERENCE>( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height, simd::actualSimdType() );
+    }
+
+    Image16Bit Maximum( const Image16Bit & in1, const Image16Bit & in2 )
+    {
+        return Image_Function_Helper::BinaryOperation( Maximum, in1, in2 );
+    }
+
+    void Maximum( const Image16Bit & in1, const Image16Bit & in2, Image16Bit & out )
+    {
+        Image_Function_Helper::BinaryOperation( Maximum, in1, in2, out );
+    }
+
+    Image16Bit Maximum( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                        uint32_t width, uint32_t height )
+    {
+        return Image_Function_Helper::BinaryOperation( Maximum, in1, startX1, startY1, in2, startX2, startY2, width, height );
+    }
+
+    void Maximum( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                  Image16Bit & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height )
+    {
+        simd::Calculate<MAXIMUM>( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height, simd::actualSimdType() );
+    }
+
+    ImageFloat Maximum( const ImageFloat & in1, const ImageFloat & in2 )
+    {
+        return Image_Function_Helper::BinaryOperation( Maximum, in1, in2 );
+    }
+
+    void Maximum( const ImageFloat & in1, const ImageFloat & in2, ImageFloat & out )
+    {
+        Image_Function_Helper::BinaryOperation( Maximum, in1, in2, out );
+    }
+
+    ImageFloat Maximum( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                        uint32_t width, uint32_t height )
+    {
+        return Image_Function_Helper::BinaryOperation( Maximum, in1, startX1, startY1, in2, startX2, startY2, width, height );
+    }
+
+    void Maximum( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                  ImageFloat & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height )
+    {
+        simd::Calculate<MAXIMUM>( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height, simd::actualSimdType() );
+    }
+
+    Image16Bit Minimum( const Image16Bit & in1, const Image16Bit & in2 )
+    {
+        return Image_Function_Helper::BinaryOperation( Minimum, in1, in2 );
+    }
+
+    void Minimum( const Image16Bit & in1, const Image16Bit & in2, Image16Bit & out )
+    {
+        Image_Function_Helper::BinaryOperation( Minimum, in1, in2, out );
+    }
+
+    Image16Bit Minimum( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                        uint32_t width, uint32_t height )
+    {
+        return Image_Function_Helper::BinaryOperation( Minimum, in1, startX1, startY1, in2, startX2, startY2, width, height );
+    }
+
+    void Minimum( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                  Image16Bit & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height )
+    {
+        simd::Calculate<MINIMUM>( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height, simd::actualSimdType() );
+    }
+
+    ImageFloat Minimum( const ImageFloat & in1, const ImageFloat & in2 )
+    {
+        return Image_Function_Helper::BinaryOperation( Minimum, in1, in2 );
+    }
+
+    void Minimum( const ImageFloat & in1, const ImageFloat & in2, ImageFloat & out )
+    {
+        Image_Function_Helper::BinaryOperation( Minimum, in1, in2, out );
+    }
+
+    ImageFloat Minimum( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                        uint32_t width, uint32_t height )
+    {
+        return Image_Function_Helper::BinaryOperation( Minimum, in1, startX1, startY1, in2, startX2, startY2, width, height );
+    }
+
+    void Minimum( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                  ImageFloat & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height )
+    {
+        simd::Calculate<MINIMUM>( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height, simd::actualSimdType() );
+    }
+
+    Image16Bit Subtract( const Image16Bit & in1, const Image16Bit & in2 )
+    {
+        return Image_Function_Helper::BinaryOperation( Subtract, in1, in2 );
+    }
+
+    void Subtract( const Image16Bit & in1, const Image16Bit & in2, Image16Bit & out )
+    {
+        Image_Function_Helper::BinaryOperation( Subtract, in1, in2, out );
+    }
+
+    Image16Bit Subtract( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                         uint32_t width, uint32_t height )
+    {
+        return Image_Function_Helper::BinaryOperation( Subtract, in1, startX1, startY1, in2, startX2, startY2, width, height );
+    }
+
+    void Subtract( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                   Image16Bit & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height )
+    {
+        simd::Calculate<SUBTRACT>( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height, simd::actualSimdType() );
+    }
+
+    ImageFloat Subtract( const ImageFloat & in1, const ImageFloat & in2 )
+    {
+        return Image_Function_Helper::BinaryOperation( Subtract, in1, in2 );
+    }
+
+    void Subtract( const ImageFloat & in1, const ImageFloat & in2, ImageFloat & out )
+    {
+        Image_Function_Helper::BinaryOperation( Subtract, in1, in2, out );
+    }
+
+    ImageFloat Subtract( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                         uint32_t width, uint32_t height )
+    {
+        return Image_Function_Helper::BinaryOperation( Subtract, in1, startX1, startY1, in2, startX2, startY2, width, height );
+    }
+
+    void Subtract( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                   ImageFloat & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height )
+    {
+        simd::Calculate<SUBTRACT>( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height, simd::actualSimdType() );
+    }
+
+    Image Threshold( const Image16Bit & in, uint16_t threshold )
+    {
+        return Image_Function_Helper::Threshold( Threshold, in, threshold );
+    }
+
+    void Threshold( const Image16Bit & in, Image & out, uint16_t threshold )
+    {
+        Image_Function_Helper::Threshold( Threshold, in, out, threshold );
+    }
+
+    Image Threshold( const Image16Bit & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint16_t threshold )
+    {
+        return Image_Function_Helper::Threshold( Threshold, in, startXIn, startYIn, width, height, threshold );
+    }
+
+    void Threshold( const Image16Bit & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                    uint32_t width, uint32_t height, uint16_t threshold )
+    {
+        simd::Threshold( in, startXIn, startYIn, out, startXOut, startYOut, width, height, threshold, static_cast<uint16_t>(65535u),
+                         simd::actualSimdType() );
+    }
+
+    Image Threshold( const ImageFloat & in, float threshold )
+    {
+        return Image_Function_Helper::Threshold( Threshold, in, threshold );
+    }
+
+    void Threshold( const ImageFloat & in, Image & out, float threshold )
+    {
+        Image_Function_Helper::Threshold( Threshold, in, out, threshold );
+    }
+
+    Image Threshold( const ImageFloat & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, float threshold )
+    {
+        return Image_Function_Helper::Threshold( Threshold, in, startXIn, startYIn, width, height, threshold );
+    }
+
+    void Threshold( const ImageFloat & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                    uint32_t width, uint32_t height, float threshold )
+    {
+        simd::Threshold( in, startXIn, startYIn, out, startXOut, startYOut, width, height, threshold, std::numeric_limits<float>::infinity(),
+                         simd::actualSimdType() );
+    }
+
+    Image Threshold( const Image16Bit & in, uint16_t minThreshold, uint16_t maxThreshold )
+    {
+        return Image_Function_Helper::Threshold( Threshold, in, minThreshold, maxThreshold );
+    }
+
+    void Threshold( const Image16Bit & in, Image & out, uint16_t minThreshold, uint16_t maxThreshold )
+    {
+        Image_Function_Helper::Threshold( Threshold, in, out, minThreshold, maxThreshold );
+    }
+
+    Image Threshold( const Image16Bit & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint16_t minThreshold,
+                     uint16_t maxThreshold )
+    {
+        return Image_Function_Helper::Threshold( Threshold, in, startXIn, startYIn, width, height, minThreshold, maxThreshold );
+    }
+
+    void Threshold( const Image16Bit & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                    uint32_t width, uint32_t height, uint16_t minThreshold, uint16_t maxThreshold )
+    {
+        simd::Threshold( in, startXIn, startYIn, out, startXOut, startYOut, width, height, minThreshold, maxThreshold, simd::actualSimdType() );
+    }
+
+    Image Threshold( const ImageFloat & in, float minThreshold, float maxThreshold )
+    {
+        return Image_Function_Helper::Threshold( Threshold, in, minThreshold, maxThreshold );
+    }
+
+    void Threshold( const ImageFloat & in, Image & out, float minThreshold, float maxThreshold )
+    {
+        Image_Function_Helper::Threshold( Threshold, in, out, minThreshold, maxThreshold );
+    }
+
+    Image Threshold( const ImageFloat & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, float minThreshold,
+                     float maxThreshold )
+    {
+        return Image_Function_Helper::Threshold( Threshold, in, startXIn, startYIn, width, height, minThreshold, maxThreshold );
+    }
+
+    void Threshold( const ImageFloat & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                    uint32_t width, uint32_t height, float minThreshold, float maxThreshold )
+    {
+        simd::Threshold( in, startXIn, startYIn, out, startXOut, startYOut, width, height, minThreshold, maxThreshold, simd::actualSimdType() );
+    }
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <vector>
 #include "image_buffer.h"
 
 namespace Image_Function_Simd
@@ -34,6 +35,34 @@ namespace Image_Function_Simd
     void  BitwiseXor( const Image & in1, uint32_t startX1, uint32_t startY1, const Image & in2, uint32_t startX2, uint32_t startY2,
                       Image & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height );
 
+    // Grayscale morphology works in the same way as in Image_Function namespace, the vertical pass of the filter uses SIMD instructions
+    Image Closing( const Image & in, uint32_t radiusX, uint32_t radiusY );
+    void  Closing( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY );
+    Image Closing( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+    void  Closing( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                   uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
+    Image Dilate( const Image & in, uint32_t radiusX, uint32_t radiusY );
+    void  Dilate( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY );
+    Image Dilate( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+    void  Dilate( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                  uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
+    Image Erode( const Image & in, uint32_t radiusX, uint32_t radiusY );
+    void  Erode( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY );
+    Image Erode( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+    void  Erode( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                 uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
+    // Gamma correction works by formula:
+    // output = A * ((input / 255) ^ gamma) * 255, where A - multiplication, gamma - power base. Both values must be greater than 0
+    // Usually people set A as 1
+    Image GammaCorrection( const Image & in, double a, double gamma );
+    void  GammaCorrection( const Image & in, Image & out, double a, double gamma );
+    Image GammaCorrection( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, double a, double gamma );
+    void  GammaCorrection( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                           uint32_t width, uint32_t height, double a, double gamma );
+
     // Invert function is Bitwise NOT operation. But to make function name more user-friendly we named it like this
     Image Invert( const Image & in );
     void  Invert( const Image & in, Image & out );
@@ -41,6 +70,13 @@ namespace Image_Function_Simd
     void  Invert( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                   uint32_t width, uint32_t height );
 
+    Image LookupTable( const Image & in, const std::vector < uint8_t > & table );
+    void  LookupTable( const Image & in, Image & out, const std::vector < uint8_t > & table );
+    Image LookupTable( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height,
+                       const std::vector < uint8_t > & table );
+    void  LookupTable( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                       uint32_t width, uint32_t height, const std::vector < uint8_t > & table );
+
     Image Maximum( const Image & in1, const Image & in2 );
     void  Maximum( const Image & in1, const Image & in2, Image & out );
     Image Maximum( const Image & in1, uint32_t startX1, uint32_t startY1, const Image & in2, uint32_t startX2, uint32_t startY2,
@@ -55,6 +91,18 @@ namespace Image_Function_Simd
     void  Minimum( const Image & in1, uint32_t startX1, uint32_t startY1, const Image & in2, uint32_t startX2, uint32_t startY2,
                    Image & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height );
 
+    Image Normalize( const Image & in );
+    void  Normalize( const Image & in, Image & out );
+    Image Normalize( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height );
+    void  Normalize( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                     uint32_t width, uint32_t height );
+
+    Image Opening( const Image & in, uint32_t radiusX, uint32_t radiusY );
+    void  Opening( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY );
+    Image Opening( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+    void  Opening( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                   uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
     Image Subtract( const Image & in1, const Image & in2 );
     void  Subtract( const Image & in1, const Image & in2, Image & out );
     Image Subtract( const Image & in1, uint32_t startX1, uint32_t startY1, const Image & in2, uint32_t startX2, uint32_t startY2,
@@ -87,12 +135,119 @@ namespace Image_Function_Simd
     void  Threshold( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                      uint32_t width, uint32_t height, uint8_t minThreshold, uint8_t maxThreshold );
 
+    Image TopHat( const Image & in, uint32_t radiusX, uint32_t radiusY );
+    void  TopHat( const Image & in, Image & out, uint32_t radiusX, uint32_t radiusY );
+    Image TopHat( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+    void  TopHat( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                  uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
+    // Functions below process images with 16-bit and floating point pixels in the same way as Image_Function namespace does
+    Image16Bit AbsoluteDifference( const Image16Bit & in1, const Image16Bit & in2 );
+    void       AbsoluteDifference( const Image16Bit & in1, const Image16Bit & in2, Image16Bit & out );
+    Image16Bit AbsoluteDifference( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                                   uint32_t width, uint32_t height );
+    void       AbsoluteDifference( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                                   Image16Bit & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height );
+
+    ImageFloat AbsoluteDifference( const ImageFloat & in1, const ImageFloat & in2 );
+    void       AbsoluteDifference( const ImageFloat & in1, const ImageFloat & in2, ImageFloat & out );
+    ImageFloat AbsoluteDifference( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                                   uint32_t width, uint32_t height );
+    void       AbsoluteDifference( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                                   ImageFloat & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height );
+
+    Image16Bit Maximum( const Image16Bit & in1, const Image16Bit & in2 );
+    void       Maximum( const Image16Bit & in1, const Image16Bit & in2, Image16Bit & out );
+    Image16Bit Maximum( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                        uint32_t width, uint32_t height );
+    void       Maximum( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                        Image16Bit & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height );
+
+    ImageFloat Maximum( const ImageFloat & in1, const ImageFloat & in2 );
+    void       Maximum( const ImageFloat & in1, const ImageFloat & in2, ImageFloat & out );
+    ImageFloat Maximum( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                        uint32_t width, uint32_t height );
+    void       Maximum( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                        ImageFloat & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height );
+
+    Image16Bit Minimum( const Image16Bit & in1, const Image16Bit & in2 );
+    void       Minimum( const Image16Bit & in1, const Image16Bit & in2, Image16Bit & out );
+    Image16Bit Minimum( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                        uint32_t width, uint32_t height );
+    void       Minimum( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                        Image16Bit & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height );
+
+    ImageFloat Minimum( const ImageFloat & in1, const ImageFloat & in2 );
+    void       Minimum( const ImageFloat & in1, const ImageFloat & in2, ImageFloat & out );
+    ImageFloat Minimum( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                        uint32_t width, uint32_t height );
+    void       Minimum( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                        ImageFloat & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height );
+
+    Image16Bit Subtract( const Image16Bit & in1, const Image16Bit & in2 );
+    void       Subtract( const Image16Bit & in1, const Image16Bit & in2, Image16Bit & out );
+    Image16Bit Subtract( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                         uint32_t width, uint32_t height );
+    void       Subtract( const Image16Bit & in1, uint32_t startX1, uint32_t startY1, const Image16Bit & in2, uint32_t startX2, uint32_t startY2,
+                         Image16Bit & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height );
+
+    ImageFloat Subtract( const ImageFloat & in1, const ImageFloat & in2 );
+    void       Subtract( const ImageFloat & in1, const ImageFloat & in2, ImageFloat & out );
+    ImageFloat Subtract( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                         uint32_t width, uint32_t height );
+    void       Subtract( const ImageFloat & in1, uint32_t startX1, uint32_t startY1, const ImageFloat & in2, uint32_t startX2, uint32_t startY2,
+                         ImageFloat & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height );
+
+    // Thresholding of 16-bit and floating point images works in the same way as for 8-bit images. Output image is always 8-bit
+    Image Threshold( const Image16Bit & in, uint16_t threshold );
+    void  Threshold( const Image16Bit & in, Image & out, uint16_t threshold );
+    Image Threshold( const Image16Bit & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint16_t threshold );
+    void  Threshold( const Image16Bit & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                     uint32_t width, uint32_t height, uint16_t threshold );
+
+    Image Threshold( const ImageFloat & in, float threshold );
+    void  Threshold( const ImageFloat & in, Image & out, float threshold );
+    Image Threshold( const ImageFloat & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, float threshold );
+    void  Threshold( const ImageFloat & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                     uint32_t width, uint32_t height, float threshold );
+
+    Image Threshold( const Image16Bit & in, uint16_t minThreshold, uint16_t maxThreshold );
+    void  Threshold( const Image16Bit & in, Image & out, uint16_t minThreshold, uint16_t maxThreshold );
+    Image Threshold( const Image16Bit & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, uint16_t minThreshold,
+                     uint16_t maxThreshold );
+    void  Threshold( const Image16Bit & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                     uint32_t width, uint32_t height, uint16_t minThreshold, uint16_t maxThreshold );
+
+    Image Threshold( const ImageFloat & in, float minThreshold, float maxThreshold );
+    void  Threshold( const ImageFloat & in, Image & out, float minThreshold, float maxThreshold );
+    Image Threshold( const ImageFloat & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height, float minThreshold,
+                     float maxThreshold );
+    void  Threshold( const ImageFloat & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
+                     uint32_t width, uint32_t height, float minThreshold, float maxThreshold );
+
     // This namespace is designed only for testing simd technique functions individually
     namespace Simd_Activation
     {
         void EnableSimd( bool enable );
+        void EnableAvx512( bool enable );
         void EnableAvx( bool enable );
         void EnableSse( bool enable );
         void EnableNeon( bool enable );
     }
 }
+
+namespace simd
+{
+    enum SIMDType
+    {
+        avx512_function,
+        avx_function,
+        sse_function,
+        neon_function,
+        cpu_function
+    };
+
+    // The most advanced SIMD technique which is available on CPU and is not disabled by Simd_Activation functions
+    // Other parts of the library which have own SIMD code must choose it by this function
+    SIMDType actualSimdType();
+}
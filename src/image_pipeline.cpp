@@ -0,0 +1,289 @@
+#include <algorithm>
+#include "image_pipeline.h"
+#include "parameter_validation.h"
+#include "penguinv/penguinv.h"
+
+namespace
+{
+    // Maximum size of a tile in bytes. Input and output tiles of all operations must fit into L1 cache together
+    const uint32_t tileSize = 8192u;
+}
+
+namespace Image_Pipeline
+{
+    Pipeline::Pipeline( const Image & in )
+        : _in      ( &in )
+        , _startXIn( 0 )
+        , _startYIn( 0 )
+        , _width   ( in.width() )
+        , _height  ( in.height() )
+    {
+    }
+
+    Pipeline::Pipeline( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height )
+        : _in      ( &in )
+        , _startXIn( startXIn )
+        , _startYIn( startYIn )
+        , _width   ( width )
+        , _height  ( height )
+    {
+        Image_Function::ParameterValidation( in, startXIn, startYIn, width, height );
+    }
+
+    Pipeline & Pipeline::absoluteDifference( const Image & in )
+    {
+        return _add( ABSOLUTE_DIFFERENCE, in, 0, 0 );
+    }
+
+    Pipeline & Pipeline::absoluteDifference( const Image & in, uint32_t startX, uint32_t startY )
+    {
+        return _add( ABSOLUTE_DIFFERENCE, in, startX, startY );
+    }
+
+    Pipeline & Pipeline::bitwiseAnd( const Image & in )
+    {
+        return _add( BITWISE_AND, in, 0, 0 );
+    }
+
+    Pipeline & Pipeline::bitwiseAnd( const Image & in, uint32_t startX, uint32_t startY )
+    {
+        return _add( BITWISE_AND, in, startX, startY );
+    }
+
+    Pipeline & Pipeline::bitwiseOr( const Image & in )
+    {
+        return _add( BITWISE_OR, in, 0, 0 );
+    }
+
+    Pipeline & Pipeline::bitwiseOr( const Image & in, uint32_t startX, uint32_t startY )
+    {
+        return _add( BITWISE_OR, in, startX, startY );
+    }
+
+    Pipeline & Pipeline::bitwiseXor( const Image & in )
+    {
+        return _add( BITWISE_XOR, in, 0, 0 );
+    }
+
+    Pipeline & Pipeline::bitwiseXor( const Image & in, uint32_t startX, uint32_t startY )
+    {
+        return _add( BITWISE_XOR, in, startX, startY );
+    }
+
+    Pipeline & Pipeline::maximum( const Image & in )
+    {
+        return _add( MAXIMUM, in, 0, 0 );
+    }
+
+    Pipeline & Pipeline::maximum( const Image & in, uint32_t startX, uint32_t startY )
+    {
+        return _add( MAXIMUM, in, startX, startY );
+    }
+
+    Pipeline & Pipeline::minimum( const Image & in )
+    {
+        return _add( MINIMUM, in, 0, 0 );
+    }
+
+    Pipeline & Pipeline::minimum( const Image & in, uint32_t startX, uint32_t startY )
+    {
+        return _add( MINIMUM, in, startX, startY );
+    }
+
+    Pipeline & Pipeline::subtract( const Image & in )
+    {
+        return _add( SUBTRACT, in, 0, 0 );
+    }
+
+    Pipeline & Pipeline::subtract( const Image & in, uint32_t startX, uint32_t startY )
+    {
+        return _add( SUBTRACT, in, startX, startY );
+    }
+
+    Pipeline & Pipeline::invert()
+    {
+        return _add( INVERT, 0, 0 );
+    }
+
+    Pipeline & Pipeline::lookupTable( const std::vector < uint8_t > & table )
+    {
+        if( table.size() != 256u )
+            throw imageException( "Lookup table size is not equal to 256" );
+
+        _add( LOOKUP_TABLE, 0, 0 );
+        _operation.back().table = table;
+
+        return (*this);
+    }
+
+    Pipeline & Pipeline::threshold( uint8_t threshold )
+    {
+        return _add( THRESHOLD, threshold, 0 );
+    }
+
+    Pipeline & Pipeline::threshold( uint8_t minThreshold, uint8_t maxThreshold )
+    {
+        if( minThreshold > maxThreshold )
+            throw imageException( "Minimum threshold value is bigger than maximum threshold value" );
+
+        return _add( THRESHOLD_DOUBLE, minThreshold, maxThreshold );
+    }
+
+    size_t Pipeline::size() const
+    {
+        return _operation.size();
+    }
+
+    void Pipeline::clear()
+    {
+        _operation.clear();
+    }
+
+    Image Pipeline::execute() const
+    {
+        Image out = _in->generate( _width, _height, _in->colorCount() );
+
+        execute( out, 0, 0 );
+
+        return out;
+    }
+
+    void Pipeline::execute( Image & out ) const
+    {
+        execute( out, 0, 0 );
+    }
+
+    void Pipeline::execute( Image & out, uint32_t startXOut, uint32_t startYOut ) const
+    {
+        Image_Function::ParameterValidation( *_in, _startXIn, _startYIn, out, startXOut, startYOut, _width, _height );
+        const uint8_t colorCount = Image_Function::CommonColorCount( *_in, out );
+
+        if( _in == &out && (_startXIn != startXOut || _startYIn != startYOut) )
+            throw imageException( "Output image area must be the same as input image area" );
+
+        // Parameters of all operations are verified before the first tile so output image is not changed partially in case of an error
+        for( std::vector < Operation >::const_iterator operation = _operation.begin(); operation != _operation.end(); ++operation ) {
+            if( operation->image != nullptr ) {
+                if( operation->image == &out )
+                    throw imageException( "Output image cannot be used as a second image in pipeline" );
+
+                Image_Function::ParameterValidation( *(operation->image), operation->startX, operation->startY, _width, _height );
+                Image_Function::CommonColorCount( *_in, *(operation->image) );
+            }
+
+            if( operation->type == THRESHOLD || operation->type == THRESHOLD_DOUBLE )
+                Image_Function::VerifyGrayScaleImage( *_in, out );
+        }
+
+        if( _operation.empty() ) {
+            if( _in != &out )
+                penguinV::Copy( *_in, _startXIn, _startYIn, out, startXOut, startYOut, _width, _height );
+            return;
+        }
+
+        // A tile contains several full rows for narrow images or a part of a row for wide images
+        const uint32_t rowSize = _width * colorCount;
+
+        uint32_t tileWidth  = _width;
+        uint32_t tileHeight = 1u;
+
+        if( rowSize > tileSize )
+            tileWidth = std::max( tileSize / colorCount, 1u );
+        else
+            tileHeight = std::min( tileSize / rowSize, _height );
+
+        for( uint32_t y = 0; y < _height; y += tileHeight ) {
+            const uint32_t height = std::min( tileHeight, _height - y );
+
+            for( uint32_t x = 0; x < _width; x += tileWidth ) {
+                const uint32_t width = std::min( tileWidth, _width - x );
+
+                std::vector < Operation >::const_iterator operation = _operation.begin();
+
+                // first operation reads input image, all others are done in place within output image tile which is still in cache
+                _run( *operation, *_in, _startXIn + x, _startYIn + y, out, startXOut + x, startYOut + y, x, y, width, height );
+
+                for( ++operation; operation != _operation.end(); ++operation )
+                    _run( *operation, out, startXOut + x, startYOut + y, out, startXOut + x, startYOut + y, x, y, width, height );
+            }
+        }
+    }
+
+    Pipeline & Pipeline::_add( OperationType type, const Image & in, uint32_t startX, uint32_t startY )
+    {
+        Image_Function::ParameterValidation( in, startX, startY, _width, _height );
+
+        Operation operation;
+        operation.type         = type;
+        operation.image        = &in;
+        operation.startX       = startX;
+        operation.startY       = startY;
+        operation.minThreshold = 0;
+        operation.maxThreshold = 0;
+
+        _operation.push_back( operation );
+
+        return (*this);
+    }
+
+    Pipeline & Pipeline::_add( OperationType type, uint8_t minThreshold, uint8_t maxThreshold )
+    {
+        Operation operation;
+        operation.type         = type;
+        operation.image        = nullptr;
+        operation.startX       = 0;
+        operation.startY       = 0;
+        operation.minThreshold = minThreshold;
+        operation.maxThreshold = maxThreshold;
+
+        _operation.push_back( operation );
+
+        return (*this);
+    }
+
+    void Pipeline::_run( const Operation & operation, const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out,
+                         uint32_t startXOut, uint32_t startYOut, uint32_t offsetX, uint32_t offsetY, uint32_t width, uint32_t height ) const
+    {
+        const uint32_t startX = operation.startX + offsetX;
+        const uint32_t startY = operation.startY + offsetY;
+
+        switch( operation.type ) {
+            case ABSOLUTE_DIFFERENCE:
+                penguinV::AbsoluteDifference( in, startXIn, startYIn, *operation.image, startX, startY, out, startXOut, startYOut, width, height );
+                break;
+            case BITWISE_AND:
+                penguinV::BitwiseAnd( in, startXIn, startYIn, *operation.image, startX, startY, out, startXOut, startYOut, width, height );
+                break;
+            case BITWISE_OR:
+                penguinV::BitwiseOr( in, startXIn, startYIn, *operation.image, startX, startY, out, startXOut, startYOut, width, height );
+                break;
+            case BITWISE_XOR:
+                penguinV::BitwiseXor( in, startXIn, startYIn, *operation.image, startX, startY, out, startXOut, startYOut, width, height );
+                break;
+            case INVERT:
+                penguinV::Invert( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+                break;
+            case LOOKUP_TABLE:
+                penguinV::LookupTable( in, startXIn, startYIn, out, startXOut, startYOut, width, height, operation.table );
+                break;
+            case MAXIMUM:
+                penguinV::Maximum( in, startXIn, startYIn, *operation.image, startX, startY, out, startXOut, startYOut, width, height );
+                break;
+            case MINIMUM:
+                penguinV::Minimum( in, startXIn, startYIn, *operation.image, startX, startY, out, startXOut, startYOut, width, height );
+                break;
+            case SUBTRACT:
+                penguinV::Subtract( in, startXIn, startYIn, *operation.image, startX, startY, out, startXOut, startYOut, width, height );
+                break;
+            case THRESHOLD:
+                penguinV::Threshold( in, startXIn, startYIn, out, startXOut, startYOut, width, height, operation.minThreshold );
+                break;
+            case THRESHOLD_DOUBLE:
+                penguinV::Threshold( in, startXIn, startYIn, out, startXOut, startYOut, width, height, operation.minThreshold,
+                                     operation.maxThreshold );
+                break;
+            default:
+                throw imageException( "Unknown pipeline operation" );
+        }
+    }
+}
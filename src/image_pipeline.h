@@ -0,0 +1,103 @@
+#pragma once
+#include <vector>
+#include "image_buffer.h"
+
+namespace Image_Pipeline
+{
+    using namespace PenguinV_Image;
+
+    // This class records a chain of per-pixel operations and executes all of them in a single pass
+    // Every operation takes a result of previous operation as its first input so the chain
+    //     Pipeline( in1 ).subtract( in2 ).absoluteDifference( in3 ).threshold( 128 ).bitwiseAnd( mask ).execute( out )
+    // is equal to calls of Subtract, AbsoluteDifference, Threshold and BitwiseAnd functions with temporary images between them
+    // An image is processed by small tiles which fit into CPU cache: all operations are applied to a tile before moving
+    // to next tile, so input images are read once and output image is written once without any intermediate buffers
+    // Operations of every tile are taken from penguinV::functionTable( width, height ) of the tile. Tiles always fit into
+    // SMALL_AREA size class so an optimized table gives CPU or SIMD implementations for them and never Function_Pool ones
+    // Pipeline doesn't own images: all images must exist until execute() function is called
+    class Pipeline
+    {
+    public:
+        explicit Pipeline( const Image & in );
+        Pipeline( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width, uint32_t height );
+
+        // Operations with second image. A second image must have the same color count as an input image
+        Pipeline & absoluteDifference( const Image & in );
+        Pipeline & absoluteDifference( const Image & in, uint32_t startX, uint32_t startY );
+
+        Pipeline & bitwiseAnd( const Image & in );
+        Pipeline & bitwiseAnd( const Image & in, uint32_t startX, uint32_t startY );
+
+        Pipeline & bitwiseOr( const Image & in );
+        Pipeline & bitwiseOr( const Image & in, uint32_t startX, uint32_t startY );
+
+        Pipeline & bitwiseXor( const Image & in );
+        Pipeline & bitwiseXor( const Image & in, uint32_t startX, uint32_t startY );
+
+        Pipeline & maximum( const Image & in );
+        Pipeline & maximum( const Image & in, uint32_t startX, uint32_t startY );
+
+        Pipeline & minimum( const Image & in );
+        Pipeline & minimum( const Image & in, uint32_t startX, uint32_t startY );
+
+        Pipeline & subtract( const Image & in );
+        Pipeline & subtract( const Image & in, uint32_t startX, uint32_t startY );
+
+        // Operations with a single image. Threshold operations require gray-scale input and output images
+        Pipeline & invert();
+        Pipeline & lookupTable( const std::vector < uint8_t > & table );
+        Pipeline & threshold( uint8_t threshold );
+        Pipeline & threshold( uint8_t minThreshold, uint8_t maxThreshold );
+
+        size_t size() const; // number of recorded operations
+        void clear(); // remove all recorded operations
+
+        // Output image can be the same as input image but it cannot be used as a second image of any operation
+        Image execute() const;
+        void  execute( Image & out ) const;
+        void  execute( Image & out, uint32_t startXOut, uint32_t startYOut ) const;
+
+    private:
+        enum OperationType
+        {
+            ABSOLUTE_DIFFERENCE,
+            BITWISE_AND,
+            BITWISE_OR,
+            BITWISE_XOR,
+            INVERT,
+            LOOKUP_TABLE,
+            MAXIMUM,
+            MINIMUM,
+            SUBTRACT,
+            THRESHOLD,
+            THRESHOLD_DOUBLE
+        };
+
+        struct Operation
+        {
+            OperationType type;
+
+            const Image * image; // second image, used only by operations with 2 images
+            uint32_t startX;
+            uint32_t startY;
+
+            uint8_t minThreshold;
+            uint8_t maxThreshold;
+            std::vector < uint8_t > table;
+        };
+
+        const Image * _in;
+        uint32_t _startXIn;
+        uint32_t _startYIn;
+        uint32_t _width;
+        uint32_t _height;
+
+        std::vector < Operation > _operation;
+
+        Pipeline & _add( OperationType type, const Image & in, uint32_t startX, uint32_t startY );
+        Pipeline & _add( OperationType type, uint8_t minThreshold, uint8_t maxThreshold );
+
+        void _run( const Operation & operation, const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out,
+                   uint32_t startXOut, uint32_t startYOut, uint32_t offsetX, uint32_t offsetY, uint32_t width, uint32_t height ) const;
+    };
+}
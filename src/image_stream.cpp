@@ -0,0 +1,248 @@
+#include <algorithm>
+#include "image_exception.h"
+#include "image_stream.h"
+#include "parameter_validation.h"
+
+namespace
+{
+    void validateSize( uint32_t width, uint32_t height, uint8_t colorCount )
+    {
+        if( width == 0 || height == 0 || colorCount == 0 )
+            throw imageException( "Invalid size of an image in a stream" );
+    }
+
+    void validateRows( const PenguinV_Image::Image & image, uint32_t startY, uint32_t height, uint32_t width, uint32_t imageHeight,
+                       uint8_t colorCount )
+    {
+        if( image.empty() || image.width() != width || image.colorCount() != colorCount || height == 0 ||
+            startY + height < height || startY + height > imageHeight )
+            throw imageException( "Bad input parameters in image stream function" );
+    }
+}
+
+namespace Image_Stream
+{
+    RawReader::RawReader( const std::string & path, uint32_t width_, uint32_t height_, uint8_t colorCount_ )
+        : _width     ( width_ )
+        , _height    ( height_ )
+        , _colorCount( colorCount_ )
+    {
+        validateSize( _width, _height, _colorCount );
+
+        _file.open( path, std::fstream::in | std::fstream::binary );
+
+        if( !_file )
+            throw imageException( "Cannot open file for reading" );
+
+        _file.seekg( 0, _file.end );
+        const std::streamoff length = _file.tellg();
+
+        if( length == std::char_traits<char>::pos_type( -1 ) ||
+            static_cast<uint64_t>(length) < static_cast<uint64_t>(_width) * _colorCount * _height )
+            throw imageException( "File size is less than image size" );
+    }
+
+    uint32_t RawReader::width() const
+    {
+        return _width;
+    }
+
+    uint32_t RawReader::height() const
+    {
+        return _height;
+    }
+
+    uint8_t RawReader::colorCount() const
+    {
+        return _colorCount;
+    }
+
+    void RawReader::read( uint32_t startY, Image & image )
+    {
+        validateRows( image, startY, image.height(), _width, _height, _colorCount );
+
+        const uint32_t lineLength = _width * _colorCount;
+
+        _file.seekg( static_cast<std::streamoff>(startY) * lineLength, _file.beg );
+
+        uint8_t * imageY = image.data();
+        const uint8_t * imageYEnd = imageY + image.height() * image.rowSize();
+
+        for( ; imageY != imageYEnd; imageY += image.rowSize() )
+            _file.read( reinterpret_cast<char *>(imageY), lineLength );
+
+        if( !_file )
+            throw imageException( "Cannot read image rows from file" );
+    }
+
+    RawWriter::RawWriter( const std::string & path, uint32_t width_, uint32_t height_, uint8_t colorCount_ )
+        : _width     ( width_ )
+        , _height    ( height_ )
+        , _colorCount( colorCount_ )
+    {
+        validateSize( _width, _height, _colorCount );
+
+        _file.open( path, std::fstream::out | std::fstream::trunc | std::fstream::binary );
+
+        if( !_file )
+            throw imageException( "Cannot create file for saving" );
+    }
+
+    uint32_t RawWriter::width() const
+    {
+        return _width;
+    }
+
+    uint32_t RawWriter::height() const
+    {
+        return _height;
+    }
+
+    uint8_t RawWriter::colorCount() const
+    {
+        return _colorCount;
+    }
+
+    void RawWriter::write( uint32_t startY, const Image & image, uint32_t startYIn, uint32_t height_ )
+    {
+        validateRows( image, startY, height_, _width, _height, _colorCount );
+        Image_Function::ParameterValidation( image, 0, startYIn, image.width(), height_ );
+
+        const uint32_t lineLength = _width * _colorCount;
+
+        _file.seekp( static_cast<std::streamoff>(startY) * lineLength, _file.beg );
+
+        const uint8_t * imageY = image.data() + startYIn * image.rowSize();
+        const uint8_t * imageYEnd = imageY + height_ * image.rowSize();
+
+        for( ; imageY != imageYEnd; imageY += image.rowSize() )
+            _file.write( reinterpret_cast<const char *>(imageY), lineLength );
+
+        if( !_file )
+            throw imageException( "Cannot write image rows into file" );
+    }
+
+    StreamExecutor::StreamExecutor( uint32_t bandHeight_, uint32_t halo_, uint32_t bandCount_ )
+        : _bandHeight( bandHeight_ )
+        , _halo      ( halo_ )
+        , _bandCount ( bandCount_ )
+        , _active    ( 0 )
+        , _operation ( nullptr )
+    {
+        if( _bandHeight == 0 )
+            throw imageException( "Band height cannot be zero" );
+
+        _activeBandCount[0] = 0;
+        _activeBandCount[1] = 0;
+    }
+
+    uint32_t StreamExecutor::bandHeight() const
+    {
+        return _bandHeight;
+    }
+
+    uint32_t StreamExecutor::halo() const
+    {
+        return _halo;
+    }
+
+    uint32_t StreamExecutor::bandCount() const
+    {
+        return _bandCount;
+    }
+
+    void StreamExecutor::execute( ImageReader & reader, ImageWriter & writer, const Operation & operation )
+    {
+        if( reader.width() != writer.width() || reader.height() != writer.height() || !operation )
+            throw imageException( "Bad input parameters in image stream function" );
+
+        const size_t threadCount = Thread_Pool::ThreadPoolMonoid::instance().threadCount();
+        if( threadCount == 0 )
+            throw imageException( "Thread Pool is not initialized." );
+
+        const size_t bandCount = (_bandCount > 0) ? _bandCount : threadCount;
+
+        for( size_t i = 0; i < 2; ++i ) {
+            _band[i].resize( bandCount );
+            _activeBandCount[i] = 0;
+        }
+
+        _operation = &operation;
+        _active = 0;
+
+        uint32_t startY = _read( reader, writer, _band[_active], _activeBandCount[_active], 0 );
+
+        while( _activeBandCount[_active] > 0 ) {
+            const size_t next = 1 - _active;
+
+            _run( _activeBandCount[_active] );
+
+            // tasks refer to band images so they must be completed even if reading or writing fails
+            try {
+                _write( writer, _band[next], _activeBandCount[next] );
+                startY = _read( reader, writer, _band[next], _activeBandCount[next], startY );
+            }
+            catch( ... ) {
+                _wait();
+                throw;
+            }
+
+            if( !_wait() ) {
+                throw imageException( "An exception raised during task execution in stream executor" );
+            }
+
+            // processed bands are written and read bands are processed at next step
+            _active = next;
+        }
+
+        _write( writer, _band[1 - _active], _activeBandCount[1 - _active] );
+
+        _operation = nullptr;
+    }
+
+    void StreamExecutor::_task( size_t taskId )
+    {
+        Band & band = _band[_active][taskId];
+
+        (*_operation)( band.in, band.out );
+    }
+
+    uint32_t StreamExecutor::_read( ImageReader & reader, ImageWriter & writer, std::vector < Band > & band, size_t & bandCount,
+                                    uint32_t startY )
+    {
+        const uint32_t height = reader.height();
+
+        bandCount = 0;
+
+        for( std::vector < Band >::iterator current = band.begin(); current != band.end() && startY < height; ++current ) {
+            current->startY  = startY;
+            current->height  = std::min( _bandHeight, height - startY );
+            current->haloTop = std::min( _halo, startY );
+
+            const uint32_t haloBottom = std::min( _halo, height - startY - current->height );
+            const uint32_t fullHeight = current->haloTop + current->height + haloBottom;
+
+            // images are reallocated only when height of a band changes, usually for the last band
+            current->in.setColorCount( reader.colorCount() );
+            current->in.resize( reader.width(), fullHeight );
+
+            current->out.setColorCount( writer.colorCount() );
+            current->out.resize( writer.width(), fullHeight );
+
+            reader.read( startY - current->haloTop, current->in );
+
+            startY += current->height;
+            ++bandCount;
+        }
+
+        return startY;
+    }
+
+    void StreamExecutor::_write( ImageWriter & writer, const std::vector < Band > & band, size_t & bandCount )
+    {
+        for( size_t i = 0; i < bandCount; ++i )
+            writer.write( band[i].startY, band[i].out, band[i].haloTop, band[i].height );
+
+        bandCount = 0;
+    }
+}
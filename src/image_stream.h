@@ -0,0 +1,131 @@
+#pragma once
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+#include "image_buffer.h"
+#include "thread_pool.h"
+
+namespace Image_Stream
+{
+    using namespace PenguinV_Image;
+
+    // Source of image rows for images which do not fit into memory
+    class ImageReader
+    {
+    public:
+        virtual ~ImageReader() {}
+
+        virtual uint32_t width() const = 0;
+        virtual uint32_t height() const = 0;
+        virtual uint8_t colorCount() const = 0;
+
+        // reads rows [startY, startY + image.height()) into an image of the same width and color count
+        virtual void read( uint32_t startY, Image & image ) = 0;
+    };
+
+    // Destination of image rows for images which do not fit into memory
+    class ImageWriter
+    {
+    public:
+        virtual ~ImageWriter() {}
+
+        virtual uint32_t width() const = 0;
+        virtual uint32_t height() const = 0;
+        virtual uint8_t colorCount() const = 0;
+
+        // writes [height] rows of an image starting from row startYIn into rows [startY, startY + height)
+        virtual void write( uint32_t startY, const Image & image, uint32_t startYIn, uint32_t height ) = 0;
+    };
+
+    // Raw file contains only pixel data: rows go from top to bottom without any padding
+    class RawReader : public ImageReader
+    {
+    public:
+        RawReader( const std::string & path, uint32_t width, uint32_t height, uint8_t colorCount = 1u );
+
+        virtual uint32_t width() const;
+        virtual uint32_t height() const;
+        virtual uint8_t colorCount() const;
+
+        virtual void read( uint32_t startY, Image & image );
+    private:
+        std::fstream _file;
+        uint32_t _width;
+        uint32_t _height;
+        uint8_t _colorCount;
+    };
+
+    class RawWriter : public ImageWriter
+    {
+    public:
+        RawWriter( const std::string & path, uint32_t width, uint32_t height, uint8_t colorCount = 1u );
+
+        virtual uint32_t width() const;
+        virtual uint32_t height() const;
+        virtual uint8_t colorCount() const;
+
+        virtual void write( uint32_t startY, const Image & image, uint32_t startYIn, uint32_t height );
+    private:
+        std::fstream _file;
+        uint32_t _width;
+        uint32_t _height;
+        uint8_t _colorCount;
+    };
+
+    // This class processes an image from a reader by horizontal bands and writes results into a writer so memory usage
+    // depends only on band height and image width, not on image height
+    // Every band is read together with [halo] rows above and below it (less at the top and bottom of an image) so
+    // neighbourhood operations like filters give the same result as for a whole image: halo must be at least a radius
+    // of a kernel (kernel size / 2 for Median or Convolve, kernel size for GaussianBlur)
+    // Several bands are processed in parallel on global thread pool while the calling thread writes results of previous
+    // bands and reads next bands, so file operations overlap with computations
+    class StreamExecutor : public Thread_Pool::TaskProviderSingleton
+    {
+    public:
+        // Operation gets an input band with halo rows and an output image of the same width and height with color count
+        // of the writer, for example:
+        //     []( const Image & in, Image & out ) { Image_Function::GaussianBlur( in, out, 2, 1.5f ); }
+        // Halo rows of the output image are not written. Operation is called from several threads at the same time
+        // Operation runs inside a task of global thread pool so it must be single-threaded: use Image_Function (including
+        // filters) or Image_Function_Simd functions. Function_Pool functions and penguinV::functionTable() functions
+        // (which may be tuned to thread pool versions by penguinV::OptimizeFunctionTable) wait for tasks of the same
+        // thread pool whose threads are busy with bands and lead to a deadlock
+        typedef std::function < void( const Image & in, Image & out ) > Operation;
+
+        // bandCount is a number of bands processed in parallel, 0 means a number of threads in thread pool
+        explicit StreamExecutor( uint32_t bandHeight = 256u, uint32_t halo = 0u, uint32_t bandCount = 0u );
+
+        void execute( ImageReader & reader, ImageWriter & writer, const Operation & operation );
+
+        uint32_t bandHeight() const;
+        uint32_t halo() const;
+        uint32_t bandCount() const;
+    protected:
+        virtual void _task( size_t taskId );
+    private:
+        struct Band
+        {
+            uint32_t startY;  // first row of the band without halo
+            uint32_t height;  // height of the band without halo
+            uint32_t haloTop; // number of halo rows above the band
+
+            Image in;
+            Image out;
+        };
+
+        uint32_t _bandHeight;
+        uint32_t _halo;
+        uint32_t _bandCount;
+
+        std::vector < Band > _band[2]; // bands being processed and bands being read or written at the same time
+        size_t _activeBandCount[2];
+        size_t _active;
+
+        const Operation * _operation;
+
+        // reads bands starting from startY row and returns the first row after them
+        uint32_t _read( ImageReader & reader, ImageWriter & writer, std::vector < Band > & band, size_t & bandCount, uint32_t startY );
+        void _write( ImageWriter & writer, const std::vector < Band > & band, size_t & bandCount );
+    };
+}
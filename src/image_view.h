@@ -0,0 +1,94 @@
+#pragma once
+
+#include "image_buffer.h"
+#include "image_exception.h"
+
+namespace PenguinV_Image
+{
+    // Non-owning view of a rectangular area of an image. A view has the same row size (stride) as the parent image
+    // so it can be passed into any function accepting an image (Image_Function, Image_Function_Simd, Function_Pool)
+    // instead of passing area coordinates or copying the area into a new image.
+    // A view never frees memory and it must not outlive the parent image. Resizing a view or assigning an image to it
+    // turns it into an ordinary image with own memory while a copy of a view refers to the same area
+    template <typename TColorDepth>
+    class ImageViewTemplate : public ImageTemplate<TColorDepth>
+    {
+    public:
+        ImageViewTemplate()
+        {
+        }
+
+        explicit ImageViewTemplate( ImageTemplate<TColorDepth> & image )
+        {
+            _set( image.data(), image.width(), image.height(), image.colorCount(), image.rowSize(), image.type() );
+        }
+
+        ImageViewTemplate( ImageTemplate<TColorDepth> & image, uint32_t x, uint32_t y, uint32_t width_, uint32_t height_ )
+        {
+            if( image.empty() || width_ == 0 || height_ == 0 || x + width_ < width_ || y + height_ < height_ ||
+                x + width_ > image.width() || y + height_ > image.height() )
+                throw imageException( "Image view area is out of image bounds" );
+
+            _set( image.data() + y * image.rowSize() + x * image.colorCount(), width_, height_, image.colorCount(), image.rowSize(),
+                  image.type() );
+        }
+
+        ImageViewTemplate( const ImageViewTemplate & view )
+            : ImageTemplate<TColorDepth>()
+        {
+            _set( const_cast<TColorDepth *>( view.data() ), view.width(), view.height(), view.colorCount(), view.rowSize(), view.type() );
+        }
+
+        ImageViewTemplate & operator=( const ImageViewTemplate & view )
+        {
+            if( this != &view )
+                _set( const_cast<TColorDepth *>( view.data() ), view.width(), view.height(), view.colorCount(), view.rowSize(), view.type() );
+
+            return (*this);
+        }
+    private:
+        void _set( TColorDepth * data_, uint32_t width_, uint32_t height_, uint8_t colorCount_, uint32_t rowSize_, uint8_t type_ )
+        {
+            if( data_ == nullptr )
+                ImageTemplate<TColorDepth>::clear();
+            else
+                ImageTemplate<TColorDepth>::_setView( data_, width_, height_, colorCount_, rowSize_, type_ );
+        }
+    };
+
+    // Read-only view of an area of an image. It is implicitly converted into a constant image so it can be used
+    // as an input of any function but it cannot be passed as an output
+    template <typename TColorDepth>
+    class ConstImageViewTemplate
+    {
+    public:
+        ConstImageViewTemplate()
+        {
+        }
+
+        explicit ConstImageViewTemplate( const ImageTemplate<TColorDepth> & image )
+            : _view( const_cast<ImageTemplate<TColorDepth> &>( image ) )
+        {
+        }
+
+        ConstImageViewTemplate( const ImageTemplate<TColorDepth> & image, uint32_t x, uint32_t y, uint32_t width_, uint32_t height_ )
+            : _view( const_cast<ImageTemplate<TColorDepth> &>( image ), x, y, width_, height_ )
+        {
+        }
+
+        operator const ImageTemplate<TColorDepth> &() const
+        {
+            return _view;
+        }
+
+        const ImageTemplate<TColorDepth> & image() const
+        {
+            return _view;
+        }
+    private:
+        ImageViewTemplate<TColorDepth> _view;
+    };
+
+    typedef ImageViewTemplate <uint8_t> ImageView;
+    typedef ConstImageViewTemplate <uint8_t> ConstImageView;
+}
@@ -0,0 +1,434 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "memory_allocator.h"
+#include "../image_exception.h"
+
+namespace Cpu_Memory
+{
+    // Lock for very short critical sections which never goes to the kernel while a lock is free
+    class SpinLock
+    {
+    public:
+        SpinLock()
+        {
+            _flag.clear();
+        }
+
+        void lock()
+        {
+            while( _flag.test_and_set( std::memory_order_acquire ) )
+                std::this_thread::yield();
+        }
+
+        void unlock()
+        {
+            _flag.clear( std::memory_order_release );
+        }
+    private:
+        std::atomic_flag _flag;
+
+        SpinLock( const SpinLock & ) = delete;
+        SpinLock & operator=( const SpinLock & ) = delete;
+    };
+
+    // Class for memory allocation in CPU memory
+    class MemoryAllocator : public BaseMemoryAllocator
+    {
+    public:
+        // Modes of free memory tracking:
+        // - SET_FREE_LIST: free chunks are kept in sets of BaseMemoryAllocator under a common lock
+        // - INTRUSIVE_FREE_LIST: free chunks are linked through their own memory in a list per level and a bitmask shows
+        //   non-empty levels so no memory is allocated for bookkeeping. Freed chunks are kept in small caches first:
+        //   every thread uses its own cache (selected by thread ID) so allocations and deallocations of the same sizes
+        //   (for example, frames of a video stream) do not wait for a common lock. A cache holds at most 1/16 of preallocated
+        //   memory and all caches are returned to the lists (merging buddies) when the lists have no chunk of required size
+        enum FreeListMode
+        {
+            SET_FREE_LIST,
+            INTRUSIVE_FREE_LIST
+        };
+
+        explicit MemoryAllocator( size_t availableSpace = std::numeric_limits<size_t>::max(), FreeListMode mode = INTRUSIVE_FREE_LIST )
+            : BaseMemoryAllocator( availableSpace )
+            , _mode              ( mode )
+            , _memory            ( nullptr )
+            , _data              ( nullptr )
+            , _allocatedCount    ( 0 )
+            , _levelCount        ( 0 )
+            , _nonEmptyLevel     ( 0 )
+            , _cache             ( cacheCount )
+            , _cacheCapacity     ( 0 )
+        {
+        }
+
+        virtual ~MemoryAllocator()
+        {
+            _free();
+        }
+
+        // the same as BaseMemoryAllocator::reserve() but free chunks are moved into intrusive lists for INTRUSIVE_FREE_LIST mode
+        virtual void reserve( size_t size )
+        {
+            BaseMemoryAllocator::reserve( size );
+
+            if( _mode == INTRUSIVE_FREE_LIST ) {
+                // chunks smaller than minimum size are never used
+                for( uint8_t level = minimumLevel; level < _freeChunck.size(); ++level ) {
+                    for( std::set < size_t >::const_iterator offset = _freeChunck[level].begin(); offset != _freeChunck[level].end(); ++offset )
+                        _link( *offset, level );
+                }
+
+                _freeChunck.clear();
+            }
+        }
+
+        // this function returns a pointer to an allocated memory
+        // if memory size on allocated chuck of memory is enough for requested size
+        // so the function just assigns a pointer to preallocated memory
+        // otherwise (or for small sizes) the function will allocate a new chuck of memory just for this pointer
+        template <typename _DataType = uint8_t>
+        _DataType * allocate( size_t size = 1 )
+        {
+            size = size * sizeof( _DataType );
+
+            if( _data != nullptr && size >= (static_cast<size_t>(1) << minimumLevel) && size <= _size ) {
+                const uint8_t level = _getAllocationLevel( size );
+                size_t offset = 0;
+
+                if( level < _levelCount && _take( level, offset ) ) {
+                    _chunkLevel[offset >> minimumLevel] = level;
+
+                    ++_allocatedCount;
+                    return reinterpret_cast<_DataType *>( _data + offset );
+                }
+            }
+
+            // if no space in preallocated memory just allocate as usual memory
+            void * address = malloc( size );
+            if( address == nullptr )
+                throw imageException( "Cannot allocate CPU memory" );
+
+            return reinterpret_cast<_DataType *>( address );
+        }
+
+        // deallocates a memory by input address
+        // if a pointer points on allocated chuck of memory inside the allocator then
+        // the allocator returns the chunk into free chunks (or a cache of current thread)
+        // otherwise the memory is returned to the heap
+        void free( void * address )
+        {
+            uint8_t * data = reinterpret_cast<uint8_t *>( address );
+
+            if( _data != nullptr && data >= _data && data < _data + _size ) {
+                const size_t offset = static_cast<size_t>( data - _data );
+
+                --_allocatedCount;
+
+                _give( offset, _chunkLevel[offset >> minimumLevel] );
+                return;
+            }
+
+            ::free( address );
+        }
+
+        // returns a number of chunks allocated from preallocated memory and not freed yet
+        size_t allocatedCount() const
+        {
+            return _allocatedCount;
+        }
+
+        FreeListMode mode() const
+        {
+            return _mode;
+        }
+    private:
+        // Allocations smaller than 2^minimumLevel bytes are not taken from preallocated memory
+        static const uint8_t minimumLevel = 12u;
+        static const size_t cacheCount = 16u; // number of caches for threads
+        static const size_t cacheSize = 2u;   // maximum number of chunks of one size in a cache
+
+        static const size_t noChunk = std::numeric_limits<size_t>::max();
+
+        struct Cache
+        {
+            Cache()
+                : size( 0 )
+            { }
+
+            SpinLock lock;
+            std::vector < std::vector < size_t > > chunk; // offsets of free chunks for every level
+            size_t size; // total size of chunks in bytes
+        };
+
+        // links of intrusive list stored at the beginning of every free chunk
+        struct ChunkLink
+        {
+            size_t previous;
+            size_t next;
+        };
+
+        const FreeListMode _mode;
+
+        uint8_t * _memory; // a pointer to memory allocated chunk
+        uint8_t * _data;   // the same pointer aligned to a cache line
+
+        std::atomic < size_t > _allocatedCount;
+
+        // levels of allocated chunks in preallocated memory for every 2^minimumLevel bytes
+        std::vector < uint8_t > _chunkLevel;
+
+        std::mutex _mutex; // protects sets of free chunks for SET_FREE_LIST mode
+
+        // intrusive lists of free chunks for INTRUSIVE_FREE_LIST mode
+        uint8_t _levelCount;
+        uint64_t _nonEmptyLevel;          // bit per level with at least one free chunk
+        std::vector < size_t > _head;     // the first free chunk for every level
+        std::vector < uint8_t > _freeLevel; // level + 1 of a free chunk started at every 2^minimumLevel bytes, 0 if no free chunk starts there
+        SpinLock _lock;
+
+        std::vector < Cache > _cache;
+        size_t _cacheCapacity; // maximum size of chunks in a cache in bytes
+
+        Cache & _threadCache()
+        {
+            return _cache[std::hash < std::thread::id >()( std::this_thread::get_id() ) % cacheCount];
+        }
+
+        ChunkLink & _chunkLink( size_t offset )
+        {
+            return *reinterpret_cast<ChunkLink *>( _data + offset );
+        }
+
+        void _link( size_t offset, uint8_t level )
+        {
+            ChunkLink & link = _chunkLink( offset );
+            link.previous = noChunk;
+            link.next = _head[level];
+
+            if( _head[level] != noChunk )
+                _chunkLink( _head[level] ).previous = offset;
+
+            _head[level] = offset;
+            _nonEmptyLevel |= static_cast<uint64_t>(1) << level;
+            _freeLevel[offset >> minimumLevel] = static_cast<uint8_t>( level + 1u );
+        }
+
+        void _unlink( size_t offset, uint8_t level )
+        {
+            const ChunkLink & link = _chunkLink( offset );
+
+            if( link.previous != noChunk )
+                _chunkLink( link.previous ).next = link.next;
+            else
+                _head[level] = link.next;
+
+            if( link.next != noChunk )
+                _chunkLink( link.next ).previous = link.previous;
+
+            if( _head[level] == noChunk )
+                _nonEmptyLevel &= ~(static_cast<uint64_t>(1) << level);
+
+            _freeLevel[offset >> minimumLevel] = 0;
+        }
+
+        // takes a free chunk of required level splitting bigger chunks if needed
+        bool _take( uint8_t level, size_t & offset )
+        {
+            if( _mode == SET_FREE_LIST ) {
+                std::lock_guard < std::mutex > lock( _mutex );
+
+                if( !_split( level ) )
+                    return false;
+
+                offset = *_freeChunck[level].begin();
+                _freeChunck[level].erase( _freeChunck[level].begin() );
+                return true;
+            }
+
+            Cache & cache = _threadCache();
+
+            {
+                std::lock_guard < SpinLock > lock( cache.lock );
+
+                if( !cache.chunk[level].empty() ) {
+                    offset = cache.chunk[level].back();
+                    cache.chunk[level].pop_back();
+                    cache.size -= static_cast<size_t>(1) << level;
+                    return true;
+                }
+            }
+
+            std::lock_guard < SpinLock > lock( _lock );
+
+            if( (_nonEmptyLevel >> level) == 0 ) {
+                // chunks in caches are not merged with their buddies so a bigger chunk can be hidden in them
+                _flushCaches();
+
+                if( (_nonEmptyLevel >> level) == 0 )
+                    return false;
+            }
+
+            uint8_t from = level;
+            while( ((_nonEmptyLevel >> from) & 1u) == 0 )
+                ++from;
+
+            offset = _head[from];
+            _unlink( offset, from );
+
+            // the second half of every split chunk becomes free
+            while( from > level ) {
+                --from;
+                _link( offset + (static_cast<size_t>(1) << from), from );
+            }
+
+            return true;
+        }
+
+        // returns a chunk to free chunks merging it with a free neighbour (buddy) of the same level
+        void _give( size_t offset, uint8_t level )
+        {
+            if( _mode == SET_FREE_LIST ) {
+                std::lock_guard < std::mutex > lock( _mutex );
+
+                _freeChunck[level].insert( offset );
+                _merge( offset, level );
+                return;
+            }
+
+            Cache & cache = _threadCache();
+            const size_t chunkSize = static_cast<size_t>(1) << level;
+
+            {
+                std::lock_guard < SpinLock > lock( cache.lock );
+
+                if( cache.chunk[level].size() < cacheSize && cache.size + chunkSize <= _cacheCapacity ) {
+                    cache.chunk[level].push_back( offset );
+                    cache.size += chunkSize;
+                    return;
+                }
+            }
+
+            std::lock_guard < SpinLock > lock( _lock );
+
+            _release( offset, level );
+        }
+
+        // links a free chunk merging it with free buddies, _lock must be held
+        void _release( size_t offset, uint8_t level )
+        {
+            while( level + 1u < _levelCount ) {
+                const size_t chunkSize = static_cast<size_t>(1) << level;
+                const size_t buddy = offset ^ chunkSize;
+
+                if( buddy + chunkSize > _size || _freeLevel[buddy >> minimumLevel] != level + 1u )
+                    break;
+
+                _unlink( buddy, level );
+
+                offset = offset & ~chunkSize;
+                ++level;
+            }
+
+            _link( offset, level );
+        }
+
+        // returns chunks of all caches into intrusive lists, _lock must be held
+        void _flushCaches()
+        {
+            for( std::vector < Cache >::iterator cache = _cache.begin(); cache != _cache.end(); ++cache ) {
+                std::lock_guard < SpinLock > lock( cache->lock );
+
+                for( uint8_t level = 0; level < cache->chunk.size(); ++level ) {
+                    for( std::vector < size_t >::const_iterator offset = cache->chunk[level].begin(); offset != cache->chunk[level].end(); ++offset )
+                        _release( *offset, level );
+
+                    cache->chunk[level].clear();
+                }
+
+                cache->size = 0;
+            }
+        }
+
+        // the function for true memory allocation
+        virtual void _allocate( size_t size )
+        {
+            if( _size != size && size > 0 ) {
+                if( _allocatedCount > 0 )
+                    throw imageException( "Cannot free CPU memory. Not all objects were previously deallocated from allocator." );
+
+                _free();
+
+                _memory = reinterpret_cast<uint8_t *>( malloc( size + 64u ) );
+                if( _memory == nullptr )
+                    throw imageException( "Cannot allocate CPU memory" );
+
+                _data = _memory + (64u - reinterpret_cast<size_t>( _memory ) % 64u) % 64u;
+
+                _chunkLevel.resize( (size >> minimumLevel) + 1u );
+
+                _levelCount = static_cast<uint8_t>( _getAllocationLevel( size ) + 1u );
+
+                if( _mode == INTRUSIVE_FREE_LIST ) {
+                    _nonEmptyLevel = 0;
+                    _head.resize( _levelCount, static_cast<size_t>( noChunk ) );
+                    _freeLevel.resize( (size >> minimumLevel) + 1u, 0 );
+                    _cacheCapacity = size / cacheCount;
+
+                    for( std::vector < Cache >::iterator cache = _cache.begin(); cache != _cache.end(); ++cache ) {
+                        cache->chunk.resize( _levelCount );
+
+                        for( std::vector < std::vector < size_t > >::iterator chunk = cache->chunk.begin(); chunk != cache->chunk.end(); ++chunk )
+                            chunk->reserve( cacheSize );
+                    }
+                }
+
+                _size = size;
+            }
+        }
+
+        // the function for true memory deallocation
+        virtual void _deallocate()
+        {
+            if( _memory != nullptr ) {
+                ::free( _memory );
+                _memory = nullptr;
+                _data = nullptr;
+            }
+
+            _chunkLevel.clear();
+
+            _levelCount = 0;
+            _nonEmptyLevel = 0;
+            _head.clear();
+            _freeLevel.clear();
+
+            for( std::vector < Cache >::iterator cache = _cache.begin(); cache != _cache.end(); ++cache ) {
+                cache->chunk.clear();
+                cache->size = 0;
+            }
+
+            _cacheCapacity = 0;
+        }
+
+        MemoryAllocator( const MemoryAllocator & ) = delete;
+        MemoryAllocator & operator=( const MemoryAllocator & ) = delete;
+    };
+
+    // This is a shortcut (facade) namespace to access global memory allocator for CPU
+    namespace MemoryManager
+    {
+        inline MemoryAllocator & memory()
+        {
+            static MemoryAllocator allocator;
+            return allocator;
+        }
+    }
+}
@@ -25,7 +25,8 @@ public:
     // we recommend to call this function only one time at the startup of an application
     // do not reallocate memory if some objects in your source code are allocated
     // through this allocator. Future access to such object's memory is unpredictable
-    void reserve( size_t size )
+    // derived classes can override the function to build their own structures of free memory after calling it
+    virtual void reserve( size_t size )
     {
         if ( size == 0 )
             throw std::logic_error( "Memory size cannot be 0" );
@@ -37,6 +37,33 @@ struct CpuInformation
         return false;
     }
 
+    // AVX-512 functions require Foundation and Byte and Word instruction sets
+    static bool isAvx512Supported()
+    {
+#ifndef __arm__
+        int info[4];
+        __cpuid_count( 0, 0, info[0], info[1], info[2], info[3] );
+        const int id = info[0];
+
+        if( id >= 0x00000007 ) {
+            __cpuid_count( 0x00000007, 0, info[0], info[1], info[2], info[3] );
+            if( (info[1] & ((int)1 << 16)) == 0 || (info[1] & ((int)1 << 30)) == 0 )
+                return false;
+
+            // Operating system must save mask and 512-bit registers on context switch (XCR0 register bits 1, 2, 5, 6 and 7)
+            __cpuid_count( 0x00000001, 0, info[0], info[1], info[2], info[3] );
+            if( (info[2] & ((int)1 << 27)) == 0 )
+                return false;
+
+            unsigned int xcr0Low = 0;
+            unsigned int xcr0High = 0;
+            __asm__ __volatile__ ( "xgetbv" : "=a" ( xcr0Low ), "=d" ( xcr0High ) : "c" ( 0 ) );
+            return (xcr0Low & 0xE6u) == 0xE6u;
+        }
+#endif
+        return false;
+    }
+
     static bool isNeonSupported()
     {
 #ifdef __arm__
@@ -32,6 +32,29 @@ struct CpuInformation
         return false;
     }
 
+    // AVX-512 functions require Foundation and Byte and Word instruction sets
+    static bool isAvx512Supported()
+    {
+        int info[4];
+        __cpuidex( info, 0, 0 );
+        const int id = info[0];
+
+        if( id >= 0x00000007 ) {
+            __cpuidex( info, 0x00000007, 0 );
+            if( (info[1] & ((int)1 << 16)) == 0 || (info[1] & ((int)1 << 30)) == 0 )
+                return false;
+
+            // Operating system must save mask and 512-bit registers on context switch (XCR0 register bits 1, 2, 5, 6 and 7)
+            __cpuidex( info, 0x00000001, 0 );
+            if( (info[2] & ((int)1 << 27)) == 0 )
+                return false;
+
+            return (_xgetbv( 0 ) & 0xE6u) == 0xE6u;
+        }
+
+        return false;
+    }
+
     static bool isNeonSupported()
     {
 #ifdef _M_ARM
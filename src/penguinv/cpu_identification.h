@@ -16,6 +16,10 @@
             #if _MSC_VER >= 1700
                 #define PENGUINV_AVX_SET
             #endif
+
+            #if _MSC_VER >= 1910
+                #define PENGUINV_AVX512_SET
+            #endif
         #endif
     #endif
 #elif defined(__APPLE__) || defined(__linux__) // MacOS and Linux
@@ -29,6 +33,10 @@
 
         #ifdef __AVX2__
             #define PENGUINV_AVX_SET
+
+            #ifdef __AVX512BW__
+                #define PENGUINV_AVX512_SET
+            #endif
         #endif
     #endif
 
@@ -49,6 +57,12 @@
 
 #endif
 
+#ifdef PENGUINV_AVX512_SET
+    #ifndef PENGUINV_AVX_SET
+        #error "None of existing processors can support AVX-512 but not AVX. Please check SIMD instruction set verification code"
+    #endif
+#endif
+
 #ifdef PENGUINV_AVX_SET
     #ifndef PENGUINV_SSE_SET
         #error "None of existing processors can support AVX but not SSE. Please check SIMD instruction set verification code"
@@ -68,6 +82,12 @@ static const bool isAvxAvailable  = CpuInformation::isAvxSupported();
 static const bool isAvxAvailable  = false;
 #endif
 
+#ifdef PENGUINV_AVX512_SET
+static const bool isAvx512Available = CpuInformation::isAvx512Supported();
+#else
+static const bool isAvx512Available = false;
+#endif
+
 #ifdef PENGUINV_NEON_SET
 static const bool isNeonAvailable = CpuInformation::isNeonSupported();
 #else
@@ -1,16 +1,37 @@
 #include "penguinv.h"
 
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <sstream>
 #include "cpu_identification.h"
+#include "../function_pool.h"
+#include "../image_exception.h"
 #include "../image_function.h"
 #include "../image_function_simd.h"
+#include "../thread_pool.h"
 
-// We directly make first call to initialize function table
+// We directly make first call to initialize function tables
 // to prevent multithreading issues
 static const penguinV::FunctionTable& functionTable = penguinV::functionTable();
+// Tables of all size classes are created at once so any size could be used here
+static const penguinV::FunctionTable& sizeClassFunctionTable = penguinV::functionTable( 1u, 1u );
 
 namespace
 {
-    penguinV::FunctionTable initialize()
+    // Implementations of functions which are compared during function table optimization
+    enum Variant
+    {
+        CPU_VARIANT,
+        SIMD_VARIANT,
+        THREAD_POOL_VARIANT,
+        VARIANT_COUNT
+    };
+
+    const char * const variantName[VARIANT_COUNT] = { "cpu", "simd", "thread_pool" };
+
+    penguinV::FunctionTable initialize( Variant variant )
     {
         penguinV::FunctionTable table;
 
@@ -49,27 +70,338 @@ namespace
         table.Transpose          = &Image_Function::Transpose;
 
         // SIMD
-        table.AbsoluteDifference = &Image_Function_Simd::AbsoluteDifference;
-        table.BitwiseAnd         = &Image_Function_Simd::BitwiseAnd;
-        table.BitwiseOr          = &Image_Function_Simd::BitwiseOr;
-        table.BitwiseXor         = &Image_Function_Simd::BitwiseXor;
-        table.Invert             = &Image_Function_Simd::Invert;
-        table.Maximum            = &Image_Function_Simd::Maximum;
-        table.Minimum            = &Image_Function_Simd::Minimum;
-        table.Subtract           = &Image_Function_Simd::Subtract;
-        table.Sum                = &Image_Function_Simd::Sum;
-        table.Threshold          = &Image_Function_Simd::Threshold;
-        table.Threshold2         = &Image_Function_Simd::Threshold;
+        if( variant == SIMD_VARIANT ) {
+            table.AbsoluteDifference = &Image_Function_Simd::AbsoluteDifference;
+            table.BitwiseAnd         = &Image_Function_Simd::BitwiseAnd;
+            table.BitwiseOr          = &Image_Function_Simd::BitwiseOr;
+            table.BitwiseXor         = &Image_Function_Simd::BitwiseXor;
+            table.GammaCorrection    = &Image_Function_Simd::GammaCorrection;
+            table.Invert             = &Image_Function_Simd::Invert;
+            table.LookupTable        = &Image_Function_Simd::LookupTable;
+            table.Maximum            = &Image_Function_Simd::Maximum;
+            table.Minimum            = &Image_Function_Simd::Minimum;
+            table.Normalize          = &Image_Function_Simd::Normalize;
+            table.Subtract           = &Image_Function_Simd::Subtract;
+            table.Sum                = &Image_Function_Simd::Sum;
+            table.Threshold          = &Image_Function_Simd::Threshold;
+            table.Threshold2         = &Image_Function_Simd::Threshold;
+        }
+
+        // Multithreading
+        if( variant == THREAD_POOL_VARIANT ) {
+            table.AbsoluteDifference = &Function_Pool::AbsoluteDifference;
+            table.BitwiseAnd         = &Function_Pool::BitwiseAnd;
+            table.BitwiseOr          = &Function_Pool::BitwiseOr;
+            table.BitwiseXor         = &Function_Pool::BitwiseXor;
+            table.ConvertToGrayScale = &Function_Pool::ConvertToGrayScale;
+            table.ConvertToRgb       = &Function_Pool::ConvertToRgb;
+            table.ExtractChannel     = &Function_Pool::ExtractChannel;
+            table.GammaCorrection    = &Function_Pool::GammaCorrection;
+            table.Histogram          = &Function_Pool::Histogram;
+            table.Invert             = &Function_Pool::Invert;
+            table.IsEqual            = &Function_Pool::IsEqual;
+            table.LookupTable        = &Function_Pool::LookupTable;
+            table.Maximum            = &Function_Pool::Maximum;
+            table.Minimum            = &Function_Pool::Minimum;
+            table.Normalize          = &Function_Pool::Normalize;
+            table.ProjectionProfile  = &Function_Pool::ProjectionProfile;
+            table.Resize             = &Function_Pool::Resize;
+            table.RgbToBgr           = &Function_Pool::RgbToBgr;
+            table.Subtract           = &Function_Pool::Subtract;
+            table.Threshold          = &Function_Pool::Threshold;
+            table.Threshold2         = &Function_Pool::Threshold;
+        }
 
         return table;
     }
+
+    const penguinV::FunctionTable & variantTable( Variant variant )
+    {
+        static const penguinV::FunctionTable table[VARIANT_COUNT] = { initialize( CPU_VARIANT ), initialize( SIMD_VARIANT ),
+                                                                      initialize( THREAD_POOL_VARIANT ) };
+        return table[variant];
+    }
+
+    penguinV::FunctionTable & sizeClassTable( penguinV::SizeClass sizeClass )
+    {
+        static penguinV::FunctionTable table[penguinV::SIZE_CLASS_COUNT] = { penguinV::functionTable(), penguinV::functionTable(),
+                                                                             penguinV::functionTable() };
+        return table[sizeClass];
+    }
+
+    // Images and buffers used to measure execution time of functions for one size class
+    struct MeasurementData
+    {
+        explicit MeasurementData( uint32_t size_ )
+            : size     ( size_ )
+            , gray1    ( size_, size_ )
+            , gray2    ( size_, size_ )
+            , grayOut  ( size_, size_ )
+            , rgb      ( size_, size_, PenguinV_Image::RGB )
+            , rgbOut   ( size_, size_, PenguinV_Image::RGB )
+            , table    ( 256u )
+        {
+            // Pixel intensities must be spread over the whole range as some functions, for example Normalize, skip uniform images
+            fill( gray1, 1u );
+            fill( gray2, 7u );
+            fill( rgb, 13u );
+
+            for( size_t i = 0; i < table.size(); ++i )
+                table[i] = static_cast<uint8_t>(255u - i);
+        }
+
+        static void fill( PenguinV_Image::Image & image, uint32_t seed )
+        {
+            uint8_t * data = image.data();
+            const uint32_t size = image.rowSize() * image.height();
+
+            for( uint32_t i = 0; i < size; ++i )
+                data[i] = static_cast<uint8_t>(((i + seed) * 2654435761u) >> 24);
+        }
+
+        uint32_t size;
+        PenguinV_Image::Image gray1;
+        PenguinV_Image::Image gray2;
+        PenguinV_Image::Image grayOut;
+        PenguinV_Image::Image rgb;
+        PenguinV_Image::Image rgbOut;
+        std::vector < uint8_t > table;
+        std::vector < uint32_t > histogram;
+        std::vector < uint32_t > projection;
+    };
+
+    // A function in the table which has several implementations
+    struct TunedFunction
+    {
+        const char * name;
+        void ( *run )( const penguinV::FunctionTable & table, MeasurementData & data );
+        bool ( *isEqual )( const penguinV::FunctionTable & table1, const penguinV::FunctionTable & table2 );
+        void ( *copy )( const penguinV::FunctionTable & in, penguinV::FunctionTable & out );
+    };
+
+// Function call is passed as variadic arguments as it contains commas
+#define TUNED_FUNCTION( function, ... )                                                                                          \
+    { #function,                                                                                                                 \
+      []( const penguinV::FunctionTable & table, MeasurementData & data ) { __VA_ARGS__; },                                     \
+      []( const penguinV::FunctionTable & table1, const penguinV::FunctionTable & table2 ) { return table1.function == table2.function; }, \
+      []( const penguinV::FunctionTable & in, penguinV::FunctionTable & out ) { out.function = in.function; } }
+
+    const TunedFunction tunedFunction[] =
+    {
+        TUNED_FUNCTION( AbsoluteDifference, table.AbsoluteDifference( data.gray1, 0, 0, data.gray2, 0, 0, data.grayOut, 0, 0, data.size, data.size ) ),
+        TUNED_FUNCTION( BitwiseAnd, table.BitwiseAnd( data.gray1, 0, 0, data.gray2, 0, 0, data.grayOut, 0, 0, data.size, data.size ) ),
+        TUNED_FUNCTION( BitwiseOr, table.BitwiseOr( data.gray1, 0, 0, data.gray2, 0, 0, data.grayOut, 0, 0, data.size, data.size ) ),
+        TUNED_FUNCTION( BitwiseXor, table.BitwiseXor( data.gray1, 0, 0, data.gray2, 0, 0, data.grayOut, 0, 0, data.size, data.size ) ),
+        TUNED_FUNCTION( ConvertToGrayScale, table.ConvertToGrayScale( data.rgb, 0, 0, data.grayOut, 0, 0, data.size, data.size ) ),
+        TUNED_FUNCTION( ConvertToRgb, table.ConvertToRgb( data.gray1, 0, 0, data.rgbOut, 0, 0, data.size, data.size ) ),
+        TUNED_FUNCTION( ExtractChannel, table.ExtractChannel( data.rgb, 0, 0, data.grayOut, 0, 0, data.size, data.size, 1 ) ),
+        TUNED_FUNCTION( GammaCorrection, table.GammaCorrection( data.gray1, 0, 0, data.grayOut, 0, 0, data.size, data.size, 1.0, 0.5 ) ),
+        TUNED_FUNCTION( Histogram, table.Histogram( data.gray1, 0, 0, data.size, data.size, data.histogram ) ),
+        TUNED_FUNCTION( Invert, table.Invert( data.gray1, 0, 0, data.grayOut, 0, 0, data.size, data.size ) ),
+        // Equal images are compared as comparison of different images stops at first different row
+        TUNED_FUNCTION( IsEqual, table.IsEqual( data.gray1, 0, 0, data.gray1, 0, 0, data.size, data.size ) ),
+        TUNED_FUNCTION( LookupTable, table.LookupTable( data.gray1, 0, 0, data.grayOut, 0, 0, data.size, data.size, data.table ) ),
+        TUNED_FUNCTION( Maximum, table.Maximum( data.gray1, 0, 0, data.gray2, 0, 0, data.grayOut, 0, 0, data.size, data.size ) ),
+        TUNED_FUNCTION( Minimum, table.Minimum( data.gray1, 0, 0, data.gray2, 0, 0, data.grayOut, 0, 0, data.size, data.size ) ),
+        TUNED_FUNCTION( Normalize, table.Normalize( data.gray1, 0, 0, data.grayOut, 0, 0, data.size, data.size ) ),
+        TUNED_FUNCTION( ProjectionProfile, table.ProjectionProfile( data.gray1, 0, 0, data.size, data.size, true, data.projection ) ),
+        TUNED_FUNCTION( Resize, table.Resize( data.gray1, 0, 0, data.size, data.size, data.grayOut, 0, 0, data.size / 2, data.size / 2 ) ),
+        TUNED_FUNCTION( RgbToBgr, table.RgbToBgr( data.rgb, 0, 0, data.rgbOut, 0, 0, data.size, data.size ) ),
+        TUNED_FUNCTION( Subtract, table.Subtract( data.gray1, 0, 0, data.gray2, 0, 0, data.grayOut, 0, 0, data.size, data.size ) ),
+        TUNED_FUNCTION( Sum, table.Sum( data.gray1, 0, 0, data.size, data.size ) ),
+        TUNED_FUNCTION( Threshold, table.Threshold( data.gray1, 0, 0, data.grayOut, 0, 0, data.size, data.size, 128 ) ),
+        TUNED_FUNCTION( Threshold2, table.Threshold2( data.gray1, 0, 0, data.grayOut, 0, 0, data.size, data.size, 64, 192 ) )
+    };
+
+    const size_t tunedFunctionCount = sizeof( tunedFunction ) / sizeof( tunedFunction[0] );
+
+    // Sizes of square images which represent size classes
+    const uint32_t sizeClassImageSize[penguinV::SIZE_CLASS_COUNT] = { 64u, 512u, 2048u };
+
+    typedef std::vector < std::vector < Variant > > Configuration; // [function][size class]
+
+    // A configuration is valid only for the same set of available SIMD technologies and the same number of threads
+    std::string systemDescription()
+    {
+        std::ostringstream description;
+        description << "avx512 " << isAvx512Available << " avx " << isAvxAvailable << " sse " << isSseAvailable << " neon " << isNeonAvailable
+                    << " threads " << Thread_Pool::ThreadPoolMonoid::instance().threadCount();
+        return description.str();
+    }
+
+    const char * const configurationHeader = "penguinV function table";
+
+    // Thread pool functions are never used for small areas: such areas are processed by code which could run in the thread pool
+    // itself, for example, by tiles of Image_Pipeline, and splitting of them into tasks costs more than it gives
+    bool isAvailable( Variant variant, size_t functionId, penguinV::SizeClass sizeClass )
+    {
+        if( variant == THREAD_POOL_VARIANT && (sizeClass == penguinV::SMALL_AREA || Thread_Pool::ThreadPoolMonoid::instance().threadCount() == 0) )
+            return false;
+
+        // Skip an implementation if it is the same as one of previous variants, for example, when a function has no SIMD code
+        for( int previous = CPU_VARIANT; previous < variant; ++previous ) {
+            if( tunedFunction[functionId].isEqual( variantTable( static_cast<Variant>(previous) ), variantTable( variant ) ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    double measure( const TunedFunction & function, const penguinV::FunctionTable & table, MeasurementData & data )
+    {
+        // Small images need more repetitions to get reliable time
+        const uint32_t repetitionCount = std::max( 3u, (1u << 20) / (data.size * data.size) );
+
+        function.run( table, data ); // warm up caches and threads
+
+        double minimumTime = std::numeric_limits<double>::max();
+
+        for( uint32_t attempt = 0; attempt < 3u; ++attempt ) {
+            const std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+            for( uint32_t i = 0; i < repetitionCount; ++i )
+                function.run( table, data );
+
+            const double time = std::chrono::duration < double >( std::chrono::high_resolution_clock::now() - start ).count();
+            if( minimumTime > time )
+                minimumTime = time;
+        }
+
+        return minimumTime;
+    }
+
+    Configuration calibrate()
+    {
+        Configuration configuration( tunedFunctionCount, std::vector < Variant >( penguinV::SIZE_CLASS_COUNT, SIMD_VARIANT ) );
+
+        for( int sizeClass = 0; sizeClass < penguinV::SIZE_CLASS_COUNT; ++sizeClass ) {
+            MeasurementData data( sizeClassImageSize[sizeClass] );
+
+            for( size_t functionId = 0; functionId < tunedFunctionCount; ++functionId ) {
+                double minimumTime = std::numeric_limits<double>::max();
+
+                for( int variant = CPU_VARIANT; variant < VARIANT_COUNT; ++variant ) {
+                    if( !isAvailable( static_cast<Variant>(variant), functionId, static_cast<penguinV::SizeClass>(sizeClass) ) )
+                        continue;
+
+                    const double time = measure( tunedFunction[functionId], variantTable( static_cast<Variant>(variant) ), data );
+                    if( minimumTime > time ) {
+                        minimumTime = time;
+                        configuration[functionId][sizeClass] = static_cast<Variant>(variant);
+                    }
+                }
+            }
+        }
+
+        return configuration;
+    }
+
+    // Configuration file contains a header, a description of the system and one line per function:
+    // a name of a function followed by names of chosen implementations for every size class
+    bool load( const std::string & fileName, Configuration & configuration )
+    {
+        std::ifstream file( fileName.c_str() );
+        if( !file )
+            return false;
+
+        std::string line;
+        if( !std::getline( file, line ) || line != configurationHeader )
+            return false;
+
+        if( !std::getline( file, line ) || line != systemDescription() )
+            return false;
+
+        configuration.assign( tunedFunctionCount, std::vector < Variant >( penguinV::SIZE_CLASS_COUNT, SIMD_VARIANT ) );
+
+        for( size_t functionId = 0; functionId < tunedFunctionCount; ++functionId ) {
+            if( !std::getline( file, line ) )
+                return false;
+
+            std::istringstream stream( line );
+            std::string name;
+            if( !(stream >> name) || name != tunedFunction[functionId].name )
+                return false;
+
+            for( int sizeClass = 0; sizeClass < penguinV::SIZE_CLASS_COUNT; ++sizeClass ) {
+                std::string variant;
+                if( !(stream >> variant) )
+                    return false;
+
+                const char * const * found = std::find( variantName, variantName + VARIANT_COUNT, variant );
+                if( found == variantName + VARIANT_COUNT ||
+                    !isAvailable( static_cast<Variant>(found - variantName), functionId, static_cast<penguinV::SizeClass>(sizeClass) ) )
+                    return false;
+
+                configuration[functionId][sizeClass] = static_cast<Variant>(found - variantName);
+            }
+        }
+
+        return true;
+    }
+
+    void save( const std::string & fileName, const Configuration & configuration )
+    {
+        std::ofstream file( fileName.c_str() );
+        if( !file )
+            throw imageException( "Cannot create file for function table configuration" );
+
+        file << configurationHeader << std::endl << systemDescription() << std::endl;
+
+        for( size_t functionId = 0; functionId < tunedFunctionCount; ++functionId ) {
+            file << tunedFunction[functionId].name;
+
+            for( int sizeClass = 0; sizeClass < penguinV::SIZE_CLASS_COUNT; ++sizeClass )
+                file << " " << variantName[configuration[functionId][sizeClass]];
+
+            file << std::endl;
+        }
+
+        if( !file )
+            throw imageException( "Cannot save function table configuration" );
+    }
 }
 
 namespace penguinV
 {
     const FunctionTable & functionTable()
     {
-        static FunctionTable table = initialize();
+        static FunctionTable table = initialize( SIMD_VARIANT );
         return table;
     }
+
+    const FunctionTable & functionTable( uint32_t width, uint32_t height )
+    {
+        const uint64_t area = static_cast<uint64_t>(width) * height;
+
+        if( area <= 128u * 128u )
+            return sizeClassTable( SMALL_AREA );
+        else if( area <= 1024u * 1024u )
+            return sizeClassTable( MEDIUM_AREA );
+        else
+            return sizeClassTable( LARGE_AREA );
+    }
+
+    void OptimizeFunctionTable( const std::string & fileName )
+    {
+        Configuration configuration;
+
+        if( fileName.empty() || !load( fileName, configuration ) ) {
+            configuration = calibrate();
+
+            if( !fileName.empty() )
+                save( fileName, configuration );
+        }
+
+        for( size_t functionId = 0; functionId < tunedFunctionCount; ++functionId ) {
+            for( int sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; ++sizeClass )
+                tunedFunction[functionId].copy( variantTable( configuration[functionId][sizeClass] ),
+                                                sizeClassTable( static_cast<SizeClass>(sizeClass) ) );
+        }
+    }
+
+    void ResetFunctionTable()
+    {
+        for( int sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; ++sizeClass )
+            sizeClassTable( static_cast<SizeClass>(sizeClass) ) = functionTable();
+    }
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string>
 #include <vector>
 #include "../image_buffer.h"
 #include "../image_function_helper.h"
@@ -45,78 +46,100 @@ namespace penguinV
         Image_Function_Helper::FunctionTable::Transpose Transpose;
     };
 
+    // Size classes of image areas for which function tables are optimized separately
+    enum SizeClass
+    {
+        SMALL_AREA,  // up to 128 x 128 pixels
+        MEDIUM_AREA, // up to 1024 x 1024 pixels
+        LARGE_AREA,
+        SIZE_CLASS_COUNT
+    };
+
     // A function which returns reference to a function table
     const FunctionTable & functionTable();
 
+    // A function which returns reference to a function table optimized for given area of an image
+    // Tables of medium and large areas could contain multithreaded functions so code running in the thread pool must use
+    // functionTable() without parameters for such areas. A table of small areas never contains multithreaded functions
+    const FunctionTable & functionTable( uint32_t width, uint32_t height );
+
+    // Measures execution time of CPU, SIMD and thread pool implementations for every size class and chooses the fastest one
+    // The result is stored in a file with given name and loaded from it next time if the system is the same
+    // An empty name means no file usage. Call this function at the start of an application before other threads use the library
+    void OptimizeFunctionTable( const std::string & fileName );
+
+    // Sets tables of all size classes back to the default function table. The same restrictions as for OptimizeFunctionTable apply
+    void ResetFunctionTable();
+
     // A list of basic functions
     inline void AbsoluteDifference( const Image & in1, uint32_t startX1, uint32_t startY1, const Image & in2, uint32_t startX2, uint32_t startY2,
                                     Image & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height )
     {
-        functionTable().AbsoluteDifference( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
+        functionTable( width, height ).AbsoluteDifference( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
     }
 
     inline void Accumulate( const Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height, std::vector < uint32_t > & result )
     {
-        functionTable().Accumulate( image, x, y, width, height, result );
+        functionTable( width, height ).Accumulate( image, x, y, width, height, result );
     }
 
     inline void BitwiseAnd( const Image & in1, uint32_t startX1, uint32_t startY1, const Image & in2, uint32_t startX2, uint32_t startY2,
                             Image & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height )
     {
-        functionTable().BitwiseAnd( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
+        functionTable( width, height ).BitwiseAnd( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
     }
 
     inline void BitwiseOr( const Image & in1, uint32_t startX1, uint32_t startY1, const Image & in2, uint32_t startX2, uint32_t startY2,
                            Image & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height )
     {
-        functionTable().BitwiseOr( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
+        functionTable( width, height ).BitwiseOr( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
     }
 
     inline void BitwiseXor( const Image & in1, uint32_t startX1, uint32_t startY1, const Image & in2, uint32_t startX2, uint32_t startY2,
                             Image & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height )
     {
-        functionTable().BitwiseXor( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
+        functionTable( width, height ).BitwiseXor( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
     }
 
     inline void ConvertToGrayScale( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                                     uint32_t width, uint32_t height )
     {
-        functionTable().ConvertToGrayScale( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+        functionTable( width, height ).ConvertToGrayScale( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
     }
 
     inline void ConvertToRgb( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                               uint32_t width, uint32_t height )
     {
-        functionTable().ConvertToRgb( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+        functionTable( width, height ).ConvertToRgb( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
     }
 
     inline void Copy( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                       uint32_t width, uint32_t height )
     {
-        functionTable().Copy( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+        functionTable( width, height ).Copy( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
     }
 
     inline void ExtractChannel( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut,
                                 uint32_t startYOut, uint32_t width, uint32_t height, uint8_t channelId )
     {
-        functionTable().ExtractChannel( in, startXIn, startYIn, out, startXOut, startYOut, width, height, channelId );
+        functionTable( width, height ).ExtractChannel( in, startXIn, startYIn, out, startXOut, startYOut, width, height, channelId );
     }
 
     inline void Fill( Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint8_t value )
     {
-        functionTable().Fill( image, x, y, width, height, value );
+        functionTable( width, height ).Fill( image, x, y, width, height, value );
     }
 
     inline void Flip( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                       uint32_t width, uint32_t height, bool horizontal, bool vertical )
     {
-        functionTable().Flip( in, startXIn, startYIn, out, startXOut, startYOut, width, height, horizontal, vertical );
+        functionTable( width, height ).Flip( in, startXIn, startYIn, out, startXOut, startYOut, width, height, horizontal, vertical );
     }
 
     inline void GammaCorrection( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                                  uint32_t width, uint32_t height, double a, double gamma )
     {
-        functionTable().GammaCorrection( in, startXIn, startYIn, out, startXOut, startYOut, width, height, a, gamma );
+        functionTable( width, height ).GammaCorrection( in, startXIn, startYIn, out, startXOut, startYOut, width, height, a, gamma );
     }
 
     inline uint8_t GetPixel( const Image & image, uint32_t x, uint32_t y )
@@ -132,69 +155,69 @@ namespace penguinV
     inline void Histogram( const Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
                            std::vector < uint32_t > & histogram )
     {
-        functionTable().Histogram( image, x, y, width, height, histogram );
+        functionTable( width, height ).Histogram( image, x, y, width, height, histogram );
     }
 
     inline void Invert( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                         uint32_t width, uint32_t height )
     {
-        functionTable().Invert( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+        functionTable( width, height ).Invert( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
     }
 
     inline bool IsEqual( const Image & in1, uint32_t startX1, uint32_t startY1, const Image & in2, uint32_t startX2, uint32_t startY2,
                          uint32_t width, uint32_t height )
     {
-        return functionTable().IsEqual( in1, startX1, startY1, in2, startX2, startY2, width, height );
+        return functionTable( width, height ).IsEqual( in1, startX1, startY1, in2, startX2, startY2, width, height );
     }
 
     inline void LookupTable ( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                               uint32_t width, uint32_t height, const std::vector < uint8_t > & table )
     {
-        functionTable().LookupTable( in, startXIn, startYIn, out, startXOut, startYOut, width, height, table );
+        functionTable( width, height ).LookupTable( in, startXIn, startYIn, out, startXOut, startYOut, width, height, table );
     }
 
     inline void Maximum( const Image & in1, uint32_t startX1, uint32_t startY1, const Image & in2, uint32_t startX2, uint32_t startY2,
                          Image & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height )
     {
-        functionTable().Maximum( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
+        functionTable( width, height ).Maximum( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
     }
 
     inline void Merge( const Image & in1, uint32_t startXIn1, uint32_t startYIn1, const Image & in2, uint32_t startXIn2, uint32_t startYIn2,
                        const Image & in3, uint32_t startXIn3, uint32_t startYIn3, Image & out, uint32_t startXOut, uint32_t startYOut,
                        uint32_t width, uint32_t height )
     {
-        functionTable().Merge( in1, startXIn1, startYIn1, in2, startXIn2, startYIn2, in3, startXIn3, startYIn3,
+        functionTable( width, height ).Merge( in1, startXIn1, startYIn1, in2, startXIn2, startYIn2, in3, startXIn3, startYIn3,
                                out, startXOut, startYOut, width, height );
     }
 
     inline void Minimum( const Image & in1, uint32_t startX1, uint32_t startY1, const Image & in2, uint32_t startX2, uint32_t startY2,
                          Image & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height )
     {
-        functionTable().Minimum( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
+        functionTable( width, height ).Minimum( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
     }
 
     inline void Normalize( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                            uint32_t width, uint32_t height )
     {
-        functionTable().Normalize( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+        functionTable( width, height ).Normalize( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
     }
 
     inline void ProjectionProfile( const Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height, bool horizontal,
                                    std::vector < uint32_t > & projection )
     {
-        functionTable().ProjectionProfile( image, x, y, width, height, horizontal, projection );
+        functionTable( width, height ).ProjectionProfile( image, x, y, width, height, horizontal, projection );
     }
 
     inline void Resize( const Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t widthIn, uint32_t heightIn,
                         Image & out, uint32_t startXOut, uint32_t startYOut, uint32_t widthOut, uint32_t heightOut )
     {
-        functionTable().Resize( in, startXIn, startYIn, widthIn, heightIn, out, startXOut, startYOut, widthOut, heightOut );
+        functionTable( widthOut, heightOut ).Resize( in, startXIn, startYIn, widthIn, heightIn, out, startXOut, startYOut, widthOut, heightOut );
     }
 
     inline void RgbToBgr( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                           uint32_t width, uint32_t height )
     {
-        functionTable().RgbToBgr( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+        functionTable( width, height ).RgbToBgr( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
     }
 
     inline void SetPixel( Image & image, uint32_t x, uint32_t y, uint8_t value )
@@ -211,36 +234,36 @@ namespace penguinV
                        Image & out2, uint32_t startXOut2, uint32_t startYOut2, Image & out3, uint32_t startXOut3, uint32_t startYOut3,
                        uint32_t width, uint32_t height )
     {
-        functionTable().Split( in, startXIn, startYIn, out1, startXOut1, startYOut1, out2, startXOut2, startYOut2,
+        functionTable( width, height ).Split( in, startXIn, startYIn, out1, startXOut1, startYOut1, out2, startXOut2, startYOut2,
                                out3, startXOut3, startYOut3, width, height );
     }
 
     inline void Subtract( const Image & in1, uint32_t startX1, uint32_t startY1, const Image & in2, uint32_t startX2, uint32_t startY2,
                           Image & out, uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height )
     {
-        functionTable().Subtract( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
+        functionTable( width, height ).Subtract( in1, startX1, startY1, in2, startX2, startY2, out, startXOut, startYOut, width, height );
     }
 
     inline uint32_t Sum( const Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height )
     {
-        return functionTable().Sum( image, x, y, width, height );
+        return functionTable( width, height ).Sum( image, x, y, width, height );
     }
 
     inline void Threshold( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                            uint32_t width, uint32_t height, uint8_t threshold )
     {
-        functionTable().Threshold( in, startXIn, startYIn, out, startXOut, startYOut, width, height, threshold );
+        functionTable( width, height ).Threshold( in, startXIn, startYIn, out, startXOut, startYOut, width, height, threshold );
     }
 
     inline void Threshold( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                            uint32_t width, uint32_t height, uint8_t minThreshold, uint8_t maxThreshold )
     {
-        functionTable().Threshold2( in, startXIn, startYIn, out, startXOut, startYOut, width, height, minThreshold, maxThreshold );
+        functionTable( width, height ).Threshold2( in, startXIn, startYIn, out, startXOut, startYOut, width, height, minThreshold, maxThreshold );
     }
 
     inline void Transpose( const Image & in, uint32_t startXIn, uint32_t startYIn, Image & out, uint32_t startXOut, uint32_t startYOut,
                            uint32_t width, uint32_t height )
     {
-        functionTable().Transpose( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
+        functionTable( width, height ).Transpose( in, startXIn, startYIn, out, startXOut, startYOut, width, height );
     }
 }
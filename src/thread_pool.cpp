@@ -130,10 +130,23 @@ namespace Thread_Pool
     }
 
 
+    ThreadPool::ThreadPool()
+        : _exit               ( false )
+        , _runningThreadCount ( 0 )
+        , _threadCount        ( 0 )
+        , _threadsCreated     ( false )
+        , _pendingTaskCount   ( 0 )
+        , _nextQueue          ( 0 )
+    {
+    }
+
     ThreadPool::ThreadPool( size_t threads )
-        : _runningThreadCount ( 0 )
+        : _exit               ( false )
+        , _runningThreadCount ( 0 )
         , _threadCount        ( 0 )
         , _threadsCreated     ( false )
+        , _pendingTaskCount   ( 0 )
+        , _nextQueue          ( 0 )
     {
         resize( threads );
     }
@@ -148,39 +161,22 @@ namespace Thread_Pool
         if( threads == 0 )
             throw imageException( "Try to set zero threads in thread pool" );
 
-        if( threads > threadCount() ) {
-            _taskInfo.lock();
-            _run.resize( threads, 1 );
-            _exit.resize( threads, 0 );
-            _taskInfo.unlock();
-
-            _threadCount = threads;
-
-            while( threads > threadCount() )
-                _worker.push_back( std::thread ( ThreadPool::_workerThread, this, threadCount() ) );
-
-            std::unique_lock < std::mutex > _mutexLock( _creation );
-            _completeCreation.wait( _mutexLock, [&] { return _threadsCreated; } );
-        }
-        else if( threads < threadCount() ) {
-            _taskInfo.lock();
+        if( threads != threadCount() ) {
+            // Queues belong to workers so the easiest and safest way to change their number
+            // is to close all workers, keep not started tasks and give them to new workers
+            _join();
 
-            std::fill( _exit.begin() + static_cast<std::vector < uint8_t >::difference_type>(threads), _exit.end(), 1 );
-            std::fill( _run.begin()  + static_cast<std::vector < uint8_t >::difference_type>(threads), _run.end(), 1 );
-            _waiting.notify_all();
-
-            _taskInfo.unlock();
+            std::deque < AbstractTaskProvider * > task = _takeAll();
+            _queue.clear();
 
-            while( threads < threadCount() ) {
-                _worker.back().join();
+            _start( threads );
 
-                _worker.pop_back();
+            for( std::deque < AbstractTaskProvider * >::const_iterator provider = task.begin(); provider != task.end(); ++provider )
+                _distribute( *provider, 1u );
 
+            if( !task.empty() ) {
                 _taskInfo.lock();
-
-                _exit.pop_back();
-                _run.pop_back();
-
+                _waiting.notify_all();
                 _taskInfo.unlock();
             }
         }
@@ -203,55 +199,72 @@ namespace Thread_Pool
         provider->_running = true;
         provider->_completion.unlock();
 
-        _taskInfo.lock();
+        _distribute( provider, taskCount );
 
-        _task.insert( _task.end(), taskCount, provider );
-
-        std::fill( _run.begin(), _run.end(), 1 );
+        // the mutex is taken to avoid a situation when a thread checks a number of pending tasks and goes to sleep after notification
+        _taskInfo.lock();
         _waiting.notify_all();
-
         _taskInfo.unlock();
     }
 
     bool ThreadPool::empty()
     {
-        _taskInfo.lock();
-
-        bool emp = _task.empty();
-
-        _taskInfo.unlock();
-
-        return emp;
+        return _pendingTaskCount == 0;
     }
 
     void ThreadPool::remove( AbstractTaskProvider * provider )
     {
-        _taskInfo.lock();
+        for( std::vector < std::unique_ptr < TaskQueue > >::iterator queue = _queue.begin(); queue != _queue.end(); ++queue ) {
+            std::lock_guard < std::mutex > _mutexLock( (*queue)->lock );
 
-        _task.remove( provider );
+            std::deque < AbstractTaskProvider * > & task = (*queue)->task;
+            const size_t sizeBefore = task.size();
 
-        _taskInfo.unlock();
+            task.erase( std::remove( task.begin(), task.end(), provider ), task.end() );
+
+            _pendingTaskCount -= sizeBefore - task.size();
+        }
     }
 
     void ThreadPool::clear()
     {
-        _taskInfo.lock();
         // complete all tasks without real computations. It helps to avoid a deadlock in a case when thread pool is destroyed
-        std::for_each( _task.begin(), _task.end(), []( AbstractTaskProvider * task ) { task->_task( true ); } );
-        _task.clear();
-
-        _taskInfo.unlock();
+        std::deque < AbstractTaskProvider * > task = _takeAll();
+        std::for_each( task.begin(), task.end(), []( AbstractTaskProvider * provider ) { provider->_taskRun( true ); } );
     }
 
     void ThreadPool::stop()
     {
         clear();
 
+        _join();
+        _queue.clear();
+    }
+
+    void ThreadPool::_start( size_t threads )
+    {
+        _exit = false;
+        _runningThreadCount = 0;
+        _threadsCreated = false;
+        _threadCount = threads;
+
+        // all queues must exist before any worker starts to steal tasks
+        for( size_t i = 0; i < threads; ++i )
+            _queue.push_back( std::unique_ptr < TaskQueue >( new TaskQueue ) );
+
+        for( size_t i = 0; i < threads; ++i )
+            _worker.push_back( std::thread ( ThreadPool::_workerThread, this, i ) );
+
+        std::unique_lock < std::mutex > _mutexLock( _creation );
+        _completeCreation.wait( _mutexLock, [&] { return _threadsCreated; } );
+    }
+
+    void ThreadPool::_join()
+    {
         if( !_worker.empty() ) {
             _taskInfo.lock();
 
-            std::fill( _exit.begin(), _exit.end(), 1 );
-            std::fill( _run.begin(), _run.end(), 1 );
+            _exit = true;
             _waiting.notify_all();
 
             _taskInfo.unlock();
@@ -263,6 +276,75 @@ namespace Thread_Pool
         }
     }
 
+    std::deque < AbstractTaskProvider * > ThreadPool::_takeAll()
+    {
+        std::deque < AbstractTaskProvider * > task;
+
+        for( std::vector < std::unique_ptr < TaskQueue > >::iterator queue = _queue.begin(); queue != _queue.end(); ++queue ) {
+            std::lock_guard < std::mutex > _mutexLock( (*queue)->lock );
+
+            _pendingTaskCount -= (*queue)->task.size();
+
+            task.insert( task.end(), (*queue)->task.begin(), (*queue)->task.end() );
+            (*queue)->task.clear();
+        }
+
+        return task;
+    }
+
+    void ThreadPool::_distribute( AbstractTaskProvider * provider, size_t taskCount )
+    {
+        // tasks are divided evenly between queues and every queue is locked only once
+        const size_t queueCount = _queue.size();
+        const size_t taskPerQueue = taskCount / queueCount;
+        const size_t remainingTasks = taskCount % queueCount;
+        const size_t startQueue = (_nextQueue += remainingTasks) - remainingTasks;
+
+        for( size_t i = 0; i < queueCount; ++i ) {
+            const size_t queueId = (startQueue + i) % queueCount;
+            const size_t count = taskPerQueue + ( (i < remainingTasks) ? 1u : 0u );
+
+            if( count > 0 ) {
+                TaskQueue & queue = *_queue[queueId];
+
+                std::lock_guard < std::mutex > _mutexLock( queue.lock );
+
+                queue.task.insert( queue.task.end(), count, provider );
+                _pendingTaskCount += count;
+            }
+        }
+    }
+
+    AbstractTaskProvider * ThreadPool::_pop( size_t threadId )
+    {
+        const size_t queueCount = _queue.size();
+
+        for( size_t i = 0; i < queueCount; ++i ) {
+            TaskQueue & queue = *_queue[(threadId + i) % queueCount];
+
+            std::lock_guard < std::mutex > _mutexLock( queue.lock );
+
+            if( !queue.task.empty() ) {
+                AbstractTaskProvider * task = nullptr;
+
+                if( i == 0 ) { // own queue
+                    task = queue.task.back();
+                    queue.task.pop_back();
+                }
+                else { // steal from another worker
+                    task = queue.task.front();
+                    queue.task.pop_front();
+                }
+
+                --_pendingTaskCount;
+
+                return task;
+            }
+        }
+
+        return nullptr;
+    }
+
     void ThreadPool::_workerThread( ThreadPool * pool, size_t threadId )
     {
         if( ++(pool->_runningThreadCount) == pool->_threadCount ) {
@@ -272,29 +354,15 @@ namespace Thread_Pool
             pool->_creation.unlock();
         }
 
-        while( !pool->_exit[threadId] ) {
-            std::unique_lock < std::mutex > _mutexLock( pool->_taskInfo );
-            pool->_waiting.wait( _mutexLock, [&] { return pool->_run[threadId]; } );
-            _mutexLock.unlock();
-
-            if( pool->_exit[threadId] )
-                break;
-
-            pool->_taskInfo.lock();
-
-            if( !pool->_task.empty() ) {
-                AbstractTaskProvider * task = pool->_task.front();
-
-                pool->_task.pop_front();
-
-                pool->_taskInfo.unlock();
+        while( !pool->_exit ) {
+            AbstractTaskProvider * task = pool->_pop( threadId );
 
+            if( task != nullptr ) {
                 task->_taskRun( false );
             }
             else {
-                pool->_run[threadId] = 0;
-
-                pool->_taskInfo.unlock();
+                std::unique_lock < std::mutex > _mutexLock( pool->_taskInfo );
+                pool->_waiting.wait( _mutexLock, [&] { return pool->_exit || pool->_pendingTaskCount > 0; } );
             }
         }
 
@@ -3,7 +3,8 @@
 #include <atomic>
 #include <condition_variable>
 #include <cstdint>
-#include <list>
+#include <deque>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <vector>
@@ -69,7 +70,7 @@ namespace Thread_Pool
     class ThreadPool
     {
     public:
-        ThreadPool() { }
+        ThreadPool();
         explicit ThreadPool( size_t threads );
         ThreadPool & operator=( const ThreadPool & ) = delete;
         ThreadPool( const ThreadPool & ) = delete;
@@ -85,9 +86,17 @@ namespace Thread_Pool
 
         void stop(); // stop all working threads
     private:
+        // Every worker owns a queue of tasks. A worker takes tasks from the back of its own queue
+        // and when the queue is empty it steals tasks from the front of queues of other workers
+        struct TaskQueue
+        {
+            std::deque < AbstractTaskProvider * > task; // tasks assigned to a worker
+            std::mutex lock;                             // mutex for synchronization of queue access
+        };
+
         std::vector < std::thread > _worker; // an array of worker threads
-        std::vector < uint8_t > _run;        // indicator for threads to run tasks
-        std::vector < uint8_t > _exit;       // indicator for threads to close themselfs
+        std::vector < std::unique_ptr < TaskQueue > > _queue; // an array of task queues, one per worker
+        std::atomic < bool > _exit;          // indicator for threads to close themselfs
         std::condition_variable _waiting;    // condition variable for synchronization of threads
 
         std::mutex _creation;                       // mutex for thread creation verification
@@ -96,8 +105,16 @@ namespace Thread_Pool
         std::size_t _threadCount;                   // current number of threads in pool
         bool _threadsCreated;                       // indicator for pool that all threads are created
 
-        std::list < AbstractTaskProvider * > _task; // a list of tasks to perform
-        std::mutex _taskInfo;                       // mutex for synchronization between threads and pool to manage tasks
+        std::atomic < size_t > _pendingTaskCount; // total number of tasks in all queues
+        std::atomic < size_t > _nextQueue;        // queue from which a distribution of new tasks starts
+        std::mutex _taskInfo;                     // mutex for synchronization between sleeping threads and pool
+
+        void _start( size_t threads ); // create worker threads with their queues
+        void _join(); // close all worker threads. Not started tasks stay in queues
+        std::deque < AbstractTaskProvider * > _takeAll(); // remove all tasks from all queues
+        void _distribute( AbstractTaskProvider * provider, size_t taskCount ); // spread tasks across queues
+
+        AbstractTaskProvider * _pop( size_t threadId ); // take a task from own queue or steal it from another queue
 
         static void _workerThread( ThreadPool * pool, size_t threadId );
     };
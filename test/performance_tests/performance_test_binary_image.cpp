@@ -0,0 +1,147 @@
+#include <algorithm>
+#include "../../src/binary_image_function.h"
+#include "../../src/blob_detection.h"
+#include "performance_test_binary_image.h"
+#include "performance_test_helper.h"
+
+namespace
+{
+    std::pair < double, double > Threshold( uint32_t size )
+    {
+        Performance_Test::TimerContainer timer;
+
+        const PenguinV_Image::Image input = Performance_Test::uniformImage( size, size );
+        PenguinV_Image::BinaryImage output( size, size );
+
+        const uint8_t threshold = Performance_Test::randomValue<uint8_t>( 256 );
+
+        for( uint32_t i = 0; i < Performance_Test::runCount(); ++i ) {
+            timer.start();
+
+            Binary_Image_Function::Threshold( input, output, threshold );
+
+            timer.stop();
+        }
+
+        return timer.mean();
+    }
+
+    std::pair < double, double > BitwiseAnd( uint32_t size )
+    {
+        Performance_Test::TimerContainer timer;
+
+        const PenguinV_Image::BinaryImage input1 = Binary_Image_Function::Threshold( Performance_Test::uniformImage( size, size ), 128 );
+        const PenguinV_Image::BinaryImage input2 = Binary_Image_Function::Threshold( Performance_Test::uniformImage( size, size ), 128 );
+        PenguinV_Image::BinaryImage output( size, size );
+
+        for( uint32_t i = 0; i < Performance_Test::runCount(); ++i ) {
+            timer.start();
+
+            Binary_Image_Function::BitwiseAnd( input1, input2, output );
+
+            timer.stop();
+        }
+
+        return timer.mean();
+    }
+
+    std::pair < double, double > Dilate31x31( uint32_t size )
+    {
+        Performance_Test::TimerContainer timer;
+
+        const PenguinV_Image::BinaryImage input = Binary_Image_Function::Threshold( Performance_Test::uniformImage( size, size ), 250 );
+        PenguinV_Image::BinaryImage output( size, size );
+
+        for( uint32_t i = 0; i < Performance_Test::runCount(); ++i ) {
+            timer.start();
+
+            Binary_Image_Function::Dilate( input, output, 15, 15 );
+
+            timer.stop();
+        }
+
+        return timer.mean();
+    }
+
+    std::pair < double, double > Sum( uint32_t size )
+    {
+        Performance_Test::TimerContainer timer;
+
+        const PenguinV_Image::BinaryImage image = Binary_Image_Function::Threshold( Performance_Test::uniformImage( size, size ), 128 );
+
+        for( uint32_t i = 0; i < Performance_Test::runCount(); ++i ) {
+            timer.start();
+
+            Binary_Image_Function::Sum( image );
+
+            timer.stop();
+        }
+
+        return timer.mean();
+    }
+
+    // black image with 4 x 4 pixel squares placed in 16 pixel steps
+    std::pair < double, double > SparseImageRunLength( uint32_t size )
+    {
+        Performance_Test::TimerContainer timer;
+
+        PenguinV_Image::Image sparse = Performance_Test::uniformImage( size, size, 0 );
+
+        for( uint32_t y = 0; y < size; y += 16 ) {
+            for( uint32_t x = 0; x < size; x += 16 ) {
+                for( uint32_t i = 0; i < 4; ++i )
+                    std::fill( sparse.data() + (y + i) * sparse.rowSize() + x, sparse.data() + (y + i) * sparse.rowSize() + x + 4, 255 );
+            }
+        }
+
+        const PenguinV_Image::BinaryImage image = Binary_Image_Function::ConvertToBinary( sparse );
+
+        for( uint32_t i = 0; i < Performance_Test::runCount(); ++i ) {
+            timer.start();
+
+            { // destroy the object within the scope
+                Blob_Detection::BlobDetection detection;
+
+                detection.findRunLength( image );
+            }
+
+            timer.stop();
+        }
+
+        return timer.mean();
+    }
+}
+
+// Function naming: _functionName_imageSize
+#define SET_FUNCTION( function )                                      \
+namespace binary_image_##function                                     \
+{                                                                     \
+    std::pair < double, double > _256 () { return function( 256  ); } \
+    std::pair < double, double > _512 () { return function( 512  ); } \
+    std::pair < double, double > _1024() { return function( 1024 ); } \
+    std::pair < double, double > _2048() { return function( 2048 ); } \
+}
+
+namespace
+{
+    SET_FUNCTION( BitwiseAnd )
+    SET_FUNCTION( Dilate31x31 )
+    SET_FUNCTION( SparseImageRunLength )
+    SET_FUNCTION( Sum )
+    SET_FUNCTION( Threshold )
+}
+
+#define ADD_TEST_FUNCTION( framework, function )       \
+ADD_TEST( framework, binary_image_##function::_256 );  \
+ADD_TEST( framework, binary_image_##function::_512 );  \
+ADD_TEST( framework, binary_image_##function::_1024 ); \
+ADD_TEST( framework, binary_image_##function::_2048 );
+
+void addTests_Binary_Image( PerformanceTestFramework & framework )
+{
+    ADD_TEST_FUNCTION( framework, BitwiseAnd )
+    ADD_TEST_FUNCTION( framework, Dilate31x31 )
+    ADD_TEST_FUNCTION( framework, SparseImageRunLength )
+    ADD_TEST_FUNCTION( framework, Sum )
+    ADD_TEST_FUNCTION( framework, Threshold )
+}
@@ -1,4 +1,7 @@
+#include <algorithm>
 #include "../../src/blob_detection.h"
+#include "../../src/function_pool.h"
+#include "../../src/thread_pool.h"
 #include "performance_test_blob_detection.h"
 #include "performance_test_helper.h"
 
@@ -24,6 +27,151 @@ namespace
 
         return timer.mean();
     }
+
+    std::pair < double, double > SolidImageRunLength( uint32_t size )
+    {
+        Performance_Test::TimerContainer timer;
+
+        PenguinV_Image::Image image = Performance_Test::uniformImage( size, size, Performance_Test::randomValue<uint8_t>( 1, 256 ) );
+
+        for( uint32_t i = 0; i < Performance_Test::runCount(); ++i ) {
+            timer.start();
+
+            { // destroy the object within the scope
+                Blob_Detection::BlobDetection detection;
+
+                detection.findRunLength( image );
+            }
+
+            timer.stop();
+        }
+
+        return timer.mean();
+    }
+
+    std::pair < double, double > SolidImageFunctionPool( uint32_t size )
+    {
+        Performance_Test::TimerContainer timer;
+
+        Thread_Pool::ThreadPoolMonoid::instance().resize( 4 );
+
+        PenguinV_Image::Image image = Performance_Test::uniformImage( size, size, Performance_Test::randomValue<uint8_t>( 1, 256 ) );
+
+        for( uint32_t i = 0; i < Performance_Test::runCount(); ++i ) {
+            timer.start();
+
+            { // destroy the object within the scope
+                Function_Pool::BlobDetection detection;
+
+                detection.find( image );
+            }
+
+            timer.stop();
+        }
+
+        return timer.mean();
+    }
+
+    // black image with 4 x 4 pixel squares placed in 16 pixel steps
+    PenguinV_Image::Image sparseImage( uint32_t size )
+    {
+        PenguinV_Image::Image image = Performance_Test::uniformImage( size, size, 0 );
+
+        for( uint32_t y = 0; y < size; y += 16 ) {
+            for( uint32_t x = 0; x < size; x += 16 ) {
+                for( uint32_t i = 0; i < 4; ++i )
+                    std::fill( image.data() + (y + i) * image.rowSize() + x, image.data() + (y + i) * image.rowSize() + x + 4, 255 );
+            }
+        }
+
+        return image;
+    }
+
+    std::pair < double, double > SparseImage( uint32_t size )
+    {
+        Performance_Test::TimerContainer timer;
+
+        PenguinV_Image::Image image = sparseImage( size );
+
+        for( uint32_t i = 0; i < Performance_Test::runCount(); ++i ) {
+            timer.start();
+
+            { // destroy the object within the scope
+                Blob_Detection::BlobDetection detection;
+
+                detection.find( image );
+            }
+
+            timer.stop();
+        }
+
+        return timer.mean();
+    }
+
+    std::pair < double, double > SparseImageRunLength( uint32_t size )
+    {
+        Performance_Test::TimerContainer timer;
+
+        PenguinV_Image::Image image = sparseImage( size );
+
+        for( uint32_t i = 0; i < Performance_Test::runCount(); ++i ) {
+            timer.start();
+
+            { // destroy the object within the scope
+                Blob_Detection::BlobDetection detection;
+
+                detection.findRunLength( image );
+            }
+
+            timer.stop();
+        }
+
+        return timer.mean();
+    }
+
+    std::pair < double, double > SparseImageMoments( uint32_t size )
+    {
+        Performance_Test::TimerContainer timer;
+
+        PenguinV_Image::Image image = sparseImage( size );
+
+        for( uint32_t i = 0; i < Performance_Test::runCount(); ++i ) {
+            timer.start();
+
+            { // destroy the object within the scope
+                Blob_Detection::BlobDetection detection;
+
+                detection.find( image, Blob_Detection::BlobParameters(), 1, Blob_Detection::BlobDetection::SEARCH_MOMENTS );
+            }
+
+            timer.stop();
+        }
+
+        return timer.mean();
+    }
+
+    std::pair < double, double > SparseImageFunctionPool( uint32_t size )
+    {
+        Performance_Test::TimerContainer timer;
+
+        Thread_Pool::ThreadPoolMonoid::instance().resize( 4 );
+
+        PenguinV_Image::Image image = sparseImage( size );
+
+        for( uint32_t i = 0; i < Performance_Test::runCount(); ++i ) {
+            timer.start();
+
+            { // destroy the object within the scope
+                Function_Pool::BlobDetection detection;
+
+                detection.find( image );
+            }
+
+            timer.stop();
+        }
+
+        return timer.mean();
+    }
 }
 
 // Function naming: _functionName_imageSize
@@ -39,6 +187,12 @@ namespace blob_detection_##function                                   \
 namespace
 {
     SET_FUNCTION( SolidImage )
+    SET_FUNCTION( SolidImageRunLength )
+    SET_FUNCTION( SolidImageFunctionPool )
+    SET_FUNCTION( SparseImage )
+    SET_FUNCTION( SparseImageRunLength )
+    SET_FUNCTION( SparseImageMoments )
+    SET_FUNCTION( SparseImageFunctionPool )
 }
 
 #define ADD_TEST_FUNCTION( framework, function )         \
@@ -50,4 +204,10 @@ ADD_TEST( framework, blob_detection_##function::_2048 );
 void addTests_Blob_Detection( PerformanceTestFramework & framework )
 {
     ADD_TEST_FUNCTION( framework, SolidImage )
+    ADD_TEST_FUNCTION( framework, SolidImageRunLength )
+    ADD_TEST_FUNCTION( framework, SolidImageFunctionPool )
+    ADD_TEST_FUNCTION( framework, SparseImage )
+    ADD_TEST_FUNCTION( framework, SparseImageRunLength )
+    ADD_TEST_FUNCTION( framework, SparseImageMoments )
+    ADD_TEST_FUNCTION( framework, SparseImageFunctionPool )
 }
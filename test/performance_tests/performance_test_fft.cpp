@@ -0,0 +1,91 @@
+#include "../../src/fft.h"
+#include "performance_test_fft.h"
+#include "performance_test_helper.h"
+
+namespace
+{
+    std::pair < double, double > DirectTransform( uint32_t size )
+    {
+        Performance_Test::TimerContainer timer;
+
+        FFT::ComplexData data( Performance_Test::uniformImage( size, size ) );
+        FFT::FFTExecutor executor( size, size );
+
+        for( uint32_t i = 0; i < Performance_Test::runCount(); ++i ) {
+            timer.start();
+
+            executor.directTransform( data );
+
+            timer.stop();
+        }
+
+        return timer.mean();
+    }
+
+    std::pair < double, double > RealDirectTransform( uint32_t size )
+    {
+        Performance_Test::TimerContainer timer;
+
+        FFT::ComplexData data( Performance_Test::uniformImage( size, size ) );
+        FFT::RealFFTExecutor executor( size, size );
+
+        for( uint32_t i = 0; i < Performance_Test::runCount(); ++i ) {
+            timer.start();
+
+            executor.directTransform( data );
+
+            timer.stop();
+        }
+
+        return timer.mean();
+    }
+
+    std::pair < double, double > RealInverseTransform( uint32_t size )
+    {
+        Performance_Test::TimerContainer timer;
+
+        FFT::ComplexData data( Performance_Test::uniformImage( size, size ) );
+        FFT::RealFFTExecutor executor( size, size );
+        executor.directTransform( data );
+
+        for( uint32_t i = 0; i < Performance_Test::runCount(); ++i ) {
+            timer.start();
+
+            executor.inverseTransform( data );
+
+            timer.stop();
+        }
+
+        return timer.mean();
+    }
+}
+
+// Function naming: _functionName_imageSize
+#define SET_FUNCTION( function )                                      \
+namespace fft_##function                                              \
+{                                                                     \
+    std::pair < double, double > _256 () { return function( 256  ); } \
+    std::pair < double, double > _512 () { return function( 512  ); } \
+    std::pair < double, double > _1024() { return function( 1024 ); } \
+    std::pair < double, double > _2048() { return function( 2048 ); } \
+}
+
+namespace
+{
+    SET_FUNCTION( DirectTransform      )
+    SET_FUNCTION( RealDirectTransform  )
+    SET_FUNCTION( RealInverseTransform )
+}
+
+#define ADD_TEST_FUNCTION( framework, function ) \
+ADD_TEST( framework, fft_##function::_256 );     \
+ADD_TEST( framework, fft_##function::_512 );     \
+ADD_TEST( framework, fft_##function::_1024 );    \
+ADD_TEST( framework, fft_##function::_2048 );
+
+void addTests_FFT( PerformanceTestFramework & framework )
+{
+    ADD_TEST_FUNCTION( framework, DirectTransform      )
+    ADD_TEST_FUNCTION( framework, RealDirectTransform  )
+    ADD_TEST_FUNCTION( framework, RealInverseTransform )
+}
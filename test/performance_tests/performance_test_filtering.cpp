@@ -1,16 +1,72 @@
 #include "../../src/filtering.h"
+#include "../../src/function_pool.h"
+#include "../../src/image_function.h"
+#include "../../src/image_function_simd.h"
+#include "../../src/thread_pool.h"
 #include "performance_test_filtering.h"
 #include "performance_test_helper.h"
 
 namespace
 {
     typedef void ( *filterFunction )( const PenguinV_Image::Image & input, PenguinV_Image::Image & output );
+    typedef void ( *gradientFunction )( const PenguinV_Image::Image & input, PenguinV_Image::Image & magnitude,
+                                        PenguinV_Image::Image & direction );
+
+    void ConvolveFixedPoint5x5( const PenguinV_Image::Image & input, PenguinV_Image::Image & output )
+    {
+        // binomial kernel 1 4 6 4 1 in both directions: sum of kernel is 256
+        const std::vector < int16_t > kernel = { 1, 4, 6, 4, 1 };
+        Image_Function::Convolve( input, output, kernel, kernel, 8 );
+    }
+
+    void DilateFilter31x31( const PenguinV_Image::Image & input, PenguinV_Image::Image & output )
+    {
+        Image_Function::Dilate( input, output, 15, 15 );
+    }
+
+    void DilateFilterSimd31x31( const PenguinV_Image::Image & input, PenguinV_Image::Image & output )
+    {
+        Image_Function_Simd::Dilate( input, output, 15, 15 );
+    }
+
+    void GaussianBlur5x5( const PenguinV_Image::Image & input, PenguinV_Image::Image & output )
+    {
+        Image_Function::GaussianBlur( input, output, 2, 1.0f );
+    }
+
+    void GaussianBlurPool5x5( const PenguinV_Image::Image & input, PenguinV_Image::Image & output )
+    {
+        Thread_Pool::ThreadPoolMonoid::instance().resize( 4 );
+        Function_Pool::GaussianBlur( input, output, 2, 1.0f );
+    }
 
     void MedianFilter3x3( const PenguinV_Image::Image & input, PenguinV_Image::Image & output )
     {
         Image_Function::Median( input, output, 3 );
     }
 
+    void MedianFilter15x15( const PenguinV_Image::Image & input, PenguinV_Image::Image & output )
+    {
+        Image_Function::Median( input, output, 15 );
+    }
+
+    void MedianFilterPool15x15( const PenguinV_Image::Image & input, PenguinV_Image::Image & output )
+    {
+        Thread_Pool::ThreadPoolMonoid::instance().resize( 4 );
+        Function_Pool::Median( input, output, 15 );
+    }
+
+    void OpeningFilter15x15( const PenguinV_Image::Image & input, PenguinV_Image::Image & output )
+    {
+        Image_Function::Opening( input, output, 7, 7 );
+    }
+
+    void OpeningFilterPool15x15( const PenguinV_Image::Image & input, PenguinV_Image::Image & output )
+    {
+        Thread_Pool::ThreadPoolMonoid::instance().resize( 4 );
+        Function_Pool::Opening( input, output, 7, 7 );
+    }
+
     void PrewittFilter( const PenguinV_Image::Image & input, PenguinV_Image::Image & output )
     {
         Image_Function::Prewitt( input, output );
@@ -21,6 +77,17 @@ namespace
         Image_Function::Sobel( input, output );
     }
 
+    void SobelFilterDirection( const PenguinV_Image::Image & input, PenguinV_Image::Image & magnitude, PenguinV_Image::Image & direction )
+    {
+        Image_Function::Sobel( input, magnitude, direction );
+    }
+
+    void SobelFilterPool( const PenguinV_Image::Image & input, PenguinV_Image::Image & output )
+    {
+        Thread_Pool::ThreadPoolMonoid::instance().resize( 4 );
+        Function_Pool::Sobel( input, output );
+    }
+
     std::pair < double, double > FilterFunctionTest( filterFunction Filter, uint32_t size )
     {
         Performance_Test::TimerContainer timer;
@@ -38,6 +105,25 @@ namespace
 
         return timer.mean();
     }
+
+    std::pair < double, double > FilterFunctionTest( gradientFunction Filter, uint32_t size )
+    {
+        Performance_Test::TimerContainer timer;
+
+        PenguinV_Image::Image input = Performance_Test::uniformImage( size, size, Performance_Test::randomValue<uint8_t>( 1, 256 ) );
+        PenguinV_Image::Image magnitude( input.width(), input.height() );
+        PenguinV_Image::Image direction( input.width(), input.height() );
+
+        for( uint32_t i = 0; i < Performance_Test::runCount(); ++i ) {
+            timer.start();
+
+            Filter( input, magnitude, direction );
+
+            timer.stop();
+        }
+
+        return timer.mean();
+    }
 }
 
 // Function naming: _functionName_imageSize
@@ -52,9 +138,20 @@ namespace filtering_##function                                        \
 
 namespace
 {
+    SET_FUNCTION( ConvolveFixedPoint5x5 )
+    SET_FUNCTION( DilateFilter31x31 )
+    SET_FUNCTION( DilateFilterSimd31x31 )
+    SET_FUNCTION( GaussianBlur5x5 )
+    SET_FUNCTION( GaussianBlurPool5x5 )
     SET_FUNCTION( MedianFilter3x3 )
+    SET_FUNCTION( MedianFilter15x15 )
+    SET_FUNCTION( MedianFilterPool15x15 )
+    SET_FUNCTION( OpeningFilter15x15 )
+    SET_FUNCTION( OpeningFilterPool15x15 )
     SET_FUNCTION( PrewittFilter   )
     SET_FUNCTION( SobelFilter     )
+    SET_FUNCTION( SobelFilterDirection )
+    SET_FUNCTION( SobelFilterPool )
 }
 
 #define ADD_TEST_FUNCTION( framework, function )    \
@@ -65,7 +162,18 @@ ADD_TEST( framework, filtering_##function::_2048 );
 
 void addTests_Filtering( PerformanceTestFramework & framework )
 {
+    ADD_TEST_FUNCTION( framework, ConvolveFixedPoint5x5 )
+    ADD_TEST_FUNCTION( framework, DilateFilter31x31 )
+    ADD_TEST_FUNCTION( framework, DilateFilterSimd31x31 )
+    ADD_TEST_FUNCTION( framework, GaussianBlur5x5 )
+    ADD_TEST_FUNCTION( framework, GaussianBlurPool5x5 )
     ADD_TEST_FUNCTION( framework, MedianFilter3x3 )
+    ADD_TEST_FUNCTION( framework, MedianFilter15x15 )
+    ADD_TEST_FUNCTION( framework, MedianFilterPool15x15 )
+    ADD_TEST_FUNCTION( framework, OpeningFilter15x15 )
+    ADD_TEST_FUNCTION( framework, OpeningFilterPool15x15 )
     ADD_TEST_FUNCTION( framework, PrewittFilter   )
     ADD_TEST_FUNCTION( framework, SobelFilter     )
+    ADD_TEST_FUNCTION( framework, SobelFilterDirection )
+    ADD_TEST_FUNCTION( framework, SobelFilterPool )
 }
@@ -83,6 +83,10 @@ namespace Function_Template
             Image_Function_Simd::Simd_Activation::EnableSimd( true );
             Thread_Pool::ThreadPoolMonoid::instance().resize( 4 );
         }
+        else if ( namespaceName == "image_function_avx512" ) {
+            Image_Function_Simd::Simd_Activation::EnableSimd( false );
+            Image_Function_Simd::Simd_Activation::EnableAvx512( true );
+        }
         else if ( namespaceName == "image_function_avx" ) {
             Image_Function_Simd::Simd_Activation::EnableSimd( false );
             Image_Function_Simd::Simd_Activation::EnableAvx( true );
@@ -99,7 +103,8 @@ namespace Function_Template
 
     void CleanupFunction(const std::string& namespaceName)
     {
-        if ( (namespaceName == "image_function_avx") || (namespaceName == "image_function_sse") || (namespaceName == "image_function_neon") )
+        if ( (namespaceName == "image_function_avx512") || (namespaceName == "image_function_avx") || (namespaceName == "image_function_sse") ||
+             (namespaceName == "image_function_neon") )
             Image_Function_Simd::Simd_Activation::EnableSimd( true );
     }
 
@@ -212,6 +217,17 @@ namespace Function_Template
         TEST_FUNCTION_LOOP( Minimum( image[0], image[1], image[2] ), namespaceName )
     }
 
+    std::pair < double, double > template_Normalize( NormalizeFunction Normalize, const std::string & namespaceName, uint32_t size )
+    {
+        std::vector < PenguinV_Image::Image > image = Performance_Test::uniformImages( 2, size, size );
+
+        // a uniform image is just copied so the range of intensities is made wider
+        image[0].data()[0] = 16u;
+        image[0].data()[1] = 240u;
+
+        TEST_FUNCTION_LOOP( Normalize( image[0], image[1] ), namespaceName )
+    }
+
     std::pair < double, double > template_RgbToBgr( RgbToBgrFunction RgbToBgr, const std::string & namespaceName, uint32_t size )
     {
         std::vector < PenguinV_Image::Image > image = Performance_Test::uniformRGBImages( 2, size, size );
@@ -318,6 +334,7 @@ namespace image_function
     SET_FUNCTION( LookupTable        )
     SET_FUNCTION( Maximum            )
     SET_FUNCTION( Minimum            )
+    SET_FUNCTION( Normalize          )
     SET_FUNCTION( RgbToBgr           )
     REGISTER_FUNCTION( ResizeDown, Resize )
     REGISTER_FUNCTION( ResizeUp, Resize   )
@@ -347,6 +364,7 @@ namespace function_pool
     SET_FUNCTION( LookupTable        )
     SET_FUNCTION( Maximum            )
     SET_FUNCTION( Minimum            )
+    SET_FUNCTION( Normalize          )
     SET_FUNCTION( RgbToBgr           )
     REGISTER_FUNCTION( ResizeDown, Resize )
     REGISTER_FUNCTION( ResizeUp, Resize   )
@@ -356,6 +374,31 @@ namespace function_pool
     REGISTER_FUNCTION( ThresholdDouble, Threshold )
 }
 
+#ifdef PENGUINV_AVX512_SET
+namespace image_function_avx512
+{
+    using namespace Image_Function_Simd;
+
+    const bool isSupported = isAvx512Available;
+    const std::string namespaceName = "image_function_avx512";
+
+    SET_FUNCTION( AbsoluteDifference )
+    SET_FUNCTION( BitwiseAnd         )
+    SET_FUNCTION( BitwiseOr          )
+    SET_FUNCTION( BitwiseXor         )
+    SET_FUNCTION( GammaCorrection    )
+    SET_FUNCTION( Invert             )
+    SET_FUNCTION( LookupTable        )
+    SET_FUNCTION( Maximum            )
+    SET_FUNCTION( Minimum            )
+    SET_FUNCTION( Normalize          )
+    SET_FUNCTION( Subtract           )
+    SET_FUNCTION( Sum                )
+    SET_FUNCTION( Threshold          )
+    REGISTER_FUNCTION( ThresholdDouble, Threshold )
+}
+#endif
+
 #ifdef PENGUINV_AVX_SET
 namespace image_function_avx
 {
@@ -368,9 +411,12 @@ namespace image_function_avx
     SET_FUNCTION( BitwiseAnd         )
     SET_FUNCTION( BitwiseOr          )
     SET_FUNCTION( BitwiseXor         )
+    SET_FUNCTION( GammaCorrection    )
     SET_FUNCTION( Invert             )
+    SET_FUNCTION( LookupTable        )
     SET_FUNCTION( Maximum            )
     SET_FUNCTION( Minimum            )
+    SET_FUNCTION( Normalize          )
     SET_FUNCTION( Subtract           )
     SET_FUNCTION( Sum                )
     SET_FUNCTION( Threshold          )
@@ -390,9 +436,12 @@ namespace image_function_neon
     SET_FUNCTION( BitwiseAnd         )
     SET_FUNCTION( BitwiseOr          )
     SET_FUNCTION( BitwiseXor         )
+    SET_FUNCTION( GammaCorrection    )
     SET_FUNCTION( Invert             )
+    SET_FUNCTION( LookupTable        )
     SET_FUNCTION( Maximum            )
     SET_FUNCTION( Minimum            )
+    SET_FUNCTION( Normalize          )
     SET_FUNCTION( Subtract           )
     SET_FUNCTION( Sum                )
     SET_FUNCTION( Threshold          )
@@ -412,9 +461,12 @@ namespace image_function_sse
     SET_FUNCTION( BitwiseAnd         )
     SET_FUNCTION( BitwiseOr          )
     SET_FUNCTION( BitwiseXor         )
+    SET_FUNCTION( GammaCorrection    )
     SET_FUNCTION( Invert             )
+    SET_FUNCTION( LookupTable        )
     SET_FUNCTION( Maximum            )
     SET_FUNCTION( Minimum            )
+    SET_FUNCTION( Normalize          )
     SET_FUNCTION( Subtract           )
     SET_FUNCTION( Sum                )
     SET_FUNCTION( Threshold          )
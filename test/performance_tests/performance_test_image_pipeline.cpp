@@ -0,0 +1,77 @@
+#include "../../src/image_function_simd.h"
+#include "../../src/image_pipeline.h"
+#include "performance_test_image_pipeline.h"
+#include "performance_test_helper.h"
+
+namespace
+{
+    // Subtract --> AbsoluteDifference --> Threshold --> BitwiseAnd chain done by separate function calls
+    std::pair < double, double > SeparateFunctions( uint32_t size )
+    {
+        Performance_Test::TimerContainer timer;
+
+        const std::vector< PenguinV_Image::Image > input = Performance_Test::uniformImages( 4, size, size );
+        const uint8_t threshold = Performance_Test::randomValue<uint8_t>( 256 );
+
+        for( uint32_t i = 0; i < Performance_Test::runCount(); ++i ) {
+            timer.start();
+
+            const PenguinV_Image::Image difference = Image_Function_Simd::Subtract( input[0], input[1] );
+            const PenguinV_Image::Image absolute   = Image_Function_Simd::AbsoluteDifference( difference, input[2] );
+            const PenguinV_Image::Image binary     = Image_Function_Simd::Threshold( absolute, threshold );
+            const PenguinV_Image::Image output     = Image_Function_Simd::BitwiseAnd( binary, input[3] );
+
+            timer.stop();
+        }
+
+        return timer.mean();
+    }
+
+    // The same chain executed by fused pipeline
+    std::pair < double, double > FusedPipeline( uint32_t size )
+    {
+        Performance_Test::TimerContainer timer;
+
+        const std::vector< PenguinV_Image::Image > input = Performance_Test::uniformImages( 4, size, size );
+        const uint8_t threshold = Performance_Test::randomValue<uint8_t>( 256 );
+
+        for( uint32_t i = 0; i < Performance_Test::runCount(); ++i ) {
+            timer.start();
+
+            const PenguinV_Image::Image output = Image_Pipeline::Pipeline( input[0] ).subtract( input[1] ).absoluteDifference( input[2] )
+                                                     .threshold( threshold ).bitwiseAnd( input[3] ).execute();
+
+            timer.stop();
+        }
+
+        return timer.mean();
+    }
+}
+
+// Function naming: _functionName_imageSize
+#define SET_FUNCTION( function )                                      \
+namespace image_pipeline_##function                                   \
+{                                                                     \
+    std::pair < double, double > _256 () { return function( 256  ); } \
+    std::pair < double, double > _512 () { return function( 512  ); } \
+    std::pair < double, double > _1024() { return function( 1024 ); } \
+    std::pair < double, double > _2048() { return function( 2048 ); } \
+}
+
+namespace
+{
+    SET_FUNCTION( SeparateFunctions )
+    SET_FUNCTION( FusedPipeline     )
+}
+
+#define ADD_TEST_FUNCTION( framework, function )         \
+ADD_TEST( framework, image_pipeline_##function::_256 );  \
+ADD_TEST( framework, image_pipeline_##function::_512 );  \
+ADD_TEST( framework, image_pipeline_##function::_1024 ); \
+ADD_TEST( framework, image_pipeline_##function::_2048 );
+
+void addTests_Image_Pipeline( PerformanceTestFramework & framework )
+{
+    ADD_TEST_FUNCTION( framework, SeparateFunctions )
+    ADD_TEST_FUNCTION( framework, FusedPipeline     )
+}
@@ -0,0 +1,96 @@
+#include <limits>
+#include <thread>
+#include "../../src/memory/cpu_memory.h"
+#include "performance_test_memory_allocator.h"
+#include "performance_test_helper.h"
+
+namespace
+{
+    // Every thread allocates and frees chunks of frame-like sizes keeping the last few chunks alive to fragment memory
+    std::pair < double, double > AllocationThroughput( Cpu_Memory::MemoryAllocator::FreeListMode mode, uint32_t threadCount )
+    {
+        Performance_Test::TimerContainer timer;
+
+        Cpu_Memory::MemoryAllocator allocator( std::numeric_limits<size_t>::max(), mode );
+        allocator.reserve( 256 * 1024 * 1024 );
+
+        const uint32_t allocationCount = 20000u / threadCount;
+
+        for( uint32_t i = 0; i < Performance_Test::runCount(); ++i ) {
+            timer.start();
+
+            std::vector < std::thread > thread;
+
+            for( uint32_t threadId = 0; threadId < threadCount; ++threadId ) {
+                thread.push_back( std::thread( [&allocator, allocationCount, threadId]() {
+                    uint8_t * chunk[8] = { nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr };
+                    uint32_t seed = threadId + 1;
+
+                    for( uint32_t id = 0; id < allocationCount; ++id ) {
+                        seed = seed * 1103515245u + 12345u;
+
+                        uint8_t * & data = chunk[id % 8];
+                        if( data != nullptr )
+                            allocator.free( data );
+
+                        data = allocator.allocate( static_cast<size_t>( 4096u ) << ((seed >> 16) % 8) );
+                    }
+
+                    for( uint32_t id = 0; id < 8; ++id ) {
+                        if( chunk[id] != nullptr )
+                            allocator.free( chunk[id] );
+                    }
+                } ) );
+            }
+
+            for( std::vector < std::thread >::iterator t = thread.begin(); t != thread.end(); ++t )
+                t->join();
+
+            timer.stop();
+        }
+
+        return timer.mean();
+    }
+
+    std::pair < double, double > SetFreeList( uint32_t threadCount )
+    {
+        return AllocationThroughput( Cpu_Memory::MemoryAllocator::SET_FREE_LIST, threadCount );
+    }
+
+    std::pair < double, double > IntrusiveFreeList( uint32_t threadCount )
+    {
+        return AllocationThroughput( Cpu_Memory::MemoryAllocator::INTRUSIVE_FREE_LIST, threadCount );
+    }
+}
+
+// Function naming: _functionName_threadCount
+#define SET_FUNCTION( function )                                    \
+namespace memory_allocator_##function                               \
+{                                                                   \
+    std::pair < double, double > _1 () { return function( 1  ); }   \
+    std::pair < double, double > _2 () { return function( 2  ); }   \
+    std::pair < double, double > _4 () { return function( 4  ); }   \
+    std::pair < double, double > _8 () { return function( 8  ); }   \
+    std::pair < double, double > _16() { return function( 16 ); }   \
+    std::pair < double, double > _32() { return function( 32 ); }   \
+}
+
+namespace
+{
+    SET_FUNCTION( SetFreeList       )
+    SET_FUNCTION( IntrusiveFreeList )
+}
+
+#define ADD_TEST_FUNCTION( framework, function )        \
+ADD_TEST( framework, memory_allocator_##function::_1 );  \
+ADD_TEST( framework, memory_allocator_##function::_2 );  \
+ADD_TEST( framework, memory_allocator_##function::_4 );  \
+ADD_TEST( framework, memory_allocator_##function::_8 );  \
+ADD_TEST( framework, memory_allocator_##function::_16 ); \
+ADD_TEST( framework, memory_allocator_##function::_32 );
+
+void addTests_Memory_Allocator( PerformanceTestFramework & framework )
+{
+    ADD_TEST_FUNCTION( framework, SetFreeList       )
+    ADD_TEST_FUNCTION( framework, IntrusiveFreeList )
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "performance_test_framework.h"
+
+void addTests_Memory_Allocator( PerformanceTestFramework & framework );
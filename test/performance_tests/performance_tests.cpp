@@ -1,9 +1,13 @@
 // This application is designed to run performance tests on penguinV library
 #include <iostream>
+#include "performance_test_binary_image.h"
 #include "performance_test_blob_detection.h"
+#include "performance_test_fft.h"
 #include "performance_test_filtering.h"
 #include "performance_test_framework.h"
 #include "performance_test_image_function.h"
+#include "performance_test_image_pipeline.h"
+#include "performance_test_memory_allocator.h"
 
 int main()
 {
@@ -14,9 +18,13 @@ int main()
     PerformanceTestFramework framework;
 
     // We add tests
+    addTests_Binary_Image       ( framework );
     addTests_Blob_Detection     ( framework );
+    addTests_FFT                ( framework );
     addTests_Filtering          ( framework );
     addTests_Image_Function     ( framework );
+    addTests_Image_Pipeline     ( framework );
+    addTests_Memory_Allocator   ( framework );
 
     // Just run the framework what will handle all tests
     framework.run();
@@ -0,0 +1,159 @@
+#include <algorithm>
+#include "unit_test_binary_image.h"
+#include "unit_test_helper.h"
+#include "../../src/binary_image_function.h"
+#include "../../src/image_function.h"
+
+namespace
+{
+    // Widths are not multiple of 64 pixels in most cases so the last word of rows is partially filled
+    PenguinV_Image::Image randomImage( uint32_t width, uint32_t height )
+    {
+        PenguinV_Image::Image image( width, height );
+
+        uint8_t * outY = image.data();
+        const uint8_t * outYEnd = outY + image.height() * image.rowSize();
+
+        for( ; outY != outYEnd; outY += image.rowSize() ) {
+            uint8_t * outX = outY;
+            const uint8_t * outXEnd = outX + image.width();
+
+            for( ; outX != outXEnd; ++outX )
+                (*outX) = Unit_Test::randomValue<uint8_t>( 256 );
+        }
+
+        return image;
+    }
+
+    PenguinV_Image::Image randomBinaryImage( uint32_t width, uint32_t height )
+    {
+        return Image_Function::Threshold( randomImage( width, height ), Unit_Test::randomValue<uint8_t>( 1, 256 ) );
+    }
+
+    std::vector < uint32_t > scaledProfile( const std::vector < uint32_t > & projection )
+    {
+        std::vector < uint32_t > scaled( projection );
+
+        for( std::vector < uint32_t >::iterator value = scaled.begin(); value != scaled.end(); ++value )
+            (*value) *= 255u;
+
+        return scaled;
+    }
+}
+
+namespace binary_image
+{
+    bool BitwiseSameAsImage()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const uint32_t width  = Unit_Test::randomValue<uint32_t>( 1, 512 );
+            const uint32_t height = Unit_Test::randomValue<uint32_t>( 1, 64 );
+
+            const PenguinV_Image::Image input1 = randomBinaryImage( width, height );
+            const PenguinV_Image::Image input2 = randomBinaryImage( width, height );
+
+            const PenguinV_Image::BinaryImage binary1 = Binary_Image_Function::ConvertToBinary( input1 );
+            const PenguinV_Image::BinaryImage binary2 = Binary_Image_Function::ConvertToBinary( input2 );
+
+            if( !Image_Function::IsEqual( Binary_Image_Function::ConvertFromBinary( Binary_Image_Function::BitwiseAnd( binary1, binary2 ) ),
+                                          Image_Function::BitwiseAnd( input1, input2 ) ) ||
+                !Image_Function::IsEqual( Binary_Image_Function::ConvertFromBinary( Binary_Image_Function::BitwiseOr( binary1, binary2 ) ),
+                                          Image_Function::BitwiseOr( input1, input2 ) ) ||
+                !Image_Function::IsEqual( Binary_Image_Function::ConvertFromBinary( Binary_Image_Function::BitwiseXor( binary1, binary2 ) ),
+                                          Image_Function::BitwiseXor( input1, input2 ) ) ||
+                !Image_Function::IsEqual( Binary_Image_Function::ConvertFromBinary( Binary_Image_Function::Invert( binary1 ) ),
+                                          Image_Function::Invert( input1 ) ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    // Binary images are 0 and 255 gray-scale images for gray-scale morphology which ignores pixels outside of image as well
+    bool MorphologySameAsImage()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image input = randomBinaryImage( Unit_Test::randomValue<uint32_t>( 1, 512 ),
+                                                                   Unit_Test::randomValue<uint32_t>( 1, 64 ) );
+
+            const uint32_t radiusX = Unit_Test::randomValue<uint32_t>( 100 );
+            const uint32_t radiusY = Unit_Test::randomValue<uint32_t>( 20 );
+
+            PenguinV_Image::BinaryImage binary = Binary_Image_Function::ConvertToBinary( input );
+
+            if( Unit_Test::randomValue<uint32_t>( 2 ) == 0 ) {
+                Binary_Image_Function::Dilate( binary, binary, radiusX, radiusY );
+
+                if( !Image_Function::IsEqual( Binary_Image_Function::ConvertFromBinary( binary ), Image_Function::Dilate( input, radiusX, radiusY ) ) )
+                    return false;
+            }
+            else {
+                Binary_Image_Function::Erode( binary, binary, radiusX, radiusY );
+
+                if( !Image_Function::IsEqual( Binary_Image_Function::ConvertFromBinary( binary ), Image_Function::Erode( input, radiusX, radiusY ) ) )
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool SumAndProjectionProfile()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image input = randomBinaryImage( Unit_Test::randomValue<uint32_t>( 1, 512 ),
+                                                                   Unit_Test::randomValue<uint32_t>( 1, 64 ) );
+
+            const PenguinV_Image::BinaryImage binary = Binary_Image_Function::ConvertToBinary( input );
+
+            const bool horizontal = (Unit_Test::randomValue<uint32_t>( 2 ) == 0);
+
+            if( Binary_Image_Function::Sum( binary ) * 255u != Image_Function::Sum( input ) ||
+                scaledProfile( Binary_Image_Function::ProjectionProfile( binary, horizontal ) ) !=
+                Image_Function::ProjectionProfile( input, horizontal ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    bool ThresholdSameAsImage()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image input = randomImage( Unit_Test::randomValue<uint32_t>( 1, 512 ), Unit_Test::randomValue<uint32_t>( 1, 64 ) );
+
+            uint32_t roiX, roiY;
+            uint32_t roiWidth, roiHeight;
+            Unit_Test::generateRoi( input, roiX, roiY, roiWidth, roiHeight );
+
+            uint8_t minThreshold = Unit_Test::randomValue<uint8_t>( 256 );
+            uint8_t maxThreshold = Unit_Test::randomValue<uint8_t>( 256 );
+
+            if( minThreshold > maxThreshold )
+                std::swap( minThreshold, maxThreshold );
+
+            const PenguinV_Image::Image expected = Image_Function::Threshold( input, roiX, roiY, roiWidth, roiHeight, minThreshold );
+            const PenguinV_Image::Image expectedRange = Image_Function::Threshold( input, roiX, roiY, roiWidth, roiHeight, minThreshold,
+                                                                                   maxThreshold );
+
+            const PenguinV_Image::BinaryImage binary = Binary_Image_Function::Threshold( input, roiX, roiY, roiWidth, roiHeight, minThreshold );
+            const PenguinV_Image::BinaryImage binaryRange = Binary_Image_Function::Threshold( input, roiX, roiY, roiWidth, roiHeight, minThreshold,
+                                                                                              maxThreshold );
+
+            if( !Image_Function::IsEqual( Binary_Image_Function::ConvertFromBinary( binary ), expected ) ||
+                !Binary_Image_Function::IsEqual( Binary_Image_Function::ConvertToBinary( expected ), binary ) ||
+                !Image_Function::IsEqual( Binary_Image_Function::ConvertFromBinary( binaryRange ), expectedRange ) )
+                return false;
+        }
+
+        return true;
+    }
+}
+
+void addTests_Binary_Image( UnitTestFramework & framework )
+{
+    ADD_TEST( framework, binary_image::BitwiseSameAsImage );
+    ADD_TEST( framework, binary_image::MorphologySameAsImage );
+    ADD_TEST( framework, binary_image::SumAndProjectionProfile );
+    ADD_TEST( framework, binary_image::ThresholdSameAsImage );
+}
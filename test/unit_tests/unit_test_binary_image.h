@@ -0,0 +1,5 @@
+#pragma once
+
+#include "unit_test_framework.h"
+
+void addTests_Binary_Image( UnitTestFramework & framework );
@@ -1,7 +1,46 @@
+#include <cstring>
 #include "unit_test_bitmap.h"
 #include "unit_test_helper.h"
 #include "../../src/FileOperation/bitmap.h"
 
+namespace
+{
+    PenguinV_Image::Image randomColorImage( uint8_t colorCount )
+    {
+        // odd width to have padding at the end of every line in a file
+        PenguinV_Image::Image image( Unit_Test::randomValue<uint32_t>( 1, 100 ) | 1u, Unit_Test::randomValue<uint32_t>( 1, 100 ),
+                                     colorCount );
+
+        uint8_t * imageY = image.data();
+        const uint8_t * imageYEnd = imageY + image.height() * image.rowSize();
+
+        for( ; imageY != imageYEnd; imageY += image.rowSize() ) {
+            const std::vector < uint8_t > value = Unit_Test::intensityArray( image.width() * colorCount );
+            memcpy( imageY, value.data(), value.size() );
+        }
+
+        return image;
+    }
+
+    bool equalArea( const PenguinV_Image::Image & image, uint32_t x, uint32_t y, const PenguinV_Image::Image & area )
+    {
+        // a loaded image has row size aligned as in a bitmap file so rows are compared one by one
+        if( area.colorCount() != image.colorCount() || area.width() == 0 || area.height() == 0 ||
+            x + area.width() > image.width() || y + area.height() > image.height() )
+            return false;
+
+        const uint32_t lineLength = area.width() * area.colorCount();
+
+        for( uint32_t rowId = 0; rowId < area.height(); ++rowId ) {
+            if( memcmp( image.data() + (y + rowId) * image.rowSize() + x * image.colorCount(),
+                        area.data() + rowId * area.rowSize(), lineLength ) != 0 )
+                return false;
+        }
+
+        return true;
+    }
+}
+
 namespace bitmap_operation
 {
     bool LoadSaveGrayScaleImage()
@@ -18,10 +57,33 @@ namespace bitmap_operation
 
         return true;
     }
+
+    bool LoadSaveMappedImage()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image original = randomColorImage( (i % 2 == 0) ? 1u : 3u );
+
+            Bitmap_Operation::Save( "mapped.bmp", original );
+
+            if( !equalArea( original, 0, 0, Bitmap_Operation::LoadMapped( "mapped.bmp" ) ) )
+                return false;
+
+            uint32_t roiX, roiY, roiWidth, roiHeight;
+            Unit_Test::generateRoi( original, roiX, roiY, roiWidth, roiHeight );
+
+            Bitmap_Operation::SaveMapped( "mapped.bmp", original, roiX, roiY, roiWidth, roiHeight );
+
+            if( !equalArea( original, roiX, roiY, Bitmap_Operation::Load( "mapped.bmp" ) ) )
+                return false;
+        }
+
+        return true;
+    }
 }
 
 
 void addTests_Bitmap( UnitTestFramework & framework )
 {
     ADD_TEST( framework, bitmap_operation::LoadSaveGrayScaleImage );
+    ADD_TEST( framework, bitmap_operation::LoadSaveMappedImage );
 }
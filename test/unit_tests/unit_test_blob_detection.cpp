@@ -1,7 +1,63 @@
+#include <algorithm>
+#include <cmath>
+#include <thread>
 #include "unit_test_blob_detection.h"
 #include "unit_test_helper.h"
+#include "../../src/binary_image_function.h"
 #include "../../src/blob_detection.h"
+#include "../../src/function_pool.h"
 #include "../../src/image_function.h"
+#include "../../src/thread_pool.h"
+
+namespace
+{
+    // Flood fill search is slow on big noisy images so test images must be small enough
+    PenguinV_Image::Image randomImage( uint32_t width, uint32_t height )
+    {
+        PenguinV_Image::Image image( width, height );
+
+        uint8_t * outY = image.data();
+        const uint8_t * outYEnd = outY + image.height() * image.rowSize();
+
+        for( ; outY != outYEnd; outY += image.rowSize() ) {
+            uint8_t * outX = outY;
+            const uint8_t * outXEnd = outX + image.width();
+
+            for( ; outX != outXEnd; ++outX )
+                (*outX) = Unit_Test::randomValue<uint8_t>( 256 );
+        }
+
+        return image;
+    }
+
+    std::vector < std::pair < uint32_t, uint32_t > > sortedPoints( const std::vector < uint32_t > & x, const std::vector < uint32_t > & y )
+    {
+        std::vector < std::pair < uint32_t, uint32_t > > point( x.size() );
+
+        for( size_t i = 0; i < x.size(); ++i )
+            point[i] = std::make_pair( y[i], x[i] );
+
+        std::sort( point.begin(), point.end() );
+
+        return point;
+    }
+
+    bool equalBlobs( Blob_Detection::BlobInfo & blob1, Blob_Detection::BlobInfo & blob2 )
+    {
+        const Blob_Detection::Area area1 = blob1.area();
+        const Blob_Detection::Area area2 = blob2.area();
+
+        const Point2d center1 = blob1.center();
+        const Point2d center2 = blob2.center();
+
+        return blob1.size() == blob2.size() && blob1.width() == blob2.width() && blob1.height() == blob2.height() &&
+               area1.left == area2.left && area1.right == area2.right && area1.top == area2.top && area1.bottom == area2.bottom &&
+               std::fabs( center1.x - center2.x ) < 1e-6 && std::fabs( center1.y - center2.y ) < 1e-6 &&
+               sortedPoints( blob1.pointX  (), blob1.pointY  () ) == sortedPoints( blob2.pointX  (), blob2.pointY  () ) &&
+               sortedPoints( blob1.contourX(), blob1.contourY() ) == sortedPoints( blob2.contourX(), blob2.contourY() ) &&
+               sortedPoints( blob1.edgeX   (), blob1.edgeY   () ) == sortedPoints( blob2.edgeX   (), blob2.edgeY   () );
+    }
+}
 
 namespace blob_detection
 {
@@ -30,10 +86,363 @@ namespace blob_detection
 
         return true;
     }
+
+    bool Detect1BlobRunLength()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            PenguinV_Image::Image image = Unit_Test::blackImage();
+
+            uint32_t roiX, roiY;
+            uint32_t roiWidth, roiHeight;
+            Unit_Test::generateRoi( image, roiX, roiY, roiWidth, roiHeight );
+
+            Unit_Test::fillImage( image, roiX, roiY, roiWidth, roiHeight, Unit_Test::randomValue<uint8_t>( 1, 256 ) );
+
+            Blob_Detection::BlobDetection detection;
+            detection.findRunLength( image );
+
+            const uint32_t contour = ((roiWidth > 1) && (roiHeight > 2)) ? (2 * roiWidth + 2 * (roiHeight - 2)) : (roiWidth * roiHeight);
+
+            if( detection().size() != 1 || detection()[0].width() != roiWidth ||
+                detection()[0].height() != roiHeight || detection()[0].size() != roiWidth * roiHeight ||
+                detection()[0].contourX().size() != contour ||
+                detection()[0].edgeX   ().size() != contour )
+                return false;
+        }
+
+        return true;
+    }
+
+    bool RunLengthSameAsFloodFill()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image image = randomImage( Unit_Test::randomValue<uint32_t>( 1, 512 ), Unit_Test::randomValue<uint32_t>( 1, 512 ) );
+
+            uint32_t roiX, roiY;
+            uint32_t roiWidth, roiHeight;
+            Unit_Test::generateRoi( image, roiX, roiY, roiWidth, roiHeight );
+
+            const uint8_t threshold = Unit_Test::randomValue<uint8_t>( 1, 256 );
+
+            Blob_Detection::BlobDetection floodFill;
+            floodFill.find( image, roiX, roiY, roiWidth, roiHeight, Blob_Detection::BlobParameters(), threshold );
+
+            Blob_Detection::BlobDetection runLength;
+            runLength.findRunLength( image, roiX, roiY, roiWidth, roiHeight, Blob_Detection::BlobParameters(), threshold );
+
+            if( floodFill().size() != runLength().size() )
+                return false;
+
+            for( size_t blobId = 0; blobId < floodFill().size(); ++blobId ) {
+                if( !equalBlobs( floodFill()[blobId], runLength()[blobId] ) )
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Length must be the same as the maximum distance between contour points and all contour points must be inside minimum area
+    // Threshold is high enough to produce small blobs as the distance is checked by brute force
+    bool ConvexHullGeometry()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image image = randomImage( Unit_Test::randomValue<uint32_t>( 1, 256 ), Unit_Test::randomValue<uint32_t>( 1, 256 ) );
+
+            Blob_Detection::BlobDetection detection;
+            detection.findRunLength( image, Blob_Detection::BlobParameters(), Unit_Test::randomValue<uint8_t>( 160, 256 ) );
+
+            for( std::vector < Blob_Detection::BlobInfo >::iterator blob = detection().begin(); blob != detection().end(); ++blob ) {
+                const std::vector < uint32_t > & x = blob->contourX();
+                const std::vector < uint32_t > & y = blob->contourY();
+
+                double maximumDistance = 0;
+
+                for( size_t id1 = 0; id1 < x.size(); ++id1 ) {
+                    for( size_t id2 = id1 + 1; id2 < x.size(); ++id2 ) {
+                        const double distanceX = static_cast<double>(x[id1]) - x[id2];
+                        const double distanceY = static_cast<double>(y[id1]) - y[id2];
+
+                        maximumDistance = std::max( maximumDistance, distanceX * distanceX + distanceY * distanceY );
+                    }
+                }
+
+                if( std::fabs( blob->length() - std::sqrt( maximumDistance ) ) > 1e-6 || blob->elongation() < 1 )
+                    return false;
+
+                const Blob_Detection::OrientedArea area = blob->minimumArea();
+                const double cosAngle = std::cos( area.angle );
+                const double sinAngle = std::sin( area.angle );
+
+                if( area.width * area.height > static_cast<double>(blob->width() - 1) * (blob->height() - 1) + 1e-6 )
+                    return false;
+
+                for( size_t id = 0; id < x.size(); ++id ) {
+                    const double alongX = (x[id] - area.center.x) * cosAngle + (y[id] - area.center.y) * sinAngle;
+                    const double alongY = (y[id] - area.center.y) * cosAngle - (x[id] - area.center.x) * sinAngle;
+
+                    if( std::fabs( alongX ) > area.width / 2 + 1e-6 || std::fabs( alongY ) > area.height / 2 + 1e-6 )
+                        return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    // Blobs found in moments mode have the same basic features as blobs with all points
+    bool MomentsSameAsPoints()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image image = randomImage( Unit_Test::randomValue<uint32_t>( 1, 512 ), Unit_Test::randomValue<uint32_t>( 1, 512 ) );
+
+            uint32_t roiX, roiY;
+            uint32_t roiWidth, roiHeight;
+            Unit_Test::generateRoi( image, roiX, roiY, roiWidth, roiHeight );
+
+            const uint8_t threshold = Unit_Test::randomValue<uint8_t>( 1, 256 );
+
+            Blob_Detection::BlobDetection points;
+            points.find( image, roiX, roiY, roiWidth, roiHeight, Blob_Detection::BlobParameters(), threshold );
+
+            Blob_Detection::BlobDetection moments;
+            moments.find( image, roiX, roiY, roiWidth, roiHeight, Blob_Detection::BlobParameters(), threshold,
+                          Blob_Detection::BlobDetection::SEARCH_MOMENTS );
+
+            if( points().size() != moments().size() )
+                return false;
+
+            for( size_t blobId = 0; blobId < points().size(); ++blobId ) {
+                Blob_Detection::BlobInfo & blob1 = points()[blobId];
+                Blob_Detection::BlobInfo & blob2 = moments()[blobId];
+
+                const Blob_Detection::Area area1 = blob1.area();
+                const Blob_Detection::Area area2 = blob2.area();
+
+                const Point2d center1 = blob1.center();
+                const Point2d center2 = blob2.center();
+
+                const Blob_Detection::Moments moments1 = blob1.moments();
+                const Blob_Detection::Moments moments2 = blob2.moments();
+
+                if( blob1.size() != blob2.size() || blob1.width() != blob2.width() || blob1.height() != blob2.height() ||
+                    area1.left != area2.left || area1.right != area2.right || area1.top != area2.top || area1.bottom != area2.bottom ||
+                    std::fabs( center1.x - center2.x ) > 1e-6 || std::fabs( center1.y - center2.y ) > 1e-6 ||
+                    std::fabs( moments1.mu20 - moments2.mu20 ) > 1e-6 * (1 + moments1.mu20) ||
+                    std::fabs( moments1.mu11 - moments2.mu11 ) > 1e-6 * (1 + std::fabs( moments1.mu11 )) ||
+                    std::fabs( moments1.mu02 - moments2.mu02 ) > 1e-6 * (1 + moments1.mu02) ||
+                    moments1.perimeter != moments2.perimeter || !blob2.pointX().empty() || !blob2.contourX().empty() )
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Shape features estimated by moments are exact for a rectangle, solidity cannot be estimated
+    bool MomentsOfRectangle()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            PenguinV_Image::Image image = Unit_Test::blackImage();
+
+            uint32_t roiX, roiY;
+            uint32_t roiWidth, roiHeight;
+            Unit_Test::generateRoi( image, roiX, roiY, roiWidth, roiHeight );
+
+            Unit_Test::fillImage( image, roiX, roiY, roiWidth, roiHeight, Unit_Test::randomValue<uint8_t>( 1, 256 ) );
+
+            Blob_Detection::BlobDetection points;
+            points.find( image );
+
+            Blob_Detection::BlobDetection moments;
+            moments.find( image, Blob_Detection::BlobParameters(), 1, Blob_Detection::BlobDetection::SEARCH_MOMENTS );
+
+            if( moments().size() != 1 || moments()[0].moments().perimeter != 2 * (roiWidth + roiHeight) ||
+                std::fabs( points()[0].length() - moments()[0].length() ) > 1e-6 ||
+                std::fabs( points()[0].elongation() - moments()[0].elongation() ) > 1e-6 )
+                return false;
+
+            // moments do not tell about holes
+            try {
+                moments()[0].isSolid();
+                return false;
+            }
+            catch( imageException & ) {
+            }
+        }
+
+        return true;
+    }
+
+    bool RunsSameAsPoints()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image image = randomImage( Unit_Test::randomValue<uint32_t>( 1, 512 ), Unit_Test::randomValue<uint32_t>( 1, 512 ) );
+
+            Blob_Detection::BlobDetection detection;
+            detection.findRunLength( image, Blob_Detection::BlobParameters(), Unit_Test::randomValue<uint8_t>( 1, 256 ) );
+
+            for( std::vector < Blob_Detection::BlobInfo >::iterator blob = detection().begin(); blob != detection().end(); ++blob ) {
+                std::vector < uint32_t > x;
+                std::vector < uint32_t > y;
+
+                for( size_t id = 0; id < blob->runCount(); ++id ) {
+                    const Blob_Detection::PointRun run = blob->run( id );
+
+                    if( (run.startX >= run.endX) || (id > 0 && blob->run( id - 1 ).y > run.y) )
+                        return false;
+
+                    for( uint32_t pointX = run.startX; pointX != run.endX; ++pointX ) {
+                        x.push_back( pointX );
+                        y.push_back( run.y );
+                    }
+                }
+
+                if( x.size() != blob->size() || sortedPoints( x, y ) != sortedPoints( blob->pointX(), blob->pointY() ) )
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Coordinates of runs do not fit into 16 bits so the storage keeps full size values
+    bool RunLengthWideImage()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image image = randomImage( Unit_Test::randomValue<uint32_t>( 65537, 70000 ), Unit_Test::randomValue<uint32_t>( 1, 4 ) );
+
+            const uint8_t threshold = Unit_Test::randomValue<uint8_t>( 1, 256 );
+
+            Blob_Detection::BlobDetection floodFill;
+            floodFill.find( image, Blob_Detection::BlobParameters(), threshold );
+
+            Blob_Detection::BlobDetection runLength;
+            runLength.findRunLength( image, Blob_Detection::BlobParameters(), threshold );
+
+            if( floodFill().size() != runLength().size() )
+                return false;
+
+            for( size_t blobId = 0; blobId < floodFill().size(); ++blobId ) {
+                if( !equalBlobs( floodFill()[blobId], runLength()[blobId] ) )
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool FunctionPoolSameAsRunLength()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            Thread_Pool::ThreadPoolMonoid::instance().resize( Unit_Test::randomValue<uint8_t>( 1, 8 ) );
+
+            const PenguinV_Image::Image image = randomImage( Unit_Test::randomValue<uint32_t>( 1, 512 ), Unit_Test::randomValue<uint32_t>( 1, 512 ) );
+
+            uint32_t roiX, roiY;
+            uint32_t roiWidth, roiHeight;
+            Unit_Test::generateRoi( image, roiX, roiY, roiWidth, roiHeight );
+
+            const uint8_t threshold = Unit_Test::randomValue<uint8_t>( 1, 256 );
+
+            Blob_Detection::BlobDetection runLength;
+            runLength.findRunLength( image, roiX, roiY, roiWidth, roiHeight, Blob_Detection::BlobParameters(), threshold );
+
+            Function_Pool::BlobDetection pool;
+            pool.find( image, roiX, roiY, roiWidth, roiHeight, Blob_Detection::BlobParameters(), threshold );
+
+            if( runLength().size() != pool().size() )
+                return false;
+
+            for( size_t blobId = 0; blobId < runLength().size(); ++blobId ) {
+                if( !equalBlobs( runLength()[blobId], pool()[blobId] ) )
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool BinaryImageSameAsRunLength()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image image = randomImage( Unit_Test::randomValue<uint32_t>( 1, 512 ), Unit_Test::randomValue<uint32_t>( 1, 512 ) );
+
+            const uint8_t threshold = Unit_Test::randomValue<uint8_t>( 1, 256 );
+
+            Blob_Detection::BlobDetection runLength;
+            runLength.findRunLength( image, Blob_Detection::BlobParameters(), threshold );
+
+            Blob_Detection::BlobDetection binary;
+            binary.findRunLength( Binary_Image_Function::Threshold( image, threshold ) );
+
+            if( runLength().size() != binary().size() )
+                return false;
+
+            for( size_t blobId = 0; blobId < runLength().size(); ++blobId ) {
+                if( !equalBlobs( runLength()[blobId], binary()[blobId] ) )
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool ConcurrentConstAccess()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image image = randomImage( Unit_Test::randomValue<uint32_t>( 1, 256 ), Unit_Test::randomValue<uint32_t>( 1, 256 ) );
+
+            const uint8_t threshold = Unit_Test::randomValue<uint8_t>( 1, 256 );
+
+            Blob_Detection::BlobDetection reference;
+            reference.findRunLength( image, Blob_Detection::BlobParameters(), threshold );
+
+            Blob_Detection::BlobDetection detection;
+            const std::vector < Blob_Detection::BlobInfo > & blob = detection.findRunLength( image, Blob_Detection::BlobParameters(), threshold );
+
+            // all threads request point arrays and convex hull of the same blobs which are not extracted yet
+            std::vector < std::thread > worker;
+
+            for( uint32_t threadId = 0; threadId < 4; ++threadId ) {
+                worker.push_back( std::thread( [&blob]() {
+                    for( std::vector < Blob_Detection::BlobInfo >::const_iterator info = blob.begin(); info != blob.end(); ++info ) {
+                        info->convexHullX();
+                        info->pointX();
+                        info->isSolid();
+                    }
+                } ) );
+            }
+
+            for( std::vector < std::thread >::iterator thread = worker.begin(); thread != worker.end(); ++thread )
+                thread->join();
+
+            for( size_t blobId = 0; blobId < blob.size(); ++blobId ) {
+                const Blob_Detection::BlobInfo & expected = reference()[blobId];
+
+                if( blob[blobId].pointX() != expected.pointX() || blob[blobId].contourY() != expected.contourY() ||
+                    blob[blobId].edgeX() != expected.edgeX() || blob[blobId].convexHullX() != expected.convexHullX() ||
+                    blob[blobId].convexHullY() != expected.convexHullY() )
+                    return false;
+            }
+        }
+
+        return true;
+    }
 }
 
 
 void addTests_Blob_Detection( UnitTestFramework & framework )
 {
     framework.add( blob_detection::Detect1Blob, "blob_detection::Detect one blob" );
+    framework.add( blob_detection::Detect1BlobRunLength, "blob_detection::Detect one blob (run-length)" );
+    framework.add( blob_detection::RunLengthSameAsFloodFill, "blob_detection::Run-length search is same as flood fill" );
+    framework.add( blob_detection::ConvexHullGeometry, "blob_detection::Convex hull geometry" );
+    framework.add( blob_detection::MomentsSameAsPoints, "blob_detection::Moments search is same as point search" );
+    framework.add( blob_detection::MomentsOfRectangle, "blob_detection::Moments of rectangle" );
+    framework.add( blob_detection::RunsSameAsPoints, "blob_detection::Runs of blob are same as points" );
+    framework.add( blob_detection::RunLengthWideImage, "blob_detection::Run-length search on wide image" );
+    framework.add( blob_detection::FunctionPoolSameAsRunLength, "blob_detection::Function pool search is same as run-length search" );
+    framework.add( blob_detection::BinaryImageSameAsRunLength, "blob_detection::Binary image search is same as run-length search" );
+    framework.add( blob_detection::ConcurrentConstAccess, "blob_detection::Concurrent access to constant blobs" );
 }
@@ -0,0 +1,200 @@
+#include <cmath>
+#include "unit_test_fft.h"
+#include "unit_test_helper.h"
+#include "../../src/fft.h"
+#include "../../src/image_exception.h"
+
+namespace
+{
+    // Random image with power of 2 width and height
+    PenguinV_Image::Image randomFFTImage()
+    {
+        const uint32_t width  = 2u << Unit_Test::randomValue<uint32_t>( 8 );
+        const uint32_t height = 1u << Unit_Test::randomValue<uint32_t>( 9 );
+
+        PenguinV_Image::Image image( width, height );
+
+        for( uint32_t y = 0; y < height; ++y ) {
+            uint8_t * data = image.data() + y * image.rowSize();
+
+            for( uint32_t x = 0; x < width; ++x )
+                data[x] = Unit_Test::randomValue<uint8_t>( 256 );
+        }
+
+        return image;
+    }
+
+    bool equalData( const FFT::ComplexData & left, const FFT::ComplexData & right, float tolerance )
+    {
+        const kiss_fft_cpx * leftX  = left.data();
+        const kiss_fft_cpx * rightX = right.data();
+        const kiss_fft_cpx * leftXEnd = leftX + left.width() * left.height();
+
+        for( ; leftX != leftXEnd; ++leftX, ++rightX ) {
+            if( std::fabs( leftX->r - rightX->r ) > tolerance || std::fabs( leftX->i - rightX->i ) > tolerance )
+                return false;
+        }
+
+        return true;
+    }
+}
+
+namespace fft
+{
+    bool ComplexDataMemoryReuse()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image image = randomFFTImage();
+
+            FFT::ComplexData data( image );
+            const kiss_fft_cpx * memory = data.data();
+
+            if( reinterpret_cast<size_t>( memory ) % 64 != 0 )
+                return false;
+
+            data.set( image.generate( image.width(), image.height() ) );
+
+            const FFT::ComplexData another( image );
+            data = another;
+
+            if( data.data() != memory )
+                return false;
+        }
+
+        return true;
+    }
+
+    bool PlanCacheReuse()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const uint32_t width  = 1u << Unit_Test::randomValue<uint32_t>( 1, 9 );
+            const uint32_t height = 1u << Unit_Test::randomValue<uint32_t>( 1, 9 );
+
+            FFT::PlanCache::instance().clear();
+            { FFT::FFTExecutor executor( width, height ); }
+
+            const size_t hitCount  = FFT::PlanCache::instance().hitCount();
+            const size_t missCount = FFT::PlanCache::instance().missCount();
+
+            FFT::FFTExecutor executor( width, height );
+            executor.initialize( width, height );
+
+            // both direct and inverse plans must be taken from the cache
+            if( FFT::PlanCache::instance().hitCount() != hitCount + 2 || FFT::PlanCache::instance().missCount() != missCount )
+                return false;
+
+            // the plan is used by executor so another executor needs new plans
+            FFT::FFTExecutor another( width, height );
+
+            if( FFT::PlanCache::instance().missCount() != missCount + 2 )
+                return false;
+        }
+
+        return true;
+    }
+
+    bool RealFFTTwiddleReuse()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const uint32_t width  = 1u << Unit_Test::randomValue<uint32_t>( 1, 9 );
+            const uint32_t height = 1u << Unit_Test::randomValue<uint32_t>( 1, 9 );
+
+            FFT::PlanCache::instance().clear();
+            FFT::RealFFTExecutor executor( width, height );
+
+            const size_t hitCount  = FFT::PlanCache::instance().hitCount();
+            const size_t missCount = FFT::PlanCache::instance().missCount();
+
+            // twiddle factors are read-only so they are shared even with an executor which is still alive
+            FFT::RealFFTExecutor another( width, height );
+
+            if( FFT::PlanCache::instance().hitCount() != hitCount + 1 || FFT::PlanCache::instance().missCount() != missCount )
+                return false;
+        }
+
+        return true;
+    }
+
+    bool RealFFTDirectTransform()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image image = randomFFTImage();
+
+            FFT::ComplexData expected( image );
+            FFT::FFTExecutor executor( image.width(), image.height() );
+            executor.directTransform( expected );
+
+            const FFT::ComplexData input( image );
+            FFT::ComplexData output( image );
+            FFT::RealFFTExecutor realExecutor( image.width(), image.height() );
+            realExecutor.directTransform( input, output );
+
+            // both transforms are done in single precision so the tolerance depends on a size of image
+            const float tolerance = 0.002f * static_cast<float>( image.width() * image.height() );
+
+            if( !equalData( expected, output, tolerance ) )
+                return false;
+
+            output = input;
+            realExecutor.directTransform( output );
+
+            if( !equalData( expected, output, tolerance ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    bool RealFFTInverseTransform()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image image = randomFFTImage();
+
+            FFT::ComplexData data( image );
+            FFT::RealFFTExecutor executor( image.width(), image.height() );
+            executor.directTransform( data );
+            executor.inverseTransform( data );
+
+            // inverse transform is not normalized
+            const float size = static_cast<float>( image.width() * image.height() );
+
+            for( uint32_t y = 0; y < image.height(); ++y ) {
+                const uint8_t * original = image.data() + y * image.rowSize();
+                const kiss_fft_cpx * restored = data.data() + y * image.width();
+
+                for( uint32_t x = 0; x < image.width(); ++x ) {
+                    if( std::fabs( restored[x].r / size - original[x] ) > 0.01f || restored[x].i != 0 )
+                        return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool RealFFTInvalidSize()
+    {
+        const uint32_t size[][2] = { { 0, 0 }, { 1, 1 }, { 1, 8 }, { 6, 8 }, { 8, 0 }, { 8, 12 } };
+
+        for( uint32_t i = 0; i < sizeof( size ) / sizeof( size[0] ); ++i ) {
+            try {
+                FFT::RealFFTExecutor executor( size[i][0], size[i][1] );
+                return false;
+            }
+            catch( imageException & ) {
+            }
+        }
+
+        return true;
+    }
+}
+
+void addTests_FFT( UnitTestFramework & framework )
+{
+    ADD_TEST( framework, fft::ComplexDataMemoryReuse );
+    ADD_TEST( framework, fft::PlanCacheReuse );
+    ADD_TEST( framework, fft::RealFFTTwiddleReuse );
+    ADD_TEST( framework, fft::RealFFTDirectTransform );
+    ADD_TEST( framework, fft::RealFFTInverseTransform );
+    ADD_TEST( framework, fft::RealFFTInvalidSize );
+}
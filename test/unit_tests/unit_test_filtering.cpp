@@ -0,0 +1,808 @@
+#include <algorithm>
+#include <cmath>
+#include "unit_test_filtering.h"
+#include "unit_test_helper.h"
+#include "../../src/filtering.h"
+#include "../../src/function_pool.h"
+#include "../../src/image_function.h"
+#include "../../src/image_function_simd.h"
+#include "../../src/thread_pool.h"
+
+namespace
+{
+    // Median filter works with kernels up to several tens of pixels so images must be small enough for brute force verification
+    PenguinV_Image::Image randomImage( uint32_t width, uint32_t height )
+    {
+        PenguinV_Image::Image image( width, height );
+
+        uint8_t * outY = image.data();
+        const uint8_t * outYEnd = outY + image.height() * image.rowSize();
+
+        for( ; outY != outYEnd; outY += image.rowSize() ) {
+            uint8_t * outX = outY;
+            const uint8_t * outXEnd = outX + image.width();
+
+            for( ; outX != outXEnd; ++outX )
+                (*outX) = Unit_Test::randomValue<uint8_t>( 256 );
+        }
+
+        return image;
+    }
+
+    uint32_t randomKernelSize( uint32_t width, uint32_t height )
+    {
+        const uint32_t maximumSize = std::min( std::min( width, height ) - 1, 41u );
+
+        return Unit_Test::randomValue<uint32_t>( 1, (maximumSize - 1) / 2 + 1 ) * 2 + 1;
+    }
+
+    uint8_t kernelMedian( const PenguinV_Image::Image & image, uint32_t x, uint32_t y, uint32_t kernelSize )
+    {
+        std::vector < uint8_t > data;
+
+        for( uint32_t j = y; j < y + kernelSize; ++j ) {
+            for( uint32_t i = x; i < x + kernelSize; ++i )
+                data.push_back( image.data()[j * image.rowSize() + i] );
+        }
+
+        std::nth_element( data.begin(), data.begin() + data.size() / 2, data.end() );
+
+        return data[data.size() / 2];
+    }
+
+    Image_Function::BorderMode randomBorderMode()
+    {
+        return static_cast<Image_Function::BorderMode>( Unit_Test::randomValue<uint32_t>( 3 ) );
+    }
+
+    // returns -1 if a pixel outside of image is equal to 0
+    int32_t borderPosition( int32_t position, int32_t size, Image_Function::BorderMode border )
+    {
+        if( position < 0 ) {
+            if( border == Image_Function::BORDER_CONSTANT )
+                return -1;
+            return (border == Image_Function::BORDER_REPLICATE) ? 0 : -position;
+        }
+
+        if( position >= size ) {
+            if( border == Image_Function::BORDER_CONSTANT )
+                return -1;
+            return (border == Image_Function::BORDER_REPLICATE) ? size - 1 : 2 * size - 2 - position;
+        }
+
+        return position;
+    }
+
+    template <typename TData>
+    std::vector < TData > randomKernel( int32_t minimum, int32_t maximum )
+    {
+        std::vector < TData > kernel( Unit_Test::randomValue<uint32_t>( 0, 5 ) * 2 + 1 );
+
+        for( typename std::vector < TData >::iterator value = kernel.begin(); value != kernel.end(); ++value )
+            *value = static_cast<TData>( Unit_Test::randomValue<int32_t>( minimum, maximum ) );
+
+        return kernel;
+    }
+
+    std::vector < float > randomFloatKernel()
+    {
+        const std::vector < int32_t > weight = randomKernel<int32_t>( 1, 100 );
+
+        int32_t sum = 0;
+        for( std::vector < int32_t >::const_iterator value = weight.begin(); value != weight.end(); ++value )
+            sum += *value;
+
+        std::vector < float > kernel( weight.size() );
+        for( size_t i = 0; i < weight.size(); ++i )
+            kernel[i] = static_cast<float>(weight[i]) / static_cast<float>(sum);
+
+        return kernel;
+    }
+
+    // brute force convolution of a pixel with 2D kernel which is an outer product of kernelX and kernelY
+    template <typename TData, typename TSum>
+    TSum convolvePixel( const PenguinV_Image::Image & image, uint32_t x, uint32_t y, const std::vector < TData > & kernelX,
+                        const std::vector < TData > & kernelY, Image_Function::BorderMode border )
+    {
+        const int32_t radiusX = static_cast<int32_t>(kernelX.size() / 2);
+        const int32_t radiusY = static_cast<int32_t>(kernelY.size() / 2);
+
+        TSum sum = 0;
+
+        for( int32_t j = -radiusY; j <= radiusY; ++j ) {
+            const int32_t positionY = borderPosition( static_cast<int32_t>(y) + j, static_cast<int32_t>(image.height()), border );
+
+            TSum rowSum = 0;
+
+            for( int32_t i = -radiusX; i <= radiusX; ++i ) {
+                const int32_t positionX = borderPosition( static_cast<int32_t>(x) + i, static_cast<int32_t>(image.width()), border );
+
+                if( positionX >= 0 && positionY >= 0 )
+                    rowSum += static_cast<TSum>(kernelX[static_cast<size_t>(i + radiusX)]) *
+                              image.data()[static_cast<uint32_t>(positionY) * image.rowSize() + static_cast<uint32_t>(positionX)];
+            }
+
+            sum += static_cast<TSum>(kernelY[static_cast<size_t>(j + radiusY)]) * rowSum;
+        }
+
+        return sum;
+    }
+
+    uint8_t saturate( int64_t value )
+    {
+        return static_cast<uint8_t>( (value < 0) ? 0 : ((value > 255) ? 255 : value) );
+    }
+    // brute force dilation (maximum) or erosion (minimum) of image area, only pixels inside [left, right) x [top, bottom) range are used
+    PenguinV_Image::Image morphology( const PenguinV_Image::Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                                      uint32_t radiusX, uint32_t radiusY, uint32_t left, uint32_t top, uint32_t right, uint32_t bottom,
+                                      bool isMaximum )
+    {
+        PenguinV_Image::Image output( width, height );
+
+        for( uint32_t outY = 0; outY < height; ++outY ) {
+            for( uint32_t outX = 0; outX < width; ++outX ) {
+                const int32_t positionX = static_cast<int32_t>(x + outX);
+                const int32_t positionY = static_cast<int32_t>(y + outY);
+
+                const int32_t startX = std::max( positionX - static_cast<int32_t>(radiusX), static_cast<int32_t>(left) );
+                const int32_t startY = std::max( positionY - static_cast<int32_t>(radiusY), static_cast<int32_t>(top) );
+                const int32_t endX   = std::min( positionX + static_cast<int32_t>(radiusX) + 1, static_cast<int32_t>(right) );
+                const int32_t endY   = std::min( positionY + static_cast<int32_t>(radiusY) + 1, static_cast<int32_t>(bottom) );
+
+                uint8_t value = static_cast<uint8_t>( isMaximum ? 0 : 255 );
+
+                for( int32_t j = startY; j < endY; ++j ) {
+                    for( int32_t i = startX; i < endX; ++i ) {
+                        const uint8_t pixel = image.data()[static_cast<uint32_t>(j) * image.rowSize() + static_cast<uint32_t>(i)];
+                        value = isMaximum ? std::max( value, pixel ) : std::min( value, pixel );
+                    }
+                }
+
+                output.data()[outY * output.rowSize() + outX] = value;
+            }
+        }
+
+        return output;
+    }
+
+    // opening (isOpening) or closing of image area: the first operation is done over the whole image
+    PenguinV_Image::Image morphology( const PenguinV_Image::Image & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                                      uint32_t radiusX, uint32_t radiusY, bool isOpening )
+    {
+        const PenguinV_Image::Image first = morphology( image, 0, 0, image.width(), image.height(), radiusX, radiusY, 0, 0,
+                                                        image.width(), image.height(), !isOpening );
+
+        return morphology( first, x, y, width, height, radiusX, radiusY, 0, 0, image.width(), image.height(), isOpening );
+    }
+
+    PenguinV_Image::Image topHat( const PenguinV_Image::Image & image, const PenguinV_Image::Image & opening, uint32_t x, uint32_t y )
+    {
+        PenguinV_Image::Image output( opening.width(), opening.height() );
+
+        for( uint32_t outY = 0; outY < output.height(); ++outY ) {
+            for( uint32_t outX = 0; outX < output.width(); ++outX )
+                output.data()[outY * output.rowSize() + outX] = static_cast<uint8_t>( image.data()[(y + outY) * image.rowSize() + x + outX] -
+                                                                                      opening.data()[outY * opening.rowSize() + outX] );
+        }
+
+        return output;
+    }
+
+    PenguinV_Image::Image randomBinaryImage( uint32_t width, uint32_t height )
+    {
+        PenguinV_Image::Image image = randomImage( width, height );
+
+        Image_Function::Threshold( image, image, Unit_Test::randomValue<uint8_t>( 1, 255 ) );
+
+        return image;
+    }
+
+    typedef void (*MorphologyForm)( const PenguinV_Image::Image & in, uint32_t startXIn, uint32_t startYIn, PenguinV_Image::Image & out,
+                                    uint32_t startXOut, uint32_t startYOut, uint32_t width, uint32_t height, uint32_t radiusX, uint32_t radiusY );
+
+    // in-place filtering of an area must use original values of pixels around the area
+    bool verifyMorphology( MorphologyForm Filter, bool isMaximum )
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image input = randomImage( Unit_Test::randomValue<uint32_t>( 1, 128 ),
+                                                             Unit_Test::randomValue<uint32_t>( 1, 128 ) );
+
+            uint32_t roiX, roiY;
+            uint32_t roiWidth, roiHeight;
+            Unit_Test::generateRoi( input, roiX, roiY, roiWidth, roiHeight );
+
+            const uint32_t radiusX = Unit_Test::randomValue<uint32_t>( 20 );
+            const uint32_t radiusY = Unit_Test::randomValue<uint32_t>( 20 );
+
+            const PenguinV_Image::Image expected = morphology( input, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY, 0, 0,
+                                                               input.width(), input.height(), isMaximum );
+
+            PenguinV_Image::Image output( roiWidth, roiHeight );
+            Filter( input, roiX, roiY, output, 0, 0, roiWidth, roiHeight, radiusX, radiusY );
+
+            if( !Image_Function::IsEqual( output, expected ) )
+                return false;
+
+            PenguinV_Image::Image inPlace = input;
+            Filter( inPlace, roiX, roiY, inPlace, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY );
+
+            if( !Image_Function::IsEqual( inPlace, roiX, roiY, expected, 0, 0, roiWidth, roiHeight ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    typedef void (*GradientForm)( const PenguinV_Image::Image & in, uint32_t startXIn, uint32_t startYIn, PenguinV_Image::Image & magnitude,
+                                  uint32_t startXMagnitude, uint32_t startYMagnitude, PenguinV_Image::Image & direction, uint32_t startXDirection,
+                                  uint32_t startYDirection, uint32_t width, uint32_t height );
+
+    typedef PenguinV_Image::Image (*MagnitudeForm)( const PenguinV_Image::Image & in, uint32_t startXIn, uint32_t startYIn, uint32_t width,
+                                                    uint32_t height );
+
+    // weight is a weight of central row and column of kernel: 1 for Prewitt and 2 for Sobel filters
+    bool verifyGradient( GradientForm Filter, MagnitudeForm FilterMagnitude, int32_t weight )
+    {
+        const double maximumGradient = 255.0 * (weight + 2) * sqrt( 2.0 );
+        const double pi = 3.14159265358979;
+
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image input = randomImage( Unit_Test::randomValue<uint32_t>( 16, 128 ),
+                                                             Unit_Test::randomValue<uint32_t>( 16, 128 ) );
+
+            uint32_t roiX, roiY;
+            uint32_t roiWidth, roiHeight;
+            Unit_Test::generateRoi( input, roiX, roiY, roiWidth, roiHeight );
+
+            if( roiWidth < 3 || roiHeight < 3 )
+                continue;
+
+            PenguinV_Image::Image magnitude( roiWidth, roiHeight );
+            PenguinV_Image::Image direction( roiWidth, roiHeight );
+
+            Filter( input, roiX, roiY, magnitude, 0, 0, direction, 0, 0, roiWidth, roiHeight );
+
+            if( !Image_Function::IsEqual( magnitude, FilterMagnitude( input, roiX, roiY, roiWidth, roiHeight ) ) )
+                return false;
+
+            for( uint32_t y = 0; y < roiHeight; ++y ) {
+                for( uint32_t x = 0; x < roiWidth; ++x ) {
+                    const uint8_t magnitudeValue = magnitude.data()[y * magnitude.rowSize() + x];
+                    const uint8_t directionValue = direction.data()[y * direction.rowSize() + x];
+
+                    if( x == 0 || y == 0 || x == roiWidth - 1 || y == roiHeight - 1 ) {
+                        if( magnitudeValue != 0 || directionValue != 0 )
+                            return false;
+                        continue;
+                    }
+
+                    const uint8_t * in = input.data() + (roiY + y) * input.rowSize() + roiX + x;
+                    const uint32_t rowSize = input.rowSize();
+
+                    const int32_t gX = in[-static_cast<int32_t>(rowSize) + 1] + weight * in[1] + in[rowSize + 1]
+                                     - in[-static_cast<int32_t>(rowSize) - 1] - weight * in[-1] - in[rowSize - 1];
+                    const int32_t gY = in[rowSize - 1] + weight * in[rowSize] + in[rowSize + 1]
+                                     - in[-static_cast<int32_t>(rowSize) - 1] - weight * in[-static_cast<int32_t>(rowSize)] - in[-static_cast<int32_t>(rowSize) + 1];
+
+                    const int32_t expectedMagnitude = static_cast<int32_t>( sqrt( static_cast<double>(gX * gX + gY * gY) ) / maximumGradient * 255 + 0.5 );
+                    if( expectedMagnitude - magnitudeValue < -1 || expectedMagnitude - magnitudeValue > 1 )
+                        return false;
+
+                    if( gX == 0 && gY == 0 ) {
+                        if( directionValue != 0 )
+                            return false;
+                        continue;
+                    }
+
+                    // sector is not verified for angles which are very close to borders of sectors
+                    const double sector = atan2( static_cast<double>(gY), static_cast<double>(gX) ) * 4 / pi + 8.0;
+                    if( fabs( sector - floor( sector ) - 0.5 ) < 1e-3 )
+                        continue;
+
+                    if( directionValue != static_cast<uint32_t>( floor( sector + 0.5 ) ) % 8u )
+                        return false;
+                }
+            }
+        }
+
+        return true;
+    }
+}
+
+namespace filtering
+{
+    bool BinaryMorphology()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image input = randomBinaryImage( Unit_Test::randomValue<uint32_t>( 1, 128 ),
+                                                                   Unit_Test::randomValue<uint32_t>( 1, 128 ) );
+
+            uint32_t roiX, roiY;
+            uint32_t roiWidth, roiHeight;
+            Unit_Test::generateRoi( input, roiX, roiY, roiWidth, roiHeight );
+
+            const uint32_t radiusX = Unit_Test::randomValue<uint32_t>( 20 );
+            const uint32_t radiusY = Unit_Test::randomValue<uint32_t>( 20 );
+
+            // binary morphology uses only pixels of the area
+            const PenguinV_Image::Image area = Image_Function::Copy( input, roiX, roiY, roiWidth, roiHeight );
+            PenguinV_Image::Image expected;
+
+            PenguinV_Image::Image output = input;
+
+            switch( Unit_Test::randomValue<uint32_t>( 5 ) ) {
+                case 0:
+                    Image_Function::BinaryDilate( output, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY );
+                    expected = morphology( area, 0, 0, roiWidth, roiHeight, radiusX, radiusY, 0, 0, roiWidth, roiHeight, true );
+                    break;
+                case 1:
+                    Image_Function::BinaryErode( output, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY );
+                    expected = morphology( area, 0, 0, roiWidth, roiHeight, radiusX, radiusY, 0, 0, roiWidth, roiHeight, false );
+                    break;
+                case 2:
+                    Image_Function::BinaryOpening( output, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY );
+                    expected = morphology( area, 0, 0, roiWidth, roiHeight, radiusX, radiusY, true );
+                    break;
+                case 3:
+                    Image_Function::BinaryClosing( output, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY );
+                    expected = morphology( area, 0, 0, roiWidth, roiHeight, radiusX, radiusY, false );
+                    break;
+                default:
+                    Image_Function::BinaryTopHat( output, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY );
+                    expected = topHat( area, morphology( area, 0, 0, roiWidth, roiHeight, radiusX, radiusY, true ), 0, 0 );
+                    break;
+            }
+
+            // pixels outside of the area must stay untouched
+            PenguinV_Image::Image expectedImage = input;
+            Image_Function::Copy( expected, 0, 0, expectedImage, roiX, roiY, roiWidth, roiHeight );
+
+            if( !Image_Function::IsEqual( output, expectedImage ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    bool ConvolveFloat()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image input = randomImage( Unit_Test::randomValue<uint32_t>( 16, 128 ),
+                                                             Unit_Test::randomValue<uint32_t>( 16, 128 ) );
+
+            uint32_t roiX, roiY;
+            uint32_t roiWidth, roiHeight;
+            Unit_Test::generateRoi( input, roiX, roiY, roiWidth, roiHeight );
+
+            const std::vector < float > kernelX = randomFloatKernel();
+            const std::vector < float > kernelY = randomFloatKernel();
+            const Image_Function::BorderMode border = randomBorderMode();
+
+            const PenguinV_Image::Image output = Image_Function::Convolve( input, roiX, roiY, roiWidth, roiHeight, kernelX, kernelY, border );
+
+            for( uint32_t y = 0; y < roiHeight; ++y ) {
+                for( uint32_t x = 0; x < roiWidth; ++x ) {
+                    const double value = convolvePixel<float, double>( input, roiX + x, roiY + y, kernelX, kernelY, border );
+                    const int32_t difference = static_cast<int32_t>(output.data()[y * output.rowSize() + x]) -
+                                               static_cast<int32_t>(saturate( static_cast<int64_t>(value + 0.5) ));
+
+                    // rounding of float values in SIMD and non-SIMD code can be different
+                    if( difference < -1 || difference > 1 )
+                        return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    // 16-bit image contains 8-bit values multiplied by 257 and floating point image contains the same values as 8-bit image
+    bool ConvolveHighBitDepth()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image input = randomImage( Unit_Test::randomValue<uint32_t>( 16, 128 ),
+                                                             Unit_Test::randomValue<uint32_t>( 16, 128 ) );
+
+            PenguinV_Image::Image16Bit input16Bit( input.width(), input.height() );
+            PenguinV_Image::ImageFloat inputFloat( input.width(), input.height() );
+
+            for( uint32_t y = 0; y < input.height(); ++y ) {
+                for( uint32_t x = 0; x < input.width(); ++x ) {
+                    const uint8_t value = input.data()[y * input.rowSize() + x];
+
+                    input16Bit.data()[y * input16Bit.rowSize() + x] = static_cast<uint16_t>(value * 257u);
+                    inputFloat.data()[y * inputFloat.rowSize() + x] = static_cast<float>(value);
+                }
+            }
+
+            uint32_t roiX, roiY;
+            uint32_t roiWidth, roiHeight;
+            Unit_Test::generateRoi( input, roiX, roiY, roiWidth, roiHeight );
+
+            const std::vector < float > kernelX = randomFloatKernel();
+            const std::vector < float > kernelY = randomFloatKernel();
+            const Image_Function::BorderMode border = randomBorderMode();
+
+            const PenguinV_Image::Image16Bit output16Bit = Image_Function::Convolve( input16Bit, roiX, roiY, roiWidth, roiHeight, kernelX,
+                                                                                     kernelY, border );
+            const PenguinV_Image::ImageFloat outputFloat = Image_Function::Convolve( inputFloat, roiX, roiY, roiWidth, roiHeight, kernelX,
+                                                                                     kernelY, border );
+
+            for( uint32_t y = 0; y < roiHeight; ++y ) {
+                for( uint32_t x = 0; x < roiWidth; ++x ) {
+                    const double value = convolvePixel<float, double>( input, roiX + x, roiY + y, kernelX, kernelY, border );
+
+                    if( fabs( output16Bit.data()[y * output16Bit.rowSize() + x] - value * 257 ) > 1.0 ||
+                        fabs( outputFloat.data()[y * outputFloat.rowSize() + x] - value ) > 1e-3 )
+                        return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool ConvolveFixedPoint()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image input = randomImage( Unit_Test::randomValue<uint32_t>( 16, 128 ),
+                                                             Unit_Test::randomValue<uint32_t>( 16, 128 ) );
+
+            uint32_t roiX, roiY;
+            uint32_t roiWidth, roiHeight;
+            Unit_Test::generateRoi( input, roiX, roiY, roiWidth, roiHeight );
+
+            // sum of absolute values of 9 coefficients is not bigger than 128
+            const std::vector < int16_t > kernelX = randomKernel<int16_t>( -6, 15 );
+            const std::vector < int16_t > kernelY = randomKernel<int16_t>( -100, 200 );
+            const uint8_t shift = Unit_Test::randomValue<uint8_t>( 13 );
+            const Image_Function::BorderMode border = randomBorderMode();
+
+            const PenguinV_Image::Image output = Image_Function::Convolve( input, roiX, roiY, roiWidth, roiHeight, kernelX, kernelY, shift,
+                                                                           border );
+
+            const int64_t rounding = (shift > 0) ? (1 << (shift - 1)) : 0;
+
+            for( uint32_t y = 0; y < roiHeight; ++y ) {
+                for( uint32_t x = 0; x < roiWidth; ++x ) {
+                    const int64_t value = convolvePixel<int16_t, int64_t>( input, roiX + x, roiY + y, kernelX, kernelY, border );
+
+                    if( output.data()[y * output.rowSize() + x] != saturate( (value + rounding) >> shift ) )
+                        return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool ConvolveFunctionPool()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            Thread_Pool::ThreadPoolMonoid::instance().resize( Unit_Test::randomValue<uint8_t>( 1, 8 ) );
+
+            const PenguinV_Image::Image input = randomImage( Unit_Test::randomValue<uint32_t>( 16, 256 ),
+                                                             Unit_Test::randomValue<uint32_t>( 16, 256 ) );
+
+            uint32_t roiX, roiY;
+            uint32_t roiWidth, roiHeight;
+            Unit_Test::generateRoi( input, roiX, roiY, roiWidth, roiHeight );
+
+            const Image_Function::BorderMode border = randomBorderMode();
+
+            const std::vector < float > kernelX = randomFloatKernel();
+            const std::vector < float > kernelY = randomFloatKernel();
+
+            if( !Image_Function::IsEqual( Image_Function::Convolve( input, roiX, roiY, roiWidth, roiHeight, kernelX, kernelY, border ),
+                                          Function_Pool::Convolve( input, roiX, roiY, roiWidth, roiHeight, kernelX, kernelY, border ) ) )
+                return false;
+
+            const std::vector < int16_t > kernelXInt = randomKernel<int16_t>( -6, 15 );
+            const std::vector < int16_t > kernelYInt = randomKernel<int16_t>( -100, 200 );
+            const uint8_t shift = Unit_Test::randomValue<uint8_t>( 13 );
+
+            if( !Image_Function::IsEqual( Image_Function::Convolve( input, roiX, roiY, roiWidth, roiHeight, kernelXInt, kernelYInt, shift, border ),
+                                          Function_Pool::Convolve( input, roiX, roiY, roiWidth, roiHeight, kernelXInt, kernelYInt, shift, border ) ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    bool Dilate()
+    {
+        return verifyMorphology( Image_Function::Dilate, true );
+    }
+
+    bool Erode()
+    {
+        return verifyMorphology( Image_Function::Erode, false );
+    }
+
+    bool GaussianBlur()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image input = randomImage( Unit_Test::randomValue<uint32_t>( 16, 128 ),
+                                                             Unit_Test::randomValue<uint32_t>( 16, 128 ) );
+
+            const uint32_t kernelSize = Unit_Test::randomValue<uint32_t>( 1, 6 );
+            const float sigma = static_cast<float>( Unit_Test::randomValue<uint32_t>( 1, 50 ) ) / 10.0f;
+            const uint32_t kernelWidth = 2 * kernelSize + 1;
+
+            const PenguinV_Image::Image output = Image_Function::GaussianBlur( input, kernelSize, sigma, Image_Function::BORDER_CONSTANT );
+
+            // 2D kernel must give the same result as separable convolution
+            std::vector < float > kernel;
+            Image_Function::GetGaussianKernel( kernel, kernelWidth, kernelWidth, kernelSize, sigma );
+
+            for( uint32_t y = 0; y < input.height(); ++y ) {
+                for( uint32_t x = 0; x < input.width(); ++x ) {
+                    double value = 0;
+
+                    for( uint32_t j = 0; j < kernelWidth; ++j ) {
+                        for( uint32_t k = 0; k < kernelWidth; ++k ) {
+                            const uint32_t positionX = x + k - kernelSize;
+                            const uint32_t positionY = y + j - kernelSize;
+
+                            if( positionX < input.width() && positionY < input.height() )
+                                value += kernel[j * kernelWidth + k] * input.data()[positionY * input.rowSize() + positionX];
+                        }
+                    }
+
+                    const int32_t difference = static_cast<int32_t>(output.data()[y * output.rowSize() + x]) -
+                                               static_cast<int32_t>(saturate( static_cast<int64_t>(value + 0.5) ));
+
+                    if( difference < -1 || difference > 1 )
+                        return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool GradientFunctionPool()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            Thread_Pool::ThreadPoolMonoid::instance().resize( Unit_Test::randomValue<uint8_t>( 1, 8 ) );
+
+            const PenguinV_Image::Image input = randomImage( Unit_Test::randomValue<uint32_t>( 16, 256 ),
+                                                             Unit_Test::randomValue<uint32_t>( 16, 256 ) );
+
+            uint32_t roiX, roiY;
+            uint32_t roiWidth, roiHeight;
+            Unit_Test::generateRoi( input, roiX, roiY, roiWidth, roiHeight );
+
+            if( roiWidth < 3 || roiHeight < 3 )
+                continue;
+
+            PenguinV_Image::Image magnitude( roiWidth, roiHeight );
+            PenguinV_Image::Image direction( roiWidth, roiHeight );
+            PenguinV_Image::Image magnitudePool( roiWidth, roiHeight );
+            PenguinV_Image::Image directionPool( roiWidth, roiHeight );
+
+            if( Unit_Test::randomValue<uint32_t>( 2 ) == 0 ) {
+                Image_Function::Sobel( input, roiX, roiY, magnitude, 0, 0, direction, 0, 0, roiWidth, roiHeight );
+                Function_Pool::Sobel( input, roiX, roiY, magnitudePool, 0, 0, directionPool, 0, 0, roiWidth, roiHeight );
+            }
+            else {
+                Image_Function::Prewitt( input, roiX, roiY, magnitude, 0, 0, direction, 0, 0, roiWidth, roiHeight );
+                Function_Pool::Prewitt( input, roiX, roiY, magnitudePool, 0, 0, directionPool, 0, 0, roiWidth, roiHeight );
+            }
+
+            if( !Image_Function::IsEqual( magnitude, magnitudePool ) || !Image_Function::IsEqual( direction, directionPool ) )
+                return false;
+
+            if( !Image_Function::IsEqual( Image_Function::Sobel( input ), Function_Pool::Sobel( input ) ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    bool Median()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image input = randomImage( Unit_Test::randomValue<uint32_t>( 48, 128 ),
+                                                             Unit_Test::randomValue<uint32_t>( 48, 128 ) );
+
+            uint32_t roiX, roiY;
+            uint32_t roiWidth, roiHeight;
+            Unit_Test::generateRoi( input, roiX, roiY, roiWidth, roiHeight );
+
+            if( roiWidth < 4 || roiHeight < 4 )
+                continue;
+
+            const uint32_t kernelSize = randomKernelSize( roiWidth, roiHeight );
+            const uint32_t border = kernelSize / 2;
+
+            const PenguinV_Image::Image output = Image_Function::Median( input, roiX, roiY, roiWidth, roiHeight, kernelSize );
+
+            for( uint32_t y = 0; y < roiHeight; ++y ) {
+                for( uint32_t x = 0; x < roiWidth; ++x ) {
+                    const bool isBorder = (x < border) || (y < border) || (x >= roiWidth - border) || (y >= roiHeight - border);
+
+                    const uint8_t expected = isBorder ? input.data()[(roiY + y) * input.rowSize() + roiX + x] :
+                                                        kernelMedian( input, roiX + x - border, roiY + y - border, kernelSize );
+
+                    if( output.data()[y * output.rowSize() + x] != expected )
+                        return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool MedianFunctionPool()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            Thread_Pool::ThreadPoolMonoid::instance().resize( Unit_Test::randomValue<uint8_t>( 1, 8 ) );
+
+            const PenguinV_Image::Image input = randomImage( Unit_Test::randomValue<uint32_t>( 48, 256 ),
+                                                             Unit_Test::randomValue<uint32_t>( 48, 256 ) );
+
+            const uint32_t kernelSize = randomKernelSize( input.width(), input.height() );
+
+            if( !Image_Function::IsEqual( Image_Function::Median( input, kernelSize ), Function_Pool::Median( input, kernelSize ) ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    bool MorphologyFunctionPool()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            Thread_Pool::ThreadPoolMonoid::instance().resize( Unit_Test::randomValue<uint8_t>( 1, 8 ) );
+
+            const PenguinV_Image::Image input = randomImage( Unit_Test::randomValue<uint32_t>( 1, 256 ),
+                                                             Unit_Test::randomValue<uint32_t>( 1, 256 ) );
+
+            uint32_t roiX, roiY;
+            uint32_t roiWidth, roiHeight;
+            Unit_Test::generateRoi( input, roiX, roiY, roiWidth, roiHeight );
+
+            const uint32_t radiusX = Unit_Test::randomValue<uint32_t>( 20 );
+            const uint32_t radiusY = Unit_Test::randomValue<uint32_t>( 20 );
+
+            if( !Image_Function::IsEqual( Image_Function::Dilate( input, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY ),
+                                          Function_Pool::Dilate( input, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY ) ) ||
+                !Image_Function::IsEqual( Image_Function::Erode( input, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY ),
+                                          Function_Pool::Erode( input, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY ) ) ||
+                !Image_Function::IsEqual( Image_Function::Opening( input, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY ),
+                                          Function_Pool::Opening( input, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY ) ) ||
+                !Image_Function::IsEqual( Image_Function::Closing( input, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY ),
+                                          Function_Pool::Closing( input, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY ) ) ||
+                !Image_Function::IsEqual( Image_Function::TopHat( input, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY ),
+                                          Function_Pool::TopHat( input, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY ) ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    bool MorphologySimd()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image input = randomImage( Unit_Test::randomValue<uint32_t>( 1, 256 ),
+                                                             Unit_Test::randomValue<uint32_t>( 1, 256 ) );
+
+            uint32_t roiX, roiY;
+            uint32_t roiWidth, roiHeight;
+            Unit_Test::generateRoi( input, roiX, roiY, roiWidth, roiHeight );
+
+            const uint32_t radiusX = Unit_Test::randomValue<uint32_t>( 20 );
+            const uint32_t radiusY = Unit_Test::randomValue<uint32_t>( 20 );
+
+            for( uint32_t simdType = 0; simdType < 4; ++simdType ) {
+                Image_Function_Simd::Simd_Activation::EnableSimd( false );
+                if( simdType == 0 )
+                    Image_Function_Simd::Simd_Activation::EnableAvx512( true );
+                else if( simdType == 1 )
+                    Image_Function_Simd::Simd_Activation::EnableAvx( true );
+                else if( simdType == 2 )
+                    Image_Function_Simd::Simd_Activation::EnableSse( true );
+                else
+                    Image_Function_Simd::Simd_Activation::EnableNeon( true );
+
+                const bool equal =
+                    Image_Function::IsEqual( Image_Function::Dilate( input, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY ),
+                                             Image_Function_Simd::Dilate( input, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY ) ) &&
+                    Image_Function::IsEqual( Image_Function::Erode( input, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY ),
+                                             Image_Function_Simd::Erode( input, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY ) ) &&
+                    Image_Function::IsEqual( Image_Function::Opening( input, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY ),
+                                             Image_Function_Simd::Opening( input, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY ) ) &&
+                    Image_Function::IsEqual( Image_Function::Closing( input, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY ),
+                                             Image_Function_Simd::Closing( input, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY ) ) &&
+                    Image_Function::IsEqual( Image_Function::TopHat( input, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY ),
+                                             Image_Function_Simd::TopHat( input, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY ) );
+
+                Image_Function_Simd::Simd_Activation::EnableSimd( true );
+
+                if( !equal )
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool OpeningClosing()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image input = randomImage( Unit_Test::randomValue<uint32_t>( 1, 128 ),
+                                                             Unit_Test::randomValue<uint32_t>( 1, 128 ) );
+
+            uint32_t roiX, roiY;
+            uint32_t roiWidth, roiHeight;
+            Unit_Test::generateRoi( input, roiX, roiY, roiWidth, roiHeight );
+
+            const uint32_t radiusX = Unit_Test::randomValue<uint32_t>( 20 );
+            const uint32_t radiusY = Unit_Test::randomValue<uint32_t>( 20 );
+
+            const PenguinV_Image::Image opening = morphology( input, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY, true );
+            const PenguinV_Image::Image closing = morphology( input, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY, false );
+
+            if( !Image_Function::IsEqual( Image_Function::Opening( input, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY ), opening ) ||
+                !Image_Function::IsEqual( Image_Function::Closing( input, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY ), closing ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    bool Prewitt()
+    {
+        return verifyGradient( Image_Function::Prewitt, Image_Function::Prewitt, 1 );
+    }
+
+    bool Sobel()
+    {
+        return verifyGradient( Image_Function::Sobel, Image_Function::Sobel, 2 );
+    }
+
+    bool TopHat()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image input = randomImage( Unit_Test::randomValue<uint32_t>( 1, 128 ),
+                                                             Unit_Test::randomValue<uint32_t>( 1, 128 ) );
+
+            uint32_t roiX, roiY;
+            uint32_t roiWidth, roiHeight;
+            Unit_Test::generateRoi( input, roiX, roiY, roiWidth, roiHeight );
+
+            const uint32_t radiusX = Unit_Test::randomValue<uint32_t>( 20 );
+            const uint32_t radiusY = Unit_Test::randomValue<uint32_t>( 20 );
+
+            const PenguinV_Image::Image expected = topHat( input, morphology( input, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY, true ),
+                                                           roiX, roiY );
+
+            if( !Image_Function::IsEqual( Image_Function::TopHat( input, roiX, roiY, roiWidth, roiHeight, radiusX, radiusY ), expected ) )
+                return false;
+        }
+
+        return true;
+    }
+}
+
+void addTests_Filtering( UnitTestFramework & framework )
+{
+    framework.add( filtering::BinaryMorphology,       "filtering::BinaryDilate, BinaryErode, BinaryOpening, BinaryClosing and BinaryTopHat" );
+    framework.add( filtering::ConvolveFloat,          "filtering::Convolve (float kernel)" );
+    framework.add( filtering::ConvolveFixedPoint,     "filtering::Convolve (fixed-point kernel)" );
+    framework.add( filtering::ConvolveFunctionPool,   "filtering::Convolve (function pool)" );
+    framework.add( filtering::ConvolveHighBitDepth,   "filtering::Convolve (16-bit and float images)" );
+    framework.add( filtering::Dilate,                 "filtering::Dilate" );
+    framework.add( filtering::Erode,                  "filtering::Erode" );
+    framework.add( filtering::GaussianBlur,           "filtering::GaussianBlur" );
+    framework.add( filtering::GradientFunctionPool,   "filtering::Sobel and Prewitt (function pool)" );
+    framework.add( filtering::Median,                 "filtering::Median" );
+    framework.add( filtering::MedianFunctionPool,     "filtering::Median (function pool)" );
+    framework.add( filtering::MorphologyFunctionPool, "filtering::Dilate, Erode, Opening, Closing and TopHat (function pool)" );
+    framework.add( filtering::MorphologySimd,         "filtering::Dilate, Erode, Opening, Closing and TopHat (SIMD)" );
+    framework.add( filtering::OpeningClosing,         "filtering::Opening and Closing" );
+    framework.add( filtering::Prewitt,                "filtering::Prewitt" );
+    framework.add( filtering::Sobel,                  "filtering::Sobel" );
+    framework.add( filtering::TopHat,                 "filtering::TopHat" );
+}
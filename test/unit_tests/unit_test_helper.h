@@ -49,6 +49,10 @@ namespace Unit_Test
     template <typename data>
     bool equalData( const PenguinV_Image::ImageTemplate < data > & image1, const PenguinV_Image::ImageTemplate < data > & image2 )
     {
+        // memcmp() must not get null pointers even for zero size
+        if( image1.empty() || image2.empty() )
+            return image1.empty() && image2.empty();
+
         return memcmp( image1.data(), image2.data(), sizeof( data ) * image1.height() * image1.rowSize() ) == 0;
     }
 
@@ -1,6 +1,12 @@
+#include <algorithm>
+#include <limits>
+#include <thread>
 #include "unit_test_helper.h"
 #include "unit_test_image_buffer.h"
+#include "../../src/image_buffer_pool.h"
 #include "../../src/image_function.h"
+#include "../../src/image_function_simd.h"
+#include "../../src/image_view.h"
 
 namespace template_image
 {
@@ -45,6 +51,57 @@ namespace template_image
         return false;
     }
 
+    bool AssignNewArray()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const uint32_t width      = Unit_Test::randomValue<uint32_t>( 1, 2048 );
+            const uint32_t height     = Unit_Test::randomValue<uint32_t>( 1, 2048 );
+            const uint8_t  colorCount = Unit_Test::randomValue<uint8_t >( 1, 4 );
+
+            // memory allocated by new[] has no alignment offset in front of it
+            uint8_t * data = new uint8_t[width * height * colorCount];
+
+            PenguinV_Image::Image image;
+            image.assign( data, width, height, colorCount, 1u );
+
+            if( image.data() != data || image.rowSize() != width * colorCount )
+                return false;
+
+            // the image must release memory by delete[] when it is destroyed, moved or reassigned
+            PenguinV_Image::Image moved( std::move( image ) );
+
+            if( moved.data() != data || !image.empty() )
+                return false;
+
+            moved.assign( new uint8_t[width * height * colorCount], width, height, colorCount, 1u );
+        }
+
+        return true;
+    }
+
+    bool MemoryAlignment()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const uint32_t width      = Unit_Test::randomValue<uint32_t>( 1, 2048 );
+            const uint32_t height     = Unit_Test::randomValue<uint32_t>( 1, 2048 );
+            const uint8_t  colorCount = Unit_Test::randomValue<uint8_t >( 1, 4 );
+            const uint8_t  alignment  = (i % 2 == 0) ? PenguinV_Image::SIMD_ALIGNMENT : PenguinV_Image::CACHE_LINE_ALIGNMENT;
+
+            const PenguinV_Image::ImageTemplate < uint8_t > image( width, height, colorCount, alignment );
+
+            if( reinterpret_cast<size_t>( image.data() ) % PenguinV_Image::CACHE_LINE_ALIGNMENT != 0 || image.rowSize() % alignment != 0 ||
+                image.rowSize() < width * colorCount || image.rowSize() >= width * colorCount + alignment )
+                return false;
+
+            const PenguinV_Image::ImageTemplate < double > imageDouble( width, height, colorCount, alignment );
+
+            if( reinterpret_cast<size_t>( imageDouble.data() ) % PenguinV_Image::CACHE_LINE_ALIGNMENT != 0 )
+                return false;
+        }
+
+        return true;
+    }
+
     template <typename _Type>
     bool _CopyConstructor()
     {
@@ -64,6 +121,73 @@ namespace template_image
         return true;
     }
 
+    // pixels within the area must be equal to value and pixels outside the area must be equal to background
+    template <typename _Type>
+    bool _verifyArea( const PenguinV_Image::ImageTemplate < _Type > & image, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                      _Type value, _Type background )
+    {
+        const uint8_t colorCount = image.colorCount();
+
+        for( uint32_t rowId = 0; rowId < image.height(); ++rowId ) {
+            const _Type * pixel = image.data() + rowId * image.rowSize();
+
+            for( uint32_t columnId = 0; columnId < image.width() * colorCount; ++columnId ) {
+                const bool inside = rowId >= y && rowId < y + height && columnId >= x * colorCount && columnId < (x + width) * colorCount;
+
+                if( pixel[columnId] != (inside ? value : background) )
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    template <typename _Type>
+    bool _Fill()
+    {
+        const uint32_t maxValue = static_cast<uint32_t>( std::min<double>( std::numeric_limits<_Type>::max(), 30000 ) );
+
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const uint32_t width      = Unit_Test::randomValue<uint32_t>( 1, 1024 );
+            const uint32_t height     = Unit_Test::randomValue<uint32_t>( 1, 1024 );
+            const uint8_t  colorCount = Unit_Test::randomValue<uint8_t >( 1, 4 );
+            const uint8_t  alignment  = Unit_Test::randomValue<uint8_t >( 1, 32 );
+
+            // values of non-integer types have a fractional part so every byte of a pixel matters
+            const _Type fraction  = std::numeric_limits<_Type>::is_integer ? static_cast<_Type>( 0 ) : static_cast<_Type>( 0.5 );
+            const _Type value     = static_cast<_Type>( static_cast<_Type>( Unit_Test::randomValue<uint32_t>( 1, maxValue ) ) + fraction );
+            const _Type viewValue = static_cast<_Type>( value - 1 );
+
+            PenguinV_Image::ImageTemplate < _Type > image( width, height, colorCount, alignment );
+            image.fill( value );
+
+            if( !_verifyArea( image, 0, 0, width, height, value, value ) )
+                return false;
+
+            const uint32_t roiX      = Unit_Test::randomValue<uint32_t>( width );
+            const uint32_t roiY      = Unit_Test::randomValue<uint32_t>( height );
+            const uint32_t roiWidth  = Unit_Test::randomValue<uint32_t>( 1, width - roiX + 1 );
+            const uint32_t roiHeight = Unit_Test::randomValue<uint32_t>( 1, height - roiY + 1 );
+
+            {
+                PenguinV_Image::ImageViewTemplate < _Type > view( image, roiX, roiY, roiWidth, roiHeight );
+                view.fill( viewValue );
+            }
+
+            // a view fills its rows only
+            if( !_verifyArea( image, roiX, roiY, roiWidth, roiHeight, viewValue, value ) )
+                return false;
+
+            PenguinV_Image::ImageTemplatePool < _Type > poolImage( width, height, colorCount, alignment );
+            poolImage.fill( value );
+
+            if( !_verifyArea( poolImage, 0, 0, width, height, value, value ) )
+                return false;
+        }
+
+        return true;
+    }
+
     template <typename _Type>
     bool _AssignmentOperator()
     {
@@ -86,6 +210,323 @@ namespace template_image
     }
 }
 
+namespace image_view
+{
+    bool SharedMemory()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const std::vector < uint8_t > intensity = Unit_Test::intensityArray( 2 );
+            PenguinV_Image::Image image = Unit_Test::uniformImage( intensity[0] );
+
+            uint32_t roiX, roiY, roiWidth, roiHeight;
+            Unit_Test::generateRoi( image, roiX, roiY, roiWidth, roiHeight );
+
+            {
+                PenguinV_Image::ImageView view( image, roiX, roiY, roiWidth, roiHeight );
+
+                if( !view.isView() || view.rowSize() != image.rowSize() || view.data() != image.data() + roiY * image.rowSize() + roiX )
+                    return false;
+
+                view.fill( intensity[1] );
+            }
+
+            // destruction of the view must not affect the image
+            if( !Unit_Test::verifyImage( image, roiX, roiY, roiWidth, roiHeight, intensity[1] ) )
+                return false;
+
+            PenguinV_Image::Image expected( image.width(), image.height() );
+            expected.fill( intensity[0] );
+            Unit_Test::fillImage( expected, roiX, roiY, roiWidth, roiHeight, intensity[1] );
+
+            if( !Unit_Test::equalData( image, expected ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    bool CopyOwnsData()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const uint8_t intensity = Unit_Test::intensityValue();
+            PenguinV_Image::Image image = Unit_Test::uniformImage( intensity );
+
+            uint32_t roiX, roiY, roiWidth, roiHeight;
+            Unit_Test::generateRoi( image, roiX, roiY, roiWidth, roiHeight );
+
+            const PenguinV_Image::ImageView view( image, roiX, roiY, roiWidth, roiHeight );
+            const PenguinV_Image::ImageView viewCopy( view );
+            const PenguinV_Image::Image copy( view );
+
+            if( !viewCopy.isView() || viewCopy.data() != view.data() || copy.isView() || copy.data() == view.data() ||
+                !Unit_Test::equalSize( copy, roiWidth, roiHeight ) || copy.rowSize() != roiWidth || !Unit_Test::verifyImage( copy, intensity ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    bool ImageFunctionArguments()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const std::vector < uint8_t > intensity = Unit_Test::intensityArray( 3 );
+            const std::vector < PenguinV_Image::Image > input = Unit_Test::uniformImages( intensity );
+            PenguinV_Image::Image output = input[2];
+
+            std::vector < uint32_t > roiX, roiY;
+            uint32_t roiWidth, roiHeight;
+            Unit_Test::generateRoi( input, roiX, roiY, roiWidth, roiHeight );
+
+            const PenguinV_Image::ConstImageView in1( input[0], roiX[0], roiY[0], roiWidth, roiHeight );
+            const PenguinV_Image::ConstImageView in2( input[1], roiX[1], roiY[1], roiWidth, roiHeight );
+            PenguinV_Image::ImageView out( output, roiX[2], roiY[2], roiWidth, roiHeight );
+
+            Image_Function::Maximum( in1, in2, out );
+
+            if( !Unit_Test::verifyImage( output, roiX[2], roiY[2], roiWidth, roiHeight, std::max( intensity[0], intensity[1] ) ) )
+                return false;
+
+            Image_Function_Simd::Minimum( in1, in2, out );
+
+            if( !Unit_Test::verifyImage( output, roiX[2], roiY[2], roiWidth, roiHeight, std::min( intensity[0], intensity[1] ) ) )
+                return false;
+
+            // output image generated from a view is an ordinary image
+            const PenguinV_Image::Image inverted = Image_Function::Invert( in1 );
+
+            if( inverted.isView() || !Unit_Test::equalSize( inverted, roiWidth, roiHeight ) ||
+                !Unit_Test::verifyImage( inverted, static_cast<uint8_t>( ~intensity[0] ) ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    bool InvalidArea()
+    {
+        PenguinV_Image::Image image = Unit_Test::uniformImage();
+
+        try {
+            PenguinV_Image::ImageView view( image, Unit_Test::randomValue<uint32_t>( image.width() ), 0, image.width() + 1, image.height() );
+        }
+        catch( imageException & ) {
+            return true;
+        }
+
+        return false;
+    }
+}
+
+namespace pool_image
+{
+    bool MemoryAllocatorReuse()
+    {
+        Cpu_Memory::MemoryAllocator allocator;
+        allocator.reserve( 1024 * 1024 );
+
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const size_t size = Unit_Test::randomValue<size_t>( 4096, 256 * 1024 );
+
+            uint8_t * first = allocator.allocate( size );
+            uint8_t * second = allocator.allocate( size );
+
+            // chunks must not overlap
+            memset( first, 1, size );
+            memset( second, 2, size );
+
+            if( first[size - 1] != 1 || second[0] != 2 || allocator.allocatedCount() != 2 )
+                return false;
+
+            allocator.free( second );
+
+            // the same chunk must be taken from the cache
+            if( allocator.allocate( size ) != second )
+                return false;
+
+            allocator.free( first );
+            allocator.free( second );
+
+            if( allocator.allocatedCount() != 0 )
+                return false;
+        }
+
+        return true;
+    }
+
+    bool MemoryAllocatorModes()
+    {
+        const Cpu_Memory::MemoryAllocator::FreeListMode mode[2] = { Cpu_Memory::MemoryAllocator::SET_FREE_LIST,
+                                                                    Cpu_Memory::MemoryAllocator::INTRUSIVE_FREE_LIST };
+
+        for( uint32_t modeId = 0; modeId < 2; ++modeId ) {
+            Cpu_Memory::MemoryAllocator allocator( std::numeric_limits<size_t>::max(), mode[modeId] );
+            allocator.reserve( 1024 * 1024 + 4096 * Unit_Test::randomValue<size_t>( 256 ) );
+
+            for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+                std::vector < std::pair < uint8_t *, size_t > > chunk;
+
+                // fill preallocated memory by chunks of random sizes until a chunk is allocated in the heap
+                while( true ) {
+                    const size_t size = Unit_Test::randomValue<size_t>( 4096, 65536 );
+                    uint8_t * data = allocator.allocate( size );
+
+                    if( allocator.allocatedCount() == chunk.size() ) {
+                        allocator.free( data );
+                        break;
+                    }
+
+                    memset( data, static_cast<int>( chunk.size() % 256 ), size );
+                    chunk.push_back( std::make_pair( data, size ) );
+                }
+
+                for( size_t id = 0; id < chunk.size(); ++id ) {
+                    const uint8_t value = static_cast<uint8_t>( id % 256 );
+
+                    if( chunk[id].first[0] != value || chunk[id].first[chunk[id].second - 1] != value )
+                        return false;
+                }
+
+                std::random_shuffle( chunk.begin(), chunk.end() );
+
+                for( size_t id = 0; id < chunk.size(); ++id )
+                    allocator.free( chunk[id].first );
+
+                if( allocator.allocatedCount() != 0 )
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool MemoryAllocatorBaseReserve()
+    {
+        const Cpu_Memory::MemoryAllocator::FreeListMode mode[2] = { Cpu_Memory::MemoryAllocator::SET_FREE_LIST,
+                                                                    Cpu_Memory::MemoryAllocator::INTRUSIVE_FREE_LIST };
+
+        for( uint32_t modeId = 0; modeId < 2; ++modeId ) {
+            Cpu_Memory::MemoryAllocator allocator( std::numeric_limits<size_t>::max(), mode[modeId] );
+
+            // free memory structures of the mode must be built even if memory is reserved through the base class
+            BaseMemoryAllocator & base = allocator;
+            base.reserve( 1024 * 1024 );
+
+            uint8_t * data = allocator.allocate( Unit_Test::randomValue<size_t>( 4096, 1024 * 1024 ) );
+
+            if( allocator.allocatedCount() != 1 )
+                return false;
+
+            allocator.free( data );
+        }
+
+        return true;
+    }
+
+    bool MemoryAllocatorCacheMerge()
+    {
+        const size_t memorySize = 1024 * 1024;
+
+        Cpu_Memory::MemoryAllocator allocator;
+        allocator.reserve( memorySize );
+
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const size_t size = static_cast<size_t>(4096) << Unit_Test::randomValue<uint32_t>( 8 );
+
+            std::vector < uint8_t * > chunk;
+
+            for( size_t id = 0; id < memorySize / size; ++id )
+                chunk.push_back( allocator.allocate( size ) );
+
+            if( allocator.allocatedCount() != chunk.size() )
+                return false;
+
+            for( size_t id = 0; id < chunk.size(); ++id )
+                allocator.free( chunk[id] );
+
+            // some of freed chunks are kept in a cache of this thread but they must be merged to give the whole memory
+            uint8_t * data = allocator.allocate( memorySize );
+
+            if( allocator.allocatedCount() != 1 )
+                return false;
+
+            allocator.free( data );
+
+            data = allocator.allocate( memorySize / 2 );
+
+            if( allocator.allocatedCount() != 1 )
+                return false;
+
+            allocator.free( data );
+        }
+
+        return true;
+    }
+
+    bool MemoryAllocatorThreads()
+    {
+        Cpu_Memory::MemoryAllocator allocator;
+        allocator.reserve( 4 * 1024 * 1024 );
+
+        std::vector < std::thread > thread;
+        std::vector < uint8_t > result( 4, 1 );
+
+        for( uint8_t threadId = 0; threadId < 4; ++threadId ) {
+            thread.push_back( std::thread( [&allocator, &result, threadId]() {
+                for( uint32_t i = 0; i < 256; ++i ) {
+                    const size_t size = 4096u << (i % 6);
+                    uint8_t * data = allocator.allocate( size );
+
+                    memset( data, threadId, size );
+                    std::this_thread::yield();
+
+                    for( size_t x = 0; x < size; x += 512 ) {
+                        if( data[x] != threadId )
+                            result[threadId] = 0;
+                    }
+
+                    allocator.free( data );
+                }
+            } ) );
+        }
+
+        for( std::vector < std::thread >::iterator t = thread.begin(); t != thread.end(); ++t )
+            t->join();
+
+        return allocator.allocatedCount() == 0 && std::find( result.begin(), result.end(), 0 ) == result.end();
+    }
+
+    bool ImageFunctionOutput()
+    {
+        Cpu_Memory::MemoryManager::memory().reserve( 16 * 1024 * 1024 );
+
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const uint32_t width  = Unit_Test::randomValue<uint32_t>( 64, 1024 );
+            const uint32_t height = Unit_Test::randomValue<uint32_t>( 64, 1024 );
+            const uint8_t value[2] = { Unit_Test::randomValue<uint8_t>( 256 ), Unit_Test::randomValue<uint8_t>( 256 ) };
+
+            PenguinV_Image::ImagePool image[2] = { PenguinV_Image::ImagePool( width, height ), PenguinV_Image::ImagePool( width, height ) };
+            image[0].fill( value[0] );
+            image[1].fill( value[1] );
+
+            const size_t allocatedCount = Cpu_Memory::MemoryManager::memory().allocatedCount();
+
+            // output image has the same type as input images so its memory is taken from the allocator
+            const PenguinV_Image::Image output = Image_Function::Maximum( image[0], image[1] );
+
+            if( output.type() != image[0].type() || Cpu_Memory::MemoryManager::memory().allocatedCount() != allocatedCount + 1 ||
+                !Unit_Test::verifyImage( output, std::max( value[0], value[1] ) ) )
+                return false;
+
+            const PenguinV_Image::ImagePool copy( image[0] );
+
+            if( !Unit_Test::equalSize( copy, image[0] ) || !Unit_Test::verifyImage( copy, value[0] ) )
+                return false;
+        }
+
+        return true;
+    }
+}
+
 #define ADD_TEMPLATE_FUNCTION( function, type )                                                                     \
     framework.add( template_image::_##function < type >, std::string("template_image::") + std::string(#function) + \
                    std::string(" (") + std::string(#type) + std::string(")") );
@@ -95,6 +536,8 @@ void addTests_Image_Buffer( UnitTestFramework & framework )
     ADD_TEST( framework, template_image::EmptyConstructor );
     ADD_TEST( framework, template_image::Constructor );
     ADD_TEST( framework, template_image::NullAssignment );
+    ADD_TEST( framework, template_image::AssignNewArray );
+    ADD_TEST( framework, template_image::MemoryAlignment );
 
     ADD_TEMPLATE_FUNCTION( CopyConstructor, uint8_t );
     ADD_TEMPLATE_FUNCTION( CopyConstructor, uint16_t );
@@ -117,4 +560,22 @@ void addTests_Image_Buffer( UnitTestFramework & framework )
     ADD_TEMPLATE_FUNCTION( AssignmentOperator, int64_t );
     ADD_TEMPLATE_FUNCTION( AssignmentOperator, float );
     ADD_TEMPLATE_FUNCTION( AssignmentOperator, double );
+
+    ADD_TEMPLATE_FUNCTION( Fill, uint8_t );
+    ADD_TEMPLATE_FUNCTION( Fill, uint16_t );
+    ADD_TEMPLATE_FUNCTION( Fill, int32_t );
+    ADD_TEMPLATE_FUNCTION( Fill, float );
+    ADD_TEMPLATE_FUNCTION( Fill, double );
+
+    ADD_TEST( framework, image_view::SharedMemory );
+    ADD_TEST( framework, image_view::CopyOwnsData );
+    ADD_TEST( framework, image_view::ImageFunctionArguments );
+    ADD_TEST( framework, image_view::InvalidArea );
+
+    ADD_TEST( framework, pool_image::MemoryAllocatorReuse );
+    ADD_TEST( framework, pool_image::MemoryAllocatorModes );
+    ADD_TEST( framework, pool_image::MemoryAllocatorBaseReserve );
+    ADD_TEST( framework, pool_image::MemoryAllocatorCacheMerge );
+    ADD_TEST( framework, pool_image::MemoryAllocatorThreads );
+    ADD_TEST( framework, pool_image::ImageFunctionOutput );
 }
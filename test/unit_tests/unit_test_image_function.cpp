@@ -1,10 +1,13 @@
+#include <algorithm>
 #include <math.h>
 #include <numeric>
+#include <stdio.h>
 #include "../../src/function_pool.h"
 #include "../../src/image_function.h"
 #include "../../src/image_function_simd.h"
 #include "../../src/thread_pool.h"
 #include "../../src/penguinv/cpu_identification.h"
+#include "../../src/penguinv/penguinv.h"
 #include "unit_test_image_function.h"
 #include "unit_test_helper.h"
 
@@ -16,6 +19,10 @@ namespace
             Image_Function_Simd::Simd_Activation::EnableSimd( true );
             Thread_Pool::ThreadPoolMonoid::instance().resize( Unit_Test::randomValue<uint8_t>( 1, 8 ) );
         }
+        else if ( namespaceName == "image_function_avx512" ) {
+            Image_Function_Simd::Simd_Activation::EnableSimd( false );
+            Image_Function_Simd::Simd_Activation::EnableAvx512( true );
+        }
         else if ( namespaceName == "image_function_avx" ) {
             Image_Function_Simd::Simd_Activation::EnableSimd( false );
             Image_Function_Simd::Simd_Activation::EnableAvx( true );
@@ -32,7 +39,8 @@ namespace
 
     void CleanupFunction(const std::string& namespaceName)
     {
-        if ( (namespaceName == "image_function_avx") || (namespaceName == "image_function_sse") || (namespaceName == "image_function_neon") )
+        if ( (namespaceName == "image_function_avx512") || (namespaceName == "image_function_avx") || (namespaceName == "image_function_sse") ||
+             (namespaceName == "image_function_neon") )
             Image_Function_Simd::Simd_Activation::EnableSimd( true );
     }
 
@@ -1890,6 +1898,30 @@ namespace function_pool
     SET_FUNCTION_8_FORMS( Threshold )
 }
 
+#ifdef PENGUINV_AVX512_SET
+namespace avx512
+{
+    using namespace Image_Function_Simd;
+
+    const bool isSupported = isAvx512Available;
+    const std::string namespaceName = "image_function_avx512";
+
+    SET_FUNCTION_4_FORMS( AbsoluteDifference )
+    SET_FUNCTION_4_FORMS( BitwiseAnd )
+    SET_FUNCTION_4_FORMS( BitwiseOr )
+    SET_FUNCTION_4_FORMS( BitwiseXor )
+    SET_FUNCTION_4_FORMS( GammaCorrection )
+    SET_FUNCTION_4_FORMS( Invert )
+    SET_FUNCTION_4_FORMS( LookupTable )
+    SET_FUNCTION_4_FORMS( Maximum )
+    SET_FUNCTION_4_FORMS( Minimum )
+    SET_FUNCTION_4_FORMS( Normalize )
+    SET_FUNCTION_4_FORMS( Subtract )
+    SET_FUNCTION_2_FORMS( Sum )
+    SET_FUNCTION_8_FORMS( Threshold )
+}
+#endif
+
 #ifdef PENGUINV_AVX_SET
 namespace avx
 {
@@ -1902,9 +1934,12 @@ namespace avx
     SET_FUNCTION_4_FORMS( BitwiseAnd )
     SET_FUNCTION_4_FORMS( BitwiseOr )
     SET_FUNCTION_4_FORMS( BitwiseXor )
+    SET_FUNCTION_4_FORMS( GammaCorrection )
     SET_FUNCTION_4_FORMS( Invert )
+    SET_FUNCTION_4_FORMS( LookupTable )
     SET_FUNCTION_4_FORMS( Maximum )
     SET_FUNCTION_4_FORMS( Minimum )
+    SET_FUNCTION_4_FORMS( Normalize )
     SET_FUNCTION_4_FORMS( Subtract )
     SET_FUNCTION_2_FORMS( Sum )
     SET_FUNCTION_8_FORMS( Threshold )
@@ -1923,9 +1958,12 @@ namespace neon
     SET_FUNCTION_4_FORMS( BitwiseAnd )
     SET_FUNCTION_4_FORMS( BitwiseOr )
     SET_FUNCTION_4_FORMS( BitwiseXor )
+    SET_FUNCTION_4_FORMS( GammaCorrection )
     SET_FUNCTION_4_FORMS( Invert )
+    SET_FUNCTION_4_FORMS( LookupTable )
     SET_FUNCTION_4_FORMS( Maximum )
     SET_FUNCTION_4_FORMS( Minimum )
+    SET_FUNCTION_4_FORMS( Normalize )
     SET_FUNCTION_4_FORMS( Subtract )
     SET_FUNCTION_2_FORMS( Sum )
     SET_FUNCTION_8_FORMS( Threshold )
@@ -1944,16 +1982,446 @@ namespace sse
     SET_FUNCTION_4_FORMS( BitwiseAnd )
     SET_FUNCTION_4_FORMS( BitwiseOr )
     SET_FUNCTION_4_FORMS( BitwiseXor )
+    SET_FUNCTION_4_FORMS( GammaCorrection )
     SET_FUNCTION_4_FORMS( Invert )
+    SET_FUNCTION_4_FORMS( LookupTable )
     SET_FUNCTION_4_FORMS( Maximum )
     SET_FUNCTION_4_FORMS( Minimum )
+    SET_FUNCTION_4_FORMS( Normalize )
     SET_FUNCTION_4_FORMS( Subtract )
     SET_FUNCTION_2_FORMS( Sum )
     SET_FUNCTION_8_FORMS( Threshold )
 }
 #endif
 
+namespace image_function_simd
+{
+    using namespace PenguinV_Image;
+
+    Image alignedRandomImage( uint32_t width, uint32_t height )
+    {
+        Image image( width, height, GRAY_SCALE, CACHE_LINE_ALIGNMENT );
+
+        for( uint8_t * data = image.data(); data != image.data() + image.height() * image.rowSize(); ++data )
+            *data = Unit_Test::randomValue<uint8_t>( 256 );
+
+        return image;
+    }
+
+    bool equalImages( const Image & image1, const Image & image2 )
+    {
+        for( uint32_t y = 0; y < image1.height(); ++y ) {
+            if( memcmp( image1.data() + y * image1.rowSize(), image2.data() + y * image2.rowSize(), image1.width() ) != 0 )
+                return false;
+        }
+
+        return true;
+    }
+
+    // All images have rows aligned to a cache line so SIMD functions use aligned load and store instructions
+    bool AlignedRows()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const uint32_t width  = Unit_Test::randomValue<uint32_t>( 32, 512 );
+            const uint32_t height = Unit_Test::randomValue<uint32_t>( 1, 64 );
+            const uint8_t threshold = Unit_Test::randomValue<uint8_t>( 256 );
+
+            const Image in1 = alignedRandomImage( width, height );
+            const Image in2 = alignedRandomImage( width, height );
+
+            Image expected( width, height, GRAY_SCALE, CACHE_LINE_ALIGNMENT );
+            Image actual  ( width, height, GRAY_SCALE, CACHE_LINE_ALIGNMENT );
+
+            for( uint32_t simdType = 0; simdType < 3; ++simdType ) {
+                Image_Function_Simd::Simd_Activation::EnableSimd( false );
+                if( simdType == 0 )
+                    Image_Function_Simd::Simd_Activation::EnableAvx512( true );
+                else if( simdType == 1 )
+                    Image_Function_Simd::Simd_Activation::EnableAvx( true );
+                else
+                    Image_Function_Simd::Simd_Activation::EnableSse( true );
+
+                Image_Function::AbsoluteDifference( in1, in2, expected );
+                Image_Function_Simd::AbsoluteDifference( in1, in2, actual );
+                bool equal = equalImages( expected, actual );
+
+                Image_Function::Maximum( in1, in2, expected );
+                Image_Function_Simd::Maximum( in1, in2, actual );
+                equal = equal && equalImages( expected, actual );
+
+                Image_Function::Subtract( in1, in2, expected );
+                Image_Function_Simd::Subtract( in1, in2, actual );
+                equal = equal && equalImages( expected, actual );
+
+                Image_Function::Invert( in1, expected );
+                Image_Function_Simd::Invert( in1, actual );
+                equal = equal && equalImages( expected, actual );
+
+                Image_Function::Threshold( in1, expected, threshold );
+                Image_Function_Simd::Threshold( in1, actual, threshold );
+                equal = equal && equalImages( expected, actual );
+
+                equal = equal && (Image_Function::Sum( in1 ) == Image_Function_Simd::Sum( in1 ));
+
+                Image_Function_Simd::Simd_Activation::EnableSimd( true );
+
+                if( !equal )
+                    return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+namespace image_function_high_bit
+{
+    using namespace PenguinV_Image;
+
+    uint16_t randomPixel( uint16_t ) { return Unit_Test::randomValue<uint16_t>( 65536 ); }
+    float randomPixel( float ) { return static_cast<float>(Unit_Test::randomValue<uint32_t>( 2000001 )) / 1000.0f - 1000.0f; }
+
+    template <typename TColorDepth>
+    ImageTemplate < TColorDepth > randomImage( uint32_t width, uint32_t height, uint8_t colorCount = GRAY_SCALE )
+    {
+        ImageTemplate < TColorDepth > image( width, height, colorCount );
+
+        for( TColorDepth * data = image.data(); data != image.data() + image.height() * image.rowSize(); ++data )
+            *data = randomPixel( TColorDepth() );
+
+        return image;
+    }
+
+    template <typename TColorDepth>
+    TColorDepth pixel( const ImageTemplate < TColorDepth > & image, uint32_t x, uint32_t y )
+    {
+        return image.data()[y * image.rowSize() + x];
+    }
+
+    uint16_t subtract( uint16_t value1, uint16_t value2 ) { return (value1 > value2) ? static_cast<uint16_t>(value1 - value2) : 0u; }
+    float subtract( float value1, float value2 ) { return value1 - value2; }
+
+    template <typename TColorDepth>
+    bool verifyArithmetic()
+    {
+        typedef ImageTemplate < TColorDepth > TImage;
+
+        const uint8_t colorCount = (Unit_Test::randomValue<uint32_t>( 2 ) == 0) ? GRAY_SCALE : RGB;
+        const uint32_t width  = Unit_Test::randomValue<uint32_t>( 1, 256 );
+        const uint32_t height = Unit_Test::randomValue<uint32_t>( 1, 32 );
+
+        const TImage in1 = randomImage<TColorDepth>( width, height, colorCount );
+        const TImage in2 = randomImage<TColorDepth>( width, height, colorCount );
+
+        // output image has an offset so rows of input and output images are not aligned in the same way
+        const uint32_t offset = Unit_Test::randomValue<uint32_t>( 8 );
+        TImage expected( width, height, colorCount );
+        TImage actual( width + offset, height, colorCount );
+
+        for( uint32_t operation = 0; operation < 4; ++operation ) {
+            switch( operation ) {
+                case 0:
+                    Image_Function::AbsoluteDifference( in1, in2, expected );
+                    Image_Function_Simd::AbsoluteDifference( in1, 0, 0, in2, 0, 0, actual, offset, 0, width, height );
+                    break;
+                case 1:
+                    Image_Function::Maximum( in1, in2, expected );
+                    Image_Function_Simd::Maximum( in1, 0, 0, in2, 0, 0, actual, offset, 0, width, height );
+                    break;
+                case 2:
+                    Image_Function::Minimum( in1, in2, expected );
+                    Image_Function_Simd::Minimum( in1, 0, 0, in2, 0, 0, actual, offset, 0, width, height );
+                    break;
+                default:
+                    Image_Function::Subtract( in1, in2, expected );
+                    Image_Function_Simd::Subtract( in1, 0, 0, in2, 0, 0, actual, offset, 0, width, height );
+                    break;
+            }
+
+            for( uint32_t y = 0; y < height; ++y ) {
+                for( uint32_t x = 0; x < width * colorCount; ++x ) {
+                    const TColorDepth value1 = pixel( in1, x, y );
+                    const TColorDepth value2 = pixel( in2, x, y );
+
+                    TColorDepth value;
+                    switch( operation ) {
+                        case 0:
+                            value = (value1 > value2) ? static_cast<TColorDepth>(value1 - value2) : static_cast<TColorDepth>(value2 - value1);
+                            break;
+                        case 1:
+                            value = std::max( value1, value2 );
+                            break;
+                        case 2:
+                            value = std::min( value1, value2 );
+                            break;
+                        default:
+                            value = subtract( value1, value2 );
+                            break;
+                    }
+
+                    if( pixel( expected, x, y ) != value || pixel( actual, x + offset * colorCount, y ) != value )
+                        return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool Arithmetic()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            for( uint32_t simdType = 0; simdType < 4; ++simdType ) {
+                Image_Function_Simd::Simd_Activation::EnableSimd( false );
+                if( simdType == 0 )
+                    Image_Function_Simd::Simd_Activation::EnableAvx512( true );
+                else if( simdType == 1 )
+                    Image_Function_Simd::Simd_Activation::EnableAvx( true );
+                else if( simdType == 2 )
+                    Image_Function_Simd::Simd_Activation::EnableSse( true );
+
+                const bool equal = verifyArithmetic<uint16_t>() && verifyArithmetic<float>();
+
+                Image_Function_Simd::Simd_Activation::EnableSimd( true );
+
+                if( !equal )
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool Histogram()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const Image16Bit image = randomImage<uint16_t>( Unit_Test::randomValue<uint32_t>( 1, 256 ), Unit_Test::randomValue<uint32_t>( 1, 256 ) );
+
+            const uint32_t roiX = Unit_Test::randomValue<uint32_t>( image.width() );
+            const uint32_t roiY = Unit_Test::randomValue<uint32_t>( image.height() );
+            const uint32_t roiWidth  = Unit_Test::randomValue<uint32_t>( 1, image.width() - roiX + 1 );
+            const uint32_t roiHeight = Unit_Test::randomValue<uint32_t>( 1, image.height() - roiY + 1 );
+
+            const std::vector < uint32_t > histogram = Image_Function::Histogram( image, roiX, roiY, roiWidth, roiHeight );
+
+            if( histogram.size() != 65536u ||
+                std::accumulate( histogram.begin(), histogram.end(), 0u ) != roiWidth * roiHeight ||
+                histogram[pixel( image, roiX, roiY )] == 0u )
+                return false;
+        }
+
+        return true;
+    }
+
+    template <typename TColorDepth>
+    bool verifyResize()
+    {
+        const ImageTemplate < TColorDepth > input = randomImage<TColorDepth>( Unit_Test::randomValue<uint32_t>( 1, 128 ),
+                                                                              Unit_Test::randomValue<uint32_t>( 1, 128 ) );
+
+        // nearest neighbour upscaling in 2 times and downscaling back must return the same image
+        const ImageTemplate < TColorDepth > upscaled = Image_Function::Resize( input, input.width() * 2, input.height() * 2 );
+        const ImageTemplate < TColorDepth > output = Image_Function::Resize( upscaled, input.width(), input.height() );
+
+        for( uint32_t y = 0; y < input.height(); ++y ) {
+            for( uint32_t x = 0; x < input.width(); ++x ) {
+                if( pixel( output, x, y ) != pixel( input, x, y ) || pixel( upscaled, 2 * x + 1, 2 * y + 1 ) != pixel( input, x, y ) )
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool Resize()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            if( !verifyResize<uint16_t>() || !verifyResize<float>() )
+                return false;
+        }
+
+        return true;
+    }
+
+    template <typename TColorDepth>
+    bool verifyThreshold()
+    {
+        const ImageTemplate < TColorDepth > input = randomImage<TColorDepth>( Unit_Test::randomValue<uint32_t>( 1, 256 ),
+                                                                              Unit_Test::randomValue<uint32_t>( 1, 64 ) );
+
+        TColorDepth minThreshold = randomPixel( TColorDepth() );
+        TColorDepth maxThreshold = randomPixel( TColorDepth() );
+        if( minThreshold > maxThreshold )
+            std::swap( minThreshold, maxThreshold );
+
+        const Image output1 = Image_Function::Threshold( input, minThreshold );
+        const Image output2 = Image_Function::Threshold( input, minThreshold, maxThreshold );
+
+        // SIMD output image has an offset so rows of input and output images are not aligned in the same way
+        const uint32_t offset = Unit_Test::randomValue<uint32_t>( 8 );
+        Image output3( input.width() + offset, input.height() );
+        Image output4( input.width() + offset, input.height() );
+        Image_Function_Simd::Threshold( input, 0, 0, output3, offset, 0, input.width(), input.height(), minThreshold );
+        Image_Function_Simd::Threshold( input, 0, 0, output4, offset, 0, input.width(), input.height(), minThreshold, maxThreshold );
+
+        for( uint32_t y = 0; y < input.height(); ++y ) {
+            for( uint32_t x = 0; x < input.width(); ++x ) {
+                const TColorDepth value = pixel( input, x, y );
+
+                const uint8_t expected1 = (value < minThreshold) ? 0u : 255u;
+                const uint8_t expected2 = (value < minThreshold || value > maxThreshold) ? 0u : 255u;
+
+                if( pixel( output1, x, y ) != expected1 || pixel( output2, x, y ) != expected2 ||
+                    pixel( output3, x + offset, y ) != expected1 || pixel( output4, x + offset, y ) != expected2 )
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool Threshold()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            for( uint32_t simdType = 0; simdType < 4; ++simdType ) {
+                Image_Function_Simd::Simd_Activation::EnableSimd( false );
+                if( simdType == 0 )
+                    Image_Function_Simd::Simd_Activation::EnableAvx512( true );
+                else if( simdType == 1 )
+                    Image_Function_Simd::Simd_Activation::EnableAvx( true );
+                else if( simdType == 2 )
+                    Image_Function_Simd::Simd_Activation::EnableSse( true );
+
+                const bool equal = verifyThreshold<uint16_t>() && verifyThreshold<float>();
+
+                Image_Function_Simd::Simd_Activation::EnableSimd( true );
+
+                if( !equal )
+                    return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+namespace function_pool_task
+{
+    using namespace PenguinV_Image;
+
+    // Every case of Function_Pool task must end by break otherwise an operation of the next case overwrites the result
+    bool ExtractChannel()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            Thread_Pool::ThreadPoolMonoid::instance().resize( Unit_Test::randomValue<uint8_t>( 1, 8 ) );
+
+            Image input( Unit_Test::randomValue<uint32_t>( 1, 256 ), Unit_Test::randomValue<uint32_t>( 1, 256 ), RGB );
+
+            for( uint32_t y = 0; y < input.height(); ++y ) {
+                const std::vector < uint8_t > value = Unit_Test::intensityArray( input.width() * RGB );
+                memcpy( input.data() + y * input.rowSize(), value.data(), value.size() );
+            }
+
+            const uint8_t channelId = Unit_Test::randomValue<uint8_t>( RGB );
+
+            if( !Image_Function::IsEqual( Function_Pool::ExtractChannel( input, channelId ), Image_Function::ExtractChannel( input, channelId ) ) )
+                return false;
+        }
+
+        return true;
+    }
+}
+
+namespace function_table
+{
+    using namespace PenguinV_Image;
+
+    // Restores global state changed by the test even if the test fails or throws an exception
+    class OptimizationGuard
+    {
+    public:
+        explicit OptimizationGuard( const std::string & fileName )
+            : _fileName   ( fileName )
+            , _threadCount( Thread_Pool::ThreadPoolMonoid::instance().threadCount() )
+        {
+        }
+
+        ~OptimizationGuard()
+        {
+            remove( _fileName.c_str() );
+
+            penguinV::ResetFunctionTable();
+
+            if( _threadCount == 0 )
+                Thread_Pool::ThreadPoolMonoid::instance().stop();
+            else
+                Thread_Pool::ThreadPoolMonoid::instance().resize( _threadCount );
+        }
+    private:
+        std::string _fileName;
+        size_t _threadCount;
+    };
+
+    // Optimized function table must give the same results as CPU code, the second call loads the configuration from the file
+    bool Optimize()
+    {
+        const std::string fileName( "function_table.txt" );
+        const OptimizationGuard guard( fileName );
+
+        Thread_Pool::ThreadPoolMonoid::instance().resize( Unit_Test::randomValue<uint8_t>( 1, 8 ) );
+
+        for( uint32_t attempt = 0; attempt < 2u; ++attempt ) {
+            penguinV::OptimizeFunctionTable( fileName );
+
+            for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+                const uint32_t width  = Unit_Test::randomValue<uint32_t>( 1, 2048 );
+                const uint32_t height = Unit_Test::randomValue<uint32_t>( 1, 1024 );
+                const uint8_t threshold = Unit_Test::randomValue<uint8_t>( 256 );
+
+                const Image in1 = image_function_simd::alignedRandomImage( width, height );
+                const Image in2 = image_function_simd::alignedRandomImage( width, height );
+
+                Image expected( width, height );
+                Image actual  ( width, height );
+
+                Image_Function::Maximum( in1, 0, 0, in2, 0, 0, expected, 0, 0, width, height );
+                penguinV::Maximum( in1, 0, 0, in2, 0, 0, actual, 0, 0, width, height );
+                if( !Image_Function::IsEqual( expected, actual ) )
+                    return false;
+
+                Image_Function::Threshold( in2, 0, 0, expected, 0, 0, width, height, threshold );
+                penguinV::Threshold( in2, 0, 0, actual, 0, 0, width, height, threshold );
+                if( !Image_Function::IsEqual( expected, actual ) )
+                    return false;
+
+                if( Image_Function::Sum( in2 ) != penguinV::Sum( in2, 0, 0, width, height ) )
+                    return false;
+            }
+        }
+
+        penguinV::ResetFunctionTable();
+
+        // images of these sizes belong to different size classes
+        const uint32_t size[3] = { 1u, 1024u, 2048u };
+
+        for( uint32_t i = 0; i < 3u; ++i ) {
+            if( penguinV::functionTable( size[i], size[i] ).Maximum != penguinV::functionTable().Maximum )
+                return false;
+        }
+
+        return true;
+    }
+}
+
 void addTests_Image_Function( UnitTestFramework & framework )
 {
     FunctionRegistrator::instance().set( framework );
+
+    ADD_TEST( framework, image_function_simd::AlignedRows );
+    ADD_TEST( framework, image_function_high_bit::Arithmetic );
+    ADD_TEST( framework, image_function_high_bit::Histogram );
+    ADD_TEST( framework, image_function_high_bit::Resize );
+    ADD_TEST( framework, image_function_high_bit::Threshold );
+    ADD_TEST( framework, function_pool_task::ExtractChannel );
+    ADD_TEST( framework, function_table::Optimize );
 }
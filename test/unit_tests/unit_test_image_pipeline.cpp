@@ -0,0 +1,206 @@
+#include "unit_test_image_pipeline.h"
+#include "unit_test_helper.h"
+#include "../../src/function_pool.h"
+#include "../../src/image_function.h"
+#include "../../src/image_pipeline.h"
+#include "../../src/thread_pool.h"
+#include "../../src/penguinv/penguinv.h"
+
+namespace
+{
+    std::vector < PenguinV_Image::Image > randomImages( uint32_t images )
+    {
+        std::vector < PenguinV_Image::Image > image( 1, Unit_Test::randomImage() );
+
+        for( uint32_t i = 1; i < images; ++i ) {
+            image.push_back( image[0].generate( image[0].width(), image[0].height() ) );
+
+            uint8_t * data = image.back().data();
+            const uint8_t * dataEnd = data + image.back().height() * image.back().rowSize();
+
+            for( ; data != dataEnd; ++data )
+                (*data) = Unit_Test::randomValue<uint8_t>( 256 );
+        }
+
+        return image;
+    }
+
+    // Restores the default function table and the thread pool even if a test fails or throws an exception
+    class FunctionTableGuard
+    {
+    public:
+        FunctionTableGuard()
+            : _threadCount( Thread_Pool::ThreadPoolMonoid::instance().threadCount() )
+        {
+        }
+
+        ~FunctionTableGuard()
+        {
+            penguinV::ResetFunctionTable();
+
+            if( _threadCount == 0 )
+                Thread_Pool::ThreadPoolMonoid::instance().stop();
+            else
+                Thread_Pool::ThreadPoolMonoid::instance().resize( _threadCount );
+        }
+    private:
+        size_t _threadCount;
+    };
+
+    // Function_Pool functions are overloaded so a type of a function pointer is taken from the first argument
+    template <typename TFunction>
+    bool isSameFunction( TFunction function1, TFunction function2 )
+    {
+        return function1 == function2;
+    }
+}
+
+namespace image_pipeline
+{
+    bool FusedChain()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const std::vector < PenguinV_Image::Image > input = randomImages( 4 );
+            const uint8_t threshold = Unit_Test::randomValue<uint8_t>( 256 );
+
+            PenguinV_Image::Image expected = Image_Function::Subtract( input[0], input[1] );
+            expected = Image_Function::AbsoluteDifference( expected, input[2] );
+            expected = Image_Function::Threshold( expected, threshold );
+            expected = Image_Function::BitwiseAnd( expected, input[3] );
+
+            const PenguinV_Image::Image output = Image_Pipeline::Pipeline( input[0] ).subtract( input[1] ).absoluteDifference( input[2] )
+                                                     .threshold( threshold ).bitwiseAnd( input[3] ).execute();
+
+            if( !Unit_Test::equalSize( expected, output ) || !Image_Function::IsEqual( expected, output ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    bool FusedChainInPlace()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            std::vector < PenguinV_Image::Image > input = randomImages( 2 );
+            const std::vector < uint8_t > table = Unit_Test::intensityArray( 256 );
+
+            PenguinV_Image::Image expected = Image_Function::Maximum( input[0], input[1] );
+            expected = Image_Function::LookupTable( expected, table );
+            expected = Image_Function::Invert( expected );
+
+            Image_Pipeline::Pipeline( input[0] ).maximum( input[1] ).lookupTable( table ).invert().execute( input[0] );
+
+            if( !Image_Function::IsEqual( expected, input[0] ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    bool FusedChainRoi()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            std::vector < PenguinV_Image::Image > image;
+            for( uint32_t j = 0; j < 4; ++j )
+                image.push_back( Unit_Test::randomImage() );
+
+            std::vector < uint32_t > roiX, roiY;
+            uint32_t roiWidth, roiHeight;
+            Unit_Test::generateRoi( image, roiX, roiY, roiWidth, roiHeight );
+
+            const uint8_t minThreshold = Unit_Test::randomValue<uint8_t>( 256 );
+            const uint8_t maxThreshold = Unit_Test::randomValue<uint8_t>( minThreshold, 256 );
+
+            PenguinV_Image::Image expected = Image_Function::Minimum( image[0], roiX[0], roiY[0], image[1], roiX[1], roiY[1], roiWidth, roiHeight );
+            expected = Image_Function::BitwiseXor( expected, 0, 0, image[2], roiX[2], roiY[2], roiWidth, roiHeight );
+            expected = Image_Function::Threshold( expected, minThreshold, maxThreshold );
+
+            Image_Pipeline::Pipeline( image[0], roiX[0], roiY[0], roiWidth, roiHeight ).minimum( image[1], roiX[1], roiY[1] )
+                .bitwiseXor( image[2], roiX[2], roiY[2] ).threshold( minThreshold, maxThreshold ).execute( image[3], roiX[3], roiY[3] );
+
+            if( !Image_Function::IsEqual( expected, 0, 0, image[3], roiX[3], roiY[3], roiWidth, roiHeight ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    bool OutputAsSecondImage()
+    {
+        std::vector < PenguinV_Image::Image > input = randomImages( 2 );
+
+        try {
+            Image_Pipeline::Pipeline( input[0] ).bitwiseOr( input[1] ).execute( input[1] );
+        }
+        catch( imageException & ) {
+            return true;
+        }
+
+        return false;
+    }
+
+    bool ColorThresholdKeepsOutput()
+    {
+        const PenguinV_Image::Image input = Unit_Test::uniformRGBImage();
+
+        const uint8_t intensity = Unit_Test::intensityValue();
+        PenguinV_Image::Image output = input.generate( input.width(), input.height(), input.colorCount() );
+        output.fill( intensity );
+
+        try {
+            Image_Pipeline::Pipeline( input ).invert().threshold( 128 ).execute( output );
+        }
+        catch( imageException & ) {
+            return Unit_Test::verifyImage( output, intensity );
+        }
+
+        return false;
+    }
+
+    // Tiles belong to the small size class whose optimized table never contains Function_Pool functions
+    bool OptimizedFunctionTable()
+    {
+        const FunctionTableGuard guard;
+
+        Thread_Pool::ThreadPoolMonoid::instance().resize( Unit_Test::randomValue<uint8_t>( 1, 8 ) );
+        penguinV::OptimizeFunctionTable( "" );
+
+        const penguinV::FunctionTable & table = penguinV::functionTable( 1u, 1u );
+
+        if( isSameFunction( table.AbsoluteDifference, &Function_Pool::AbsoluteDifference ) ||
+            isSameFunction( table.BitwiseAnd, &Function_Pool::BitwiseAnd ) || isSameFunction( table.BitwiseOr, &Function_Pool::BitwiseOr ) ||
+            isSameFunction( table.BitwiseXor, &Function_Pool::BitwiseXor ) || isSameFunction( table.Invert, &Function_Pool::Invert ) ||
+            isSameFunction( table.LookupTable, &Function_Pool::LookupTable ) || isSameFunction( table.Maximum, &Function_Pool::Maximum ) ||
+            isSameFunction( table.Minimum, &Function_Pool::Minimum ) || isSameFunction( table.Subtract, &Function_Pool::Subtract ) ||
+            isSameFunction( table.Threshold, &Function_Pool::Threshold ) || isSameFunction( table.Threshold2, &Function_Pool::Threshold ) )
+            return false;
+
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const std::vector < PenguinV_Image::Image > input = randomImages( 3 );
+            const uint8_t minThreshold = Unit_Test::randomValue<uint8_t>( 128 );
+            const uint8_t maxThreshold = Unit_Test::randomValue<uint8_t>( 128, 256 );
+
+            PenguinV_Image::Image expected = Image_Function::Minimum( input[0], input[1] );
+            expected = Image_Function::BitwiseXor( expected, input[2] );
+            expected = Image_Function::Threshold( expected, minThreshold, maxThreshold );
+
+            const PenguinV_Image::Image output = Image_Pipeline::Pipeline( input[0] ).minimum( input[1] ).bitwiseXor( input[2] )
+                                                     .threshold( minThreshold, maxThreshold ).execute();
+
+            if( !Image_Function::IsEqual( expected, output ) )
+                return false;
+        }
+
+        return true;
+    }
+}
+
+void addTests_Image_Pipeline( UnitTestFramework & framework )
+{
+    ADD_TEST( framework, image_pipeline::FusedChain );
+    ADD_TEST( framework, image_pipeline::FusedChainInPlace );
+    ADD_TEST( framework, image_pipeline::FusedChainRoi );
+    ADD_TEST( framework, image_pipeline::OutputAsSecondImage );
+    ADD_TEST( framework, image_pipeline::ColorThresholdKeepsOutput );
+    ADD_TEST( framework, image_pipeline::OptimizedFunctionTable );
+}
@@ -0,0 +1,122 @@
+#include "unit_test_image_stream.h"
+#include "unit_test_helper.h"
+#include "../../src/filtering.h"
+#include "../../src/image_function.h"
+#include "../../src/image_stream.h"
+#include "../../src/FileOperation/bitmap.h"
+
+namespace
+{
+    PenguinV_Image::Image randomImage( uint8_t colorCount )
+    {
+        PenguinV_Image::Image image( Unit_Test::randomValue<uint32_t>( 1, 256 ), Unit_Test::randomValue<uint32_t>( 1, 256 ), colorCount );
+
+        uint8_t * data = image.data();
+        const uint8_t * dataEnd = data + image.height() * image.rowSize();
+
+        for( ; data != dataEnd; ++data )
+            (*data) = Unit_Test::randomValue<uint8_t>( 256 );
+
+        return image;
+    }
+
+    Image_Stream::StreamExecutor randomExecutor( uint32_t halo )
+    {
+        Thread_Pool::ThreadPoolMonoid::instance().resize( Unit_Test::randomValue<uint8_t>( 1, 8 ) );
+
+        return Image_Stream::StreamExecutor( Unit_Test::randomValue<uint32_t>( 1, 64 ), halo, Unit_Test::randomValue<uint32_t>( 1, 5 ) );
+    }
+}
+
+namespace image_stream
+{
+    bool RawFileFilter()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image input = randomImage( 1u );
+            const uint32_t kernelSize = Unit_Test::randomValue<uint32_t>( 1, 5 );
+
+            {
+                Image_Stream::RawWriter writer( "stream_in.raw", input.width(), input.height() );
+                writer.write( 0, input, 0, input.height() );
+            }
+
+            {
+                Image_Stream::RawReader reader( "stream_in.raw", input.width(), input.height() );
+                Image_Stream::RawWriter writer( "stream_out.raw", input.width(), input.height() );
+
+                randomExecutor( kernelSize ).execute( reader, writer, [&]( const PenguinV_Image::Image & in, PenguinV_Image::Image & out ) {
+                    Image_Function::GaussianBlur( in, out, kernelSize, 1.5f );
+                } );
+            }
+
+            const PenguinV_Image::Image expected = Image_Function::GaussianBlur( input, kernelSize, 1.5f );
+
+            PenguinV_Image::Image output( input.width(), input.height() );
+            Image_Stream::RawReader( "stream_out.raw", input.width(), input.height() ).read( 0, output );
+
+            if( !Unit_Test::equalSize( output, expected.width(), expected.height() ) || !Image_Function::IsEqual( expected, output ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    bool BitmapFileFunction()
+    {
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image input = randomImage( (i % 2 == 0) ? 1u : 3u );
+
+            Bitmap_Operation::Save( "stream_in.bmp", input );
+
+            {
+                Bitmap_Operation::BitmapReader reader( "stream_in.bmp" );
+                Bitmap_Operation::BitmapWriter writer( "stream_out.bmp", reader.width(), reader.height(), reader.colorCount() );
+
+                randomExecutor( 0 ).execute( reader, writer, []( const PenguinV_Image::Image & in, PenguinV_Image::Image & out ) {
+                    Image_Function::Invert( in, out );
+                } );
+            }
+
+            const PenguinV_Image::Image loaded = Bitmap_Operation::Load( "stream_in.bmp" );
+
+            PenguinV_Image::Image expected = loaded.generate( loaded.width(), loaded.height(), loaded.colorCount() );
+            Image_Function::Invert( loaded, expected );
+
+            const PenguinV_Image::Image output = Bitmap_Operation::Load( "stream_out.bmp" );
+
+            if( !Unit_Test::equalSize( output, expected.width(), expected.height() ) || !Image_Function::IsEqual( expected, output ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    bool DifferentColorCount()
+    {
+        const PenguinV_Image::Image input = randomImage( 3u );
+
+        Bitmap_Operation::Save( "stream_in.bmp", input );
+
+        {
+            Bitmap_Operation::BitmapReader reader( "stream_in.bmp" );
+            Bitmap_Operation::BitmapWriter writer( "stream_out.bmp", reader.width(), reader.height(), 1u );
+
+            randomExecutor( 0 ).execute( reader, writer, []( const PenguinV_Image::Image & in, PenguinV_Image::Image & out ) {
+                Image_Function::ConvertToGrayScale( in, out );
+            } );
+        }
+
+        const PenguinV_Image::Image expected = Image_Function::ConvertToGrayScale( Bitmap_Operation::Load( "stream_in.bmp" ) );
+        const PenguinV_Image::Image output = Bitmap_Operation::Load( "stream_out.bmp" );
+
+        return Unit_Test::equalSize( output, expected.width(), expected.height() ) && Image_Function::IsEqual( expected, output );
+    }
+}
+
+void addTests_Image_Stream( UnitTestFramework & framework )
+{
+    ADD_TEST( framework, image_stream::BitmapFileFunction );
+    ADD_TEST( framework, image_stream::DifferentColorCount );
+    ADD_TEST( framework, image_stream::RawFileFilter );
+}
@@ -0,0 +1,223 @@
+#include <cstdio>
+#include <cstring>
+#include <png.h>
+#include "unit_test_png.h"
+#include "unit_test_helper.h"
+#include "../../src/image_function.h"
+#include "../../src/thread_pool.h"
+#include "../../src/FileOperation/png_file.h"
+
+namespace
+{
+    // PNG files are always loaded as RGB images
+    PenguinV_Image::Image randomColorImage()
+    {
+        PenguinV_Image::Image image( Unit_Test::randomValue<uint32_t>( 1, 256 ), Unit_Test::randomValue<uint32_t>( 1, 256 ), PenguinV_Image::RGB );
+
+        uint8_t * imageY = image.data();
+        const uint8_t * imageYEnd = imageY + image.height() * image.rowSize();
+
+        for( ; imageY != imageYEnd; imageY += image.rowSize() ) {
+            const std::vector < uint8_t > value = Unit_Test::intensityArray( image.width() * PenguinV_Image::RGB );
+            memcpy( imageY, value.data(), value.size() );
+        }
+
+        return image;
+    }
+
+    // Png_Operation saves only non-interlaced files so an interlaced file is written by libpng directly
+    void saveInterlaced( const std::string & path, const PenguinV_Image::Image & image )
+    {
+        FILE * file = fopen( path.data(), "wb" );
+        if( file == nullptr )
+            throw imageException( "Cannot create file for saving" );
+
+        png_structp png = png_create_write_struct( PNG_LIBPNG_VER_STRING, NULL, NULL, NULL );
+        png_infop info = png_create_info_struct( png );
+
+        png_init_io( png, file );
+        png_set_IHDR( png, info, image.width(), image.height(), 8, PNG_COLOR_TYPE_RGB, PNG_INTERLACE_ADAM7,
+                      PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT );
+        png_set_bgr( png ); // image stores pixels in BGR order
+
+        png_write_info( png, info );
+
+        std::vector < png_bytep > row( image.height() );
+        for( uint32_t y = 0; y < image.height(); ++y )
+            row[y] = const_cast<png_bytep>( image.data() + y * image.rowSize() );
+
+        png_write_image( png, row.data() );
+        png_write_end( png, NULL );
+        png_destroy_write_struct( &png, &info );
+
+        fclose( file );
+    }
+
+    void setThreadPool()
+    {
+        Thread_Pool::ThreadPoolMonoid::instance().resize( Unit_Test::randomValue<uint8_t>( 1, 8 ) );
+    }
+}
+
+namespace png_operation
+{
+    bool AsyncLoadSave()
+    {
+        setThreadPool();
+
+        Png_Operation::AsyncPng saver;
+        Png_Operation::AsyncPng loader;
+
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image original = randomColorImage();
+
+            saver.save( "async.png", original ).get();
+
+            PenguinV_Image::Image loaded;
+            loader.load( "async.png", loaded ).get();
+
+            if( !Unit_Test::equalSize( loaded, original.width(), original.height() ) || loaded.colorCount() != PenguinV_Image::RGB ||
+                !Image_Function::IsEqual( original, loaded ) )
+                return false;
+        }
+
+        std::remove( "async.png" );
+
+        return true;
+    }
+
+    bool AsyncLoadReuseImage()
+    {
+        setThreadPool();
+
+        Png_Operation::AsyncPng loader;
+
+        const PenguinV_Image::Image original = randomColorImage();
+        Png_Operation::Save( "async_reuse.png", original );
+
+        PenguinV_Image::Image loaded( original.width(), original.height(), PenguinV_Image::RGB );
+        const uint8_t * data = loaded.data();
+
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            loaded.fill( Unit_Test::randomValue<uint8_t>( 256 ) );
+
+            // an image of the same size must be decoded in place without reallocation
+            loader.load( "async_reuse.png", loaded ).get();
+
+            if( loaded.data() != data || !Image_Function::IsEqual( original, loaded ) )
+                return false;
+        }
+
+        std::remove( "async_reuse.png" );
+
+        return true;
+    }
+
+    bool AsyncLoadInterlaced()
+    {
+        setThreadPool();
+
+        Png_Operation::AsyncPng loader;
+
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            const PenguinV_Image::Image original = randomColorImage();
+
+            saveInterlaced( "async_interlaced.png", original );
+
+            PenguinV_Image::Image loaded;
+            loader.load( "async_interlaced.png", loaded ).get();
+
+            if( !Unit_Test::equalSize( loaded, original.width(), original.height() ) || !Image_Function::IsEqual( original, loaded ) )
+                return false;
+        }
+
+        std::remove( "async_interlaced.png" );
+
+        return true;
+    }
+
+    bool AsyncLoadCorruptFile()
+    {
+        setThreadPool();
+
+        Png_Operation::AsyncPng loader;
+
+        for( uint32_t i = 0; i < Unit_Test::runCount(); ++i ) {
+            Png_Operation::Save( "async_corrupt.png", randomColorImage() );
+
+            // a file is truncated or its bytes after PNG signature are replaced by random values
+            std::vector < uint8_t > data;
+            {
+                FILE * file = fopen( "async_corrupt.png", "rb" );
+                if( file == nullptr )
+                    return false;
+
+                uint8_t value[256];
+                size_t readCount = 0;
+                while( (readCount = fread( value, 1u, sizeof( value ), file )) > 0 )
+                    data.insert( data.end(), value, value + readCount );
+
+                fclose( file );
+            }
+
+            if( Unit_Test::randomValue<uint32_t>( 2 ) == 0 ) {
+                data.resize( Unit_Test::randomValue<uint32_t>( static_cast<uint32_t>( data.size() ) ) );
+            }
+            else {
+                for( size_t id = 8u; id < data.size(); ++id )
+                    data[id] = Unit_Test::randomValue<uint8_t>( 256 );
+            }
+
+            FILE * file = fopen( "async_corrupt.png", "wb" );
+            if( file == nullptr )
+                return false;
+
+            fwrite( data.data(), 1u, data.size(), file );
+            fclose( file );
+
+            PenguinV_Image::Image image;
+            std::future < void > result = loader.load( "async_corrupt.png", image );
+
+            // libpng error must be raised as an exception through the future instead of terminating the application
+            try {
+                result.get();
+                return false;
+            }
+            catch( imageException & ) {
+            }
+        }
+
+        std::remove( "async_corrupt.png" );
+
+        return true;
+    }
+
+    bool AsyncLoadMissingFile()
+    {
+        setThreadPool();
+
+        Png_Operation::AsyncPng loader;
+        PenguinV_Image::Image image;
+
+        std::future < void > result = loader.load( "missing_file.png", image );
+
+        // an error is raised in a worker thread and it is passed to the caller through the future
+        try {
+            result.get();
+        }
+        catch( imageException & ) {
+            return image.empty();
+        }
+
+        return false;
+    }
+}
+
+void addTests_Png( UnitTestFramework & framework )
+{
+    ADD_TEST( framework, png_operation::AsyncLoadSave );
+    ADD_TEST( framework, png_operation::AsyncLoadReuseImage );
+    ADD_TEST( framework, png_operation::AsyncLoadInterlaced );
+    ADD_TEST( framework, png_operation::AsyncLoadCorruptFile );
+    ADD_TEST( framework, png_operation::AsyncLoadMissingFile );
+}
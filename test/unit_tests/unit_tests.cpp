@@ -1,10 +1,18 @@
 // This application is designed to run unit tests on penguinV library
 #include <iostream>
+#include "unit_test_binary_image.h"
 #include "unit_test_bitmap.h"
 #include "unit_test_blob_detection.h"
+#include "unit_test_fft.h"
+#include "unit_test_filtering.h"
 #include "unit_test_framework.h"
 #include "unit_test_image_buffer.h"
 #include "unit_test_image_function.h"
+#include "unit_test_image_pipeline.h"
+#include "unit_test_image_stream.h"
+#ifndef _WIN32
+#include "unit_test_png.h"
+#endif
 
 int main()
 {
@@ -15,10 +23,18 @@ int main()
     UnitTestFramework framework;
 
     // We add tests
+    addTests_Binary_Image       ( framework );
     addTests_Bitmap             ( framework );
     addTests_Blob_Detection     ( framework );
+    addTests_FFT                ( framework );
+    addTests_Filtering          ( framework );
     addTests_Image_Buffer       ( framework );
     addTests_Image_Function     ( framework );
+    addTests_Image_Pipeline     ( framework );
+    addTests_Image_Stream       ( framework );
+#ifndef _WIN32 // PNG files are supported only with libpng on Linux
+    addTests_Png                ( framework );
+#endif
 
     // Just run the framework what will handle all tests
     return framework.run();